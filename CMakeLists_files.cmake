@@ -37,19 +37,29 @@ list (APPEND MAIN_SOURCE_FILES
   opm/simulators/timestepping/SimulatorReport.cpp
   opm/simulators/flow/countGlobalCells.cpp
   opm/simulators/flow/KeywordValidation.cpp
+  opm/simulators/linalg/BinarySystemDump.cpp
   opm/simulators/linalg/ExtractParallelGridInformationToISTL.cpp
   opm/simulators/linalg/FlexibleSolver1.cpp
   opm/simulators/linalg/FlexibleSolver2.cpp
   opm/simulators/linalg/FlexibleSolver3.cpp
   opm/simulators/linalg/FlexibleSolver4.cpp
+  opm/simulators/linalg/LinearSolverAutoTuner.cpp
   opm/simulators/linalg/setupPropertyTree.cpp
+  opm/simulators/utils/CheckpointBuffer.cpp
   opm/simulators/utils/PartiallySupportedFlowKeywords.cpp
   opm/simulators/utils/readDeck.cpp
+  opm/simulators/utils/RunMetrics.cpp
+  opm/simulators/utils/StartupProfile.cpp
+  opm/simulators/utils/StructuredPartitioner.cpp
+  opm/simulators/utils/Tracing.cpp
+  opm/simulators/utils/PerfCounters.cpp
+  opm/simulators/utils/MemoryReport.cpp
   opm/simulators/utils/UnsupportedFlowKeywords.cpp
   opm/simulators/timestepping/TimeStepControl.cpp
   opm/simulators/timestepping/AdaptiveSimulatorTimer.cpp
   opm/simulators/timestepping/SimulatorTimer.cpp
   opm/simulators/timestepping/gatherConvergenceReport.cpp
+  opm/simulators/timestepping/LoadBalanceReport.cpp
   opm/simulators/utils/DeferredLogger.cpp
   opm/simulators/utils/gatherDeferredLogger.cpp
   opm/simulators/utils/ParallelFileMerger.cpp
@@ -59,6 +69,7 @@ list (APPEND MAIN_SOURCE_FILES
   opm/simulators/wells/GasLiftStage2.cpp
   opm/simulators/wells/GlobalWellInfo.cpp
   opm/simulators/wells/GroupState.cpp
+  opm/simulators/wells/GroupTree.cpp
   opm/simulators/wells/ParallelWellInfo.cpp
   opm/simulators/wells/TargetCalculator.cpp
   opm/simulators/wells/VFPProdProperties.cpp
@@ -83,6 +94,7 @@ if(OPENCL_FOUND)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/BILU0.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/Reorder.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/ChowPatelIlu.cpp)
+  list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/CPR.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/opencl.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/openclKernels.cpp)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/openclSolverBackend.cpp)
@@ -118,9 +130,25 @@ list (APPEND TEST_SOURCE_FILES
   tests/test_vfpproperties.cpp
   tests/test_milu.cpp
   tests/test_multmatrixtransposed.cpp
+  tests/test_mswellhelpers.cpp
   tests/test_wellmodel.cpp
   tests/test_deferredlogger.cpp
   tests/test_timer.cpp
+  tests/test_timestepcontrol.cpp
+  tests/test_checkpointbuffer.cpp
+  tests/test_binarysystemdump.cpp
+  tests/test_tracing.cpp
+  tests/test_loadbalancereport.cpp
+  tests/test_memoryreport.cpp
+  tests/test_structuredpartitioner.cpp
+  tests/test_linearsolverautotuner.cpp
+  tests/test_krylovmonitor.cpp
+  tests/test_uniformtablelookup.cpp
+  tests/test_scratcharena.cpp
+  tests/test_regionbatches.cpp
+  tests/test_parallelfilemerger.cpp
+  tests/test_pararealiteration.cpp
+  tests/test_runmetrics.cpp
   tests/test_invert.cpp
   tests/test_stoppedwells.cpp
   tests/test_relpermdiagnostics.cpp
@@ -132,6 +160,7 @@ list (APPEND TEST_SOURCE_FILES
   tests/test_keyword_validator.cpp
   tests/test_GroupState.cpp
   tests/test_ALQState.cpp
+  tests/test_packedwellschurcomplement.cpp
   )
 
 if(MPI_FOUND)
@@ -198,6 +227,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/flow/FlowMainEbos.hpp
   opm/simulators/flow/Main.hpp
   opm/simulators/flow/NonlinearSolverEbos.hpp
+  opm/simulators/flow/SimulatorCheckpoint.hpp
   opm/simulators/flow/SimulatorFullyImplicitBlackoilEbos.hpp
   opm/simulators/flow/KeywordValidation.hpp
   opm/core/props/BlackoilPhases.hpp
@@ -219,6 +249,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/linalg/bda/cuda_header.hpp
   opm/simulators/linalg/bda/cusparseSolverBackend.hpp
   opm/simulators/linalg/bda/ChowPatelIlu.hpp
+  opm/simulators/linalg/bda/CPR.hpp
   opm/simulators/linalg/bda/FPGAMatrix.hpp
   opm/simulators/linalg/bda/FPGABILU0.hpp
   opm/simulators/linalg/bda/FPGASolverBackend.hpp
@@ -232,11 +263,18 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/linalg/bda/WellContributions.hpp
   opm/simulators/linalg/amgcpr.hh
   opm/simulators/linalg/twolevelmethodcpr.hh
+  opm/simulators/linalg/DecoupledEnergySolver.hpp
   opm/simulators/linalg/ExtractParallelGridInformationToISTL.hpp
   opm/simulators/linalg/FlexibleSolver.hpp
   opm/simulators/linalg/FlexibleSolver_impl.hpp
+  opm/simulators/linalg/FloatMatrixAdapter.hpp
+  opm/simulators/linalg/PipelinedBiCGSTABSolver.hpp
+  opm/simulators/linalg/KrylovMonitor.hpp
+  opm/simulators/linalg/RecyclingGCROSolver.hpp
   opm/simulators/linalg/FlowLinearSolverParameters.hpp
   opm/simulators/linalg/GraphColoring.hpp
+  opm/simulators/linalg/HaloExchange.hpp
+  opm/simulators/linalg/AmgxPreconditioner.hpp
   opm/simulators/linalg/ISTLSolverEbos.hpp
   opm/simulators/linalg/ISTLSolverEbosFlexible.hpp
   opm/simulators/linalg/MatrixBlock.hpp
@@ -250,12 +288,17 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/linalg/PressureTransferPolicy.hpp
   opm/simulators/linalg/PreconditionerFactory.hpp
   opm/simulators/linalg/PreconditionerWithUpdate.hpp
+  opm/simulators/linalg/SequentialImplicitSolver.hpp
+  opm/simulators/linalg/SubdomainDirectPreconditioner.hpp
   opm/simulators/linalg/WellOperators.hpp
   opm/simulators/linalg/WriteSystemMatrixHelper.hpp
+  opm/simulators/linalg/BinarySystemDump.hpp
   opm/simulators/linalg/findOverlapRowsAndColumns.hpp
   opm/simulators/linalg/getQuasiImpesWeights.hpp
+  opm/simulators/linalg/LinearSolverAutoTuner.hpp
   opm/simulators/linalg/setupPropertyTree.hpp
   opm/simulators/linalg/setupPropertyTree_impl.hpp
+  opm/simulators/linalg/SmallBlockKernels.hpp
   opm/simulators/timestepping/AdaptiveSimulatorTimer.hpp
   opm/simulators/timestepping/AdaptiveTimeSteppingEbos.hpp
   opm/simulators/timestepping/ConvergenceReport.hpp
@@ -264,9 +307,14 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/timestepping/SimulatorTimer.hpp
   opm/simulators/timestepping/SimulatorTimerInterface.hpp
   opm/simulators/timestepping/gatherConvergenceReport.hpp
+  opm/simulators/timestepping/LoadBalanceReport.hpp
+  opm/simulators/timestepping/PararealIteration.hpp
+  opm/simulators/utils/CompactBuffer.hpp
   opm/simulators/utils/ParallelFileMerger.hpp
   opm/simulators/utils/DeferredLoggingErrorHelpers.hpp
+  opm/simulators/utils/ConvergenceHotspots.hpp
   opm/simulators/utils/DeferredLogger.hpp
+  opm/simulators/utils/CheckpointBuffer.hpp
   opm/simulators/utils/gatherDeferredLogger.hpp
   opm/simulators/utils/moduleVersion.hpp
   opm/simulators/utils/ParallelEclipseState.hpp
@@ -275,11 +323,22 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/wells/PerforationData.hpp
   opm/simulators/wells/RateConverter.hpp
   opm/simulators/utils/readDeck.hpp
+  opm/simulators/utils/RunMetrics.hpp
+  opm/simulators/utils/StartupProfile.hpp
+  opm/simulators/utils/StructuredPartitioner.hpp
+  opm/simulators/utils/Tracing.hpp
+  opm/simulators/utils/PerfCounters.hpp
+  opm/simulators/utils/PhaseActivity.hpp
+  opm/simulators/utils/UniformTableLookup.hpp
+  opm/simulators/utils/RegionBatches.hpp
+  opm/simulators/utils/ScratchArena.hpp
+  opm/simulators/utils/MemoryReport.hpp
   opm/simulators/wells/TargetCalculator.hpp
   opm/simulators/wells/WellConnectionAuxiliaryModule.hpp
   opm/simulators/wells/WellState.hpp
   opm/simulators/wells/GlobalWellInfo.hpp
   opm/simulators/wells/GroupState.hpp
+  opm/simulators/wells/GroupTree.hpp
   opm/simulators/wells/ALQState.hpp
   opm/simulators/wells/WGState.hpp
   opm/simulators/wells/VFPProperties.hpp
@@ -299,8 +358,12 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/wells/BlackoilWellModel.hpp
   opm/simulators/wells/BlackoilWellModel_impl.hpp
   opm/simulators/wells/ParallelWellInfo.hpp
+  opm/simulators/wells/PackedWellSchurComplement.hpp
   )
 
 list (APPEND EXAMPLE_SOURCE_FILES
+  examples/assembly_benchmark.cpp
+  examples/linear_solver_benchmark.cpp
   examples/printvfp.cpp
+  examples/well_model_benchmark.cpp
   )
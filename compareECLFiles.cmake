@@ -7,6 +7,10 @@
 # are passed from the build system to the driver script through
 # command line parameters. See the opm_add_test() documentation for
 # details on the parameters passed to the macro.
+#
+# With OPM_PERFORMANCE_DIR set in the environment, the compareECLFiles tests
+# also collect the timings of the runs in that directory. Two such directories
+# can be compared with tests/compare-performance.py.
 
 # Define some paths
 set(BASE_RESULT_PATH ${PROJECT_BINARY_DIR}/tests/results)
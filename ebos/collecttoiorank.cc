@@ -24,6 +24,8 @@
 #include <config.h>
 #include <ebos/collecttoiorank.hh>
 
+#include <opm/simulators/utils/MemoryReport.hpp>
+
 #include <opm/grid/common/CartesianIndexMapper.hpp>
 #include <opm/grid/CpGrid.hpp>
 #include <opm/grid/polyhedralgrid.hh>
@@ -36,9 +38,12 @@
 #include <ebos/femcpgridcompat.hh>
 #endif
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace Opm {
 
@@ -81,7 +86,8 @@ protected:
     const std::vector<int>& distributedGlobalIndex_;
     IndexMapType& localIndexMap_;
     IndexMapStorageType& indexMaps_;
-    std::map<int, int> globalPosition_;
+    // the index in the global state by Cartesian index, -1 for inactive cells
+    std::vector<int> globalPosition_;
     std::set<int>& recv_;
     std::vector<int>& ranks_;
 
@@ -102,9 +108,11 @@ public:
     {
         size_t size = globalIndex.size();
         // create mapping globalIndex --> localIndex
-        if ( isIORank ) // ioRank
+        if ( isIORank && size > 0 ) { // ioRank
+            globalPosition_.resize(*std::max_element(globalIndex.begin(), globalIndex.end()) + 1, -1);
             for (size_t index = 0; index < size; ++index)
-                globalPosition_.insert(std::make_pair(globalIndex[index], index));
+                globalPosition_[globalIndex[index]] = index;
+        }
 
         // we need to create a mapping from local to global
         if (!indexMaps_.empty()) {
@@ -137,11 +145,17 @@ public:
                 if (rankIt != recv_.end())
                     rank = *rankIt;
 
-                for (auto&& entry: indexMap)
+                const int numCells = indexMap.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+                for (int i = 0; i < numCells; ++i)
                 {
-                    auto candidate = globalPosition_.find(entry);
-                    assert(candidate != globalPosition_.end());
-                    entry = candidate->second;
+                    // the cells of one rank are distinct
+                    auto& entry = indexMap[i];
+                    assert(static_cast<std::size_t>(entry) < globalPosition_.size());
+                    entry = globalPosition_[entry];
+                    assert(entry >= 0);
                     // Using max should be backwards compatible
                     ranks_[entry] = std::max(ranks_[entry], rank);
                 }
@@ -267,6 +281,33 @@ private:
     std::vector<int>& elementIndices_;
 };
 
+/// \brief Copy the values of the cells of the I/O rank itself for all
+///        fields at once, which does not need a message buffer.
+///
+/// Entry i of sourceIndex is the cell of the source vectors which is copied
+/// to entry targetIndex[i] of the target vectors.
+void gatherCells(const std::vector<const std::vector<double>*>& sources,
+                 const std::vector<std::vector<double>*>& targets,
+                 const IndexMapType& sourceIndex,
+                 const IndexMapType& targetIndex)
+{
+    assert(sources.size() == targets.size());
+    assert(sourceIndex.size() == targetIndex.size());
+    const int numCells = sourceIndex.size();
+    const std::size_t numFields = sources.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < numCells; ++i) {
+        const auto source = sourceIndex[i];
+        const auto target = targetIndex[i];
+        for (std::size_t field = 0; field < numFields; ++field) {
+            assert(static_cast<std::size_t>(target) < targets[field]->size());
+            (*targets[field])[target] = (*sources[field])[source];
+        }
+    }
+}
+
 class PackUnPackCellData : public P2PCommunicatorType::DataHandleInterface
 {
     const data::Solution& localCellData_;
@@ -274,6 +315,11 @@ class PackUnPackCellData : public P2PCommunicatorType::DataHandleInterface
 
     const IndexMapType& localIndexMap_;
     const IndexMapStorageType& indexMaps_;
+    // if not null, only this field is packed and unpacked
+    const std::string* field_;
+
+    bool skip(const std::string& key) const
+    { return field_ != nullptr && key != *field_; }
 
 public:
     PackUnPackCellData(const data::Solution& localCellData,
@@ -281,28 +327,33 @@ public:
                        const IndexMapType& localIndexMap,
                        const IndexMapStorageType& indexMaps,
                        size_t globalSize,
-                       bool isIORank)
+                       bool isIORank,
+                       const std::string* field = nullptr)
         : localCellData_(localCellData)
         , globalCellData_(globalCellData)
         , localIndexMap_(localIndexMap)
         , indexMaps_(indexMaps)
+        , field_(field)
     {
         if (isIORank) {
             // add missing data to global cell data
+            std::vector<const std::vector<double>*> sources;
+            std::vector<std::vector<double>*> targets;
             for (const auto& pair : localCellData_) {
                 const std::string& key = pair.first;
+                if (skip(key))
+                    continue;
                 std::size_t containerSize = globalSize;
                 [[maybe_unused]] auto ret = globalCellData_.insert(key, pair.second.dim,
                                                                    std::vector<double>(containerSize),
                                                                    pair.second.target);
                 assert(ret.second);
+                sources.push_back(&pair.second.data);
+                targets.push_back(&globalCellData_.data(key));
             }
 
-            MessageBufferType buffer;
-            pack(0, buffer);
-
             // the last index map is the local one
-            doUnpack(indexMaps.back(), buffer);
+            gatherCells(sources, targets, localIndexMap_, indexMaps.back());
         }
     }
 
@@ -315,6 +366,8 @@ public:
 
         // write all cell data registered in local state
         for (const auto& pair : localCellData_) {
+            if (skip(pair.first))
+                continue;
             const auto& data = pair.second.data;
 
             // write all data from local data to buffer
@@ -328,6 +381,8 @@ public:
         // its order governs the order the data got received.
         for (auto& pair : localCellData_) {
             const std::string& key = pair.first;
+            if (skip(key))
+                continue;
             auto& data = globalCellData_.data(key);
 
             //write all data from local cell data to buffer
@@ -376,6 +431,98 @@ protected:
     }
 };
 
+class DistributeCellData : public P2PCommunicatorType::DataHandleInterface
+{
+    const data::Solution& globalCellData_;
+    data::Solution& localCellData_;
+
+    const IndexMapType& localIndexMap_;
+    const IndexMapStorageType& indexMaps_;
+
+public:
+    DistributeCellData(const data::Solution& globalCellData,
+                       data::Solution& localCellData,
+                       const IndexMapType& localIndexMap,
+                       const IndexMapStorageType& indexMaps,
+                       size_t localSize,
+                       bool isIORank)
+        : globalCellData_(globalCellData)
+        , localCellData_(localCellData)
+        , localIndexMap_(localIndexMap)
+        , indexMaps_(indexMaps)
+        , localSize_(localSize)
+    {
+        if (isIORank) {
+            std::vector<const std::vector<double>*> sources;
+            std::vector<std::vector<double>*> targets;
+            for (const auto& pair : globalCellData_) {
+                localCellData_.insert(pair.first, pair.second.dim,
+                                      std::vector<double>(localSize_, 0.0),
+                                      pair.second.target);
+                sources.push_back(&pair.second.data);
+                targets.push_back(&localCellData_.data(pair.first));
+            }
+
+            // the last index map is the local one
+            gatherCells(sources, targets, indexMaps.back(), localIndexMap_);
+        }
+    }
+
+    // pack the values of the cells of the rank associated with link
+    void pack(int link, MessageBufferType& buffer)
+    { doPack(indexMaps_[link], buffer); }
+
+    void doPack(const IndexMapType& indexMap, MessageBufferType& buffer)
+    {
+        unsigned int numFields = globalCellData_.size();
+        buffer.write(numFields);
+        for (const auto& pair : globalCellData_) {
+            buffer.write(pair.first);
+            buffer.write(static_cast<int>(pair.second.dim));
+            buffer.write(static_cast<int>(pair.second.target));
+
+            const auto& data = pair.second.data;
+            unsigned int size = indexMap.size();
+            buffer.write(size);
+            for (unsigned int i = 0; i < size; ++i) {
+                assert(static_cast<std::size_t>(indexMap[i]) < data.size());
+                buffer.write(data[indexMap[i]]);
+            }
+        }
+    }
+
+    // unpack the values of the local cells sent by the I/O rank
+    void unpack(int /*link*/, MessageBufferType& buffer)
+    {
+        unsigned int numFields = 0;
+        buffer.read(numFields);
+        for (unsigned int field = 0; field < numFields; ++field) {
+            std::string key;
+            int dim = 0;
+            int target = 0;
+            buffer.read(key);
+            buffer.read(dim);
+            buffer.read(target);
+
+            std::vector<double> data(localSize_, 0.0);
+            unsigned int size = 0;
+            buffer.read(size);
+            assert(size == localIndexMap_.size());
+            for (unsigned int i = 0; i < size; ++i) {
+                assert(static_cast<std::size_t>(localIndexMap_[i]) < data.size());
+                buffer.read(data[localIndexMap_[i]]);
+            }
+            localCellData_.insert(key,
+                                  static_cast<UnitSystem::measure>(dim),
+                                  std::move(data),
+                                  static_cast<data::TargetType>(target));
+        }
+    }
+
+private:
+    size_t localSize_;
+};
+
 class PackUnPackWellData : public P2PCommunicatorType::DataHandleInterface
 {
     const data::Wells& localWellData_;
@@ -669,14 +816,43 @@ private:
     }
 };
 
+// Packs the data of several handles into the same message, such that they
+// are sent to the I/O rank in a single exchange. The data of each handle
+// is self-delimiting, so the handles just read their part in turn.
+class PackUnPackCombined : public P2PCommunicatorType::DataHandleInterface
+{
+    std::vector<P2PCommunicatorType::DataHandleInterface*> handles_;
+
+public:
+    explicit PackUnPackCombined(std::vector<P2PCommunicatorType::DataHandleInterface*> handles)
+        : handles_(std::move(handles))
+    {}
+
+    // pack all data associated with link
+    void pack(int link, MessageBufferType& buffer)
+    {
+        for (auto* handle : handles_)
+            handle->pack(link, buffer);
+    }
+
+    // unpack all data associated with link
+    void unpack(int link, MessageBufferType& buffer)
+    {
+        for (auto* handle : handles_)
+            handle->unpack(link, buffer);
+    }
+};
+
 
 template <class Grid, class EquilGrid, class GridView>
 CollectDataToIORank<Grid,EquilGrid,GridView>::
 CollectDataToIORank(const Grid& grid, const EquilGrid* equilGrid,
                     const GridView& localGridView,
                     const Dune::CartesianIndexMapper<Grid>& cartMapper,
-                    const Dune::CartesianIndexMapper<EquilGrid>* equilCartMapper)
+                    const Dune::CartesianIndexMapper<EquilGrid>* equilCartMapper,
+                    bool collectCellDataPerField)
     : toIORankComm_()
+    , collectCellDataPerField_(collectCellDataPerField)
 {
     // index maps only have to be build when reordering is needed
     if (!needsReordering && !isParallel())
@@ -772,6 +948,8 @@ CollectDataToIORank(const Grid& grid, const EquilGrid* equilGrid,
 
         // insert send and recv linkage to communicator
         toIORankComm_.insertRequest(send, recv);
+        // and the opposite direction for distributing data
+        fromIORankComm_.insertRequest(recv, send);
 
         // need an index map for each rank
         indexMaps_.clear();
@@ -809,19 +987,38 @@ collect(const data::Solution& localCellData,
     if(!needsReordering && !isParallel())
         return;
 
-    // this also linearises the local buffers on ioRank
-    PackUnPackCellData packUnpackCellData {
-        localCellData,
-        this->globalCellData_,
-        this->localIndexMap_,
-        this->indexMaps_,
-        this->numCells(),
-        this->isIORank()
-    };
+    if (isParallel() && collectCellDataPerField_) {
+        // one exchange per field, all ranks hold the same fields in the same order
+        for (const auto& pair : localCellData) {
+            PackUnPackCellData packUnpackField {
+                localCellData,
+                this->globalCellData_,
+                this->localIndexMap_,
+                this->indexMaps_,
+                this->numCells(),
+                this->isIORank(),
+                &pair.first
+            };
+            toIORankComm_.exchange(packUnpackField);
+        }
+    }
+    else {
+        // this also linearises the local buffers on ioRank
+        PackUnPackCellData packUnpackCellData {
+            localCellData,
+            this->globalCellData_,
+            this->localIndexMap_,
+            this->indexMaps_,
+            this->numCells(),
+            this->isIORank()
+        };
+
+        if (! isParallel()) {
+            // no need to collect anything.
+            return;
+        }
 
-    if (! isParallel()) {
-        // no need to collect anything.
-        return;
+        toIORankComm_.exchange(packUnpackCellData);
     }
 
     PackUnPackWellData packUnpackWellData {
@@ -854,12 +1051,16 @@ collect(const data::Solution& localCellData,
                 this->isIORank()
     };
 
-    toIORankComm_.exchange(packUnpackCellData);
-    toIORankComm_.exchange(packUnpackWellData);
-    toIORankComm_.exchange(packUnpackGroupAndNetworkData);
-    toIORankComm_.exchange(packUnpackBlockData);
-    toIORankComm_.exchange(packUnpackWBPData);
-    toIORankComm_.exchange(packUnpackAquiferData);
+    // the well, group, block and aquifer data is small, send it in a single
+    // message per rank instead of synchronising for each kind separately
+    PackUnPackCombined packUnpackReportData {
+        {&packUnpackWellData,
+         &packUnpackGroupAndNetworkData,
+         &packUnpackBlockData,
+         &packUnpackWBPData,
+         &packUnpackAquiferData}
+    };
+    toIORankComm_.exchange(packUnpackReportData);
 
 #ifndef NDEBUG
     // make sure every process is on the same page
@@ -867,6 +1068,28 @@ collect(const data::Solution& localCellData,
 #endif
 }
 
+template <class Grid, class EquilGrid, class GridView>
+void CollectDataToIORank<Grid,EquilGrid,GridView>::
+distribute(const data::Solution& globalCellData,
+           data::Solution& localCellData)
+{
+    localCellData = {};
+
+    if (!isParallel())
+        throw std::logic_error("distributing cell data requires a parallel run");
+
+    DistributeCellData distributeCellData {
+        globalCellData,
+        localCellData,
+        this->localIndexMap_,
+        this->indexMaps_,
+        this->localIdxToGlobalIdx_.size(),
+        this->isIORank()
+    };
+
+    fromIORankComm_.exchange(distributeCellData);
+}
+
 template <class Grid, class EquilGrid, class GridView>
 int CollectDataToIORank<Grid,EquilGrid,GridView>::
 localIdxToGlobalIdx(unsigned localIdx) const
@@ -895,6 +1118,22 @@ isCartIdxOnThisRank(int cartIdx) const
     return (candidate != sortedCartesianIdx_.end() && *candidate == cartIdx);
 }
 
+template <class Grid, class EquilGrid, class GridView>
+std::size_t CollectDataToIORank<Grid,EquilGrid,GridView>::
+memoryUsage() const
+{
+    std::size_t bytes = Opm::memoryUsage(globalCartesianIndex_)
+        + Opm::memoryUsage(localIndexMap_)
+        + Opm::memoryUsage(globalRanks_)
+        + Opm::memoryUsage(localIdxToGlobalIdx_)
+        + Opm::memoryUsage(sortedCartesianIdx_);
+    for (const auto& indexMap : indexMaps_)
+        bytes += Opm::memoryUsage(indexMap);
+    for (const auto& pair : globalCellData_)
+        bytes += Opm::memoryUsage(pair.second.data);
+    return bytes;
+}
+
 
 
 #if HAVE_DUNE_FEM
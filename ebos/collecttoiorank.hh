@@ -61,7 +61,8 @@ public:
                         const EquilGrid* equilGrid,
                         const GridView& gridView,
                         const Dune::CartesianIndexMapper<Grid>& cartMapper,
-                        const Dune::CartesianIndexMapper<EquilGrid>* equilCartMapper);
+                        const Dune::CartesianIndexMapper<EquilGrid>* equilCartMapper,
+                        bool collectCellDataPerField = false);
 
     // gather solution to rank 0 for EclipseWriter
     void collect(const data::Solution& localCellData,
@@ -71,6 +72,12 @@ public:
                  const data::GroupAndNetworkValues& localGroupAndNetworkData,
                  const data::Aquifers& localAquiferData);
 
+    // distribute a solution on the I/O rank, e.g. read from a restart file,
+    // to the local cells of all ranks. The result is indexed by the local
+    // element index.
+    void distribute(const data::Solution& globalCellData,
+                    data::Solution& localCellData);
+
     const std::map<std::size_t, double>& globalWBPData() const
     { return this->globalWBPData_; }
 
@@ -105,8 +112,12 @@ public:
 
     bool isCartIdxOnThisRank(int cartIdx) const;
 
+    //! \brief The bytes of the index maps and of the collected cell data.
+    std::size_t memoryUsage() const;
+
 protected:
     P2PCommunicatorType toIORankComm_;
+    P2PCommunicatorType fromIORankComm_;
     IndexMapType globalCartesianIndex_;
     IndexMapType localIndexMap_;
     IndexMapStorageType indexMaps_;
@@ -122,6 +133,11 @@ protected:
     ///
     /// non-empty only when running in parallel
     std::vector<int> sortedCartesianIdx_;
+    /// \brief gather the cell data one field at a time
+    ///
+    /// The I/O rank then only holds the receive buffers of a single
+    /// field instead of those of the complete solution.
+    bool collectCellDataPerField_;
 };
 
 } // end namespace Opm
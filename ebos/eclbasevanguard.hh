@@ -38,9 +38,11 @@
 #include <opm/parser/eclipse/EclipseState/Aquifer/NumericalAquifer/NumericalAquiferCell.hpp>
 #include <opm/simulators/flow/BlackoilModelParametersEbos.hpp>
 
+#include <algorithm>
 #include <array>
 #include <optional>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace Opm {
@@ -98,11 +100,21 @@ struct ZoltanImbalanceTol {
     using type = UndefinedProperty;
 };
 
+template<class TypeTag, class MyTypeTag>
+struct StructuredPartitioning {
+    using type = UndefinedProperty;
+};
+
 template<class TypeTag, class MyTypeTag>
 struct AllowDistributedWells {
     using type = UndefinedProperty;
 };
 
+template<class TypeTag, class MyTypeTag>
+struct TransmissibilityCache {
+    using type = UndefinedProperty;
+};
+
 template<class TypeTag>
 struct IgnoreKeywords<TypeTag, TTag::EclBaseVanguard> {
     static constexpr auto value = "";
@@ -145,10 +157,19 @@ struct ZoltanImbalanceTol<TypeTag, TTag::EclBaseVanguard> {
     static constexpr double value = 1.1;
 };
 
+template<class TypeTag>
+struct StructuredPartitioning<TypeTag, TTag::EclBaseVanguard> {
+    static constexpr bool value = false;
+};
+
 template<class TypeTag>
 struct AllowDistributedWells<TypeTag, TTag::EclBaseVanguard> {
     static constexpr bool value = false;
 };
+template<class TypeTag>
+struct TransmissibilityCache<TypeTag, TTag::EclBaseVanguard> {
+    static constexpr auto value = "";
+};
 
 template<class T1, class T2>
 struct UseMultisegmentWell;
@@ -215,8 +236,12 @@ public:
                              "Perform partitioning for parallel runs on a single process.");
         EWOMS_REGISTER_PARAM(TypeTag, double, ZoltanImbalanceTol,
                              "Tolerable imbalance of the loadbalancing provided by Zoltan (default: 1.1).");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, StructuredPartitioning,
+                             "Partition the grid by bisection of its (I,J) columns instead of with Zoltan, keeping the wells whole.");
         EWOMS_REGISTER_PARAM(TypeTag, bool, AllowDistributedWells,
                              "Allow the perforations of a well to be distributed to interior of multiple processes");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, TransmissibilityCache,
+                             "The prefix of the files which keep the transmissibilities and the NNCs between runs, they are reused as long as the GRID, EDIT and REGIONS sections of the deck do not change. Disabled if empty.");
         // register here for the use in the tests without BlackoildModelParametersEbos
         EWOMS_REGISTER_PARAM(TypeTag, bool, UseMultisegmentWell, "Use the well model for multi-segment wells instead of the one for single-segment wells");
 
@@ -236,7 +261,9 @@ public:
         ownersFirst_ = EWOMS_GET_PARAM(TypeTag, bool, OwnerCellsFirst);
         serialPartitioning_ = EWOMS_GET_PARAM(TypeTag, bool, SerialPartitioning);
         zoltanImbalanceTol_ = EWOMS_GET_PARAM(TypeTag, double, ZoltanImbalanceTol);
+        structuredPartitioning_ = EWOMS_GET_PARAM(TypeTag, bool, StructuredPartitioning);
         enableDistributedWells_ = EWOMS_GET_PARAM(TypeTag, bool, AllowDistributedWells);
+        transmissibilityCache_ = EWOMS_GET_PARAM(TypeTag, std::string, TransmissibilityCache);
         ignoredKeywords_ = EWOMS_GET_PARAM(TypeTag, std::string, IgnoreKeywords);
         eclStrictParsing_ = EWOMS_GET_PARAM(TypeTag, bool, EclStrictParsing);
         int output_param = EWOMS_GET_PARAM(TypeTag, int, EclOutputInterval);
@@ -297,8 +324,18 @@ public:
      */
     int compressedIndex(int cartesianCellIdx) const
     {
-        int index = cartesianToCompressed_[cartesianCellIdx];
-        return index;
+        if (!cartesianToCompressed_.empty()) {
+            int index = cartesianToCompressed_[cartesianCellIdx];
+            return index;
+        }
+
+        // compact mapping, sorted by the cartesian index
+        const auto it = std::lower_bound(sortedCartesianIndices_.begin(),
+                                         sortedCartesianIndices_.end(),
+                                         cartesianCellIdx);
+        if (it == sortedCartesianIndices_.end() || *it != cartesianCellIdx)
+            return -1;
+        return sortedCompressedIndices_[it - sortedCartesianIndices_.begin()];
     }
 
     /*!
@@ -399,10 +436,32 @@ protected:
     void updateCartesianToCompressedMapping_()
     {
         size_t num_cells = asImp_().grid().leafGridView().size(0);
-        cartesianToCompressed_.resize(cartesianSize(), -1);
-        for (unsigned i = 0; i < num_cells; ++i) {
-            unsigned cartesianCellIdx = cartesianIndex(i);
-            cartesianToCompressed_[cartesianCellIdx] = i;
+        cartesianToCompressed_.clear();
+        sortedCartesianIndices_.clear();
+        sortedCompressedIndices_.clear();
+
+        // A vector over the whole cartesian box takes one int per cartesian
+        // cell, the compact mapping two per local cell. The latter is smaller
+        // for distributed grids and for boxes with few active cells.
+        if (2*num_cells >= static_cast<size_t>(cartesianSize())) {
+            cartesianToCompressed_.resize(cartesianSize(), -1);
+            for (unsigned i = 0; i < num_cells; ++i) {
+                unsigned cartesianCellIdx = cartesianIndex(i);
+                cartesianToCompressed_[cartesianCellIdx] = i;
+            }
+            return;
+        }
+
+        std::vector<std::pair<int, int>> cells;
+        cells.reserve(num_cells);
+        for (unsigned i = 0; i < num_cells; ++i)
+            cells.emplace_back(cartesianIndex(i), i);
+        std::sort(cells.begin(), cells.end());
+        sortedCartesianIndices_.reserve(num_cells);
+        sortedCompressedIndices_.reserve(num_cells);
+        for (const auto& [cartesianCellIdx, compressedCellIdx] : cells) {
+            sortedCartesianIndices_.push_back(cartesianCellIdx);
+            sortedCompressedIndices_.push_back(compressedCellIdx);
         }
     }
 
@@ -484,6 +543,14 @@ protected:
      */
     std::vector<int> cartesianToCompressed_;
 
+    /*! \brief Compact mapping between cartesian and compressed cells, used
+     *  instead of cartesianToCompressed_ if the grid has few cells compared
+     *  to the cartesian box: the cartesian indices of the cells in ascending
+     *  order and their compressed indices.
+     */
+    std::vector<int> sortedCartesianIndices_;
+    std::vector<int> sortedCompressedIndices_;
+
     /*! \brief Cell center depths
      */
     std::vector<Scalar> cellCenterDepth_;
@@ -133,7 +133,8 @@ public:
 #if HAVE_MPI
         this->doLoadBalance_(this->edgeWeightsMethod(), this->ownersFirst(),
                              this->serialPartitioning(), this->enableDistributedWells(),
-                             this->zoltanImbalanceTol(), this->gridView(),
+                             this->zoltanImbalanceTol(), this->structuredPartitioning(),
+                             this->gridView(),
                              this->schedule(), this->centroids_,
                              this->eclState(), this->parallelWells_);
 #endif
@@ -165,7 +166,9 @@ protected:
                                                     this->cellCentroids(),
                                                     getPropValue<TypeTag, Properties::EnableEnergy>(),
                                                     getPropValue<TypeTag, Properties::EnableDiffusion>()));
-        globalTrans_->update(false);
+        globalTrans_->updateCached(false,
+                                   this->transmissibilityCacheFile(/*global=*/true),
+                                   this->transmissibilityCacheKey());
     }
 
     double getTransmissibility(unsigned I, unsigned J) override
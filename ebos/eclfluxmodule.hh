@@ -33,6 +33,7 @@
 
 #include <opm/models/discretization/common/fvbaseproperties.hh>
 #include <opm/models/blackoil/blackoilproperties.hh>
+#include <opm/models/utils/parametersystem.hh>
 #include <opm/models/utils/signum.hh>
 
 #include <opm/material/common/Valgrind.hpp>
@@ -40,6 +41,26 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace Opm::Properties {
+
+template<class TypeTag, class MyTypeTag>
+struct EclFluxReuseTolerance {
+    using type = UndefinedProperty;
+};
+
+template<class TypeTag, class MyTypeTag>
+struct EclAdaptiveImplicitCfl {
+    using type = UndefinedProperty;
+};
+
+} // namespace Opm::Properties
+
 namespace Opm {
 
 template <class TypeTag>
@@ -66,17 +87,233 @@ struct EclTransFluxModule
      * \brief Register all run-time parameters for the flux module.
      */
     static void registerParameters()
-    { }
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, GetPropType<TypeTag, Properties::Scalar>, EclFluxReuseTolerance,
+                             "Reuse the fluxes and their derivatives of the previous linearization for faces "
+                             "whose cells changed less than this relative amount, 0 always recomputes them");
+        EWOMS_REGISTER_PARAM(TypeTag, GetPropType<TypeTag, Properties::Scalar>, EclAdaptiveImplicitCfl,
+                             "Treat the saturations of the cells whose throughput in the last time step was "
+                             "below this fraction of their pore volume explicitly in the fluxes, 0 makes all "
+                             "cells fully implicit");
+    }
 };
 
 /*!
  * \ingroup EclBlackOilSimulator
  * \brief Provides the defaults for the parameters required by the
  *        transmissibility based volume flux calculation.
+ *
+ * It also keeps the fluxes of the previous linearizations for the incremental
+ * linearization: the fluxes of a face are reused as long as the primary variables of
+ * both adjacent cells changed less than EclFluxReuseTolerance (relative to the values
+ * at which the fluxes were computed) and kept their meaning. This skips the gravity
+ * corrected pressure differences and upwinding in quiescent regions, at the price of
+ * slightly inexact derivatives there.
+ *
+ * For the adaptive implicit formulation it keeps the outflow of the faces of the last
+ * linearization. At the end of a time step the cells whose outflow over the step was
+ * below EclAdaptiveImplicitCfl times their pore volume are marked explicit, the fluxes
+ * out of them then use the mobilities at the start of the time step, such that only the
+ * pressure of these cells is implicit.
  */
 template <class TypeTag>
 class EclTransBaseProblem
-{ };
+{
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
+    using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
+    using PrimaryVariables = GetPropType<TypeTag, Properties::PrimaryVariables>;
+
+    enum { numPhases = FluidSystem::numPhases };
+
+public:
+    //! The quantities of a face which are computed by the flux module
+    struct FaceFluxes
+    {
+        bool valid = false;
+        Evaluation pressureDifference[numPhases];
+        Evaluation volumeFlux[numPhases];
+        short upIdx[numPhases];
+        short dnIdx[numPhases];
+    };
+
+    EclTransBaseProblem()
+    {
+        fluxReuseTolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, EclFluxReuseTolerance);
+        adaptiveImplicitCfl_ = EWOMS_GET_PARAM(TypeTag, Scalar, EclAdaptiveImplicitCfl);
+    }
+
+    /*!
+     * \brief Returns true if the fluxes of faces may be reused between linearizations.
+     */
+    bool fluxReuseEnabled() const
+    { return fluxReuseTolerance_ > 0.0; }
+
+    /*!
+     * \brief Decide which cells changed since the fluxes of their faces were computed.
+     *
+     * This must be called before each linearization, the reference solution of the
+     * changed cells is updated.
+     */
+    template <class SolutionVector>
+    void updateFluxReuse(const SolutionVector& solution)
+    {
+        if (!fluxReuseEnabled())
+            return;
+
+        const std::size_t numCells = solution.size();
+        if (referenceSolution_.size() != numCells) {
+            referenceSolution_.assign(solution.begin(), solution.end());
+            cellChanged_.assign(numCells, 1);
+            faceFluxes_.clear();
+            faceFluxes_.resize(numCells);
+            return;
+        }
+
+        for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            const auto& priVars = solution[cellIdx];
+            auto& reference = referenceSolution_[cellIdx];
+            bool changed = priVars.primaryVarsMeaning() != reference.primaryVarsMeaning();
+            for (unsigned pvIdx = 0; pvIdx < priVars.size() && !changed; ++pvIdx) {
+                const Scalar scale = std::max(std::abs(reference[pvIdx]), Scalar(1.0));
+                changed = std::abs(priVars[pvIdx] - reference[pvIdx]) > fluxReuseTolerance_*scale;
+            }
+            cellChanged_[cellIdx] = changed;
+            if (changed)
+                reference = priVars;
+        }
+    }
+
+    /*!
+     * \brief Forget all stored fluxes, e.g. because the transmissibilities may have changed.
+     */
+    void invalidateFluxReuse()
+    {
+        referenceSolution_.clear();
+        cellChanged_.clear();
+        faceFluxes_.clear();
+    }
+
+    /*!
+     * \brief Returns the stored fluxes of an interior face of a cell if they can be
+     *        reused, nullptr otherwise.
+     */
+    const FaceFluxes* reusableFaceFluxes(unsigned I, unsigned J, unsigned scvfIdx) const
+    {
+        if (faceFluxes_.empty() || cellChanged_[I] || cellChanged_[J])
+            return nullptr;
+        const auto& faces = faceFluxes_[I];
+        if (scvfIdx >= faces.size() || !faces[scvfIdx].valid)
+            return nullptr;
+        return &faces[scvfIdx];
+    }
+
+    /*!
+     * \brief Returns the storage for the fluxes of an interior face of a cell.
+     *
+     * Only the thread which linearizes cell I may call this.
+     */
+    FaceFluxes* faceFluxesStorage(unsigned I, unsigned scvfIdx) const
+    {
+        if (faceFluxes_.empty())
+            return nullptr;
+        auto& faces = faceFluxes_[I];
+        if (scvfIdx >= faces.size())
+            faces.resize(scvfIdx + 1);
+        return &faces[scvfIdx];
+    }
+
+    /*!
+     * \brief Returns true if the adaptive implicit formulation is used.
+     */
+    bool adaptiveImplicitEnabled() const
+    { return adaptiveImplicitCfl_ > 0.0; }
+
+    /*!
+     * \brief Returns the mobilities at the start of the time step if the cell is
+     *        explicit in the saturations, nullptr if it is fully implicit.
+     */
+    const Scalar* explicitMobilities(unsigned I) const
+    {
+        if (I >= explicitCell_.size() || !explicitCell_[I])
+            return nullptr;
+        return explicitMobility_[I].data();
+    }
+
+    /*!
+     * \brief Store the volumetric outflow of an interior face of a cell.
+     *
+     * Only the thread which linearizes cell I may call this.
+     */
+    void storeFaceOutflow(unsigned I, unsigned scvfIdx, Scalar rate) const
+    {
+        if (faceOutflow_.size() <= I)
+            return;
+        auto& faces = faceOutflow_[I];
+        if (scvfIdx >= faces.size())
+            faces.resize(scvfIdx + 1, 0.0);
+        faces[scvfIdx] = rate;
+    }
+
+    /*!
+     * \brief Decide which cells are explicit in the saturations in the next time step.
+     *
+     * This must be called at the end of each time step, the outflows of the last
+     * linearization are compared to the pore volumes of the cells. Cells whose outflow
+     * is unknown, e.g. the ones which are not linearized on this process, stay implicit.
+     */
+    template <class Model>
+    void updateAdaptiveImplicit(const Model& model, Scalar dt)
+    {
+        if (!adaptiveImplicitEnabled())
+            return;
+
+        const std::size_t numCells = model.numGridDof();
+        if (faceOutflow_.size() != numCells) {
+            faceOutflow_.clear();
+            faceOutflow_.resize(numCells);
+            explicitCell_.assign(numCells, 0);
+            explicitMobility_.resize(numCells);
+            return;
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            const auto* intQuants = model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0);
+            const auto& faces = faceOutflow_[cellIdx];
+            explicitCell_[cellIdx] = 0;
+            if (!intQuants || faces.empty())
+                continue;
+
+            Scalar outflow = 0.0;
+            for (const Scalar rate : faces)
+                outflow += rate;
+            const Scalar poreVolume =
+                model.dofTotalVolume(cellIdx)*Toolbox::value(intQuants->porosity());
+            if (poreVolume <= 0.0 || dt*outflow >= adaptiveImplicitCfl_*poreVolume)
+                continue;
+
+            explicitCell_[cellIdx] = 1;
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                explicitMobility_[cellIdx][phaseIdx] = FluidSystem::phaseIsActive(phaseIdx)
+                    ? Toolbox::value(intQuants->mobility(phaseIdx)) : 0.0;
+        }
+    }
+
+private:
+    using Toolbox = MathToolbox<Evaluation>;
+
+    Scalar fluxReuseTolerance_;
+    Scalar adaptiveImplicitCfl_;
+    std::vector<char> explicitCell_;
+    std::vector<std::array<Scalar, numPhases>> explicitMobility_;
+    mutable std::vector<std::vector<Scalar>> faceOutflow_;
+    std::vector<PrimaryVariables> referenceSolution_;
+    std::vector<char> cellChanged_;
+    mutable std::vector<std::vector<FaceFluxes>> faceFluxes_;
+};
 
 /*!
  * \ingroup EclBlackOilSimulator
@@ -224,9 +461,25 @@ protected:
         unsigned I = stencil.globalSpaceIndex(interiorDofIdx_);
         unsigned J = stencil.globalSpaceIndex(exteriorDofIdx_);
 
+        // the stored derivatives are with respect to the interior degree of freedom
+        const bool reuseFluxes =
+            timeIdx == 0 && problem.fluxReuseEnabled() && elemCtx.focusDofIndex() == interiorDofIdx_;
+        if (reuseFluxes) {
+            const auto* cached = problem.reusableFaceFluxes(I, J, scvfIdx);
+            if (cached) {
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                    pressureDifference_[phaseIdx] = cached->pressureDifference[phaseIdx];
+                    volumeFlux_[phaseIdx] = cached->volumeFlux[phaseIdx];
+                    upIdx_[phaseIdx] = cached->upIdx[phaseIdx];
+                    dnIdx_[phaseIdx] = cached->dnIdx[phaseIdx];
+                }
+                return;
+            }
+        }
+
         Scalar trans = problem.transmissibility(elemCtx, interiorDofIdx_, exteriorDofIdx_);
         Scalar faceArea = scvf.area();
-        Scalar thpres = problem.thresholdPressure(I, J);
+        Scalar thpres = problem.thresholdPressure(elemCtx, interiorDofIdx_, exteriorDofIdx_);
 
         // estimate the gravity correction: for performance reasons we use a simplified
         // approach for this flux module that assumes that gravity is constant and always
@@ -248,6 +501,10 @@ protected:
         // exterior DOF)
         Scalar distZ = zIn - zEx;
 
+        // the factors of the phase loop which do not depend on the phase
+        const Scalar halfGravityHead = distZ*g/2;
+        const Scalar transPerArea = -trans/faceArea;
+
         for (unsigned phaseIdx=0; phaseIdx < numPhases; phaseIdx++) {
             if (!FluidSystem::phaseIsActive(phaseIdx))
                 continue;
@@ -265,20 +522,22 @@ protected:
             }
 
             // do the gravity correction: compute the hydrostatic pressure for the
-            // external at the depth of the internal one
+            // external at the depth of the internal one. Only the interior quantities
+            // carry derivatives, hence the terms of the exterior DOF are summed up as
+            // scalars first such that only the interior ones touch all derivatives.
             const Evaluation& rhoIn = intQuantsIn.fluidState().density(phaseIdx);
             Scalar rhoEx = Toolbox::value(intQuantsEx.fluidState().density(phaseIdx));
-            Evaluation rhoAvg = (rhoIn + rhoEx)/2;
 
             const Evaluation& pressureInterior = intQuantsIn.fluidState().pressure(phaseIdx);
-            Evaluation pressureExterior = Toolbox::value(intQuantsEx.fluidState().pressure(phaseIdx));
+            const Scalar pressureExterior = Toolbox::value(intQuantsEx.fluidState().pressure(phaseIdx))
+                + rhoEx*halfGravityHead;
             if (enableExtbo) // added stability; particulary useful for solvent migrating in pure water
                              // where the solvent fraction displays a 0/1 behaviour ...
-                pressureExterior += Toolbox::value(rhoAvg)*(distZ*g);
+                pressureDifference_[phaseIdx] =
+                    (pressureExterior + Toolbox::value(rhoIn)*halfGravityHead) - pressureInterior;
             else
-                pressureExterior += rhoAvg*(distZ*g);
-
-            pressureDifference_[phaseIdx] = pressureExterior - pressureInterior;
+                pressureDifference_[phaseIdx] =
+                    rhoIn*halfGravityHead + (pressureExterior - pressureInterior);
 
             // decide the upstream index for the phase. for this we make sure that the
             // degree of freedom which is regarded upstream if both pressures are equal
@@ -347,12 +606,47 @@ protected:
             const Evaluation& transMult =
                 problem.template rockCompTransMultiplier<Evaluation>(up, stencil.globalSpaceIndex(upstreamIdx));
 
-            if (upstreamIdx == interiorDofIdx_)
+            // with the adaptive implicit formulation, the saturations of an explicit
+            // upstream cell enter via the mobilities of the start of the time step
+            const Scalar* explicitMobility = (timeIdx == 0 && problem.adaptiveImplicitEnabled())
+                ? problem.explicitMobilities(stencil.globalSpaceIndex(upstreamIdx)) : nullptr;
+
+            if (explicitMobility != nullptr) {
+                if (upstreamIdx == interiorDofIdx_)
+                    volumeFlux_[phaseIdx] =
+                        pressureDifference_[phaseIdx]*(transMult*(explicitMobility[phaseIdx]*transPerArea));
+                else
+                    volumeFlux_[phaseIdx] =
+                        pressureDifference_[phaseIdx]*(explicitMobility[phaseIdx]*Toolbox::value(transMult)*transPerArea);
+            }
+            else if (upstreamIdx == interiorDofIdx_)
                 volumeFlux_[phaseIdx] =
-                    pressureDifference_[phaseIdx]*up.mobility(phaseIdx)*transMult*(-trans/faceArea);
+                    pressureDifference_[phaseIdx]*(up.mobility(phaseIdx)*(transMult*transPerArea));
             else
                 volumeFlux_[phaseIdx] =
-                    pressureDifference_[phaseIdx]*(Toolbox::value(up.mobility(phaseIdx))*Toolbox::value(transMult)*(-trans/faceArea));
+                    pressureDifference_[phaseIdx]*(Toolbox::value(up.mobility(phaseIdx))*Toolbox::value(transMult)*transPerArea);
+        }
+
+        if (timeIdx == 0 && problem.adaptiveImplicitEnabled() && elemCtx.focusDofIndex() == interiorDofIdx_) {
+            Scalar outflow = 0.0;
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                if (FluidSystem::phaseIsActive(phaseIdx) && upIdx_[phaseIdx] == interiorDofIdx_)
+                    outflow += std::abs(Toolbox::value(volumeFlux_[phaseIdx]))*faceArea;
+            }
+            problem.storeFaceOutflow(I, scvfIdx, outflow);
+        }
+
+        if (reuseFluxes) {
+            auto* storage = problem.faceFluxesStorage(I, scvfIdx);
+            if (storage) {
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                    storage->pressureDifference[phaseIdx] = pressureDifference_[phaseIdx];
+                    storage->volumeFlux[phaseIdx] = volumeFlux_[phaseIdx];
+                    storage->upIdx[phaseIdx] = upIdx_[phaseIdx];
+                    storage->dnIdx[phaseIdx] = dnIdx_[phaseIdx];
+                }
+                storage->valid = true;
+            }
         }
     }
 
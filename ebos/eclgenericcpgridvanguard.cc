@@ -34,6 +34,8 @@
 #include <opm/simulators/utils/ParallelEclipseState.hpp>
 #include <opm/simulators/utils/PropsCentroidsDataHandle.hpp>
 #include <opm/simulators/utils/ParallelSerialization.hpp>
+#include <opm/simulators/utils/StartupProfile.hpp>
+#include <opm/simulators/utils/StructuredPartitioner.hpp>
 
 #include <dune/common/version.hh>
 #include <dune/grid/common/mcmgmapper.hh>
@@ -78,12 +80,15 @@ void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::doLoadBalance_(Dun
                                                                              bool serialPartitioning,
                                                                              bool enableDistributedWells,
                                                                              double zoltanImbalanceTol,
+                                                                             bool structuredPartitioning,
                                                                              const GridView& gridv,
                                                                              const Schedule& schedule,
                                                                              std::vector<double>& centroids,
                                                                              EclipseState& eclState1,
                                                                              EclGenericVanguard::ParallelWellStruct& parallelWells)
 {
+    StartupProfile::Phase profilePhase("load balancing");
+
     int mpiSize = 1;
     MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
 
@@ -106,7 +111,9 @@ void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::doLoadBalance_(Dun
         std::vector<double> faceTrans;
         int loadBalancerSet = externalLoadBalancer.has_value();
         grid_->comm().broadcast(&loadBalancerSet, 1, 0);
-        if (!loadBalancerSet){
+        // the structured partitioning does not need the edge weights either
+        const bool usePartsVector = loadBalancerSet || structuredPartitioning;
+        if (!usePartsVector){
             faceTrans.resize(numFaces, 0.0);
             ElementMapper elemMapper(gridv, Dune::mcmgElementLayout());
             auto elemIt = gridView.template begin</*codim=*/0>();
@@ -147,13 +154,30 @@ void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::doLoadBalance_(Dun
 
                 PropsCentroidsDataHandle<Dune::CpGrid> handle(*grid_, eclState, eclGrid, centroids,
                                                               cartesianIndexMapper());
-                if (loadBalancerSet)
+                if (usePartsVector)
                 {
                     std::vector<int> parts;
-                    if (grid_->comm().rank() == 0)
+                    if (grid_->comm().rank() == 0 && loadBalancerSet)
                     {
                         parts =  (*externalLoadBalancer)(*grid_);
                     }
+                    else if (grid_->comm().rank() == 0)
+                    {
+                        std::vector<int> cartesianIndices(grid_->size(0));
+                        for (std::size_t cell = 0; cell < cartesianIndices.size(); ++cell)
+                            cartesianIndices[cell] = cartesianIndexMapper_->cartesianIndex(cell);
+
+                        std::vector<std::vector<int>> wellCells;
+                        wellCells.reserve(wells.size());
+                        for (const auto& well : wells) {
+                            auto& cells = wellCells.emplace_back();
+                            for (const auto& connection : well.getConnections())
+                                cells.push_back(connection.global_index());
+                        }
+                        parts = structuredColumnPartition(cartesianIndexMapper_->cartesianDimensions(),
+                                                          cartesianIndices, grid_->comm().size(),
+                                                          wellCells);
+                    }
                     parallelWells = std::get<1>(grid_->loadBalance(handle, parts, &wells, ownersFirst, false, 1));
                 }
                 else
@@ -219,6 +243,8 @@ void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::allocCartMapper()
 template<class ElementMapper, class GridView, class Scalar>
 void EclGenericCpGridVanguard<ElementMapper,GridView,Scalar>::doCreateGrids_(EclipseState& eclState)
 {
+    StartupProfile::Phase profilePhase("grid processing");
+
     const EclipseGrid* input_grid = nullptr;
     std::vector<double> global_porv;
     // At this stage the ParallelEclipseState instance is still in global
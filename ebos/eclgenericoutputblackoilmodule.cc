@@ -37,10 +37,16 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/SummaryState.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
 #include <cassert>
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
 namespace {
 
@@ -766,36 +772,6 @@ setRestart(const data::Solution& sol,
         ppcw_[elemIdx] = sol.data("PPCW")[globalDofIndex];
 }
 
-template<class FluidSystem,class Scalar>
-typename EclGenericOutputBlackoilModule<FluidSystem,Scalar>::ScalarBuffer
-EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
-regionSum(const ScalarBuffer& property,
-          const std::vector<int>& regionId,
-          size_t maxNumberOfRegions,
-          const Comm& comm)
-{
-        ScalarBuffer totals(maxNumberOfRegions, 0.0);
-
-        if (property.empty())
-            return totals;
-
-        assert(regionId.size() == property.size());
-        for (size_t j = 0; j < regionId.size(); ++j) {
-            const int regionIdx = regionId[j] - 1;
-            // the cell is not attributed to any region. ignore it!
-            if (regionIdx < 0)
-                continue;
-
-            assert(regionIdx < static_cast<int>(maxNumberOfRegions));
-            totals[regionIdx] += property[j];
-        }
-
-        for (size_t i = 0; i < maxNumberOfRegions; ++i)
-            totals[i] = comm.sum(totals[i]);
-
-        return totals;
-    }
-
 template<class FluidSystem, class Scalar>
 void EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
 doAllocBuffers(unsigned bufferSize,
@@ -878,6 +854,11 @@ doAllocBuffers(unsigned bufferSize,
         }
     }
 
+    // The cell data of the previous output step must not be computed again
+    // on steps where it is not written. The buffers keep their memory such
+    // that the next output step can reuse it.
+    clearCellBuffers_();
+
     // field data should be allocated
     // 1) when we want to restart
     // 2) when it is ask for by the user via restartConfig
@@ -1060,6 +1041,33 @@ doAllocBuffers(unsigned bufferSize,
 
 }
 
+template<class FluidSystem, class Scalar>
+void EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
+clearCellBuffers_()
+{
+    for (auto* buffer : {&gasFormationVolumeFactor_, &oilPressure_, &temperature_,
+                         &rs_, &rv_, &overburdenPressure_, &oilSaturationPressure_,
+                         &sSol_, &cPolymer_, &cFoam_, &cSalt_,
+                         &extboX_, &extboY_, &extboZ_, &mFracOil_, &mFracGas_, &mFracCo2_,
+                         &soMax_, &pcSwMdcOw_, &krnSwMdcOw_, &pcSwMdcGo_, &krnSwMdcGo_,
+                         &ppcw_, &gasDissolutionFactor_, &oilVaporizationFactor_,
+                         &bubblePointPressure_, &dewPointPressure_,
+                         &rockCompPorvMultiplier_, &swMax_, &minimumOilPressure_,
+                         &saturatedOilFormationVolumeFactor_, &rockCompTransMultiplier_})
+        buffer->clear();
+
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+        saturation_[phaseIdx].clear();
+        invB_[phaseIdx].clear();
+        density_[phaseIdx].clear();
+        viscosity_[phaseIdx].clear();
+        relativePermeability_[phaseIdx].clear();
+    }
+
+    for (auto& concentration : tracerConcentrations_)
+        concentration.clear();
+}
+
 template<class FluidSystem, class Scalar>
 void EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
 fipUnitConvert_(std::unordered_map<Inplace::Phase, Scalar>& fip) const
@@ -1444,15 +1452,6 @@ outputFipLogImpl(const Inplace& inplace) const
     }
 }
 
-template<class FluidSystem,class Scalar>
-int EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
-regionMax(const std::vector<int>& region,
-          const Comm& comm)
-{
-    const auto max_value = region.empty() ? 0 : *std::max_element(region.begin(), region.end());
-    return comm.max(max_value);
-}
-
 template<class FluidSystem,class Scalar>
 void EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
 update(Inplace& inplace,
@@ -1469,32 +1468,102 @@ update(Inplace& inplace,
     inplace.add( phase, sum );
 }
 
-template<class FluidSystem,class Scalar>
-void EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
-makeRegionSum(Inplace& inplace,
-              const std::string& region_name,
-              const Comm& comm)
-{
-    const auto& region = this->regions_.at(region_name);
-    std::size_t ntFip = this->regionMax(region, comm);
-
-    update(inplace, region_name, Inplace::Phase::PressurePV, ntFip, this->regionSum(this->pressureTimesPoreVolume_, region, ntFip, comm));
-    update(inplace, region_name, Inplace::Phase::HydroCarbonPV, ntFip, this->regionSum(this->hydrocarbonPoreVolume_, region, ntFip, comm));
-    update(inplace, region_name, Inplace::Phase::PressureHydroCarbonPV, ntFip, this->regionSum(this->pressureTimesHydrocarbonVolume_, region, ntFip, comm));
-
-    for (const auto& phase : Inplace::phases())
-        update(inplace, region_name, phase, ntFip, this->regionSum(this->fip_[phase], region, ntFip, comm));
-}
-
 template<class FluidSystem,class Scalar>
 Inplace EclGenericOutputBlackoilModule<FluidSystem,Scalar>::
 accumulateRegionSums(const Comm& comm)
 {
     Inplace inplace;
 
-    for (const auto& [region_name, _] : this->regions_) {
-        (void)_;
-        makeRegionSum(inplace, region_name, comm);
+    // The properties which are summed for every region set. The sums of a
+    // region are stored contiguously in this order.
+    std::vector<std::pair<Inplace::Phase, const ScalarBuffer*>> properties {
+        {Inplace::Phase::PressurePV, &this->pressureTimesPoreVolume_},
+        {Inplace::Phase::HydroCarbonPV, &this->hydrocarbonPoreVolume_},
+        {Inplace::Phase::PressureHydroCarbonPV, &this->pressureTimesHydrocarbonVolume_},
+    };
+    for (const auto& phase : Inplace::phases())
+        properties.emplace_back(phase, &this->fip_[phase]);
+    const std::size_t numProperties = properties.size();
+
+    // empty properties contribute zeros, there is no need to visit them per cell
+    std::vector<std::size_t> activeProperties;
+    for (std::size_t p = 0; p < numProperties; ++p) {
+        if (!properties[p].second->empty())
+            activeProperties.push_back(p);
+    }
+
+    std::vector<std::pair<std::string, const std::vector<int>*>> regionSets;
+    for (const auto& [region_name, region] : this->regions_)
+        regionSets.emplace_back(region_name, &region);
+    const std::size_t numSets = regionSets.size();
+
+    // The number of regions of all region sets in a single reduction.
+    std::vector<int> ntFip(numSets, 0);
+    for (std::size_t s = 0; s < numSets; ++s) {
+        const auto& region = *regionSets[s].second;
+        ntFip[s] = region.empty() ? 0 : *std::max_element(region.begin(), region.end());
+    }
+    if (numSets > 0)
+        comm.max(ntFip.data(), numSets);
+
+    std::vector<std::size_t> offsets(numSets + 1, 0);
+    for (std::size_t s = 0; s < numSets; ++s)
+        offsets[s + 1] = offsets[s] + ntFip[s] * numProperties;
+
+    const int numCells = numSets > 0 ? regionSets[0].second->size() : 0;
+#ifdef _OPENMP
+    const int numThreads = omp_get_max_threads();
+#else
+    const int numThreads = 1;
+#endif
+    // One pass over the cells for all region sets. Every thread has its own
+    // buffer, the buffers are summed in thread order afterwards such that the
+    // result does not depend on the scheduling.
+    std::vector<ScalarBuffer> threadSums(numThreads, ScalarBuffer(offsets[numSets], 0.0));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+#ifdef _OPENMP
+        auto& localSums = threadSums[omp_get_thread_num()];
+#else
+        auto& localSums = threadSums[0];
+#endif
+        for (std::size_t s = 0; s < numSets; ++s) {
+            const auto& region = *regionSets[s].second;
+            assert(static_cast<int>(region.size()) == numCells);
+            const int regionIdx = region[cellIdx] - 1;
+            // the cell is not attributed to any region. ignore it!
+            if (regionIdx < 0)
+                continue;
+
+            assert(regionIdx < ntFip[s]);
+            Scalar* sums = localSums.data() + offsets[s] + regionIdx * numProperties;
+            for (const auto p : activeProperties) {
+                assert(static_cast<int>(properties[p].second->size()) == numCells);
+                sums[p] += (*properties[p].second)[cellIdx];
+            }
+        }
+    }
+
+    ScalarBuffer& sums = threadSums[0];
+    for (int thread = 1; thread < numThreads; ++thread) {
+        for (std::size_t k = 0; k < sums.size(); ++k)
+            sums[k] += threadSums[thread][k];
+    }
+
+    // all regions, region sets and phases in a single reduction
+    if (!sums.empty())
+        comm.sum(sums.data(), sums.size());
+
+    for (std::size_t s = 0; s < numSets; ++s) {
+        ScalarBuffer values(ntFip[s]);
+        for (std::size_t p = 0; p < numProperties; ++p) {
+            for (int regionIdx = 0; regionIdx < ntFip[s]; ++regionIdx)
+                values[regionIdx] = sums[offsets[s] + regionIdx * numProperties + p];
+
+            update(inplace, regionSets[s].first, properties[p].first, ntFip[s], values);
+        }
     }
 
     // The first time the outputFipLog function is run we store the inplace values in
@@ -231,6 +231,9 @@ protected:
                         const bool enableHysteresis,
                         unsigned numTracers);
 
+    // Empty all cell based buffers of the restart output, keeping their memory.
+    void clearCellBuffers_();
+
     void fipUnitConvert_(std::unordered_map<Inplace::Phase, Scalar>& fip) const;
 
     void pressureUnitConvert_(Scalar& pav) const;
@@ -250,10 +253,8 @@ protected:
 
     void outputFipLogImpl(const Inplace& inplace) const;
 
-    void makeRegionSum(Inplace& inplace,
-                       const std::string& region_name,
-                       const Comm& comm);
-
+    // Sum the fluid in place of all region sets, in one pass over the cells
+    // and a single reduction.
     Inplace accumulateRegionSums(const Comm& comm);
 
     void updateSummaryRegionValues(const Inplace& inplace,
@@ -273,15 +274,6 @@ protected:
                                          const ScalarBuffer& pressurePv,
                                          const ScalarBuffer& pv,
                                          bool hydrocarbon);
-    // Sum Fip values over regions.
-    static ScalarBuffer regionSum(const ScalarBuffer& property,
-                                  const std::vector<int>& regionId,
-                                  size_t maxNumberOfRegions,
-                                  const Comm& comm);
-
-    static int regionMax(const std::vector<int>& region,
-                         const Comm& comm);
-
     static void update(Inplace& inplace,
                        const std::string& region_name,
                        Inplace::Phase phase,
@@ -180,15 +180,16 @@ readRockCompactionParameters_()
             throw std::runtime_error("ROCKCOMP is activated." + std::to_string(numRocktabTables)
                                      +" ROCKTAB tables is expected, but " + std::to_string(rocktabTables.size()) +" is provided");
 
-        rockCompPoroMult_.resize(numRocktabTables);
-        rockCompTransMult_.resize(numRocktabTables);
+        rockCompPoroMult_.clear();
+        rockCompTransMult_.clear();
         for (size_t regionIdx = 0; regionIdx < numRocktabTables; ++regionIdx) {
             const auto& rocktabTable = rocktabTables.template getTable<RocktabTable>(regionIdx);
             const auto& pressureColumn = rocktabTable.getPressureColumn();
             const auto& poroColumn = rocktabTable.getPoreVolumeMultiplierColumn();
             const auto& transColumn = rocktabTable.getTransmissibilityMultiplierColumn();
-            rockCompPoroMult_[regionIdx].setXYContainers(pressureColumn, poroColumn);
-            rockCompTransMult_[regionIdx].setXYContainers(pressureColumn, transColumn);
+            const std::vector<double> pressures(pressureColumn.begin(), pressureColumn.end());
+            rockCompPoroMult_.emplace_back(pressures, std::vector<double>(poroColumn.begin(), poroColumn.end()));
+            rockCompTransMult_.emplace_back(pressures, std::vector<double>(transColumn.begin(), transColumn.end()));
         }
     } else {
         const auto& rock2dTables = eclState_.getTableManager().getRock2dTables();
@@ -606,6 +607,16 @@ plmixnumRegionIndex(unsigned elemIdx) const
     return plmixnum_[elemIdx];
 }
 
+template<class GridView, class FluidSystem, class Scalar>
+unsigned EclGenericProblem<GridView,FluidSystem,Scalar>::
+rockTableIndex(unsigned elemIdx) const
+{
+    if (rockTableIdx_.empty())
+        return 0;
+
+    return rockTableIdx_[elemIdx];
+}
+
 template<class GridView, class FluidSystem, class Scalar>
 Scalar EclGenericProblem<GridView,FluidSystem,Scalar>::
 maxPolymerAdsorption(unsigned elemIdx) const
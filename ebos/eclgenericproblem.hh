@@ -31,6 +31,8 @@
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
 
+#include <opm/simulators/utils/UniformTableLookup.hpp>
+
 #include <array>
 #include <string>
 #include <vector>
@@ -168,6 +170,11 @@ public:
      */
     unsigned plmixnumRegionIndex(unsigned elemIdx) const;
 
+    /*!
+     * \brief Returns the index of the rock compaction table (ROCKNUM) given a cell index
+     */
+    unsigned rockTableIndex(unsigned elemIdx) const;
+
     /*!
      * \brief Returns the max polymer adsorption value
      */
@@ -263,8 +270,9 @@ protected:
     std::vector<unsigned short> rockTableIdx_;
     std::vector<TabulatedTwoDFunction> rockCompPoroMultWc_;
     std::vector<TabulatedTwoDFunction> rockCompTransMultWc_;
-    std::vector<TabulatedFunction> rockCompPoroMult_;
-    std::vector<TabulatedFunction> rockCompTransMult_;
+    // evaluated per cell in the storage and flux terms, hence the constant time lookups
+    std::vector<UniformTableLookup> rockCompPoroMult_;
+    std::vector<UniformTableLookup> rockCompTransMult_;
 
     std::vector<Scalar> maxOilSaturation_;
     std::vector<Scalar> maxPolymerAdsorption_;
@@ -102,7 +102,7 @@ protected:
     std::vector<Scalar> thpresftValues_;
     std::vector<int> cartElemFaultIdx_;
 
-    bool enableThresholdPressure_;
+    bool enableThresholdPressure_ = false;
     bool enableExperiments_;
 };
 
@@ -32,6 +32,9 @@
 #include <opm/parser/eclipse/EclipseState/Runspec.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TracerVdTable.hpp>
 
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+
 #include <dune/istl/operators.hh>
 #include <dune/istl/solvers.hh>
 #include <dune/istl/preconditioners.hh>
@@ -42,9 +45,11 @@
 #include <ebos/femcpgridcompat.hh>
 #endif
 
+#include <algorithm>
 #include <iostream>
 #include <set>
 #include <stdexcept>
+#include <utility>
 
 namespace Opm {
 
@@ -243,6 +248,212 @@ linearSolve_(const TracerMatrix& M, TracerVector& x, TracerVector& b)
     return result.converged;
 }
 
+template<class Grid,class GridView, class DofMapper, class Stencil, class Scalar>
+bool EclGenericTracerModel<Grid,GridView,DofMapper,Stencil,Scalar>::
+linearSolveBatch_(const TracerMatrix& M, std::vector<TracerVector>& x, std::vector<TracerVector>& b)
+{
+#if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2,7)
+    Dune::FMatrixPrecision<Scalar>::set_singular_limit(1.e-30);
+    Dune::FMatrixPrecision<Scalar>::set_absolute_limit(1.e-30);
+#endif
+    Scalar tolerance = 1e-2;
+    int maxIter = 100;
+
+    int verbosity = 0;
+    using TracerSolver = Dune::BiCGSTABSolver<TracerVector>;
+    using TracerOperator = Dune::MatrixAdapter<TracerMatrix,TracerVector,TracerVector>;
+    using TracerScalarProduct = Dune::SeqScalarProduct<TracerVector>;
+    using TracerPreconditioner = Dune::SeqILU< TracerMatrix,TracerVector,TracerVector>;
+
+    if (useUpwindSolver_) {
+        UpwindOrdering ordering;
+        bool success = computeUpwindOrdering_(M, ordering);
+        for (std::size_t rhsIdx = 0; success && rhsIdx < b.size(); ++rhsIdx)
+            success = solveUpwind_(M, ordering, x[rhsIdx], b[rhsIdx]);
+
+        if (success)
+            return true;
+
+        OpmLog::debug("Upwind ordering of the tracer system failed, using the iterative solver");
+    }
+
+    TracerOperator tracerOperator(M);
+    TracerScalarProduct tracerScalarProduct;
+    TracerPreconditioner tracerPreconditioner(M, 0, 1); // results in ILU0
+
+    TracerSolver solver (tracerOperator, tracerScalarProduct,
+                         tracerPreconditioner, tolerance, maxIter,
+                         verbosity);
+
+    bool converged = true;
+    for (std::size_t rhsIdx = 0; rhsIdx < b.size(); ++rhsIdx) {
+        x[rhsIdx] = 0.0;
+        Dune::InverseOperatorResult result;
+        solver.apply(x[rhsIdx], b[rhsIdx], result);
+        converged = converged && result.converged;
+    }
+
+    return converged;
+}
+
+template<class Grid,class GridView, class DofMapper, class Stencil, class Scalar>
+bool EclGenericTracerModel<Grid,GridView,DofMapper,Stencil,Scalar>::
+computeUpwindOrdering_(const TracerMatrix& M, UpwindOrdering& ordering) const
+{
+    // cells whose equations are coupled in a cycle have to be solved together,
+    // larger components are left to the iterative solver
+    constexpr int maxComponentSize = 200;
+
+    // Tarjan's algorithm without recursion. cell I depends on cell J if M[I][J] is
+    // non-zero, a component is completed after all components it depends on,
+    // hence the components are found in the order in which they can be solved.
+    const int numCells = M.N();
+    std::vector<int> index(numCells, -1);
+    std::vector<int> lowlink(numCells, 0);
+    std::vector<char> onStack(numCells, 0);
+    std::vector<int> stack;
+    std::vector<std::pair<int, typename TracerMatrix::ConstColIterator>> callStack;
+    int nextIndex = 0;
+    bool success = true;
+
+    ordering.cells.clear();
+    ordering.cells.reserve(numCells);
+    ordering.componentStart.clear();
+
+    const auto& visit = [&](int cellIdx)
+    {
+        index[cellIdx] = lowlink[cellIdx] = nextIndex++;
+        stack.push_back(cellIdx);
+        onStack[cellIdx] = 1;
+        callStack.emplace_back(cellIdx, M[cellIdx].begin());
+    };
+
+    for (int root = 0; root < numCells; ++root) {
+        if (index[root] >= 0)
+            continue;
+
+        visit(root);
+        while (!callStack.empty()) {
+            const int v = callStack.back().first;
+            auto& colIt = callStack.back().second;
+            const auto colEndIt = M[v].end();
+            int next = -1;
+            for (; colIt != colEndIt; ++colIt) {
+                const int w = colIt.index();
+                if (w == v || (*colIt)[0][0] == 0.0)
+                    continue;
+
+                if (index[w] < 0) {
+                    // the edge is looked at again after returning from w
+                    next = w;
+                    break;
+                }
+                if (onStack[w])
+                    lowlink[v] = std::min(lowlink[v], lowlink[w]);
+            }
+            if (next >= 0) {
+                visit(next);
+                continue;
+            }
+
+            if (lowlink[v] == index[v]) {
+                const int begin = ordering.cells.size();
+                ordering.componentStart.push_back(begin);
+                int w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = 0;
+                    ordering.cells.push_back(w);
+                } while (w != v);
+
+                if (static_cast<int>(ordering.cells.size()) - begin > maxComponentSize)
+                    success = false;
+            }
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                const int u = callStack.back().first;
+                lowlink[u] = std::min(lowlink[u], lowlink[v]);
+            }
+        }
+        if (!success)
+            return false;
+    }
+    ordering.componentStart.push_back(ordering.cells.size());
+
+    return true;
+}
+
+template<class Grid,class GridView, class DofMapper, class Stencil, class Scalar>
+bool EclGenericTracerModel<Grid,GridView,DofMapper,Stencil,Scalar>::
+solveUpwind_(const TracerMatrix& M, const UpwindOrdering& ordering,
+             TracerVector& x, const TracerVector& b) const
+{
+    x = 0.0;
+    std::vector<int> localIdx(M.N(), -1);
+    Dune::DynamicMatrix<Scalar> A;
+    Dune::DynamicVector<Scalar> localX, localB;
+
+    const std::size_t numComponents = ordering.componentStart.size() - 1;
+    for (std::size_t compIdx = 0; compIdx < numComponents; ++compIdx) {
+        const int begin = ordering.componentStart[compIdx];
+        const int end = ordering.componentStart[compIdx + 1];
+
+        if (end - begin == 1) {
+            // the cell only depends on cells which are already solved
+            const int I = ordering.cells[begin];
+            Scalar diag = 0.0;
+            Scalar sum = b[I][0];
+            const auto colEndIt = M[I].end();
+            for (auto colIt = M[I].begin(); colIt != colEndIt; ++colIt) {
+                if (colIt.index() == static_cast<std::size_t>(I))
+                    diag = (*colIt)[0][0];
+                else
+                    sum -= (*colIt)[0][0] * x[colIt.index()][0];
+            }
+            if (diag == 0.0)
+                return false;
+
+            x[I][0] = sum / diag;
+            continue;
+        }
+
+        // local dense system of a cycle
+        const int size = end - begin;
+        for (int i = 0; i < size; ++i)
+            localIdx[ordering.cells[begin + i]] = i;
+
+        A.resize(size, size, 0.0);
+        localX.resize(size);
+        localB.resize(size);
+        for (int i = 0; i < size; ++i) {
+            const int I = ordering.cells[begin + i];
+            localB[i] = b[I][0];
+            const auto colEndIt = M[I].end();
+            for (auto colIt = M[I].begin(); colIt != colEndIt; ++colIt) {
+                const int j = localIdx[colIt.index()];
+                if (j >= 0)
+                    A[i][j] = (*colIt)[0][0];
+                else
+                    localB[i] -= (*colIt)[0][0] * x[colIt.index()][0];
+            }
+        }
+        try {
+            A.solve(localX, localB);
+        }
+        catch (const Dune::FMatrixError&) {
+            return false;
+        }
+        for (int i = 0; i < size; ++i) {
+            const int I = ordering.cells[begin + i];
+            x[I][0] = localX[i];
+            localIdx[I] = -1;
+        }
+    }
+
+    return true;
+}
+
 #if HAVE_DUNE_FEM
 template class EclGenericTracerModel<Dune::CpGrid,
                                      Dune::GridView<Dune::Fem::GridPart2GridViewTraits<Dune::Fem::AdaptiveLeafGridPart<Dune::CpGrid, Dune::PartitionIteratorType(4), false>>>,
@@ -37,6 +37,8 @@
 
 #include <dune/common/version.hh>
 
+#include <cstddef>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -68,6 +70,42 @@ public:
      */
     Scalar tracerConcentration(int tracerIdx, int globalDofIdx) const;
 
+    /*!
+     * \brief Write the tracer concentrations to a rank local checkpoint
+     */
+    template <class Buffer>
+    void writeCheckpoint(Buffer& buffer) const
+    {
+        buffer.write(tracerConcentration_.size());
+        for (const auto& concentration : tracerConcentration_) {
+            buffer.write(concentration.size());
+            for (const auto& value : concentration)
+                buffer.write(value[0]);
+        }
+    }
+
+    /*!
+     * \brief Read the tracer concentrations written by writeCheckpoint()
+     */
+    template <class Buffer>
+    void readCheckpoint(Buffer& buffer)
+    {
+        std::size_t numTracers = 0;
+        buffer.read(numTracers);
+        if (numTracers != tracerConcentration_.size())
+            throw std::runtime_error("The checkpoint does not match the number of tracers");
+
+        for (auto& concentration : tracerConcentration_) {
+            std::size_t size = 0;
+            buffer.read(size);
+            if (size != concentration.size())
+                throw std::runtime_error("The checkpoint does not match the tracer grid");
+
+            for (auto& value : concentration)
+                buffer.read(value[0]);
+        }
+    }
+
 protected:
     EclGenericTracerModel(const GridView& gridView,
                           const EclipseState& eclState,
@@ -85,6 +123,38 @@ protected:
 
     bool linearSolve_(const TracerMatrix& M, TracerVector& x, TracerVector& b);
 
+    /*!
+     * \brief Solve M x[i] = b[i] for several right hand sides, the preconditioner
+     *        is only set up once.
+     */
+    bool linearSolveBatch_(const TracerMatrix& M, std::vector<TracerVector>& x, std::vector<TracerVector>& b);
+
+    /*!
+     * \brief The cells grouped into the strongly connected components of the matrix
+     *        graph, in an order in which the components can be solved one after the
+     *        other. For upwind transport most components consist of a single cell.
+     */
+    struct UpwindOrdering
+    {
+        std::vector<int> cells;
+        std::vector<int> componentStart; // begin of each component in cells, plus the end
+    };
+
+    /*!
+     * \brief Compute the upwind ordering of the matrix.
+     *
+     * \return false if a component is too large to be solved directly
+     */
+    bool computeUpwindOrdering_(const TracerMatrix& M, UpwindOrdering& ordering) const;
+
+    /*!
+     * \brief Solve M x = b by a single sweep over the components of the ordering.
+     *
+     * \return false if the system of a component is singular
+     */
+    bool solveUpwind_(const TracerMatrix& M, const UpwindOrdering& ordering,
+                      TracerVector& x, const TracerVector& b) const;
+
     const GridView& gridView_;
     const EclipseState& eclState_;
     const CartesianIndexMapper& cartMapper_;
@@ -98,6 +168,7 @@ protected:
     TracerVector tracerResidual_;
     std::vector<int> cartToGlobal_;
     std::vector<Dune::BlockVector<Dune::FieldVector<Scalar, 1>>> storageOfTimeIndex1_;
+    bool useUpwindSolver_ = false;
 };
 
 } // namespace Opm
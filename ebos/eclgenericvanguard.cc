@@ -28,6 +28,7 @@
 #include <opm/common/utility/FileSystem.hpp>
 #include <opm/common/utility/TimeService.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/Section.hpp>
 #include <opm/parser/eclipse/EclipseState/Aquifer/NumericalAquifer/NumericalAquiferCell.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Action/State.hpp>
@@ -48,8 +49,40 @@
 #include <mpi.h>
 #endif // HAVE_MPI
 
+#include <sstream>
 #include <stdexcept>
 
+namespace {
+
+// FNV-1a hash of the keywords of the sections which determine the grid and its
+// transmissibilities. unlike std::hash it is the same for every run.
+std::uint64_t gridSectionsHash(const Opm::Deck& deck)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    const auto addSection = [&hash](const auto& section)
+    {
+        for (const auto& keyword : section) {
+            std::ostringstream os;
+            os << keyword;
+            for (const unsigned char c : os.str()) {
+                hash ^= c;
+                hash *= 1099511628211ULL;
+            }
+        }
+    };
+
+    if (Opm::Section::hasGRID(deck))
+        addSection(Opm::GRIDSection(deck));
+    if (Opm::Section::hasEDIT(deck))
+        addSection(Opm::EDITSection(deck));
+    if (Opm::Section::hasREGIONS(deck))
+        addSection(Opm::REGIONSSection(deck));
+
+    return hash;
+}
+
+} // anonymous namespace
+
 namespace Opm {
 
 double EclGenericVanguard::externalSetupTime_ = 0.0;
@@ -264,6 +297,18 @@ void EclGenericVanguard::init()
              std::move(parseContext_), /* initFromRestart = */ false,
              /* checkDeck = */ enableExperiments_, outputInterval_);
 
+    if (!transmissibilityCache_.empty()) {
+        // the deck is only available on the first process
+        if (myRank == 0)
+            transmissibilityCacheKey_ = gridSectionsHash(*deck_);
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
+        const auto& comm = Dune::MPIHelper::getCommunication();
+#else
+        const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+#endif
+        comm.broadcast(&transmissibilityCacheKey_, 1, 0);
+    }
+
     this->summaryState_ = std::make_unique<SummaryState>( TimeService::from_time_t(this->eclSchedule_->getStartTime() ));
     this->udqState_ = std::make_unique<UDQState>( this->eclSchedule_->getUDQConfig(0).params().undefinedValue() );
     this->actionState_ = std::make_unique<Action::State>() ;
@@ -318,6 +363,25 @@ void EclGenericVanguard::init()
     }
 }
 
+std::string EclGenericVanguard::transmissibilityCacheFile(bool global) const
+{
+    if (transmissibilityCache_.empty())
+        return "";
+
+    if (global)
+        return transmissibilityCache_ + ".global";
+
+#if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
+    const auto& comm = Dune::MPIHelper::getCommunication();
+#else
+    const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+#endif
+    if (comm.size() > 1)
+        return transmissibilityCache_ + "." + std::to_string(comm.rank()) + "of" + std::to_string(comm.size());
+
+    return transmissibilityCache_;
+}
+
 bool EclGenericVanguard::drsdtconEnabled() const
 {
   for (const auto& schIt : this->schedule()) {
@@ -30,6 +30,7 @@
 #include <opm/grid/common/GridEnums.hpp>
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -150,6 +151,23 @@ public:
     Deck& deck()
     { return *deck_; }
 
+    /*!
+     * \brief Returns the file which caches the transmissibilities between runs, empty
+     *        if the cache is disabled.
+     *
+     * \param global Whether the file is the one of the transmissibilities of the global
+     *               grid which are used for the load balancing, otherwise it is the one
+     *               of the grid of this process.
+     */
+    std::string transmissibilityCacheFile(bool global) const;
+
+    /*!
+     * \brief Returns the hash of the GRID, EDIT and REGIONS sections of the deck which
+     *        identifies the cached transmissibilities.
+     */
+    std::uint64_t transmissibilityCacheKey() const
+    { return transmissibilityCacheKey_; }
+
     /*!
      * \brief Return a reference to the internalized ECL deck.
      */
@@ -244,6 +262,13 @@ public:
     double zoltanImbalanceTol() const
     { return zoltanImbalanceTol_; }
 
+    /*!
+     * \brief Parameter that decides if the grid is partitioned by its columns
+     *        instead of with Zoltan.
+     */
+    bool structuredPartitioning() const
+    { return structuredPartitioning_; }
+
     /*!
      * \brief Whether perforations of a well might be distributed.
      */
@@ -284,12 +309,15 @@ protected:
     bool ownersFirst_;
     bool serialPartitioning_;
     double zoltanImbalanceTol_;
+    bool structuredPartitioning_ = false;
     bool enableDistributedWells_;
     std::string ignoredKeywords_;
     bool eclStrictParsing_;
     std::optional<int> outputInterval_;
     bool useMultisegmentWell_;
     bool enableExperiments_;
+    std::string transmissibilityCache_;
+    std::uint64_t transmissibilityCacheKey_ = 0;
 
     std::unique_ptr<SummaryState> summaryState_;
     std::unique_ptr<Action::State> actionState_;
@@ -38,6 +38,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/SummaryState.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/UDQ/UDQState.hpp>
+#include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 
 #include <dune/grid/common/mcmgmapper.hh>
@@ -52,6 +53,52 @@
 #include <mpi.h>
 #endif
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+
+namespace Opm {
+
+/*!
+ * \brief Counts the output requests that are queued or being written.
+ *
+ * Shared between the writer and its tasklets, the simulation only waits
+ * for the output thread if the number of pending requests reaches the
+ * queue size.
+ */
+class EclOutputQueue
+{
+public:
+    //! \brief Wait until less than maxSize requests are pending and
+    //!        register a new one. Returns the number of pending ones.
+    std::size_t push(std::size_t maxSize)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this, maxSize] { return pending_ < maxSize; });
+        return pending_++;
+    }
+
+    //! \brief Mark one request as written.
+    void pop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --pending_;
+        }
+        cond_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::size_t pending_ = 0;
+};
+
+} // namespace Opm
+
 namespace {
 
 /*!
@@ -103,6 +150,23 @@ bool directVerticalNeighbors(const std::array<int, 3>& cartDims,
 }
 
 
+/*!
+ * \brief Round a value to the given number of mantissa bits.
+ *
+ * The remaining bits of the written values are zero, such that the restart
+ * files compress to a fraction of their size.
+ */
+double roundMantissa(double value, int bits)
+{
+    if (value == 0.0 || !std::isfinite(value))
+        return value;
+
+    int exponent = 0;
+    const double mantissa = std::frexp(value, &exponent);
+    return std::ldexp(std::round(std::ldexp(mantissa, bits)), exponent - bits);
+}
+
+
 struct EclWriteTasklet : public Opm::TaskletInterface
 {
     Opm::Action::State actionState_;
@@ -114,6 +178,8 @@ struct EclWriteTasklet : public Opm::TaskletInterface
     double secondsElapsed_;
     Opm::RestartValue restartValue_;
     bool writeDoublePrecision_;
+    int mantissaBits_;
+    std::shared_ptr<Opm::EclOutputQueue> queue_;
 
     explicit EclWriteTasklet(const Opm::Action::State& actionState,
                              const Opm::SummaryState& summaryState,
@@ -123,7 +189,9 @@ struct EclWriteTasklet : public Opm::TaskletInterface
                              bool isSubStep,
                              double secondsElapsed,
                              Opm::RestartValue restartValue,
-                             bool writeDoublePrecision)
+                             bool writeDoublePrecision,
+                             int mantissaBits,
+                             std::shared_ptr<Opm::EclOutputQueue> queue)
         : actionState_(actionState)
         , summaryState_(summaryState)
         , udqState_(udqState)
@@ -131,13 +199,29 @@ struct EclWriteTasklet : public Opm::TaskletInterface
         , reportStepNum_(reportStepNum)
         , isSubStep_(isSubStep)
         , secondsElapsed_(secondsElapsed)
-        , restartValue_(restartValue)
+        , restartValue_(std::move(restartValue))
         , writeDoublePrecision_(writeDoublePrecision)
+        , mantissaBits_(mantissaBits)
+        , queue_(std::move(queue))
     { }
 
     // callback to eclIO serial writeTimeStep method
     void run()
     {
+        // release the queue slot also if writing fails
+        struct QueueSlot {
+            Opm::EclOutputQueue& queue;
+            ~QueueSlot() { queue.pop(); }
+        } slot{*queue_};
+
+        // on the output thread if the output is asynchronous
+        if (mantissaBits_ > 0) {
+            for (auto& field : restartValue_.solution) {
+                for (auto& value : field.second.data)
+                    value = roundMantissa(value, mantissaBits_);
+            }
+        }
+
         eclIO_.writeTimeStep(actionState_,
                              summaryState_,
                              udqState_,
@@ -164,22 +248,40 @@ EclGenericWriter(const Schedule& schedule,
                  const Dune::CartesianIndexMapper<Grid>& cartMapper,
                  const Dune::CartesianIndexMapper<EquilGrid>* equilCartMapper,
                  const TransmissibilityType& globalTrans,
-                 bool enableAsyncOutput)
+                 bool enableAsyncOutput,
+                 bool collectCellDataPerField,
+                 int outputQueueSize,
+                 const std::string& restartFields,
+                 int outputMantissaBits)
     : collectToIORank_(grid,
                        equilGrid,
                        gridView,
                        cartMapper,
-                       equilCartMapper)
+                       equilCartMapper,
+                       collectCellDataPerField)
     , grid_(grid)
     , gridView_(gridView)
     , schedule_(schedule)
     , eclState_(eclState)
     , summaryConfig_(summaryConfig)
+    , outputQueue_(std::make_shared<EclOutputQueue>())
+    , outputQueueSize_(std::max(outputQueueSize, 1))
     , globalTrans_(globalTrans)
     , cartMapper_(cartMapper)
     , equilCartMapper_(equilCartMapper)
     , equilGrid_(equilGrid)
+    , outputMantissaBits_(std::max(outputMantissaBits, 0))
 {
+    // comma or space separated names
+    std::istringstream fields(restartFields);
+    std::string field;
+    while (std::getline(fields, field, ',')) {
+        std::istringstream names(field);
+        std::string name;
+        while (names >> name)
+            restartFields_.insert(name);
+    }
+
     if (collectToIORank_.isIORank()) {
         eclIO_.reset(new EclipseIO(eclState_,
                                    UgGridHelpers::createEclipseGrid(*equilGrid, eclState_.getInputGrid()),
@@ -199,12 +301,46 @@ EclGenericWriter(const Schedule& schedule,
     }
     // create output thread if enabled and rank is I/O rank
     // async output is enabled by default if pthread are enabled
+    setupSummaryRequirements_();
+
     int numWorkerThreads = 0;
     if (enableAsyncOutput && collectToIORank_.isIORank())
         numWorkerThreads = 1;
     taskletRunner_.reset(new TaskletRunner(numWorkerThreads));
 }
 
+template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
+void EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
+setupSummaryRequirements_()
+{
+    using Category = SummaryConfigNode::Category;
+
+    for (const auto& node : summaryConfig_) {
+        const auto category = node.category();
+        const auto& keyword = node.keyword();
+
+        // aquifer vectors, and field or region totals like FAQR
+        if (category == Category::Aquifer || keyword.find("AQ") != std::string::npos) {
+            summaryNeedsAquiferData_ = true;
+            continue;
+        }
+
+        // connection and segment vectors, and the completion vectors
+        // W...L which are evaluated from the connections
+        const bool details = category == Category::Connection ||
+                             category == Category::Segment ||
+                             (category == Category::Well && keyword.back() == 'L');
+        if (!details)
+            continue;
+
+        const auto& wellName = node.namedEntity();
+        if (wellName.empty() || wellName.find_first_of("*?") != std::string::npos)
+            summaryDetailsForAllWells_ = true;
+        else
+            summaryDetailWells_.insert(wellName);
+    }
+}
+
 template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
 const EclipseIO& EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
 eclIO() const
@@ -215,15 +351,21 @@ eclIO() const
 
 template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
 void EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
-writeInit()
+writeInit(const TransmissibilityType& localTrans)
 {
+    if (collectToIORank_.isParallel())
+        collectToIORank_.collect(computeLocalTrans_(localTrans), {}, {}, {}, {}, {});
+
     if (collectToIORank_.isIORank()) {
         std::map<std::string, std::vector<int> > integerVectors;
         if (collectToIORank_.isParallel())
             integerVectors.emplace("MPI_RANK", collectToIORank_.globalRanks());
         auto cartMap = cartesianToCompressed(equilGrid_->size(0),
                                              UgGridHelpers::globalCell(*equilGrid_));
-        eclIO_->writeInitial(computeTrans_(cartMap), integerVectors, exportNncStructure_(cartMap));
+        auto trans = collectToIORank_.isParallel()
+            ? globalTransFromCollected_()
+            : computeTrans_(cartMap);
+        eclIO_->writeInitial(std::move(trans), integerVectors, exportNncStructure_(cartMap));
     }
 }
 
@@ -298,6 +440,103 @@ computeTrans_(const std::unordered_map<int,int>& cartesianToActive) const
             {"TRANZ", tranz}};
 }
 
+template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
+data::Solution EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
+computeLocalTrans_(const TransmissibilityType& localTrans) const
+{
+    const auto& cartDims = cartMapper_.cartesianDimensions();
+    const std::size_t numCells = gridView_.size(0);
+
+    // The cells of the column between two vertical neighbours are only known
+    // if they are part of the local grid (including the overlap), cells
+    // outside of it are treated as inactive.
+    std::unordered_map<int,int> cartesianToActive;
+    cartesianToActive.reserve(numCells);
+    for (std::size_t i = 0; i < numCells; ++i)
+        cartesianToActive.emplace(cartMapper_.cartesianIndex(i), i);
+
+    data::CellData tranx = {UnitSystem::measure::transmissibility, std::vector<double>(numCells, 0.0), data::TargetType::INIT};
+    data::CellData trany = {UnitSystem::measure::transmissibility, std::vector<double>(numCells, 0.0), data::TargetType::INIT};
+    data::CellData tranz = {UnitSystem::measure::transmissibility, std::vector<double>(numCells, 0.0), data::TargetType::INIT};
+
+    ElementMapper elemMapper(gridView_, Dune::mcmgElementLayout());
+    for (const auto& elem : elements(gridView_)) {
+        if (elem.partitionType() != Dune::InteriorEntity)
+            continue;
+
+        for (const auto& is : intersections(gridView_, elem)) {
+            if (!is.neighbor())
+                continue; // intersection is on the domain boundary
+
+            unsigned c1 = elemMapper.index(is.inside());
+            unsigned c2 = elemMapper.index(is.outside());
+            const int gc1 = cartMapper_.cartesianIndex(c1);
+            const int gc2 = cartMapper_.cartesianIndex(c2);
+
+            // Like in computeTrans_() the value belongs to the cell with the
+            // smaller cartesian index, which is interior on exactly one process.
+            if (gc2 < gc1)
+                continue;
+
+            if (gc2 - gc1 == 1 && cartDims[0] > 1) {
+                tranx.data[c1] = localTrans.transmissibility(c1, c2);
+                continue;
+            }
+
+            if (gc2 - gc1 == cartDims[0] && cartDims[1] > 1) {
+                trany.data[c1] = localTrans.transmissibility(c1, c2);
+                continue;
+            }
+
+            if (gc2 - gc1 == cartDims[0]*cartDims[1] ||
+                directVerticalNeighbors(cartDims, cartesianToActive, gc1, gc2))
+                tranz.data[c1] = localTrans.transmissibility(c1, c2);
+        }
+    }
+
+    return {{"TRANX", tranx},
+            {"TRANY", trany},
+            {"TRANZ", tranz}};
+}
+
+template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
+data::Solution EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
+globalTransFromCollected_() const
+{
+    const auto& cartMapper = *equilCartMapper_;
+    const auto& cartDims = cartMapper.cartesianDimensions();
+    const int globalSize = cartDims[0]*cartDims[1]*cartDims[2];
+    const auto& collected = collectToIORank_.globalCellData();
+
+    const std::array<const char*, 3> names = {"TRANX", "TRANY", "TRANZ"};
+    std::array<const std::vector<double>*, 3> active;
+    std::array<std::vector<double>, 3> values;
+    for (std::size_t dir = 0; dir < names.size(); ++dir) {
+        active[dir] = &collected.at(names[dir]).data;
+        values[dir].assign(globalSize, 0.0);
+    }
+
+    // all directions at once, such that the Cartesian index of every cell is
+    // looked up only once
+    const int numCells = active[0]->size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < numCells; ++i) {
+        const int cartIdx = cartMapper.cartesianIndex(i);
+        for (std::size_t dir = 0; dir < names.size(); ++dir)
+            values[dir][cartIdx] = (*active[dir])[i];
+    }
+
+    data::Solution trans;
+    for (std::size_t dir = 0; dir < names.size(); ++dir) {
+        trans.insert(names[dir], UnitSystem::measure::transmissibility,
+                     std::move(values[dir]), data::TargetType::INIT);
+    }
+
+    return trans;
+}
+
 template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
 std::vector<NNCdata> EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
 exportNncStructure_(const std::unordered_map<int,int>& cartesianToActive) const
@@ -427,17 +666,33 @@ doWriteOutput(const int                     reportStepNum,
     // step to disk
     auto eclWriteTasklet = std::make_shared<EclWriteTasklet>(
         actionState, summaryState, udqState, *this->eclIO_,
-        reportStepNum, isSubStep, curTime, std::move(restartValue), doublePrecision);
+        reportStepNum, isSubStep, curTime, std::move(restartValue), doublePrecision,
+        this->outputMantissaBits_, this->outputQueue_);
 
-    // then, make sure that the previous I/O request has been completed
-    // and the number of incomplete tasklets does not increase between
-    // time steps
-    this->taskletRunner_->barrier();
+    // then, make sure that the number of incomplete I/O requests stays
+    // below the queue size. With a queue size of one this waits for the
+    // previous request to be completed
+    this->outputQueueDepth_ = this->outputQueue_->push(this->outputQueueSize_);
 
     // finally, start a new output writing job
     this->taskletRunner_->dispatch(std::move(eclWriteTasklet));
 }
 
+template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
+void EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
+selectRestartFields_(data::Solution& cellData) const
+{
+    if (restartFields_.empty())
+        return;
+
+    for (auto it = cellData.begin(); it != cellData.end();) {
+        if (restartFields_.count(it->first) == 0)
+            it = cellData.erase(it);
+        else
+            ++it;
+    }
+}
+
 template<class Grid, class EquilGrid, class GridView, class ElementMapper, class Scalar>
 void EclGenericWriter<Grid,EquilGrid,GridView,ElementMapper,Scalar>::
 evalSummary(int reportStepNum,
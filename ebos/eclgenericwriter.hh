@@ -35,7 +35,9 @@
 
 #include <cstddef>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -44,6 +46,7 @@ namespace Opm {
 namespace Action { class State; }
 class EclipseIO;
 class EclipseState;
+class EclOutputQueue;
 class Inplace;
 struct NNCdata;
 class Schedule;
@@ -70,11 +73,39 @@ public:
                      const Dune::CartesianIndexMapper<Grid>& cartMapper,
                      const Dune::CartesianIndexMapper<EquilGrid>* equilCartMapper,
                      const TransmissibilityType& globalTrans,
-                     bool enableAsyncOutput);
+                     bool enableAsyncOutput,
+                     bool collectCellDataPerField,
+                     int outputQueueSize,
+                     const std::string& restartFields,
+                     int outputMantissaBits);
 
     const EclipseIO& eclIO() const;
 
-    void writeInit();
+    //! \brief Number of output requests that were still pending when the
+    //!        last one was queued, i.e. zero if the writer keeps up.
+    std::size_t outputQueueDepth() const
+    { return outputQueueDepth_; }
+
+    //! \brief Whether the SUMMARY section requests connection or segment
+    //!        vectors of a well.
+    bool summaryNeedsWellDetails(const std::string& wellName) const
+    { return summaryDetailsForAllWells_ || summaryDetailWells_.count(wellName) > 0; }
+
+    //! \brief The bytes of the index maps and the buffers for collecting the
+    //!        output on the I/O rank.
+    std::size_t collectMemoryUsage() const
+    { return collectToIORank_.memoryUsage(); }
+
+    //! \brief Whether the SUMMARY section requests any aquifer vector.
+    bool summaryNeedsAquiferData() const
+    { return summaryNeedsAquiferData_; }
+
+    //! \brief Write the INIT and EGRID files.
+    //!
+    //! In parallel runs the TRANX, TRANY and TRANZ arrays are computed from the
+    //! transmissibilities of the interior cells of each process and collected
+    //! on the I/O rank. This is collective, all processes must call it.
+    void writeInit(const TransmissibilityType& localTrans);
 
 protected:
     void doWriteOutput(const int                     reportStepNum,
@@ -90,6 +121,10 @@ protected:
                        Scalar nextStepSize,
                        bool doublePrecision);
 
+    //! \brief Remove the cell data which is not in the list of restart fields,
+    //!        before it is collected. Does nothing if all fields are written.
+    void selectRestartFields_(data::Solution& cellData) const;
+
     void evalSummary(int reportStepNum,
                      Scalar curTime,
                      const std::map<std::size_t, double>& wbpData,
@@ -111,6 +146,9 @@ protected:
     const EclipseState& eclState_;
     const SummaryConfig& summaryConfig_;
     std::unique_ptr<EclipseIO> eclIO_;
+    std::shared_ptr<EclOutputQueue> outputQueue_;
+    std::size_t outputQueueSize_;
+    std::size_t outputQueueDepth_ = 0;
     std::unique_ptr<TaskletRunner> taskletRunner_;
     Scalar restartTimeStepSize_;
     const TransmissibilityType& globalTrans_;
@@ -118,9 +156,21 @@ protected:
     const Dune::CartesianIndexMapper<EquilGrid>* equilCartMapper_;
     const EquilGrid* equilGrid_;
     std::vector<std::size_t> wbp_index_list_;
+    // summary requirements, computed once from the SUMMARY section
+    std::unordered_set<std::string> summaryDetailWells_;
+    bool summaryDetailsForAllWells_ = false;
+    bool summaryNeedsAquiferData_ = false;
+    // the cell data written to the restart files if not empty, and the
+    // number of mantissa bits they are rounded to if positive
+    std::unordered_set<std::string> restartFields_;
+    int outputMantissaBits_ = 0;
 
 private:
+    void setupSummaryRequirements_();
+
     data::Solution computeTrans_(const std::unordered_map<int,int>& cartesianToActive) const;
+    data::Solution computeLocalTrans_(const TransmissibilityType& localTrans) const;
+    data::Solution globalTransFromCollected_() const;
     std::vector<NNCdata> exportNncStructure_(const std::unordered_map<int,int>& cartesianToActive) const;
 };
 
@@ -22,7 +22,16 @@
 #define ECL_MPI_SERIALIZER_HH
 
 #include <opm/simulators/utils/ParallelRestart.hpp>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
 #include <optional>
+#include <type_traits>
 #include <variant>
 
 namespace Opm {
@@ -40,6 +49,19 @@ public:
         m_comm(comm)
     {}
 
+    EclMpiSerializer(const EclMpiSerializer&) = delete;
+    EclMpiSerializer& operator=(const EclMpiSerializer&) = delete;
+
+    ~EclMpiSerializer()
+    {
+#if HAVE_MPI && MPI_VERSION >= 3
+        if (m_leaderComm != MPI_COMM_NULL)
+            MPI_Comm_free(&m_leaderComm);
+        if (m_nodeComm != MPI_COMM_NULL)
+            MPI_Comm_free(&m_nodeComm);
+#endif
+    }
+
     //! \brief (De-)serialization for simple types.
     //! \details The data handled by this depends on the underlying serialization used.
     //!          Currently you can call this for scalars, and stl containers with scalars.
@@ -71,6 +93,13 @@ public:
     template<class T, bool complexType = true>
     void vector(std::vector<T>& data)
     {
+        if constexpr (!complexType && std::is_pod_v<T> && !std::is_same_v<T,bool>) {
+            // The elements are packed in one go, with the same layout as
+            // one by one.
+            (*this)(data);
+            return;
+        }
+
         auto handle = [&](auto& d)
         {
             for (auto& it : d) {
@@ -331,7 +360,7 @@ public:
                 pack(data);
                 m_packSize = m_position;
                 m_comm.broadcast(&m_packSize, 1, 0);
-                m_comm.broadcast(m_buffer.data(), m_position, 0);
+                broadcastBuffer();
             } catch (...) {
                 m_packSize = std::numeric_limits<size_t>::max();
                 m_comm.broadcast(&m_packSize, 1, 0);
@@ -342,8 +371,7 @@ public:
             if (m_packSize == std::numeric_limits<size_t>::max()) {
                 throw std::runtime_error("Error detected in parallel serialization");
             }
-            m_buffer.resize(m_packSize);
-            m_comm.broadcast(m_buffer.data(), m_packSize, 0);
+            broadcastBuffer();
             unpack(data);
         }
     }
@@ -361,6 +389,60 @@ public:
     }
 
 protected:
+    //! \brief Broadcast the first m_packSize bytes of m_buffer from the root process.
+    //! \details With MPI-3 the buffer is sent once to every node. The processes on a
+    //!          node copy it from a shared memory window instead of receiving it
+    //!          one by one.
+    void broadcastBuffer()
+    {
+#if HAVE_MPI && MPI_VERSION >= 3
+        const int rank = m_comm.rank();
+
+        // the node communicators are set up once and reused for all objects
+        // which are broadcast with this serializer
+        if (m_nodeComm == MPI_COMM_NULL) {
+            MPI_Comm comm = m_comm;
+            MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &m_nodeComm);
+            MPI_Comm_rank(m_nodeComm, &m_nodeRank);
+
+            // the root process is rank 0 of its node, so it is also rank 0 among the node leaders
+            MPI_Comm_split(comm, m_nodeRank == 0 ? 0 : MPI_UNDEFINED, rank, &m_leaderComm);
+        }
+
+        char* shared = nullptr;
+        MPI_Win win;
+        MPI_Win_allocate_shared(static_cast<MPI_Aint>(m_nodeRank == 0 ? m_packSize : 0), 1, MPI_INFO_NULL,
+                                m_nodeComm, &shared, &win);
+        if (m_nodeRank != 0) {
+            MPI_Aint size;
+            int dispUnit;
+            MPI_Win_shared_query(win, 0, &size, &dispUnit, &shared);
+        }
+
+        MPI_Win_fence(0, win);
+        if (m_nodeRank == 0) {
+            if (rank == 0)
+                std::copy(m_buffer.begin(), m_buffer.begin() + m_packSize, shared);
+            // in pieces, the count of MPI_Bcast is an int
+            constexpr std::size_t maxChunk = std::numeric_limits<int>::max();
+            for (std::size_t offset = 0; offset < m_packSize; offset += maxChunk) {
+                const auto count = static_cast<int>(std::min(maxChunk, m_packSize - offset));
+                MPI_Bcast(shared + offset, count, MPI_CHAR, 0, m_leaderComm);
+            }
+        }
+        MPI_Win_fence(0, win);
+
+        if (rank != 0)
+            m_buffer.assign(shared, shared + m_packSize);
+
+        MPI_Win_free(&win);
+#else
+        if (m_comm.rank() != 0)
+            m_buffer.resize(m_packSize);
+        m_comm.broadcast(m_buffer.data(), m_packSize, 0);
+#endif
+    }
+
     //! \brief Enumeration of operations.
     enum class Operation {
         PACKSIZE, //!< Calculating serialization buffer size
@@ -482,6 +564,11 @@ protected:
     size_t m_packSize = 0; //!< Required buffer size after PACKSIZE has been done
     int m_position = 0; //!< Current position in buffer
     std::vector<char> m_buffer; //!< Buffer for serialized data
+#if HAVE_MPI && MPI_VERSION >= 3
+    MPI_Comm m_nodeComm = MPI_COMM_NULL; //!< Processes sharing memory with this one
+    MPI_Comm m_leaderComm = MPI_COMM_NULL; //!< Rank 0 of each node, null on the others
+    int m_nodeRank = 0; //!< Rank within m_nodeComm
+#endif
 };
 
 }
@@ -48,6 +48,8 @@
 
 #include <ebos/eclgenericoutputblackoilmodule.hh>
 
+#include <opm/simulators/utils/PhaseActivity.hpp>
+
 #include <dune/common/fvector.hh>
 
 #include <type_traits>
@@ -92,9 +94,12 @@ class EclOutputBlackOilModule : public EclGenericOutputBlackoilModule<GetPropTyp
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using Evaluation = GetPropType<TypeTag, Properties::Evaluation>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
     using MaterialLaw = GetPropType<TypeTag, Properties::MaterialLaw>;
     using MaterialLawParams = GetPropType<TypeTag, Properties::MaterialLawParams>;
     using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
+    using Indices = GetPropType<TypeTag, Properties::Indices>;
+    using PhaseActivity = Opm::PhaseActivity<FluidSystem, Indices>;
     using GridView = GetPropType<TypeTag, Properties::GridView>;
     using Element = typename GridView::template Codim<0>::Entity;
     using ElementIterator = typename GridView::template Codim<0>::Iterator;
@@ -184,348 +189,362 @@ public:
         if (!std::is_same<Discretization, EcfvDiscretization<TypeTag> >::value)
             return;
 
-        const auto& problem = elemCtx.simulator().problem();
         for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx) {
-            const auto& intQuants = elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
-            const auto& fs = intQuants.fluidState();
+            processCell(elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0),
+                        elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0));
+        }
+    }
+
+    /*!
+     * \brief Modify the internal buffers according to the intensive quantities of
+     *        a single cell
+     *
+     * This allows to use the intensive quantities cached by the model during the
+     * last linearization instead of updating them again for every element.
+     */
+    void processCell(unsigned globalDofIdx, const IntensiveQuantities& intQuants)
+    {
+        if (!std::is_same<Discretization, EcfvDiscretization<TypeTag> >::value)
+            return;
 
-            typedef typename std::remove_const<typename std::remove_reference<decltype(fs)>::type>::type FluidState;
-            unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-            unsigned pvtRegionIdx = elemCtx.primaryVars(dofIdx, /*timeIdx=*/0).pvtRegionIndex();
+        const auto& problem = simulator_.problem();
+        const auto& fs = intQuants.fluidState();
 
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (this->saturation_[phaseIdx].empty())
-                    continue;
+        typedef typename std::remove_const<typename std::remove_reference<decltype(fs)>::type>::type FluidState;
+        unsigned pvtRegionIdx = intQuants.pvtRegionIndex();
 
-                this->saturation_[phaseIdx][globalDofIdx] = getValue(fs.saturation(phaseIdx));
-                Valgrind::CheckDefined(this->saturation_[phaseIdx][globalDofIdx]);
-            }
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (this->saturation_[phaseIdx].empty())
+                continue;
+
+            this->saturation_[phaseIdx][globalDofIdx] = getValue(fs.saturation(phaseIdx));
+            Valgrind::CheckDefined(this->saturation_[phaseIdx][globalDofIdx]);
+        }
 
-            if (!this->oilPressure_.empty()) {
-                if (FluidSystem::phaseIsActive(oilPhaseIdx)) {
-                    this->oilPressure_[globalDofIdx] = getValue(fs.pressure(oilPhaseIdx));
-                }else{
-                    // put pressure in oil pressure for output
-                    if (FluidSystem::phaseIsActive(waterPhaseIdx)) {
-                        this->oilPressure_[globalDofIdx] = getValue(fs.pressure(waterPhaseIdx));
-                    } else {
-                        this->oilPressure_[globalDofIdx] = getValue(fs.pressure(gasPhaseIdx));
-                    }
+        if (!this->oilPressure_.empty()) {
+            if (PhaseActivity::phaseIsActive(oilPhaseIdx)) {
+                this->oilPressure_[globalDofIdx] = getValue(fs.pressure(oilPhaseIdx));
+            }else{
+                // put pressure in oil pressure for output
+                if (PhaseActivity::phaseIsActive(waterPhaseIdx)) {
+                    this->oilPressure_[globalDofIdx] = getValue(fs.pressure(waterPhaseIdx));
+                } else {
+                    this->oilPressure_[globalDofIdx] = getValue(fs.pressure(gasPhaseIdx));
                 }
-                Valgrind::CheckDefined(this->oilPressure_[globalDofIdx]);
             }
+            Valgrind::CheckDefined(this->oilPressure_[globalDofIdx]);
+        }
 
-            if (!this->temperature_.empty()) {
-                this->temperature_[globalDofIdx] = getValue(fs.temperature(oilPhaseIdx));
-                Valgrind::CheckDefined(this->temperature_[globalDofIdx]);
-            }
-            if (!this->gasDissolutionFactor_.empty()) {
-                Scalar SoMax = elemCtx.problem().maxOilSaturation(globalDofIdx);
-                this->gasDissolutionFactor_[globalDofIdx] =
-                    FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx, SoMax);
-                Valgrind::CheckDefined(this->gasDissolutionFactor_[globalDofIdx]);
+        if (!this->temperature_.empty()) {
+            this->temperature_[globalDofIdx] = getValue(fs.temperature(oilPhaseIdx));
+            Valgrind::CheckDefined(this->temperature_[globalDofIdx]);
+        }
+        if (!this->gasDissolutionFactor_.empty()) {
+            Scalar SoMax = problem.maxOilSaturation(globalDofIdx);
+            this->gasDissolutionFactor_[globalDofIdx] =
+                FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx, SoMax);
+            Valgrind::CheckDefined(this->gasDissolutionFactor_[globalDofIdx]);
 
-            }
-            if (!this->oilVaporizationFactor_.empty()) {
-                Scalar SoMax = elemCtx.problem().maxOilSaturation(globalDofIdx);
-                this->oilVaporizationFactor_[globalDofIdx] =
-                    FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx, SoMax);
-                Valgrind::CheckDefined(this->oilVaporizationFactor_[globalDofIdx]);
+        }
+        if (!this->oilVaporizationFactor_.empty()) {
+            Scalar SoMax = problem.maxOilSaturation(globalDofIdx);
+            this->oilVaporizationFactor_[globalDofIdx] =
+                FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx, SoMax);
+            Valgrind::CheckDefined(this->oilVaporizationFactor_[globalDofIdx]);
 
-            }
-            if (!this->gasFormationVolumeFactor_.empty()) {
-                this->gasFormationVolumeFactor_[globalDofIdx] =
-                    1.0/FluidSystem::template inverseFormationVolumeFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx);
-                Valgrind::CheckDefined(this->gasFormationVolumeFactor_[globalDofIdx]);
+        }
+        if (!this->gasFormationVolumeFactor_.empty()) {
+            this->gasFormationVolumeFactor_[globalDofIdx] =
+                1.0/FluidSystem::template inverseFormationVolumeFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx);
+            Valgrind::CheckDefined(this->gasFormationVolumeFactor_[globalDofIdx]);
 
-            }
-            if (!this->saturatedOilFormationVolumeFactor_.empty()) {
-                this->saturatedOilFormationVolumeFactor_[globalDofIdx] =
-                    1.0/FluidSystem::template saturatedInverseFormationVolumeFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
-                Valgrind::CheckDefined(this->saturatedOilFormationVolumeFactor_[globalDofIdx]);
+        }
+        if (!this->saturatedOilFormationVolumeFactor_.empty()) {
+            this->saturatedOilFormationVolumeFactor_[globalDofIdx] =
+                1.0/FluidSystem::template saturatedInverseFormationVolumeFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
+            Valgrind::CheckDefined(this->saturatedOilFormationVolumeFactor_[globalDofIdx]);
 
-            }
-            if (!this->oilSaturationPressure_.empty()) {
-                this->oilSaturationPressure_[globalDofIdx] =
-                    FluidSystem::template saturationPressure<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
-                Valgrind::CheckDefined(this->oilSaturationPressure_[globalDofIdx]);
+        }
+        if (!this->oilSaturationPressure_.empty()) {
+            this->oilSaturationPressure_[globalDofIdx] =
+                FluidSystem::template saturationPressure<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
+            Valgrind::CheckDefined(this->oilSaturationPressure_[globalDofIdx]);
 
-            }
+        }
 
-            if (!this->rs_.empty()) {
-                this->rs_[globalDofIdx] = getValue(fs.Rs());
-                Valgrind::CheckDefined(this->rs_[globalDofIdx]);
-            }
+        if (!this->rs_.empty()) {
+            this->rs_[globalDofIdx] = getValue(fs.Rs());
+            Valgrind::CheckDefined(this->rs_[globalDofIdx]);
+        }
 
-            if (!this->rv_.empty()) {
-                this->rv_[globalDofIdx] = getValue(fs.Rv());
-                Valgrind::CheckDefined(this->rv_[globalDofIdx]);
-            }
+        if (!this->rv_.empty()) {
+            this->rv_[globalDofIdx] = getValue(fs.Rv());
+            Valgrind::CheckDefined(this->rv_[globalDofIdx]);
+        }
 
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (this->invB_[phaseIdx].empty())
-                    continue;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (this->invB_[phaseIdx].empty())
+                continue;
 
-                this->invB_[phaseIdx][globalDofIdx] = getValue(fs.invB(phaseIdx));
-                Valgrind::CheckDefined(this->invB_[phaseIdx][globalDofIdx]);
-            }
+            this->invB_[phaseIdx][globalDofIdx] = getValue(fs.invB(phaseIdx));
+            Valgrind::CheckDefined(this->invB_[phaseIdx][globalDofIdx]);
+        }
 
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (this->density_[phaseIdx].empty())
-                    continue;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (this->density_[phaseIdx].empty())
+                continue;
 
-                this->density_[phaseIdx][globalDofIdx] = getValue(fs.density(phaseIdx));
-                Valgrind::CheckDefined(this->density_[phaseIdx][globalDofIdx]);
-            }
+            this->density_[phaseIdx][globalDofIdx] = getValue(fs.density(phaseIdx));
+            Valgrind::CheckDefined(this->density_[phaseIdx][globalDofIdx]);
+        }
 
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (this->viscosity_[phaseIdx].empty())
-                    continue;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (this->viscosity_[phaseIdx].empty())
+                continue;
 
-                if (!this->extboX_.empty() && phaseIdx==oilPhaseIdx)
-                    this->viscosity_[phaseIdx][globalDofIdx] = getValue(intQuants.oilViscosity());
-                else if (!this->extboX_.empty() && phaseIdx==gasPhaseIdx)
-                    this->viscosity_[phaseIdx][globalDofIdx] = getValue(intQuants.gasViscosity());
-                else
-                    this->viscosity_[phaseIdx][globalDofIdx] = getValue(fs.viscosity(phaseIdx));
-                Valgrind::CheckDefined(this->viscosity_[phaseIdx][globalDofIdx]);
-            }
+            if (!this->extboX_.empty() && phaseIdx==oilPhaseIdx)
+                this->viscosity_[phaseIdx][globalDofIdx] = getValue(intQuants.oilViscosity());
+            else if (!this->extboX_.empty() && phaseIdx==gasPhaseIdx)
+                this->viscosity_[phaseIdx][globalDofIdx] = getValue(intQuants.gasViscosity());
+            else
+                this->viscosity_[phaseIdx][globalDofIdx] = getValue(fs.viscosity(phaseIdx));
+            Valgrind::CheckDefined(this->viscosity_[phaseIdx][globalDofIdx]);
+        }
 
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (this->relativePermeability_[phaseIdx].empty())
-                    continue;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (this->relativePermeability_[phaseIdx].empty())
+                continue;
 
-                this->relativePermeability_[phaseIdx][globalDofIdx] = getValue(intQuants.relativePermeability(phaseIdx));
-                Valgrind::CheckDefined(this->relativePermeability_[phaseIdx][globalDofIdx]);
-            }
+            this->relativePermeability_[phaseIdx][globalDofIdx] = getValue(intQuants.relativePermeability(phaseIdx));
+            Valgrind::CheckDefined(this->relativePermeability_[phaseIdx][globalDofIdx]);
+        }
 
-            if (!this->sSol_.empty()) {
-                this->sSol_[globalDofIdx] = intQuants.solventSaturation().value();
-            }
+        if (!this->sSol_.empty()) {
+            this->sSol_[globalDofIdx] = intQuants.solventSaturation().value();
+        }
 
-            if (!this->cPolymer_.empty()) {
-                this->cPolymer_[globalDofIdx] = intQuants.polymerConcentration().value();
-            }
+        if (!this->cPolymer_.empty()) {
+            this->cPolymer_[globalDofIdx] = intQuants.polymerConcentration().value();
+        }
 
-            if (!this->cFoam_.empty()) {
-                this->cFoam_[globalDofIdx] = intQuants.foamConcentration().value();
-            }
+        if (!this->cFoam_.empty()) {
+            this->cFoam_[globalDofIdx] = intQuants.foamConcentration().value();
+        }
 
-            if (!this->cSalt_.empty()) {
-                this->cSalt_[globalDofIdx] = fs.saltConcentration().value();
-            }
+        if (!this->cSalt_.empty()) {
+            this->cSalt_[globalDofIdx] = fs.saltConcentration().value();
+        }
 
-            if (!this->extboX_.empty()) {
-                this->extboX_[globalDofIdx] = intQuants.xVolume().value();
-            }
+        if (!this->extboX_.empty()) {
+            this->extboX_[globalDofIdx] = intQuants.xVolume().value();
+        }
 
-            if (!this->extboY_.empty()) {
-                this->extboY_[globalDofIdx] = intQuants.yVolume().value();
-            }
+        if (!this->extboY_.empty()) {
+            this->extboY_[globalDofIdx] = intQuants.yVolume().value();
+        }
 
-            if (!this->extboZ_.empty()) {
-                this->extboZ_[globalDofIdx] = intQuants.zFraction().value();
-            }
+        if (!this->extboZ_.empty()) {
+            this->extboZ_[globalDofIdx] = intQuants.zFraction().value();
+        }
 
-            if (!this->mFracCo2_.empty()) {
-                const Scalar stdVolOil = getValue(fs.saturation(oilPhaseIdx))*getValue(fs.invB(oilPhaseIdx))
-                                       + getValue(fs.saturation(gasPhaseIdx))*getValue(fs.invB(gasPhaseIdx))*getValue(fs.Rv());
-                const Scalar stdVolGas = getValue(fs.saturation(gasPhaseIdx))*getValue(fs.invB(gasPhaseIdx))*(1.0-intQuants.yVolume().value())
-                                       + getValue(fs.saturation(oilPhaseIdx))*getValue(fs.invB(oilPhaseIdx))*getValue(fs.Rs())*(1.0-intQuants.xVolume().value());
-                const Scalar stdVolCo2 = getValue(fs.saturation(gasPhaseIdx))*getValue(fs.invB(gasPhaseIdx))*intQuants.yVolume().value()
-                                       + getValue(fs.saturation(oilPhaseIdx))*getValue(fs.invB(oilPhaseIdx))*getValue(fs.Rs())*intQuants.xVolume().value();
-                const Scalar rhoO= FluidSystem::referenceDensity(gasPhaseIdx, pvtRegionIdx);
-                const Scalar rhoG= FluidSystem::referenceDensity(gasPhaseIdx, pvtRegionIdx);
-                const Scalar rhoCO2= intQuants.zRefDensity();
-                const Scalar stdMassTotal= 1.0e-10 + stdVolOil*rhoO + stdVolGas*rhoG + stdVolCo2*rhoCO2;
-                this->mFracOil_[globalDofIdx] = stdVolOil*rhoO/stdMassTotal;
-                this->mFracGas_[globalDofIdx] = stdVolGas*rhoG/stdMassTotal;
-                this->mFracCo2_[globalDofIdx] = stdVolCo2*rhoCO2/stdMassTotal;
-            }
+        if (!this->mFracCo2_.empty()) {
+            const Scalar stdVolOil = getValue(fs.saturation(oilPhaseIdx))*getValue(fs.invB(oilPhaseIdx))
+                                   + getValue(fs.saturation(gasPhaseIdx))*getValue(fs.invB(gasPhaseIdx))*getValue(fs.Rv());
+            const Scalar stdVolGas = getValue(fs.saturation(gasPhaseIdx))*getValue(fs.invB(gasPhaseIdx))*(1.0-intQuants.yVolume().value())
+                                   + getValue(fs.saturation(oilPhaseIdx))*getValue(fs.invB(oilPhaseIdx))*getValue(fs.Rs())*(1.0-intQuants.xVolume().value());
+            const Scalar stdVolCo2 = getValue(fs.saturation(gasPhaseIdx))*getValue(fs.invB(gasPhaseIdx))*intQuants.yVolume().value()
+                                   + getValue(fs.saturation(oilPhaseIdx))*getValue(fs.invB(oilPhaseIdx))*getValue(fs.Rs())*intQuants.xVolume().value();
+            const Scalar rhoO= FluidSystem::referenceDensity(gasPhaseIdx, pvtRegionIdx);
+            const Scalar rhoG= FluidSystem::referenceDensity(gasPhaseIdx, pvtRegionIdx);
+            const Scalar rhoCO2= intQuants.zRefDensity();
+            const Scalar stdMassTotal= 1.0e-10 + stdVolOil*rhoO + stdVolGas*rhoG + stdVolCo2*rhoCO2;
+            this->mFracOil_[globalDofIdx] = stdVolOil*rhoO/stdMassTotal;
+            this->mFracGas_[globalDofIdx] = stdVolGas*rhoG/stdMassTotal;
+            this->mFracCo2_[globalDofIdx] = stdVolCo2*rhoCO2/stdMassTotal;
+        }
 
-            if (!this->bubblePointPressure_.empty()) {
-                try {
-                    this->bubblePointPressure_[globalDofIdx] = getValue(FluidSystem::bubblePointPressure(fs, intQuants.pvtRegionIndex()));
-                }
-                catch (const NumericalIssue&) {
-                    const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-                    this->failedCellsPb_.push_back(cartesianIdx);
-                }
+        if (!this->bubblePointPressure_.empty()) {
+            try {
+                this->bubblePointPressure_[globalDofIdx] = getValue(FluidSystem::bubblePointPressure(fs, intQuants.pvtRegionIndex()));
             }
-            if (!this->dewPointPressure_.empty()) {
-                try {
-                    this->dewPointPressure_[globalDofIdx] = getValue(FluidSystem::dewPointPressure(fs, intQuants.pvtRegionIndex()));
-                }
-                catch (const NumericalIssue&) {
-                    const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-                    this->failedCellsPd_.push_back(cartesianIdx);
-                }
+            catch (const NumericalIssue&) {
+                const auto cartesianIdx = simulator_.vanguard().grid().globalCell()[globalDofIdx];
+                this->failedCellsPb_.push_back(cartesianIdx);
             }
-
-            if (!this->soMax_.empty())
-                this->soMax_[globalDofIdx] =
-                    std::max(getValue(fs.saturation(oilPhaseIdx)),
-                             problem.maxOilSaturation(globalDofIdx));
-
-            if (!this->swMax_.empty())
-                this->swMax_[globalDofIdx] =
-                    std::max(getValue(fs.saturation(waterPhaseIdx)),
-                             problem.maxWaterSaturation(globalDofIdx));
-
-            if (!this->minimumOilPressure_.empty())
-                this->minimumOilPressure_[globalDofIdx] =
-                    std::min(getValue(fs.pressure(oilPhaseIdx)),
-                             problem.minOilPressure(globalDofIdx));
-
-            if (!this->overburdenPressure_.empty())
-                this->overburdenPressure_[globalDofIdx] = problem.overburdenPressure(globalDofIdx);
-
-            if (!this->rockCompPorvMultiplier_.empty())
-                this->rockCompPorvMultiplier_[globalDofIdx] = problem.template rockCompPoroMultiplier<Scalar>(intQuants, globalDofIdx);
-
-            if (!this->rockCompTransMultiplier_.empty())
-                this->rockCompTransMultiplier_[globalDofIdx] = problem.template rockCompTransMultiplier<Scalar>(intQuants, globalDofIdx);
-
-            const auto& matLawManager = problem.materialLawManager();
-            if (matLawManager->enableHysteresis()) {
-                if (!this->pcSwMdcOw_.empty() && !this->krnSwMdcOw_.empty()) {
-                    matLawManager->oilWaterHysteresisParams(
-                                this->pcSwMdcOw_[globalDofIdx],
-                                this->krnSwMdcOw_[globalDofIdx],
-                                globalDofIdx);
-                }
-                if (!this->pcSwMdcGo_.empty() && !this->krnSwMdcGo_.empty()) {
-                    matLawManager->gasOilHysteresisParams(
-                                this->pcSwMdcGo_[globalDofIdx],
-                                this->krnSwMdcGo_[globalDofIdx],
-                                globalDofIdx);
-                }
+        }
+        if (!this->dewPointPressure_.empty()) {
+            try {
+                this->dewPointPressure_[globalDofIdx] = getValue(FluidSystem::dewPointPressure(fs, intQuants.pvtRegionIndex()));
+            }
+            catch (const NumericalIssue&) {
+                const auto cartesianIdx = simulator_.vanguard().grid().globalCell()[globalDofIdx];
+                this->failedCellsPd_.push_back(cartesianIdx);
             }
+        }
+
+        if (!this->soMax_.empty())
+            this->soMax_[globalDofIdx] =
+                std::max(getValue(fs.saturation(oilPhaseIdx)),
+                         problem.maxOilSaturation(globalDofIdx));
 
+        if (!this->swMax_.empty())
+            this->swMax_[globalDofIdx] =
+                std::max(getValue(fs.saturation(waterPhaseIdx)),
+                         problem.maxWaterSaturation(globalDofIdx));
 
-            if (!this->ppcw_.empty()) {
-                this->ppcw_[globalDofIdx] = matLawManager->oilWaterScaledEpsInfoDrainage(globalDofIdx).maxPcow;
-                //printf("ppcw_[%d] = %lg\n", globalDofIdx, ppcw_[globalDofIdx]);
+        if (!this->minimumOilPressure_.empty())
+            this->minimumOilPressure_[globalDofIdx] =
+                std::min(getValue(fs.pressure(oilPhaseIdx)),
+                         problem.minOilPressure(globalDofIdx));
+
+        if (!this->overburdenPressure_.empty())
+            this->overburdenPressure_[globalDofIdx] = problem.overburdenPressure(globalDofIdx);
+
+        if (!this->rockCompPorvMultiplier_.empty())
+            this->rockCompPorvMultiplier_[globalDofIdx] = problem.template rockCompPoroMultiplier<Scalar>(intQuants, globalDofIdx);
+
+        if (!this->rockCompTransMultiplier_.empty())
+            this->rockCompTransMultiplier_[globalDofIdx] = problem.template rockCompTransMultiplier<Scalar>(intQuants, globalDofIdx);
+
+        const auto& matLawManager = problem.materialLawManager();
+        if (matLawManager->enableHysteresis()) {
+            if (!this->pcSwMdcOw_.empty() && !this->krnSwMdcOw_.empty()) {
+                matLawManager->oilWaterHysteresisParams(
+                            this->pcSwMdcOw_[globalDofIdx],
+                            this->krnSwMdcOw_[globalDofIdx],
+                            globalDofIdx);
+            }
+            if (!this->pcSwMdcGo_.empty() && !this->krnSwMdcGo_.empty()) {
+                matLawManager->gasOilHysteresisParams(
+                            this->pcSwMdcGo_[globalDofIdx],
+                            this->krnSwMdcGo_[globalDofIdx],
+                            globalDofIdx);
             }
-            // hack to make the intial output of rs and rv Ecl compatible.
-            // For cells with swat == 1 Ecl outputs; rs = rsSat and rv=rvSat, in all but the initial step
-            // where it outputs rs and rv values calculated by the initialization. To be compatible we overwrite
-            // rs and rv with the values computed in the initially.
-            // Volume factors, densities and viscosities need to be recalculated with the updated rs and rv values.
-            // This can be removed when ebos has 100% controll over output
-            if (elemCtx.simulator().episodeIndex() < 0 && FluidSystem::phaseIsActive(oilPhaseIdx) && FluidSystem::phaseIsActive(gasPhaseIdx)) {
-
-                const auto& fsInitial = problem.initialFluidState(globalDofIdx);
-
-                // use initial rs and rv values
-                if (!this->rv_.empty())
-                    this->rv_[globalDofIdx] = fsInitial.Rv();
-
-                if (!this->rs_.empty())
-                    this->rs_[globalDofIdx] = fsInitial.Rs();
-
-                // re-compute the volume factors, viscosities and densities if asked for
-                if (!this->density_[oilPhaseIdx].empty())
-                    this->density_[oilPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
+        }
+
+
+        if (!this->ppcw_.empty()) {
+            this->ppcw_[globalDofIdx] = matLawManager->oilWaterScaledEpsInfoDrainage(globalDofIdx).maxPcow;
+            //printf("ppcw_[%d] = %lg\n", globalDofIdx, ppcw_[globalDofIdx]);
+        }
+        // hack to make the intial output of rs and rv Ecl compatible.
+        // For cells with swat == 1 Ecl outputs; rs = rsSat and rv=rvSat, in all but the initial step
+        // where it outputs rs and rv values calculated by the initialization. To be compatible we overwrite
+        // rs and rv with the values computed in the initially.
+        // Volume factors, densities and viscosities need to be recalculated with the updated rs and rv values.
+        // This can be removed when ebos has 100% controll over output
+        if (simulator_.episodeIndex() < 0 && PhaseActivity::phaseIsActive(oilPhaseIdx) && PhaseActivity::phaseIsActive(gasPhaseIdx)) {
+
+            const auto& fsInitial = problem.initialFluidState(globalDofIdx);
+
+            // use initial rs and rv values
+            if (!this->rv_.empty())
+                this->rv_[globalDofIdx] = fsInitial.Rv();
+
+            if (!this->rs_.empty())
+                this->rs_[globalDofIdx] = fsInitial.Rs();
+
+            // re-compute the volume factors, viscosities and densities if asked for
+            if (!this->density_[oilPhaseIdx].empty())
+                this->density_[oilPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
+                                                                                 oilPhaseIdx,
+                                                                                 intQuants.pvtRegionIndex());
+            if (!this->density_[gasPhaseIdx].empty())
+                this->density_[gasPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
+                                                                                 gasPhaseIdx,
+                                                                                 intQuants.pvtRegionIndex());
+
+            if (!this->invB_[oilPhaseIdx].empty())
+                this->invB_[oilPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
+                                                                                                   oilPhaseIdx,
+                                                                                                   intQuants.pvtRegionIndex());
+            if (!this->invB_[gasPhaseIdx].empty())
+                this->invB_[gasPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
+                                                                                             gasPhaseIdx,
+                                                                                             intQuants.pvtRegionIndex());
+            if (!this->viscosity_[oilPhaseIdx].empty())
+                this->viscosity_[oilPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
                                                                                      oilPhaseIdx,
                                                                                      intQuants.pvtRegionIndex());
-                if (!this->density_[gasPhaseIdx].empty())
-                    this->density_[gasPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
+            if (!this->viscosity_[gasPhaseIdx].empty())
+                this->viscosity_[gasPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
                                                                                      gasPhaseIdx,
                                                                                      intQuants.pvtRegionIndex());
+        }
 
-                if (!this->invB_[oilPhaseIdx].empty())
-                    this->invB_[oilPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
-                                                                                                       oilPhaseIdx,
-                                                                                                       intQuants.pvtRegionIndex());
-                if (!this->invB_[gasPhaseIdx].empty())
-                    this->invB_[gasPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
-                                                                                                 gasPhaseIdx,
-                                                                                                 intQuants.pvtRegionIndex());
-                if (!this->viscosity_[oilPhaseIdx].empty())
-                    this->viscosity_[oilPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
-                                                                                         oilPhaseIdx,
-                                                                                         intQuants.pvtRegionIndex());
-                if (!this->viscosity_[gasPhaseIdx].empty())
-                    this->viscosity_[gasPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
-                                                                                         gasPhaseIdx,
-                                                                                         intQuants.pvtRegionIndex());
-            }
-
-            // Add fluid in Place values
-            updateFluidInPlace_(elemCtx, dofIdx);
-
-            // Adding block data
-            const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-            for (auto& val: this->blockData_) {
-                const auto& key = val.first;
-                int cartesianIdxBlock = key.second - 1;
-                if (cartesianIdx == cartesianIdxBlock) {
-                    if ((key.first == "BWSAT") || (key.first == "BSWAT"))
-                        val.second = getValue(fs.saturation(waterPhaseIdx));
-                    else if ((key.first == "BGSAT") || (key.first == "BSGAS"))
-                        val.second = getValue(fs.saturation(gasPhaseIdx));
-                    else if ((key.first == "BOSAT") || (key.first == "BSOIL"))
-                        val.second = getValue(fs.saturation(oilPhaseIdx));
-                    else if ((key.first == "BPR") || (key.first == "BPRESSUR"))
-                        val.second = getValue(fs.pressure(oilPhaseIdx));
-                    else if (key.first == "BWKR" || key.first == "BKRW")
-                        val.second = getValue(intQuants.relativePermeability(waterPhaseIdx));
-                    else if (key.first == "BGKR" || key.first == "BKRG")
-                        val.second = getValue(intQuants.relativePermeability(gasPhaseIdx));
-                    else if (key.first == "BOKR" || key.first == "BKRO")
-                        val.second = getValue(intQuants.relativePermeability(oilPhaseIdx));
-                    else if (key.first == "BKROG") {
-                        const auto& materialParams = problem.materialLawParams(elemCtx, dofIdx, /* timeIdx = */ 0);
-                        const auto krog = MaterialLaw::template relpermOilInOilGasSystem<Evaluation>(materialParams, fs);
-                        val.second = getValue(krog);
-                    }
-                    else if (key.first == "BKROW") {
-                        const auto& materialParams = problem.materialLawParams(elemCtx, dofIdx, /* timeIdx = */ 0);
-                        const auto krow = MaterialLaw::template relpermOilInOilWaterSystem<Evaluation>(materialParams, fs);
-                        val.second = getValue(krow);
-                    }
-                    else if (key.first == "BWPC")
-                        val.second = getValue(fs.pressure(oilPhaseIdx)) - getValue(fs.pressure(waterPhaseIdx));
-                    else if (key.first == "BGPC")
-                        val.second = getValue(fs.pressure(gasPhaseIdx)) - getValue(fs.pressure(oilPhaseIdx));
-                    else if (key.first == "BVWAT" || key.first == "BWVIS")
-                        val.second = getValue(fs.viscosity(waterPhaseIdx));
-                    else if (key.first == "BVGAS" || key.first == "BGVIS")
-                        val.second = getValue(fs.viscosity(gasPhaseIdx));
-                    else if (key.first == "BVOIL" || key.first == "BOVIS")
-                        val.second = getValue(fs.viscosity(oilPhaseIdx));
-                    else {
-                        std::string logstring = "Keyword '";
-                        logstring.append(key.first);
-                        logstring.append("' is unhandled for output to file.");
-                        OpmLog::warning("Unhandled output keyword", logstring);
-                    }
+        // Add fluid in Place values
+        updateFluidInPlace_(globalDofIdx, intQuants);
+
+        // Adding block data
+        const auto cartesianIdx = simulator_.vanguard().grid().globalCell()[globalDofIdx];
+        for (auto& val: this->blockData_) {
+            const auto& key = val.first;
+            int cartesianIdxBlock = key.second - 1;
+            if (cartesianIdx == cartesianIdxBlock) {
+                if ((key.first == "BWSAT") || (key.first == "BSWAT"))
+                    val.second = getValue(fs.saturation(waterPhaseIdx));
+                else if ((key.first == "BGSAT") || (key.first == "BSGAS"))
+                    val.second = getValue(fs.saturation(gasPhaseIdx));
+                else if ((key.first == "BOSAT") || (key.first == "BSOIL"))
+                    val.second = getValue(fs.saturation(oilPhaseIdx));
+                else if ((key.first == "BPR") || (key.first == "BPRESSUR"))
+                    val.second = getValue(fs.pressure(oilPhaseIdx));
+                else if (key.first == "BWKR" || key.first == "BKRW")
+                    val.second = getValue(intQuants.relativePermeability(waterPhaseIdx));
+                else if (key.first == "BGKR" || key.first == "BKRG")
+                    val.second = getValue(intQuants.relativePermeability(gasPhaseIdx));
+                else if (key.first == "BOKR" || key.first == "BKRO")
+                    val.second = getValue(intQuants.relativePermeability(oilPhaseIdx));
+                else if (key.first == "BKROG") {
+                    const auto& materialParams = problem.materialLawParams(globalDofIdx);
+                    const auto krog = MaterialLaw::template relpermOilInOilGasSystem<Evaluation>(materialParams, fs);
+                    val.second = getValue(krog);
+                }
+                else if (key.first == "BKROW") {
+                    const auto& materialParams = problem.materialLawParams(globalDofIdx);
+                    const auto krow = MaterialLaw::template relpermOilInOilWaterSystem<Evaluation>(materialParams, fs);
+                    val.second = getValue(krow);
+                }
+                else if (key.first == "BWPC")
+                    val.second = getValue(fs.pressure(oilPhaseIdx)) - getValue(fs.pressure(waterPhaseIdx));
+                else if (key.first == "BGPC")
+                    val.second = getValue(fs.pressure(gasPhaseIdx)) - getValue(fs.pressure(oilPhaseIdx));
+                else if (key.first == "BVWAT" || key.first == "BWVIS")
+                    val.second = getValue(fs.viscosity(waterPhaseIdx));
+                else if (key.first == "BVGAS" || key.first == "BGVIS")
+                    val.second = getValue(fs.viscosity(gasPhaseIdx));
+                else if (key.first == "BVOIL" || key.first == "BOVIS")
+                    val.second = getValue(fs.viscosity(oilPhaseIdx));
+                else {
+                    std::string logstring = "Keyword '";
+                    logstring.append(key.first);
+                    logstring.append("' is unhandled for output to file.");
+                    OpmLog::warning("Unhandled output keyword", logstring);
                 }
             }
+        }
 
-            // Adding Well RFT data
-            if (this->oilConnectionPressures_.count(cartesianIdx) > 0) {
-                this->oilConnectionPressures_[cartesianIdx] = getValue(fs.pressure(oilPhaseIdx));
-            }
-            if (this->waterConnectionSaturations_.count(cartesianIdx) > 0) {
-                this->waterConnectionSaturations_[cartesianIdx] = getValue(fs.saturation(waterPhaseIdx));
-            }
-            if (this->gasConnectionSaturations_.count(cartesianIdx) > 0) {
-                this->gasConnectionSaturations_[cartesianIdx] = getValue(fs.saturation(gasPhaseIdx));
-            }
-            if (this->wbpData_.count(cartesianIdx) > 0)
-                this->wbpData_[cartesianIdx] = getValue(fs.pressure(oilPhaseIdx));
-
-            // tracers
-            const auto& tracerModel = simulator_.problem().tracerModel();
-            if (!this->tracerConcentrations_.empty()) {
-                for (int tracerIdx = 0; tracerIdx < tracerModel.numTracers(); tracerIdx++){
-                    if (this->tracerConcentrations_[tracerIdx].empty())
-                        continue;
+        // Adding Well RFT data
+        if (this->oilConnectionPressures_.count(cartesianIdx) > 0) {
+            this->oilConnectionPressures_[cartesianIdx] = getValue(fs.pressure(oilPhaseIdx));
+        }
+        if (this->waterConnectionSaturations_.count(cartesianIdx) > 0) {
+            this->waterConnectionSaturations_[cartesianIdx] = getValue(fs.saturation(waterPhaseIdx));
+        }
+        if (this->gasConnectionSaturations_.count(cartesianIdx) > 0) {
+            this->gasConnectionSaturations_[cartesianIdx] = getValue(fs.saturation(gasPhaseIdx));
+        }
+        if (this->wbpData_.count(cartesianIdx) > 0)
+            this->wbpData_[cartesianIdx] = getValue(fs.pressure(oilPhaseIdx));
+
+        // tracers
+        const auto& tracerModel = simulator_.problem().tracerModel();
+        if (!this->tracerConcentrations_.empty()) {
+            for (int tracerIdx = 0; tracerIdx < tracerModel.numTracers(); tracerIdx++){
+                if (this->tracerConcentrations_[tracerIdx].empty())
+                    continue;
 
-                    this->tracerConcentrations_[tracerIdx][globalDofIdx] = tracerModel.tracerConcentration(tracerIdx, globalDofIdx);
-                }
+                this->tracerConcentrations_[tracerIdx][globalDofIdx] = tracerModel.tracerConcentration(tracerIdx, globalDofIdx);
             }
         }
     }
@@ -548,9 +567,9 @@ public:
             MaterialLaw::capillaryPressures(pc, matParams, fs);
             Valgrind::CheckDefined(this->oilPressure_[elemIdx]);
             Valgrind::CheckDefined(pc);
-            assert(FluidSystem::phaseIsActive(oilPhaseIdx));
+            assert(PhaseActivity::phaseIsActive(oilPhaseIdx));
             for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx))
+                if (!PhaseActivity::phaseIsActive(phaseIdx))
                     continue;
 
                 fs.setPressure(phaseIdx, this->oilPressure_[elemIdx] + (pc[phaseIdx] - pc[oilPhaseIdx]));
@@ -606,12 +625,9 @@ private:
         return candidate == parallelWells.end() || *candidate != value;
     }
 
-    void updateFluidInPlace_(const ElementContext& elemCtx, unsigned dofIdx)
+    void updateFluidInPlace_(unsigned globalDofIdx, const IntensiveQuantities& intQuants)
     {
-
-        const auto& intQuants = elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
         const auto& fs = intQuants.fluidState();
-        unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
 
         // Fluid in Place calculations
 
@@ -623,7 +639,7 @@ private:
         // returned by the intensive quantities can be outside of the physical
         // range [0, 1] in pathetic cases.
         const double pv =
-            elemCtx.simulator().model().dofTotalVolume(globalDofIdx)
+            simulator_.model().dofTotalVolume(globalDofIdx)
             * intQuants.porosity().value();
 
         if (!this->pressureTimesHydrocarbonVolume_.empty() && !this->pressureTimesPoreVolume_.empty()) {
@@ -633,14 +649,14 @@ private:
             this->fip_[Inplace::Phase::PoreVolume][globalDofIdx] = pv;
 
             Scalar hydrocarbon = 0.0;
-            if (FluidSystem::phaseIsActive(oilPhaseIdx))
+            if (PhaseActivity::phaseIsActive(oilPhaseIdx))
                 hydrocarbon += getValue(fs.saturation(oilPhaseIdx));
-            if (FluidSystem::phaseIsActive(gasPhaseIdx))
+            if (PhaseActivity::phaseIsActive(gasPhaseIdx))
                 hydrocarbon += getValue(fs.saturation(gasPhaseIdx));
 
             this->hydrocarbonPoreVolume_[globalDofIdx] = pv * hydrocarbon;
 
-            if (FluidSystem::phaseIsActive(oilPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(oilPhaseIdx)) {
                 this->pressureTimesPoreVolume_[globalDofIdx] = getValue(fs.pressure(oilPhaseIdx)) * pv;
                 this->pressureTimesHydrocarbonVolume_[globalDofIdx] = this->pressureTimesPoreVolume_[globalDofIdx] * hydrocarbon;
             }
@@ -651,7 +667,7 @@ private:
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
                 fip[phaseIdx] = 0.0;
 
-                if (!FluidSystem::phaseIsActive(phaseIdx))
+                if (!PhaseActivity::phaseIsActive(phaseIdx))
                     continue;
 
                 const double b = getValue(fs.invB(phaseIdx));
@@ -659,21 +675,21 @@ private:
                 fip[phaseIdx] = b * s * pv;
             }
 
-            if (FluidSystem::phaseIsActive(oilPhaseIdx) && !this->fip_[Inplace::Phase::OIL].empty())
+            if (PhaseActivity::phaseIsActive(oilPhaseIdx) && !this->fip_[Inplace::Phase::OIL].empty())
                 this->fip_[Inplace::Phase::OIL][globalDofIdx] = fip[oilPhaseIdx];
-            if (FluidSystem::phaseIsActive(gasPhaseIdx) && !this->fip_[Inplace::Phase::GAS].empty())
+            if (PhaseActivity::phaseIsActive(gasPhaseIdx) && !this->fip_[Inplace::Phase::GAS].empty())
                 this->fip_[Inplace::Phase::GAS][globalDofIdx] = fip[gasPhaseIdx];
-            if (FluidSystem::phaseIsActive(waterPhaseIdx) && !this->fip_[Inplace::Phase::WATER].empty())
+            if (PhaseActivity::phaseIsActive(waterPhaseIdx) && !this->fip_[Inplace::Phase::WATER].empty())
                 this->fip_[Inplace::Phase::WATER][globalDofIdx] = fip[waterPhaseIdx];
 
             // Store the pure oil and gas Fip
-            if (FluidSystem::phaseIsActive(oilPhaseIdx) && !this->fip_[Inplace::Phase::OilInLiquidPhase].empty())
+            if (PhaseActivity::phaseIsActive(oilPhaseIdx) && !this->fip_[Inplace::Phase::OilInLiquidPhase].empty())
                 this->fip_[Inplace::Phase::OilInLiquidPhase][globalDofIdx] = fip[oilPhaseIdx];
 
-            if (FluidSystem::phaseIsActive(gasPhaseIdx) && !this->fip_[Inplace::Phase::GasInGasPhase].empty())
+            if (PhaseActivity::phaseIsActive(gasPhaseIdx) && !this->fip_[Inplace::Phase::GasInGasPhase].empty())
                 this->fip_[Inplace::Phase::GasInGasPhase][globalDofIdx] = fip[gasPhaseIdx];
 
-            if (FluidSystem::phaseIsActive(oilPhaseIdx) && FluidSystem::phaseIsActive(gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(oilPhaseIdx) && PhaseActivity::phaseIsActive(gasPhaseIdx)) {
                 // Gas dissolved in oil and vaporized oil
                 Scalar gasInPlaceLiquid = getValue(fs.Rs()) * fip[oilPhaseIdx];
                 Scalar oilInPlaceGas = getValue(fs.Rv()) * fip[gasPhaseIdx];
@@ -65,11 +65,13 @@
 #include "eclnewtonmethod.hh"
 #include "ecltracermodel.hh"
 #include "vtkecltracermodule.hh"
+#include "vtkeclconvergencehotspotmodule.hh"
 #include "eclgenericproblem.hh"
 
 #include <opm/core/props/satfunc/RelpermDiagnostics.hpp>
 
 #include <opm/models/utils/pffgridvector.hh>
+#include <opm/models/parallel/threadedentityiterator.hh>
 #include <opm/models/blackoil/blackoilmodel.hh>
 #include <opm/models/discretization/ecfv/ecfvdiscretization.hh>
 
@@ -98,12 +100,19 @@
 #include <dune/common/version.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
+#include <dune/grid/io/file/vtk/common.hh>
 
 #include <opm/output/eclipse/EclipseIO.hpp>
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 
+#include <opm/simulators/utils/ConvergenceHotspots.hpp>
+#include <opm/simulators/utils/StartupProfile.hpp>
+
+#include <atomic>
+#include <exception>
 #include <set>
+#include <stdexcept>
 #include <vector>
 #include <string>
 #include <algorithm>
@@ -433,6 +442,18 @@ struct EnableVtkOutput<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = false;
 };
 
+// If the VTK output is enabled, write it in the appended binary format, which is much
+// smaller and faster to write than ASCII. The data is written by a separate thread from
+// a snapshot of the output fields, such that it does not block the simulation.
+template<class TypeTag>
+struct VtkOutputFormat<TypeTag, TTag::EclBaseProblem> {
+    static constexpr int value = Dune::VTK::appendedraw;
+};
+template<class TypeTag>
+struct EnableAsyncVtkOutput<TypeTag, TTag::EclBaseProblem> {
+    static constexpr bool value = true;
+};
+
 // ... but enable the ECL output by default
 template<class TypeTag>
 struct EnableEclOutput<TypeTag,TTag::EclBaseProblem> {
@@ -445,12 +466,36 @@ struct EnableAsyncEclOutput<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = true;
 };
 
+// By default, gather all cell data to the I/O rank in one exchange
+template<class TypeTag>
+struct EclOutputCollectPerField<TypeTag, TTag::EclBaseProblem> {
+    static constexpr bool value = false;
+};
+
+// By default, wait for the previous asynchronous ECL output before queuing the next
+template<class TypeTag>
+struct EclOutputQueueSize<TypeTag, TTag::EclBaseProblem> {
+    static constexpr int value = 1;
+};
+
 // By default, use single precision for the ECL formated results
 template<class TypeTag>
 struct EclOutputDoublePrecision<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = false;
 };
 
+// By default, write all cell data to the restart files
+template<class TypeTag>
+struct EclOutputRestartFields<TypeTag, TTag::EclBaseProblem> {
+    static constexpr auto value = "";
+};
+
+// By default, write the exact values of the cell data
+template<class TypeTag>
+struct EclOutputMantissaBits<TypeTag, TTag::EclBaseProblem> {
+    static constexpr int value = 0;
+};
+
 // The default location for the ECL output files
 template<class TypeTag>
 struct OutputDir<TypeTag, TTag::EclBaseProblem> {
@@ -551,6 +596,11 @@ struct EnableTracerModel<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = false;
 };
 
+template<class TypeTag>
+struct EnableTracerUpwindSolver<TypeTag, TTag::EclBaseProblem> {
+    static constexpr bool value = false;
+};
+
 // By default, simulators derived from the EclBaseProblem are production simulators,
 // i.e., experimental features must be explicitly enabled at compile time
 template<class TypeTag>
@@ -574,6 +624,20 @@ struct EclEnableTuning<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = false;
 };
 
+// Recompute the fluxes of all faces in every linearization by default
+template<class TypeTag>
+struct EclFluxReuseTolerance<TypeTag, TTag::EclBaseProblem> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+
+// all cells are fully implicit by default
+template<class TypeTag>
+struct EclAdaptiveImplicitCfl<TypeTag, TTag::EclBaseProblem> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+
 template<class TypeTag>
 struct OutputMode<TypeTag, TTag::EclBaseProblem> {
     static constexpr auto value = "all";
@@ -697,6 +761,8 @@ public:
                              "The frequencies of which time steps are serialized to disk");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTracerModel,
                              "Transport tracers found in the deck.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTracerUpwindSolver,
+                             "Solve the tracer equations by a single sweep in upwind order instead of iteratively");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EclEnableDriftCompensation,
                              "Enable partial compensation of systematic mass losses via the source term of the next time step");
         if constexpr (enableExperiments)
@@ -782,6 +848,7 @@ public:
         , tracerModel_(simulator)
     {
         this->model().addOutputModule(new VtkEclTracerModule<TypeTag>(simulator));
+        this->model().addOutputModule(new VtkEclConvergenceHotspotModule<TypeTag>(simulator));
         // Tell the black-oil extensions to initialize their internal data structures
         const auto& vanguard = simulator.vanguard();
         SolventModule::initFromState(vanguard.eclState(), vanguard.schedule());
@@ -863,8 +930,11 @@ public:
 
         this->readRockParameters_(simulator.vanguard().cellCenterDepths());
         readMaterialParameters_();
+        initHysteresisCells_();
         readThermalParameters_();
-        transmissibilities_.finishInit();
+        transmissibilities_.updateCached(true,
+                                         simulator.vanguard().transmissibilityCacheFile(/*global=*/false),
+                                         simulator.vanguard().transmissibilityCacheKey());
 
         const auto& initconfig = eclState.getInitConfig();
         if (initconfig.restartRequested())
@@ -927,7 +997,7 @@ public:
 
         // write the static output files (EGRID, INIT, SMSPEC, etc.)
         if (enableEclOutput_)
-            eclWriter_->writeInit();
+            eclWriter_->writeInit(transmissibilities_);
 
         simulator.vanguard().releaseGlobalTransmissibilities();
 
@@ -983,6 +1053,91 @@ public:
             aquiferModel_.serialize(res);
     }
 
+    /*!
+     * \brief Write the cell history of the problem to a rank local checkpoint.
+     *
+     * This covers the state which is not part of the primary variables: the
+     * saturation and pressure history of the cells, the DRSDT/DRVDT limits, the
+     * threshold pressures, the drift, the hysteresis state and the tracers.
+     */
+    template <class Buffer>
+    void writeCheckpoint(Buffer& buffer) const
+    {
+        buffer.write(this->maxOilSaturation_);
+        buffer.write(this->maxWaterSaturation_);
+        buffer.write(this->minOilPressure_);
+        buffer.write(this->maxPolymerAdsorption_);
+        buffer.write(this->lastRs_);
+        buffer.write(this->maxDRs_);
+        buffer.write(this->lastRv_);
+        buffer.write(this->maxDRv_);
+        buffer.write(thresholdPressures_.data());
+
+        buffer.write(drift_.size());
+        for (const auto& dofDrift : drift_)
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                buffer.write(dofDrift[eqIdx]);
+
+        const bool hysteresis = materialLawManager_->enableHysteresis();
+        buffer.write(hysteresis);
+        if (hysteresis) {
+            const unsigned numDof = this->model().numGridDof();
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+                Scalar values[4];
+                materialLawManager_->oilWaterHysteresisParams(values[0], values[1], dofIdx);
+                materialLawManager_->gasOilHysteresisParams(values[2], values[3], dofIdx);
+                buffer.write(values);
+            }
+        }
+
+        tracerModel_.writeCheckpoint(buffer);
+    }
+
+    /*!
+     * \brief Read the cell history written by writeCheckpoint().
+     */
+    template <class Buffer>
+    void readCheckpoint(Buffer& buffer)
+    {
+        buffer.read(this->maxOilSaturation_);
+        buffer.read(this->maxWaterSaturation_);
+        buffer.read(this->minOilPressure_);
+        buffer.read(this->maxPolymerAdsorption_);
+        buffer.read(this->lastRs_);
+        buffer.read(this->maxDRs_);
+        buffer.read(this->lastRv_);
+        buffer.read(this->maxDRv_);
+
+        std::vector<Scalar> thpres;
+        buffer.read(thpres);
+        if (!thpres.empty())
+            setThresholdPressuresFromRestart(thpres);
+
+        std::size_t driftSize = 0;
+        buffer.read(driftSize);
+        drift_.resize(driftSize);
+        for (auto& dofDrift : drift_)
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                buffer.read(dofDrift[eqIdx]);
+
+        bool hysteresis = false;
+        buffer.read(hysteresis);
+        if (hysteresis != materialLawManager_->enableHysteresis())
+            throw std::runtime_error("The checkpoint does not match the hysteresis setting of the deck");
+
+        if (hysteresis) {
+            const unsigned numDof = this->model().numGridDof();
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+                Scalar values[4];
+                buffer.read(values);
+                materialLawManager_->setOilWaterHysteresisParams(values[0], values[1], dofIdx);
+                materialLawManager_->setGasOilHysteresisParams(values[2], values[3], dofIdx);
+            }
+        }
+
+        tracerModel_.readCheckpoint(buffer);
+    }
+
     int episodeIndex() const
     {
         return std::max(this->simulator().episodeIndex(), 0);
@@ -1051,23 +1206,20 @@ public:
                              this->simulator().timeStepSize(),
                              this->simulator().endTime());
 
-        // update maximum water saturation and minimum pressure
-        // used when ROCKCOMP is activated
-        const bool invalidateFromMaxWaterSat = updateMaxWaterSaturation_();
-        const bool invalidateFromMinPressure = updateMinPressure_();
-
-        // update hysteresis and max oil saturation used in vappars
-        const bool invalidateFromHyst = updateHysteresis_();
-        const bool invalidateFromMaxOilSat = updateMaxOilSaturation_();
+        // update maximum water saturation and minimum pressure used when ROCKCOMP is
+        // activated, the hysteresis and the max oil saturation used in vappars
+        const bool invalidateIntensiveQuantities = updateCellHistory_();
 
         // the derivatives may have change
-        bool invalidateIntensiveQuantities = invalidateFromMaxWaterSat || invalidateFromMinPressure || invalidateFromHyst || invalidateFromMaxOilSat;
         if (invalidateIntensiveQuantities)
             this->model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
 
         if constexpr (getPropValue<TypeTag, Properties::EnablePolymer>())
             updateMaxPolymerAdsorption_();
 
+        // the transmissibilities and threshold pressures may have changed
+        this->invalidateFluxReuse();
+
         wellModel_.beginTimeStep();
         if (enableAquifers_)
             aquiferModel_.beginTimeStep();
@@ -1080,6 +1232,7 @@ public:
      */
     void beginIteration()
     {
+        this->updateFluxReuse(this->model().solution(/*timeIdx=*/0));
         wellModel_.beginIteration();
         if (enableAquifers_)
             aquiferModel_.beginIteration();
@@ -1124,6 +1277,9 @@ public:
         // deal with DRSDT and DRVDT
         updateCompositionChangeLimits_();
 
+        // choose the cells which are explicit in the saturations in the next time step
+        this->updateAdaptiveImplicit(this->model(), simulator.timeStepSize());
+
         if (enableDriftCompensation_) {
             const auto& residual = this->model().linearizer().residual();
             for (unsigned globalDofIdx = 0; globalDofIdx < residual.size(); globalDofIdx ++) {
@@ -1250,8 +1406,16 @@ public:
         if (actions.empty())
             return;
 
-        Action::Context context( summaryState, schedule[reportStep].wlist_manager() );
+        // Most actions are not pending at most time steps, since they have
+        // run their maximum number of times or wait for their minimum interval.
         auto now = TimeStampUTC( schedule.getStartTime() ) + std::chrono::duration<double>(sim_time);
+        auto simTime = asTimeT(now);
+        const auto pending = actions.pending(actionState, simTime);
+        const auto& pending_python = actions.pending_python();
+        if (pending.empty() && pending_python.empty())
+            return;
+
+        Action::Context context( summaryState, schedule[reportStep].wlist_manager() );
         std::string ts;
         {
             std::ostringstream os;
@@ -1262,13 +1426,12 @@ public:
             ts = os.str();
         }
 
-        for (const auto& pyaction : actions.pending_python()) {
+        for (const auto& pyaction : pending_python) {
             pyaction->run(ecl_state, schedule, reportStep, summaryState);
         }
 
         bool commit_wellstate = false;
-        auto simTime = asTimeT(now);
-        for (const auto& action : actions.pending(actionState, simTime)) {
+        for (const auto& action : pending) {
             auto actionResult = action->eval(context);
             if (actionResult) {
                 std::string wells_string;
@@ -1403,12 +1566,51 @@ public:
     const typename Vanguard::TransmissibilityType& eclTransmissibilities() const
     { return transmissibilities_; }
 
+    /*!
+     * \brief Change the permeability and the transmissibility multipliers of some
+     *        elements and update the transmissibilities of their faces.
+     *
+     * See EclTransmissibility::updateElements(), a GEO_MODIFIER event of the schedule
+     * discards the changes.
+     */
+    void updateElementTransmissibilities(const std::vector<unsigned>& elems,
+                                         const std::vector<DimMatrix>& perms,
+                                         const std::vector<typename Vanguard::TransmissibilityType::DimVector>& mults)
+    {
+        transmissibilities_.updateElements(elems, perms, mults);
+        updatePffDofData_();
+    }
+
     /*!
      * \copydoc BlackOilBaseProblem::thresholdPressure
      */
     Scalar thresholdPressure(unsigned elem1Idx, unsigned elem2Idx) const
     { return thresholdPressures_.thresholdPressure(elem1Idx, elem2Idx); }
 
+    /*!
+     * \brief Return the threshold pressure of a face of the current stencil.
+     *
+     * The values are precomputed per face along with the transmissibilities, this is
+     * what the flux module uses.
+     */
+    template <class Context>
+    Scalar thresholdPressure(const Context& context,
+                             [[maybe_unused]] unsigned fromDofLocalIdx,
+                             unsigned toDofLocalIdx) const
+    {
+        assert(fromDofLocalIdx == 0);
+        return pffDofData_.get(context.element(), toDofLocalIdx).thresholdPressure;
+    }
+
+    /*!
+     * \brief Set the threshold pressures from a restart file.
+     */
+    void setThresholdPressuresFromRestart(const std::vector<Scalar>& values)
+    {
+        thresholdPressures_.setFromRestart(values);
+        updatePffDofData_();
+    }
+
     const EclThresholdPressure<TypeTag>& thresholdPressure() const
     { return thresholdPressures_; }
 
@@ -1418,6 +1620,17 @@ public:
     const EclTracerModel<TypeTag>& tracerModel() const
     { return tracerModel_; }
 
+    /*!
+     * \brief The per cell counters of the convergence problems, which are
+     *        written to the restart and VTK files once a simulator enabled
+     *        them.
+     */
+    const ConvergenceHotspots& convergenceHotspots() const
+    { return convergenceHotspots_; }
+
+    ConvergenceHotspots& convergenceHotspots()
+    { return convergenceHotspots_; }
+
     /*!
      * \copydoc FvBaseMultiPhaseProblem::porosity
      *
@@ -1801,12 +2014,16 @@ public:
         // initialize the wells. Note that this needs to be done after initializing the
         // intrinsic permeabilities and the after applying the initial solution because
         // the well model uses these...
-        wellModel_.init();
+        {
+            StartupProfile::Phase profilePhase("well setup");
+            wellModel_.init();
+        }
 
         // let the object for threshold pressures initialize itself. this is done only at
         // this point, because determining the threshold pressures may require to access
         // the initial solution.
         thresholdPressures_.finishInit();
+        updatePffDofData_();
 
         updateCompositionChangeLimits_();
 
@@ -1895,6 +2112,20 @@ public:
     const EclipseIO& eclIO() const
     { return eclWriter_->eclIO(); }
 
+    /*!
+     * \brief Number of ECL output requests which were still pending when
+     *        the last one was queued.
+     */
+    std::size_t eclOutputQueueDepth() const
+    { return eclWriter_->outputQueueDepth(); }
+
+    /*!
+     * \brief The bytes of the data for collecting the ECL output on the I/O
+     *        rank.
+     */
+    std::size_t eclOutputMemoryUsage() const
+    { return eclWriter_ ? eclWriter_->collectMemoryUsage() : 0; }
+
     bool nonTrivialBoundaryConditions() const
     { return nonTrivialBoundaryConditions_; }
 
@@ -1953,7 +2184,7 @@ public:
 
 
         if (!this->rockCompPoroMult_.empty()) {
-            return this->rockCompPoroMult_[tableIdx].eval(effectiveOilPressure, /*extrapolation=*/true);
+            return this->rockCompPoroMult_[tableIdx].eval(effectiveOilPressure, /*extrapolate=*/true);
         }
 
         // water compaction
@@ -1992,7 +2223,7 @@ public:
             effectiveOilPressure -= this->overburdenPressure_[elementIdx];
 
         if (!this->rockCompTransMult_.empty())
-            return this->rockCompTransMult_[tableIdx].eval(effectiveOilPressure, /*extrapolation=*/true);
+            return this->rockCompTransMult_[tableIdx].eval(effectiveOilPressure, /*extrapolate=*/true);
 
         // water compaction
         assert(!this->rockCompTransMultWc_.empty());
@@ -2003,6 +2234,46 @@ public:
     }
 
 private:
+    // Call func(elemCtx) for all elements of the grid view, distributing the
+    // elements over the threads of the thread manager. The element context
+    // passed to the functor has its primary stencil and intensive quantities
+    // updated. The functor must only write data belonging to the element
+    // which it is called for.
+    template <class Func>
+    void threadedElementLoop_(Func&& func) const
+    {
+        const auto& simulator = this->simulator();
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(simulator.vanguard().gridView());
+        std::exception_ptr exc;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator);
+            auto elemIt = threadedElemIt.beginParallel();
+            try {
+                for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                    const Element& elem = *elemIt;
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    func(static_cast<const ElementContext&>(elemCtx));
+                }
+            }
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                exc = std::current_exception();
+                // let this thread stop picking up elements, the others will
+                // finish their current element and run out of work as well
+                while (!threadedElemIt.isFinished(elemIt))
+                    elemIt = threadedElemIt.increment();
+            }
+        }
+        if (exc)
+            std::rethrow_exception(exc);
+    }
+
     // update the parameters needed for DRSDT and DRVDT
     void updateCompositionChangeLimits_()
     {
@@ -2016,14 +2287,8 @@ private:
             // Sandve et al. "Convective dissolution in field scale CO2 storage simulations using the OPM Flow simulator"
             // Submitted to TCCS 11, 2021
             Scalar g = this->gravity_[dim - 1];
-            ElementContext elemCtx(simulator);
             const auto& vanguard = simulator.vanguard();
-            auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-            const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const Element& elem = *elemIt;
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+            this->threadedElementLoop_([&](const ElementContext& elemCtx) {
                 unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
                 const DimMatrix& perm = intrinsicPermeability(compressedDofIdx);
                 const Scalar permz = perm[dim - 1][dim - 1]; // The Z permeability
@@ -2045,20 +2310,12 @@ private:
                 // Also we restrict the effect of convective mixing to positive density differences
                 // i.e. we only allow for fingers moving downward
                 this->convectiveDrs_[compressedDofIdx] = permz * rssat * max(0.0, deltaDensity) * g / ( so * visc * distZ * poro);
-            }
+            });
         }
 
         if (this->drsdtActive_(episodeIdx)) {
-            ElementContext elemCtx(simulator);
-            const auto& vanguard = simulator.vanguard();
-            auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-            const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const Element& elem = *elemIt;
-
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
+            const auto& oilVaporizationControl = simulator.vanguard().schedule()[episodeIdx].oilvap();
+            this->threadedElementLoop_([&](const ElementContext& elemCtx) {
                 unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
                 const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
                 const auto& fs = iq.fluidState();
@@ -2066,7 +2323,6 @@ private:
                 using FluidState = typename std::decay<decltype(fs)>::type;
 
                 int pvtRegionIdx = this->pvtRegionIndex(compressedDofIdx);
-                const auto& oilVaporizationControl = simulator.vanguard().schedule()[episodeIdx].oilvap();
                 if (oilVaporizationControl.getOption(pvtRegionIdx) || fs.saturation(gasPhaseIdx) > freeGasMinSaturation_)
                     this->lastRs_[compressedDofIdx] =
                         BlackOil::template getRs_<FluidSystem,
@@ -2074,22 +2330,13 @@ private:
                                                  Scalar>(fs, iq.pvtRegionIndex());
                 else
                     this->lastRs_[compressedDofIdx] = std::numeric_limits<Scalar>::infinity();
-            }
+            });
         }
 
         // update the "last Rv" values for all elements, including the ones in the ghost
         // and overlap regions
         if (this->drvdtActive_(episodeIdx)) {
-            ElementContext elemCtx(simulator);
-            const auto& vanguard = simulator.vanguard();
-            auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-            const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const Element& elem = *elemIt;
-
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
+            this->threadedElementLoop_([&](const ElementContext& elemCtx) {
                 unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
                 const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
                 const auto& fs = iq.fluidState();
@@ -2100,98 +2347,132 @@ private:
                     BlackOil::template getRv_<FluidSystem,
                                               FluidState,
                                               Scalar>(fs, iq.pvtRegionIndex());
-            }
+            });
         }
     }
 
-    bool updateMaxOilSaturation_()
+    // update the per cell state which depends on the history of the solution: the
+    // maximum oil saturation for VAPPARS, the maximum water saturation and the minimum
+    // pressure for ROCKCOMP and the hysteresis parameters. This is done in a single pass
+    // over the grid, such that the intensive quantities are only visited once.
+    // returns true if the intensive quantities must be recomputed, i.e. if the state of
+    // any cell changed
+    bool updateCellHistory_()
     {
-        const auto& simulator = this->simulator();
-        int episodeIdx = this->episodeIndex();
+        const bool updateMaxOilSat = this->vapparsActive(this->episodeIndex());
+        const bool updateMaxWaterSat = !this->maxWaterSaturation_.empty();
+        const bool updateMinPressure = !this->minOilPressure_.empty();
+        const bool updateHysteresis = !hysteresisCells_.empty();
+        if (!updateMaxOilSat && !updateMaxWaterSat && !updateMinPressure && !updateHysteresis)
+            return false;
 
-        // we use VAPPARS
-        if (this->vapparsActive(episodeIdx)) {
-            ElementContext elemCtx(simulator);
-            const auto& vanguard = simulator.vanguard();
-            auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-            const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const Element& elem = *elemIt;
+        if (updateMaxWaterSat)
+            this->maxWaterSaturation_[/*timeIdx=*/1] = this->maxWaterSaturation_[/*timeIdx=*/0];
 
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+        std::atomic<bool> changed{false};
+        if (!updateMaxOilSat && !updateMaxWaterSat && !updateMinPressure) {
+            // only the hysteresis: visit the cells which have it, using the cached
+            // intensive quantities if they are available
+            if (updateHysteresisCells_(changed))
+                return changed;
+        }
 
-                unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& fs = iq.fluidState();
+        // we need to update the hysteresis data for _all_ elements (i.e., not just the
+        // interior ones) to avoid desynchronization of the processes in the parallel case!
+        this->threadedElementLoop_([&](const ElementContext& elemCtx) {
+            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+            const auto& fs = iq.fluidState();
 
+            if (updateMaxOilSat) {
                 Scalar So = decay<Scalar>(fs.saturation(oilPhaseIdx));
-
-                this->maxOilSaturation_[compressedDofIdx] = std::max(this->maxOilSaturation_[compressedDofIdx], So);
+                if (So > this->maxOilSaturation_[compressedDofIdx]) {
+                    this->maxOilSaturation_[compressedDofIdx] = So;
+                    changed.store(true, std::memory_order_relaxed);
+                }
             }
+            if (updateMaxWaterSat) {
+                Scalar Sw = decay<Scalar>(fs.saturation(waterPhaseIdx));
+                if (Sw > this->maxWaterSaturation_[compressedDofIdx]) {
+                    this->maxWaterSaturation_[compressedDofIdx] = Sw;
+                    changed.store(true, std::memory_order_relaxed);
+                }
+            }
+            if (updateMinPressure) {
+                Scalar po = getValue(fs.pressure(oilPhaseIdx));
+                if (po < this->minOilPressure_[compressedDofIdx]) {
+                    this->minOilPressure_[compressedDofIdx] = po;
+                    changed.store(true, std::memory_order_relaxed);
+                }
+            }
+            if (updateHysteresis && hysteresisActive_[compressedDofIdx])
+                updateHysteresis_(fs, compressedDofIdx, changed);
+        });
 
-            // we need to invalidate the intensive quantities cache here because the
-            // derivatives of Rs and Rv will most likely have changed
-            return true;
-        }
-
-        return false;
+        return changed;
     }
 
-    bool updateMaxWaterSaturation_()
+    // update the hysteresis parameters of one cell, set changed if they differ
+    template <class FluidState>
+    void updateHysteresis_(const FluidState& fs, unsigned compressedDofIdx, std::atomic<bool>& changed)
     {
-        // water compaction is activated in ROCKCOMP
-        if (this->maxWaterSaturation_.empty())
-            return false;
-
-        this->maxWaterSaturation_[/*timeIdx=*/1] = this->maxWaterSaturation_[/*timeIdx=*/0];
-        ElementContext elemCtx(this->simulator());
-        const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& fs = iq.fluidState();
+        Scalar before[4];
+        materialLawManager_->oilWaterHysteresisParams(before[0], before[1], compressedDofIdx);
+        materialLawManager_->gasOilHysteresisParams(before[2], before[3], compressedDofIdx);
+        materialLawManager_->updateHysteresis(fs, compressedDofIdx);
+        Scalar after[4];
+        materialLawManager_->oilWaterHysteresisParams(after[0], after[1], compressedDofIdx);
+        materialLawManager_->gasOilHysteresisParams(after[2], after[3], compressedDofIdx);
+        if (!std::equal(before, before + 4, after))
+            changed.store(true, std::memory_order_relaxed);
+    }
 
-            Scalar Sw = decay<Scalar>(fs.saturation(waterPhaseIdx));
-            this->maxWaterSaturation_[compressedDofIdx] = std::max(this->maxWaterSaturation_[compressedDofIdx], Sw);
+    // update the hysteresis parameters of the cells which have hysteresis from the
+    // cached intensive quantities. returns false if these are not available
+    bool updateHysteresisCells_(std::atomic<bool>& changed)
+    {
+        const auto& model = this->model();
+        for (const auto cellIdx : hysteresisCells_) {
+            if (!model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0))
+                return false;
         }
 
+        const int numCells = hysteresisCells_.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < numCells; ++i) {
+            const unsigned cellIdx = hysteresisCells_[i];
+            const auto* iq = model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0);
+            updateHysteresis_(iq->fluidState(), cellIdx, changed);
+        }
         return true;
     }
 
-    bool updateMinPressure_()
+    // the cells whose hysteresis state must be tracked: the ones whose imbibition
+    // saturation functions differ from the drainage ones. If IMBNUM is not given, all
+    // cells are tracked.
+    void initHysteresisCells_()
     {
-        // IRREVERS option is used in ROCKCOMP
-        if (this->minOilPressure_.empty())
-            return false;
-
-        ElementContext elemCtx(this->simulator());
-        const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& fs = iq.fluidState();
+        hysteresisCells_.clear();
+        hysteresisActive_.clear();
+        if (!materialLawManager_->enableHysteresis())
+            return;
 
-            this->minOilPressure_[compressedDofIdx] =
-                std::min(this->minOilPressure_[compressedDofIdx],
-                         getValue(fs.pressure(oilPhaseIdx)));
+        const auto& fieldProps = this->simulator().vanguard().eclState().fieldProps();
+        const bool compareImbnum = fieldProps.has_int("IMBNUM") && fieldProps.has_int("SATNUM");
+        const unsigned numDof = this->model().numGridDof();
+        hysteresisActive_.assign(numDof, !compareImbnum);
+        if (compareImbnum) {
+            const auto& imbnum = fieldProps.get_int("IMBNUM");
+            const auto& satnum = fieldProps.get_int("SATNUM");
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx)
+                hysteresisActive_[dofIdx] = imbnum[dofIdx] != satnum[dofIdx];
+        }
+        for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+            if (hysteresisActive_[dofIdx])
+                hysteresisCells_.push_back(dofIdx);
         }
-
-        return true;
     }
 
     void readMaterialParameters_()
@@ -2296,6 +2577,7 @@ private:
 
     void readEquilInitialCondition_()
     {
+        StartupProfile::Phase profilePhase("equilibration");
         const auto& simulator = this->simulator();
 
         // initial condition corresponds to hydrostatic conditions.
@@ -2596,32 +2878,6 @@ private:
         }
     }
 
-    // update the hysteresis parameters of the material laws for the whole grid
-    bool updateHysteresis_()
-    {
-        if (!materialLawManager_->enableHysteresis())
-            return false;
-
-        // we need to update the hysteresis data for _all_ elements (i.e., not just the
-        // interior ones) to avoid desynchronization of the processes in the parallel case!
-        const auto& simulator = this->simulator();
-        ElementContext elemCtx(simulator);
-        const auto& vanguard = simulator.vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            materialLawManager_->updateHysteresis(intQuants.fluidState(), compressedDofIdx);
-        }
-        return true;
-    }
-
     void updateMaxPolymerAdsorption_()
     {
         // we need to update the max polymer adsoption data for all elements
@@ -2650,6 +2906,7 @@ private:
         ConditionalStorage<enableEnergy, Scalar> thermalHalfTransOut;
         ConditionalStorage<enableDiffusion, Scalar> diffusivity;
         Scalar transmissibility;
+        Scalar thresholdPressure;
     };
 
     // update the prefetch friendly data object
@@ -2665,15 +2922,22 @@ private:
 
             unsigned globalElemIdx = elementMapper.index(stencil.entity(localDofIdx));
             if (localDofIdx != 0) {
+                // the values are read from the neighbor slots of the center element,
+                // which are stored in the order of the Jacobian row
                 unsigned globalCenterElemIdx = elementMapper.index(stencil.entity(/*dofIdx=*/0));
-                dofData.transmissibility = transmissibilities_.transmissibility(globalCenterElemIdx, globalElemIdx);
+                const int slotIdx = transmissibilities_.neighborSlot(globalCenterElemIdx, globalElemIdx);
+                if (slotIdx < 0)
+                    throw std::logic_error("No transmissibility between the elements of a stencil");
+
+                dofData.transmissibility = transmissibilities_.slotTransmissibility(slotIdx);
+                dofData.thresholdPressure = thresholdPressures_.thresholdPressure(globalCenterElemIdx, globalElemIdx);
 
                 if constexpr (enableEnergy) {
-                    *dofData.thermalHalfTransIn = transmissibilities_.thermalHalfTrans(globalCenterElemIdx, globalElemIdx);
+                    *dofData.thermalHalfTransIn = transmissibilities_.slotThermalHalfTrans(slotIdx);
                     *dofData.thermalHalfTransOut = transmissibilities_.thermalHalfTrans(globalElemIdx, globalCenterElemIdx);
                 }
                 if constexpr (enableDiffusion)
-                    *dofData.diffusivity = transmissibilities_.diffusivity(globalCenterElemIdx, globalElemIdx);
+                    *dofData.diffusivity = transmissibilities_.slotDiffusivity(slotIdx);
             }
         };
 
@@ -2867,6 +3131,10 @@ private:
     std::shared_ptr<EclMaterialLawManager> materialLawManager_;
     std::shared_ptr<EclThermalLawManager> thermalLawManager_;
 
+    // the cells whose hysteresis state is tracked, as a list and as a flag per cell
+    std::vector<unsigned> hysteresisCells_;
+    std::vector<char> hysteresisActive_;
+
     EclThresholdPressure<TypeTag> thresholdPressures_;
 
     std::vector<InitialFluidState> initialFluidStates_;
@@ -2885,6 +3153,7 @@ private:
 
     PffGridVector<GridView, Stencil, PffDofData_, DofMapper> pffDofData_;
     TracerModel tracerModel_;
+    ConvergenceHotspots convergenceHotspots_;
 
     std::vector<bool> freebcX_;
     std::vector<bool> freebcXMinus_;
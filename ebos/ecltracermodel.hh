@@ -33,6 +33,7 @@
 #include <opm/models/utils/propertysystem.hh>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Opm::Properties {
@@ -42,6 +43,11 @@ struct EnableTracerModel {
     using type = UndefinedProperty;
 };
 
+template<class TypeTag, class MyTypeTag>
+struct EnableTracerUpwindSolver {
+    using type = UndefinedProperty;
+};
+
 } // namespace Opm::Properties
 
 namespace Opm {
@@ -99,6 +105,7 @@ public:
     void init()
     {
         bool enabled = EWOMS_GET_PARAM(TypeTag, bool, EnableTracerModel);
+        this->useUpwindSolver_ = EWOMS_GET_PARAM(TypeTag, bool, EnableTracerUpwindSolver);
         this->doInit(enabled, simulator_.model().numGridDof(),
                      gasPhaseIdx, oilPhaseIdx, waterPhaseIdx);
     }
@@ -133,17 +140,30 @@ public:
         if (this->numTracers()==0)
             return;
 
-        for (int tracerIdx = 0; tracerIdx < this->numTracers(); ++ tracerIdx){
+        // the Jacobian only depends on the phase of a tracer, not on its
+        // concentration. hence all tracers of a phase share one assembly of the
+        // matrix and one preconditioner, and only the residuals differ.
+        for (int phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            std::vector<int> tracerIndices;
+            for (int tracerIdx = 0; tracerIdx < this->numTracers(); ++ tracerIdx)
+                if (this->tracerPhaseIdx_[tracerIdx] == phaseIdx)
+                    tracerIndices.push_back(tracerIdx);
 
-            typename BaseType::TracerVector dx(this->tracerResidual_.size());
             // Newton step (currently the system is linear, converge in one iteration)
-            for (int iter = 0; iter < 5; ++ iter){
-                linearize_(tracerIdx);
-                this->linearSolve_(*this->tracerMatrix_, dx, this->tracerResidual_);
-                this->tracerConcentration_[tracerIdx] -= dx;
-
-                if (dx.two_norm()<1e-2)
-                    break;
+            for (int iter = 0; iter < 5 && !tracerIndices.empty(); ++ iter){
+                const std::size_t numActive = tracerIndices.size();
+                std::vector<typename BaseType::TracerVector> dx(numActive, this->tracerResidual_);
+                std::vector<typename BaseType::TracerVector> residuals(numActive, this->tracerResidual_);
+                linearize_(tracerIndices, residuals);
+                this->linearSolveBatch_(*this->tracerMatrix_, dx, residuals);
+
+                std::vector<int> notConverged;
+                for (std::size_t i = 0; i < numActive; ++i) {
+                    this->tracerConcentration_[tracerIndices[i]] -= dx[i];
+                    if (dx[i].two_norm() >= 1e-2)
+                        notConverged.push_back(tracerIndices[i]);
+                }
+                tracerIndices = std::move(notConverged);
             }
         }
     }
@@ -229,10 +249,13 @@ protected:
 
     }
 
-    void linearize_(int tracerIdx)
+    // assemble the matrix and the residuals of tracers which are all in the same phase
+    void linearize_(const std::vector<int>& tracerIndices,
+                    std::vector<typename BaseType::TracerVector>& residuals)
     {
         (*this->tracerMatrix_) = 0.0;
-        this->tracerResidual_ = 0.0;
+        for (auto& residual : residuals)
+            residual = 0.0;
 
         size_t numGridDof =  simulator_.model().numGridDof();
         std::vector<double> volumes(numGridDof, 0.0);
@@ -254,41 +277,49 @@ protected:
 
             size_t I = elemCtx.globalSpaceIndex(/*dofIdx=*/ 0, /*timIdx=*/0);
             volumes[I] = scvVolume;
-            TracerEvaluation localStorage;
-            TracerEvaluation storageOfTimeIndex0;
-            Scalar storageOfTimeIndex1;
-            computeStorage_(storageOfTimeIndex0, elemCtx, 0, /*timIdx=*/0, tracerIdx);
-            if (elemCtx.enableStorageCache())
-                storageOfTimeIndex1 = this->storageOfTimeIndex1_[tracerIdx][I];
-            else
-                computeStorage_(storageOfTimeIndex1, elemCtx, 0, /*timIdx=*/1, tracerIdx);
-
-            localStorage = (storageOfTimeIndex0 - storageOfTimeIndex1) * scvVolume/dt;
-            this->tracerResidual_[I][0] += localStorage.value(); //residual + flux
-            (*this->tracerMatrix_)[I][I][0][0] = localStorage.derivative(0);
             size_t numInteriorFaces = elemCtx.numInteriorFaces(/*timIdx=*/0);
-            for (unsigned scvfIdx = 0; scvfIdx < numInteriorFaces; scvfIdx++) {
-                TracerEvaluation flux;
-                const auto& face = elemCtx.stencil(0).interiorFace(scvfIdx);
-                unsigned j = face.exteriorIndex();
-                unsigned J = elemCtx.globalSpaceIndex(/*dofIdx=*/ j, /*timIdx=*/0);
-                computeFlux_(flux, elemCtx, scvfIdx, 0, tracerIdx);
-                this->tracerResidual_[I][0] += flux.value(); //residual + flux
-                (*this->tracerMatrix_)[J][I][0][0] = -flux.derivative(0);
-                (*this->tracerMatrix_)[I][J][0][0] = flux.derivative(0);
+            for (std::size_t i = 0; i < tracerIndices.size(); ++i) {
+                const int tracerIdx = tracerIndices[i];
+                TracerEvaluation localStorage;
+                TracerEvaluation storageOfTimeIndex0;
+                Scalar storageOfTimeIndex1;
+                computeStorage_(storageOfTimeIndex0, elemCtx, 0, /*timIdx=*/0, tracerIdx);
+                if (elemCtx.enableStorageCache())
+                    storageOfTimeIndex1 = this->storageOfTimeIndex1_[tracerIdx][I];
+                else
+                    computeStorage_(storageOfTimeIndex1, elemCtx, 0, /*timIdx=*/1, tracerIdx);
+
+                localStorage = (storageOfTimeIndex0 - storageOfTimeIndex1) * scvVolume/dt;
+                residuals[i][I][0] += localStorage.value(); //residual + flux
+                if (i == 0)
+                    (*this->tracerMatrix_)[I][I][0][0] = localStorage.derivative(0);
+                for (unsigned scvfIdx = 0; scvfIdx < numInteriorFaces; scvfIdx++) {
+                    TracerEvaluation flux;
+                    computeFlux_(flux, elemCtx, scvfIdx, 0, tracerIdx);
+                    residuals[i][I][0] += flux.value(); //residual + flux
+                    if (i == 0) {
+                        const auto& face = elemCtx.stencil(0).interiorFace(scvfIdx);
+                        unsigned j = face.exteriorIndex();
+                        unsigned J = elemCtx.globalSpaceIndex(/*dofIdx=*/ j, /*timIdx=*/0);
+                        (*this->tracerMatrix_)[J][I][0][0] = -flux.derivative(0);
+                        (*this->tracerMatrix_)[I][J][0][0] = flux.derivative(0);
+                    }
+                }
             }
-
         }
 
         // Wells
         const int episodeIdx = simulator_.episodeIndex();
         const auto& wells = simulator_.vanguard().schedule().getWells(episodeIdx);
+        const int tracerPhaseIdx = this->tracerPhaseIdx_[tracerIndices.front()];
+        std::vector<double> wtracer(tracerIndices.size());
         for (const auto& well : wells) {
 
             if (well.getStatus() == Well::Status::SHUT)
                 continue;
 
-            const double wtracer = well.getTracerProperties().getConcentration(this->tracerNames_[tracerIdx]);
+            for (std::size_t i = 0; i < tracerIndices.size(); ++i)
+                wtracer[i] = well.getTracerProperties().getConcentration(this->tracerNames_[tracerIndices[i]]);
             std::array<int, 3> cartesianCoordinate;
             for (auto& connection : well.getConnections()) {
 
@@ -300,11 +331,13 @@ protected:
                 cartesianCoordinate[2] = connection.getK();
                 const size_t cartIdx = simulator_.vanguard().cartesianIndex(cartesianCoordinate);
                 const int I = this->cartToGlobal_[cartIdx];
-                Scalar rate = simulator_.problem().wellModel().well(well.name())->volumetricSurfaceRateForConnection(I, this->tracerPhaseIdx_[tracerIdx]);
-                if (rate > 0)
-                    this->tracerResidual_[I][0] -= rate*wtracer;
-                else if (rate < 0)
-                    this->tracerResidual_[I][0] -= rate*this->tracerConcentration_[tracerIdx][I];
+                Scalar rate = simulator_.problem().wellModel().well(well.name())->volumetricSurfaceRateForConnection(I, tracerPhaseIdx);
+                for (std::size_t i = 0; i < tracerIndices.size(); ++i) {
+                    if (rate > 0)
+                        residuals[i][I][0] -= rate*wtracer[i];
+                    else if (rate < 0)
+                        residuals[i][I][0] -= rate*this->tracerConcentration_[tracerIndices[i]][I];
+                }
             }
         }
     }
@@ -24,6 +24,8 @@
 #include <config.h>
 #include <ebos/ecltransmissibility.hh>
 
+#include <opm/common/OpmLog/OpmLog.hpp>
+
 #include <dune/common/version.hh>
 #include <dune/grid/common/mcmgmapper.hh>
 
@@ -36,6 +38,8 @@
 #include <opm/parser/eclipse/EclipseState/Grid/TransMult.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 
+#include <opm/simulators/utils/StartupProfile.hpp>
+
 #if HAVE_DUNE_FEM
 #include <dune/fem/gridpart/adaptiveleafgridpart.hh>
 #include <dune/fem/gridpart/common/gridpart2gridview.hh>
@@ -47,38 +51,93 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <exception>
 #include <sstream>
 #include <stdexcept>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace {
 
-constexpr unsigned elemIdxShift = 32; // bits
+constexpr char transCacheMagic[8] = {'O', 'P', 'M', 'T', 'R', 'A', 'N', 'S'};
+constexpr std::uint32_t transCacheVersion = 1;
 
-std::uint64_t isId(std::uint32_t elemIdx1, std::uint32_t elemIdx2)
+void hashBytes(std::uint64_t& hash, std::uint64_t value)
 {
-    std::uint32_t elemAIdx = std::min(elemIdx1, elemIdx2);
-    std::uint64_t elemBIdx = std::max(elemIdx1, elemIdx2);
-
-    return (elemBIdx<<elemIdxShift) + elemAIdx;
+    // FNV-1a
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (8*i)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
 }
 
-std::pair<std::uint32_t, std::uint32_t> isIdReverse(const std::uint64_t& id)
+template <class T>
+void writeCacheValue(std::ostream& os, const T& value)
 {
-    // Assigning an unsigned integer to a narrower type discards the most significant bits.
-    // See "The C programming language", section A.6.2.
-    // NOTE that the ordering of element A and B may have changed
-    std::uint32_t elemAIdx = id;
-    std::uint32_t elemBIdx = (id - elemAIdx) >> elemIdxShift;
-
-    return std::make_pair(elemAIdx, elemBIdx);
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
 }
 
-std::uint64_t directionalIsId(std::uint32_t elemIdx1, std::uint32_t elemIdx2)
+template <class T>
+void writeCacheArray(std::ostream& os, const std::vector<T>& values)
 {
-    return (std::uint64_t(elemIdx1)<<elemIdxShift) + elemIdx2;
+    writeCacheValue(os, static_cast<std::uint64_t>(values.size()));
+    os.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T));
 }
 
-}
+// reads the values of a cache file, the sizes of the arrays are checked against
+// the size of the file before anything is allocated
+class CacheReader
+{
+public:
+    explicit CacheReader(const std::string& fileName)
+        : is_(fileName, std::ios::binary)
+    {
+        if (is_) {
+            is_.seekg(0, std::ios::end);
+            remaining_ = is_.tellg();
+            is_.seekg(0, std::ios::beg);
+        }
+    }
+
+    template <class T>
+    bool read(T& value)
+    {
+        return readBytes_(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    bool read(std::vector<T>& values)
+    {
+        std::uint64_t size = 0;
+        if (!read(size) || size > remaining_ / sizeof(T))
+            return false;
+        values.resize(size);
+        return readBytes_(reinterpret_cast<char*>(values.data()), size*sizeof(T));
+    }
+
+    bool atEnd() const
+    { return remaining_ == 0; }
+
+private:
+    bool readBytes_(char* data, std::uint64_t size)
+    {
+        if (!is_ || size > remaining_)
+            return false;
+        is_.read(data, size);
+        remaining_ -= size;
+        return static_cast<bool>(is_);
+    }
+
+    std::ifstream is_;
+    std::uint64_t remaining_ = 0;
+};
+
+} // anonymous namespace
 
 namespace Opm {
 
@@ -107,7 +166,11 @@ template<class Grid, class GridView, class ElementMapper, class Scalar>
 Scalar EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
 transmissibility(unsigned elemIdx1, unsigned elemIdx2) const
 {
-    return trans_.at(isId(elemIdx1, elemIdx2));
+    const int faceIdx = faceIndex_(elemIdx1, elemIdx2);
+    if (faceIdx < 0)
+        throw std::out_of_range(fmt::format("No face between the elements {} and {}", elemIdx1, elemIdx2));
+
+    return trans_[faceIdx];
 }
 
 template<class Grid, class GridView, class ElementMapper, class Scalar>
@@ -121,7 +184,11 @@ template<class Grid, class GridView, class ElementMapper, class Scalar>
 Scalar EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
 thermalHalfTrans(unsigned insideElemIdx, unsigned outsideElemIdx) const
 {
-    return thermalHalfTrans_.at(directionalIsId(insideElemIdx, outsideElemIdx));
+    const int slotIdx = slotIndex_(insideElemIdx, outsideElemIdx);
+    if (slotIdx < 0 || thermalHalfTrans_.empty())
+        throw std::out_of_range(fmt::format("No face between the elements {} and {}", insideElemIdx, outsideElemIdx));
+
+    return thermalHalfTrans_[slotIdx];
 }
 
 template<class Grid, class GridView, class ElementMapper, class Scalar>
@@ -138,14 +205,125 @@ diffusivity(unsigned elemIdx1, unsigned elemIdx2) const
     if (diffusivity_.empty())
         return 0.0;
 
-    return diffusivity_.at(isId(elemIdx1, elemIdx2));
+    const int faceIdx = faceIndex_(elemIdx1, elemIdx2);
+    if (faceIdx < 0)
+        throw std::out_of_range(fmt::format("No face between the elements {} and {}", elemIdx1, elemIdx2));
+
+    return diffusivity_[faceIdx];
+}
+
+template<class Grid, class GridView, class ElementMapper, class Scalar>
+int EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
+slotIndex_(unsigned elemIdx, unsigned neighborElemIdx) const
+{
+    if (elemIdx + 1 >= neighborOffsets_.size())
+        return -1;
+
+    const auto begin = neighbors_.begin() + neighborOffsets_[elemIdx];
+    const auto end = neighbors_.begin() + neighborOffsets_[elemIdx + 1];
+    const auto it = std::lower_bound(begin, end, neighborElemIdx);
+    if (it == end || *it != neighborElemIdx)
+        return -1;
+
+    return it - neighbors_.begin();
+}
+
+template<class Grid, class GridView, class ElementMapper, class Scalar>
+int EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
+faceIndex_(unsigned elemIdx1, unsigned elemIdx2) const
+{
+    int slotIdx = slotIndex_(elemIdx1, elemIdx2);
+    if (slotIdx < 0)
+        slotIdx = slotIndex_(elemIdx2, elemIdx1);
+    if (slotIdx < 0)
+        return -1;
 
+    return slotFaces_[slotIdx];
+}
+
+template<class Grid, class GridView, class ElementMapper, class Scalar>
+void EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
+updateNeighbors_(const ElementMapper& elemMapper)
+{
+    const unsigned numElements = elemMapper.size();
+
+    // the neighbors of an element, sorted like the columns of its row in the
+    // Jacobian. an element which is connected by several intersections gets a
+    // single slot.
+    std::vector<unsigned> elemNeighbors;
+    const auto& collectNeighbors = [&](const Element& elem)
+    {
+        elemNeighbors.clear();
+        auto isIt = gridView_.ibegin(elem);
+        const auto& isEndIt = gridView_.iend(elem);
+        for (; isIt != isEndIt; ++ isIt) {
+            const auto& intersection = *isIt;
+            if (!intersection.neighbor())
+                continue;
+
+            unsigned outsideElemIdx = elemMapper.index(intersection.outside());
+            elemNeighbors.push_back(outsideElemIdx);
+        }
+        std::sort(elemNeighbors.begin(), elemNeighbors.end());
+        elemNeighbors.erase(std::unique(elemNeighbors.begin(), elemNeighbors.end()), elemNeighbors.end());
+    };
+
+    neighborOffsets_.assign(numElements + 1, 0);
+    auto elemIt = gridView_.template begin</*codim=*/ 0>();
+    const auto& elemEndIt = gridView_.template end</*codim=*/ 0>();
+    for (; elemIt != elemEndIt; ++elemIt) {
+        collectNeighbors(*elemIt);
+        neighborOffsets_[elemMapper.index(*elemIt) + 1] = elemNeighbors.size();
+    }
+    for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx)
+        neighborOffsets_[elemIdx + 1] += neighborOffsets_[elemIdx];
+
+    neighbors_.resize(neighborOffsets_[numElements]);
+    for (elemIt = gridView_.template begin</*codim=*/ 0>(); elemIt != elemEndIt; ++elemIt) {
+        collectNeighbors(*elemIt);
+        std::copy(elemNeighbors.begin(), elemNeighbors.end(),
+                  neighbors_.begin() + neighborOffsets_[elemMapper.index(*elemIt)]);
+    }
+
+    // number the faces. a face belongs to the element with the lower Cartesian
+    // index, the slot of the other element refers to the same face.
+    constexpr unsigned noFace = std::numeric_limits<unsigned>::max();
+    slotFaces_.assign(neighbors_.size(), noFace);
+    faceElements_.clear();
+    faceElements_.reserve(neighbors_.size() / 2);
+    for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+        for (unsigned slotIdx = neighborOffsets_[elemIdx]; slotIdx < neighborOffsets_[elemIdx + 1]; ++slotIdx) {
+            const unsigned neighborElemIdx = neighbors_[slotIdx];
+            if (cartMapper_.cartesianIndex(elemIdx) < cartMapper_.cartesianIndex(neighborElemIdx)) {
+                slotFaces_[slotIdx] = faceElements_.size();
+                faceElements_.emplace_back(elemIdx, neighborElemIdx);
+            }
+        }
+    }
+    for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+        for (unsigned slotIdx = neighborOffsets_[elemIdx]; slotIdx < neighborOffsets_[elemIdx + 1]; ++slotIdx) {
+            if (slotFaces_[slotIdx] != noFace)
+                continue;
+
+            const unsigned neighborElemIdx = neighbors_[slotIdx];
+            const int ownerSlotIdx = slotIndex_(neighborElemIdx, elemIdx);
+            if (ownerSlotIdx >= 0 && slotFaces_[ownerSlotIdx] != noFace)
+                slotFaces_[slotIdx] = slotFaces_[ownerSlotIdx];
+            else {
+                // the connection is only seen from this side
+                slotFaces_[slotIdx] = faceElements_.size();
+                faceElements_.emplace_back(elemIdx, neighborElemIdx);
+            }
+        }
+    }
 }
 
 template<class Grid, class GridView, class ElementMapper, class Scalar>
 void EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
 update(bool global)
 {
+    StartupProfile::Phase profilePhase("transmissibilities");
+
     const auto& cartDims = cartMapper_.cartesianDimensions();
     auto& transMult = eclState_.getTransMult();
     const auto& comm = gridView_.comm();
@@ -164,12 +342,17 @@ update(bool global)
     for (unsigned dimIdx = 0; dimIdx < dimWorld; ++dimIdx)
         axisCentroids[dimIdx].resize(numElements);
 
+    // the elements are collected for the threaded loop over the faces below
+    std::vector<Element> elements;
+    elements.reserve(numElements);
+
     auto elemIt = gridView_.template begin</*codim=*/ 0>();
     const auto& elemEndIt = gridView_.template end</*codim=*/ 0>();
     size_t centroidIdx = 0;
     for (; elemIt != elemEndIt; ++elemIt, ++centroidIdx) {
         const auto& elem = *elemIt;
         unsigned elemIdx = elemMapper.index(elem);
+        elements.push_back(elem);
 
         // compute the axis specific "centroids" used for the transmissibilities. for
         // consistency with the flow simulator, we use the element centers as
@@ -189,27 +372,30 @@ update(bool global)
                 axisCentroids[axisIdx][elemIdx][dimIdx] = centroid[dimIdx];
     }
 
-    // reserving some space in the hashmap upfront saves quite a bit of time because
-    // resizes are costly for hashmaps and there would be quite a few of them if we
-    // would not have a rough idea of how large the final map will be (the rough idea
-    // is a conforming Cartesian grid).
-    trans_.clear();
-    trans_.reserve(numElements*3*1.05);
+    // set up the neighbor slots of the elements and the numbering of the faces. the
+    // values are then stored in flat arrays, so that the faces can be computed
+    // concurrently without any synchronization.
+    updateNeighbors_(elemMapper);
 
+    const std::size_t numFaces = faceElements_.size();
+    trans_.assign(numFaces, 0.0);
     transBoundary_.clear();
+    faceGeometry_.assign(numFaces, FaceGeometry{});
+    elementMult_.clear();
+
+    DimMatrix unitPerm(0.0);
+    for (unsigned dimIdx = 0; dimIdx < dimWorld; ++dimIdx)
+        unitPerm[dimIdx][dimIdx] = 1.0;
 
     // if energy is enabled, let's do the same for the "thermal half transmissibilities"
     if (enableEnergy_) {
-        thermalHalfTrans_.clear();
-        thermalHalfTrans_.reserve(numElements*6*1.05);
-
+        thermalHalfTrans_.assign(neighbors_.size(), 0.0);
         thermalHalfTransBoundary_.clear();
     }
 
     // if diffusion is enabled, let's do the same for the "diffusivity"
     if (updateDiffusivity) {
-        diffusivity_.clear();
-        diffusivity_.reserve(numElements*3*1.05);
+        diffusivity_.assign(numFaces, 0.0);
         extractPorosity_();
     }
 
@@ -225,10 +411,20 @@ update(bool global)
         comm.broadcast(&useSmallestMultiplier, 1, 0);
     }
 
-    // compute the transmissibilities for all intersections
-    elemIt = gridView_.template begin</*codim=*/ 0>();
-    for (; elemIt != elemEndIt; ++elemIt) {
-        const auto& elem = *elemIt;
+    // the values of a face are only written by the thread which handles the inside
+    // element with the lower Cartesian index. the boundary segments go to
+    // per-thread lists which are merged into the maps afterwards.
+    struct BoundarySegment
+    {
+        unsigned elemIdx;
+        unsigned boundaryIsIdx;
+        Scalar trans;
+        Scalar thermalHalfTrans;
+    };
+
+    const auto& computeElementFaces =
+        [&](const Element& elem, std::vector<BoundarySegment>& boundarySegments)
+    {
         unsigned elemIdx = elemMapper.index(elem);
 
         auto isIt = gridView_.ibegin(elem);
@@ -260,12 +456,11 @@ update(bool global)
                 // normally there would be two half-transmissibilities that would be
                 // averaged. on the grid boundary there only is the half
                 // transmissibility of the interior element.
-                transBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] = transBoundaryIs;
 
                 // for boundary intersections we also need to compute the thermal
                 // half transmissibilities
+                Scalar transBoundaryEnergyIs = 0.0;
                 if (enableEnergy_) {
-                    Scalar transBoundaryEnergyIs;
                     computeHalfDiffusivity_(transBoundaryEnergyIs,
                                             faceAreaNormal,
                                             distanceVector_(faceCenterInside,
@@ -273,9 +468,8 @@ update(bool global)
                                                             elemIdx,
                                                             axisCentroids),
                                             1.0);
-                    thermalHalfTransBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] =
-                        transBoundaryEnergyIs;
                 }
+                boundarySegments.push_back({elemIdx, boundaryIsIdx, transBoundaryIs, transBoundaryEnergyIs});
 
                 ++ boundaryIsIdx;
                 continue;
@@ -299,6 +493,8 @@ update(bool global)
             if (insideCartElemIdx > outsideCartElemIdx)
                 continue;
 
+            const unsigned faceIdx = faceIndex_(elemIdx, outsideElemIdx);
+
             // local indices of the faces of the inside and
             // outside elements which contain the intersection
             int insideFaceIdx  = intersection.indexInInside();
@@ -308,7 +504,7 @@ update(bool global)
                 // NNC. Set zero transmissibility, as it will be
                 // *added to* by applyNncToGridTrans_() later.
                 assert(outsideFaceIdx == -1);
-                trans_[isId(elemIdx, outsideElemIdx)] = 0.0;
+                trans_[faceIdx] = 0.0;
                 continue;
             }
 
@@ -361,20 +557,20 @@ update(bool global)
 
             // apply the full face transmissibility multipliers
             // for the inside ...
-
+            Scalar mult = 1.0;
             if (useSmallestMultiplier)
             {
                 // Currently PINCH(4) is never queries and hence  PINCH(4) == TOPBOT is assumed
                 // and in this branch PINCH(5) == ALL holds
-                applyAllZMultipliers_(trans, insideFaceIdx, outsideFaceIdx, insideCartElemIdx,
+                applyAllZMultipliers_(mult, insideFaceIdx, outsideFaceIdx, insideCartElemIdx,
                                       outsideCartElemIdx, transMult, cartDims,
                                       /* pinchTop= */ false);
             }
             else
             {
-                applyMultipliers_(trans, insideFaceIdx, insideCartElemIdx, transMult);
+                applyMultipliers_(mult, insideFaceIdx, insideCartElemIdx, transMult);
                 // ... and outside elements
-                applyMultipliers_(trans, outsideFaceIdx, outsideCartElemIdx, transMult);
+                applyMultipliers_(mult, outsideFaceIdx, outsideCartElemIdx, transMult);
             }
 
             // apply the region multipliers (cf. the MULTREGT keyword)
@@ -399,11 +595,39 @@ update(bool global)
                 throw std::logic_error("Could not determine a face direction");
             }
 
-            trans *= transMult.getRegionMultiplier(insideCartElemIdx,
-                                                   outsideCartElemIdx,
-                                                   faceDir);
+            mult *= transMult.getRegionMultiplier(insideCartElemIdx,
+                                                  outsideCartElemIdx,
+                                                  faceDir);
+            trans *= mult;
 
-            trans_[isId(elemIdx, outsideElemIdx)] = trans;
+            trans_[faceIdx] = trans;
+
+            // keep the parts which do not depend on the permeability
+            auto& geometry = faceGeometry_[faceIdx];
+            const unsigned insideSide = faceElements_[faceIdx].first == elemIdx ? 0 : 1;
+            computeHalfTrans_(geometry.halfTrans[insideSide],
+                              faceAreaNormal,
+                              insideFaceIdx,
+                              distanceVector_(faceCenterInside,
+                                              intersection.indexInInside(),
+                                              elemIdx,
+                                              axisCentroids),
+                              unitPerm);
+            computeHalfTrans_(geometry.halfTrans[1 - insideSide],
+                              faceAreaNormal,
+                              outsideFaceIdx,
+                              distanceVector_(faceCenterOutside,
+                                              intersection.indexInOutside(),
+                                              outsideElemIdx,
+                                              axisCentroids),
+                              unitPerm);
+            applyNtg_(geometry.halfTrans[insideSide], insideFaceIdx, elemIdx, ntg);
+            applyNtg_(geometry.halfTrans[1 - insideSide], outsideFaceIdx, outsideElemIdx, ntg);
+            geometry.mult = mult;
+            geometry.dim[insideSide] = insideFaceIdx / 2;
+            geometry.dim[1 - insideSide] = outsideFaceIdx / 2;
+            geometry.multSide = (insideFaceIdx % 2 == 1) ? insideSide : 1 - insideSide;
+            geometry.fromGrid = true;
 
             // update the "thermal half transmissibility" for the intersection
             if (enableEnergy_) {
@@ -426,8 +650,10 @@ update(bool global)
                                                         axisCentroids),
                                         1.0);
                 //TODO Add support for multipliers
-                thermalHalfTrans_[directionalIsId(elemIdx, outsideElemIdx)] = halfDiffusivity1;
-                thermalHalfTrans_[directionalIsId(outsideElemIdx, elemIdx)] = halfDiffusivity2;
+                thermalHalfTrans_[slotIndex_(elemIdx, outsideElemIdx)] = halfDiffusivity1;
+                const int outsideSlotIdx = slotIndex_(outsideElemIdx, elemIdx);
+                if (outsideSlotIdx >= 0)
+                    thermalHalfTrans_[outsideSlotIdx] = halfDiffusivity2;
            }
 
             // update the "diffusive half transmissibility" for the intersection
@@ -463,10 +689,54 @@ update(bool global)
                     diffusivity = 1.0 / (1.0/halfDiffusivity1 + 1.0/halfDiffusivity2);
 
 
-                diffusivity_[isId(elemIdx, outsideElemIdx)] = diffusivity;
+                diffusivity_[faceIdx] = diffusivity;
            }
         }
+    };
+
+    // compute the transmissibilities for all intersections
+#ifdef _OPENMP
+    const int numThreads = omp_get_max_threads();
+#else
+    const int numThreads = 1;
+#endif
+    std::vector<std::vector<BoundarySegment>> boundarySegments(numThreads);
+    std::exception_ptr exc;
+    const int numLoopElements = elements.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+    for (int i = 0; i < numLoopElements; ++i) {
+#ifdef _OPENMP
+        auto& threadBoundarySegments = boundarySegments[omp_get_thread_num()];
+#else
+        auto& threadBoundarySegments = boundarySegments[0];
+#endif
+        try {
+            computeElementFaces(elements[i], threadBoundarySegments);
+        }
+        catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            exc = std::current_exception();
+        }
     }
+    if (exc)
+        std::rethrow_exception(exc);
+
+    for (const auto& threadBoundarySegments : boundarySegments) {
+        for (const auto& segment : threadBoundarySegments) {
+            const auto key = std::make_pair(segment.elemIdx, segment.boundaryIsIdx);
+            transBoundary_[key] = segment.trans;
+            if (enableEnergy_)
+                thermalHalfTransBoundary_[key] = segment.thermalHalfTrans;
+        }
+    }
+
+    // the faces whose transmissibility is changed below by the keywords of the deck
+    // can not be recomputed by updateElements()
+    const std::vector<Scalar> gridTrans = trans_;
 
     // potentially overwrite and/or modify  transmissibilities based on input from deck
     updateFromEclState_(global);
@@ -489,6 +759,240 @@ update(bool global)
 
     //remove very small non-neighbouring transmissibilities
     removeSmallNonCartesianTransmissibilities_();
+
+    for (std::size_t faceIdx = 0; faceIdx < numFaces; ++faceIdx) {
+        if (trans_[faceIdx] != gridTrans[faceIdx])
+            faceGeometry_[faceIdx].fromGrid = false;
+    }
+}
+
+template<class Grid, class GridView, class ElementMapper, class Scalar>
+void EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
+updateCached(bool global, const std::string& fileName, std::uint64_t key)
+{
+    if (fileName.empty()) {
+        update(global);
+        return;
+    }
+
+    bool loaded;
+    {
+        StartupProfile::Phase profilePhase("transmissibility cache");
+        loaded = loadCache_(fileName, key);
+    }
+
+    // update() communicates, so either all processes use their cache or none does
+    const auto& comm = gridView_.comm();
+    if (global && comm.size() > 1)
+        loaded = comm.min(static_cast<int>(loaded));
+
+    if (loaded) {
+        OpmLog::info(fmt::format("Read the transmissibilities from {}", fileName));
+        return;
+    }
+
+    update(global);
+    saveCache_(fileName, key);
+}
+
+template<class Grid, class GridView, class ElementMapper, class Scalar>
+std::uint64_t EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
+elementsHash_() const
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    hashBytes(hash, cartMapper_.cartesianSize());
+    const std::size_t numElements = gridView_.size(/*codim=*/0);
+    for (std::size_t elemIdx = 0; elemIdx < numElements; ++elemIdx)
+        hashBytes(hash, cartMapper_.cartesianIndex(elemIdx));
+
+    return hash;
+}
+
+template<class Grid, class GridView, class ElementMapper, class Scalar>
+bool EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
+loadCache_(const std::string& fileName, std::uint64_t key)
+{
+    CacheReader reader(fileName);
+
+    char magic[sizeof(transCacheMagic)];
+    std::uint32_t version = 0;
+    std::uint64_t fileKey = 0;
+    std::uint64_t fileElementsHash = 0;
+    std::uint32_t scalarSize = 0;
+    std::uint8_t fileEnableEnergy = 0;
+    std::uint8_t fileUpdateDiffusivity = 0;
+    if (!reader.read(magic) || !std::equal(magic, magic + sizeof(magic), transCacheMagic) ||
+        !reader.read(version) || version != transCacheVersion ||
+        !reader.read(fileKey) || fileKey != key ||
+        !reader.read(fileElementsHash) || fileElementsHash != elementsHash_() ||
+        !reader.read(scalarSize) || scalarSize != sizeof(Scalar))
+        return false;
+
+    const bool updateDiffusivity = eclState_.getSimulationConfig().isDiffusive() && enableDiffusivity_;
+    if (!reader.read(fileEnableEnergy) || (fileEnableEnergy != 0) != enableEnergy_ ||
+        !reader.read(fileUpdateDiffusivity) || (fileUpdateDiffusivity != 0) != updateDiffusivity)
+        return false;
+
+    std::vector<unsigned> faceElements;
+    std::vector<unsigned> transBoundaryKeys;
+    std::vector<Scalar> transBoundary;
+    std::vector<unsigned> thermalBoundaryKeys;
+    std::vector<Scalar> thermalBoundary;
+    if (!reader.read(permeability_) ||
+        !reader.read(porosity_) ||
+        !reader.read(neighborOffsets_) ||
+        !reader.read(neighbors_) ||
+        !reader.read(slotFaces_) ||
+        !reader.read(faceElements) ||
+        !reader.read(trans_) ||
+        !reader.read(faceGeometry_) ||
+        !reader.read(transBoundaryKeys) ||
+        !reader.read(transBoundary) ||
+        !reader.read(thermalHalfTrans_) ||
+        !reader.read(thermalBoundaryKeys) ||
+        !reader.read(thermalBoundary) ||
+        !reader.read(diffusivity_) ||
+        !reader.atEnd())
+        return false;
+
+    const std::size_t numElements = gridView_.size(/*codim=*/0);
+    const std::size_t numFaces = trans_.size();
+    if (permeability_.size() != numElements ||
+        neighborOffsets_.size() != numElements + 1 ||
+        neighborOffsets_.back() != neighbors_.size() ||
+        slotFaces_.size() != neighbors_.size() ||
+        faceElements.size() != 2*numFaces ||
+        faceGeometry_.size() != numFaces ||
+        transBoundaryKeys.size() != 2*transBoundary.size() ||
+        thermalBoundaryKeys.size() != 2*thermalBoundary.size())
+        return false;
+
+    faceElements_.resize(numFaces);
+    for (std::size_t faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+        faceElements_[faceIdx] = {faceElements[2*faceIdx], faceElements[2*faceIdx + 1]};
+
+    transBoundary_.clear();
+    for (std::size_t i = 0; i < transBoundary.size(); ++i)
+        transBoundary_.emplace(std::make_pair(transBoundaryKeys[2*i], transBoundaryKeys[2*i + 1]),
+                               transBoundary[i]);
+    thermalHalfTransBoundary_.clear();
+    for (std::size_t i = 0; i < thermalBoundary.size(); ++i)
+        thermalHalfTransBoundary_.emplace(std::make_pair(thermalBoundaryKeys[2*i], thermalBoundaryKeys[2*i + 1]),
+                                          thermalBoundary[i]);
+
+    elementMult_.clear();
+    return true;
+}
+
+template<class Grid, class GridView, class ElementMapper, class Scalar>
+void EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
+saveCache_(const std::string& fileName, std::uint64_t key) const
+{
+    std::vector<unsigned> faceElements;
+    faceElements.reserve(2*faceElements_.size());
+    for (const auto& elements : faceElements_) {
+        faceElements.push_back(elements.first);
+        faceElements.push_back(elements.second);
+    }
+
+    const auto& flattenBoundary = [](const auto& boundary,
+                                     std::vector<unsigned>& keys,
+                                     std::vector<Scalar>& values)
+    {
+        for (const auto& [segment, value] : boundary) {
+            keys.push_back(segment.first);
+            keys.push_back(segment.second);
+            values.push_back(value);
+        }
+    };
+    std::vector<unsigned> transBoundaryKeys;
+    std::vector<Scalar> transBoundary;
+    flattenBoundary(transBoundary_, transBoundaryKeys, transBoundary);
+    std::vector<unsigned> thermalBoundaryKeys;
+    std::vector<Scalar> thermalBoundary;
+    flattenBoundary(thermalHalfTransBoundary_, thermalBoundaryKeys, thermalBoundary);
+
+    const bool updateDiffusivity = eclState_.getSimulationConfig().isDiffusive() && enableDiffusivity_;
+
+    // write to a temporary file first, such that an aborted run does not leave a
+    // truncated cache behind
+    const std::string tmpFileName = fileName + ".tmp";
+    {
+        std::ofstream os(tmpFileName, std::ios::binary | std::ios::trunc);
+        os.write(transCacheMagic, sizeof(transCacheMagic));
+        writeCacheValue(os, transCacheVersion);
+        writeCacheValue(os, key);
+        writeCacheValue(os, elementsHash_());
+        writeCacheValue(os, static_cast<std::uint32_t>(sizeof(Scalar)));
+        writeCacheValue(os, static_cast<std::uint8_t>(enableEnergy_));
+        writeCacheValue(os, static_cast<std::uint8_t>(updateDiffusivity));
+        writeCacheArray(os, permeability_);
+        writeCacheArray(os, porosity_);
+        writeCacheArray(os, neighborOffsets_);
+        writeCacheArray(os, neighbors_);
+        writeCacheArray(os, slotFaces_);
+        writeCacheArray(os, faceElements);
+        writeCacheArray(os, trans_);
+        writeCacheArray(os, faceGeometry_);
+        writeCacheArray(os, transBoundaryKeys);
+        writeCacheArray(os, transBoundary);
+        writeCacheArray(os, thermalHalfTrans_);
+        writeCacheArray(os, thermalBoundaryKeys);
+        writeCacheArray(os, thermalBoundary);
+        writeCacheArray(os, diffusivity_);
+        if (!os) {
+            OpmLog::warning(fmt::format("Could not write the transmissibilities to {}", fileName));
+            std::remove(tmpFileName.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+        OpmLog::warning(fmt::format("Could not write the transmissibilities to {}", fileName));
+        std::remove(tmpFileName.c_str());
+    }
+}
+
+template<class Grid, class GridView, class ElementMapper, class Scalar>
+void EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
+updateElements(const std::vector<unsigned>& elems,
+               const std::vector<DimMatrix>& perms,
+               const std::vector<DimVector>& mults)
+{
+    if (perms.size() != elems.size() || mults.size() != elems.size())
+        throw std::invalid_argument("One permeability and one multiplier per element are required");
+
+    if (elementMult_.empty())
+        elementMult_.assign(permeability_.size(), DimVector(1.0));
+    for (std::size_t i = 0; i < elems.size(); ++i) {
+        permeability_[elems[i]] = perms[i];
+        elementMult_[elems[i]] = mults[i];
+    }
+
+    for (const unsigned elemIdx : elems) {
+        for (unsigned slotIdx = neighborBegin(elemIdx); slotIdx < neighborEnd(elemIdx); ++slotIdx) {
+            const unsigned faceIdx = slotFaces_[slotIdx];
+            const auto& geometry = faceGeometry_[faceIdx];
+            if (!geometry.fromGrid)
+                continue;
+
+            const unsigned faceElems[2] = {faceElements_[faceIdx].first, faceElements_[faceIdx].second};
+            Scalar halfTrans[2];
+            for (unsigned side = 0; side < 2; ++side) {
+                const unsigned dimIdx = geometry.dim[side];
+                halfTrans[side] = geometry.halfTrans[side] * permeability_[faceElems[side]][dimIdx][dimIdx];
+            }
+
+            Scalar trans;
+            if (std::abs(halfTrans[0]) < 1e-30 || std::abs(halfTrans[1]) < 1e-30)
+                trans = 0.0;
+            else
+                trans = 1.0 / (1.0/halfTrans[0] + 1.0/halfTrans[1]);
+
+            const unsigned multSide = geometry.multSide;
+            trans *= geometry.mult * elementMult_[faceElems[multSide]][geometry.dim[multSide]];
+            trans_[faceIdx] = trans;
+        }
+    }
 }
 
 template<class Grid, class GridView, class ElementMapper, class Scalar>
@@ -555,10 +1059,9 @@ void EclTransmissibility<Grid,GridView,ElementMapper,Scalar>::
 removeSmallNonCartesianTransmissibilities_()
 {
     const auto& cartDims = cartMapper_.cartesianDimensions();
-    for (auto&& trans: trans_) {
-        if (trans.second < transmissibilityThreshold_) {
-            const auto& id = trans.first;
-            const auto& elements = isIdReverse(id);
+    for (std::size_t faceIdx = 0; faceIdx < trans_.size(); ++faceIdx) {
+        if (trans_[faceIdx] < transmissibilityThreshold_) {
+            const auto& elements = faceElements_[faceIdx];
             int gc1 = std::min(cartMapper_.cartesianIndex(elements.first), cartMapper_.cartesianIndex(elements.second));
             int gc2 = std::max(cartMapper_.cartesianIndex(elements.first), cartMapper_.cartesianIndex(elements.second));
 
@@ -567,7 +1070,7 @@ removeSmallNonCartesianTransmissibilities_()
                 continue;
 
             //remove transmissibilities less than the threshold (by default 1e-6 in the deck's unit system)
-            trans.second = 0.0;
+            trans_[faceIdx] = 0.0;
         }
     }
 }
@@ -686,22 +1189,22 @@ createTransmissibilityArrays_(const std::array<bool,3>& is_tran)
             if (gc1 > gc2)
                 continue; // we only need to handle each connection once, thank you.
 
-            auto isID = isId(c1, c2);
+            const int faceIdx = faceIndex_(c1, c2);
 
             if (gc2 - gc1 == 1 && cartDims[0] > 1) {
                 if (is_tran[0])
                     // set simulator internal transmissibilities to values from inputTranx
-                     trans[0][c1] = trans_[isID];
+                     trans[0][c1] = trans_[faceIdx];
             }
             else if (gc2 - gc1 == cartDims[0] && cartDims[1] > 1) {
                 if (is_tran[1])
                     // set simulator internal transmissibilities to values from inputTrany
-                     trans[1][c1] = trans_[isID];
+                     trans[1][c1] = trans_[faceIdx];
             }
             else if (gc2 - gc1 == cartDims[0]*cartDims[1]) {
                 if (is_tran[2])
                     // set simulator internal transmissibilities to values from inputTranz
-                     trans[2][c1] = trans_[isID];
+                     trans[2][c1] = trans_[faceIdx];
             }
             //else.. We don't support modification of NNC at the moment.
         }
@@ -746,22 +1249,22 @@ resetTransmissibilityFromArrays_(const std::array<bool,3>& is_tran,
             if (gc1 > gc2)
                 continue; // we only need to handle each connection once, thank you.
 
-            auto isID = isId(c1, c2);
+            const int faceIdx = faceIndex_(c1, c2);
 
             if (gc2 - gc1 == 1 && cartDims[0] > 1) {
                 if (is_tran[0])
                     // set simulator internal transmissibilities to values from inputTranx
-                    trans_[isID] = trans[0][c1];
+                    trans_[faceIdx] = trans[0][c1];
             }
             else if (gc2 - gc1 == cartDims[0] && cartDims[1] > 1) {
                 if (is_tran[1])
                     // set simulator internal transmissibilities to values from inputTrany
-                    trans_[isID] = trans[1][c1];
+                    trans_[faceIdx] = trans[1][c1];
             }
             else if (gc2 - gc1 == cartDims[0]*cartDims[1]) {
                 if (is_tran[2])
                     // set simulator internal transmissibilities to values from inputTranz
-                    trans_[isID] = trans[2][c1];
+                    trans_[faceIdx] = trans[2][c1];
             }
             //else.. We don't support modification of NNC at the moment.
         }
@@ -844,9 +1347,9 @@ applyNncToGridTrans_(const std::vector<int>& cartesianToCompressed)
             continue;
         }
 
-        auto candidate = trans_.find(isId(low, high));
+        const int faceIdx = faceIndex_(low, high);
 
-        if (candidate == trans_.end())
+        if (faceIdx < 0)
             // This NNC is not resembled by the grid. Save it for later
             // processing with local cell values
             unprocessedNnc.push_back(nncEntry);
@@ -854,7 +1357,7 @@ applyNncToGridTrans_(const std::vector<int>& cartesianToCompressed)
             // NNC is represented by the grid and might be a neighboring connection
             // In this case the transmissibilty is added to the value already
             // set or computed.
-            candidate->second += nncEntry.trans;
+            trans_[faceIdx] += nncEntry.trans;
             processedNnc.push_back(nncEntry);
         }
     }
@@ -900,8 +1403,8 @@ applyEditNncToGridTrans_(const std::vector<int>& globalToLocal)
         if (low > high)
             std::swap(low, high);
 
-        auto candidate = trans_.find(isId(low, high));
-        if (candidate == trans_.end()) {
+        const int faceIdx = low < 0 ? -1 : faceIndex_(low, high);
+        if (faceIdx < 0) {
             const auto& location = nnc_input.edit_location( *nnc );
             auto warning = make_warning(location, *nnc);
             OpmLog::warning("EDITNNC", warning);
@@ -911,7 +1414,7 @@ applyEditNncToGridTrans_(const std::vector<int>& globalToLocal)
         else {
             // NNC exists
             while (nnc!= end && c1==nnc->cell1 && c2==nnc->cell2) {
-                candidate->second *= nnc->trans;
+                trans_[faceIdx] *= nnc->trans;
                 ++nnc;
             }
         }
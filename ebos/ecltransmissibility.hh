@@ -34,10 +34,12 @@
 #include <dune/common/fmatrix.hh>
 
 #include <array>
+#include <cstdint>
 #include <map>
+#include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
-#include <unordered_map>
 
 namespace Opm {
 
@@ -49,6 +51,7 @@ template<class Grid, class GridView, class ElementMapper, class Scalar>
 class EclTransmissibility {
     // Grid and world dimension
     enum { dimWorld = GridView::dimensionworld };
+    using Element = typename GridView::template Codim<0>::Entity;
 public:
 
     using DimMatrix = Dune::FieldMatrix<Scalar, dimWorld, dimWorld>;
@@ -101,6 +104,54 @@ public:
      */
     Scalar diffusivity(unsigned elemIdx1, unsigned elemIdx2) const;
 
+    /*!
+     * \brief Return the first neighbor slot of an element.
+     *
+     * The neighbors of an element occupy the slots neighborBegin(elemIdx) to
+     * neighborEnd(elemIdx) - 1 in ascending order of their element index, i.e. in
+     * the order of the off-diagonal blocks in the element's row of the Jacobian.
+     */
+    unsigned neighborBegin(unsigned elemIdx) const
+    { return neighborOffsets_[elemIdx]; }
+
+    /*!
+     * \brief Return the slot after the last neighbor slot of an element.
+     */
+    unsigned neighborEnd(unsigned elemIdx) const
+    { return neighborOffsets_[elemIdx + 1]; }
+
+    /*!
+     * \brief Return the element index of the neighbor in a slot.
+     */
+    unsigned neighbor(unsigned slotIdx) const
+    { return neighbors_[slotIdx]; }
+
+    /*!
+     * \brief Return the slot of a neighbor of an element, -1 if the two elements are
+     *        not connected.
+     */
+    int neighborSlot(unsigned elemIdx, unsigned neighborElemIdx) const
+    { return slotIndex_(elemIdx, neighborElemIdx); }
+
+    /*!
+     * \brief Return the transmissibility of the face of a neighbor slot.
+     */
+    Scalar slotTransmissibility(unsigned slotIdx) const
+    { return trans_[slotFaces_[slotIdx]]; }
+
+    /*!
+     * \brief Return the thermal half transmissibility of a neighbor slot, seen from
+     *        the element which owns the slot.
+     */
+    Scalar slotThermalHalfTrans(unsigned slotIdx) const
+    { return thermalHalfTrans_[slotIdx]; }
+
+    /*!
+     * \brief Return the diffusivity of the face of a neighbor slot.
+     */
+    Scalar slotDiffusivity(unsigned slotIdx) const
+    { return diffusivity_.empty() ? 0.0 : diffusivity_[slotFaces_[slotIdx]]; }
+
     /*!
      * \brief Actually compute the transmissibility over a face as a pre-compute step.
      *
@@ -126,9 +177,67 @@ public:
      */
     void update(bool global);
 
+    /*!
+     * \brief Compute all transmissibilities like update(), but read them from a file
+     *        written by a previous run if it matches.
+     *
+     * \param global If true, update is called on all processes
+     * \param fileName The file of the cache. If it does not exist or does not match,
+     *                 the transmissibilities are computed and written to it. Nothing
+     *                 is cached if it is empty.
+     * \param key The hash of the parts of the deck which determine the
+     *            transmissibilities.
+     *
+     * The file matches if it was written with the same key and for the same elements
+     * in the same order, i.e. also for the same partitioning of the grid.
+     */
+    void updateCached(bool global, const std::string& fileName, std::uint64_t key);
+
+    /*!
+     * \brief Change the permeability and the transmissibility multipliers of some
+     *        elements and recompute only the transmissibilities of their faces.
+     *
+     * \param elems The elements to change.
+     * \param perms The new permeabilities of the elements.
+     * \param mults Per element the factors of the transmissibilities of its faces in
+     *              positive x, y and z direction, on top of the multipliers of the
+     *              deck, i.e. like MULTX, MULTY and MULTZ.
+     *
+     * The faces are recomputed from the geometry of the last update(), faces whose
+     * transmissibility was set by the NNC, EDITNNC or TRAN{X,Y,Z} keywords keep it.
+     * The next update() discards the changes.
+     */
+    void updateElements(const std::vector<unsigned>& elems,
+                        const std::vector<DimMatrix>& perms,
+                        const std::vector<DimVector>& mults);
+
+    /*!
+     * \brief Return the transmissibility multipliers of an element set by updateElements().
+     */
+    DimVector elementMultiplier(unsigned elemIdx) const
+    { return elementMult_.empty() ? DimVector(1.0) : elementMult_[elemIdx]; }
+
 protected:
+    /// \brief Set up the neighbor slots of all elements and the numbering of the faces.
+    void updateNeighbors_(const ElementMapper& elemMapper);
+
+    /// \brief Index of the slot of neighborElemIdx in the neighbors of elemIdx, -1 if none.
+    int slotIndex_(unsigned elemIdx, unsigned neighborElemIdx) const;
+
+    /// \brief Index of the face between two elements, -1 if they are not connected.
+    int faceIndex_(unsigned elemIdx1, unsigned elemIdx2) const;
+
     void updateFromEclState_(bool global);
 
+    /// \brief Hash of the Cartesian indices of the elements in the order of their indices.
+    std::uint64_t elementsHash_() const;
+
+    /// \brief Read the results of update() from a cache file, false if it does not match.
+    bool loadCache_(const std::string& fileName, std::uint64_t key);
+
+    /// \brief Write the results of update() to a cache file.
+    void saveCache_(const std::string& fileName, std::uint64_t key) const;
+
     void removeSmallNonCartesianTransmissibilities_();
 
     /// \brief Apply the Multipliers for the case PINCH(4)==TOPBOT
@@ -231,7 +340,31 @@ protected:
 
     std::vector<DimMatrix> permeability_;
     std::vector<Scalar> porosity_;
-    std::unordered_map<std::uint64_t, Scalar> trans_;
+
+    // The neighbors of element i are neighbors_[neighborOffsets_[i]] to
+    // neighbors_[neighborOffsets_[i+1] - 1], sorted by element index.
+    // slotFaces_ maps each of these slots to the face, and faceElements_ holds
+    // the two elements of each face.
+    std::vector<unsigned> neighborOffsets_;
+    std::vector<unsigned> neighbors_;
+    std::vector<unsigned> slotFaces_;
+    std::vector<std::pair<unsigned, unsigned>> faceElements_;
+
+    std::vector<Scalar> trans_; // per face
+
+    // The parts of the transmissibility of a face between two elements which do not
+    // depend on the permeability, for updateElements(). Side s refers to element
+    // faceElements_[faceIdx].first for s = 0 and to the second element for s = 1.
+    struct FaceGeometry
+    {
+        Scalar halfTrans[2] = {0.0, 0.0}; // for unit permeability, including NTG
+        Scalar mult = 1.0; // the multipliers of the deck
+        unsigned char dim[2] = {0, 0}; // the component of the permeability of each side
+        unsigned char multSide = 0; // the side whose face is in positive direction
+        bool fromGrid = false; // whether the transmissibility is given by the above
+    };
+    std::vector<FaceGeometry> faceGeometry_; // per face
+    std::vector<DimVector> elementMult_; // per element, empty if not set
     const EclipseState& eclState_;
     const GridView& gridView_;
     const Dune::CartesianIndexMapper<Grid>& cartMapper_;
@@ -242,8 +375,8 @@ protected:
     std::map<std::pair<unsigned, unsigned>, Scalar> thermalHalfTransBoundary_;
     bool enableEnergy_;
     bool enableDiffusivity_;
-    std::unordered_map<std::uint64_t, Scalar> thermalHalfTrans_;
-    std::unordered_map<std::uint64_t, Scalar> diffusivity_;
+    std::vector<Scalar> thermalHalfTrans_; // per slot, for the element of the slot
+    std::vector<Scalar> diffusivity_; // per face
 };
 
 } // namespace Opm
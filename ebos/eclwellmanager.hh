@@ -51,6 +51,7 @@
 
 #include <dune/grid/common/gridenums.hh>
 
+#include <functional>
 #include <map>
 #include <unordered_set>
 #include <string>
@@ -534,7 +535,7 @@ public:
         }
     }
 
-    data::Wells wellData() const
+    data::Wells wellData(const std::function<bool(const std::string&)>& /* reportDetails */ = {}) const
     {
         data::Wells wellDat;
 
@@ -37,7 +37,9 @@
 
 #include <ebos/eclgenericwriter.hh>
 
+#include <optional>
 #include <string>
+#include <tuple>
 
 namespace Opm::Properties {
 
@@ -50,9 +52,25 @@ struct EnableAsyncEclOutput {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct EclOutputCollectPerField {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct EclOutputQueueSize {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct EclOutputDoublePrecision {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct EclOutputRestartFields {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct EclOutputMantissaBits {
+    using type = UndefinedProperty;
+};
 
 } // namespace Opm::Properties
 
@@ -107,6 +125,15 @@ public:
 
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncEclOutput,
                              "Write the ECL-formated results in a non-blocking way (i.e., using a separate thread).");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EclOutputCollectPerField,
+                             "Gather the cell data to the I/O rank one field at a time to bound its memory usage in parallel runs.");
+        EWOMS_REGISTER_PARAM(TypeTag, int, EclOutputQueueSize,
+                             "Maximum number of report steps which are queued for asynchronous output before the simulation waits for the writer.");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, EclOutputRestartFields,
+                             "Comma separated list of the cell data written to the restart files, e.g. PRESSURE,SWAT,SGAS for screening runs. "
+                             "All fields are written if empty, restarting from files with only some of them is not possible.");
+        EWOMS_REGISTER_PARAM(TypeTag, int, EclOutputMantissaBits,
+                             "Round the cell data of the restart files to this number of mantissa bits, such that they compress well. 0 writes the exact values.");
     }
 
     // The Simulator object should preferably have been const - the
@@ -123,7 +150,11 @@ public:
                    simulator.vanguard().cartesianIndexMapper(),
                    simulator.vanguard().grid().comm().rank() == 0 ? &simulator.vanguard().equilCartesianIndexMapper() : nullptr,
                    simulator.vanguard().grid().comm().size() > 1 ? simulator.vanguard().globalTransmissibility() : problem.eclTransmissibilities(),
-                   EWOMS_GET_PARAM(TypeTag, bool, EnableAsyncEclOutput))
+                   EWOMS_GET_PARAM(TypeTag, bool, EnableAsyncEclOutput),
+                   EWOMS_GET_PARAM(TypeTag, bool, EclOutputCollectPerField),
+                   EWOMS_GET_PARAM(TypeTag, int, EclOutputQueueSize),
+                   EWOMS_GET_PARAM(TypeTag, std::string, EclOutputRestartFields),
+                   EWOMS_GET_PARAM(TypeTag, int, EclOutputMantissaBits))
         , simulator_(simulator)
     {
         this->eclOutputModule_ = std::make_unique<EclOutputBlackOilModule<TypeTag>>(simulator, this->wbp_index_list_, this->collectToIORank_);
@@ -171,12 +202,18 @@ public:
             simulator_.setupTimer().realTimeElapsed() +
             simulator_.vanguard().externalSetupTime();
 
-        const auto localWellData            = simulator_.problem().wellModel().wellData();
+        // only the connection and segment results of wells with such
+        // summary vectors are needed
+        const auto localWellData            = simulator_.problem().wellModel()
+            .wellData([this](const std::string& wellName)
+                      { return this->summaryNeedsWellDetails(wellName); });
         const auto localGroupAndNetworkData = simulator_.problem().wellModel()
             .groupAndNetworkData(reportStepNum, simulator_.vanguard().schedule());
 
 
-        const auto localAquiferData = simulator_.problem().mutableAquiferModel().aquiferData();
+        const auto localAquiferData = this->summaryNeedsAquiferData()
+            ? simulator_.problem().mutableAquiferModel().aquiferData()
+            : data::Aquifers{};
 
         this->prepareLocalCellData(isSubStep, reportStepNum);
 
@@ -238,8 +275,24 @@ public:
         if (! isSubStep) {
             this->eclOutputModule_->assignToSolution(localCellData);
 
+            const auto& hotspots = simulator_.problem().convergenceHotspots();
+            if (hotspots.enabled()) {
+                localCellData.insert("HSCNVMAX", UnitSystem::measure::identity,
+                                     hotspots.maxCnvCount(), data::TargetType::RESTART_AUXILIARY);
+                localCellData.insert("HSCHOPS", UnitSystem::measure::identity,
+                                     hotspots.chopCount(), data::TargetType::RESTART_AUXILIARY);
+                localCellData.insert("HSLINITS", UnitSystem::measure::identity,
+                                     hotspots.linearIterations(), data::TargetType::RESTART_AUXILIARY);
+            }
+
             // add cell data to perforations for Rft output
             this->eclOutputModule_->addRftDataToWells(localWellData, reportStepNum);
+
+            // the buffers have been moved to the solution
+            this->preparedCellData_.reset();
+
+            // the fields which are not written are not collected either
+            this->selectRestartFields_(localCellData);
         }
 
         if (this->collectToIORank_.isParallel()) {
@@ -301,22 +354,33 @@ public:
         const auto& gridView = simulator_.vanguard().gridView();
         unsigned numElements = gridView.size(/*codim=*/0);
         eclOutputModule_->allocBuffers(numElements, restartStepIdx, /*isSubStep=*/false, /*log=*/false, /*isRestart*/ true);
+        this->preparedCellData_.reset();
 
         {
             SummaryState& summaryState = simulator_.vanguard().summaryState();
             Action::State& actionState = simulator_.vanguard().actionState();
+            // in parallel, every rank only receives the cell data of its own cells
+            const bool isParallel = this->collectToIORank_.isParallel();
             auto restartValues = loadParallelRestart(this->eclIO_.get(), actionState, summaryState, solutionKeys, extraKeys,
-                                                     gridView.grid().comm());
-            for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
-                unsigned globalIdx = this->collectToIORank_.localIdxToGlobalIdx(elemIdx);
-                eclOutputModule_->setRestart(restartValues.solution, elemIdx, globalIdx);
+                                                     gridView.grid().comm(), /*broadcastSolution=*/!isParallel);
+            if (isParallel) {
+                data::Solution localSolution;
+                this->collectToIORank_.distribute(restartValues.solution, localSolution);
+                restartValues.solution = {};
+                for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx)
+                    eclOutputModule_->setRestart(localSolution, elemIdx, elemIdx);
+            }
+            else {
+                for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+                    unsigned globalIdx = this->collectToIORank_.localIdxToGlobalIdx(elemIdx);
+                    eclOutputModule_->setRestart(restartValues.solution, elemIdx, globalIdx);
+                }
             }
 
             if (inputThpres.active()) {
                 Simulator& mutableSimulator = const_cast<Simulator&>(simulator_);
-                auto& thpres = mutableSimulator.problem().thresholdPressure();
                 const auto& thpresValues = restartValues.getExtra("THRESHPR");
-                thpres.setFromRestart(thpresValues);
+                mutableSimulator.problem().setThresholdPressuresFromRestart(thpresValues);
             }
             restartTimeStepSize_ = restartValues.getExtra("OPMEXTRA")[0];
 
@@ -359,6 +423,14 @@ private:
     void prepareLocalCellData(const bool isSubStep,
                               const int  reportStepNum)
     {
+        // writeOutput() directly follows evalSummaryState() at the end of a
+        // time step, the solution has not changed in between.
+        const auto key = std::make_tuple(reportStepNum,
+                                         simulator_.time() + simulator_.timeStepSize(),
+                                         isSubStep);
+        if (this->preparedCellData_ == key)
+            return;
+
         const auto& gridView = simulator_.vanguard().gridView();
         const int numElements = gridView.size(/*codim=*/0);
         const bool log = this->collectToIORank_.isIORank();
@@ -366,6 +438,9 @@ private:
         eclOutputModule_->allocBuffers(numElements, reportStepNum,
                                       isSubStep, log, /*isRestart*/ false);
 
+        // The intensive quantities of the last linearization are used if the
+        // model has cached them, they are only updated for cells without.
+        const auto& model = simulator_.model();
         ElementContext elemCtx(simulator_);
         ElementIterator elemIt = gridView.template begin</*codim=*/0>();
 
@@ -374,15 +449,24 @@ private:
             const Element& elem = *elemIt;
 
             elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+            const unsigned globalDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+            const auto* intQuants = model.cachedIntensiveQuantities(globalDofIdx, /*timeIdx=*/0);
+            if (intQuants != nullptr) {
+                eclOutputModule_->processCell(globalDofIdx, *intQuants);
+                continue;
+            }
 
+            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
             eclOutputModule_->processElement(elemCtx);
         }
+        this->preparedCellData_ = key;
     }
 
     Simulator& simulator_;
     std::unique_ptr<EclOutputBlackOilModule<TypeTag>> eclOutputModule_;
     Scalar restartTimeStepSize_;
+    // report step, time and substep flag of the data in the output module buffers
+    std::optional<std::tuple<int, Scalar, bool>> preparedCellData_;
 };
 } // namespace Opm
 
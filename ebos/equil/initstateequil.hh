@@ -58,6 +58,7 @@
 #include <array>
 #include <cassert>
 #include <cstddef>
+#include <exception>
 #include <limits>
 #include <stdexcept>
 #include <type_traits>
@@ -850,9 +851,11 @@ public:
         , press_    (rhs.press_)
     {
         // Note: We don't need to do anything to the 'fluidState_' here.
-        this->setEvaluationPoint(*rhs.evalPt_.position,
-                                 *rhs.evalPt_.region,
-                                 *rhs.evalPt_.ptable);
+        if (rhs.evalPt_.position != nullptr) {
+            this->setEvaluationPoint(*rhs.evalPt_.position,
+                                     *rhs.evalPt_.region,
+                                     *rhs.evalPt_.ptable);
+        }
     }
 
     /// Disabled assignment operator.
@@ -1948,8 +1951,16 @@ private:
         }
     }
 
-    template <class CellRange, class EquilibrationMethod>
+    /// Apply the equilibration method to all cells of a region.
+    ///
+    /// The cells are independent of each other, so they are distributed over
+    /// the threads. Every thread works on its own copy of the saturation
+    /// calculator, which is passed to the equilibration method. The material
+    /// law manager is shared, but it is only modified for the cell which is
+    /// being equilibrated.
+    template <class CellRange, class PhaseSat, class EquilibrationMethod>
     void cellLoop(const CellRange&      cells,
+                  const PhaseSat&       psat,
                   EquilibrationMethod&& eqmethod)
     {
         const auto oilPos = FluidSystem::oilPhaseIdx;
@@ -1960,34 +1971,62 @@ private:
         const auto gasActive = FluidSystem::phaseIsActive(gasPos);
         const auto watActive = FluidSystem::phaseIsActive(watPos);
 
-        auto pressures   = Details::PhaseQuantityValue{};
-        auto saturations = Details::PhaseQuantityValue{};
-        auto Rs          = 0.0;
-        auto Rv          = 0.0;
+        using CellID = std::remove_cv_t<std::remove_reference_t<decltype(*cells.begin())>>;
+        const std::vector<CellID> cellList(cells.begin(), cells.end());
+        const int numCells = cellList.size();
 
-        for (const auto& cell : cells) {
-            eqmethod(cell, pressures, saturations, Rs, Rv);
+        std::exception_ptr exc;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            auto localPsat   = psat;
+            auto pressures   = Details::PhaseQuantityValue{};
+            auto saturations = Details::PhaseQuantityValue{};
+            auto Rs          = 0.0;
+            auto Rv          = 0.0;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256)
+#endif
+            for (int cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                const auto& cell = cellList[cellIdx];
+                try {
+                    eqmethod(localPsat, cell, pressures, saturations, Rs, Rv);
+                }
+                catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    exc = std::current_exception();
+                    continue;
+                }
 
-            if (oilActive) {
-                this->pp_ [oilPos][cell] = pressures.oil;
-                this->sat_[oilPos][cell] = saturations.oil;
-            }
+                if (oilActive) {
+                    this->pp_ [oilPos][cell] = pressures.oil;
+                    this->sat_[oilPos][cell] = saturations.oil;
+                }
 
-            if (gasActive) {
-                this->pp_ [gasPos][cell] = pressures.gas;
-                this->sat_[gasPos][cell] = saturations.gas;
-            }
+                if (gasActive) {
+                    this->pp_ [gasPos][cell] = pressures.gas;
+                    this->sat_[gasPos][cell] = saturations.gas;
+                }
 
-            if (watActive) {
-                this->pp_ [watPos][cell] = pressures.water;
-                this->sat_[watPos][cell] = saturations.water;
-            }
+                if (watActive) {
+                    this->pp_ [watPos][cell] = pressures.water;
+                    this->sat_[watPos][cell] = saturations.water;
+                }
 
-            if (oilActive && gasActive) {
-                this->rs_[cell] = Rs;
-                this->rv_[cell] = Rv;
+                if (oilActive && gasActive) {
+                    this->rs_[cell] = Rs;
+                    this->rv_[cell] = Rv;
+                }
             }
         }
+
+        if (exc) {
+            std::rethrow_exception(exc);
+        }
     }
 
     template <class CellRange, class PressTable, class PhaseSat>
@@ -1999,8 +2038,9 @@ private:
         using CellPos = typename PhaseSat::Position;
         using CellID  = std::remove_cv_t<std::remove_reference_t<
             decltype(std::declval<CellPos>().cell)>>;
-        this->cellLoop(cells, [this, &eqreg,  &ptable, &psat]
-            (const CellID                 cell,
+        this->cellLoop(cells, psat, [this, &eqreg, &ptable]
+            (PhaseSat&                    threadPsat,
+             const CellID                 cell,
              Details::PhaseQuantityValue& pressures,
              Details::PhaseQuantityValue& saturations,
              double&                      Rs,
@@ -2010,8 +2050,8 @@ private:
                 cell, cellCenterDepth_[cell]
             };
 
-            saturations = psat.deriveSaturations(pos, eqreg, ptable);
-            pressures   = psat.correctedPhasePressures();
+            saturations = threadPsat.deriveSaturations(pos, eqreg, ptable);
+            pressures   = threadPsat.correctedPhasePressures();
 
             const auto temp = this->temperature_[cell];
 
@@ -2034,8 +2074,9 @@ private:
         using CellID  = std::remove_cv_t<std::remove_reference_t<
             decltype(std::declval<CellPos>().cell)>>;
 
-        this->cellLoop(cells, [this, acc, &eqreg, &ptable, &psat]
-            (const CellID                 cell,
+        this->cellLoop(cells, psat, [this, acc, &eqreg, &ptable]
+            (PhaseSat&                    threadPsat,
+             const CellID                 cell,
              Details::PhaseQuantityValue& pressures,
              Details::PhaseQuantityValue& saturations,
              double&                      Rs,
@@ -2048,8 +2089,8 @@ private:
             for (const auto& [depth, frac] : Details::horizontalSubdivision(cell, cellZSpan_[cell], acc)) {
                 const auto pos = CellPos { cell, depth };
 
-                saturations.axpy(psat.deriveSaturations(pos, eqreg, ptable), frac);
-                pressures  .axpy(psat.correctedPhasePressures(), frac);
+                saturations.axpy(threadPsat.deriveSaturations(pos, eqreg, ptable), frac);
+                pressures  .axpy(threadPsat.correctedPhasePressures(), frac);
 
                 totfrac += frac;
             }
@@ -0,0 +1,131 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::VtkEclConvergenceHotspotModule
+ */
+#ifndef EWOMS_VTK_ECL_CONVERGENCE_HOTSPOT_MODULE_HH
+#define EWOMS_VTK_ECL_CONVERGENCE_HOTSPOT_MODULE_HH
+
+#include <opm/models/io/vtkmultiwriter.hh>
+#include <opm/models/io/baseoutputmodule.hh>
+
+#include <opm/models/utils/propertysystem.hh>
+#include <opm/models/utils/parametersystem.hh>
+
+#include <opm/simulators/utils/ConvergenceHotspots.hpp>
+
+namespace Opm {
+/*!
+ * \ingroup Vtk
+ *
+ * \brief VTK output module for the convergence hotspot counters.
+ *
+ * The counters are only written if the simulator enabled them in the
+ * problem, e.g. by --output-convergence-hotspots of flow.
+ */
+template <class TypeTag>
+class VtkEclConvergenceHotspotModule : public BaseOutputModule<TypeTag>
+{
+    typedef BaseOutputModule<TypeTag> ParentType;
+
+    using Simulator = GetPropType<TypeTag, Properties::Simulator>;
+    using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using GridView = GetPropType<TypeTag, Properties::GridView>;
+
+    static const int vtkFormat = getPropValue<TypeTag, Properties::VtkOutputFormat>();
+    typedef ::Opm::VtkMultiWriter<GridView, vtkFormat> VtkMultiWriter;
+
+    typedef typename ParentType::ScalarBuffer ScalarBuffer;
+
+public:
+    VtkEclConvergenceHotspotModule(const Simulator& simulator)
+        : ParentType(simulator)
+    { }
+
+    static void registerParameters()
+    { }
+
+    /*!
+     * \brief Allocate memory for the scalar fields we would like to
+     *        write to the VTK file.
+     */
+    void allocBuffers()
+    {
+        if (!hotspots_().enabled())
+            return;
+
+        this->resizeScalarBuffer_(maxCnvCount_);
+        this->resizeScalarBuffer_(chopCount_);
+        this->resizeScalarBuffer_(linearIterations_);
+    }
+
+    /*!
+     * \brief Copy the counters of the degrees of freedom of an element.
+     */
+    void processElement(const ElementContext& elemCtx)
+    {
+        if (!vtkOutput_() || !hotspots_().enabled())
+            return;
+
+        const auto& hotspots = hotspots_();
+        for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx) {
+            const unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+            maxCnvCount_[globalDofIdx] = hotspots.maxCnvCount()[globalDofIdx];
+            chopCount_[globalDofIdx] = hotspots.chopCount()[globalDofIdx];
+            linearIterations_[globalDofIdx] = hotspots.linearIterations()[globalDofIdx];
+        }
+    }
+
+    /*!
+     * \brief Add all buffers to the VTK output writer.
+     */
+    void commitBuffers(BaseOutputWriter& baseWriter)
+    {
+        VtkMultiWriter *vtkWriter = dynamic_cast<VtkMultiWriter*>(&baseWriter);
+        if (!vtkWriter || !hotspots_().enabled())
+            return;
+
+        this->commitScalarBuffer_(baseWriter, "convergenceHotspotMaxCnv", maxCnvCount_);
+        this->commitScalarBuffer_(baseWriter, "convergenceHotspotChops", chopCount_);
+        this->commitScalarBuffer_(baseWriter, "convergenceHotspotLinearIterations", linearIterations_);
+    }
+
+private:
+    static bool vtkOutput_()
+    {
+        static bool val = EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput);
+        return val;
+    }
+
+    const ConvergenceHotspots& hotspots_() const
+    { return this->simulator_.problem().convergenceHotspots(); }
+
+    ScalarBuffer maxCnvCount_;
+    ScalarBuffer chopCount_;
+    ScalarBuffer linearIterations_;
+};
+} // namespace Opm
+
+#endif
@@ -125,7 +125,8 @@ namespace Opm {
      */
         void processElement(const ElementContext& elemCtx)
         {
-            if (!EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput))
+            // this is called for every element, so the parameters must not be looked up here
+            if (!vtkOutput_() || !eclTracerConcentrationOutput_())
                 return;
 
             const auto& tracerModel = elemCtx.problem().tracerModel();
@@ -133,10 +134,8 @@ namespace Opm {
             for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx) {
                 unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
 
-                if (eclTracerConcentrationOutput_()){
-                    for(size_t tracerIdx=0; tracerIdx<eclTracerConcentration_.size();++tracerIdx){
-                        eclTracerConcentration_[tracerIdx][globalDofIdx] = tracerModel.tracerConcentration(tracerIdx, globalDofIdx);
-                    }
+                for(size_t tracerIdx=0; tracerIdx<eclTracerConcentration_.size();++tracerIdx){
+                    eclTracerConcentration_[tracerIdx][globalDofIdx] = tracerModel.tracerConcentration(tracerIdx, globalDofIdx);
                 }
             }
         }
@@ -163,6 +162,12 @@ namespace Opm {
         }
 
     private:
+        static bool vtkOutput_()
+        {
+            static bool val = EWOMS_GET_PARAM(TypeTag, bool, EnableVtkOutput);
+            return val;
+        }
+
         static bool eclTracerConcentrationOutput_()
         {
             static bool val = EWOMS_GET_PARAM(TypeTag, bool, VtkWriteEclTracerConcentration);
@@ -0,0 +1,239 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Benchmark of the assembly of the reservoir equations of flow.
+//
+// Usage: assembly_benchmark --ecl-deck-file-name=CASE.DATA
+//                           [--assembly-benchmark-repetitions=N] [flow parameters]
+//
+// The deck is initialised as for the first time step of the first report
+// step, and the state is then frozen: every repetition linearizes the same
+// solution. The phases of the linearization are timed separately:
+//
+//   - the intensive quantities of all cells, as updated after each Newton
+//     update of the solution,
+//   - the fluxes of all faces, EclTransExtensiveQuantities,
+//   - the source terms of the cells, which include the well rates,
+//   - the assembly of the well equations,
+//   - the local residuals and the Jacobian written to the global matrix, the
+//     remainder of the time of linearizeDomain().
+//
+// The fluxes and the source terms are timed by loops over the elements which
+// update the element contexts as linearizeDomain() does, and the time of the
+// same loop without them is subtracted. These loops are serial, so for the
+// phases to add up, run with --threads-per-process=1. The fastest repetition
+// of each phase is reported.
+
+#include <config.h>
+
+#include <opm/simulators/flow/BlackoilModelEbos.hpp>
+#include <opm/simulators/flow/BlackoilModelParametersEbos.hpp>
+
+#include <opm/models/utils/start.hh>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#else
+#include <dune/common/parallel/mpihelper.hh>
+#endif
+
+#include <dune/common/timer.hh>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace Opm::Properties {
+
+template<class TypeTag, class MyTypeTag>
+struct AssemblyBenchmarkRepetitions {
+    using type = UndefinedProperty;
+};
+
+template<class TypeTag>
+struct AssemblyBenchmarkRepetitions<TypeTag, TTag::EclFlowProblem> {
+    static constexpr int value = 10;
+};
+
+} // namespace Opm::Properties
+
+namespace
+{
+
+using TypeTag = Opm::Properties::TTag::EclFlowProblem;
+using Simulator = Opm::GetPropType<TypeTag, Opm::Properties::Simulator>;
+using ElementContext = Opm::GetPropType<TypeTag, Opm::Properties::ElementContext>;
+using RateVector = Opm::GetPropType<TypeTag, Opm::Properties::RateVector>;
+
+// Update the element contexts of all interior cells, and call extra() for
+// each of them, as the linearizer does.
+template <class Extra>
+void elementLoop(Simulator& simulator, const Extra& extra)
+{
+    ElementContext elemCtx(simulator);
+    for (const auto& elem : elements(simulator.gridView(), Dune::Partitions::interior)) {
+        elemCtx.updateStencil(elem);
+        elemCtx.updateAllIntensiveQuantities();
+        extra(elemCtx);
+    }
+}
+
+// The fastest of a number of runs of a function.
+template <class Function>
+double bestTime(const int repetitions, const Function& function)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int rep = 0; rep < repetitions; ++rep) {
+        Dune::Timer timer;
+        function();
+        best = std::min(best, timer.elapsed());
+    }
+    return best;
+}
+
+void printPhase(const std::string& name, const double time, const std::size_t numCells)
+{
+    std::cout << std::left << std::setw(36) << name << std::right << std::fixed
+              << std::setw(12) << std::setprecision(6) << time
+              << std::setw(16) << std::setprecision(0) << (time > 0.0 ? numCells / time : 0.0)
+              << '\n';
+}
+
+std::unique_ptr<Simulator> initSimulator()
+{
+    auto simulator = std::make_unique<Simulator>();
+    simulator->model().applyInitialSolution();
+
+    const auto& schedule = simulator->vanguard().schedule();
+    simulator->setEpisodeIndex(-1);
+    simulator->setEpisodeLength(0.0);
+    simulator->startNextEpisode(simulator->startTime(), schedule.stepLength(0));
+    simulator->setEpisodeIndex(0);
+    simulator->problem().beginEpisode();
+
+    simulator->setTimeStepSize(schedule.stepLength(0));
+    simulator->model().newtonMethod().setIterationIndex(0);
+    simulator->problem().beginTimeStep();
+    return simulator;
+}
+
+int benchmark(Simulator& simulator, const int repetitions)
+{
+    auto& model = simulator.model();
+    auto& problem = simulator.problem();
+    auto& wellModel = problem.wellModel();
+
+    std::size_t numCells = 0;
+    elementLoop(simulator, [&numCells](const ElementContext&) { ++numCells; });
+
+    // warm up the caches of the intensive quantities and the well model
+    problem.beginIteration();
+    model.linearizer().linearizeDomain();
+    problem.endIteration();
+
+    const double intensiveTime = bestTime(repetitions, [&model]()
+    {
+        model.invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+    });
+
+    const double contextTime = bestTime(repetitions, [&simulator]()
+    {
+        elementLoop(simulator, [](const ElementContext&) {});
+    });
+
+    const double fluxTime = bestTime(repetitions, [&simulator]()
+    {
+        elementLoop(simulator, [](ElementContext& elemCtx)
+        {
+            elemCtx.updateAllExtensiveQuantities();
+        });
+    }) - contextTime;
+
+    const double sourceTime = bestTime(repetitions, [&simulator, &problem]()
+    {
+        RateVector rate;
+        elementLoop(simulator, [&problem, &rate](const ElementContext& elemCtx)
+        {
+            for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx)
+                problem.source(rate, elemCtx, dofIdx, /*timeIdx=*/0);
+        });
+    }) - contextTime;
+
+    const double wellTime = bestTime(repetitions, [&wellModel]()
+    {
+        wellModel.beginIteration();
+    });
+
+    const double linearizeTime = bestTime(repetitions, [&model]()
+    {
+        model.linearizer().linearizeDomain();
+    });
+    const double jacobianTime = std::max(linearizeTime - contextTime - fluxTime - sourceTime, 0.0);
+
+    const auto numWells = simulator.vanguard().schedule().getWells(0).size();
+    std::cout << "Case " << simulator.vanguard().caseName() << ": " << numCells << " cells, "
+              << numWells << " wells, " << repetitions << " repetitions\n\n"
+              << std::left << std::setw(36) << "phase" << std::right
+              << std::setw(12) << "time [s]" << std::setw(16) << "cells/s" << '\n';
+    printPhase("intensive quantities", intensiveTime, numCells);
+    printPhase("fluxes", fluxTime, numCells);
+    printPhase("source terms", sourceTime, numCells);
+    printPhase("well equations", wellTime, numCells);
+    printPhase("local residuals and Jacobian write", jacobianTime, numCells);
+    printPhase("linearizeDomain", linearizeTime, numCells);
+    printPhase("total", intensiveTime + wellTime + linearizeTime, numCells);
+    return EXIT_SUCCESS;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    try {
+        Opm::registerAllParameters_<TypeTag>(/*finalizeRegistration=*/false);
+        Opm::BlackoilModelParametersEbos<TypeTag>::registerParameters();
+        EWOMS_REGISTER_PARAM(TypeTag, int, AssemblyBenchmarkRepetitions,
+                             "The number of times each phase of the assembly is run");
+        EWOMS_END_PARAM_REGISTRATION(TypeTag);
+
+        const int status = Opm::setupParameters_<TypeTag>(argc, const_cast<const char**>(argv),
+                                                          /*registerParams=*/false);
+        if (status != 0) {
+            return status < 0 ? EXIT_SUCCESS : status;
+        }
+
+        const int repetitions = std::max(EWOMS_GET_PARAM(TypeTag, int, AssemblyBenchmarkRepetitions), 1);
+        auto simulator = initSimulator();
+        return benchmark(*simulator, repetitions);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
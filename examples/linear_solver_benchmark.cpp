@@ -0,0 +1,417 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Benchmark of the linear solver configurations on systems dumped by the
+// simulator (--linear-solver-verbosity > 10 writes them to the reports
+// directory of the output directory).
+//
+// Usage: linear_solver_benchmark <configurations.json> <system prefix> [repetitions]
+//
+// The system prefix is the common part of the file names of the dump, e.g.
+// reports/prob_12_time_000086400_nit_2_, which is followed by matrix_istl.mm
+// and rhs_istl.mm, or by system_istl.bin for the binary dumps written with
+// --linear-solver-dump-format=binary. The binary dumps also hold the standard
+// wells, which are then applied by the operator of the solvers as in the
+// simulator. The configuration file contains a list of named
+// configurations, each either a FlexibleSolver property tree or the
+// arguments of one of the BdaBridge backends:
+//
+// { "configurations": [
+//     { "name": "cpr-ilu0", "flexible": { "solver": "bicgstab", ... } },
+//     { "name": "opencl-ilu0", "bda": { "accelerator_mode": "opencl", "maxit": "200",
+//                                     "tolerance": "0.01" } }
+// ] }
+//
+// For every configuration the setup time, the time of the solve, the number
+// of iterations and the memory bandwidth of the matrix-vector products of the
+// solve are reported. The bandwidth counts the bytes of the matrix and the
+// vectors streamed by each operator application. It does not include the
+// preconditioner, and is therefore a lower bound of the bandwidth reached.
+// Each configuration is run several times, and the fastest run is reported.
+
+#include <config.h>
+
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
+#include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
+#include <opm/simulators/linalg/matrixblock.hh>
+#include <opm/simulators/linalg/MatrixMarketSpecializations.hpp>
+#include <opm/simulators/wells/PackedWellSchurComplement.hpp>
+
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
+#include <opm/simulators/linalg/bda/BdaBridge.hpp>
+#include <opm/simulators/linalg/bda/WellContributions.hpp>
+#endif
+
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/matrixmarket.hh>
+#include <dune/istl/operators.hh>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct Result
+{
+    double setupTime = std::numeric_limits<double>::max();
+    double applyTime = std::numeric_limits<double>::max();
+    int iterations = 0;
+    bool converged = false;
+    std::size_t operatorApplications = 0;
+};
+
+// Matrix adapter which counts the operator applications of the solver, and
+// applies the wells of the system when they are not part of the matrix.
+template <class Matrix, class Vector, class Wells>
+class CountingMatrixAdapter : public Dune::MatrixAdapter<Matrix, Vector, Vector>
+{
+    using ParentType = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+
+public:
+    using field_type = typename ParentType::field_type;
+
+    CountingMatrixAdapter(const Matrix& matrix, const Wells& wells)
+        : ParentType(matrix)
+        , wells_(wells)
+    {}
+
+    void apply(const Vector& x, Vector& y) const override
+    {
+        ++count_;
+        ParentType::apply(x, y);
+        wells_.apply(x, y);
+    }
+
+    void applyscaleadd(field_type alpha, const Vector& x, Vector& y) const override
+    {
+        ++count_;
+        ParentType::applyscaleadd(alpha, x, y);
+        if (!wells_.empty()) {
+            Ax_.resize(x.size());
+            Ax_ = 0.0;
+            wells_.apply(x, Ax_);
+            y.axpy(alpha, Ax_);
+        }
+    }
+
+    std::size_t count() const
+    { return count_; }
+
+    void resetCount()
+    { count_ = 0; }
+
+private:
+    const Wells& wells_;
+    mutable Vector Ax_;
+    mutable std::size_t count_ = 0;
+};
+
+std::string binaryFile(const std::string& prefix)
+{
+    return prefix + "system_istl.bin";
+}
+
+bool isBinary(const std::string& prefix)
+{
+    return std::ifstream(binaryFile(prefix)).good();
+}
+
+// Read the block size from the header of the binary dump, or from the header
+// written by Dune::storeMatrixMarket().
+int blockSize(const std::string& prefix)
+{
+    if (isBinary(prefix)) {
+        return Opm::BinarySystemReader(binaryFile(prefix)).header().block_size;
+    }
+    const std::string matrixFile = prefix + "matrix_istl.mm";
+    std::ifstream is(matrixFile);
+    if (!is) {
+        throw std::runtime_error("Could not read matrix file " + matrixFile);
+    }
+    std::string line;
+    while (std::getline(is, line) && !line.empty() && line[0] == '%') {
+        std::istringstream ls(line);
+        std::string percent, tag, structure;
+        int rows = 1;
+        if ((ls >> percent >> tag >> structure >> rows) && tag == "ISTL_STRUCT" && structure == "blocked") {
+            return rows;
+        }
+    }
+    return 1;
+}
+
+template <class Matrix, class Vector, class Wells>
+void readSystem(const std::string& prefix, Matrix& matrix, Vector& rhs, Wells& wells)
+{
+    if (isBinary(prefix)) {
+        const Opm::BinarySystemReader reader(binaryFile(prefix));
+        Opm::Helper::readBinarySystem(reader, matrix, rhs);
+        Opm::Helper::readBinarySystemWells(reader, wells);
+        return;
+    }
+    {
+        std::ifstream is(prefix + "matrix_istl.mm");
+        if (!is) {
+            throw std::runtime_error("Could not read matrix file " + prefix + "matrix_istl.mm");
+        }
+        Dune::readMatrixMarket(matrix, is);
+    }
+    {
+        std::ifstream is(prefix + "rhs_istl.mm");
+        if (!is) {
+            throw std::runtime_error("Could not read rhs file " + prefix + "rhs_istl.mm");
+        }
+        Dune::readMatrixMarket(rhs, is);
+    }
+}
+
+template <class Matrix, class Vector, class Wells>
+Result runFlexible(const Matrix& matrix, const Vector& rhs, const Wells& wells,
+                   const boost::property_tree::ptree& prm, const int repetitions)
+{
+    const bool transpose = prm.get<std::string>("preconditioner.type", "") == "cprt";
+    const int pressureIndex = prm.get<int>("preconditioner.pressure_var_index", 1);
+    auto weightsCalculator = [&matrix, pressureIndex, transpose]()
+    {
+        return Opm::Amg::getQuasiImpesWeights<Matrix, Vector>(matrix, pressureIndex, transpose);
+    };
+
+    Result result;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        CountingMatrixAdapter<Matrix, Vector, Wells> op(matrix, wells);
+
+        Dune::Timer setupTimer;
+        Dune::FlexibleSolver<Matrix, Vector> solver(op, prm, weightsCalculator);
+        result.setupTime = std::min(result.setupTime, setupTimer.elapsed());
+
+        Vector x(rhs.size());
+        x = 0.0;
+        Vector b(rhs);
+        Dune::InverseOperatorResult res;
+        op.resetCount();
+
+        Dune::Timer applyTimer;
+        solver.apply(x, b, res);
+        const double applyTime = applyTimer.elapsed();
+        if (applyTime < result.applyTime) {
+            result.applyTime = applyTime;
+            result.iterations = res.iterations;
+            result.converged = res.converged;
+            result.operatorApplications = op.count();
+        }
+    }
+    return result;
+}
+
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
+// Copy the packed wells in the layout of StandardWell::addWellContribution().
+template <int bz>
+void addWellContributions(const Opm::PackedWellSchurComplement<double, bz>& wells,
+                          Opm::WellContributions& wellContribs)
+{
+    const int nw = wells.empty() ? 1 : wells.numWellEq(0);
+    wellContribs.setBlockSize(bz, nw);
+    for (std::size_t well = 0; well < wells.numWells(); ++well) {
+        if (wells.numWellEq(well) != nw) {
+            throw std::runtime_error("the wells of the system have different numbers of equations");
+        }
+        wellContribs.addNumBlocks(wells.numPerforations(well));
+    }
+    wellContribs.alloc();
+
+    const int blockSize = nw * bz;
+    const int* cell = wells.cells().data();
+    const double* val = wells.values().data();
+    for (std::size_t well = 0; well < wells.numWells(); ++well) {
+        const int numPerfs = wells.numPerforations(well);
+        std::vector<int> colIndices(cell, cell + numPerfs);
+        std::vector<double> B, C;
+        for (int perf = 0; perf < numPerfs; ++perf) {
+            B.insert(B.end(), val + 2 * perf * blockSize, val + (2 * perf + 1) * blockSize);
+            C.insert(C.end(), val + (2 * perf + 1) * blockSize, val + (2 * perf + 2) * blockSize);
+        }
+        std::vector<double> invD(val + 2 * numPerfs * blockSize, val + 2 * numPerfs * blockSize + nw * nw);
+        int diagIndex = 0;
+        wellContribs.addMatrix(Opm::WellContributions::MatrixType::C, colIndices.data(), C.data(), numPerfs);
+        wellContribs.addMatrix(Opm::WellContributions::MatrixType::D, &diagIndex, invD.data(), 1);
+        wellContribs.addMatrix(Opm::WellContributions::MatrixType::B, colIndices.data(), B.data(), numPerfs);
+        cell += numPerfs;
+        val += wells.packedSize(nw, numPerfs);
+    }
+}
+
+template <class Matrix, class Vector, int bz>
+Result runBda(const Matrix& matrix, const Vector& rhs,
+              const Opm::PackedWellSchurComplement<double, bz>& wells,
+              const boost::property_tree::ptree& prm, const int repetitions)
+{
+    const std::string mode = prm.get<std::string>("accelerator_mode");
+    Opm::BdaBridge<Matrix, Vector, bz> bridge(mode,
+                                              prm.get<std::string>("fpga_bitstream", ""),
+                                              prm.get<int>("verbosity", 0),
+                                              prm.get<int>("maxit", 200),
+                                              prm.get<double>("tolerance", 1e-2),
+                                              prm.get<unsigned int>("platform_id", 0),
+                                              prm.get<unsigned int>("device_id", 0),
+                                              prm.get<std::string>("opencl_ilu_reorder", "graph_coloring"));
+    if (prm.get<bool>("cpr", false)) {
+        bridge.setCpr(prm.get<int>("pressure_var_index", 1));
+    }
+
+    // The backend analyses the matrix in the first solve and only updates
+    // the values afterwards, so the setup time is the additional time of
+    // the first solve.
+    Result result;
+    double firstSolve = 0.0;
+    for (int rep = 0; rep < std::max(repetitions, 2); ++rep) {
+        Matrix A(matrix);
+        Vector b(rhs);
+        Vector x(rhs.size());
+        Opm::WellContributions wellContribs(mode);
+        bridge.initWellContributions(wellContribs);
+        addWellContributions(wells, wellContribs);
+        Dune::InverseOperatorResult res;
+
+        Dune::Timer timer;
+        bridge.solve_system(&A, b, wellContribs, res);
+        bridge.get_result(x);
+        const double time = timer.elapsed();
+        if (rep == 0) {
+            firstSolve = time;
+            continue;
+        }
+        if (time < result.applyTime) {
+            result.applyTime = time;
+            result.iterations = res.iterations;
+            result.converged = res.converged;
+            result.operatorApplications = 2 * res.iterations; // BiCGStab
+        }
+    }
+    result.setupTime = std::max(firstSolve - result.applyTime, 0.0);
+    return result;
+}
+#endif
+
+template <int bz>
+int benchmark(const boost::property_tree::ptree& configurations,
+              const std::string& prefix, const int repetitions)
+{
+    using Matrix = Dune::BCRSMatrix<Opm::MatrixBlock<double, bz, bz>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+    using Wells = Opm::PackedWellSchurComplement<double, bz>;
+
+    Matrix matrix;
+    Vector rhs;
+    Wells wells;
+    readSystem(prefix, matrix, rhs, wells);
+
+    // bytes streamed by one matrix-vector product: the blocks, their column
+    // indices, the row pointers, the packed wells, and reading x and updating y
+    const double bytesPerOperator = matrix.nonzeroes() * (sizeof(double) * bz * bz + sizeof(std::size_t))
+        + matrix.N() * (sizeof(std::size_t) + 3 * sizeof(double) * bz)
+        + wells.values().size() * sizeof(double) + wells.cells().size() * sizeof(int);
+
+    std::cout << "System " << prefix << ": " << matrix.N() << " rows of " << bz << "x" << bz
+              << " blocks, " << matrix.nonzeroes() << " nonzero blocks, "
+              << wells.numWells() << " wells\n\n"
+              << std::left << std::setw(24) << "configuration" << std::right
+              << std::setw(12) << "setup [s]" << std::setw(12) << "apply [s]"
+              << std::setw(8) << "iter" << std::setw(11) << "converged" << std::setw(10) << "GB/s" << '\n';
+
+    int failures = 0;
+    for (const auto& [key, configuration] : configurations) {
+        const std::string name = configuration.get<std::string>("name", "unnamed");
+        try {
+            Result result;
+            if (const auto flexible = configuration.get_child_optional("flexible")) {
+                result = runFlexible(matrix, rhs, wells, *flexible, repetitions);
+            } else if (const auto bda = configuration.get_child_optional("bda")) {
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
+                result = runBda<Matrix, Vector, bz>(matrix, rhs, wells, *bda, repetitions);
+#else
+                throw std::runtime_error("not built with CUDA, OpenCL or FPGA support");
+#endif
+            } else {
+                throw std::runtime_error("neither \"flexible\" nor \"bda\" is given");
+            }
+
+            const double bandwidth = result.applyTime > 0.0
+                ? result.operatorApplications * bytesPerOperator / result.applyTime * 1e-9
+                : 0.0;
+            std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+                      << std::setw(12) << std::setprecision(4) << result.setupTime
+                      << std::setw(12) << std::setprecision(4) << result.applyTime
+                      << std::setw(8) << result.iterations
+                      << std::setw(11) << (result.converged ? "yes" : "no")
+                      << std::setw(10) << std::setprecision(2) << bandwidth << '\n';
+        } catch (const std::exception& e) {
+            std::cout << std::left << std::setw(24) << name << " failed: " << e.what() << '\n';
+            ++failures;
+        }
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <configurations.json> <system prefix> [repetitions]\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        boost::property_tree::ptree prm;
+        boost::property_tree::read_json(argv[1], prm);
+        const auto& configurations = prm.get_child("configurations");
+        const std::string prefix = argv[2];
+        const int repetitions = argc > 3 ? std::max(std::stoi(argv[3]), 1) : 3;
+
+        switch (blockSize(prefix)) {
+        case 1: return benchmark<1>(configurations, prefix, repetitions);
+        case 2: return benchmark<2>(configurations, prefix, repetitions);
+        case 3: return benchmark<3>(configurations, prefix, repetitions);
+        case 4: return benchmark<4>(configurations, prefix, repetitions);
+        default:
+            std::cerr << "Unsupported block size of the matrix\n";
+            return EXIT_FAILURE;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
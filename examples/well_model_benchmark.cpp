@@ -0,0 +1,523 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Benchmark of the well model on synthetic decks with many wells.
+//
+// Usage: well_model_benchmark [--well-benchmark-standard-wells=N]
+//                             [--well-benchmark-multisegment-wells=N]
+//                             [--well-benchmark-group-depth=N]
+//                             [--well-benchmark-vfp=true] [--well-benchmark-gas-lift=true]
+//                             [--well-benchmark-repetitions=N] [flow parameters]
+//
+// A deck is generated to WELL_BENCHMARK.DATA in the current directory. Every
+// well is vertical and perforates all layers of its own column of a box grid.
+// Every fourth standard well is a water injector, the other wells produce at
+// an oil rate target. The wells are spread over the leaf groups of a binary
+// group tree of the given depth, which have oil rate targets below the sum
+// of the targets of their wells, such that the group controls are active.
+// With VFP, the producers are also limited by a THP through a common VFPPROD
+// table. Gas lift optimisation of the standard producers adds an ALQ axis to
+// the table, and therefore implies VFP.
+//
+// The deck is initialised for its first time step, and the following functions
+// of BlackoilWellModel are timed in isolation, from the same well state in each
+// repetition: assemble() (through beginIteration(), beyond the first Newton
+// iteration), updateWellControls(), apply() of the Schur complement, and
+// recoverWellSolutionAndUpdateWellState() (through postSolve()). The fastest
+// repetition is reported.
+
+#include <config.h>
+
+#include <opm/simulators/flow/BlackoilModelEbos.hpp>
+#include <opm/simulators/flow/BlackoilModelParametersEbos.hpp>
+#include <opm/simulators/utils/DeferredLogger.hpp>
+
+#include <opm/models/utils/start.hh>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#else
+#include <dune/common/parallel/mpihelper.hh>
+#endif
+
+#include <dune/common/timer.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm::Properties {
+
+template<class TypeTag, class MyTypeTag>
+struct WellBenchmarkStandardWells {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct WellBenchmarkMultisegmentWells {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct WellBenchmarkGroupDepth {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct WellBenchmarkVfp {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct WellBenchmarkGasLift {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct WellBenchmarkRepetitions {
+    using type = UndefinedProperty;
+};
+
+template<class TypeTag>
+struct WellBenchmarkStandardWells<TypeTag, TTag::EclFlowProblem> {
+    static constexpr int value = 100;
+};
+template<class TypeTag>
+struct WellBenchmarkMultisegmentWells<TypeTag, TTag::EclFlowProblem> {
+    static constexpr int value = 10;
+};
+template<class TypeTag>
+struct WellBenchmarkGroupDepth<TypeTag, TTag::EclFlowProblem> {
+    static constexpr int value = 2;
+};
+template<class TypeTag>
+struct WellBenchmarkVfp<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct WellBenchmarkGasLift<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct WellBenchmarkRepetitions<TypeTag, TTag::EclFlowProblem> {
+    static constexpr int value = 10;
+};
+
+} // namespace Opm::Properties
+
+namespace
+{
+
+using TypeTag = Opm::Properties::TTag::EclFlowProblem;
+using Simulator = Opm::GetPropType<TypeTag, Opm::Properties::Simulator>;
+using GlobalEqVector = Opm::GetPropType<TypeTag, Opm::Properties::GlobalEqVector>;
+using WellModel = Opm::BlackoilWellModel<TypeTag>;
+
+const std::string deckFileName = "WELL_BENCHMARK.DATA";
+
+struct DeckOptions
+{
+    int standardWells = 0;
+    int multisegmentWells = 0;
+    int groupDepth = 1;
+    bool vfp = false;
+    bool gasLift = false;
+};
+
+constexpr int numLayers = 5;
+constexpr double topDepth = 2000.0;
+constexpr double layerThickness = 10.0;
+constexpr double oilRateTarget = 200.0;
+
+struct Well
+{
+    std::string name;
+    int i;
+    int j;
+    std::string group;
+    bool injector;
+    bool multisegment;
+};
+
+void writeVfpTable(std::ostream& os, const bool gasLift)
+{
+    const std::vector<double> flows { 10.0, 100.0, 500.0, 1000.0, 2000.0 };
+    const std::vector<double> thps { 10.0, 30.0 };
+    const std::vector<double> wcts { 0.0, 0.5 };
+    const std::vector<double> gors { 50.0, 500.0 };
+    const std::vector<double> alqs = gasLift ? std::vector<double>{ 0.0, 100000.0 }
+                                             : std::vector<double>{ 0.0 };
+
+    os << "VFPPROD\n"
+       << " 1 " << topDepth << " 'LIQ' 'WCT' 'GOR' 'THP' " << (gasLift ? "'GRAT'" : "1*")
+       << " 'METRIC' 'BHP' /\n";
+    for (const auto* axis : { &flows, &thps, &wcts, &gors, &alqs }) {
+        for (const double value : *axis)
+            os << ' ' << value;
+        os << " /\n";
+    }
+    // the lift reduces the bottom hole pressure, the friction increases it
+    for (std::size_t t = 0; t < thps.size(); ++t) {
+        for (std::size_t w = 0; w < wcts.size(); ++w) {
+            for (std::size_t g = 0; g < gors.size(); ++g) {
+                for (std::size_t a = 0; a < alqs.size(); ++a) {
+                    os << ' ' << t + 1 << ' ' << w + 1 << ' ' << g + 1 << ' ' << a + 1;
+                    for (const double flow : flows) {
+                        const double bhp = thps[t] + 150.0 * (1.0 + 0.2 * wcts[w] - 0.0001 * gors[g])
+                            * (1.0 - 1.5e-6 * alqs[a]) + 0.02 * flow;
+                        os << ' ' << bhp;
+                    }
+                    os << " /\n";
+                }
+            }
+        }
+    }
+    os << '\n';
+}
+
+void writeSyntheticDeck(const std::string& fileName, const DeckOptions& options)
+{
+    const int numWells = options.standardWells + options.multisegmentWells;
+    if (numWells < 1) {
+        throw std::invalid_argument("The synthetic deck needs at least one well");
+    }
+
+    // every well in its own column, with an empty column in between
+    const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(numWells))));
+    const int nx = 2 * columns;
+    const int ny = 2 * columns;
+    const int numCells = nx * ny * numLayers;
+
+    // binary group tree, the groups are numbered as a heap with FIELD as 1
+    const int depth = std::max(options.groupDepth, 1);
+    const int firstLeaf = 1 << depth;
+    const int numGroups = 2 * firstLeaf - 2;
+    const auto groupName = [](const int idx)
+    {
+        return idx == 1 ? std::string("FIELD") : "G" + std::to_string(idx);
+    };
+
+    std::vector<Well> wells;
+    std::vector<int> producersInGroup(2 * firstLeaf, 0);
+    std::vector<int> wellsInGroup(2 * firstLeaf, 0);
+    for (int w = 0; w < numWells; ++w) {
+        Well well;
+        well.multisegment = w >= options.standardWells;
+        well.injector = !well.multisegment && w % 4 == 3;
+        well.name = (well.multisegment ? "M" : (well.injector ? "I" : "P")) + std::to_string(w + 1);
+        well.i = 2 * (w % columns) + 1;
+        well.j = 2 * (w / columns) + 1;
+        const int leaf = firstLeaf + w % firstLeaf;
+        well.group = groupName(leaf);
+        ++wellsInGroup[leaf];
+        if (!well.injector)
+            ++producersInGroup[leaf];
+        wells.push_back(well);
+    }
+    const int maxWellsInGroup = *std::max_element(wellsInGroup.begin(), wellsInGroup.end());
+
+    std::ofstream os(fileName);
+    if (!os) {
+        throw std::runtime_error("Could not write " + fileName);
+    }
+
+    os << "-- Synthetic deck of well_model_benchmark with " << options.standardWells
+       << " standard and " << options.multisegmentWells << " multisegment wells\n\n"
+       << "RUNSPEC\n\n"
+       << "DIMENS\n " << nx << ' ' << ny << ' ' << numLayers << " /\n\n"
+       << "OIL\nWATER\nGAS\n\nMETRIC\n\n"
+       << "START\n 1 'JAN' 2020 /\n\n"
+       << "EQLDIMS\n 1 /\n\n"
+       << "TABDIMS\n 1 1 20 20 /\n\n"
+       << "WELLDIMS\n " << numWells << ' ' << numLayers << ' ' << numGroups + 1 << ' '
+       << std::max(maxWellsInGroup, 2) << " /\n\n";
+    if (options.multisegmentWells > 0) {
+        os << "WSEGDIMS\n " << options.multisegmentWells << ' ' << numLayers + 1 << " 1 /\n\n";
+    }
+    if (options.vfp) {
+        os << "VFPPDIMS\n 5 2 2 2 2 1 /\n\n";
+    }
+    os << "UNIFOUT\n\n";
+
+    os << "GRID\n\n"
+       << "DX\n " << numCells << "*100 /\n"
+       << "DY\n " << numCells << "*100 /\n"
+       << "DZ\n " << numCells << '*' << layerThickness << " /\n"
+       << "TOPS\n " << nx * ny << '*' << topDepth << " /\n"
+       << "PORO\n " << numCells << "*0.25 /\n"
+       << "PERMX\n " << numCells << "*200 /\n"
+       << "PERMY\n " << numCells << "*200 /\n"
+       << "PERMZ\n " << numCells << "*20 /\n\n";
+
+    os << "PROPS\n\n"
+       << "SWOF\n"
+       << " 0.2 0.0 1.0 0.0\n 0.5 0.2 0.3 0.0\n 1.0 1.0 0.0 0.0 /\n\n"
+       << "SGOF\n"
+       << " 0.0 0.0 1.0 0.0\n 0.4 0.3 0.1 0.0\n 0.8 1.0 0.0 0.0 /\n\n"
+       << "PVDO\n"
+       << " 50 1.20 1.0\n 200 1.15 1.1\n 400 1.10 1.2 /\n\n"
+       << "PVDG\n"
+       << " 50 0.020 0.015\n 200 0.005 0.020\n 400 0.003 0.025 /\n\n"
+       << "PVTW\n 200 1.02 4.0E-5 0.4 0.0 /\n\n"
+       << "DENSITY\n 850 1030 0.9 /\n\n"
+       << "ROCK\n 200 4.0E-5 /\n\n";
+
+    os << "SOLUTION\n\n"
+       << "EQUIL\n " << topDepth << " 200 " << topDepth + 2 * numLayers * layerThickness
+       << " 0 " << topDepth - 100.0 << " 0 /\n\n";
+
+    os << "SCHEDULE\n\n";
+    os << "GRUPTREE\n";
+    for (int idx = 2; idx < 2 * firstLeaf; ++idx)
+        os << " '" << groupName(idx) << "' '" << groupName(idx / 2) << "' /\n";
+    os << "/\n\n";
+
+    if (options.vfp || options.gasLift) {
+        writeVfpTable(os, options.gasLift);
+    }
+
+    os << "WELSPECS\n";
+    for (const auto& well : wells)
+        os << " '" << well.name << "' '" << well.group << "' " << well.i << ' ' << well.j
+           << ' ' << topDepth << " '" << (well.injector ? "WATER" : "OIL") << "' /\n";
+    os << "/\n\n";
+
+    os << "COMPDAT\n";
+    for (const auto& well : wells)
+        os << " '" << well.name << "' " << well.i << ' ' << well.j << " 1 " << numLayers
+           << " 'OPEN' 2* 0.2 /\n";
+    os << "/\n\n";
+
+    for (const auto& well : wells) {
+        if (!well.multisegment)
+            continue;
+        os << "WELSEGS\n"
+           << " '" << well.name << "' " << topDepth << ' ' << topDepth << " 1.0E-5 'ABS' 'HFA' 'HO' /\n";
+        for (int seg = 2; seg <= numLayers + 1; ++seg) {
+            const double length = topDepth + (seg - 1) * layerThickness;
+            os << ' ' << seg << ' ' << seg << " 1 " << seg - 1 << ' ' << length << ' ' << length
+               << " 0.1 1.0E-4 /\n";
+        }
+        os << "/\n\n"
+           << "COMPSEGS\n '" << well.name << "' /\n";
+        for (int k = 1; k <= numLayers; ++k)
+            os << ' ' << well.i << ' ' << well.j << ' ' << k << " 1 "
+               << topDepth + (k - 1) * layerThickness << ' ' << topDepth + k * layerThickness << " /\n";
+        os << "/\n\n";
+    }
+
+    os << "GCONPROD\n";
+    for (int leaf = firstLeaf; leaf < 2 * firstLeaf; ++leaf) {
+        if (producersInGroup[leaf] > 0)
+            os << " '" << groupName(leaf) << "' 'ORAT' " << 0.8 * oilRateTarget * producersInGroup[leaf] << " /\n";
+    }
+    os << "/\n\n";
+
+    os << "WCONPROD\n";
+    for (const auto& well : wells) {
+        if (well.injector)
+            continue;
+        os << " '" << well.name << "' 'OPEN' 'ORAT' " << oilRateTarget << " 4* 50";
+        if (options.vfp || options.gasLift)
+            os << " 20 1";
+        os << " /\n";
+    }
+    os << "/\n\n";
+
+    if (options.standardWells > 3) {
+        os << "GCONINJE\n 'FIELD' 'WATER' 'VREP' 3* 1.0 'NO' /\n/\n\n"
+           << "WCONINJE\n";
+        for (const auto& well : wells) {
+            if (well.injector)
+                os << " '" << well.name << "' 'WATER' 'OPEN' 'GRUP' 1000 1* 400 /\n";
+        }
+        os << "/\n\n";
+    }
+
+    if (options.gasLift) {
+        os << "LIFTOPT\n 12500 5E-3 0.0 YES /\n\n"
+           << "WLIFTOPT\n";
+        for (const auto& well : wells) {
+            if (!well.injector && !well.multisegment)
+                os << " '" << well.name << "' YES 150000 1.01 -1.0 /\n";
+        }
+        os << "/\n\n";
+    }
+
+    os << "TSTEP\n 1 /\n\nEND\n";
+    if (!os) {
+        throw std::runtime_error("Could not write " + fileName);
+    }
+}
+
+// The fastest of a number of runs of a function, prepare() is called before
+// each run and is not timed.
+template <class Prepare, class Function>
+double bestTime(const int repetitions, const Prepare& prepare, const Function& function)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int rep = 0; rep < repetitions; ++rep) {
+        prepare();
+        Dune::Timer timer;
+        function();
+        best = std::min(best, timer.elapsed());
+    }
+    return best;
+}
+
+std::unique_ptr<Simulator> initSimulator()
+{
+    auto simulator = std::make_unique<Simulator>();
+    simulator->model().applyInitialSolution();
+
+    const auto& schedule = simulator->vanguard().schedule();
+    simulator->setEpisodeIndex(-1);
+    simulator->setEpisodeLength(0.0);
+    simulator->startNextEpisode(simulator->startTime(), schedule.stepLength(0));
+    simulator->setEpisodeIndex(0);
+    simulator->problem().beginEpisode();
+
+    simulator->setTimeStepSize(schedule.stepLength(0));
+    simulator->model().newtonMethod().setIterationIndex(0);
+    simulator->problem().beginTimeStep();
+    return simulator;
+}
+
+int benchmark(Simulator& simulator, const int repetitions)
+{
+    auto& wellModel = simulator.problem().wellModel();
+
+    // the first iteration computes the explicit quantities of the time step,
+    // the state after it is restored before each timed run
+    wellModel.beginIteration();
+    wellModel.commitWGState();
+    simulator.model().newtonMethod().setIterationIndex(1);
+    const auto reset = [&wellModel]() { wellModel.resetWGState(); };
+
+    const double assembleTime = bestTime(repetitions, reset, [&wellModel]()
+    {
+        wellModel.beginIteration();
+    });
+
+    const double controlsTime = bestTime(repetitions, reset, [&wellModel]()
+    {
+        Opm::DeferredLogger logger;
+        wellModel.updateWellControls(logger, /*checkGroupControls=*/true);
+    });
+
+    // apply() and the recovery use the assembled well equations
+    reset();
+    wellModel.beginIteration();
+
+    const std::size_t numCells = simulator.model().numGridDof();
+    typename WellModel::BVector x(numCells);
+    typename WellModel::BVector Ax(numCells);
+    x = 1.0;
+    const double applyTime = bestTime(repetitions, [&Ax]() { Ax = 0.0; }, [&wellModel, &x, &Ax]()
+    {
+        wellModel.apply(x, Ax);
+    });
+
+    GlobalEqVector dx(numCells);
+    const double recoverTime = bestTime(repetitions, [&reset, &dx]() { reset(); dx = 0.0; },
+                                        [&wellModel, &dx]()
+    {
+        wellModel.postSolve(dx);
+    });
+
+    const auto numWells = simulator.vanguard().schedule().getWells(0).size();
+    std::cout << "Case " << simulator.vanguard().caseName() << ": " << numWells << " wells, "
+              << numCells << " cells, " << repetitions << " repetitions\n\n"
+              << std::left << std::setw(40) << "function" << std::right
+              << std::setw(12) << "time [s]" << std::setw(16) << "wells/s" << '\n';
+    const auto print = [numWells](const std::string& name, const double time)
+    {
+        std::cout << std::left << std::setw(40) << name << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(6) << time
+                  << std::setw(16) << std::setprecision(0) << (time > 0.0 ? numWells / time : 0.0)
+                  << '\n';
+    };
+    print("assemble", assembleTime);
+    print("updateWellControls", controlsTime);
+    print("apply", applyTime);
+    print("recoverWellSolutionAndUpdateWellState", recoverTime);
+    return EXIT_SUCCESS;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    try {
+        Opm::registerAllParameters_<TypeTag>(/*finalizeRegistration=*/false);
+        Opm::BlackoilModelParametersEbos<TypeTag>::registerParameters();
+        EWOMS_REGISTER_PARAM(TypeTag, int, WellBenchmarkStandardWells,
+                             "The number of standard wells of the synthetic deck");
+        EWOMS_REGISTER_PARAM(TypeTag, int, WellBenchmarkMultisegmentWells,
+                             "The number of multisegment wells of the synthetic deck");
+        EWOMS_REGISTER_PARAM(TypeTag, int, WellBenchmarkGroupDepth,
+                             "The depth of the binary group tree of the synthetic deck");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, WellBenchmarkVfp,
+                             "Limit the producers of the synthetic deck by a THP through a VFP table");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, WellBenchmarkGasLift,
+                             "Optimise the gas lift of the standard producers of the synthetic deck");
+        EWOMS_REGISTER_PARAM(TypeTag, int, WellBenchmarkRepetitions,
+                             "The number of times each function of the well model is run");
+        EWOMS_END_PARAM_REGISTRATION(TypeTag);
+
+        // the deck is always the synthetic one
+        std::vector<const char*> args(argv, argv + argc);
+        const std::string deckArg = "--ecl-deck-file-name=" + deckFileName;
+        args.push_back(deckArg.c_str());
+        const int status = Opm::setupParameters_<TypeTag>(args.size(), args.data(),
+                                                          /*registerParams=*/false);
+        if (status != 0) {
+            return status < 0 ? EXIT_SUCCESS : status;
+        }
+
+        DeckOptions options;
+        options.standardWells = EWOMS_GET_PARAM(TypeTag, int, WellBenchmarkStandardWells);
+        options.multisegmentWells = EWOMS_GET_PARAM(TypeTag, int, WellBenchmarkMultisegmentWells);
+        options.groupDepth = EWOMS_GET_PARAM(TypeTag, int, WellBenchmarkGroupDepth);
+        options.vfp = EWOMS_GET_PARAM(TypeTag, bool, WellBenchmarkVfp);
+        options.gasLift = EWOMS_GET_PARAM(TypeTag, bool, WellBenchmarkGasLift);
+        const int repetitions = std::max(EWOMS_GET_PARAM(TypeTag, int, WellBenchmarkRepetitions), 1);
+
+        const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+        if (comm.rank() == 0) {
+            writeSyntheticDeck(deckFileName, options);
+        }
+        comm.barrier();
+
+        auto simulator = initSimulator();
+        return benchmark(*simulator, repetitions);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
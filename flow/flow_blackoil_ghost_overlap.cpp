@@ -0,0 +1,47 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+
+#include <opm/simulators/flow/Main.hpp>
+
+// The blackoil simulator for parallel runs at many processes, where the
+// overlap cells are only ghost values of the interior rows: their own
+// equations are not assembled, and the linear solver replaces their rows by
+// the identity for every preconditioner.
+namespace Opm::Properties {
+
+namespace TTag {
+struct EclFlowProblemGhostOverlap {
+    using InheritsFrom = std::tuple<EclFlowProblem>;
+};
+}
+
+template<class TypeTag>
+struct LinearizeNonLocalElements<TypeTag, TTag::EclFlowProblemGhostOverlap> {
+    static constexpr bool value = false;
+};
+
+} // namespace Opm::Properties
+
+int main(int argc, char** argv)
+{
+    using TypeTag = Opm::Properties::TTag::EclFlowProblemGhostOverlap;
+    auto mainObject = Opm::Main(argc, argv);
+    return mainObject.runStatic<TypeTag>();
+}
@@ -0,0 +1,49 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+
+// The entry point of the blackoil modules libflow_blackoil_<isa>.so, which
+// contain the blackoil simulator compiled for an instruction set extension.
+// They are compiled with hidden visibility, such that the template instances
+// of a module never replace those of the executable or of another module.
+
+#include <flow/flow_ebos_blackoil.hpp>
+#include <flow/flow_isa_dispatch.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
+
+#include <memory>
+
+extern "C" __attribute__((visibility("default")))
+int flowEbosBlackoilIsaMain(int argc, char** argv, bool outputCout, bool outputFiles,
+                            double setupTime, Opm::Deck* deck, Opm::EclipseState* eclState,
+                            Opm::Schedule* schedule, Opm::SummaryConfig* summaryConfig)
+{
+    // make sure that the entry point matches the type the executable expects
+    [[maybe_unused]] Opm::FlowBlackoilIsaMain self = &flowEbosBlackoilIsaMain;
+
+    Opm::flowEbosBlackoilSetDeck(setupTime, std::unique_ptr<Opm::Deck>(deck),
+                                 std::unique_ptr<Opm::EclipseState>(eclState),
+                                 std::unique_ptr<Opm::Schedule>(schedule),
+                                 std::unique_ptr<Opm::SummaryConfig>(summaryConfig));
+    return Opm::flowEbosBlackoilMain(argc, argv, outputCout, outputFiles);
+}
@@ -0,0 +1,97 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "config.h"
+
+#include <flow/flow_isa_dispatch.hpp>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include <climits>
+#include <cstdlib>
+
+namespace Opm {
+
+std::vector<std::string> supportedFlowIsaVariants()
+{
+    std::vector<std::string> variants;
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") &&
+        __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq")) {
+        variants.push_back("avx512");
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        variants.push_back("avx2");
+    }
+#endif
+    return variants;
+}
+
+namespace {
+
+// The directory of the running executable, with a trailing slash. Empty if it
+// cannot be determined, dlopen() searches the library path then.
+std::string executableDirectory()
+{
+    char path[PATH_MAX];
+    const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0) {
+        return {};
+    }
+    const std::string exe(path, length);
+    const auto slash = exe.rfind('/');
+    return slash == std::string::npos ? std::string{} : exe.substr(0, slash + 1);
+}
+
+}
+
+FlowBlackoilIsaMain loadFlowBlackoilIsaVariant(std::string& isaName)
+{
+    const char* requested = std::getenv("OPM_FLOW_ISA");
+    const std::string only = requested ? requested : "";
+    if (only == "generic") {
+        return nullptr;
+    }
+
+    const std::string directory = executableDirectory();
+    for (const auto& isa : supportedFlowIsaVariants()) {
+        if (!only.empty() && only != isa) {
+            continue;
+        }
+        const std::string library = directory + "libflow_blackoil_" + isa + ".so";
+        // the module keeps its own instances of the simulator templates
+        void* handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!handle) {
+            continue;
+        }
+        auto entry = reinterpret_cast<FlowBlackoilIsaMain>(dlsym(handle, "flowEbosBlackoilIsaMain"));
+        if (!entry) {
+            dlclose(handle);
+            continue;
+        }
+        // the module is never unloaded, the simulator may leave static objects behind
+        isaName = isa;
+        return entry;
+    }
+    return nullptr;
+}
+
+}
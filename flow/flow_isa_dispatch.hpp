@@ -0,0 +1,55 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef FLOW_ISA_DISPATCH_HPP
+#define FLOW_ISA_DISPATCH_HPP
+
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+class Deck;
+class EclipseState;
+class Schedule;
+class SummaryConfig;
+
+//! \brief The entry point of a blackoil module built for an instruction set
+//!        extension, see flow_ebos_blackoil_isa.cpp. It takes the ownership
+//!        of the parsed input.
+using FlowBlackoilIsaMain = int (*)(int argc, char** argv, bool outputCout, bool outputFiles,
+                                    double setupTime, Deck* deck, EclipseState* eclState,
+                                    Schedule* schedule, SummaryConfig* summaryConfig);
+
+//! \brief The instruction set extensions that the CPU supports and for which
+//!        flow has blackoil modules, best first.
+std::vector<std::string> supportedFlowIsaVariants();
+
+//! \brief Load the blackoil module for the best instruction set extension the
+//!        CPU supports, libflow_blackoil_<isa>.so in the directory of the
+//!        executable.
+//!
+//! The environment variable OPM_FLOW_ISA restricts the choice: "generic" never
+//! loads a module, e.g. "avx2" loads that one only. Returns nullptr if no module
+//! is loaded, the code of the executable itself is used then.
+//! \param isaName Set to the extension of the loaded module.
+FlowBlackoilIsaMain loadFlowBlackoilIsaVariant(std::string& isaName);
+
+}
+
+#endif // FLOW_ISA_DISPATCH_HPP
@@ -8,6 +8,9 @@ set (opm-simulators_CONFIG_VAR
   HAVE_CUDA
   HAVE_OPENCL
   HAVE_FPGA
+  HAVE_AMGX
+  HAVE_TRACING
+  HAVE_PERF_COUNTERS
   HAVE_SUITESPARSE_UMFPACK_H
   HAVE_DUNE_ISTL
   DUNE_ISTL_VERSION_MAJOR
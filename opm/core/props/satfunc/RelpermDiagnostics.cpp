@@ -39,6 +39,10 @@
 #include <opm/grid/CpGrid.hpp>
 #include <opm/grid/polyhedralgrid.hh>
 
+#include <array>
+#include <string>
+#include <vector>
+
 namespace Opm{
 
     bool RelpermDiagnostics::phaseCheck_(const EclipseState& es)
@@ -753,8 +757,50 @@ namespace Opm{
         const bool threepoint = eclState.runspec().endpointScaling().threepoint();
         scaledEpsInfo_.resize(nc);
         EclEpsGridProperties epsGridProperties(eclState, false);
+
+        // The end points of the cells are independent, extract and check them
+        // in parallel and format the messages afterwards for the few cells
+        // which fail a check, in the order of the cells.
+        enum Failure : unsigned char {
+            SguExceeded = 1,
+            SglExceeded = 2,
+            OilWaterImmobile = 4,
+            OilGasImmobile = 8
+        };
+        const bool checkMobility = threepoint && fluidSystem_ == FluidSystem::BlackOil;
+        std::vector<unsigned char> failures(nc, 0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int c = 0; c < nc; ++c) {
+            auto& info = scaledEpsInfo_[c];
+            info.extractScaled(eclState, epsGridProperties, c);
+
+            unsigned char failed = 0;
+            // SGU <= 1.0 - SWL
+            if (info.Sgu > (1.0 - info.Swl + tolerance))
+                failed |= SguExceeded;
+
+            // SGL <= 1.0 - SWU
+            if (info.Sgl > (1.0 - info.Swu + tolerance))
+                failed |= SglExceeded;
+
+            if (checkMobility) {
+                // Mobilility check.
+                if ((info.Sowcr + info.Swcr) >= (1.0 + tolerance))
+                    failed |= OilWaterImmobile;
+
+                if ((info.Sogcr + info.Sgcr + info.Swl) >= (1.0 + tolerance))
+                    failed |= OilGasImmobile;
+            }
+            failures[c] = failed;
+        }
+
         const std::string tag = "Scaled endpoints";
         for (int c = 0; c < nc; ++c) {
+            if (failures[c] == 0)
+                continue;
+
             const std::string satnumIdx = std::to_string(epsGridProperties.satRegion(c));
             std::string cellIdx;
             {
@@ -764,32 +810,19 @@ namespace Opm{
                     std::to_string(ijk[1]) + ", " +
                     std::to_string(ijk[2]) + ")";
             }
-            scaledEpsInfo_[c].extractScaled(eclState, epsGridProperties, c);
+            const std::string prefix = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx;
 
-            // SGU <= 1.0 - SWL
-            if (scaledEpsInfo_[c].Sgu > (1.0 - scaledEpsInfo_[c].Swl + tolerance)) {
-                const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SGU exceed 1.0 - SWL";
-                OpmLog::warning(tag, msg);
-            }
+            if (failures[c] & SguExceeded)
+                OpmLog::warning(tag, prefix + ", SGU exceed 1.0 - SWL");
 
-            // SGL <= 1.0 - SWU
-            if (scaledEpsInfo_[c].Sgl > (1.0 - scaledEpsInfo_[c].Swu + tolerance)) {
-                const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SGL exceed 1.0 - SWU";
-                OpmLog::warning(tag, msg);
-            }
+            if (failures[c] & SglExceeded)
+                OpmLog::warning(tag, prefix + ", SGL exceed 1.0 - SWU");
 
-            if (threepoint && fluidSystem_ == FluidSystem::BlackOil) {
-                // Mobilility check.
-                if ((scaledEpsInfo_[c].Sowcr + scaledEpsInfo_[c].Swcr) >= (1.0 + tolerance)) {
-                    const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SOWCR + SWCR exceed 1.0";
-                    OpmLog::warning(tag, msg);
-                }
-
-            if ((scaledEpsInfo_[c].Sogcr + scaledEpsInfo_[c].Sgcr + scaledEpsInfo_[c].Swl) >= (1.0 + tolerance)) {
-                    const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SOGCR + SGCR + SWL exceed 1.0";
-                    OpmLog::warning(tag, msg);
-                }
-            }
+            if (failures[c] & OilWaterImmobile)
+                OpmLog::warning(tag, prefix + ", SOWCR + SWCR exceed 1.0");
+
+            if (failures[c] & OilGasImmobile)
+                OpmLog::warning(tag, prefix + ", SOGCR + SGCR + SWL exceed 1.0");
         }
     }
 
@@ -26,6 +26,7 @@
 #include <opm/output/data/Aquifer.hpp>
 
 #include <exception>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <utility>
@@ -101,6 +102,13 @@ protected:
     Scalar dimensionless_time_{0};
     Scalar dimensionless_pressure_{0};
 
+    // The influence table terms of Eqs 5.8 and 5.9 are the same for all connections,
+    // they are evaluated once for the time and time step size stored here.
+    Scalar coeff_time_{std::numeric_limits<Scalar>::quiet_NaN()};
+    Scalar coeff_dt_{std::numeric_limits<Scalar>::quiet_NaN()};
+    Scalar PItdprime_{0};
+    Scalar eqn_denom_{1};
+
     void assignRestartData(const data::AquiferData& /* xaq */) override
     {
         throw std::runtime_error {"Restart-based initialization not currently supported "
@@ -135,18 +143,33 @@ protected:
         return dp;
     }
 
+    void updateInfluenceTerms(const Simulator& simulator)
+    {
+        const Scalar time = simulator.time();
+        const Scalar dt = simulator.timeStepSize();
+        if (time == this->coeff_time_ && dt == this->coeff_dt_) {
+            return;
+        }
+        this->coeff_time_ = time;
+        this->coeff_dt_ = dt;
+
+        const Scalar td_plus_dt = (dt + time) / this->Tc_;
+        this->dimensionless_time_ = time / this->Tc_;
+
+        const auto [PItd, PItdprime] = this->getInfluenceTableValues(td_plus_dt);
+
+        this->PItdprime_ = PItdprime;
+        this->eqn_denom_ = this->Tc_ * (PItd - this->dimensionless_time_*PItdprime);
+    }
+
     // This function implements Eqs 5.8 and 5.9 of the EclipseTechnicalDescription
     std::pair<Scalar, Scalar>
     calculateEqnConstants(const int idx, const Simulator& simulator)
     {
-        const Scalar td_plus_dt = (simulator.timeStepSize() + simulator.time()) / this->Tc_;
-        this->dimensionless_time_ = simulator.time() / this->Tc_;
-
-        const auto [PItd, PItdprime] = this->getInfluenceTableValues(td_plus_dt);
+        this->updateInfluenceTerms(simulator);
 
-        const auto denom = this->Tc_ * (PItd - this->dimensionless_time_*PItdprime);
-        const auto a = (this->beta_*dpai(idx) - this->fluxValue_*PItdprime) / denom;
-        const auto b = this->beta_ / denom;
+        const auto a = (this->beta_*dpai(idx) - this->fluxValue_*this->PItdprime_) / this->eqn_denom_;
+        const auto b = this->beta_ / this->eqn_denom_;
 
         return std::make_pair(a, b);
     }
@@ -26,6 +26,7 @@ along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 #include <opm/output/data/Aquifer.hpp>
 
 #include <exception>
+#include <limits>
 #include <stdexcept>
 
 namespace Opm
@@ -94,6 +95,10 @@ protected:
     const Aquifetp::AQUFETP_data aqufetp_data_;
     Scalar aquifer_pressure_; // aquifer
 
+    // the time step factor of Eq 5.14, evaluated once for the time step size coef_dt_
+    Scalar coef_dt_{std::numeric_limits<Scalar>::quiet_NaN()};
+    Scalar coef_{0};
+
     void assignRestartData(const data::AquiferData& xaq) override
     {
         if (xaq.type != data::AquiferType::Fetkovich) {
@@ -130,9 +135,13 @@ protected:
     // This function implements Eq 5.14 of the EclipseTechnicalDescription
     inline void calculateInflowRate(int idx, const Simulator& simulator) override
     {
-        const Scalar td_Tc_ = simulator.timeStepSize() / this->Tc_;
-        const Scalar coef = (1 - exp(-td_Tc_)) / td_Tc_;
-        this->Qai_.at(idx) = this->alphai_[idx] * aqufetp_data_.J * dpai(idx) * coef;
+        const Scalar dt = simulator.timeStepSize();
+        if (dt != this->coef_dt_) {
+            const Scalar td_Tc_ = dt / this->Tc_;
+            this->coef_ = (1 - exp(-td_Tc_)) / td_Tc_;
+            this->coef_dt_ = dt;
+        }
+        this->Qai_.at(idx) = this->alphai_[idx] * aqufetp_data_.J * dpai(idx) * this->coef_;
     }
 
     inline void calculateAquiferCondition() override
@@ -244,22 +244,17 @@ protected:
         // denom_face_areas is the sum of the areas connected to an aquifer
         Scalar denom_face_areas = 0.;
         this->cellToConnectionIdx_.resize(this->ebos_simulator_.gridView().size(/*codim=*/0), -1);
-        const auto& gridView = this->ebos_simulator_.vanguard().gridView();
         for (size_t idx = 0; idx < this->size(); ++idx) {
             const auto global_index = this->connections_[idx].global_index;
             const int cell_index = this->ebos_simulator_.vanguard().compressedIndex(global_index);
-            auto elemIt = gridView.template begin</*codim=*/ 0>();
-            if (cell_index > 0)
-                std::advance(elemIt, cell_index);
-
-           //the global_index is not part of this grid
-            if ( cell_index < 0 || elemIt->partitionType() != Dune::InteriorEntity)
+            //the global_index is not part of this grid
+            if (cell_index < 0)
                 continue;
 
             this->cellToConnectionIdx_[cell_index] = idx;
-            this->cell_depth_.at(idx) = this->ebos_simulator_.vanguard().cellCenterDepth(cell_index);
         }
-        // get areas for all connections
+        // get depths and areas for all connections in a single pass over the grid
+        const auto& gridView = this->ebos_simulator_.vanguard().gridView();
         ElementMapper elemMapper(gridView, Dune::mcmgElementLayout());
         auto elemIt = gridView.template begin</*codim=*/ 0>();
         const auto& elemEndIt = gridView.template end</*codim=*/ 0>();
@@ -272,6 +267,14 @@ protected:
             if( idx < 0)
                 continue;
 
+            // the connections of cells owned by other processes are handled there
+            if (elem.partitionType() != Dune::InteriorEntity) {
+                this->cellToConnectionIdx_[cell_index] = -1;
+                continue;
+            }
+
+            this->cell_depth_.at(idx) = this->ebos_simulator_.vanguard().cellCenterDepth(cell_index);
+
             auto isIt = gridView.ibegin(elem);
             const auto& isEndIt = gridView.iend(elem);
             for (; isIt != isEndIt; ++ isIt) {
@@ -127,6 +127,7 @@ private:
         double sum_watervolume = 0.;
 
         ElementContext  elem_ctx(this->ebos_simulator_);
+        const auto& elemMapper = this->ebos_simulator_.model().elementMapper();
         const auto& gridView = this->ebos_simulator_.gridView();
         auto elemIt = gridView.template begin</*codim=*/0>();
         const auto& elemEndIt = gridView.template end</*codim=*/0>();
@@ -135,14 +136,13 @@ private:
             if (elem.partitionType() != Dune::InteriorEntity) {
                 continue;
             }
-            elem_ctx.updatePrimaryStencil(elem);
-
-            const size_t cell_index = elem_ctx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const int idx = this->cell_to_aquifer_cell_idx_[cell_index];
+            // only the aquifer cells need the element context
+            const int idx = this->cell_to_aquifer_cell_idx_[elemMapper.index(elem)];
             if (idx < 0) {
                 continue;
             }
 
+            elem_ctx.updatePrimaryStencil(elem);
             elem_ctx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
             const auto& iq0 = elem_ctx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
             const auto& fs = iq0.fluidState();
@@ -160,10 +160,10 @@ private:
             sum_watervolume += water_volume;
         }
 
+        double sums[2] = {sum_pressure_watervolume, sum_watervolume};
         const auto& comm = this->ebos_simulator_.vanguard().grid().comm();
-        comm.sum(&sum_pressure_watervolume, 1);
-        comm.sum(&sum_watervolume, 1);
-        return sum_pressure_watervolume / sum_watervolume;
+        comm.sum(sums, 2);
+        return sums[0] / sums[1];
     }
 
     double calculateAquiferFluxRate() const
@@ -171,6 +171,7 @@ private:
         double aquifer_flux = 0.;
 
         ElementContext  elem_ctx(this->ebos_simulator_);
+        const auto& elemMapper = this->ebos_simulator_.model().elementMapper();
         const auto& gridView = this->ebos_simulator_.gridView();
         auto elemIt = gridView.template begin</*codim=*/0>();
         const auto& elemEndIt = gridView.template end</*codim=*/0>();
@@ -179,15 +180,14 @@ private:
             if (elem.partitionType() != Dune::InteriorEntity) {
                 continue;
             }
-            // elem_ctx.updatePrimaryStencil(elem);
-            elem_ctx.updateStencil(elem);
-
-            const size_t cell_index = elem_ctx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+            const size_t cell_index = elemMapper.index(elem);
             const int idx = this->cell_to_aquifer_cell_idx_[cell_index];
             // we only need the first aquifer cell
             if (idx != 0) {
                 continue;
             }
+            // elem_ctx.updatePrimaryStencil(elem);
+            elem_ctx.updateStencil(elem);
             elem_ctx.updateAllIntensiveQuantities();
             elem_ctx.updateAllExtensiveQuantities();
 
@@ -45,11 +45,18 @@
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 #include <opm/simulators/timestepping/SimulatorTimer.hpp>
+#include <opm/simulators/utils/PerfCounters.hpp>
+#include <opm/simulators/utils/PhaseActivity.hpp>
+#include <opm/simulators/utils/RegionBatches.hpp>
+#include <opm/simulators/utils/Tracing.hpp>
 #include <opm/common/utility/parameters/ParameterGroup.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 
+#include <opm/simulators/linalg/DecoupledEnergySolver.hpp>
 #include <opm/simulators/linalg/ISTLSolverEbos.hpp>
+#include <opm/simulators/linalg/SequentialImplicitSolver.hpp>
+#include <opm/simulators/linalg/setupPropertyTree.hpp>
 
 #include <dune/istl/owneroverlapcopy.hh>
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
@@ -57,14 +64,22 @@
 #else
 #include <dune/common/parallel/collectivecommunication.hh>
 #endif
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
 #include <dune/common/timer.hh>
 #include <dune/common/unused.hh>
 
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <deque>
+#include <exception>
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <memory>
+#include <numeric>
+#include <utility>
 #include <vector>
 #include <algorithm>
 
@@ -154,13 +169,17 @@ namespace Opm {
         using Simulator = GetPropType<TypeTag, Properties::Simulator>;
         using Grid = GetPropType<TypeTag, Properties::Grid>;
         using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+        using GridView = GetPropType<TypeTag, Properties::GridView>;
+        using Element = typename GridView::template Codim<0>::Entity;
         using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
         using SolutionVector = GetPropType<TypeTag, Properties::SolutionVector>;
         using PrimaryVariables = GetPropType<TypeTag, Properties::PrimaryVariables>;
         using FluidSystem = GetPropType<TypeTag, Properties::FluidSystem>;
         using Indices = GetPropType<TypeTag, Properties::Indices>;
+        using PhaseActivity = Opm::PhaseActivity<FluidSystem, Indices>;
         using MaterialLaw = GetPropType<TypeTag, Properties::MaterialLaw>;
         using MaterialLawParams = GetPropType<TypeTag, Properties::MaterialLawParams>;
+        using IntensiveQuantities = GetPropType<TypeTag, Properties::IntensiveQuantities>;
 
         typedef double Scalar;
         static const int numEq = Indices::numEq;
@@ -215,6 +234,44 @@ namespace Opm {
             // compute global sum of number of cells
             global_nc_ = detail::countGlobalCells(grid_);
             convergence_reports_.reserve(300); // Often insufficient, but avoids frequent moves.
+
+            // the counters are kept by the problem over all report steps
+            auto& hotspots = ebosSimulator_.problem().convergenceHotspots();
+            if (param_.output_convergence_hotspots_ && !hotspots.enabled()) {
+                hotspots.resize(ebosSimulator_.gridView().size(/*codim=*/0));
+            }
+
+            if (param_.sequential_implicit_) {
+                if (isParallel() || !param_.matrix_add_well_contributions_) {
+                    if (terminal_output_) {
+                        OpmLog::warning("The sequential implicit updates need a serial run with "
+                                        "--matrix-add-well-contributions=true, using the fully implicit linear solver.");
+                    }
+                } else {
+                    sequential_solver_ = std::make_unique<SequentialImplicitSolver<Mat, BVector>>(
+                        Indices::pressureSwitchIdx, param_.sequential_pressure_tolerance_, /*pressureMaxIter=*/200);
+                }
+            }
+            if (param_.decoupled_energy_ && !sequential_solver_) {
+                if constexpr (has_energy_) {
+                    static_assert(Indices::temperatureIdx == Indices::contiEnergyEqIdx,
+                                  "The decoupled energy solve needs the temperature at the index of the energy equation");
+                    if (isParallel() || !param_.matrix_add_well_contributions_) {
+                        if (terminal_output_) {
+                            OpmLog::warning("The decoupled energy solve needs a serial run with "
+                                            "--matrix-add-well-contributions=true, using the fully coupled linear solver.");
+                        }
+                    } else {
+                        FlowLinearSolverParameters linearSolverParameters;
+                        linearSolverParameters.template init<TypeTag>();
+                        energy_solver_ = std::make_unique<DecoupledEnergySolver<Mat, BVector>>(
+                            setupPropertyTree<TypeTag>(linearSolverParameters), Indices::contiEnergyEqIdx,
+                            param_.decoupled_energy_tolerance_, /*energyMaxIter=*/200);
+                    }
+                } else if (terminal_output_) {
+                    OpmLog::warning("The decoupled energy solve is only used in thermal runs.");
+                }
+            }
         }
 
         bool isParallel() const
@@ -231,7 +288,12 @@ namespace Opm {
             Dune::Timer perfTimer;
             perfTimer.start();
             // update the solution variables in ebos
+            SolutionVector failedIterate;
+            const double failedStepSize = ebosSimulator_.timeStepSize();
             if ( timer.lastStepFailed() ) {
+                if (param_.failed_step_initial_guess_) {
+                    failedIterate = ebosSimulator_.model().solution(/*timeIdx=*/0);
+                }
                 ebosSimulator_.model().updateFailed();
             } else {
                 ebosSimulator_.model().advanceTimeLevel();
@@ -251,6 +313,25 @@ namespace Opm {
             wasSwitched_.resize(numDof);
             std::fill(wasSwitched_.begin(), wasSwitched_.end(), false);
 
+            // the time level changed, all intensive quantities have to be computed again
+            evaluated_primary_vars_valid_ = false;
+
+            // the chopped step starts from the same fraction of the change of the failed attempt
+            if (failedIterate.size() > 0 && failedStepSize > timer.currentStepLength()) {
+                const Scalar weight = timer.currentStepLength() / failedStepSize;
+                const auto& solution = ebosSimulator_.model().solution(/*timeIdx=*/1);
+                SolutionVector guess(solution);
+                for (std::size_t cell_idx = 0; cell_idx < guess.size(); ++cell_idx) {
+                    guess[cell_idx] = combinePrimaryVars_(solution[cell_idx], failedIterate[cell_idx],
+                                                          1.0 - weight, weight);
+                }
+                applyInitialGuess_(guess);
+            }
+            else if (!timer.lastStepFailed() && param_.solution_extrapolation_order_ > 0) {
+                extrapolateSolution_(timer.simulationTimeElapsed(),
+                                     timer.simulationTimeElapsed() + timer.currentStepLength());
+            }
+
             if (param_.update_equations_scaling_) {
                 std::cout << "equation scaling not suported yet" << std::endl;
                 //updateEquationsScaling();
@@ -275,6 +356,7 @@ namespace Opm {
                                                  const SimulatorTimerInterface& timer,
                                                  NonlinearSolverType& nonlinear_solver)
         {
+            OPM_TRACE_SCOPE("newton iteration");
             SimulatorReportSingle report;
             failureReport_ = SimulatorReportSingle();
             Dune::Timer perfTimer;
@@ -307,7 +389,8 @@ namespace Opm {
             perfTimer.reset();
             perfTimer.start();
             // the step is not considered converged until at least minIter iterations is done
-            {
+            auto checkConvergence = [&]() {
+                residual_norms.clear();
                 auto convrep = getConvergence(timer, iteration,residual_norms);
                 report.converged = convrep.converged()  && iteration > nonlinear_solver.minIter();;
                 ConvergenceReport::Severity severity = convrep.severityOfWorstFailure();
@@ -319,8 +402,13 @@ namespace Opm {
                 } else if (severity == ConvergenceReport::Severity::TooLarge) {
                     OPM_THROW(NumericalIssue, "Too large residual found!");
                 }
-            }
+            };
+            checkConvergence();
             report.update_time += perfTimer.stop();
+
+            if (param_.line_search_max_cuts_ > 0 && iteration > 0) {
+                backtrackUpdate_(timer, iteration, residual_norms, report, checkConvergence);
+            }
             residual_norms_history_.push_back(residual_norms);
             if (!report.converged) {
                 perfTimer.reset();
@@ -334,18 +422,35 @@ namespace Opm {
                 const int nc = UgGridHelpers::numCells(grid_);
                 BVector x(nc);
 
+                // after the first iteration, only update where the residual is large
+                const bool localized = param_.use_localized_newton_ && iteration > 0
+                    && updateLocalizedNewtonCells(timer.currentStepLength());
+
                 // apply the Schur compliment of the well model to the reservoir linearized
                 // equations
                 wellModel().linearize(ebosSimulator().model().linearizer().jacobian(),
                                       ebosSimulator().model().linearizer().residual());
 
+                if (localized) {
+                    restrictToLocalizedNewtonCells();
+                }
+
                 // Solve the linear system.
                 linear_solve_setup_time_ = 0.0;
                 try {
-                    solveJacobianSystem(x);
+                    if (sequential_solver_) {
+                        solveSequentialImplicit(x);
+                        report.pressure_time += sequential_solver_->pressureTime();
+                        report.transport_time += sequential_solver_->transportTime();
+                    } else if (energy_solver_) {
+                        solveDecoupledEnergy(x);
+                    } else {
+                        solveJacobianSystem(x);
+                    }
                     report.linear_solve_setup_time += linear_solve_setup_time_;
                     report.linear_solve_time += perfTimer.stop();
                     report.total_linear_iterations += linearIterationsLastSolve();
+                    ebosSimulator_.problem().convergenceHotspots().recordLinearIterations(linearIterationsLastSolve());
                 }
                 catch (...) {
                     report.linear_solve_setup_time += linear_solve_setup_time_;
@@ -362,7 +467,17 @@ namespace Opm {
                 // handling well state update before oscillation treatment is a decision based
                 // on observation to avoid some big performance degeneration under some circumstances.
                 // there is no theorectical explanation which way is better for sure.
+                // The wells only read the update of their perforated cells, which are owned
+                // by this process and not frozen below, so they recover their solution while
+                // the ghost entries of the update may still be exchanged.
                 wellModel().postSolve(x);
+                ebosSimulator_.model().newtonMethod().linearSolver().finishSolutionExchange(x);
+
+                // drop the negligible updates, such that the frozen cells keep their
+                // intensive quantities
+                if (param_.frozen_cell_update_threshold_ > 0.0 && iteration > 0) {
+                    freezeSmallUpdates(x);
+                }
 
                 if (param_.use_update_stabilization_) {
                     // Stabilize the nonlinear update.
@@ -381,11 +496,23 @@ namespace Opm {
                     nonlinear_solver.stabilizeNonlinearUpdate(x, dx_old_, current_relaxation_);
                 }
 
+                if (param_.anderson_acceleration_depth_ > 0) {
+                    andersonAccelerate_(x, iteration);
+                }
+
+                if (param_.line_search_max_cuts_ > 0) {
+                    line_search_solution_ = ebosSimulator_.model().solution(/*timeIdx=*/0);
+                    line_search_dx_ = x;
+                    line_search_merit_ = std::accumulate(residual_norms.begin(), residual_norms.end(), 0.0);
+                }
+
                 // Apply the update, with considering model-dependent limitations and
                 // chopping of the update.
                 updateSolution(x);
 
                 report.update_time += perfTimer.stop();
+                report.intensive_quantities_computed += intensive_quantities_computed_;
+                report.intensive_quantities_reused += intensive_quantities_reused_;
             }
 
             return report;
@@ -418,10 +545,14 @@ namespace Opm {
         SimulatorReportSingle assembleReservoir(const SimulatorTimerInterface& /* timer */,
                                                 const int iterationIdx)
         {
+            OPM_TRACE_SCOPE("assemble reservoir");
             // -------- Mass balance equations --------
             ebosSimulator_.model().newtonMethod().setIterationIndex(iterationIdx);
             ebosSimulator_.problem().beginIteration();
-            ebosSimulator_.model().linearizer().linearizeDomain();
+            {
+                OPM_PERF_SCOPE("linearize", 0);
+                ebosSimulator_.model().linearizer().linearizeDomain();
+            }
             ebosSimulator_.problem().endIteration();
 
             return wellModel().lastReport();
@@ -433,78 +564,66 @@ namespace Opm {
             Scalar resultDelta = 0.0;
             Scalar resultDenom = 0.0;
 
-            const auto& elemMapper = ebosSimulator_.model().elementMapper();
-            const auto& gridView = ebosSimulator_.gridView();
-            auto elemIt = gridView.template begin</*codim=*/0>();
-            const auto& elemEndIt = gridView.template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const auto& elem = *elemIt;
-                if (elem.partitionType() != Dune::InteriorEntity)
-                    continue;
-
-                unsigned globalElemIdx = elemMapper.index(elem);
-                const auto& priVarsNew = ebosSimulator_.model().solution(/*timeIdx=*/0)[globalElemIdx];
-
-                Scalar pressureNew;
-                pressureNew = priVarsNew[Indices::pressureSwitchIdx];
+            // the active phases are the same for all cells, only the gas saturation
+            // depends on the meaning of the primary variables of the cell
+            const bool waterActive = PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx);
+            const bool gasActive = PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx);
+            const bool oilActive = PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx);
+            const bool multiPhase = FluidSystem::numActivePhases() > 1;
 
-                Scalar saturationsNew[FluidSystem::numPhases] = { 0.0 };
-                Scalar oilSaturationNew = 1.0;
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                    saturationsNew[FluidSystem::waterPhaseIdx] = priVarsNew[Indices::waterSaturationIdx];
-                    oilSaturationNew -= saturationsNew[FluidSystem::waterPhaseIdx];
+            const auto saturations = [&](const PrimaryVariables& priVars, Scalar* sat)
+            {
+                Scalar oilSaturation = 1.0;
+                if constexpr (Indices::waterEnabled) {
+                    if (waterActive) {
+                        sat[FluidSystem::waterPhaseIdx] = priVars[Indices::waterSaturationIdx];
+                        oilSaturation -= sat[FluidSystem::waterPhaseIdx];
+                    }
                 }
-
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && priVarsNew.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
-                    saturationsNew[FluidSystem::gasPhaseIdx] = priVarsNew[Indices::compositionSwitchIdx];
-                    oilSaturationNew -= saturationsNew[FluidSystem::gasPhaseIdx];
+                if constexpr (Indices::gasEnabled) {
+                    if (gasActive) {
+                        const bool hasSg = priVars.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg;
+                        sat[FluidSystem::gasPhaseIdx] = hasSg ? priVars[Indices::compositionSwitchIdx] : 0.0;
+                        oilSaturation -= sat[FluidSystem::gasPhaseIdx];
+                    }
                 }
-
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-                    saturationsNew[FluidSystem::oilPhaseIdx] = oilSaturationNew;
+                if (oilActive) {
+                    sat[FluidSystem::oilPhaseIdx] = oilSaturation;
                 }
+            };
 
-                const auto& priVarsOld = ebosSimulator_.model().solution(/*timeIdx=*/1)[globalElemIdx];
-
-                Scalar pressureOld;
-                pressureOld = priVarsOld[Indices::pressureSwitchIdx];
-
-                Scalar saturationsOld[FluidSystem::numPhases] = { 0.0 };
-                Scalar oilSaturationOld = 1.0;
+            const auto& solutionNew = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            const auto& solutionOld = ebosSimulator_.model().solution(/*timeIdx=*/1);
+            for (const unsigned cell_idx : interiorCells_()) {
+                const auto& priVarsNew = solutionNew[cell_idx];
+                const auto& priVarsOld = solutionOld[cell_idx];
 
                 // NB fix me! adding pressures changes to satutation changes does not make sense
-                Scalar tmp = pressureNew - pressureOld;
+                const Scalar pressureNew = priVarsNew[Indices::pressureSwitchIdx];
+                const Scalar tmp = pressureNew - priVarsOld[Indices::pressureSwitchIdx];
                 resultDelta += tmp*tmp;
                 resultDenom += pressureNew*pressureNew;
 
-                if (FluidSystem::numActivePhases() > 1) {
-                    if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                        saturationsOld[FluidSystem::waterPhaseIdx] = priVarsOld[Indices::waterSaturationIdx];
-                        oilSaturationOld -= saturationsOld[FluidSystem::waterPhaseIdx];
-                    }
-
-                    if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) &&
-                        priVarsOld.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg)
-                    {
-                        saturationsOld[FluidSystem::gasPhaseIdx] = priVarsOld[Indices::compositionSwitchIdx];
-                        oilSaturationOld -= saturationsOld[FluidSystem::gasPhaseIdx];
-                    }
+                if (!multiPhase) {
+                    continue;
+                }
 
-                    if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-                        saturationsOld[FluidSystem::oilPhaseIdx] = oilSaturationOld;
-                    }
-                    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++ phaseIdx) {
-                        Scalar tmpSat = saturationsNew[phaseIdx] - saturationsOld[phaseIdx];
-                        resultDelta += tmpSat*tmpSat;
-                        resultDenom += saturationsNew[phaseIdx]*saturationsNew[phaseIdx];
-                        assert(std::isfinite(resultDelta));
-                        assert(std::isfinite(resultDenom));
-                    }
+                Scalar saturationsNew[FluidSystem::numPhases] = { 0.0 };
+                Scalar saturationsOld[FluidSystem::numPhases] = { 0.0 };
+                saturations(priVarsNew, saturationsNew);
+                saturations(priVarsOld, saturationsOld);
+                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++ phaseIdx) {
+                    Scalar tmpSat = saturationsNew[phaseIdx] - saturationsOld[phaseIdx];
+                    resultDelta += tmpSat*tmpSat;
+                    resultDenom += saturationsNew[phaseIdx]*saturationsNew[phaseIdx];
+                    assert(std::isfinite(resultDelta));
+                    assert(std::isfinite(resultDenom));
                 }
             }
 
-            resultDelta = gridView.comm().sum(resultDelta);
-            resultDenom = gridView.comm().sum(resultDenom);
+            const auto& comm = ebosSimulator_.gridView().comm();
+            resultDelta = comm.sum(resultDelta);
+            resultDenom = comm.sum(resultDenom);
 
             if (resultDenom > 0.0)
                 return resultDelta/resultDenom;
@@ -512,9 +631,125 @@ namespace Opm {
         }
 
 
+        /// Decide which cells are updated by the localized Newton method: the interior
+        /// cells violating the CNV tolerance, the cells perforated by wells, all
+        /// non-interior cells, and param_.localized_newton_buffer_layers_ layers of
+        /// neighbours around them. Uses the residual before the well contributions
+        /// are applied, like the convergence check.
+        /// \return true if some cells are not updated
+        bool updateLocalizedNewtonCells(const double dt)
+        {
+            const auto& ebosModel = ebosSimulator_.model();
+            const auto& ebosProblem = ebosSimulator_.problem();
+            const auto& ebosResid = ebosModel.linearizer().residual();
+            const auto& elemMapper = ebosModel.elementMapper();
+            const auto& perforated = wellModel().isCellPerforated();
+
+            std::vector<char> active(ebosResid.size(), 0);
+            for (const auto& elem : elements(ebosSimulator_.gridView())) {
+                const unsigned cell_idx = elemMapper.index(elem);
+                if (elem.partitionType() != Dune::InteriorEntity ||
+                    (cell_idx < perforated.size() && perforated[cell_idx])) {
+                    active[cell_idx] = 1;
+                    continue;
+                }
+                const double pvValue = ebosProblem.referencePorosity(cell_idx, /*timeIdx=*/0) * ebosModel.dofTotalVolume( cell_idx );
+                const auto& cellResidual = ebosResid[cell_idx];
+                for (unsigned eqIdx = 0; eqIdx < cellResidual.size(); ++eqIdx) {
+                    const Scalar CNV = cellResidual[eqIdx] * dt * convergence_B_avg_[eqIdx] / pvValue;
+                    if (std::abs(CNV) > param_.tolerance_cnv_) {
+                        active[cell_idx] = 1;
+                        break;
+                    }
+                }
+            }
+
+            // add the buffer layers, the neighbours are taken from the sparsity pattern of the jacobian
+            const auto& jac = ebosModel.linearizer().jacobian().istlMatrix();
+            for (int layer = 0; layer < param_.localized_newton_buffer_layers_; ++layer) {
+                std::vector<char> next(active);
+                for (auto row = jac.begin(); row != jac.end(); ++row) {
+                    if (!active[row.index()])
+                        continue;
+                    for (auto col = row->begin(); col != row->end(); ++col)
+                        next[col.index()] = 1;
+                }
+                active.swap(next);
+            }
+
+            const auto numActive = std::count(active.begin(), active.end(), 1);
+            localized_newton_active_.swap(active);
+            if (terminal_output_) {
+                OpmLog::debug("Localized Newton update of " + std::to_string(numActive) + " of "
+                              + std::to_string(localized_newton_active_.size()) + " local cells");
+            }
+            const int someInactive = numActive < static_cast<long>(localized_newton_active_.size()) ? 1 : 0;
+            return grid_.comm().max(someInactive) > 0;
+        }
+
+        /// Replace the equations of the cells which are not updated by the localized
+        /// Newton method with dx = 0.
+        void restrictToLocalizedNewtonCells()
+        {
+            auto& jac = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            auto& resid = ebosSimulator_.model().linearizer().residual();
+            for (auto row = jac.begin(); row != jac.end(); ++row) {
+                const auto row_idx = row.index();
+                if (localized_newton_active_[row_idx])
+                    continue;
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    *col = 0.0;
+                    if (col.index() == row_idx) {
+                        for (int i = 0; i < numEq; ++i)
+                            (*col)[i][i] = 1.0;
+                    }
+                }
+                resid[row_idx] = 0.0;
+            }
+        }
+
+        /// Set the update of the cells which are not perforated by a well to zero if it is
+        /// below the frozen cell threshold for all primary variables, relative to the
+        /// pressure for the pressure and absolute for the other variables. The update and
+        /// the solution are consistent between the processes, so the copies of a cell on
+        /// different processes are frozen together.
+        void freezeSmallUpdates(BVector& dx) const
+        {
+            const auto& ebosModel = ebosSimulator_.model();
+            const auto& solution = ebosModel.solution(/*timeIdx=*/0);
+            const auto& elemMapper = ebosModel.elementMapper();
+            const auto& perforated = wellModel().isCellPerforated();
+            const Scalar threshold = param_.frozen_cell_update_threshold_;
+
+            for (const auto& elem : elements(ebosSimulator_.gridView())) {
+                const unsigned cell_idx = elemMapper.index(elem);
+                if (cell_idx < perforated.size() && perforated[cell_idx]) {
+                    continue;
+                }
+                auto& cellUpdate = dx[cell_idx];
+                bool small = true;
+                for (int pvIdx = 0; pvIdx < numEq && small; ++pvIdx) {
+                    Scalar change = std::abs(cellUpdate[pvIdx]);
+                    if (pvIdx == Indices::pressureSwitchIdx) {
+                        change /= std::max(std::abs(solution[cell_idx][pvIdx]), Scalar(1e-10));
+                    }
+                    small = change <= threshold;
+                }
+                if (small) {
+                    cellUpdate = 0.0;
+                }
+            }
+        }
+
         /// Number of linear iterations used in last call to solveJacobianSystem().
         int linearIterationsLastSolve() const
         {
+            if (sequential_solver_) {
+                return sequential_solver_->pressureIterations();
+            }
+            if (energy_solver_) {
+                return energy_solver_->flowIterations();
+            }
             return ebosSimulator_.model().newtonMethod().linearSolver().iterations ();
         }
 
@@ -522,6 +757,7 @@ namespace Opm {
         /// r is the residual.
         void solveJacobianSystem(BVector& x)
         {
+            OPM_TRACE_SCOPE("linear solve");
 
             auto& ebosJac = ebosSimulator_.model().linearizer().jacobian();
             auto& ebosResid = ebosSimulator_.model().linearizer().residual();
@@ -540,14 +776,65 @@ namespace Opm {
             // discretizations does not need to be synchronized across processes to be
             // consistent, this is not relevant for OPM-flow...
             ebosSolver.setMatrix(ebosJac);
+            // the ghost entries of x are exchanged while the wells recover their solution
+            ebosSolver.setDeferSolutionExchange(true);
             ebosSolver.solve(x);
        }
 
+        /// Compute the update x of the Jacobian system Jx = r sequentially, by a pressure
+        /// solve followed by a transport sweep, see SequentialImplicitSolver.
+        void solveSequentialImplicit(BVector& x)
+        {
+            OPM_TRACE_SCOPE("sequential implicit solve");
+
+            const auto& jac = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            const auto& resid = ebosSimulator_.model().linearizer().residual();
+            const auto& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+
+            std::vector<double> pressures(solution.size());
+            for (std::size_t cell_idx = 0; cell_idx < solution.size(); ++cell_idx) {
+                pressures[cell_idx] = solution[cell_idx][Indices::pressureSwitchIdx];
+            }
+            if (param_.sequential_near_well_sweeps_ > 0) {
+                // the perforated cells and their neighbours, where the throughput is highest
+                const auto& perforated = wellModel().isCellPerforated();
+                std::vector<char> nearWell(solution.size(), 0);
+                for (auto row = jac.begin(); row != jac.end(); ++row) {
+                    if (row.index() >= perforated.size() || !perforated[row.index()])
+                        continue;
+                    for (auto col = row->begin(); col != row->end(); ++col)
+                        nearWell[col.index()] = 1;
+                }
+                sequential_solver_->setRefinedCells(std::move(nearWell), param_.sequential_near_well_sweeps_);
+            }
+            linear_solve_setup_time_ = 0.0;
+            sequential_solver_->solve(jac, resid, pressures, x);
+        }
+
+        /// Compute the update x of the Jacobian system Jx = r of a thermal run by
+        /// a solve without the energy equation followed by a scalar energy solve,
+        /// see DecoupledEnergySolver.
+        void solveDecoupledEnergy(BVector& x)
+        {
+            OPM_TRACE_SCOPE("decoupled energy solve");
+
+            const auto& jac = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            const auto& resid = ebosSimulator_.model().linearizer().residual();
+            linear_solve_setup_time_ = 0.0;
+            if constexpr (has_energy_) {
+                energy_solver_->solve(jac, resid, x);
+                if (!energy_solver_->converged()) {
+                    OPM_THROW_NOLOG(NumericalIssue, "Convergence failure for the decoupled energy solve.");
+                }
+            }
+        }
+
 
 
         /// Apply an update to the primary variables.
         void updateSolution(const BVector& dx)
         {
+            OPM_TRACE_SCOPE("update solution");
             auto& ebosNewtonMethod = ebosSimulator_.model().newtonMethod();
             SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
 
@@ -558,8 +845,458 @@ namespace Opm {
                                                     // oil model do not care about the
                                                     // residual
 
-            // if the solution is updated, the intensive quantities need to be recalculated
-            ebosSimulator_.model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+            // the frozen cells did not change, so their intensive quantities are still exact
+            if (param_.enable_intensive_quantities_reuse_ || param_.frozen_cell_update_threshold_ > 0.0) {
+                updateChangedIntensiveQuantities_(solution);
+            } else if (param_.intensive_quantities_batch_size_ > 0) {
+                // all cells are evaluated again, in batches of cells of the same regions
+                evaluated_primary_vars_valid_ = false;
+                updateChangedIntensiveQuantities_(solution);
+            } else {
+                // if the solution is updated, the intensive quantities need to be recalculated
+                ebosSimulator_.model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+                intensive_quantities_computed_ = solution.size();
+                intensive_quantities_reused_ = 0;
+            }
+        }
+
+        /// Return w1*pv1 + w2*pv2 if both primary variables have the same meaning and are
+        /// finite, pv1 otherwise.
+        static PrimaryVariables combinePrimaryVars_(const PrimaryVariables& pv1, const PrimaryVariables& pv2,
+                                                    const Scalar w1, const Scalar w2)
+        {
+            if (pv1.primaryVarsMeaning() != pv2.primaryVarsMeaning()) {
+                return pv1;
+            }
+            PrimaryVariables result(pv1);
+            for (unsigned pvIdx = 0; pvIdx < result.size(); ++pvIdx) {
+                const Scalar value = w1*pv1[pvIdx] + w2*pv2[pvIdx];
+                if (!std::isfinite(value)) {
+                    return pv1;
+                }
+                result[pvIdx] = value;
+            }
+            return result;
+        }
+
+        /// Move the current solution to the initial guess with the Newton update of ebos,
+        /// such that the usual chopping of the update and the primary variable switching
+        /// apply to it. Cells with another primary variable meaning than in the guess keep
+        /// their solution.
+        void applyInitialGuess_(const SolutionVector& guess)
+        {
+            const auto& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            BVector dx(solution.size());
+            dx = 0.0;
+            for (std::size_t cell_idx = 0; cell_idx < solution.size(); ++cell_idx) {
+                if (solution[cell_idx].primaryVarsMeaning() != guess[cell_idx].primaryVarsMeaning()) {
+                    continue;
+                }
+                for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                    // ebos subtracts the update from the solution
+                    dx[cell_idx][pvIdx] = solution[cell_idx][pvIdx] - guess[cell_idx][pvIdx];
+                }
+            }
+            updateSolution(dx);
+        }
+
+        /// Replace the Newton update by its Anderson acceleration over the last updates of
+        /// the time step, with the Newton step as the residual of the fixed point iteration.
+        /// Pressures are weighted relative to the cell pressure in the least squares
+        /// problem. Cells whose primary variable meaning changed during the time step keep
+        /// their Newton update, and the history is restarted when the residual grows.
+        /// Backtracking line search on the last Newton update: while the sum of the CNV
+        /// residuals did not decrease sufficiently, go back to the solution before the
+        /// update and apply half of the update again. The residual of a trial solution
+        /// is the one of a linearization, which is the linearization of the next Newton
+        /// iteration once the trial is accepted. The well solutions keep the full update.
+        template <class CheckConvergence>
+        void backtrackUpdate_(const SimulatorTimerInterface& timer,
+                              const int iteration,
+                              const std::vector<double>& residual_norms,
+                              SimulatorReportSingle& report,
+                              CheckConvergence& checkConvergence)
+        {
+            auto& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            if (line_search_dx_.size() != solution.size()) {
+                return;
+            }
+
+            // the sufficient decrease condition of Armijo
+            constexpr double c = 1e-4;
+            double alpha = 1.0;
+            int cuts = 0;
+            auto merit = [&residual_norms]() {
+                return std::accumulate(residual_norms.begin(), residual_norms.end(), 0.0);
+            };
+            while (!report.converged && cuts < param_.line_search_max_cuts_
+                   && merit() > (1.0 - c * alpha) * line_search_merit_) {
+                alpha *= 0.5;
+                ++cuts;
+
+                Dune::Timer perfTimer;
+                perfTimer.start();
+                solution = line_search_solution_;
+                BVector dx = line_search_dx_;
+                dx *= alpha;
+                updateSolution(dx);
+                report.update_time += perfTimer.stop();
+
+                perfTimer.reset();
+                perfTimer.start();
+                try {
+                    report += assembleReservoir(timer, iteration);
+                    report.total_linearizations += 1;
+                    report.assemble_time += perfTimer.stop();
+                }
+                catch (...) {
+                    report.assemble_time += perfTimer.stop();
+                    failureReport_ += report;
+                    throw;
+                }
+
+                perfTimer.reset();
+                perfTimer.start();
+                convergence_reports_.back().report.pop_back();
+                checkConvergence();
+                report.update_time += perfTimer.stop();
+            }
+
+            if (cuts > 0 && terminalOutputEnabled()) {
+                OpmLog::debug("    Line search: Newton update scaled by " + std::to_string(alpha));
+            }
+        }
+
+        void andersonAccelerate_(BVector& dx, const int iteration)
+        {
+            const auto& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            const std::size_t nc = solution.size();
+
+            bool restart = iteration == 0 || anderson_last_solution_.size() != nc;
+            if (!restart && residual_norms_history_.size() > 1) {
+                const auto& norms = residual_norms_history_.back();
+                const auto& lastNorms = residual_norms_history_[residual_norms_history_.size() - 2];
+                restart = std::accumulate(norms.begin(), norms.end(), 0.0)
+                    > std::accumulate(lastNorms.begin(), lastNorms.end(), 0.0);
+            }
+            if (restart) {
+                anderson_du_.clear();
+                anderson_df_.clear();
+                anderson_excluded_.assign(nc, 0);
+            } else {
+                // the changes of the solution and of the step since the last iteration,
+                // the fixed point residual is -dx since ebos subtracts the update
+                BVector du(nc);
+                BVector df(nc);
+                du = 0.0;
+                df = 0.0;
+                for (std::size_t cell_idx = 0; cell_idx < nc; ++cell_idx) {
+                    if (solution[cell_idx].primaryVarsMeaning() != anderson_last_solution_[cell_idx].primaryVarsMeaning()) {
+                        anderson_excluded_[cell_idx] = 1;
+                    }
+                    if (anderson_excluded_[cell_idx]) {
+                        continue;
+                    }
+                    for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                        du[cell_idx][pvIdx] = solution[cell_idx][pvIdx] - anderson_last_solution_[cell_idx][pvIdx];
+                        df[cell_idx][pvIdx] = anderson_last_dx_[cell_idx][pvIdx] - dx[cell_idx][pvIdx];
+                    }
+                }
+                anderson_du_.push_back(std::move(du));
+                anderson_df_.push_back(std::move(df));
+                while (anderson_du_.size() > static_cast<std::size_t>(param_.anderson_acceleration_depth_)) {
+                    anderson_du_.pop_front();
+                    anderson_df_.pop_front();
+                }
+            }
+            anderson_last_solution_ = solution;
+            anderson_last_dx_ = dx;
+
+            const std::size_t m = anderson_df_.size();
+            if (m == 0) {
+                return;
+            }
+
+            // normal equations of min |f - dF gamma| over the interior cells, where
+            // f = -dx, reduced over all processes in one call
+            std::vector<double> sums(m*m + m, 0.0);
+            for (const unsigned cell_idx : interiorCells_()) {
+                if (anderson_excluded_[cell_idx]) {
+                    continue;
+                }
+                for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                    double weight = 1.0;
+                    if (pvIdx == Indices::pressureSwitchIdx) {
+                        const double p = std::abs(solution[cell_idx][pvIdx]);
+                        weight = p > 0.0 ? 1.0 / p : 1.0;
+                    }
+                    const double w2 = weight*weight;
+                    for (std::size_t i = 0; i < m; ++i) {
+                        const double dfi = anderson_df_[i][cell_idx][pvIdx];
+                        for (std::size_t j = 0; j <= i; ++j) {
+                            sums[i*m + j] += w2 * dfi * anderson_df_[j][cell_idx][pvIdx];
+                        }
+                        sums[m*m + i] -= w2 * dfi * dx[cell_idx][pvIdx];
+                    }
+                }
+            }
+            grid_.comm().sum(sums.data(), sums.size());
+
+            Dune::DynamicMatrix<double> A(m, m);
+            Dune::DynamicVector<double> b(m);
+            Dune::DynamicVector<double> gamma(m);
+            double trace = 0.0;
+            for (std::size_t i = 0; i < m; ++i) {
+                for (std::size_t j = 0; j <= i; ++j) {
+                    A[i][j] = A[j][i] = sums[i*m + j];
+                }
+                b[i] = sums[m*m + i];
+                trace += A[i][i];
+            }
+            if (!(trace > 0.0)) {
+                return;
+            }
+            // a small regularization for nearly linearly dependent updates
+            for (std::size_t i = 0; i < m; ++i) {
+                A[i][i] += 1e-10 * trace;
+            }
+            try {
+                A.solve(gamma, b);
+            }
+            catch (const Dune::FMatrixError&) {
+                anderson_du_.clear();
+                anderson_df_.clear();
+                return;
+            }
+            for (std::size_t i = 0; i < m; ++i) {
+                if (!std::isfinite(gamma[i])) {
+                    anderson_du_.clear();
+                    anderson_df_.clear();
+                    return;
+                }
+            }
+
+            // accelerated step f - sum_i gamma_i (du_i + df_i), in the sign convention of ebos
+            for (std::size_t cell_idx = 0; cell_idx < nc; ++cell_idx) {
+                if (anderson_excluded_[cell_idx]) {
+                    continue;
+                }
+                for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                    for (std::size_t i = 0; i < m; ++i) {
+                        dx[cell_idx][pvIdx] += gamma[i] * (anderson_du_[i][cell_idx][pvIdx] + anderson_df_[i][cell_idx][pvIdx]);
+                    }
+                }
+            }
+        }
+
+        /// Store the converged solution at the given time and start the time step from the
+        /// polynomial extrapolation of the stored solutions to the target time. Cells
+        /// whose primary variable meaning changed between the stored solutions are not
+        /// extrapolated.
+        void extrapolateSolution_(const double time, const double targetTime)
+        {
+            const auto& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            converged_solutions_.emplace_back(time, solution);
+            const std::size_t maxPoints = param_.solution_extrapolation_order_ + 1;
+            while (converged_solutions_.size() > maxPoints) {
+                converged_solutions_.pop_front();
+            }
+            const std::size_t numPoints = converged_solutions_.size();
+            if (numPoints < 2) {
+                return;
+            }
+
+            // Lagrange weights of the stored solutions at the target time
+            std::vector<Scalar> weights(numPoints, 1.0);
+            for (std::size_t j = 0; j < numPoints; ++j) {
+                for (std::size_t m = 0; m < numPoints; ++m) {
+                    if (m == j) {
+                        continue;
+                    }
+                    const double dt = converged_solutions_[j].first - converged_solutions_[m].first;
+                    if (dt == 0.0) {
+                        return;
+                    }
+                    weights[j] *= (targetTime - converged_solutions_[m].first) / dt;
+                }
+            }
+
+            SolutionVector guess(solution);
+            for (std::size_t cell_idx = 0; cell_idx < guess.size(); ++cell_idx) {
+                const auto meaning = solution[cell_idx].primaryVarsMeaning();
+                const bool switched = std::any_of(converged_solutions_.begin(), converged_solutions_.end(),
+                                                  [cell_idx, meaning](const auto& point)
+                                                  { return point.second[cell_idx].primaryVarsMeaning() != meaning; });
+                if (switched) {
+                    continue;
+                }
+                for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                    Scalar value = 0.0;
+                    for (std::size_t j = 0; j < numPoints; ++j) {
+                        value += weights[j] * converged_solutions_[j].second[cell_idx][pvIdx];
+                    }
+                    if (std::isfinite(value)) {
+                        guess[cell_idx][pvIdx] = value;
+                    }
+                }
+            }
+            applyInitialGuess_(guess);
+        }
+
+        /// Recompute the intensive quantities of the cells whose primary variables changed by
+        /// more than the reuse tolerance since their intensive quantities were last evaluated,
+        /// the cached intensive quantities of all other cells are kept.
+        void updateChangedIntensiveQuantities_(const SolutionVector& solution)
+        {
+            auto& ebosModel = ebosSimulator_.model();
+            const std::size_t numDof = solution.size();
+            if (evaluated_primary_vars_.size() != numDof) {
+                evaluated_primary_vars_.resize(numDof);
+                evaluated_primary_vars_valid_ = false;
+            }
+
+            std::vector<char> changed(numDof, 1);
+            if (evaluated_primary_vars_valid_) {
+                for (std::size_t idx = 0; idx < numDof; ++idx) {
+                    changed[idx] = primaryVarsChanged_(evaluated_primary_vars_[idx], solution[idx]);
+                }
+            }
+            evaluated_primary_vars_valid_ = true;
+
+            const auto& elemMapper = ebosModel.elementMapper();
+            std::vector<Element> changedElements;
+            for (const auto& elem : elements(ebosSimulator_.gridView())) {
+                const unsigned cell_idx = elemMapper.index(elem);
+                if (changed[cell_idx]) {
+                    ebosModel.setIntensiveQuantitiesCacheEntryValidity(cell_idx, /*timeIdx=*/0, false);
+                    evaluated_primary_vars_[cell_idx] = solution[cell_idx];
+                    changedElements.push_back(elem);
+                }
+            }
+            intensive_quantities_computed_ = changedElements.size();
+            intensive_quantities_reused_ = numDof - changedElements.size();
+
+            OPM_PERF_SCOPE("intensive quantities", 0);
+            const int batchSize = param_.intensive_quantities_batch_size_;
+            if (batchSize > 0) {
+                // the changed cells in the order of their regions and their Cartesian indices
+                std::vector<int> position(numDof, -1);
+                for (std::size_t i = 0; i < changedElements.size(); ++i) {
+                    position[elemMapper.index(changedElements[i])] = i;
+                }
+                std::vector<Element> orderedElements;
+                std::vector<int> keys;
+                orderedElements.reserve(changedElements.size());
+                keys.reserve(changedElements.size());
+                for (const unsigned cell_idx : regionCellOrder_()) {
+                    if (position[cell_idx] >= 0) {
+                        orderedElements.push_back(changedElements[position[cell_idx]]);
+                        keys.push_back(cell_region_keys_[cell_idx]);
+                    }
+                }
+                changedElements.swap(orderedElements);
+                intensive_quantities_batches_.build(keys, batchSize);
+            }
+            const auto& batches = intensive_quantities_batches_;
+
+            std::exception_ptr exc;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                ElementContext elemCtx(ebosSimulator_);
+                auto update = [&elemCtx, &exc](const Element& elem)
+                {
+                    try {
+                        // the invalidated entries are recomputed and stored in the cache again
+                        elemCtx.updatePrimaryStencil(elem);
+                        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    }
+                    catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                        exc = std::current_exception();
+                    }
+                };
+                if (batchSize > 0) {
+                    // the cells of a batch use the same PVT and saturation function tables
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+                    for (int b = 0; b < static_cast<int>(batches.numBatches()); ++b) {
+                        for (std::size_t k = batches.batchBegin(b); k < batches.batchEnd(b); ++k) {
+                            update(changedElements[batches.order()[k]]);
+                        }
+                    }
+                } else {
+#ifdef _OPENMP
+#pragma omp for
+#endif
+                    for (int i = 0; i < static_cast<int>(changedElements.size()); ++i) {
+                        update(changedElements[i]);
+                    }
+                }
+            }
+            if (exc) {
+                std::rethrow_exception(exc);
+            }
+        }
+
+        /// The cells sorted by the combination of their PVT, saturation function and
+        /// rock compaction table regions, and within a region by their Cartesian
+        /// indices, such that consecutive cells share their tables and are close to
+        /// each other. The key of the regions of each cell is in cell_region_keys_.
+        const std::vector<unsigned>& regionCellOrder_()
+        {
+            if (region_cell_order_.empty()) {
+                const auto& problem = ebosSimulator_.problem();
+                const auto& vanguard = ebosSimulator_.vanguard();
+                const unsigned numCells = ebosSimulator_.model().numGridDof();
+                unsigned numSatRegions = 1;
+                unsigned numRockTables = 1;
+                for (unsigned cell = 0; cell < numCells; ++cell) {
+                    numSatRegions = std::max(numSatRegions, problem.satnumRegionIndex(cell) + 1);
+                    numRockTables = std::max(numRockTables, problem.rockTableIndex(cell) + 1);
+                }
+                cell_region_keys_.resize(numCells);
+                for (unsigned cell = 0; cell < numCells; ++cell) {
+                    cell_region_keys_[cell] = (problem.pvtRegionIndex(cell) * numSatRegions
+                                               + problem.satnumRegionIndex(cell)) * numRockTables
+                        + problem.rockTableIndex(cell);
+                }
+                region_cell_order_.resize(numCells);
+                std::iota(region_cell_order_.begin(), region_cell_order_.end(), 0u);
+                std::sort(region_cell_order_.begin(), region_cell_order_.end(),
+                          [this, &vanguard](const unsigned a, const unsigned b)
+                          {
+                              const int keyA = cell_region_keys_[a];
+                              const int keyB = cell_region_keys_[b];
+                              return keyA < keyB
+                                  || (keyA == keyB && vanguard.cartesianIndex(a) < vanguard.cartesianIndex(b));
+                          });
+            }
+            return region_cell_order_;
+        }
+
+        /// Whether the intensive quantities evaluated for the primary variables oldPv
+        /// are not accurate enough for newPv.
+        bool primaryVarsChanged_(const PrimaryVariables& oldPv, const PrimaryVariables& newPv) const
+        {
+            if (oldPv.primaryVarsMeaning() != newPv.primaryVarsMeaning()) {
+                return true;
+            }
+            const Scalar tol = param_.intensive_quantities_reuse_tolerance_;
+            for (unsigned pvIdx = 0; pvIdx < newPv.size(); ++pvIdx) {
+                Scalar change = std::abs(newPv[pvIdx] - oldPv[pvIdx]);
+                if (pvIdx == Indices::pressureSwitchIdx) {
+                    change /= std::max(std::abs(oldPv[pvIdx]), Scalar(1e-10));
+                }
+                if (change > tol) {
+                    return true;
+                }
+            }
+            return false;
         }
 
         /// Return true if output to cout is wanted.
@@ -568,6 +1305,27 @@ namespace Opm {
             return terminal_output_;
         }
 
+        /// Layout of the values reduced by convergenceReduction(): B_avg and R_sum
+        /// interleaved and the pore volume, which are summed, followed by maxCoeff,
+        /// for which the maximum is taken.
+        static constexpr int numSumEntries_ = 2*numEq + 1;
+        using ConvergenceBuffer = std::array<Scalar, numSumEntries_ + numEq>;
+
+        struct SumAndMax
+        {
+            ConvergenceBuffer operator()(const ConvergenceBuffer& a, const ConvergenceBuffer& b) const
+            {
+                ConvergenceBuffer result;
+                for (int i = 0; i < numSumEntries_; ++i) {
+                    result[i] = a[i] + b[i];
+                }
+                for (int i = numSumEntries_; i < numSumEntries_ + numEq; ++i) {
+                    result[i] = std::max(a[i], b[i]);
+                }
+                return result;
+            }
+        };
+
         template <class CollectiveCommunication>
         double convergenceReduction(const CollectiveCommunication& comm,
                                     const double pvSumLocal,
@@ -575,190 +1333,233 @@ namespace Opm {
                                     std::vector< Scalar >& maxCoeff,
                                     std::vector< Scalar >& B_avg)
         {
+            OPM_TRACE_SCOPE("convergence reduction");
             // Compute total pore volume (use only owned entries)
             double pvSum = pvSumLocal;
 
             if( comm.size() > 1 )
             {
-                // global reduction
-                std::vector< Scalar > sumBuffer;
-                std::vector< Scalar > maxBuffer;
+                // global reduction, the sums and the maxima are reduced
+                // together with a single collective
                 const int numComp = B_avg.size();
-                sumBuffer.reserve( 2*numComp + 1 ); // +1 for pvSum
-                maxBuffer.reserve( numComp );
+                assert(numComp == numEq);
+                ConvergenceBuffer buffer;
                 for( int compIdx = 0; compIdx < numComp; ++compIdx )
                 {
-                    sumBuffer.push_back( B_avg[ compIdx ] );
-                    sumBuffer.push_back( R_sum[ compIdx ] );
-                    maxBuffer.push_back( maxCoeff[ compIdx ] );
+                    buffer[ 2*compIdx ]     = B_avg[ compIdx ];
+                    buffer[ 2*compIdx + 1 ] = R_sum[ compIdx ];
+                    buffer[ numSumEntries_ + compIdx ] = maxCoeff[ compIdx ];
                 }
 
                 // Compute total pore volume
-                sumBuffer.push_back( pvSum );
-
-                // compute global sum
-                comm.sum( sumBuffer.data(), sumBuffer.size() );
+                buffer[ 2*numComp ] = pvSum;
 
-                // compute global max
-                comm.max( maxBuffer.data(), maxBuffer.size() );
+                comm.template allreduce<SumAndMax>( &buffer, 1 );
 
                 // restore values to local variables
-                for( int compIdx = 0, buffIdx = 0; compIdx < numComp; ++compIdx, ++buffIdx )
-                {
-                    B_avg[ compIdx ]    = sumBuffer[ buffIdx ];
-                    ++buffIdx;
-
-                    R_sum[ compIdx ]       = sumBuffer[ buffIdx ];
-                }
-
                 for( int compIdx = 0; compIdx < numComp; ++compIdx )
                 {
-                    maxCoeff[ compIdx ] = maxBuffer[ compIdx ];
+                    B_avg[ compIdx ]    = buffer[ 2*compIdx ];
+                    R_sum[ compIdx ]    = buffer[ 2*compIdx + 1 ];
+                    maxCoeff[ compIdx ] = buffer[ numSumEntries_ + compIdx ];
                 }
 
                 // restore global pore volume
-                pvSum = sumBuffer.back();
+                pvSum = buffer[ 2*numComp ];
             }
 
             // return global pore volume
             return pvSum;
         }
 
+        /// The interior cells of this process in grid order, such that loops over them
+        /// can run over flat arrays instead of the grid. Collected on first use.
+        const std::vector<unsigned>& interiorCells_() const
+        {
+            if (interior_cells_.empty()) {
+                const auto& elemMapper = ebosSimulator_.model().elementMapper();
+                for (const auto& elem : elements(ebosSimulator_.gridView(), Dune::Partitions::interior)) {
+                    interior_cells_.push_back(elemMapper.index(elem));
+                }
+            }
+            return interior_cells_;
+        }
+
         // Get reservoir quantities on this process needed for convergence calculations.
         double localConvergenceData(std::vector<Scalar>& R_sum,
                                     std::vector<Scalar>& maxCoeff,
                                     std::vector<Scalar>& B_avg)
         {
-            double pvSumLocal = 0.0;
             const auto& ebosModel = ebosSimulator_.model();
             const auto& ebosProblem = ebosSimulator_.problem();
 
-            const auto& ebosResid = ebosSimulator_.model().linearizer().residual();
-
-            ElementContext elemCtx(ebosSimulator_);
-            const auto& gridView = ebosSimulator().gridView();
-            const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
-
-            for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
-                 elemIt != elemEndIt;
-                 ++elemIt)
-            {
-                const auto& elem = *elemIt;
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& fs = intQuants.fluidState();
+            const std::size_t numInterior = interiorCells_().size();
 
+            // the pore volumes are kept for computeCnvErrorPv() of the same iteration
+            interior_pore_volumes_.resize(numInterior);
+            double pvSumLocal = 0.0;
+            bool cacheComplete = true;
+            for (std::size_t i = 0; i < numInterior; ++i) {
+                const unsigned cell_idx = interior_cells_[i];
                 const double pvValue = ebosProblem.referencePorosity(cell_idx, /*timeIdx=*/0) * ebosModel.dofTotalVolume( cell_idx );
+                interior_pore_volumes_[i] = pvValue;
                 pvSumLocal += pvValue;
+                cacheComplete = cacheComplete && ebosModel.cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0) != nullptr;
+            }
 
-                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
-                {
-                    if (!FluidSystem::phaseIsActive(phaseIdx)) {
-                        continue;
-                    }
+            if (cacheComplete) {
+                for (std::size_t i = 0; i < numInterior; ++i) {
+                    const unsigned cell_idx = interior_cells_[i];
+                    addCellConvergenceData_(cell_idx, interior_pore_volumes_[i],
+                                            *ebosModel.cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0),
+                                            R_sum, maxCoeff, B_avg);
+                }
+            }
+            else {
+                // without the intensive quantity cache they have to be evaluated in
+                // the element context, the elements are visited in the same order
+                ElementContext elemCtx(ebosSimulator_);
+                std::size_t i = 0;
+                for (const auto& elem : elements(ebosSimulator_.gridView(), Dune::Partitions::interior)) {
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+                    addCellConvergenceData_(cell_idx, interior_pore_volumes_[i++],
+                                            elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0),
+                                            R_sum, maxCoeff, B_avg);
+                }
+            }
 
-                    const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+            // compute local average in terms of global number of elements
+            const int bSize = B_avg.size();
+            for ( int i = 0; i<bSize; ++i )
+            {
+                B_avg[ i ] /= Scalar( global_nc_ );
+            }
 
-                    B_avg[ compIdx ] += 1.0 / fs.invB(phaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][compIdx];
+            return pvSumLocal;
+        }
 
-                    R_sum[ compIdx ] += R2;
-                    maxCoeff[ compIdx ] = std::max( maxCoeff[ compIdx ], std::abs( R2 ) / pvValue );
-                }
+        void addCellConvergenceData_(const unsigned cell_idx,
+                                     const double pvValue,
+                                     const IntensiveQuantities& intQuants,
+                                     std::vector<Scalar>& R_sum,
+                                     std::vector<Scalar>& maxCoeff,
+                                     std::vector<Scalar>& B_avg) const
+        {
+            const auto& ebosResid = ebosSimulator_.model().linearizer().residual();
+            const auto& fs = intQuants.fluidState();
 
-                if constexpr (has_solvent_) {
-                    B_avg[ contiSolventEqIdx ] += 1.0 / intQuants.solventInverseFormationVolumeFactor().value();
-                    const auto R2 = ebosResid[cell_idx][contiSolventEqIdx];
-                    R_sum[ contiSolventEqIdx ] += R2;
-                    maxCoeff[ contiSolventEqIdx ] = std::max( maxCoeff[ contiSolventEqIdx ], std::abs( R2 ) / pvValue );
-                }
-                if constexpr (has_extbo_) {
-                    B_avg[ contiZfracEqIdx ] += 1.0 / fs.invB(FluidSystem::gasPhaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][contiZfracEqIdx];
-                    R_sum[ contiZfracEqIdx ] += R2;
-                    maxCoeff[ contiZfracEqIdx ] = std::max( maxCoeff[ contiZfracEqIdx ], std::abs( R2 ) / pvValue );
-                }
-                if constexpr (has_polymer_) {
-                    B_avg[ contiPolymerEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][contiPolymerEqIdx];
-                    R_sum[ contiPolymerEqIdx ] += R2;
-                    maxCoeff[ contiPolymerEqIdx ] = std::max( maxCoeff[ contiPolymerEqIdx ], std::abs( R2 ) / pvValue );
-                }
-                if constexpr (has_foam_) {
-                    B_avg[ contiFoamEqIdx ] += 1.0 / fs.invB(FluidSystem::gasPhaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][contiFoamEqIdx];
-                    R_sum[ contiFoamEqIdx ] += R2;
-                    maxCoeff[ contiFoamEqIdx ] = std::max( maxCoeff[ contiFoamEqIdx ], std::abs( R2 ) / pvValue );
-                }
-                if constexpr (has_brine_) {
-                    B_avg[ contiBrineEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][contiBrineEqIdx];
-                    R_sum[ contiBrineEqIdx ] += R2;
-                    maxCoeff[ contiBrineEqIdx ] = std::max( maxCoeff[ contiBrineEqIdx ], std::abs( R2 ) / pvValue );
+            for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+            {
+                if (!PhaseActivity::phaseIsActive(phaseIdx)) {
+                    continue;
                 }
 
-                if constexpr (has_polymermw_) {
-                    static_assert(has_polymer_);
+                const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
 
-                    B_avg[contiPolymerMWEqIdx] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    // the residual of the polymer molecular equation is scaled down by a 100, since molecular weight
-                    // can be much bigger than 1, and this equation shares the same tolerance with other mass balance equations
-                    // TODO: there should be a more general way to determine the scaling-down coefficient
-                    const auto R2 = ebosResid[cell_idx][contiPolymerMWEqIdx] / 100.;
-                    R_sum[contiPolymerMWEqIdx] += R2;
-                    maxCoeff[contiPolymerMWEqIdx] = std::max( maxCoeff[contiPolymerMWEqIdx], std::abs( R2 ) / pvValue );
-                }
+                B_avg[ compIdx ] += 1.0 / fs.invB(phaseIdx).value();
+                const auto R2 = ebosResid[cell_idx][compIdx];
 
-                if constexpr (has_energy_) {
-                    B_avg[ contiEnergyEqIdx ] += 1.0;
-                    const auto R2 = ebosResid[cell_idx][contiEnergyEqIdx];
-                    R_sum[ contiEnergyEqIdx ] += R2;
-                    maxCoeff[ contiEnergyEqIdx ] = std::max( maxCoeff[ contiEnergyEqIdx ], std::abs( R2 ) / pvValue );
-                }
+                R_sum[ compIdx ] += R2;
+                maxCoeff[ compIdx ] = std::max( maxCoeff[ compIdx ], std::abs( R2 ) / pvValue );
+            }
 
+            if constexpr (has_solvent_) {
+                B_avg[ contiSolventEqIdx ] += 1.0 / intQuants.solventInverseFormationVolumeFactor().value();
+                const auto R2 = ebosResid[cell_idx][contiSolventEqIdx];
+                R_sum[ contiSolventEqIdx ] += R2;
+                maxCoeff[ contiSolventEqIdx ] = std::max( maxCoeff[ contiSolventEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            if constexpr (has_extbo_) {
+                B_avg[ contiZfracEqIdx ] += 1.0 / fs.invB(FluidSystem::gasPhaseIdx).value();
+                const auto R2 = ebosResid[cell_idx][contiZfracEqIdx];
+                R_sum[ contiZfracEqIdx ] += R2;
+                maxCoeff[ contiZfracEqIdx ] = std::max( maxCoeff[ contiZfracEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            if constexpr (has_polymer_) {
+                B_avg[ contiPolymerEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
+                const auto R2 = ebosResid[cell_idx][contiPolymerEqIdx];
+                R_sum[ contiPolymerEqIdx ] += R2;
+                maxCoeff[ contiPolymerEqIdx ] = std::max( maxCoeff[ contiPolymerEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            if constexpr (has_foam_) {
+                B_avg[ contiFoamEqIdx ] += 1.0 / fs.invB(FluidSystem::gasPhaseIdx).value();
+                const auto R2 = ebosResid[cell_idx][contiFoamEqIdx];
+                R_sum[ contiFoamEqIdx ] += R2;
+                maxCoeff[ contiFoamEqIdx ] = std::max( maxCoeff[ contiFoamEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            if constexpr (has_brine_) {
+                B_avg[ contiBrineEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
+                const auto R2 = ebosResid[cell_idx][contiBrineEqIdx];
+                R_sum[ contiBrineEqIdx ] += R2;
+                maxCoeff[ contiBrineEqIdx ] = std::max( maxCoeff[ contiBrineEqIdx ], std::abs( R2 ) / pvValue );
             }
 
-            // compute local average in terms of global number of elements
-            const int bSize = B_avg.size();
-            for ( int i = 0; i<bSize; ++i )
-            {
-                B_avg[ i ] /= Scalar( global_nc_ );
+            if constexpr (has_polymermw_) {
+                static_assert(has_polymer_);
+
+                B_avg[contiPolymerMWEqIdx] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
+                // the residual of the polymer molecular equation is scaled down by a 100, since molecular weight
+                // can be much bigger than 1, and this equation shares the same tolerance with other mass balance equations
+                // TODO: there should be a more general way to determine the scaling-down coefficient
+                const auto R2 = ebosResid[cell_idx][contiPolymerMWEqIdx] / 100.;
+                R_sum[contiPolymerMWEqIdx] += R2;
+                maxCoeff[contiPolymerMWEqIdx] = std::max( maxCoeff[contiPolymerMWEqIdx], std::abs( R2 ) / pvValue );
             }
 
-            return pvSumLocal;
+            if constexpr (has_energy_) {
+                B_avg[ contiEnergyEqIdx ] += 1.0;
+                const auto R2 = ebosResid[cell_idx][contiEnergyEqIdx];
+                R_sum[ contiEnergyEqIdx ] += R2;
+                maxCoeff[ contiEnergyEqIdx ] = std::max( maxCoeff[ contiEnergyEqIdx ], std::abs( R2 ) / pvValue );
+            }
         }
 
+        /// The pore volume of the interior cells violating the CNV tolerance, summed over
+        /// all processes. It uses the pore volumes stored by localConvergenceData().
+        /// The cell with the largest CNV is recorded if the hotspots are counted.
         double computeCnvErrorPv(const std::vector<Scalar>& B_avg, double dt)
         {
             double errorPV{};
-            const auto& ebosModel = ebosSimulator_.model();
-            const auto& ebosProblem = ebosSimulator_.problem();
             const auto& ebosResid = ebosSimulator_.model().linearizer().residual();
-            const auto& gridView = ebosSimulator().gridView();
-            ElementContext elemCtx(ebosSimulator_);
+            const Scalar tol_cnv = param_.tolerance_cnv_;
+            auto& hotspots = ebosSimulator_.problem().convergenceHotspots();
+            Scalar maxCnv = -1.0;
+            int maxCnvCell = -1;
 
-            for (const auto& elem: elements(gridView, Dune::Partitions::interiorBorder))
+            const std::size_t numInterior = interior_cells_.size();
+            for (std::size_t i = 0; i < numInterior; ++i)
             {
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const double pvValue = ebosProblem.referencePorosity(cell_idx, /*timeIdx=*/0) * ebosModel.dofTotalVolume( cell_idx );
-                const auto& cellResidual = ebosResid[cell_idx];
+                const double pvValue = interior_pore_volumes_[i];
+                const auto& cellResidual = ebosResid[interior_cells_[i]];
                 bool cnvViolated = false;
+                Scalar cellMaxCnv = 0.0;
 
                 for (unsigned eqIdx = 0; eqIdx < cellResidual.size(); ++eqIdx)
                 {
                     using std::abs;
                     Scalar CNV = cellResidual[eqIdx] * dt * B_avg[eqIdx] / pvValue;
-                    cnvViolated = cnvViolated || (abs(CNV) > param_.tolerance_cnv_);
+                    cnvViolated = cnvViolated || (abs(CNV) > tol_cnv);
+                    cellMaxCnv = std::max(cellMaxCnv, Scalar(abs(CNV)));
                 }
 
                 if (cnvViolated)
                 {
                     errorPV += pvValue;
                 }
+                if (cellMaxCnv > maxCnv) {
+                    maxCnv = cellMaxCnv;
+                    maxCnvCell = interior_cells_[i];
+                }
+            }
+
+            if (hotspots.enabled()) {
+                // the cell is counted by the lowest rank which has the global maximum
+                const auto& comm = grid_.comm();
+                const Scalar globalMaxCnv = comm.max(maxCnv);
+                const int owner = comm.min(maxCnv == globalMaxCnv ? comm.rank() : comm.size());
+                hotspots.recordMaxCnv(owner == comm.rank() ? maxCnvCell : -1);
             }
 
             return grid_.comm().sum(errorPV);
@@ -806,7 +1607,7 @@ namespace Opm {
             if (compNames.empty()) {
                 compNames.resize(numComp);
                 for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                    if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                    if (!PhaseActivity::phaseIsActive(phaseIdx)) {
                         continue;
                     }
                     const unsigned canonicalCompIdx = FluidSystem::solventComponentIndex(phaseIdx);
@@ -916,6 +1717,7 @@ namespace Opm {
             std::vector<Scalar> B_avg(numEq, 0.0);
             auto report = getReservoirConvergence(timer.currentStepLength(), iteration, B_avg, residual_norms);
             report += wellModel().getWellConvergence(B_avg);
+            convergence_B_avg_ = B_avg;
 
             return report;
         }
@@ -996,7 +1798,48 @@ namespace Opm {
         double current_relaxation_;
         BVector dx_old_;
 
+        // B_avg of the last convergence check, and the cells updated by the localized Newton method
+        std::vector<Scalar> convergence_B_avg_;
+        std::vector<char> localized_newton_active_;
+
+        // only set if the Newton updates are computed sequentially
+        std::unique_ptr<SequentialImplicitSolver<Mat, BVector>> sequential_solver_;
+
+        // only set if the energy equation of a thermal run is solved after the flow equations
+        std::unique_ptr<DecoupledEnergySolver<Mat, BVector>> energy_solver_;
+
+        // the primary variables for which the cached intensive quantities were computed
+        std::vector<PrimaryVariables> evaluated_primary_vars_;
+        bool evaluated_primary_vars_valid_ = false;
+        unsigned long intensive_quantities_computed_ = 0;
+        unsigned long intensive_quantities_reused_ = 0;
+        // the regions of every cell, the cells in the order of their regions and the
+        // batches of the cells evaluated last (--intensive-quantities-batch-size)
+        std::vector<int> cell_region_keys_;
+        std::vector<unsigned> region_cell_order_;
+        RegionBatches intensive_quantities_batches_;
+
+        // the last converged solutions and their times, for the extrapolated initial guess
+        std::deque<std::pair<double, SolutionVector>> converged_solutions_;
+
+        // the history of the Anderson acceleration within the time step
+        std::deque<BVector> anderson_du_;
+        std::deque<BVector> anderson_df_;
+        SolutionVector anderson_last_solution_;
+        BVector anderson_last_dx_;
+        std::vector<char> anderson_excluded_;
+
+        // the solution before the last Newton update, the update and the sum of the
+        // CNV residuals before it, for the backtracking line search
+        SolutionVector line_search_solution_;
+        BVector line_search_dx_;
+        double line_search_merit_ = 0.0;
+
         std::vector<StepReport> convergence_reports_;
+
+        // the interior cells of this process and their pore volumes in the last convergence check
+        mutable std::vector<unsigned> interior_cells_;
+        std::vector<double> interior_pore_volumes_;
     public:
         /// return the StandardWells object
         BlackoilWellModel<TypeTag>&
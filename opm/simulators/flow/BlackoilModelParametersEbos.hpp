@@ -104,9 +104,93 @@ struct MatrixAddWellContributions {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct UsePackedWellOperator {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct UseLocalizedNewton {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct SequentialImplicit {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct SequentialPressureTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct SequentialNearWellSweeps {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct DecoupledEnergy {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct DecoupledEnergyTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LocalizedNewtonBufferLayers {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct EnableIntensiveQuantitiesReuse {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct IntensiveQuantitiesBatchSize {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct ParallelWellAssembly {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OverlapWellAssembly {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct ReuseWellObjects {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct IntensiveQuantitiesReuseTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct FrozenCellUpdateThreshold {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct EnableWellOperabilityCheck {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct FailedStepInitialGuess {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct SolutionExtrapolationOrder {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct AndersonAccelerationDepth {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LineSearchMaxCuts {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct WellTestUnchangedTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OutputConvergenceHotspots {
+    using type = UndefinedProperty;
+};
 
 // parameters for multisegment wells
 template<class TypeTag, class MyTypeTag>
@@ -150,6 +234,14 @@ struct MaxInnerIterWells {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct InnerIterSkipPressureChange {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct WellConnectionPressureTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct AlternativeWellRateInit {
     using type = UndefinedProperty;
 };
@@ -233,6 +325,95 @@ struct MatrixAddWellContributions<TypeTag, TTag::FlowModelParameters> {
     static constexpr bool value = false;
 };
 template<class TypeTag>
+struct UsePackedWellOperator<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct UseLocalizedNewton<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct SequentialImplicit<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct SequentialPressureTolerance<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 1e-3;
+};
+template<class TypeTag>
+struct SequentialNearWellSweeps<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct DecoupledEnergy<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct DecoupledEnergyTolerance<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 1e-4;
+};
+template<class TypeTag>
+struct LocalizedNewtonBufferLayers<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 1;
+};
+template<class TypeTag>
+struct EnableIntensiveQuantitiesReuse<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct IntensiveQuantitiesBatchSize<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct ParallelWellAssembly<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct OverlapWellAssembly<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct ReuseWellObjects<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct IntensiveQuantitiesReuseTolerance<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct FrozenCellUpdateThreshold<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct FailedStepInitialGuess<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct SolutionExtrapolationOrder<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct AndersonAccelerationDepth<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct LineSearchMaxCuts<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct WellTestUnchangedTolerance<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct OutputConvergenceHotspots<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
 struct TolerancePressureMsWells<TypeTag, TTag::FlowModelParameters> {
     using type = GetPropType<TypeTag, Scalar>;
     static constexpr type value = 0.01*1e5;
@@ -259,6 +440,16 @@ struct MaxInnerIterWells<TypeTag, TTag::FlowModelParameters> {
     static constexpr int value = 50;
 };
 template<class TypeTag>
+struct InnerIterSkipPressureChange<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct WellConnectionPressureTolerance<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
 struct AlternativeWellRateInit<TypeTag, TTag::FlowModelParameters> {
     static constexpr bool value = true;
 };
@@ -355,6 +546,14 @@ namespace Opm
         /// Maximum inner iteration number for standard wells
         int max_inner_iter_wells_;
 
+        /// Maximum pressure change of the perforated cells of a well since its last
+        /// converged inner iterations in the time step, up to which they are skipped [Pa]
+        double inner_iter_skip_pressure_change_;
+
+        /// Largest relative change of the bhp, connection pressures and rates of a standard
+        /// well since its connection pressures were computed, up to which they are reused
+        double well_connection_pressure_tolerance_;
+
         /// Maximum iteration number of the well equation solution
         int max_welleq_iter_;
 
@@ -387,6 +586,77 @@ namespace Opm
         // Whether to add influences of wells between cells to the matrix and preconditioner matrix
         bool matrix_add_well_contributions_;
 
+        // Whether to copy the well matrices into one buffer before the linear solve
+        bool use_packed_well_operator_;
+
+        /// Whether to only update the cells violating the CNV tolerance after the first Newton iteration
+        bool use_localized_newton_;
+
+        /// Number of layers of neighbouring cells which are updated together with the violating cells
+        int localized_newton_buffer_layers_;
+
+        /// Whether to compute the Newton updates by a pressure solve followed by a transport sweep
+        bool sequential_implicit_;
+
+        /// Relative residual reduction of the pressure solves of the sequential implicit updates
+        double sequential_pressure_tolerance_;
+
+        /// Number of additional transport sweeps over the cells around wells in the sequential implicit updates
+        int sequential_near_well_sweeps_;
+
+        /// Whether to solve the energy equation after the flow equations in the linear solves of thermal runs
+        bool decoupled_energy_;
+
+        /// Relative residual reduction of the energy solves of the decoupled linear solves
+        double decoupled_energy_tolerance_;
+
+        /// Whether to keep the intensive quantities of the cells whose primary variables did not change
+        bool enable_intensive_quantities_reuse_;
+
+        /// The maximum number of cells of a batch of cells with the same PVT,
+        /// saturation function and rock compaction regions whose intensive
+        /// quantities are evaluated together, 0 to evaluate them in the order of the grid
+        int intensive_quantities_batch_size_;
+
+        /// Whether to assemble the equations of the wells which are not distributed
+        /// over several processes concurrently using OpenMP threads
+        bool parallel_well_assembly_;
+
+        /// Whether to assemble the well equations on a separate thread while the
+        /// reservoir is linearized, only used in serial runs
+        bool overlap_well_assembly_;
+
+        /// Whether to keep the objects of the standard wells whose definition
+        /// and perforations did not change when the wells are set up for a time step
+        bool reuse_well_objects_;
+
+        /// Change of the primary variables below which the intensive quantities are kept,
+        /// relative for the pressure and absolute for the other variables
+        Scalar intensive_quantities_reuse_tolerance_;
+
+        /// Newton update below which a cell is frozen after the first iteration, 0 disables freezing
+        Scalar frozen_cell_update_threshold_;
+
+        /// Whether a chopped time step starts from the interpolation between the previous solution and the last iterate of the failed attempt
+        bool failed_step_initial_guess_;
+
+        /// Order of the extrapolation of the last converged solutions used as initial guess of a time step, 0 disables it
+        int solution_extrapolation_order_;
+
+        /// Number of previous Newton updates combined by the Anderson acceleration of the nonlinear update, 0 disables it
+        int anderson_acceleration_depth_;
+
+        /// Maximum number of halvings of a Newton update by the backtracking line search, 0 disables it
+        int line_search_max_cuts_;
+
+        /// Change of the pressures (relative) and saturations of the cells of a well since its last
+        /// failed well test below which the next test is skipped, 0 always tests the well
+        Scalar well_test_unchanged_tolerance_;
+
+        /// Whether to count per cell how often it had the largest CNV, the chops and the
+        /// linear iterations while it had, and to write the counters as restart and VTK arrays
+        bool output_convergence_hotspots_;
+
         /// Construct from user parameters or defaults.
         BlackoilModelParametersEbos()
         {
@@ -411,12 +681,35 @@ namespace Opm
             regularization_factor_ms_wells_ = EWOMS_GET_PARAM(TypeTag, Scalar, RegularizationFactorMsw);
             use_inner_iterations_wells_ = EWOMS_GET_PARAM(TypeTag, bool, UseInnerIterationsWells);
             max_inner_iter_wells_ = EWOMS_GET_PARAM(TypeTag, int, MaxInnerIterWells);
+            inner_iter_skip_pressure_change_ = EWOMS_GET_PARAM(TypeTag, Scalar, InnerIterSkipPressureChange);
+            well_connection_pressure_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, WellConnectionPressureTolerance);
             maxSinglePrecisionTimeStep_ = EWOMS_GET_PARAM(TypeTag, Scalar, MaxSinglePrecisionDays) *24*60*60;
             max_strict_iter_ = EWOMS_GET_PARAM(TypeTag, int, MaxStrictIter);
             solve_welleq_initially_ = EWOMS_GET_PARAM(TypeTag, bool, SolveWelleqInitially);
             update_equations_scaling_ = EWOMS_GET_PARAM(TypeTag, bool, UpdateEquationsScaling);
             use_update_stabilization_ = EWOMS_GET_PARAM(TypeTag, bool, UseUpdateStabilization);
             matrix_add_well_contributions_ = EWOMS_GET_PARAM(TypeTag, bool, MatrixAddWellContributions);
+            use_packed_well_operator_ = EWOMS_GET_PARAM(TypeTag, bool, UsePackedWellOperator);
+            use_localized_newton_ = EWOMS_GET_PARAM(TypeTag, bool, UseLocalizedNewton);
+            localized_newton_buffer_layers_ = EWOMS_GET_PARAM(TypeTag, int, LocalizedNewtonBufferLayers);
+            sequential_implicit_ = EWOMS_GET_PARAM(TypeTag, bool, SequentialImplicit);
+            sequential_pressure_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, SequentialPressureTolerance);
+            sequential_near_well_sweeps_ = EWOMS_GET_PARAM(TypeTag, int, SequentialNearWellSweeps);
+            decoupled_energy_ = EWOMS_GET_PARAM(TypeTag, bool, DecoupledEnergy);
+            decoupled_energy_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, DecoupledEnergyTolerance);
+            enable_intensive_quantities_reuse_ = EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantitiesReuse);
+            intensive_quantities_batch_size_ = EWOMS_GET_PARAM(TypeTag, int, IntensiveQuantitiesBatchSize);
+            parallel_well_assembly_ = EWOMS_GET_PARAM(TypeTag, bool, ParallelWellAssembly);
+            overlap_well_assembly_ = EWOMS_GET_PARAM(TypeTag, bool, OverlapWellAssembly);
+            reuse_well_objects_ = EWOMS_GET_PARAM(TypeTag, bool, ReuseWellObjects);
+            intensive_quantities_reuse_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, IntensiveQuantitiesReuseTolerance);
+            frozen_cell_update_threshold_ = EWOMS_GET_PARAM(TypeTag, Scalar, FrozenCellUpdateThreshold);
+            failed_step_initial_guess_ = EWOMS_GET_PARAM(TypeTag, bool, FailedStepInitialGuess);
+            solution_extrapolation_order_ = EWOMS_GET_PARAM(TypeTag, int, SolutionExtrapolationOrder);
+            anderson_acceleration_depth_ = EWOMS_GET_PARAM(TypeTag, int, AndersonAccelerationDepth);
+            line_search_max_cuts_ = EWOMS_GET_PARAM(TypeTag, int, LineSearchMaxCuts);
+            well_test_unchanged_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, WellTestUnchangedTolerance);
+            output_convergence_hotspots_ = EWOMS_GET_PARAM(TypeTag, bool, OutputConvergenceHotspots);
 
             deck_file_name_ = EWOMS_GET_PARAM(TypeTag, std::string, EclDeckFileName);
         }
@@ -444,6 +737,8 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, int, StrictInnerIterMsWells, "Number of inner iterations for multi-segment wells with strict tolerance");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseInnerIterationsWells, "Use nested iterations for standard wells");
             EWOMS_REGISTER_PARAM(TypeTag, int, MaxInnerIterWells, "Maximum number of inner iterations for standard wells");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, InnerIterSkipPressureChange, "Skip the inner iterations of a well if they converged before in the time step with the same control and the pressures of its perforated cells changed less than this since then [Pa]. Disabled if zero");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, WellConnectionPressureTolerance, "Reuse the connection densities and pressure differences of a standard well while its bhp and connection pressures changed by less than this fraction and its connection rates by less than this fraction of the well rate since they were computed. Disabled if zero");
             EWOMS_REGISTER_PARAM(TypeTag, bool, AlternativeWellRateInit, "Use alternative well rate initialization procedure");
             EWOMS_REGISTER_PARAM(TypeTag, Scalar, RegularizationFactorMsw, "Regularization factor for ms wells");
             EWOMS_REGISTER_PARAM(TypeTag, Scalar, MaxSinglePrecisionDays, "Maximum time step size where single precision floating point arithmetic can be used solving for the linear systems of equations");
@@ -452,6 +747,27 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, bool, UpdateEquationsScaling, "Update scaling factors for mass balance equations during the run");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseUpdateStabilization, "Try to detect and correct oscillations or stagnation during the Newton method");
             EWOMS_REGISTER_PARAM(TypeTag, bool, MatrixAddWellContributions, "Explicitly specify the influences of wells between cells in the Jacobian and preconditioner matrices");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UsePackedWellOperator, "Copy the B, C and D^-1 matrices of the standard wells into one contiguous buffer for the well part of the linear operator, only used without --matrix-add-well-contributions");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseLocalizedNewton, "After the first Newton iteration of a time step, only update the cells which violate the CNV tolerance, the cells perforated by wells and a buffer around them");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LocalizedNewtonBufferLayers, "Number of layers of neighbouring cells added to the cells updated by the localized Newton method");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, SequentialImplicit, "Compute the Newton updates by a quasi-IMPES pressure solve followed by a transport sweep ordered by pressure instead of the fully implicit linear solve. Only used in serial runs with --matrix-add-well-contributions=true");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, SequentialPressureTolerance, "Relative residual reduction of the pressure solves of --sequential-implicit");
+            EWOMS_REGISTER_PARAM(TypeTag, int, SequentialNearWellSweeps, "Number of additional transport sweeps of --sequential-implicit over the cells perforated by wells and their neighbours");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, DecoupledEnergy, "In thermal runs, solve the linear systems without the energy equation by the configured linear solver first and then the energy equation for the temperature with the flow update fixed. Only used in serial runs with --matrix-add-well-contributions=true");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, DecoupledEnergyTolerance, "Relative residual reduction of the energy solves of --decoupled-energy");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, EnableIntensiveQuantitiesReuse, "Only recompute the intensive quantities of the cells whose primary variables changed in the last Newton update");
+            EWOMS_REGISTER_PARAM(TypeTag, int, IntensiveQuantitiesBatchSize, "Evaluate the intensive quantities in batches of at most this number of cells which share their PVT, saturation function and rock compaction regions, ordered by their Cartesian indices within a region, such that the cells of a thread use the same tables, 0 to evaluate them in the order of the grid");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, ParallelWellAssembly, "Assemble the equations of the wells which are not distributed over several processes concurrently, requires OpenMP");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, OverlapWellAssembly, "Assemble the well equations on a separate thread while the reservoir is linearized, the perforated cells wait for them. Only used in serial runs");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, ReuseWellObjects, "Keep the objects and matrices of the standard wells whose definition and perforations did not change from one time step or report step to the next, instead of creating them again");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, IntensiveQuantitiesReuseTolerance, "Change of the primary variables below which the intensive quantities of a cell are reused, relative for the pressure and absolute for the saturations and dissolution factors. 0 only reuses unchanged cells");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, FrozenCellUpdateThreshold, "After the first Newton iteration of a time step, drop the update of the cells not perforated by wells if it is below this threshold for all primary variables (relative for the pressure), such that these cells keep their intensive quantities. 0 disables freezing");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, FailedStepInitialGuess, "Start a chopped time step from the interpolation between the solution at the beginning of the step and the last iterate of the failed attempt, instead of the solution at the beginning of the step");
+            EWOMS_REGISTER_PARAM(TypeTag, int, SolutionExtrapolationOrder, "Start each time step from the extrapolation of the last converged solutions of this order (1 for linear, 2 for quadratic), instead of the last converged solution. 0 disables the extrapolation");
+            EWOMS_REGISTER_PARAM(TypeTag, int, AndersonAccelerationDepth, "Combine the Newton update with this many previous updates of the time step by Anderson acceleration, restarted when the residual grows. 0 disables the acceleration");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LineSearchMaxCuts, "Halve the last Newton update of the reservoir up to this many times while it does not reduce the sum of the CNV residuals, each trial is evaluated by a linearization. 0 disables the line search");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, WellTestUnchangedTolerance, "Skip the well test (WTEST) of a well whose last test failed while the pressures (relative) and saturations of its cells changed less than this since. 0 always tests the wells");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, OutputConvergenceHotspots, "Count per cell how often it had the largest CNV, the time step chops and the linear iterations while it had, and write the counters as the restart arrays HSCNVMAX, HSCHOPS and HSLINITS and to the VTK output");
             EWOMS_REGISTER_PARAM(TypeTag, bool, EnableWellOperabilityCheck, "Enable the well operability checking");
         }
     };
@@ -26,9 +26,13 @@
 #include <sys/utsname.h>
 
 #include <opm/simulators/flow/SimulatorFullyImplicitBlackoilEbos.hpp>
+#include <opm/simulators/timestepping/LoadBalanceReport.hpp>
 #include <opm/simulators/utils/ParallelFileMerger.hpp>
 #include <opm/simulators/utils/moduleVersion.hpp>
 #include <opm/simulators/utils/ParallelEclipseState.hpp>
+#include <opm/simulators/utils/PerfCounters.hpp>
+#include <opm/simulators/utils/StartupProfile.hpp>
+#include <opm/simulators/utils/Tracing.hpp>
 
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/IOConfig/IOConfig.hpp>
@@ -57,6 +61,30 @@ template<class TypeTag, class MyTypeTag>
 struct EnableLoggingFalloutWarning {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct OutputStartupProfile {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OutputLoadBalanceSteps {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OutputTimingJson {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OutputPerfCounters {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OutputTrace {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct TraceBufferSize {
+    using type = UndefinedProperty;
+};
 
 // TODO: enumeration parameters. we use strings for now.
 template<class TypeTag>
@@ -72,6 +100,30 @@ template<class TypeTag>
 struct OutputInterval<TypeTag, TTag::EclFlowProblem> {
     static constexpr int value = 1;
 };
+template<class TypeTag>
+struct OutputStartupProfile<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct OutputLoadBalanceSteps<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct OutputTimingJson<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct OutputPerfCounters<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct OutputTrace<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct TraceBufferSize<TypeTag, TTag::EclFlowProblem> {
+    static constexpr int value = 1 << 16;
+};
 
 } // namespace Opm::Properties
 
@@ -123,6 +175,19 @@ namespace Opm
                                  "Specify the number of report steps between two consecutive writes of restart data");
             EWOMS_REGISTER_PARAM(TypeTag, bool, EnableLoggingFalloutWarning,
                                  "Developer option to see whether logging was on non-root processors. In that case it will be appended to the *.DBG or *.PRT files");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, OutputStartupProfile,
+                                 "Write the wall time and memory usage of the startup phases to <CASE>.STARTUP.json");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, OutputLoadBalanceSteps,
+                                 "Write the timings of each report step over the processes to <CASE>.LOADBALANCE");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, OutputTimingJson,
+                                 "Write the timings, the iteration counts and the peak memory of the run to <CASE>.TIMING.json");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, OutputPerfCounters,
+                                 "Print the hardware performance counters of the solver kernels of the first process "
+                                 "at the end of the run (requires building with ENABLE_PERF_COUNTERS)");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, OutputTrace,
+                                 "Write the trace of the hot paths of the simulation to <CASE>.TRACE.json (requires building with ENABLE_TRACING)");
+            EWOMS_REGISTER_PARAM(TypeTag, int, TraceBufferSize,
+                                 "The number of trace events kept per thread, the oldest events are overwritten");
 
             Simulator::registerParameters();
 
@@ -274,7 +339,36 @@ namespace Opm
             return status;
         }
 
-        static void printBanner()
+        /// The number of processes of the simulation running on the node of this
+        /// process. This is collective over all processes.
+        static int processesOnNode()
+        {
+            int localSize = 1;
+#if HAVE_MPI
+            MPI_Comm nodeComm;
+            MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, /*key=*/0, MPI_INFO_NULL, &nodeComm);
+            MPI_Comm_size(nodeComm, &localSize);
+            MPI_Comm_free(&nodeComm);
+#endif
+            return localSize;
+        }
+
+#if _OPENMP
+        /// The number of threads per process unless it is given by
+        /// --threads-per-process: the one of OMP_NUM_THREADS if it is set,
+        /// otherwise 2, but not more than the cores of the node divided by the
+        /// processes running on it, such that hybrid runs do not oversubscribe.
+        static int defaultThreadsPerProcess(const int processesOnNode)
+        {
+            if (getenv("OMP_NUM_THREADS"))
+                return omp_get_max_threads();
+            return std::max(1, std::min(2, omp_get_num_procs() / std::max(1, processesOnNode)));
+        }
+#endif
+
+        /// \param processesOnNode  the result of processesOnNode(), which must be
+        ///                         called by all processes
+        static void printBanner([[maybe_unused]] const int processesOnNode)
         {
             const int lineLen = 70;
             const std::string version = moduleVersionName();
@@ -297,11 +391,8 @@ namespace Opm
 #ifdef _OPENMP
             // This function is called before the parallel OpenMP stuff gets initialized.
             // That initialization happends after the deck is read and we want this message.
-            // Hence we duplicate the code of setupParallelism to get the number of threads.
-            if (getenv("OMP_NUM_THREADS"))
-                threads =  omp_get_max_threads();
-            else
-                threads = std::min(2, omp_get_max_threads());
+            // Hence we use the same default as setupParallelism to get the number of threads.
+            threads = defaultThreadsPerProcess(processesOnNode);
 
             const int input_threads = EWOMS_GET_PARAM(TypeTag, int, ThreadsPerProcess);
 
@@ -455,9 +546,11 @@ namespace Opm
 #endif
 
 #if _OPENMP
-            // if openMP is available, default to 2 threads per process.
+            // if openMP is available, default to 2 threads per process, or fewer
+            // if the processes on this node would oversubscribe its cores.
+            const int nodeProcesses = processesOnNode();
             if (!getenv("OMP_NUM_THREADS"))
-                omp_set_num_threads(std::min(2, omp_get_num_procs()));
+                omp_set_num_threads(defaultThreadsPerProcess(nodeProcesses));
 #endif
 
             using ThreadManager = GetPropType<TypeTag, Properties::ThreadManager>;
@@ -490,10 +583,12 @@ namespace Opm
             {
                 basename = uppercase(deck_filename.filename().string());
             }
-            std::for_each(fs::directory_iterator(output_path),
-                          fs::directory_iterator(),
-                          detail::ParallelFileMerger(output_path, basename,
-                                                     EWOMS_GET_PARAM(TypeTag, bool, EnableLoggingFalloutWarning)));
+            detail::ParallelFileMerger merger(output_path, basename,
+                                              EWOMS_GET_PARAM(TypeTag, bool, EnableLoggingFalloutWarning));
+            for (const auto& entry : fs::directory_iterator(output_path)) {
+                merger(entry.path());
+            }
+            merger.merge();
         }
 
         void setupEbosSimulator()
@@ -559,7 +654,52 @@ namespace Opm
         // Callback that will be called from runSimulatorInitOrRun_().
         int runSimulatorRunCallback_()
         {
+            const bool outputTrace = EWOMS_GET_PARAM(TypeTag, bool, OutputTrace);
+            const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+            if (outputTrace) {
+#if !HAVE_TRACING
+                if (this->output_cout_) {
+                    OpmLog::warning("Flow was built without ENABLE_TRACING, the trace will be empty");
+                }
+#endif
+                Tracing::start(std::max(EWOMS_GET_PARAM(TypeTag, int, TraceBufferSize), 0), comm);
+            }
+            const bool outputPerfCounters = EWOMS_GET_PARAM(TypeTag, bool, OutputPerfCounters);
+            if (outputPerfCounters) {
+#if !HAVE_PERF_COUNTERS
+                if (this->output_cout_) {
+                    OpmLog::warning("Flow was built without ENABLE_PERF_COUNTERS, no kernels are counted");
+                }
+#else
+                if (this->output_cout_ && !PerfCounters::countersAvailable()) {
+                    OpmLog::warning("The hardware performance counters are not available "
+                                    "(see kernel.perf_event_paranoid), only the times are recorded");
+                }
+#endif
+                PerfCounters::start();
+            }
+
             SimulatorReport report = simulator_->run(*simtimer_);
+
+            if (outputPerfCounters) {
+                PerfCounters::stop();
+                if (this->output_cout_) {
+                    std::ostringstream ss;
+                    ss << "\nHardware performance counters of the solver kernels of process 0:\n";
+                    PerfCounters::report(ss);
+                    OpmLog::info(ss.str());
+                }
+            }
+
+            if (outputTrace) {
+                Tracing::stop();
+                // collective, the events of all processes are written to one file
+                const auto& ioConfig = eclState().getIOConfig();
+                namespace fs = ::Opm::filesystem;
+                const fs::path fullpath = fs::path(ioConfig.getOutputDir()) / (ioConfig.getBaseName() + ".TRACE.json");
+                Tracing::writeChromeTrace(fullpath.string(), comm);
+            }
+
             runSimulatorAfterSim_(report);
             return report.success.exit_status;
         }
@@ -574,6 +714,24 @@ namespace Opm
         // Output summary after simulation has completed
         void runSimulatorAfterSim_(SimulatorReport &report)
         {
+            // collective, the reports of all processes are gathered to rank 0
+            std::unique_ptr<LoadBalanceReport> loadBalance;
+            if (mpi_size_ > 1) {
+                const auto& grid = ebosSimulator_->vanguard().grid();
+                loadBalance = std::make_unique<LoadBalanceReport>(
+                    report,
+                    detail::countLocalInteriorCells(grid),
+                    ebosSimulator_->problem().wellModel().numLocalOpenWells(),
+                    EWOMS_GET_PARAM(TypeTag, bool, OutputLoadBalanceSteps),
+                    Dune::MPIHelper::getCollectiveCommunication());
+            }
+
+            const bool outputTimingJson = EWOMS_GET_PARAM(TypeTag, bool, OutputTimingJson);
+            long peakRss = 0;
+            if (outputTimingJson) {
+                peakRss = Dune::MPIHelper::getCollectiveCommunication().max(StartupProfile::peakRss());
+            }
+
             if (this->output_cout_) {
                 std::ostringstream ss;
                 ss << "\n\n================    End of simulation     ===============\n\n";
@@ -585,6 +743,10 @@ namespace Opm
 #endif
                 ss << fmt::format("Threads per MPI process: {:9}\n", threads);
                 report.reportFullyImplicit(ss);
+                if (loadBalance) {
+                    ss << '\n';
+                    loadBalance->report(ss);
+                }
                 OpmLog::info(ss.str());
                 const std::string dir = eclState().getIOConfig().getOutputDir();
                 namespace fs = ::Opm::filesystem;
@@ -595,6 +757,23 @@ namespace Opm
                     std::ofstream os(fullpath.string());
                     report.fullReports(os);
                 }
+                if (loadBalance && loadBalance->numSteps() > 0) {
+                    std::string filename = eclState().getIOConfig().getBaseName() + ".LOADBALANCE";
+                    fs::path fullpath = output_dir / filename;
+                    std::ofstream os(fullpath.string());
+                    loadBalance->reportSteps(os);
+                }
+                if (outputTimingJson) {
+                    // read by tests/compare-performance.py
+                    std::string filename = eclState().getIOConfig().getBaseName() + ".TIMING.json";
+                    fs::path fullpath = output_dir / filename;
+                    std::ofstream os(fullpath.string());
+                    os << fmt::format("{{\"case\": \"{}\", \"processes\": {}, \"threads\": {}, "
+                                      "\"peak_rss_kib\": {}, \"report\": ",
+                                      eclState().getIOConfig().getBaseName(), mpi_size_, threads, peakRss);
+                    report.reportJson(os);
+                    os << "}\n";
+                }
             }
         }
 
@@ -604,6 +783,14 @@ namespace Opm
 
             const auto& schedule = this->schedule();
             auto& ioConfig = eclState().getIOConfig();
+
+            if (EWOMS_GET_PARAM(TypeTag, bool, OutputStartupProfile)) {
+                // collective, the phases are combined over all processes
+                namespace fs = ::Opm::filesystem;
+                const fs::path fullpath = fs::path(ioConfig.getOutputDir()) / (ioConfig.getBaseName() + ".STARTUP.json");
+                StartupProfile::writeJson(fullpath.string(), Dune::MPIHelper::getCollectiveCommunication());
+            }
+
             simtimer_ = std::make_unique<SimulatorTimer>();
 
             // initialize variables
@@ -17,9 +17,11 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 
 #include <fmt/format.h>
 
@@ -97,18 +99,40 @@ namespace KeywordValidation
         }
     }
 
+    std::unordered_map<std::string, unsigned char>
+    KeywordValidator::keywordKinds(const UnsupportedKeywords& keywords,
+                                   const PartiallySupportedKeywords<std::string>& string_items,
+                                   const PartiallySupportedKeywords<int>& int_items)
+    {
+        std::unordered_map<std::string, unsigned char> kinds;
+        kinds.reserve(keywords.size() + string_items.size() + int_items.size());
+        for (const auto& keyword : keywords)
+            kinds[keyword.first] |= Unsupported;
+        for (const auto& keyword : string_items)
+            kinds[keyword.first] |= StringItems;
+        for (const auto& keyword : int_items)
+            kinds[keyword.first] |= IntItems;
+        return kinds;
+    }
+
     void KeywordValidator::validateDeckKeyword(const DeckKeyword& keyword, std::vector<ValidationError>& errors) const
     {
-        const auto& it = m_keywords.find(keyword.name());
-        if (it != m_keywords.end()) {
+        // Most keywords are fully supported, these need a single lookup only.
+        const auto kind = m_keyword_kinds.find(keyword.name());
+        if (kind == m_keyword_kinds.end())
+            return;
+
+        if (kind->second & Unsupported) {
             // If the keyword is not supported, add an error for that.
-            const auto& properties = it->second;
+            const auto& properties = m_keywords.at(keyword.name());
             errors.push_back(ValidationError {
                 properties.critical, keyword.location(), 1, std::nullopt, std::nullopt, properties.message});
         } else {
             // Otherwise, check all its items.
-            validateKeywordItems(keyword, m_string_items, errors);
-            validateKeywordItems(keyword, m_int_items, errors);
+            if (kind->second & StringItems)
+                validateKeywordItems(keyword, m_string_items, errors);
+            if (kind->second & IntItems)
+                validateKeywordItems(keyword, m_int_items, errors);
         }
     }
 
@@ -120,23 +144,23 @@ namespace KeywordValidation
     {
         const auto& keyword_properties = partially_supported_items.find(keyword.name());
         if (keyword_properties != partially_supported_items.end()) {
-            // If this keyworcs has partially supported items, iterate over all of them.
+            // If this keyword has partially supported items, check only those
+            // items of each record, in ascending order of the item number.
             for (size_t record_index = 0; record_index < keyword.size(); record_index++) {
                 const auto& record = keyword.getRecord(record_index);
-                for (size_t item_index = 0; item_index < record.size(); item_index++) {
+                for (const auto& [item_number, item_properties] : keyword_properties->second) {
+                    // The item number starts counting at one.
+                    if (item_number == 0 || item_number > record.size())
+                        continue;
+                    const size_t item_index = item_number - 1;
                     const auto& item = record.getItem(item_index);
-                    // Find the index number, which starts counting at one, so item_index + 1
-                    const auto& item_properties = keyword_properties->second.find(item_index + 1);
-                    if (item_properties != keyword_properties->second.end()) {
-                        // Validate the item, if it is partially supported.
-                        validateKeywordItem<T>(keyword,
-                                               item_properties->second,
-                                               keyword.size() > 1,
-                                               record_index,
-                                               item_index,
-                                               item.get<T>(0),
-                                               errors);
-                    }
+                    validateKeywordItem<T>(keyword,
+                                           item_properties,
+                                           keyword.size() > 1,
+                                           record_index,
+                                           item_index,
+                                           item.get<T>(0),
+                                           errors);
                 }
             }
         }
@@ -25,6 +25,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace Opm
@@ -90,6 +91,7 @@ namespace KeywordValidation
             : m_keywords(keywords)
             , m_string_items(string_items)
             , m_int_items(int_items)
+            , m_keyword_kinds(keywordKinds(keywords, string_items, int_items))
         {
         }
 
@@ -103,6 +105,19 @@ namespace KeywordValidation
         void validateDeckKeyword(const DeckKeyword& keyword, std::vector<ValidationError>& errors) const;
 
     private:
+        // Flags of the keywords which need to be checked, any other keyword
+        // is supported and is skipped after a single lookup.
+        enum KeywordKind : unsigned char {
+            Unsupported = 1,
+            StringItems = 2,
+            IntItems = 4
+        };
+
+        static std::unordered_map<std::string, unsigned char>
+        keywordKinds(const UnsupportedKeywords& keywords,
+                     const PartiallySupportedKeywords<std::string>& string_items,
+                     const PartiallySupportedKeywords<int>& int_items);
+
         template <typename T>
         void validateKeywordItem(const DeckKeyword& keyword,
                                  const PartiallySupportedKeywordProperties<T>& properties,
@@ -121,6 +136,7 @@ namespace KeywordValidation
         const UnsupportedKeywords m_keywords;
         const PartiallySupportedKeywords<std::string> m_string_items;
         const PartiallySupportedKeywords<int> m_int_items;
+        const std::unordered_map<std::string, unsigned char> m_keyword_kinds;
     };
 
 
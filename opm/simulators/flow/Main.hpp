@@ -23,6 +23,9 @@
 #define OPM_MAIN_HEADER_INCLUDED
 
 #include <flow/flow_ebos_blackoil.hpp>
+#if FLOW_ISA_DISPATCH
+#  include <flow/flow_isa_dispatch.hpp>
+#endif
 
 # ifndef FLOW_BLACKOIL_ONLY
 #  include <flow/flow_ebos_gasoil.hpp>
@@ -51,6 +54,7 @@
 #include <opm/models/utils/parametersystem.hh>
 
 #include <opm/simulators/flow/FlowMainEbos.hpp>
+#include <opm/simulators/utils/DeferredLogger.hpp>
 #include <opm/simulators/utils/readDeck.hpp>
 
 #if HAVE_DUNE_FEM
@@ -136,6 +140,21 @@ namespace Opm
             argv_ = saveArgs_;
         }
 
+        // Run the case of the given file from already parsed input, e.g.
+        // copies of the input of another simulator of the same case.
+        Main(const std::string &filename,
+             std::unique_ptr<Deck> deck,
+             std::unique_ptr<EclipseState> eclipseState,
+             std::unique_ptr<Schedule> schedule,
+             std::unique_ptr<SummaryConfig> summaryConfig)
+            : Main(filename)
+        {
+            deck_ = std::move(deck);
+            eclipseState_ = std::move(eclipseState);
+            schedule_ = std::move(schedule);
+            summaryConfig_ = std::move(summaryConfig);
+        }
+
         Main(int argc,
              char** argv,
              std::unique_ptr<Deck> deck,
@@ -322,6 +341,17 @@ namespace Opm
 #endif // FLOW_BLACKOIL_ONLY
             // Blackoil case
             else if( phases.size() == 3 ) {
+#if FLOW_ISA_DISPATCH
+                // prefer the module built for the instruction set extensions of the CPU
+                std::string isaName;
+                if (auto isaMain = loadFlowBlackoilIsaVariant(isaName)) {
+                    if (outputCout_)
+                        std::cout << "Using the blackoil simulator built for " << isaName << std::endl;
+                    return isaMain(argc_, argv_, outputCout_, outputFiles_, setupTime_,
+                                   deck_.release(), eclipseState_.release(),
+                                   schedule_.release(), summaryConfig_.release());
+                }
+#endif
                 flowEbosBlackoilSetDeck(setupTime_, std::move(deck_),
                                         std::move(eclipseState_),
                                         std::move(schedule_),
@@ -427,8 +457,9 @@ namespace Opm
                 exitCode = EXIT_FAILURE;
                 return false;
             }
+            const int processesOnNode = FlowMainEbos<PreTypeTag>::processesOnNode();
             if (outputCout_) {
-                FlowMainEbos<PreTypeTag>::printBanner();
+                FlowMainEbos<PreTypeTag>::printBanner(processesOnNode);
             }
             // Create Deck and EclipseState.
             try {
@@ -441,6 +472,11 @@ namespace Opm
                                           outputDir,
                                           EWOMS_GET_PARAM(PreTypeTag, std::string, OutputMode),
                                           outputCout_, "STDOUT_LOGGER");
+                // The debug messages only go to the DBG file, do not collect
+                // them in the deferred loggers if it is not written.
+                if (outputMode == FileOutputMode::OUTPUT_NONE) {
+                    DeferredLogger::setEnabledMessageTypes(Log::NoDebugMessageTypes);
+                }
                 auto parseContext =
                     std::make_unique<ParseContext>(std::vector<std::pair<std::string , InputError::Action>>
                                                    {{ParseContext::PARSE_RANDOM_SLASH, InputError::IGNORE},
@@ -0,0 +1,333 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SIMULATOR_CHECKPOINT_HEADER_INCLUDED
+#define OPM_SIMULATOR_CHECKPOINT_HEADER_INCLUDED
+
+#include <opm/common/utility/FileSystem.hpp>
+#include <opm/output/data/Aquifer.hpp>
+#include <opm/output/data/Groups.hpp>
+#include <opm/output/data/Wells.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/IOConfig/IOConfig.hpp>
+
+#include <opm/models/utils/propertysystem.hh>
+
+#include <opm/simulators/utils/CheckpointBuffer.hpp>
+#include <opm/simulators/utils/DeferredLoggingErrorHelpers.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// Rank local binary checkpoints of a running simulation.
+///
+/// Each process writes the state of its own cells, wells and aquifers to a
+/// file of its own, no data is communicated between the processes. A
+/// checkpoint can therefore only be read by a run with the same number of
+/// processes and the same partitioning of the grid, which is verified by
+/// the cartesian indices of the cells. The first process writes a manifest
+/// once all processes have written their files, such that an interrupted
+/// write leaves the previous checkpoint usable.
+template <class TypeTag>
+class SimulatorCheckpoint
+{
+    using Simulator = GetPropType<TypeTag, Properties::Simulator>;
+    enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
+
+    static constexpr int version = 1;
+    static constexpr const char* magic = "OPM-CHECKPOINT";
+
+public:
+    explicit SimulatorCheckpoint(Simulator& simulator)
+        : simulator_(simulator)
+    {}
+
+    /// Directory of the checkpoints of the case.
+    static std::string directory(const EclipseState& eclState)
+    {
+        const auto& ioConfig = eclState.getIOConfig();
+        return ioConfig.getOutputDir() + "/" + ioConfig.getBaseName() + ".CHECKPOINT";
+    }
+
+    /// Whether a complete checkpoint of the case exists.
+    static bool exists(const EclipseState& eclState)
+    { return filesystem::exists(directory(eclState) + "/manifest"); }
+
+    /// Write the state at the beginning of report step reportStep, i.e. at
+    /// the end of the step before it.
+    void write(const int reportStep, const double nextTimeStepSize)
+    {
+        const auto& comm = simulator_.vanguard().grid().comm();
+        const std::string dir = directory(simulator_.vanguard().eclState());
+
+        collectiveTry_("Creating the checkpoint directory failed: ", [&]()
+        {
+            if (comm.rank() == 0)
+                filesystem::create_directories(dir);
+        });
+        collectiveTry_("Writing the checkpoint failed: ", [&]()
+        { writeRankFile_(dir, reportStep, nextTimeStepSize); });
+        collectiveTry_("Writing the checkpoint manifest failed: ", [&]()
+        {
+            if (comm.rank() == 0)
+                writeManifest_(dir, reportStep);
+        });
+
+        // the new checkpoint is complete, the previous one is not needed anymore
+        if (lastReportStep_ >= 0 && lastReportStep_ != reportStep)
+            filesystem::remove(rankFile_(dir, lastReportStep_, comm.rank()));
+        lastReportStep_ = reportStep;
+    }
+
+    /// Restore the state of the last checkpoint.
+    ///
+    /// \return The report step at which to continue and the size of the
+    ///         next time step.
+    std::pair<int, double> read()
+    {
+        const auto result = readFrom(directory(simulator_.vanguard().eclState()));
+        lastReportStep_ = result.first;
+        return result;
+    }
+
+    /// Restore the state of the checkpoint in dir, e.g. one written by the
+    /// history run of a prediction case with the same grid and partitioning.
+    /// The checkpoint is only read, the checkpoints written later go to the
+    /// directory of this case.
+    ///
+    /// \return The report step at which to continue and the size of the
+    ///         next time step.
+    std::pair<int, double> readFrom(const std::string& dir)
+    {
+        std::pair<int, double> result;
+        collectiveTry_("Reading the checkpoint failed: ", [&]()
+        { result = readRankFile_(dir); });
+        return result;
+    }
+
+private:
+    static std::string rankFile_(const std::string& dir, const int reportStep, const int rank)
+    { return dir + "/step" + std::to_string(reportStep) + ".rank" + std::to_string(rank); }
+
+    // Run func on all processes and throw on all of them if it failed on one.
+    template <class Func>
+    static void collectiveTry_(const std::string& message, Func&& func)
+    {
+        auto exc_type = ExceptionType::NONE;
+        std::string exc_msg;
+        try {
+            func();
+        } catch (const std::runtime_error& e) {
+            exc_type = ExceptionType::RUNTIME_ERROR;
+            exc_msg = e.what();
+        } catch (const std::invalid_argument& e) {
+            exc_type = ExceptionType::INVALID_ARGUMENT;
+            exc_msg = e.what();
+        } catch (const std::logic_error& e) {
+            exc_type = ExceptionType::LOGIC_ERROR;
+            exc_msg = e.what();
+        } catch (const std::exception& e) {
+            exc_type = ExceptionType::DEFAULT;
+            exc_msg = e.what();
+        }
+        checkForExceptionsAndThrow(exc_type, message + exc_msg);
+    }
+
+    void writeRankFile_(const std::string& dir, const int reportStep, const double nextTimeStepSize) const
+    {
+        const auto& comm = simulator_.vanguard().grid().comm();
+
+        CheckpointBuffer buffer;
+        buffer.write(std::string(magic));
+        buffer.write(version);
+        buffer.write(comm.rank());
+        buffer.write(comm.size());
+        buffer.write(reportStep);
+        buffer.write(nextTimeStepSize);
+
+        writeSolution_(buffer);
+        simulator_.problem().writeCheckpoint(buffer);
+        writeWellsAndAquifers_(buffer, reportStep);
+        buffer.write(simulator_.vanguard().summaryState().serialize());
+
+        buffer.save(rankFile_(dir, reportStep, comm.rank()));
+    }
+
+    void writeManifest_(const std::string& dir, const int reportStep) const
+    {
+        const auto& ioConfig = simulator_.vanguard().eclState().getIOConfig();
+
+        CheckpointManifest manifest;
+        manifest.version = version;
+        manifest.caseName = ioConfig.getBaseName();
+        manifest.processes = simulator_.vanguard().grid().comm().size();
+        manifest.reportStep = reportStep;
+        manifest.time = simulator_.time() + simulator_.timeStepSize();
+        manifest.save(dir + "/manifest");
+    }
+
+    std::pair<int, double> readRankFile_(const std::string& dir)
+    {
+        const auto& comm = simulator_.vanguard().grid().comm();
+
+        const auto manifest = CheckpointManifest::load(dir + "/manifest");
+        if (manifest.version != version)
+            throw std::runtime_error("Unsupported checkpoint version " + std::to_string(manifest.version));
+        if (manifest.processes != comm.size())
+            throw std::runtime_error("The checkpoint was written by " + std::to_string(manifest.processes)
+                                     + " processes, it can not be read by " + std::to_string(comm.size()));
+        if (manifest.reportStep >= static_cast<int>(simulator_.vanguard().schedule().size()))
+            throw std::runtime_error("The checkpoint of case " + manifest.caseName + " is at report step "
+                                     + std::to_string(manifest.reportStep) + ", after the end of the schedule");
+
+        auto buffer = CheckpointBuffer::load(rankFile_(dir, manifest.reportStep, comm.rank()));
+        std::string fileMagic;
+        int fileVersion = 0;
+        int rank = 0;
+        int size = 0;
+        int reportStep = 0;
+        double nextTimeStepSize = 0.0;
+        buffer.read(fileMagic);
+        buffer.read(fileVersion);
+        buffer.read(rank);
+        buffer.read(size);
+        buffer.read(reportStep);
+        buffer.read(nextTimeStepSize);
+        if (fileMagic != magic || fileVersion != version || rank != comm.rank()
+            || size != comm.size() || reportStep != manifest.reportStep)
+            throw std::runtime_error("The checkpoint file of process " + std::to_string(comm.rank())
+                                     + " does not match the manifest");
+
+        readSolution_(buffer);
+        simulator_.problem().readCheckpoint(buffer);
+        readWellsAndAquifers_(buffer, reportStep);
+
+        std::vector<char> summaryState;
+        buffer.read(summaryState);
+        simulator_.vanguard().summaryState().deserialize(summaryState);
+
+        if (!buffer.atEnd())
+            throw std::runtime_error("The checkpoint file of process " + std::to_string(comm.rank())
+                                     + " contains unexpected data");
+
+        return {reportStep, nextTimeStepSize};
+    }
+
+    void writeSolution_(CheckpointBuffer& buffer) const
+    {
+        const auto& vanguard = simulator_.vanguard();
+        const auto& solution = simulator_.model().solution(/*timeIdx=*/0);
+        const std::size_t numCells = solution.size();
+
+        std::vector<unsigned> cartesianIdx(numCells);
+        for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            cartesianIdx[cellIdx] = vanguard.cartesianIndex(cellIdx);
+        buffer.write(cartesianIdx);
+
+        for (const auto& priVars : solution) {
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                buffer.write(static_cast<double>(priVars[eqIdx]));
+            buffer.write(static_cast<int>(priVars.primaryVarsMeaning()));
+            buffer.write(static_cast<unsigned>(priVars.pvtRegionIndex()));
+        }
+    }
+
+    void readSolution_(CheckpointBuffer& buffer)
+    {
+        const auto& vanguard = simulator_.vanguard();
+        auto& model = simulator_.model();
+        auto& solution = model.solution(/*timeIdx=*/0);
+        const std::size_t numCells = solution.size();
+
+        std::vector<unsigned> cartesianIdx;
+        buffer.read(cartesianIdx);
+        bool samePartition = cartesianIdx.size() == numCells;
+        for (std::size_t cellIdx = 0; samePartition && cellIdx < numCells; ++cellIdx)
+            samePartition = cartesianIdx[cellIdx] == vanguard.cartesianIndex(cellIdx);
+        if (!samePartition)
+            throw std::runtime_error("The checkpoint was written with another partitioning of the grid");
+
+        using PrimaryVariables = typename std::decay_t<decltype(solution)>::block_type;
+        for (auto& priVars : solution) {
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                double value = 0.0;
+                buffer.read(value);
+                priVars[eqIdx] = value;
+            }
+            int meaning = 0;
+            unsigned pvtRegionIdx = 0;
+            buffer.read(meaning);
+            buffer.read(pvtRegionIdx);
+            priVars.setPrimaryVarsMeaning(static_cast<typename PrimaryVariables::PrimaryVarsMeaning>(meaning));
+            priVars.setPvtRegionIndex(pvtRegionIdx);
+        }
+
+        model.solution(/*timeIdx=*/1) = solution;
+        model.invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+    }
+
+    void writeWellsAndAquifers_(CheckpointBuffer& buffer, const int reportStep) const
+    {
+        auto& problem = simulator_.problem();
+        problem.wellModel().wellData().write(buffer);
+        problem.wellModel().groupAndNetworkData(reportStep, simulator_.vanguard().schedule()).write(buffer);
+
+        const auto aquifers = problem.mutableAquiferModel().aquiferData();
+        buffer.write(aquifers.size());
+        for (const auto& [key, aquifer] : aquifers) {
+            buffer.write(key);
+            aquifer.write(buffer);
+        }
+    }
+
+    void readWellsAndAquifers_(CheckpointBuffer& buffer, const int reportStep)
+    {
+        auto& problem = simulator_.problem();
+
+        data::Wells wells;
+        data::GroupAndNetworkValues grpNwrk;
+        wells.read(buffer);
+        grpNwrk.read(buffer);
+        problem.wellModel().initFromCheckpoint(wells, grpNwrk, reportStep);
+
+        std::size_t numAquifers = 0;
+        buffer.read(numAquifers);
+        std::vector<data::AquiferData> aquifers(numAquifers);
+        for (auto& aquifer : aquifers) {
+            int key = 0;
+            buffer.read(key);
+            aquifer.read(buffer);
+        }
+        if (!aquifers.empty())
+            problem.mutableAquiferModel().initFromRestart(aquifers);
+    }
+
+    Simulator& simulator_;
+    int lastReportStep_ = -1;
+};
+
+} // namespace Opm
+
+#endif // OPM_SIMULATOR_CHECKPOINT_HEADER_INCLUDED
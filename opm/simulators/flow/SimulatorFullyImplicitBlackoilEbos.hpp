@@ -25,14 +25,24 @@
 #include <opm/simulators/flow/NonlinearSolverEbos.hpp>
 #include <opm/simulators/flow/BlackoilModelEbos.hpp>
 #include <opm/simulators/flow/BlackoilModelParametersEbos.hpp>
+#include <opm/simulators/flow/SimulatorCheckpoint.hpp>
 #include <opm/simulators/wells/WellState.hpp>
 #include <opm/simulators/aquifers/BlackoilAquiferModel.hpp>
+#include <opm/simulators/utils/MemoryReport.hpp>
 #include <opm/simulators/utils/moduleVersion.hpp>
+#include <opm/simulators/utils/RunMetrics.hpp>
+#include <opm/simulators/utils/StartupProfile.hpp>
 #include <opm/simulators/timestepping/AdaptiveTimeSteppingEbos.hpp>
 #include <opm/grid/utility/StopWatch.hpp>
 
 #include <opm/common/ErrorMacros.hpp>
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 namespace Opm::Properties {
 
 template<class TypeTag, class MyTypeTag>
@@ -43,6 +53,30 @@ template<class TypeTag, class MyTypeTag>
 struct EnableTuning {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct LoadImbalanceThreshold {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OutputMemoryReport {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct CheckpointInterval {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct ResumeFromCheckpoint {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct ResumeFromSnapshot {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct OutputMetricsFile {
+    using type = UndefinedProperty;
+};
 
 template<class TypeTag>
 struct EnableTerminalOutput<TypeTag, TTag::EclFlowProblem> {
@@ -56,6 +90,30 @@ template<class TypeTag>
 struct EnableTuning<TypeTag, TTag::EclFlowProblem> {
     static constexpr bool value = false;
 };
+template<class TypeTag>
+struct LoadImbalanceThreshold<TypeTag, TTag::EclFlowProblem> {
+    static constexpr double value = 0.0;
+};
+template<class TypeTag>
+struct OutputMemoryReport<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct CheckpointInterval<TypeTag, TTag::EclFlowProblem> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct ResumeFromCheckpoint<TypeTag, TTag::EclFlowProblem> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct ResumeFromSnapshot<TypeTag, TTag::EclFlowProblem> {
+    static constexpr auto value = "";
+};
+template<class TypeTag>
+struct OutputMetricsFile<TypeTag, TTag::EclFlowProblem> {
+    static constexpr auto value = "";
+};
 
 } // namespace Opm::Properties
 
@@ -118,6 +176,10 @@ public:
         const auto& comm = grid().comm();
         terminalOutput_ = EWOMS_GET_PARAM(TypeTag, bool, EnableTerminalOutput);
         terminalOutput_ = terminalOutput_ && (comm.rank() == 0);
+        loadImbalanceThreshold_ = EWOMS_GET_PARAM(TypeTag, double, LoadImbalanceThreshold);
+        checkpointInterval_ = EWOMS_GET_PARAM(TypeTag, int, CheckpointInterval);
+        outputMemoryReport_ = EWOMS_GET_PARAM(TypeTag, bool, OutputMemoryReport);
+        metricsFile_ = EWOMS_GET_PARAM(TypeTag, std::string, OutputMetricsFile);
     }
 
     static void registerParameters()
@@ -132,6 +194,25 @@ public:
                              "Use adaptive time stepping between report steps");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTuning,
                              "Honor some aspects of the TUNING keyword.");
+        EWOMS_REGISTER_PARAM(TypeTag, double, LoadImbalanceThreshold,
+                             "Warn at the end of a report step if the maximum assembly time of a process "
+                             "exceeds this multiple of the mean over all processes (0 to disable)");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, OutputMemoryReport,
+                             "Print the memory usage of the major data structures at the start "
+                             "and at the end of every report step");
+        EWOMS_REGISTER_PARAM(TypeTag, int, CheckpointInterval,
+                             "Write a rank local checkpoint every this many report steps (0 to disable)");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, ResumeFromCheckpoint,
+                             "Continue the simulation from the last checkpoint written with the same "
+                             "number of processes");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, ResumeFromSnapshot,
+                             "Continue the simulation from the checkpoint in this directory, e.g. the "
+                             "CHECKPOINT directory of the history run of a prediction case. It must have "
+                             "been written with the same grid and number of processes and is only read");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, OutputMetricsFile,
+                             "Rewrite this file with the progress, throughput, iteration counts and memory "
+                             "usage of the run after every report step, in the Prometheus text format if "
+                             "the name ends with .prom and as JSON otherwise");
     }
 
     /// Run the simulation.
@@ -179,6 +260,32 @@ public:
                 adaptiveTimeStepping_->setSuggestedNextStep(ebosSimulator_.timeStepSize());
             }
         }
+
+        const bool resume = EWOMS_GET_PARAM(TypeTag, bool, ResumeFromCheckpoint);
+        const std::string snapshot = EWOMS_GET_PARAM(TypeTag, std::string, ResumeFromSnapshot);
+        if (resume && !snapshot.empty()) {
+            OPM_THROW(std::invalid_argument, "Only one of --resume-from-checkpoint and "
+                      "--resume-from-snapshot can be given");
+        }
+        if (checkpointInterval_ > 0 || resume || !snapshot.empty()) {
+            checkpoint_ = std::make_unique<SimulatorCheckpoint<TypeTag>>(ebosSimulator_);
+        }
+        if (resume || !snapshot.empty()) {
+            const auto [reportStep, nextStep] = resume ? checkpoint_->read()
+                                                       : checkpoint_->readFrom(snapshot);
+            timer.setCurrentStepNum(reportStep);
+            if (adaptiveTimeStepping_ && nextStep > 0.0) {
+                adaptiveTimeStepping_->setSuggestedNextStep(nextStep);
+            }
+            if (terminalOutput_) {
+                OpmLog::info(fmt::format("Resuming the simulation from the {} at report step {}",
+                                         resume ? "checkpoint" : "snapshot " + snapshot, reportStep));
+            }
+        }
+
+        if (outputMemoryReport_) {
+            reportMemory_("Memory usage at the start of the simulation", /*linearized=*/false);
+        }
     }
 
     bool runStep(SimulatorTimer& timer)
@@ -237,6 +344,7 @@ public:
         ebosSimulator_.setEpisodeIndex(timer.currentStepNum());
         solver->model().beginReportStep();
         bool enableTUNING = EWOMS_GET_PARAM(TypeTag, bool, EnableTuning);
+        const double assembleTimeBefore = report_.success.assemble_time + report_.failure.assemble_time;
 
         // If sub stepping is enabled allow the solver to sub cycle
         // in case the report steps are too large for the solver to converge
@@ -267,6 +375,12 @@ public:
             }
         }
 
+        if (loadImbalanceThreshold_ > 0.0) {
+            const double assembleTime = report_.success.assemble_time + report_.failure.assemble_time
+                - assembleTimeBefore;
+            checkLoadImbalance_(assembleTime, timer.currentStepNum());
+        }
+
         // write simulation state at the report stage
         Dune::Timer perfTimer;
         perfTimer.start();
@@ -274,15 +388,36 @@ public:
         ebosSimulator_.problem().setNextTimeStepSize(nextstep);
         ebosSimulator_.problem().writeOutput();
         report_.success.output_write_time += perfTimer.stop();
+        report_.success.max_output_queue_depth =
+            std::max<unsigned int>(report_.success.max_output_queue_depth,
+                                   ebosSimulator_.problem().eclOutputQueueDepth());
 
         solver->model().endReportStep();
 
+        if (outputMemoryReport_) {
+            reportMemory_(fmt::format("Memory usage at the end of report step {}", timer.currentStepNum()),
+                          /*linearized=*/true);
+        }
+
+        const int nextReportStep = timer.currentStepNum() + 1;
+        if (checkpointInterval_ > 0 && nextReportStep % checkpointInterval_ == 0
+            && nextReportStep < timer.numSteps()) {
+            Dune::Timer checkpointTimer;
+            checkpointTimer.start();
+            checkpoint_->write(nextReportStep, nextstep);
+            report_.success.output_write_time += checkpointTimer.stop();
+        }
+
         // take time that was used to solve system for this reportStep
         solverTimer_->stop();
 
         // update timing.
         report_.success.solver_time += solverTimer_->secsSinceStart();
 
+        if (!metricsFile_.empty()) {
+            writeMetrics_(timer);
+        }
+
         // Increment timer, remember well state.
         ++timer;
 
@@ -336,6 +471,113 @@ protected:
         return std::make_unique<Solver>(solverParam_, std::move(model));
     }
 
+    /// Compare the assembly time of the report step between the processes, and warn
+    /// if the slowest one exceeds the threshold times the mean. The time per cell
+    /// of each process is reported as well, as it shows whether the imbalance is
+    /// caused by the number of cells or by expensive cells (wells, EOR, ...).
+    void checkLoadImbalance_(const double assembleTime, const int reportStep)
+    {
+        const auto& comm = grid().comm();
+        if (comm.size() == 1) {
+            return;
+        }
+
+        const double local[2] = { assembleTime, static_cast<double>(ebosSimulator_.gridView().size(/*codim=*/0)) };
+        std::vector<double> all(comm.rank() == 0 ? 2 * comm.size() : 0);
+        comm.gather(local, all.data(), 2, 0);
+        if (!terminalOutput_) {
+            return;
+        }
+
+        int slowest = 0;
+        double sumTime = 0.0;
+        double sumCells = 0.0;
+        for (int rank = 0; rank < comm.size(); ++rank) {
+            sumTime += all[2 * rank];
+            sumCells += all[2 * rank + 1];
+            if (all[2 * rank] > all[2 * slowest]) {
+                slowest = rank;
+            }
+        }
+        const double meanTime = sumTime / comm.size();
+        if (meanTime <= 0.0 || all[2 * slowest] <= loadImbalanceThreshold_ * meanTime) {
+            return;
+        }
+
+        const double slowestCells = std::max(all[2 * slowest + 1], 1.0);
+        const double meanCells = std::max(sumCells / comm.size(), 1.0);
+        OpmLog::warning("Load imbalance",
+                        fmt::format("Assembly load imbalance {:.2f} (max/mean) in report step {}.\n"
+                                    "Process {} spent {:.2f} s on {:.0f} cells ({:.3g} s per cell), "
+                                    "the mean is {:.2f} s on {:.0f} cells ({:.3g} s per cell).",
+                                    all[2 * slowest] / meanTime, reportStep,
+                                    slowest, all[2 * slowest], all[2 * slowest + 1], all[2 * slowest] / slowestCells,
+                                    meanTime, sumCells / comm.size(), meanTime / meanCells));
+    }
+
+    /// Print the sizes of the major data structures. This is collective. The
+    /// Jacobian and the preconditioner are allocated on the first linearization.
+    void reportMemory_(const std::string& title, const bool linearized)
+    {
+        MemoryReport report;
+        auto& model = ebosSimulator_.model();
+        report.add("Jacobian and residual", linearized
+                   ? matrixMemoryUsage(model.linearizer().jacobian().istlMatrix())
+                     + vectorMemoryUsage(model.linearizer().residual())
+                   : 0);
+        model.newtonMethod().linearSolver().memoryUsage(report);
+        wellModel_().memoryUsage(report);
+        report.add("Output collection", ebosSimulator_.problem().eclOutputMemoryUsage());
+
+        std::ostringstream ss;
+        report.print(ss, title, grid().comm());
+        if (terminalOutput_) {
+            OpmLog::info(ss.str());
+        }
+    }
+
+    /// Rewrite the metrics file at the end of a report step. This is collective
+    /// for the memory usage, only the process with rank 0 writes the file.
+    void writeMetrics_(const SimulatorTimer& timer)
+    {
+        const auto& comm = grid().comm();
+        const long rss = StartupProfile::currentRss();
+        const long maxRss = comm.max(rss);
+        const long sumRss = comm.sum(rss);
+        if (comm.rank() != 0) {
+            return;
+        }
+
+        RunMetrics metrics;
+        metrics.caseName = eclState().getIOConfig().getBaseName();
+        metrics.reportStep = timer.currentStepNum() + 1;
+        metrics.numReportSteps = timer.numSteps();
+        metrics.simulatedDays = unit::convert::to(timer.simulationTimeElapsed() + timer.currentStepLength(), unit::day);
+        metrics.totalDays = unit::convert::to(timer.totalTime(), unit::day);
+        metrics.wallSeconds = totalTimer_->secsSinceStart();
+        metrics.stepSimulatedDays = metrics.simulatedDays - lastMetrics_.simulatedDays;
+        metrics.stepWallSeconds = metrics.wallSeconds - lastMetrics_.wallSeconds;
+        metrics.substeps = report_.stepreports.size();
+        metrics.timeStepChops = report_.success.time_step_chops + report_.failure.time_step_chops;
+        metrics.newtonIterations = report_.success.total_newton_iterations
+            + report_.failure.total_newton_iterations;
+        metrics.linearIterations = report_.success.total_linear_iterations
+            + report_.failure.total_linear_iterations;
+        metrics.stepNewtonIterations = metrics.newtonIterations - lastMetrics_.newtonIterations;
+        metrics.stepLinearIterations = metrics.linearIterations - lastMetrics_.linearIterations;
+        metrics.maxRss = maxRss;
+        metrics.sumRss = sumRss;
+        metrics.outputQueueDepth = ebosSimulator_.problem().eclOutputQueueDepth();
+
+        try {
+            metrics.save(metricsFile_);
+        } catch (const std::exception& e) {
+            // the metrics are for monitoring, they must not stop the run
+            OpmLog::warning("Metrics file", e.what());
+        }
+        lastMetrics_ = metrics;
+    }
+
     void outputTimestampFIP(const SimulatorTimer& timer, const std::string version)
     {
         std::ostringstream ss;
@@ -380,6 +622,12 @@ protected:
     PhaseUsage phaseUsage_;
     // Misc. data
     bool terminalOutput_;
+    double loadImbalanceThreshold_;
+    int checkpointInterval_;
+    bool outputMemoryReport_;
+    std::string metricsFile_;
+    RunMetrics lastMetrics_;
+    std::unique_ptr<SimulatorCheckpoint<TypeTag>> checkpoint_;
 
     SimulatorReport report_;
     std::unique_ptr<time::StopWatch> solverTimer_;
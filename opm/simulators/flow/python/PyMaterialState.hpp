@@ -22,15 +22,29 @@
 
 #include <opm/models/utils/propertysystem.hh>
 
+#include <algorithm>
+#include <array>
 #include <exception>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace Opm::Pybind
 {
+    /// The per cell variables of the simulator state which can be viewed from Python.
+    enum class StateVariable {
+        Pressure,
+        WaterSaturation,
+        OilSaturation,
+        GasSaturation,
+        Rs,
+        Rv,
+        CellVolume,
+    };
+
     template <class TypeTag>
     class PyMaterialState {
         using Simulator = GetPropType<TypeTag, Opm::Properties::Simulator>;
@@ -42,14 +56,52 @@ namespace Opm::Pybind
         using GridView = GetPropType<TypeTag, Opm::Properties::GridView>;
 
     public:
+        using Buffer = std::shared_ptr<std::vector<double>>;
+
         PyMaterialState(Simulator *ebosSimulator)
             : ebosSimulator_(ebosSimulator) { }
 
         std::unique_ptr<double []> getCellVolumes( std::size_t *size);
         std::unique_ptr<double []> getPorosity( std::size_t *size);
         void setPorosity(const double *poro, std::size_t size);
+        /// Set the permeabilities in x, y and z direction, each array holds one
+        /// value per cell. Only the transmissibilities of the faces of the
+        /// cells whose permeability changed are recomputed.
+        void setPermeability(const double *permx, const double *permy,
+                             const double *permz, std::size_t size);
+        /// Set factors of the transmissibilities of the faces of the cells in
+        /// positive x, y and z direction on top of MULTX, MULTY and MULTZ of
+        /// the deck, each array holds one value per cell.
+        void setTransmissibilityMultipliers(const double *multx, const double *multy,
+                                            const double *multz, std::size_t size);
+
+        // The buffers below are filled on the first request and then kept up
+        // to date by updateBuffers(), which rewrites them in place, such that
+        // views into them always show the state after the last time step.
+        // A buffer is only replaced if its size changes, the old one stays
+        // alive as long as somebody holds it.
+
+        /// Values of the variable for all cells of this process.
+        Buffer getStateBuffer(StateVariable var);
+        /// Surface rates of the wells of this process, one row of numPhases()
+        /// rates for each well, in the order of getWellNames().
+        Buffer getWellRatesBuffer();
+        /// Refill all buffers which have been handed out, called after every time step.
+        void updateBuffers();
+
+        std::vector<std::string> getWellNames() const;
+        std::size_t numPhases() const;
     private:
+        void checkSize_(const std::string& name, std::size_t size) const;
+        void updateTransmissibilities_(const std::array<const double*, 3>& perm,
+                                       const std::array<const double*, 3>& mult,
+                                       std::size_t size);
+        void fillStateBuffer_(StateVariable var, std::vector<double>& values) const;
+        void fillWellRatesBuffer_(Buffer& buffer) const;
+
         Simulator *ebosSimulator_;
+        std::map<StateVariable, Buffer> stateBuffers_;
+        Buffer wellRatesBuffer_;
     };
 
 }
@@ -66,4 +66,228 @@ setPorosity(const double *poro, std::size_t size)
         problem.setPorosity(poro[dofIdx], dofIdx);
     }
 }
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+setPermeability(const double *permx, const double *permy,
+                const double *permz, std::size_t size)
+{
+    checkSize_("permeability", size);
+    updateTransmissibilities_({permx, permy, permz}, {nullptr, nullptr, nullptr}, size);
+}
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+setTransmissibilityMultipliers(const double *multx, const double *multy,
+                               const double *multz, std::size_t size)
+{
+    checkSize_("transmissibility multipliers", size);
+    updateTransmissibilities_({nullptr, nullptr, nullptr}, {multx, multy, multz}, size);
+}
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+checkSize_(const std::string& name, std::size_t size) const
+{
+    auto model_size = ebosSimulator_->model().numGridDof();
+    if (model_size != size) {
+        std::ostringstream message;
+        message << "Cannot set " << name << ". Expected arrays of size: "
+                << model_size << ", got arrays of size: " << size;
+        throw std::runtime_error(message.str());
+    }
+}
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+updateTransmissibilities_(const std::array<const double*, 3>& perm,
+                          const std::array<const double*, 3>& mult,
+                          std::size_t size)
+{
+    Problem &problem = ebosSimulator_->problem();
+    const auto& trans = problem.eclTransmissibilities();
+    using TransType = std::remove_cv_t<std::remove_reference_t<decltype(trans)>>;
+
+    // only the changed cells are passed on, the others keep their faces
+    std::vector<unsigned> cells;
+    std::vector<typename TransType::DimMatrix> perms;
+    std::vector<typename TransType::DimVector> mults;
+    for (unsigned dofIdx = 0; dofIdx < size; ++dofIdx) {
+        auto cellPerm = trans.permeability(dofIdx);
+        auto cellMult = trans.elementMultiplier(dofIdx);
+        bool changed = false;
+        for (unsigned dimIdx = 0; dimIdx < 3; ++dimIdx) {
+            if (perm[dimIdx] && perm[dimIdx][dofIdx] != cellPerm[dimIdx][dimIdx]) {
+                cellPerm[dimIdx][dimIdx] = perm[dimIdx][dofIdx];
+                changed = true;
+            }
+            if (mult[dimIdx] && mult[dimIdx][dofIdx] != cellMult[dimIdx]) {
+                cellMult[dimIdx] = mult[dimIdx][dofIdx];
+                changed = true;
+            }
+        }
+        if (changed) {
+            cells.push_back(dofIdx);
+            perms.push_back(cellPerm);
+            mults.push_back(cellMult);
+        }
+    }
+    if (!cells.empty()) {
+        problem.updateElementTransmissibilities(cells, perms, mults);
+    }
+}
+
+template <class TypeTag>
+typename PyMaterialState<TypeTag>::Buffer
+PyMaterialState<TypeTag>::
+getStateBuffer(StateVariable var)
+{
+    auto& buffer = stateBuffers_[var];
+    if (!buffer) {
+        buffer = std::make_shared<std::vector<double>>();
+        fillStateBuffer_(var, *buffer);
+    }
+    return buffer;
+}
+
+template <class TypeTag>
+typename PyMaterialState<TypeTag>::Buffer
+PyMaterialState<TypeTag>::
+getWellRatesBuffer()
+{
+    if (!wellRatesBuffer_) {
+        fillWellRatesBuffer_(wellRatesBuffer_);
+    }
+    return wellRatesBuffer_;
+}
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+updateBuffers()
+{
+    for (auto& [var, buffer] : stateBuffers_) {
+        // the cell volumes do not change during the simulation
+        if (var != StateVariable::CellVolume) {
+            fillStateBuffer_(var, *buffer);
+        }
+    }
+    if (wellRatesBuffer_) {
+        fillWellRatesBuffer_(wellRatesBuffer_);
+    }
+}
+
+template <class TypeTag>
+std::vector<std::string>
+PyMaterialState<TypeTag>::
+getWellNames() const
+{
+    const auto& wellState = ebosSimulator_->problem().wellModel().wellState();
+    std::vector<std::string> names(wellState.numWells());
+    for (const auto& [name, entry] : wellState.wellMap()) {
+        names[entry[0]] = name;
+    }
+    return names;
+}
+
+template <class TypeTag>
+std::size_t
+PyMaterialState<TypeTag>::
+numPhases() const
+{
+    return ebosSimulator_->problem().wellModel().wellState().numPhases();
+}
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+fillStateBuffer_(StateVariable var, std::vector<double>& values) const
+{
+    Model &model = ebosSimulator_->model();
+    const std::size_t size = model.numGridDof();
+    // the size of the grid does not change, so views into the buffer stay valid
+    values.resize(size);
+    if (var == StateVariable::CellVolume) {
+        for (unsigned dofIdx = 0; dofIdx < size; ++dofIdx) {
+            values[dofIdx] = model.dofTotalVolume(dofIdx);
+        }
+        return;
+    }
+
+    int phaseIdx = -1;
+    switch (var) {
+    case StateVariable::WaterSaturation:
+        phaseIdx = FluidSystem::waterPhaseIdx;
+        break;
+    case StateVariable::OilSaturation:
+        phaseIdx = FluidSystem::oilPhaseIdx;
+        break;
+    case StateVariable::GasSaturation:
+        phaseIdx = FluidSystem::gasPhaseIdx;
+        break;
+    default:
+        break;
+    }
+    if (phaseIdx >= 0 && !FluidSystem::phaseIsActive(phaseIdx)) {
+        std::fill(values.begin(), values.end(), 0.0);
+        return;
+    }
+    // the pressure of the first active phase of oil, gas and water
+    int pressurePhaseIdx = FluidSystem::waterPhaseIdx;
+    if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+        pressurePhaseIdx = FluidSystem::oilPhaseIdx;
+    } else if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        pressurePhaseIdx = FluidSystem::gasPhaseIdx;
+    }
+
+    ElementContext elemCtx(*ebosSimulator_);
+    const auto& gridView = ebosSimulator_->gridView();
+    for (const auto& elem : elements(gridView)) {
+        const unsigned dofIdx = model.elementMapper().index(elem);
+        const auto* intQuants = model.cachedIntensiveQuantities(dofIdx, /*timeIdx=*/0);
+        if (!intQuants) {
+            elemCtx.updatePrimaryStencil(elem);
+            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+            intQuants = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+        }
+        const auto& fs = intQuants->fluidState();
+        switch (var) {
+        case StateVariable::Pressure:
+            values[dofIdx] = getValue(fs.pressure(pressurePhaseIdx));
+            break;
+        case StateVariable::Rs:
+            values[dofIdx] = getValue(fs.Rs());
+            break;
+        case StateVariable::Rv:
+            values[dofIdx] = getValue(fs.Rv());
+            break;
+        default:
+            values[dofIdx] = getValue(fs.saturation(phaseIdx));
+            break;
+        }
+    }
+}
+
+template <class TypeTag>
+void
+PyMaterialState<TypeTag>::
+fillWellRatesBuffer_(Buffer& buffer) const
+{
+    const auto& wellState = ebosSimulator_->problem().wellModel().wellState();
+    const std::size_t np = wellState.numPhases();
+    const std::size_t size = wellState.numWells() * np;
+    // the wells may change between the report steps, a buffer of
+    // another size is replaced and the old views keep the old one
+    if (!buffer || buffer->size() != size) {
+        buffer = std::make_shared<std::vector<double>>(size);
+    }
+    for (std::size_t wellIdx = 0; wellIdx < std::size_t(wellState.numWells()); ++wellIdx) {
+        const auto& rates = wellState.wellRates(wellIdx);
+        std::copy(rates.begin(), rates.end(), buffer->begin() + wellIdx * np);
+    }
+}
 } //namespace Opm::Pybind
@@ -37,22 +37,64 @@ private:
 
 public:
     BlackOilSimulator( const std::string &deckFilename);
+    // A simulator of the same case as the base, which must have run
+    // step_init() but no step(). It starts from copies of the parsed
+    // input of the base, so the deck is not read and parsed again.
+    static std::unique_ptr<BlackOilSimulator> fromBaseCase(const BlackOilSimulator& base);
     py::array_t<double> getPorosity();
+    // Read-only views of the state after the last step, the arrays are
+    // updated in place by every step() and no copy is made on access.
+    py::array_t<double> getStateView(StateVariable var);
+    py::array_t<double> getWellRatesView();
+    std::vector<std::string> getWellNames();
     int run();
     void setPorosity(
          py::array_t<double, py::array::c_style | py::array::forcecast> array);
+    // The transmissibilities of the faces of the changed cells are updated
+    // in place, the simulator is not set up again.
+    void setPermeability(
+         py::array_t<double, py::array::c_style | py::array::forcecast> permx,
+         py::array_t<double, py::array::c_style | py::array::forcecast> permy,
+         py::array_t<double, py::array::c_style | py::array::forcecast> permz);
+    void setTransmissibilityMultipliers(
+         py::array_t<double, py::array::c_style | py::array::forcecast> multx,
+         py::array_t<double, py::array::c_style | py::array::forcecast> multy,
+         py::array_t<double, py::array::c_style | py::array::forcecast> multz);
+    // Factors of the connection transmissibility factors, one per connection
+    // of the well in the schedule, applied from the next report step on.
+    void setConnectionMultipliers(const std::string& wellName,
+                                  const std::vector<double>& multipliers);
+    // Advance one report step. The GIL is released during the step unless
+    // the deck has Python actions.
     int step();
+    // Advance each of the simulators one report step, with the GIL
+    // released once for all of them.
+    static std::vector<int> stepAll(const std::vector<BlackOilSimulator*>& simulators);
     int stepInit();
     int stepCleanup();
 
 private:
+    void checkCanStep_() const;
+    int advance_();
+    PyMaterialState<TypeTag>& materialState();
+    static py::array_t<double> makeView_(const PyMaterialState<TypeTag>::Buffer& buffer,
+                                         std::vector<py::ssize_t> shape);
+
     const std::string deckFilename_;
     bool hasRunInit_ = false;
     bool hasRunCleanup_ = false;
+    bool hasRunStep_ = false;
+    bool usesPython_ = false;
+
+    // parsed input for step_init(), only set for a copy of a base case
+    std::unique_ptr<Opm::Deck> deck_;
+    std::unique_ptr<Opm::EclipseState> eclipseState_;
+    std::unique_ptr<Opm::Schedule> schedule_;
+    std::unique_ptr<Opm::SummaryConfig> summaryConfig_;
 
     std::unique_ptr<Opm::FlowMainEbos<TypeTag>> mainEbos_;
     std::unique_ptr<Opm::Main> main_;
-    Simulator *ebosSimulator_;
+    Simulator *ebosSimulator_ = nullptr;
     std::unique_ptr<PyMaterialState<TypeTag>> materialState_;
 };
 
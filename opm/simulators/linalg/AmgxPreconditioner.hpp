@@ -0,0 +1,249 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_AMGXPRECONDITIONER_HEADER_INCLUDED
+#define OPM_AMGXPRECONDITIONER_HEADER_INCLUDED
+
+#if HAVE_AMGX
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
+
+#include <dune/istl/solvercategory.hh>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <amgx_c.h>
+
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+namespace Detail
+{
+    inline void amgxCheck(const AMGX_RC rc, const char* call)
+    {
+        if (rc != AMGX_RC_OK) {
+            char message[4096];
+            AMGX_get_error_string(rc, message, sizeof(message));
+            OPM_THROW(std::runtime_error, call << " failed: " << message);
+        }
+    }
+
+    // AMGX is initialized by the first preconditioner and finalized by the last one.
+    class AmgxLibrary
+    {
+    public:
+        static void acquire()
+        {
+            std::lock_guard<std::mutex> lock(mutex());
+            if (count()++ == 0) {
+                amgxCheck(AMGX_initialize(), "AMGX_initialize");
+                amgxCheck(AMGX_initialize_plugins(), "AMGX_initialize_plugins");
+            }
+        }
+
+        static void release()
+        {
+            std::lock_guard<std::mutex> lock(mutex());
+            if (--count() == 0) {
+                AMGX_finalize_plugins();
+                AMGX_finalize();
+            }
+        }
+
+    private:
+        static std::mutex& mutex()
+        {
+            static std::mutex m;
+            return m;
+        }
+
+        static int& count()
+        {
+            static int c = 0;
+            return c;
+        }
+    };
+} // namespace Detail
+
+/// A preconditioner for scalar matrices, e.g. the pressure system of CPR,
+/// which applies the AMG of the AMGX library on a GPU.
+///
+/// The sparsity pattern of the matrix is uploaded when the preconditioner is
+/// constructed, later updates only replace the coefficients on the device and
+/// set up the hierarchy again. The applications only transfer the vectors.
+/// Only for sequential operators.
+///
+/// Parameters:
+///   config       the AMGX configuration string, by default one V-cycle of
+///                aggregation AMG with multicolor DILU smoothing
+///   config_file  a file with the AMGX configuration, used instead if given
+template <class OperatorType, class VectorType>
+class AmgxPreconditioner : public Dune::PreconditionerWithUpdate<VectorType, VectorType>
+{
+public:
+    using MatrixType = typename OperatorType::matrix_type;
+
+    static_assert(MatrixType::block_type::rows == 1 && MatrixType::block_type::cols == 1,
+                  "The AMGX preconditioner is only for scalar matrices");
+
+    AmgxPreconditioner(const OperatorType& linearoperator, const boost::property_tree::ptree& prm)
+        : matrix_(linearoperator.getmat())
+    {
+        using Detail::amgxCheck;
+        Detail::AmgxLibrary::acquire();
+
+        const std::string configFile = prm.get<std::string>("config_file", "");
+        if (!configFile.empty()) {
+            amgxCheck(AMGX_config_create_from_file(&config_, configFile.c_str()), "AMGX_config_create_from_file");
+        } else {
+            const std::string config = prm.get<std::string>("config", defaultConfig());
+            amgxCheck(AMGX_config_create(&config_, config.c_str()), "AMGX_config_create");
+        }
+        amgxCheck(AMGX_resources_create_simple(&resources_, config_), "AMGX_resources_create_simple");
+        amgxCheck(AMGX_matrix_create(&A_, resources_, mode_), "AMGX_matrix_create");
+        amgxCheck(AMGX_vector_create(&x_, resources_, mode_), "AMGX_vector_create");
+        amgxCheck(AMGX_vector_create(&b_, resources_, mode_), "AMGX_vector_create");
+        amgxCheck(AMGX_solver_create(&solver_, resources_, mode_, config_), "AMGX_solver_create");
+
+        if (matrix_.nonzeroes() > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+            OPM_THROW(std::invalid_argument, "The AMGX preconditioner supports at most 2^31 - 1 nonzeroes");
+        }
+        rowStart_.reserve(matrix_.N() + 1);
+        rowStart_.push_back(0);
+        cols_.reserve(matrix_.nonzeroes());
+        for (auto row = matrix_.begin(); row != matrix_.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                cols_.push_back(static_cast<int>(col.index()));
+            }
+            rowStart_.push_back(static_cast<int>(cols_.size()));
+        }
+        copyValues();
+        amgxCheck(AMGX_matrix_upload_all(A_, numRows(), cols_.size(), 1, 1,
+                                         rowStart_.data(), cols_.data(), values_.data(), nullptr),
+                  "AMGX_matrix_upload_all");
+        amgxCheck(AMGX_solver_setup(solver_, A_), "AMGX_solver_setup");
+    }
+
+    AmgxPreconditioner(const AmgxPreconditioner&) = delete;
+    AmgxPreconditioner& operator=(const AmgxPreconditioner&) = delete;
+
+    ~AmgxPreconditioner() override
+    {
+        AMGX_solver_destroy(solver_);
+        AMGX_vector_destroy(b_);
+        AMGX_vector_destroy(x_);
+        AMGX_matrix_destroy(A_);
+        AMGX_resources_destroy(resources_);
+        AMGX_config_destroy(config_);
+        Detail::AmgxLibrary::release();
+    }
+
+    void pre(VectorType&, VectorType&) override
+    {
+    }
+
+    void apply(VectorType& v, const VectorType& d) override
+    {
+        using Detail::amgxCheck;
+        amgxCheck(AMGX_vector_upload(b_, numRows(), 1, &d[0][0]), "AMGX_vector_upload");
+        amgxCheck(AMGX_vector_set_zero(x_, numRows(), 1), "AMGX_vector_set_zero");
+        // the result of a cycle which did not converge is still a correction
+        AMGX_solver_solve_with_0_initial_guess(solver_, b_, x_);
+        amgxCheck(AMGX_vector_download(x_, &v[0][0]), "AMGX_vector_download");
+    }
+
+    void post(VectorType&) override
+    {
+    }
+
+    /// Replace the coefficients on the device, the sparsity pattern is
+    /// assumed to be the same, and set up the hierarchy again.
+    void update() override
+    {
+        using Detail::amgxCheck;
+        copyValues();
+        amgxCheck(AMGX_matrix_replace_coefficients(A_, numRows(), cols_.size(), values_.data(), nullptr),
+                  "AMGX_matrix_replace_coefficients");
+        amgxCheck(AMGX_solver_resetup(solver_, A_), "AMGX_solver_resetup");
+    }
+
+    /// The bytes of the host copy of the matrix, the device memory is not counted.
+    std::size_t memoryUsage() const override
+    {
+        return values_.capacity() * sizeof(double)
+            + (cols_.capacity() + rowStart_.capacity()) * sizeof(int);
+    }
+
+    Dune::SolverCategory::Category category() const override
+    {
+        return Dune::SolverCategory::sequential;
+    }
+
+private:
+    static std::string defaultConfig()
+    {
+        return "config_version=2, solver=AMG, algorithm=AGGREGATION, selector=SIZE_8, "
+               "smoother=MULTICOLOR_DILU, presweeps=1, postsweeps=1, cycle=V, max_levels=50, "
+               "max_iters=1, monitor_residual=0, print_solve_stats=0, obtain_timings=0";
+    }
+
+    int numRows() const
+    {
+        return static_cast<int>(rowStart_.size()) - 1;
+    }
+
+    void copyValues()
+    {
+        values_.resize(cols_.size());
+        std::size_t k = 0;
+        for (auto row = matrix_.begin(); row != matrix_.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col, ++k) {
+                values_[k] = (*col)[0][0];
+            }
+        }
+    }
+
+    // double precision on the device and the host, 32 bit indices
+    static constexpr AMGX_Mode mode_ = AMGX_mode_dDDI;
+
+    const MatrixType& matrix_;
+    std::vector<int> rowStart_;
+    std::vector<int> cols_;
+    std::vector<double> values_;
+    AMGX_config_handle config_ = nullptr;
+    AMGX_resources_handle resources_ = nullptr;
+    AMGX_matrix_handle A_ = nullptr;
+    AMGX_vector_handle x_ = nullptr;
+    AMGX_vector_handle b_ = nullptr;
+    AMGX_solver_handle solver_ = nullptr;
+};
+
+} // namespace Opm
+
+#endif // HAVE_AMGX
+
+#endif // OPM_AMGXPRECONDITIONER_HEADER_INCLUDED
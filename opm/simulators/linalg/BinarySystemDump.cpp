@@ -0,0 +1,162 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
+
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OPM_BINARY_SYSTEM_DUMP_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define OPM_BINARY_SYSTEM_DUMP_MMAP 0
+#endif
+
+namespace
+{
+
+constexpr std::size_t flushSize = 1 << 20;
+
+std::uint64_t padded(const std::uint64_t bytes)
+{
+    return (bytes + 7) / 8 * 8;
+}
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+BinarySystemWriter::BinarySystemWriter(const std::string& fileName, const BinarySystemHeader& header)
+    : os_(fileName, std::ios::binary | std::ios::trunc)
+    , fileName_(fileName)
+{
+    if (!os_) {
+        throw std::runtime_error("Cannot open " + fileName + " for writing");
+    }
+    buffer_.reserve(flushSize + sizeof(header));
+    writeBytes(&header, sizeof(header));
+    endSection();
+}
+
+void BinarySystemWriter::writeBytes(const void* bytes, const std::size_t count)
+{
+    const char* begin = static_cast<const char*>(bytes);
+    buffer_.insert(buffer_.end(), begin, begin + count);
+    sectionBytes_ += count;
+    if (buffer_.size() >= flushSize) {
+        os_.write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+}
+
+void BinarySystemWriter::endSection()
+{
+    buffer_.resize(buffer_.size() + padded(sectionBytes_) - sectionBytes_, 0);
+    sectionBytes_ = 0;
+}
+
+void BinarySystemWriter::close()
+{
+    os_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+    os_.close();
+    if (!os_) {
+        throw std::runtime_error("Failed to write " + fileName_);
+    }
+}
+
+BinarySystemReader::BinarySystemReader(const std::string& fileName, const bool mapFile)
+{
+#if OPM_BINARY_SYSTEM_DUMP_MMAP
+    if (mapFile) {
+        const int fd = ::open(fileName.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd >= 0 && ::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                data_ = static_cast<const char*>(addr);
+                size_ = st.st_size;
+                mapped_ = true;
+            }
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#endif
+
+    if (!mapped_) {
+        std::ifstream is(fileName, std::ios::binary | std::ios::ate);
+        if (!is) {
+            throw std::runtime_error("Cannot open " + fileName);
+        }
+        buffer_.resize(is.tellg());
+        is.seekg(0);
+        is.read(buffer_.data(), buffer_.size());
+        if (!is) {
+            throw std::runtime_error("Failed to read " + fileName);
+        }
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    if (size_ < sizeof(header_)) {
+        throw std::runtime_error(fileName + " is not a binary system dump");
+    }
+    std::memcpy(&header_, data_, sizeof(header_));
+    if (std::strncmp(header_.magic, "OPMSYSB", 8) != 0 || header_.version != 1) {
+        throw std::runtime_error(fileName + " is not a binary system dump of a supported version");
+    }
+
+    const std::uint64_t bz = header_.block_size;
+    const std::uint64_t bytes[8] = {
+        (header_.rows + 1) * sizeof(std::uint64_t),
+        header_.nonzeroes * sizeof(std::int32_t),
+        header_.nonzeroes * bz * bz * sizeof(double),
+        header_.rows * bz * sizeof(double),
+        2 * header_.wells * sizeof(std::int32_t),
+        header_.well_cells * sizeof(std::int32_t),
+        header_.well_values * sizeof(double),
+        header_.indices * sizeof(BinarySystemIndex),
+    };
+    std::uint64_t offset = padded(sizeof(header_));
+    for (int section = 0; section < 8; ++section) {
+        offsets_[section] = offset;
+        offset += padded(bytes[section]);
+    }
+    if (offset > size_) {
+        throw std::runtime_error(fileName + " is truncated");
+    }
+}
+
+BinarySystemReader::~BinarySystemReader()
+{
+#if OPM_BINARY_SYSTEM_DUMP_MMAP
+    if (mapped_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+} // namespace Opm
@@ -0,0 +1,308 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BINARY_SYSTEM_DUMP_HEADER_INCLUDED
+#define OPM_BINARY_SYSTEM_DUMP_HEADER_INCLUDED
+
+#include <opm/simulators/wells/PackedWellSchurComplement.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+/*
+  Binary dumps of the linear systems, a much faster alternative to the
+  MatrixMarket files for large systems. The values are stored in the native
+  representation of the machine, after a fixed header. Every section starts
+  at a multiple of 8 bytes, such that the file can be memory mapped and the
+  sections used in place:
+
+    - the row pointers of the blocked CSR matrix, rows + 1 uint64,
+    - the column indices of the blocks, nonzeroes int32,
+    - the blocks, block_size x block_size doubles each, row major,
+    - the right hand side, rows x block_size doubles,
+    - the number of well equations and perforations of each well, 2 x wells int32,
+    - the perforated cells of the wells, well_cells int32,
+    - the values of the wells in the layout of PackedWellSchurComplement,
+      well_values doubles,
+    - the parallel index set, indices entries of BinarySystemIndex.
+
+  The wells are the standard wells which are applied by the operator when
+  their contributions are not added to the matrix, the index set is only
+  stored in parallel runs.
+*/
+struct BinarySystemHeader
+{
+    char magic[8];
+    std::uint64_t version;
+    std::uint64_t block_size;
+    std::uint64_t rows;
+    std::uint64_t nonzeroes;
+    std::uint64_t wells;
+    std::uint64_t well_cells;
+    std::uint64_t well_values;
+    std::uint64_t indices;
+};
+
+/// One entry of the parallel index set of a dumped system.
+struct BinarySystemIndex
+{
+    std::int64_t global;
+    std::int32_t local;
+    std::int32_t attribute;
+};
+
+/// Writes the sections of a binary system dump one after the other.
+class BinarySystemWriter
+{
+public:
+    BinarySystemWriter(const std::string& fileName, const BinarySystemHeader& header);
+
+    /// Write count values and pad to the next multiple of 8 bytes.
+    template <class T>
+    void writeSection(const T* values, const std::size_t count)
+    {
+        writeBytes(values, count * sizeof(T));
+        endSection();
+    }
+
+    /// Write a part of the current section.
+    void writeBytes(const void* bytes, std::size_t count);
+
+    /// Pad the current section to the next multiple of 8 bytes.
+    void endSection();
+
+    /// Flush the file, throws if writing failed.
+    void close();
+
+private:
+    std::ofstream os_;
+    std::vector<char> buffer_;
+    std::uint64_t sectionBytes_ = 0;
+    std::string fileName_;
+};
+
+/// Gives access to the sections of a binary system dump. The file is memory
+/// mapped where possible, otherwise it is read into memory.
+class BinarySystemReader
+{
+public:
+    explicit BinarySystemReader(const std::string& fileName, bool mapFile = true);
+    ~BinarySystemReader();
+
+    BinarySystemReader(const BinarySystemReader&) = delete;
+    BinarySystemReader& operator=(const BinarySystemReader&) = delete;
+
+    const BinarySystemHeader& header() const
+    { return header_; }
+
+    const std::uint64_t* rowStart() const
+    { return section<std::uint64_t>(0); }
+
+    const std::int32_t* columns() const
+    { return section<std::int32_t>(1); }
+
+    const double* values() const
+    { return section<double>(2); }
+
+    const double* rhs() const
+    { return section<double>(3); }
+
+    const std::int32_t* wellDimensions() const
+    { return section<std::int32_t>(4); }
+
+    const std::int32_t* wellCells() const
+    { return section<std::int32_t>(5); }
+
+    const double* wellValues() const
+    { return section<double>(6); }
+
+    const BinarySystemIndex* indices() const
+    { return section<BinarySystemIndex>(7); }
+
+private:
+    template <class T>
+    const T* section(const int idx) const
+    { return reinterpret_cast<const T*>(data_ + offsets_[idx]); }
+
+    BinarySystemHeader header_;
+    std::uint64_t offsets_[8];
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buffer_;
+};
+
+namespace Helper
+{
+
+    /// Write a blocked matrix, its right hand side, the packed wells (may be
+    /// nullptr) and the parallel index set to a binary system dump.
+    template <class Matrix, class Vector, class Scalar, int numEq>
+    void writeBinarySystem(const std::string& fileName,
+                           const Matrix& matrix,
+                           const Vector& rhs,
+                           const PackedWellSchurComplement<Scalar, numEq>* wells,
+                           const std::vector<BinarySystemIndex>& indices)
+    {
+        using Block = typename Matrix::block_type;
+        constexpr int bz = Block::rows;
+        static_assert(Block::cols == bz && numEq == bz,
+                      "The binary system dumps require square blocks matching the wells");
+
+        BinarySystemHeader header{};
+        const char magic[8] = {'O', 'P', 'M', 'S', 'Y', 'S', 'B', '\0'};
+        std::copy(magic, magic + 8, header.magic);
+        header.version = 1;
+        header.block_size = bz;
+        header.rows = matrix.N();
+        header.nonzeroes = matrix.nonzeroes();
+        header.wells = wells ? wells->numWells() : 0;
+        header.well_cells = wells ? wells->cells().size() : 0;
+        header.well_values = wells ? wells->values().size() : 0;
+        header.indices = indices.size();
+
+        BinarySystemWriter writer(fileName, header);
+
+        // the matrix is streamed row by row, without a copy in CSR format
+        std::uint64_t start = 0;
+        writer.writeBytes(&start, sizeof(start));
+        for (const auto& row : matrix) {
+            start += row.size();
+            writer.writeBytes(&start, sizeof(start));
+        }
+        writer.endSection();
+
+        for (const auto& row : matrix) {
+            for (auto col = row.begin(); col != row.end(); ++col) {
+                const std::int32_t idx = col.index();
+                writer.writeBytes(&idx, sizeof(idx));
+            }
+        }
+        writer.endSection();
+
+        double block[bz * bz];
+        for (const auto& row : matrix) {
+            for (const auto& entry : row) {
+                for (int i = 0; i < bz; ++i)
+                    for (int j = 0; j < bz; ++j)
+                        block[i * bz + j] = entry[i][j];
+                writer.writeBytes(block, sizeof(block));
+            }
+        }
+        writer.endSection();
+
+        for (const auto& entry : rhs) {
+            for (int i = 0; i < bz; ++i) {
+                const double value = entry[i];
+                writer.writeBytes(&value, sizeof(value));
+            }
+        }
+        writer.endSection();
+
+        std::vector<std::int32_t> dimensions;
+        std::vector<std::int32_t> cells;
+        std::vector<double> values;
+        if (wells) {
+            for (std::size_t well = 0; well < wells->numWells(); ++well) {
+                dimensions.push_back(wells->numWellEq(well));
+                dimensions.push_back(wells->numPerforations(well));
+            }
+            cells.assign(wells->cells().begin(), wells->cells().end());
+            values.assign(wells->values().begin(), wells->values().end());
+        }
+        writer.writeSection(dimensions.data(), dimensions.size());
+        writer.writeSection(cells.data(), cells.size());
+        writer.writeSection(values.data(), values.size());
+        writer.writeSection(indices.data(), indices.size());
+        writer.close();
+    }
+
+    /// Read the matrix and the right hand side of a binary system dump.
+    template <class Matrix, class Vector>
+    void readBinarySystem(const BinarySystemReader& reader, Matrix& matrix, Vector& rhs)
+    {
+        using Block = typename Matrix::block_type;
+        constexpr int bz = Block::rows;
+        const auto& header = reader.header();
+        if (header.block_size != static_cast<std::uint64_t>(bz))
+            throw std::runtime_error("The block size of the dumped system is "
+                                     + std::to_string(header.block_size));
+
+        const std::uint64_t* rowStart = reader.rowStart();
+        const std::int32_t* columns = reader.columns();
+
+        matrix = Matrix();
+        matrix.setBuildMode(Matrix::row_wise);
+        matrix.setSize(header.rows, header.rows, header.nonzeroes);
+        std::size_t rowIdx = 0;
+        for (auto row = matrix.createbegin(); row != matrix.createend(); ++row, ++rowIdx) {
+            for (auto nz = rowStart[rowIdx]; nz < rowStart[rowIdx + 1]; ++nz)
+                row.insert(columns[nz]);
+        }
+
+        const double* value = reader.values();
+        for (auto& row : matrix) {
+            for (auto& entry : row) {
+                for (int i = 0; i < bz; ++i)
+                    for (int j = 0; j < bz; ++j)
+                        entry[i][j] = *value++;
+            }
+        }
+
+        rhs.resize(header.rows);
+        const double* b = reader.rhs();
+        for (auto& entry : rhs) {
+            for (int i = 0; i < bz; ++i)
+                entry[i] = *b++;
+        }
+    }
+
+    /// Read the packed wells of a binary system dump.
+    template <class Scalar, int numEq>
+    void readBinarySystemWells(const BinarySystemReader& reader,
+                               PackedWellSchurComplement<Scalar, numEq>& wells)
+    {
+        wells.clear();
+        const std::int32_t* dimensions = reader.wellDimensions();
+        const std::int32_t* cells = reader.wellCells();
+        const double* values = reader.wellValues();
+        for (std::uint64_t well = 0; well < reader.header().wells; ++well) {
+            const int nw = dimensions[2 * well];
+            const int numPerfs = dimensions[2 * well + 1];
+            const std::vector<int> wellCells(cells, cells + numPerfs);
+            const std::size_t size = PackedWellSchurComplement<Scalar, numEq>::packedSize(nw, numPerfs);
+            const std::vector<Scalar> wellValues(values, values + size);
+            wells.addPackedWell(nw, numPerfs, wellCells.data(), wellValues.data());
+            cells += numPerfs;
+            values += size;
+        }
+    }
+
+} // namespace Helper
+} // namespace Opm
+
+#endif // OPM_BINARY_SYSTEM_DUMP_HEADER_INCLUDED
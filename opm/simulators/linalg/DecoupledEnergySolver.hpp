@@ -0,0 +1,263 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_DECOUPLEDENERGYSOLVER_HEADER_INCLUDED
+#define OPM_DECOUPLEDENERGYSOLVER_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/MatrixBlock.hpp>
+#include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Opm
+{
+
+/// Computes the Newton update of a linearized system with an energy equation
+/// in two steps: first the flow unknowns from the system without the energy
+/// equation and the temperature, with the temperature update fixed to zero,
+/// then the temperature from the scalar energy equation with the flow update
+/// fixed.
+///
+/// The flow system has blocks of one row and column less, such that the
+/// configured linear solver runs on e.g. 3x3 instead of 4x4 blocks. The
+/// coupling of the flow to the temperature is lagged to the next Newton
+/// iteration, which is cheap where the temperature fronts move slowly.
+/// Only for serial runs whose matrix contains the well contributions.
+template <class Matrix, class Vector>
+class DecoupledEnergySolver
+{
+public:
+    static constexpr int numEq = Vector::block_type::dimension;
+    // at least one, such that the types exist in the models without energy equation
+    static constexpr int numFlowEq = numEq > 1 ? numEq - 1 : 1;
+
+    using FlowMatrix = Dune::BCRSMatrix<MatrixBlock<double, numFlowEq, numFlowEq>>;
+    using FlowVector = Dune::BlockVector<Dune::FieldVector<double, numFlowEq>>;
+    using FlowOperator = Dune::MatrixAdapter<FlowMatrix, FlowVector, FlowVector>;
+    using FlowSolver = Dune::FlexibleSolver<FlowMatrix, FlowVector>;
+    using EnergyMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+    using EnergyVector = Dune::BlockVector<Dune::FieldVector<double, 1>>;
+    using EnergyOperator = Dune::MatrixAdapter<EnergyMatrix, EnergyVector, EnergyVector>;
+
+    /// \param prm              the configuration of the flow solver
+    /// \param energyIndex      the index of the energy equation and the temperature in the blocks
+    /// \param energyTolerance  the relative residual reduction of the energy solve
+    /// \param energyMaxIter    the maximum number of iterations of the energy solve
+    DecoupledEnergySolver(const boost::property_tree::ptree& prm, int energyIndex,
+                          double energyTolerance, int energyMaxIter)
+        : prm_(prm)
+        , energyIndex_(energyIndex)
+        , energyTolerance_(energyTolerance)
+        , energyMaxIter_(energyMaxIter)
+    {
+        for (int i = 0, j = 0; i < numEq; ++i) {
+            if (i != energyIndex_) {
+                flowIndices_[j++] = i;
+            }
+        }
+    }
+
+    /// Compute the update x of A x = r.
+    void solve(const Matrix& A, const Vector& r, Vector& x)
+    {
+        x.resize(r.size());
+        x = 0.0;
+
+        Dune::Timer timer;
+        timer.start();
+        solveFlow_(A, r, x);
+        flowTime_ = timer.stop();
+
+        timer.reset();
+        timer.start();
+        solveEnergy_(A, r, x);
+        energyTime_ = timer.stop();
+    }
+
+    int flowIterations() const
+    { return flowIterations_; }
+
+    int energyIterations() const
+    { return energyIterations_; }
+
+    bool converged() const
+    { return flowConverged_ && energyConverged_; }
+
+    double flowTime() const
+    { return flowTime_; }
+
+    double energyTime() const
+    { return energyTime_; }
+
+private:
+    bool patternChanged_(const Matrix& A) const
+    {
+        return !flowSolver_ || patternRows_ != A.N() || patternNonzeroes_ != A.nonzeroes();
+    }
+
+    void createSystems_(const Matrix& A)
+    {
+        flowMatrix_ = std::make_unique<FlowMatrix>(A.N(), A.M(), A.nonzeroes(), FlowMatrix::row_wise);
+        energyMatrix_ = std::make_unique<EnergyMatrix>(A.N(), A.M(), A.nonzeroes(), EnergyMatrix::row_wise);
+        for (auto row = flowMatrix_->createbegin(); row != flowMatrix_->createend(); ++row) {
+            for (auto col = A[row.index()].begin(); col != A[row.index()].end(); ++col) {
+                row.insert(col.index());
+            }
+        }
+        for (auto row = energyMatrix_->createbegin(); row != energyMatrix_->createend(); ++row) {
+            for (auto col = A[row.index()].begin(); col != A[row.index()].end(); ++col) {
+                row.insert(col.index());
+            }
+        }
+        patternRows_ = A.N();
+        patternNonzeroes_ = A.nonzeroes();
+    }
+
+    void copyEntries_(const Matrix& A)
+    {
+        for (auto row = A.begin(); row != A.end(); ++row) {
+            auto flowCol = (*flowMatrix_)[row.index()].begin();
+            auto energyCol = (*energyMatrix_)[row.index()].begin();
+            for (auto col = row->begin(); col != row->end(); ++col, ++flowCol, ++energyCol) {
+                for (int i = 0; i < numFlowEq; ++i) {
+                    for (int j = 0; j < numFlowEq; ++j) {
+                        (*flowCol)[i][j] = (*col)[flowIndices_[i]][flowIndices_[j]];
+                    }
+                }
+                (*energyCol)[0][0] = (*col)[energyIndex_][energyIndex_];
+            }
+        }
+    }
+
+    void solveFlow_(const Matrix& A, const Vector& r, Vector& x)
+    {
+        const bool patternChanged = patternChanged_(A);
+        if (patternChanged) {
+            createSystems_(A);
+        }
+        copyEntries_(A);
+
+        FlowVector rhs(r.size());
+        for (std::size_t cell = 0; cell < r.size(); ++cell) {
+            for (int i = 0; i < numFlowEq; ++i) {
+                rhs[cell][i] = r[cell][flowIndices_[i]];
+            }
+        }
+
+        if (patternChanged) {
+            std::function<FlowVector()> weightsCalculator;
+            const auto precType = prm_.get<std::string>("preconditioner.type", "cpr");
+            if (precType == "cpr" || precType == "cprt") {
+                const bool transpose = precType == "cprt";
+                const int pressureIndex = prm_.get<int>("preconditioner.pressure_var_index", 1);
+                const FlowMatrix& flowMatrix = *flowMatrix_;
+                weightsCalculator = [&flowMatrix, transpose, pressureIndex]() {
+                    return Amg::getQuasiImpesWeights<FlowMatrix, FlowVector>(flowMatrix, pressureIndex, transpose);
+                };
+            }
+            flowOperator_ = std::make_unique<FlowOperator>(*flowMatrix_);
+            flowSolver_ = std::make_unique<FlowSolver>(*flowOperator_, prm_, weightsCalculator);
+        } else {
+            flowSolver_->preconditioner().update();
+        }
+
+        FlowVector dx(r.size());
+        dx = 0.0;
+        Dune::InverseOperatorResult result;
+        flowSolver_->apply(dx, rhs, result);
+        flowIterations_ = result.iterations;
+        flowConverged_ = result.converged;
+
+        for (std::size_t cell = 0; cell < r.size(); ++cell) {
+            for (int i = 0; i < numFlowEq; ++i) {
+                x[cell][flowIndices_[i]] = dx[cell][i];
+            }
+        }
+    }
+
+    void solveEnergy_(const Matrix& A, const Vector& r, Vector& x)
+    {
+        // the residual of the energy equation left by the flow update
+        EnergyVector rhs(r.size());
+        for (auto row = A.begin(); row != A.end(); ++row) {
+            double b = r[row.index()][energyIndex_];
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                const auto& block = *col;
+                const auto& dx = x[col.index()];
+                for (int j = 0; j < numFlowEq; ++j) {
+                    b -= block[energyIndex_][flowIndices_[j]] * dx[flowIndices_[j]];
+                }
+            }
+            rhs[row.index()] = b;
+        }
+
+        EnergyOperator energyOperator(*energyMatrix_);
+        Dune::SeqSSOR<EnergyMatrix, EnergyVector, EnergyVector> ssor(*energyMatrix_, 1, 1.0);
+        Dune::BiCGSTABSolver<EnergyVector> solver(energyOperator, ssor, energyTolerance_,
+                                                  energyMaxIter_, /*verbose=*/0);
+        EnergyVector dT(r.size());
+        dT = 0.0;
+        Dune::InverseOperatorResult result;
+        solver.apply(dT, rhs, result);
+        energyIterations_ = result.iterations;
+        energyConverged_ = result.converged;
+
+        for (std::size_t cell = 0; cell < r.size(); ++cell) {
+            x[cell][energyIndex_] = dT[cell][0];
+        }
+    }
+
+    boost::property_tree::ptree prm_;
+    int energyIndex_;
+    double energyTolerance_;
+    int energyMaxIter_;
+    std::array<int, numFlowEq> flowIndices_;
+    std::unique_ptr<FlowMatrix> flowMatrix_;
+    std::unique_ptr<EnergyMatrix> energyMatrix_;
+    std::unique_ptr<FlowOperator> flowOperator_;
+    std::unique_ptr<FlowSolver> flowSolver_;
+    std::size_t patternRows_ = 0;
+    std::size_t patternNonzeroes_ = 0;
+    int flowIterations_ = 0;
+    int energyIterations_ = 0;
+    bool flowConverged_ = true;
+    bool energyConverged_ = true;
+    double flowTime_ = 0.0;
+    double energyTime_ = 0.0;
+};
+
+} // namespace Opm
+
+#endif // OPM_DECOUPLEDENERGYSOLVER_HEADER_INCLUDED
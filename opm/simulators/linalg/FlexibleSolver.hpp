@@ -22,6 +22,7 @@
 #ifndef OPM_FLEXIBLE_SOLVER_HEADER_INCLUDED
 #define OPM_FLEXIBLE_SOLVER_HEADER_INCLUDED
 
+#include <opm/simulators/linalg/PipelinedBiCGSTABSolver.hpp>
 #include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
 
 #include <dune/istl/solver.hh>
@@ -95,6 +96,7 @@ private:
     std::shared_ptr<AbstractOperatorType> linearoperator_for_precond_;
     std::shared_ptr<AbstractPrecondType> preconditioner_;
     std::shared_ptr<AbstractScalarProductType> scalarproduct_;
+    std::shared_ptr<Dune::NonblockingDots<VectorType>> nonblocking_dots_; // reductions of the pipelined_bicgstab solver
     std::shared_ptr<AbstractSolverType> linsolver_;
 };
 
@@ -22,7 +22,9 @@
 #define OPM_FLEXIBLE_SOLVER_IMPL_HEADER_INCLUDED
 
 #include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/KrylovMonitor.hpp>
 #include <opm/simulators/linalg/PreconditionerFactory.hpp>
+#include <opm/simulators/linalg/RecyclingGCROSolver.hpp>
 #include <opm/simulators/linalg/matrixblock.hh>
 
 #include <dune/common/fmatrix.hh>
@@ -112,6 +114,9 @@ namespace Dune
                                                                                     weightsCalculator,
                                                                                     comm);
         scalarproduct_ = Dune::createScalarProduct<VectorType, Comm>(comm, op.category());
+#if HAVE_MPI
+        nonblocking_dots_ = std::make_shared<Dune::ParallelNonblockingDots<VectorType, Comm>>(comm);
+#endif
         linearoperator_for_precond_ = op_prec;
     }
 
@@ -133,6 +138,7 @@ namespace Dune
                                                                               child ? *child : pt(),
                                                                               weightsCalculator);
         scalarproduct_ = std::make_shared<Dune::SeqScalarProduct<VectorType>>();
+        nonblocking_dots_ = std::make_shared<Dune::SequentialNonblockingDots<VectorType>>();
         linearoperator_for_precond_ = op_prec;
     }
 
@@ -145,6 +151,10 @@ namespace Dune
         const int maxiter = prm.get<int>("maxiter", 200);
         const int verbosity = is_iorank ? prm.get<int>("verbosity", 0) : 0;
         const std::string solver_type = prm.get<std::string>("solver", "bicgstab");
+        // gives up early on stagnation or divergence, only used by the solvers of opm-simulators
+        const Dune::KrylovMonitor monitor(prm.get<int>("stagnation_iterations", 0),
+                                          prm.get<double>("stagnation_reduction", 0.9),
+                                          prm.get<double>("divergence_factor", 0.0));
         if (solver_type == "bicgstab") {
             linsolver_.reset(new Dune::BiCGSTABSolver<VectorType>(*linearoperator_for_solver_,
                                                                   *scalarproduct_,
@@ -152,6 +162,14 @@ namespace Dune
                                                                   tol, // desired residual reduction factor
                                                                   maxiter, // maximum number of iterations
                                                                   verbosity));
+        } else if (solver_type == "pipelined_bicgstab") {
+            linsolver_.reset(new Dune::PipelinedBiCGSTABSolver<VectorType>(*linearoperator_for_solver_,
+                                                                           *preconditioner_,
+                                                                           nonblocking_dots_,
+                                                                           tol, // desired residual reduction factor
+                                                                           maxiter, // maximum number of iterations
+                                                                           verbosity,
+                                                                           monitor));
         } else if (solver_type == "loopsolver") {
             linsolver_.reset(new Dune::LoopSolver<VectorType>(*linearoperator_for_solver_,
                                                               *scalarproduct_,
@@ -168,6 +186,19 @@ namespace Dune
                                                                         restart, // desired residual reduction factor
                                                                         maxiter, // maximum number of iterations
                                                                         verbosity));
+        } else if (solver_type == "gcro") {
+            // keeps a recycled subspace between the solves of this FlexibleSolver
+            int restart = prm.get<int>("restart", 15);
+            int recycle = prm.get<int>("recycle", 5);
+            linsolver_.reset(new Dune::RecyclingGCROSolver<VectorType>(*linearoperator_for_solver_,
+                                                                       *scalarproduct_,
+                                                                       *preconditioner_,
+                                                                       tol, // desired residual reduction factor
+                                                                       restart,
+                                                                       recycle, // number of directions kept for the next solve
+                                                                       maxiter, // maximum number of iterations
+                                                                       verbosity,
+                                                                       monitor));
 #if HAVE_SUITESPARSE_UMFPACK
         } else if (solver_type == "umfpack") {
             bool dummy = false;
@@ -0,0 +1,157 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_FLOATMATRIXADAPTER_HEADER_INCLUDED
+#define OPM_FLOATMATRIXADAPTER_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/solvercategory.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+/// A sequential linear operator which applies the matrix from a single
+/// precision copy of its entries, the vectors and the accumulation stay in
+/// double precision.
+///
+/// The products of the Krylov iterations then read half the bytes of the
+/// matrix entries, and the copy stores 32 bit column indices instead of the
+/// 64 bit ones of the BCRSMatrix. getmat() still returns the double precision
+/// matrix, such that the preconditioners are set up from it. update() must be
+/// called when the entries of the matrix changed.
+template <class M, class X, class Y>
+class FloatMatrixAdapter : public Dune::AssembledLinearOperator<M, X, Y>
+{
+public:
+    using matrix_type = M;
+    using domain_type = X;
+    using range_type = Y;
+    using field_type = typename X::field_type;
+
+    static constexpr int rows = M::block_type::rows;
+    static constexpr int cols = M::block_type::cols;
+    using FloatBlock = Dune::FieldMatrix<float, rows, cols>;
+    using index_type = std::uint32_t;
+
+    explicit FloatMatrixAdapter(const M& A)
+        : A_(A)
+    {
+        update();
+    }
+
+    /// Copy the entries of the matrix, and its sparsity pattern if it changed.
+    void update()
+    {
+        if (rowStart_.size() != A_.N() + 1 || cols_.size() != A_.nonzeroes()) {
+            if (A_.M() > std::numeric_limits<index_type>::max()) {
+                OPM_THROW(std::invalid_argument, "The single precision matrix supports at most 2^32 - 1 columns");
+            }
+            rowStart_.assign(1, 0);
+            rowStart_.reserve(A_.N() + 1);
+            cols_.clear();
+            cols_.reserve(A_.nonzeroes());
+            for (auto row = A_.begin(); row != A_.end(); ++row) {
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    cols_.push_back(static_cast<index_type>(col.index()));
+                }
+                rowStart_.push_back(cols_.size());
+            }
+            values_.resize(cols_.size());
+        }
+        const int numRows = A_.N();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int r = 0; r < numRows; ++r) {
+            std::size_t k = rowStart_[r];
+            for (auto col = A_[r].begin(); col != A_[r].end(); ++col, ++k) {
+                for (int i = 0; i < rows; ++i) {
+                    for (int j = 0; j < cols; ++j) {
+                        values_[k][i][j] = static_cast<float>((*col)[i][j]);
+                    }
+                }
+            }
+        }
+    }
+
+    void apply(const X& x, Y& y) const override
+    {
+        y = 0.0;
+        applyscaleadd(1.0, x, y);
+    }
+
+    void applyscaleadd(field_type alpha, const X& x, Y& y) const override
+    {
+        const int numRows = rowStart_.size() - 1;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int r = 0; r < numRows; ++r) {
+            auto& yr = y[r];
+            for (std::size_t k = rowStart_[r]; k < rowStart_[r + 1]; ++k) {
+                const auto& block = values_[k];
+                const auto& xc = x[cols_[k]];
+                for (int i = 0; i < rows; ++i) {
+                    field_type sum = 0.0;
+                    for (int j = 0; j < cols; ++j) {
+                        sum += static_cast<field_type>(block[i][j]) * xc[j];
+                    }
+                    yr[i] += alpha * sum;
+                }
+            }
+        }
+    }
+
+    const M& getmat() const override
+    {
+        return A_;
+    }
+
+    Dune::SolverCategory::Category category() const override
+    {
+        return Dune::SolverCategory::sequential;
+    }
+
+    /// The bytes of the single precision copy.
+    std::size_t memoryUsage() const
+    {
+        return values_.capacity() * sizeof(FloatBlock)
+            + cols_.capacity() * sizeof(index_type)
+            + rowStart_.capacity() * sizeof(std::size_t);
+    }
+
+private:
+    const M& A_;
+    std::vector<std::size_t> rowStart_;
+    std::vector<index_type> cols_;
+    std::vector<FloatBlock> values_;
+};
+
+} // namespace Opm
+
+#endif // OPM_FLOATMATRIXADAPTER_HEADER_INCLUDED
@@ -82,6 +82,18 @@ struct IluReorderSpheres {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct IluLevelScheduling {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct IluMixedPrecision {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct IluCuthillMcKee {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct UseGmres {
     using type = UndefinedProperty;
 };
@@ -114,6 +126,18 @@ struct CprReuseSetup {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct CprReuseIterationFactor {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct CprRebuildInterval {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct CprFusedWeights {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct Linsolver {
     using type = UndefinedProperty;
 };
@@ -134,9 +158,77 @@ struct OpenclIluReorder {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct OpenclKernelCache {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct FpgaBitstream {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct BdaIluDecomposition {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct BdaChowPatelSweeps {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct BdaChowPatelTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct BdaPreconditioner {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverOverlapHaloExchange {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverWellAwarePreconditioner {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverFloatMatrix {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverAdaptiveReduction {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverMaxReduction {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverDumpFormat {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverAutoTune {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverAutoTuneSolves {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverAutoTuneInterval {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverStagnationIterations {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverStagnationReduction {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverDivergenceFactor {
+    using type = UndefinedProperty;
+};
 
 template<class TypeTag>
 struct LinearSolverReduction<TypeTag, TTag::FlowIstlSolverParams> {
@@ -177,6 +269,18 @@ struct IluReorderSpheres<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr bool value = false;
 };
 template<class TypeTag>
+struct IluLevelScheduling<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct IluMixedPrecision<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct IluCuthillMcKee<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
 struct UseGmres<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr bool value = false;
 };
@@ -213,6 +317,19 @@ struct CprReuseSetup<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr int value = 3;
 };
 template<class TypeTag>
+struct CprReuseIterationFactor<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 2.0;
+};
+template<class TypeTag>
+struct CprRebuildInterval<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr int value = 20;
+};
+template<class TypeTag>
+struct CprFusedWeights<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
 struct Linsolver<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr auto value = "ilu0";
 };
@@ -233,9 +350,86 @@ struct OpenclIluReorder<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr auto value = ""; // note: default value is chosen depending on the solver used
 };
 template<class TypeTag>
+struct OpenclKernelCache<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr auto value = "";
+};
+template<class TypeTag>
 struct FpgaBitstream<TypeTag, TTag::FlowIstlSolverParams> {
     static constexpr auto value = "";
 };
+template<class TypeTag>
+struct BdaIluDecomposition<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr auto value = "exact";
+};
+template<class TypeTag>
+struct BdaChowPatelSweeps<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr int value = 6;
+};
+template<class TypeTag>
+struct BdaChowPatelTolerance<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
+template<class TypeTag>
+struct BdaPreconditioner<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr auto value = "ilu0";
+};
+template<class TypeTag>
+struct LinearSolverOverlapHaloExchange<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = bool;
+    static constexpr type value = false;
+};
+template<class TypeTag>
+struct LinearSolverWellAwarePreconditioner<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = bool;
+    static constexpr type value = false;
+};
+template<class TypeTag>
+struct LinearSolverFloatMatrix<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = bool;
+    static constexpr type value = false;
+};
+template<class TypeTag>
+struct LinearSolverAdaptiveReduction<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = bool;
+    static constexpr type value = false;
+};
+template<class TypeTag>
+struct LinearSolverMaxReduction<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.1;
+};
+template<class TypeTag>
+struct LinearSolverDumpFormat<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr auto value = "matrix-market";
+};
+template<class TypeTag>
+struct LinearSolverAutoTune<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = bool;
+    static constexpr type value = false;
+};
+template<class TypeTag>
+struct LinearSolverAutoTuneSolves<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr int value = 3;
+};
+template<class TypeTag>
+struct LinearSolverAutoTuneInterval<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr int value = 2000;
+};
+template<class TypeTag>
+struct LinearSolverStagnationIterations<TypeTag, TTag::FlowIstlSolverParams> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct LinearSolverStagnationReduction<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.9;
+};
+template<class TypeTag>
+struct LinearSolverDivergenceFactor<TypeTag, TTag::FlowIstlSolverParams> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.0;
+};
 
 } // namespace Opm::Properties
 
@@ -255,6 +449,9 @@ namespace Opm
         MILU_VARIANT   ilu_milu_;
         bool   ilu_redblack_;
         bool   ilu_reorder_sphere_;
+        bool   ilu_level_scheduling_;
+        bool   ilu_mixed_precision_;
+        bool   ilu_cuthill_mckee_;
         bool   newton_use_gmres_;
         bool   require_full_sparsity_pattern_;
         bool   ignoreConvergenceFailure_;
@@ -265,8 +462,28 @@ namespace Opm
         int opencl_platform_id_;
         int cpr_max_ell_iter_ = 20;
         int cpr_reuse_setup_ = 0;
+        double cpr_reuse_iteration_factor_ = 2.0;
+        int cpr_rebuild_interval_ = 20;
+        bool cpr_fused_weights_ = false;
         std::string opencl_ilu_reorder_;
+        std::string opencl_kernel_cache_;
         std::string fpga_bitstream_;
+        std::string bda_ilu_decomposition_;
+        int bda_chow_patel_sweeps_;
+        double bda_chow_patel_tolerance_;
+        std::string bda_preconditioner_;
+        bool linear_solver_overlap_halo_exchange_;
+        bool linear_solver_well_aware_preconditioner_;
+        bool linear_solver_float_matrix_;
+        bool linear_solver_adaptive_reduction_;
+        double linear_solver_max_reduction_;
+        std::string linear_solver_dump_format_;
+        bool linear_solver_auto_tune_;
+        int linear_solver_auto_tune_solves_;
+        int linear_solver_auto_tune_interval_;
+        int linear_solver_stagnation_iterations_;
+        double linear_solver_stagnation_reduction_;
+        double linear_solver_divergence_factor_;
 
         template <class TypeTag>
         void init()
@@ -281,18 +498,41 @@ namespace Opm
             ilu_milu_ = convertString2Milu(EWOMS_GET_PARAM(TypeTag, std::string, MiluVariant));
             ilu_redblack_ = EWOMS_GET_PARAM(TypeTag, bool, IluRedblack);
             ilu_reorder_sphere_ = EWOMS_GET_PARAM(TypeTag, bool, IluReorderSpheres);
+            ilu_level_scheduling_ = EWOMS_GET_PARAM(TypeTag, bool, IluLevelScheduling);
+            ilu_mixed_precision_ = EWOMS_GET_PARAM(TypeTag, bool, IluMixedPrecision);
+            ilu_cuthill_mckee_ = EWOMS_GET_PARAM(TypeTag, bool, IluCuthillMcKee);
             newton_use_gmres_ = EWOMS_GET_PARAM(TypeTag, bool, UseGmres);
             require_full_sparsity_pattern_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverRequireFullSparsityPattern);
             ignoreConvergenceFailure_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverIgnoreConvergenceFailure);
             scale_linear_system_ = EWOMS_GET_PARAM(TypeTag, bool, ScaleLinearSystem);
             cpr_max_ell_iter_  =  EWOMS_GET_PARAM(TypeTag, int, CprMaxEllIter);
             cpr_reuse_setup_  =  EWOMS_GET_PARAM(TypeTag, int, CprReuseSetup);
+            cpr_reuse_iteration_factor_ = EWOMS_GET_PARAM(TypeTag, double, CprReuseIterationFactor);
+            cpr_rebuild_interval_ = EWOMS_GET_PARAM(TypeTag, int, CprRebuildInterval);
+            cpr_fused_weights_ = EWOMS_GET_PARAM(TypeTag, bool, CprFusedWeights);
             linsolver_ = EWOMS_GET_PARAM(TypeTag, std::string, Linsolver);
             accelerator_mode_ = EWOMS_GET_PARAM(TypeTag, std::string, AcceleratorMode);
             bda_device_id_ = EWOMS_GET_PARAM(TypeTag, int, BdaDeviceId);
             opencl_platform_id_ = EWOMS_GET_PARAM(TypeTag, int, OpenclPlatformId);
             opencl_ilu_reorder_ = EWOMS_GET_PARAM(TypeTag, std::string, OpenclIluReorder);
+            opencl_kernel_cache_ = EWOMS_GET_PARAM(TypeTag, std::string, OpenclKernelCache);
             fpga_bitstream_ = EWOMS_GET_PARAM(TypeTag, std::string, FpgaBitstream);
+            bda_ilu_decomposition_ = EWOMS_GET_PARAM(TypeTag, std::string, BdaIluDecomposition);
+            bda_chow_patel_sweeps_ = EWOMS_GET_PARAM(TypeTag, int, BdaChowPatelSweeps);
+            bda_chow_patel_tolerance_ = EWOMS_GET_PARAM(TypeTag, double, BdaChowPatelTolerance);
+            bda_preconditioner_ = EWOMS_GET_PARAM(TypeTag, std::string, BdaPreconditioner);
+            linear_solver_overlap_halo_exchange_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverOverlapHaloExchange);
+            linear_solver_well_aware_preconditioner_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverWellAwarePreconditioner);
+            linear_solver_float_matrix_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverFloatMatrix);
+            linear_solver_adaptive_reduction_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverAdaptiveReduction);
+            linear_solver_max_reduction_ = EWOMS_GET_PARAM(TypeTag, double, LinearSolverMaxReduction);
+            linear_solver_dump_format_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSolverDumpFormat);
+            linear_solver_auto_tune_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverAutoTune);
+            linear_solver_auto_tune_solves_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverAutoTuneSolves);
+            linear_solver_auto_tune_interval_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverAutoTuneInterval);
+            linear_solver_stagnation_iterations_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverStagnationIterations);
+            linear_solver_stagnation_reduction_ = EWOMS_GET_PARAM(TypeTag, double, LinearSolverStagnationReduction);
+            linear_solver_divergence_factor_ = EWOMS_GET_PARAM(TypeTag, double, LinearSolverDivergenceFactor);
         }
 
         template <class TypeTag>
@@ -307,18 +547,41 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, std::string, MiluVariant, "Specify which variant of the modified-ILU preconditioner ought to be used. Possible variants are: ILU (default, plain ILU), MILU_1 (lump diagonal with dropped row entries), MILU_2 (lump diagonal with the sum of the absolute values of the dropped row  entries), MILU_3 (if diagonal is positive add sum of dropped row entrires. Otherwise substract them), MILU_4 (if diagonal is positive add sum of dropped row entrires. Otherwise do nothing");
             EWOMS_REGISTER_PARAM(TypeTag, bool, IluRedblack, "Use red-black partioning for the ILU preconditioner");
             EWOMS_REGISTER_PARAM(TypeTag, bool, IluReorderSpheres, "Whether to reorder the entries of the matrix in the red-black ILU preconditioner in spheres starting at an edge. If false the original ordering is preserved in each color. Otherwise why try to ensure D4 ordering (in a 2D structured grid, the diagonal elements are consecutive).");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, IluLevelScheduling, "Use level scheduling to run the triangular solves of the ILU preconditioner (flexible solver only) on multiple threads. Combine with --ilu-redblack=true to get few levels.");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, IluMixedPrecision, "Store the factors of the ILU preconditioner and of the ILU smoothers of the CPR coarse solver in single precision (flexible solver only). The Krylov iteration is still done in double precision.");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, IluCuthillMcKee, "Renumber the unknowns in reverse Cuthill-McKee order for the factorization and the triangular solves of the ILU preconditioner and of the CPR smoother (flexible solver only). This narrows the band of the matrix for grids with many inactive cells and NNCs, which improves the cache reuse.");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseGmres, "Use GMRES as the linear solver");
             EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverRequireFullSparsityPattern, "Produce the full sparsity pattern for the linear solver");
             EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverIgnoreConvergenceFailure, "Continue with the simulation like nothing happened after the linear solver did not converge");
             EWOMS_REGISTER_PARAM(TypeTag, bool, ScaleLinearSystem, "Scale linear system according to equation scale and primary variable types");
             EWOMS_REGISTER_PARAM(TypeTag, int, CprMaxEllIter, "MaxIterations of the elliptic pressure part of the cpr solver");
-            EWOMS_REGISTER_PARAM(TypeTag, int, CprReuseSetup, "Reuse preconditioner setup. Valid options are 0: recreate the preconditioner for every linear solve, 1: recreate once every timestep, 2: recreate if last linear solve took more than 10 iterations, 3: never recreate");
+            EWOMS_REGISTER_PARAM(TypeTag, int, CprReuseSetup, "Reuse preconditioner setup. Valid options are 0: recreate the preconditioner for every linear solve, 1: recreate once every timestep, 2: recreate if last linear solve took more than 10 iterations, 3: never recreate, 4: keep the preconditioner unchanged across Newton iterations and timesteps and only update it when the linear iterations grow beyond CprReuseIterationFactor times the iterations of the first solve after the last update, 5: update the values of the preconditioner for every linear solve, keeping the AMG aggregates and the coarse sparsity, and rebuild it every CprRebuildInterval updates or when the linear iterations grow beyond CprReuseIterationFactor times the iterations of the first solve after the last rebuild");
+            EWOMS_REGISTER_PARAM(TypeTag, double, CprReuseIterationFactor, "Growth factor of linear iterations, relative to the first solve after the last preconditioner update (--cpr-reuse-setup=4) or rebuild (--cpr-reuse-setup=5), which triggers an update or a rebuild");
+            EWOMS_REGISTER_PARAM(TypeTag, int, CprRebuildInterval, "The number of value-only preconditioner updates after which the preconditioner is rebuilt when --cpr-reuse-setup=5, 0 to rebuild only when the linear iterations grow");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, CprFusedWeights, "Compute the quasi-IMPES weights of the cpr preconditioner in the same pass over the matrix as the pressure matrix, only used with --linear-solver=cpr_quasiimpes");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, Linsolver, "Configuration of solver. Valid options are: ilu0 (default), cpr (an alias for cpr_trueimpes), cpr_quasiimpes, cpr_trueimpes or amg. Alternatively, you can request a configuration to be read from a JSON file by giving the filename here, ending with '.json.'");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, AcceleratorMode, "Use GPU (cusparseSolver or openclSolver) or FPGA (fpgaSolver) as the linear solver, usage: '--accelerator-mode=[none|cusparse|opencl|fpga]'");
             EWOMS_REGISTER_PARAM(TypeTag, int, BdaDeviceId, "Choose device ID for cusparseSolver or openclSolver, use 'nvidia-smi' or 'clinfo' to determine valid IDs");
             EWOMS_REGISTER_PARAM(TypeTag, int, OpenclPlatformId, "Choose platform ID for openclSolver, use 'clinfo' to determine valid platform IDs");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, OpenclIluReorder, "Choose the reordering strategy for ILU for openclSolver and fpgaSolver, usage: '--opencl-ilu-reorder=[level_scheduling|graph_coloring], level_scheduling behaves like Dune and cusparse, graph_coloring is more aggressive and likely to be faster, but is random-based and generally increases the number of linear solves and linear iterations significantly.");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, OpenclKernelCache, "Directory in which openclSolver caches the compiled kernels, keyed by the device, the driver version and the kernel sources, so that later runs load them instead of compiling them again, empty to always compile the kernels");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, FpgaBitstream, "Specify the bitstream file for fpgaSolver (including path), usage: '--fpga-bitstream=<filename>'");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, BdaIluDecomposition, "Choose the ILU0 decomposition for cusparseSolver and openclSolver, usage: '--bda-ilu-decomposition=[exact|chow_patel]', chow_patel is the iterative fine-grained parallel decomposition of Chow and Patel, done completely on the GPU");
+            EWOMS_REGISTER_PARAM(TypeTag, int, BdaChowPatelSweeps, "Maximum number of sweeps of the chow_patel decomposition");
+            EWOMS_REGISTER_PARAM(TypeTag, double, BdaChowPatelTolerance, "Stop the sweeps of the chow_patel decomposition when the relative change of the factors during a sweep is below this value, 0 always does BdaChowPatelSweeps sweeps");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, BdaPreconditioner, "Choose the preconditioner for openclSolver, usage: '--bda-preconditioner=[ilu0|cpr]', cpr uses a pressure AMG built from quasi-IMPES weights with BILU0 as second stage");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverOverlapHaloExchange, "Overlap the halo exchange with the interior rows of the matrix-vector product in parallel runs, only used without --matrix-add-well-contributions");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverWellAwarePreconditioner, "Set up the preconditioner from a copy of the matrix which contains the well contributions on its existing sparsity pattern, while the wells are still applied exactly by the operator. Only used without --matrix-add-well-contributions");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverFloatMatrix, "Apply the matrix in the Krylov iterations from a single precision copy of its entries, the preconditioner is still set up from the double precision matrix. Only used in serial runs with --matrix-add-well-contributions=true");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverAdaptiveReduction, "Choose the linear solver reduction of each Newton iteration from the reduction of the nonlinear residual (Eisenstat-Walker), between --linear-solver-reduction and --linear-solver-max-reduction");
+            EWOMS_REGISTER_PARAM(TypeTag, double, LinearSolverMaxReduction, "The loosest reduction of the residual which the linear solver must achieve with --linear-solver-adaptive-reduction");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSolverDumpFormat, "The format of the linear systems written with a linear solver verbosity above 10, usage: '--linear-solver-dump-format=[matrix-market|binary]', binary is much faster for large systems and includes the standard wells which are not added to the matrix");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverAutoTune, "Try variants of the ILU smoother and of the AMG coarsening of the configured linear solver on the first linear systems, and keep the one with the smallest time to solution (flexible solver only)");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverAutoTuneSolves, "The number of linear solves with each variant when auto-tuning the linear solver");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverAutoTuneInterval, "The number of linear solves after which the variants are tried again when auto-tuning the linear solver, 0 to keep the first choice");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverStagnationIterations, "Stop the linear solver early if the residual has not dropped below LinearSolverStagnationReduction times its smallest value for this number of iterations, 0 to never stop early. Only the pipelined_bicgstab and gcro solvers are monitored");
+            EWOMS_REGISTER_PARAM(TypeTag, double, LinearSolverStagnationReduction, "The factor by which the residual must drop below its smallest value to count as progress of the linear solver, see LinearSolverStagnationIterations");
+            EWOMS_REGISTER_PARAM(TypeTag, double, LinearSolverDivergenceFactor, "Stop the linear solver early if the residual grows beyond this factor times the initial residual, 0 to never stop early. Only the pipelined_bicgstab and gcro solvers are monitored");
         }
 
         FlowLinearSolverParameters() { reset(); }
@@ -338,11 +601,31 @@ namespace Opm
             ilu_milu_                 = MILU_VARIANT::ILU;
             ilu_redblack_             = false;
             ilu_reorder_sphere_       = true;
+            ilu_level_scheduling_     = false;
+            ilu_mixed_precision_      = false;
+            ilu_cuthill_mckee_        = false;
             accelerator_mode_         = "none";
             bda_device_id_            = 0;
             opencl_platform_id_       = 0;
             opencl_ilu_reorder_       = "";  // note: the default value is chosen depending on the solver used
+            opencl_kernel_cache_      = "";
             fpga_bitstream_           = "";
+            bda_ilu_decomposition_    = "exact";
+            bda_chow_patel_sweeps_    = 6;
+            bda_chow_patel_tolerance_ = 0.0;
+            bda_preconditioner_       = "ilu0";
+            linear_solver_overlap_halo_exchange_ = false;
+            linear_solver_well_aware_preconditioner_ = false;
+            linear_solver_float_matrix_ = false;
+            linear_solver_adaptive_reduction_ = false;
+            linear_solver_max_reduction_ = 0.1;
+            linear_solver_dump_format_ = "matrix-market";
+            linear_solver_auto_tune_ = false;
+            linear_solver_auto_tune_solves_ = 3;
+            linear_solver_auto_tune_interval_ = 2000;
+            linear_solver_stagnation_iterations_ = 0;
+            linear_solver_stagnation_reduction_ = 0.9;
+            linear_solver_divergence_factor_ = 0.0;
         }
     };
 
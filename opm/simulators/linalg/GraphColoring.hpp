@@ -26,6 +26,8 @@
 #include <numeric>
 #include <queue>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 
 namespace Opm
 {
@@ -103,6 +105,88 @@ std::size_t breadthFirstSearch(const Graph& graph, typename Graph::VertexDescrip
     }
     return noVisited;
 }
+
+/// The priority of a vertex in the coloring of Jones and Plassmann: a hash of
+/// its index, such that the coloring does not depend on random numbers.
+inline std::uint64_t jonesPlassmannPriority(std::uint64_t vertex)
+{
+    vertex += 0x9e3779b97f4a7c15ULL;
+    vertex = (vertex ^ (vertex >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    vertex = (vertex ^ (vertex >> 27)) * 0x94d049bb133111ebULL;
+    return vertex ^ (vertex >> 31);
+}
+
+/// \brief Color the vertices 0, ..., noVertices-1 with the algorithm of Jones and Plassmann.
+///
+/// In every round, the uncolored vertices whose priority is higher than that of all
+/// their uncolored neighbours get the next color. The vertices of a round are
+/// checked in parallel.
+/// \param forEachNeighbor Called as forEachNeighbor(vertex, functor), must call
+///                        functor(neighbor) for all neighbours of vertex.
+template<class ForEachNeighbor>
+std::tuple<std::vector<int>, int, std::vector<std::size_t> >
+colorJonesPlassmann(std::size_t noVertices, const ForEachNeighbor& forEachNeighbor)
+{
+    std::vector<std::uint64_t> priorities(noVertices);
+    std::vector<int> colors(noVertices, -1);
+    std::vector<char> selected(noVertices, false);
+    std::vector<std::size_t> remaining(noVertices);
+    std::iota(remaining.begin(), remaining.end(), 0);
+    for(std::size_t vertex = 0; vertex < noVertices; ++vertex)
+    {
+        priorities[vertex] = jonesPlassmannPriority(vertex);
+    }
+    // equal priorities are ordered by index, so every round colors a vertex
+    auto higher = [&priorities](std::size_t v1, std::size_t v2)
+        {
+            return priorities[v1] > priorities[v2]
+                || (priorities[v1] == priorities[v2] && v1 > v2);
+        };
+
+    int color = 0;
+    std::vector<std::size_t> verticesPerColor;
+    while( !remaining.empty() )
+    {
+        // the colors are only written after the round, a round sees the
+        // colors of the previous rounds only
+        const std::ptrdiff_t noRemaining = remaining.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for(std::ptrdiff_t k = 0; k < noRemaining; ++k)
+        {
+            const std::size_t vertex = remaining[k];
+            bool isMax = true;
+            forEachNeighbor(vertex, [&](std::size_t neighbor)
+                {
+                    if ( neighbor != vertex && colors[neighbor] == -1 && higher(neighbor, vertex) )
+                    {
+                        isMax = false;
+                    }
+                });
+            selected[vertex] = isMax;
+        }
+
+        std::size_t noColored = 0;
+        for(auto vertex: remaining)
+        {
+            if ( selected[vertex] )
+            {
+                colors[vertex] = color;
+                ++noColored;
+            }
+        }
+        auto newEnd = std::remove_if(remaining.begin(), remaining.end(),
+                                     [&selected](std::size_t vertex)
+                                     {
+                                         return selected[vertex];
+                                     });
+        remaining.erase(newEnd, remaining.end());
+        verticesPerColor.push_back(noColored);
+        ++color;
+    }
+    return std::make_tuple(colors, color, verticesPerColor);
+}
 } // end namespace Detail
 
 
@@ -179,6 +263,31 @@ colorVerticesWelshPowell(const Graph& graph)
     return std::make_tuple(colors, color, verticesPerColor);
 }
 
+/// \brief Color the vertices of graph.
+///
+/// It uses the algorithm of Jones and Plassmann, which is threaded but needs
+/// more colors than the one of Welsh and Powell. The coloring does
+/// not depend on the number of threads.
+/// \param graph The graph to color. Must adhere to the graph interface of dune-istl.
+/// \return A pair of a vector with the colors of the vertices and the number of colors
+///         assigned
+template<class Graph>
+std::tuple<std::vector<int>, int, std::vector<std::size_t> >
+colorVerticesJonesPlassmann(const Graph& graph)
+{
+    using Vertex = typename Graph::VertexDescriptor;
+    auto forEachNeighbor = [&graph](std::size_t vertex, auto functor)
+        {
+            for(auto edge = graph.beginEdges(static_cast<Vertex>(vertex)),
+                    endEdge = graph.endEdges(static_cast<Vertex>(vertex));
+                edge != endEdge; ++edge)
+            {
+                functor(static_cast<std::size_t>(edge.target()));
+            }
+        };
+    return Detail::colorJonesPlassmann(graph.maxVertex() + 1, forEachNeighbor);
+}
+
 /// \! Reorder colored graph preserving order of vertices with the same color.
 template<class Graph>
 std::vector<std::size_t>
@@ -241,5 +350,156 @@ reorderVerticesSpheres(const std::vector<int>& colors, int noColors,
     }
     return indices;
 }
+
+/// \brief Reorder the vertices in reverse Cuthill-McKee order.
+///
+/// Each connected component is numbered by a breadth first search from a
+/// pseudo-peripheral vertex, visiting the neighbours by increasing degree,
+/// and the result is reversed. This reduces the bandwidth of the matrix
+/// the graph belongs to.
+/// \param graph The graph to reorder. Must adhere to the graph interface of dune-istl.
+/// \param noVertices Only the vertices below this are reordered, the others
+///                   (e.g. the ghost rows at the end) keep their index.
+/// \return The new index of each vertex.
+template<class Graph>
+std::vector<std::size_t>
+reorderVerticesReverseCuthillMcKee(const Graph& graph, std::size_t noVertices)
+{
+    using Vertex = typename Graph::VertexDescriptor;
+    const std::size_t size = graph.maxVertex() + 1;
+    noVertices = std::min(noVertices, size);
+    std::vector<std::size_t> indices(size);
+    std::iota(indices.begin(), indices.end(), 0);
+    if ( noVertices == 0 )
+    {
+        return indices;
+    }
+
+    auto forEachNeighbor = [&graph, noVertices](Vertex vertex, auto functor)
+        {
+            for(auto edge = graph.beginEdges(vertex), endEdge = graph.endEdges(vertex);
+                edge != endEdge; ++edge)
+            {
+                const Vertex target = edge.target();
+                if ( target != vertex && static_cast<std::size_t>(target) < noVertices )
+                {
+                    functor(target);
+                }
+            }
+        };
+
+    std::vector<std::size_t> degrees(noVertices, 0);
+    for(std::size_t vertex = 0; vertex < noVertices; ++vertex)
+    {
+        forEachNeighbor(vertex, [&degrees, vertex](Vertex) { ++degrees[vertex]; });
+    }
+    std::vector<Vertex> byDegree(noVertices);
+    std::iota(byDegree.begin(), byDegree.end(), 0);
+    std::stable_sort(byDegree.begin(), byDegree.end(),
+                     [&degrees](const Vertex& v1, const Vertex& v2)
+                     {
+                         return degrees[v1] < degrees[v2];
+                     });
+
+    std::vector<bool> numbered(noVertices, false);
+    std::vector<std::size_t> level(noVertices, 0);
+    std::vector<std::size_t> stamp(noVertices, 0);
+    std::size_t search = 0;
+    std::vector<Vertex> order;
+    order.reserve(noVertices);
+
+    // Breadth first search within the not yet numbered vertices, returning
+    // the vertices of the last level and the number of levels.
+    auto lastLevel = [&](Vertex root, std::vector<Vertex>& last)
+        {
+            ++search;
+            std::queue<Vertex> nextVertices;
+            nextVertices.push(root);
+            stamp[root] = search;
+            level[root] = 0;
+            std::size_t depth = 0;
+            last.clear();
+            while( !nextVertices.empty() )
+            {
+                const Vertex current = nextVertices.front();
+                nextVertices.pop();
+                if ( level[current] > depth )
+                {
+                    depth = level[current];
+                    last.clear();
+                }
+                last.push_back(current);
+                forEachNeighbor(current, [&](Vertex target)
+                    {
+                        if ( !numbered[target] && stamp[target] != search )
+                        {
+                            stamp[target] = search;
+                            level[target] = level[current] + 1;
+                            nextVertices.push(target);
+                        }
+                    });
+            }
+            return depth;
+        };
+
+    std::vector<Vertex> last;
+    std::vector<Vertex> neighbors;
+    auto candidate = byDegree.begin();
+    while ( order.size() < noVertices )
+    {
+        while ( numbered[*candidate] )
+        {
+            ++candidate;
+        }
+        // Find a pseudo-peripheral root as proposed by George and Liu.
+        Vertex root = *candidate;
+        std::size_t depth = lastLevel(root, last);
+        for ( int sweep = 0; sweep < 5; ++sweep )
+        {
+            const Vertex next = *std::min_element(last.begin(), last.end(),
+                                                  [&degrees](const Vertex& v1, const Vertex& v2)
+                                                  {
+                                                      return degrees[v1] < degrees[v2];
+                                                  });
+            const std::size_t nextDepth = lastLevel(next, last);
+            if ( nextDepth <= depth )
+            {
+                break;
+            }
+            root = next;
+            depth = nextDepth;
+        }
+
+        // Cuthill-McKee numbering of the component
+        std::size_t head = order.size();
+        order.push_back(root);
+        numbered[root] = true;
+        while ( head < order.size() )
+        {
+            const Vertex current = order[head++];
+            neighbors.clear();
+            forEachNeighbor(current, [&](Vertex target)
+                {
+                    if ( !numbered[target] )
+                    {
+                        numbered[target] = true;
+                        neighbors.push_back(target);
+                    }
+                });
+            std::stable_sort(neighbors.begin(), neighbors.end(),
+                             [&degrees](const Vertex& v1, const Vertex& v2)
+                             {
+                                 return degrees[v1] < degrees[v2];
+                             });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+
+    for ( std::size_t i = 0; i < noVertices; ++i )
+    {
+        indices[order[i]] = noVertices - 1 - i;
+    }
+    return indices;
+}
 } // end namespace Opm
 #endif
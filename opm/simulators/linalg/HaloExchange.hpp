@@ -0,0 +1,179 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_HALOEXCHANGE_HEADER_INCLUDED
+#define OPM_HALOEXCHANGE_HEADER_INCLUDED
+
+#if HAVE_MPI
+#include <mpi.h>
+#include <dune/common/parallel/mpitraits.hh>
+#include <dune/istl/owneroverlapcopy.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// A nonblocking copy of the owner entries of a vector to the ghost entries of
+/// the other processes, like copyOwnerToAll() of the communication, but split
+/// into start() and finish() such that local work can be done in between.
+///
+/// The entries are exchanged with each neighbouring process in the order of
+/// their global indices, so both sides agree on it without extra messages.
+/// At most one exchange can be in flight.
+template <class X, class Communication>
+class HaloExchange
+{
+public:
+    using block_type = typename X::block_type;
+
+    HaloExchange(const Communication& comm, const int tag)
+        : comm_(comm)
+        , tag_(tag)
+    {
+        using AttributeSet = Dune::OwnerOverlapCopyAttributeSet;
+        // lists sorted by global index, so that both sides agree on the order
+        std::map<int, std::pair<std::vector<std::pair<int,int>>, std::vector<std::pair<int,int>>>> lists;
+        for (const auto& process : comm_.remoteIndices()) {
+            for (const auto& remote : *process.second.first) {
+                const auto& pair = remote.localIndexPair();
+                const bool localOwner = pair.local().attribute() == AttributeSet::owner;
+                const bool remoteOwner = remote.attribute() == AttributeSet::owner;
+                const int global = pair.global();
+                const int local = pair.local().local();
+                if (localOwner && !remoteOwner) {
+                    lists[process.first].first.emplace_back(global, local);
+                } else if (!localOwner && remoteOwner) {
+                    lists[process.first].second.emplace_back(global, local);
+                }
+            }
+        }
+        std::size_t sendSize = 0, recvSize = 0;
+        for (auto& entry : lists) {
+            auto& send = entry.second.first;
+            auto& recv = entry.second.second;
+            std::sort(send.begin(), send.end());
+            std::sort(recv.begin(), recv.end());
+            Neighbour neighbour{entry.first, {}, {}, sendSize, recvSize};
+            for (const auto& s : send)
+                neighbour.send.push_back(s.second);
+            for (const auto& r : recv)
+                neighbour.recv.push_back(r.second);
+            sendSize += send.size();
+            recvSize += recv.size();
+            neighbours_.push_back(std::move(neighbour));
+        }
+        sendBuffer_.resize(sendSize);
+        recvBuffer_.resize(recvSize);
+        requests_.resize(2 * neighbours_.size());
+    }
+
+    HaloExchange(const HaloExchange&) = delete;
+    HaloExchange& operator=(const HaloExchange&) = delete;
+
+    ~HaloExchange()
+    {
+        // the buffers must outlive the requests
+        wait_();
+    }
+
+    /// Mark the local indices whose entries are received from other processes.
+    void markReceived(std::vector<bool>& received) const
+    {
+        for (const auto& neighbour : neighbours_)
+            for (const auto index : neighbour.recv)
+                received[index] = true;
+    }
+
+    /// Start sending the owner entries of x, an exchange still in flight is
+    /// dropped.
+    void start(const X& x)
+    {
+        wait_();
+        const auto type = Dune::MPITraits<block_type>::getType();
+        MPI_Comm mpiComm = comm_.communicator();
+        std::size_t r = 0;
+        for (const auto& neighbour : neighbours_) {
+            MPI_Irecv(recvBuffer_.data() + neighbour.recvOffset, neighbour.recv.size(), type,
+                      neighbour.rank, tag_, mpiComm, &requests_[r++]);
+        }
+        for (const auto& neighbour : neighbours_) {
+            block_type* buffer = sendBuffer_.data() + neighbour.sendOffset;
+            for (std::size_t i = 0; i < neighbour.send.size(); ++i)
+                buffer[i] = x[neighbour.send[i]];
+            MPI_Isend(buffer, neighbour.send.size(), type,
+                      neighbour.rank, tag_, mpiComm, &requests_[r++]);
+        }
+        pending_ = true;
+    }
+
+    /// Wait for the exchange started by start() and overwrite the ghost entries
+    /// of x with the values of their owners. Does nothing if none is in flight.
+    void finish(X& x)
+    {
+        if (!pending_)
+            return;
+        wait_();
+        for (const auto& neighbour : neighbours_) {
+            const block_type* buffer = recvBuffer_.data() + neighbour.recvOffset;
+            for (std::size_t i = 0; i < neighbour.recv.size(); ++i)
+                x[neighbour.recv[i]] = buffer[i];
+        }
+    }
+
+    bool pending() const
+    { return pending_; }
+
+private:
+    // indices to send to or receive from one process
+    struct Neighbour
+    {
+        int rank;
+        std::vector<int> send;
+        std::vector<int> recv;
+        std::size_t sendOffset;
+        std::size_t recvOffset;
+    };
+
+    void wait_()
+    {
+        if (pending_) {
+            MPI_Waitall(requests_.size(), requests_.data(), MPI_STATUSES_IGNORE);
+            pending_ = false;
+        }
+    }
+
+    const Communication& comm_;
+    const int tag_;
+    std::vector<Neighbour> neighbours_;
+    std::vector<block_type> sendBuffer_;
+    std::vector<block_type> recvBuffer_;
+    std::vector<MPI_Request> requests_;
+    bool pending_ = false;
+};
+
+} // namespace Opm
+
+#endif // HAVE_MPI
+
+#endif // OPM_HALOEXCHANGE_HEADER_INCLUDED
@@ -26,19 +26,31 @@
 #include <opm/models/utils/propertysystem.hh>
 #include <opm/simulators/linalg/ExtractParallelGridInformationToISTL.hpp>
 #include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/FloatMatrixAdapter.hpp>
+#include <opm/simulators/linalg/HaloExchange.hpp>
+#include <opm/simulators/linalg/LinearSolverAutoTuner.hpp>
 #include <opm/simulators/linalg/MatrixBlock.hpp>
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
 #include <opm/simulators/linalg/WellOperators.hpp>
 #include <opm/simulators/linalg/WriteSystemMatrixHelper.hpp>
 #include <opm/simulators/linalg/findOverlapRowsAndColumns.hpp>
 #include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
+#include <opm/simulators/linalg/SubdomainDirectPreconditioner.hpp>
 #include <opm/simulators/linalg/setupPropertyTree.hpp>
+#include <opm/simulators/utils/MemoryReport.hpp>
+#include <opm/simulators/utils/Tracing.hpp>
 
 
 #if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
 #include <opm/simulators/linalg/bda/BdaBridge.hpp>
 #endif
 
+#include <dune/common/timer.hh>
+
+#include <algorithm>
+#include <functional>
+#include <future>
+
 namespace Opm::Properties {
 
 namespace TTag {
@@ -92,6 +104,11 @@ namespace Opm
         using WellModelOperator = WellModelAsLinearOperator<WellModel, Vector, Vector>;
         using ElementMapper = GetPropType<TypeTag, Properties::ElementMapper>;
 
+        // Whether the rows of the overlap cells are assembled. If not, the overlap
+        // cells only provide the ghost values of the interior rows, and their rows
+        // are replaced by the identity for every preconditioner.
+        static constexpr bool linearizeNonLocalElements = getPropValue<TypeTag, Properties::LinearizeNonLocalElements>();
+
 #if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
         static const unsigned int block_size = Matrix::block_type::rows;
         std::unique_ptr<BdaBridge<Matrix, Vector, block_size>> bdaBridge;
@@ -129,20 +146,47 @@ namespace Opm
 #if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
             {
                 std::string accelerator_mode = EWOMS_GET_PARAM(TypeTag, std::string, AcceleratorMode);
-                if ((simulator_.vanguard().grid().comm().size() > 1) && (accelerator_mode != "none")) {
+                const auto& grid_comm = simulator_.vanguard().grid().comm();
+                if ((grid_comm.size() > 1) && (accelerator_mode != "none") && (accelerator_mode != "opencl")) {
+                    if (on_io_rank) {
+                        OpmLog::warning("Only the openclSolver can be used with MPI, GPU/FPGA are disabled");
+                    }
+                    accelerator_mode = "none";
+                }
+                // the well contributions of wells that are distributed over several processes
+                // cannot be applied by the openclSolver
+                if ((grid_comm.size() > 1) && (accelerator_mode == "opencl") && !EWOMS_GET_PARAM(TypeTag, bool, MatrixAddWellContributions)) {
                     if (on_io_rank) {
-                        OpmLog::warning("Cannot use GPU or FPGA with MPI, GPU/FPGA are disabled");
+                        OpmLog::warning("openclSolver with MPI needs --matrix-add-well-contributions=true, GPU is disabled");
                     }
                     accelerator_mode = "none";
                 }
                 const int platformID = EWOMS_GET_PARAM(TypeTag, int, OpenclPlatformId);
-                const int deviceID = EWOMS_GET_PARAM(TypeTag, int, BdaDeviceId);
+                // distribute the processes over the available devices, the backend wraps too high IDs
+                const int deviceID = EWOMS_GET_PARAM(TypeTag, int, BdaDeviceId) + grid_comm.rank();
                 const int maxit = EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIter);
                 const double tolerance = EWOMS_GET_PARAM(TypeTag, double, LinearSolverReduction);
                 const std::string opencl_ilu_reorder = EWOMS_GET_PARAM(TypeTag, std::string, OpenclIluReorder);
                 const int linear_solver_verbosity = parameters_.linear_solver_verbosity_;
                 std::string fpga_bitstream = EWOMS_GET_PARAM(TypeTag, std::string, FpgaBitstream);
                 bdaBridge.reset(new BdaBridge<Matrix, Vector, block_size>(accelerator_mode, fpga_bitstream, linear_solver_verbosity, maxit, tolerance, platformID, deviceID, opencl_ilu_reorder));
+                if (parameters_.bda_ilu_decomposition_ != "exact" && parameters_.bda_ilu_decomposition_ != "chow_patel") {
+                    OPM_THROW(std::logic_error, "Error invalid argument for --bda-ilu-decomposition, usage: '--bda-ilu-decomposition=[exact|chow_patel]'");
+                }
+                if (parameters_.bda_ilu_decomposition_ == "chow_patel" && (accelerator_mode == "cusparse" || accelerator_mode == "opencl")) {
+                    bdaBridge->setChowPatel(parameters_.bda_chow_patel_sweeps_, parameters_.bda_chow_patel_tolerance_);
+                }
+                if (parameters_.bda_preconditioner_ != "ilu0" && parameters_.bda_preconditioner_ != "cpr") {
+                    OPM_THROW(std::logic_error, "Error invalid argument for --bda-preconditioner, usage: '--bda-preconditioner=[ilu0|cpr]'");
+                }
+                if (parameters_.bda_preconditioner_ == "cpr" && accelerator_mode == "opencl") {
+                    bdaBridge->setCpr(Indices::pressureSwitchIdx);
+                } else if (parameters_.bda_preconditioner_ == "cpr" && accelerator_mode != "none") {
+                    OpmLog::warning("The cpr preconditioner is only supported by the openclSolver, using ilu0");
+                }
+                if (accelerator_mode == "opencl" && !parameters_.opencl_kernel_cache_.empty()) {
+                    bdaBridge->setKernelCache(parameters_.opencl_kernel_cache_);
+                }
             }
 #else
             if (EWOMS_GET_PARAM(TypeTag, std::string, AcceleratorMode) != "none") {
@@ -158,12 +202,6 @@ namespace Opm
             detail::findOverlapAndInterior(simulator_.vanguard().grid(), elemMapper, overlapRows_, interiorRows_);
 
             useWellConn_ = EWOMS_GET_PARAM(TypeTag, bool, MatrixAddWellContributions);
-#if HAVE_FPGA
-            // check usage of MatrixAddWellContributions: for FPGA they must be included
-            if (EWOMS_GET_PARAM(TypeTag, std::string, AcceleratorMode) == "fpga" && !useWellConn_) {
-                OPM_THROW(std::logic_error,"fpgaSolver needs --matrix-add-well-contributions=true");
-            }
-#endif
             const bool ownersFirst = EWOMS_GET_PARAM(TypeTag, bool, OwnerCellsFirst);
             if (!ownersFirst) {
                 const std::string msg = "The linear solver no longer supports --owner-cells-first=false.";
@@ -175,6 +213,35 @@ namespace Opm
 
             interiorCellNum_ = detail::numMatrixRowsToUseInSolver(simulator_.vanguard().grid(), true);
 
+            overlapHaloExchange_ = parameters_.linear_solver_overlap_halo_exchange_ && isParallel() && !useWellConn_;
+            wellAwarePreconditioner_ = parameters_.linear_solver_well_aware_preconditioner_ && !useWellConn_;
+            floatMatrix_ = parameters_.linear_solver_float_matrix_ && !isParallel() && useWellConn_;
+            if (parameters_.linear_solver_float_matrix_ && !floatMatrix_ && on_io_rank) {
+                OpmLog::warning("The single precision matrix needs a serial run with "
+                                "--matrix-add-well-contributions=true, using the double precision matrix.");
+            }
+            if (overlapHaloExchange_) {
+                // The operator makes the preconditioned vectors consistent.
+                const std::string precType = prm_.get<std::string>("preconditioner.type", "ParOverILU0");
+                if (precType == "ParOverILU0" || precType == "ILU0") {
+                    prm_.put("preconditioner.copy_owner_to_all", false);
+                }
+            }
+
+            if (!linearizeNonLocalElements && isParallel() && on_io_rank
+                && prm_.get<std::string>("preconditioner.type", "ParOverILU0") == "ParOverILU0") {
+                OpmLog::note("The overlap cells are not assembled, ParOverILU0 "
+                             "uses the interior rows and the ghost values only.");
+            }
+
+            subdomainPreconditioner_ = hasSubdomainPreconditioner(prm_);
+
+            if (parameters_.linear_solver_auto_tune_) {
+                autoTuner_ = std::make_unique<LinearSolverAutoTuner>(prm_,
+                                                                     parameters_.linear_solver_auto_tune_solves_,
+                                                                     parameters_.linear_solver_auto_tune_interval_);
+            }
+
             // Print parameters to PRT/DBG logs.
             if (on_io_rank) {
                 std::ostringstream os;
@@ -190,6 +257,7 @@ namespace Opm
 
         void prepare(const SparseMatrixAdapter& M, Vector& b)
         {
+            OPM_TRACE_SCOPE("linear solver prepare");
             static bool firstcall = true;
 #if HAVE_MPI
             if (firstcall && parallelInformation_.type() == typeid(ParallelISTLInformation)) {
@@ -216,10 +284,28 @@ namespace Opm
             }
             rhs_ = &b;
 
-            if (isParallel() && prm_.get<std::string>("preconditioner.type") != "ParOverILU0") {
+            if (isParallel() && (!linearizeNonLocalElements
+                                 || prm_.get<std::string>("preconditioner.type") != "ParOverILU0")) {
                 makeOverlapRowsInvalid(getMatrix());
             }
-            prepareFlexibleSolver();
+            // The subdomains of the subdomain_direct preconditioner are grown
+            // from the perforated cells, the solver is set up again when the
+            // open wells change.
+            if (subdomainPreconditioner_) {
+                auto wellCells = simulator_.problem().wellModel().localWellCells();
+                if (wellCells != subdomainSeeds_) {
+                    subdomainSeeds_ = std::move(wellCells);
+                    flexibleSolver_.reset();
+                }
+            }
+            // With an accelerator the CPU solver is set up while the accelerator
+            // solves, such that a fallback to it starts warm.
+            flexibleSetupPending_ = concurrentFallbackSetup();
+            if (!flexibleSetupPending_) {
+                Dune::Timer setupTimer;
+                prepareFlexibleSolver();
+                setupTime_ = setupTimer.elapsed();
+            }
             firstcall = false;
         }
 
@@ -237,19 +323,30 @@ namespace Opm
         }
 
         bool solve(Vector& x) {
+            OPM_TRACE_SCOPE("linear solver apply");
             // Write linear system if asked for.
             const int verbosity = prm_.get<int>("verbosity", 0);
             const bool write_matrix = verbosity > 10;
             if (write_matrix) {
-                Helper::writeSystem(simulator_, //simulator is only used to get names
-                                    getMatrix(),
-                                    *rhs_,
-                                    comm_.get());
+                if (parameters_.linear_solver_dump_format_ == "binary") {
+                    Helper::writeSystemBinary(simulator_,
+                                              getMatrix(),
+                                              *rhs_,
+                                              !useWellConn_,
+                                              comm_.get());
+                } else {
+                    Helper::writeSystem(simulator_, //simulator is only used to get names
+                                        getMatrix(),
+                                        *rhs_,
+                                        comm_.get());
+                }
             }
 
             // Solve system.
             Dune::InverseOperatorResult result;
             bool accelerator_was_used = false;
+            // the residual reduction of the accelerator's iterate the fallback starts from
+            double warmStartReduction = 1.0;
 
             // Use GPU if: available, chosen by user, and successful.
             // Use FPGA if: support compiled, chosen by user, and successful.
@@ -260,18 +357,44 @@ namespace Opm
                 const std::string accelerator_mode = EWOMS_GET_PARAM(TypeTag, std::string, AcceleratorMode);
                 WellContributions wellContribs(accelerator_mode);
                 bdaBridge->initWellContributions(wellContribs);
+#if HAVE_MPI
+                if (isParallel() && !bdaCommunicationSet_) {
+                    bdaBridge->setCommunication(createBdaCommunication());
+                    bdaCommunicationSet_ = true;
+                }
+#endif
 
                 if (!useWellConn_) {
                     simulator_.problem().wellModel().getWellContributions(wellContribs);
                 }
 
+                // The CPU solver is set up on another thread once the accelerator
+                // has made its changes to the matrix, which is only read from then on.
+                std::future<void> fallbackSetup;
+                std::function<void()> startFallbackSetup;
+                if (flexibleSetupPending_) {
+                    startFallbackSetup = [this, &fallbackSetup]() {
+                        fallbackSetup = std::async(std::launch::async, [this]() {
+                            Dune::Timer setupTimer;
+                            prepareFlexibleSolver();
+                            setupTime_ = setupTimer.elapsed();
+                        });
+                    };
+                }
+
                 // Const_cast needed since the CUDA stuff overwrites values for better matrix condition..
-                bdaBridge->solve_system(const_cast<Matrix*>(&getMatrix()), *rhs_, wellContribs, result);
+                bdaBridge->solve_system(const_cast<Matrix*>(&getMatrix()), *rhs_, wellContribs, result, startFallbackSetup);
+                finishFallbackSetup(fallbackSetup);
                 if (result.converged) {
                     // get result vector x from non-Dune backend, iff solve was successful
                     bdaBridge->get_result(x);
                     accelerator_was_used = true;
                 } else {
+                    // start from the iterate of the accelerator if it reduced the residual
+                    if (result.iterations > 0 && result.reduction > 0.0 && result.reduction < 1.0) {
+                        bdaBridge->get_result(x);
+                        warmStartReduction = result.reduction;
+                    }
                     // warn about CPU fallback
                     // BdaBridge might have disabled its BdaSolver for this simulation due to some error
                     // in that case the BdaBridge is disabled and flexibleSolver is always used
@@ -286,7 +409,54 @@ namespace Opm
             // Otherwise, use flexible istl solver.
             if (!accelerator_was_used) {
                 assert(flexibleSolver_);
-                flexibleSolver_->apply(x, *rhs_, result);
+                Dune::Timer applyTimer;
+                if (warmStartReduction < 1.0) {
+                    // only the rest of the reduction is left to the CPU solver
+                    const double reduction = parameters_.linear_solver_adaptive_reduction_
+                        ? adaptiveReduction()
+                        : prm_.get<double>("tol", parameters_.linear_solver_reduction_);
+                    flexibleSolver_->apply(x, *rhs_, std::min(1.0, reduction / warmStartReduction), result);
+                } else if (parameters_.linear_solver_adaptive_reduction_) {
+                    flexibleSolver_->apply(x, *rhs_, adaptiveReduction(), result);
+                } else {
+                    flexibleSolver_->apply(x, *rhs_, result);
+                }
+#if HAVE_MPI
+                // Solvers that update x with a preconditioned vector that has
+                // not been through the operator leave its ghost entries stale.
+                if (overlapHaloExchange_) {
+                    if (deferSolutionExchange_) {
+                        if (!solutionExchange_) {
+                            solutionExchange_ = std::make_unique<HaloExchange<Vector, CommunicationType>>(*comm_, /*tag=*/3469);
+                        }
+                        solutionExchange_->start(x);
+                    } else {
+                        comm_->copyOwnerToAll(x, x);
+                    }
+                }
+#endif
+                // Remember the iteration count achieved with a freshly set up
+                // preconditioner, it is the reference for deciding when a
+                // reused preconditioner has become too stale.
+                if (!result.converged) {
+                    iterationsAfterSetup_ = -1;
+                    iterationsAfterRebuild_ = -1;
+                    // A solve which gave up before spending its iterations, on
+                    // stagnation or divergence, gets a rebuilt preconditioner for
+                    // the retried step whatever the reuse policy.
+                    rebuildAfterAbort_ = result.iterations
+                        < prm_.get<int>("maxiter", parameters_.linear_solver_maxiter_);
+                } else {
+                    if (preconditionerIsFresh_) {
+                        iterationsAfterSetup_ = result.iterations;
+                    }
+                    if (solverIsFresh_) {
+                        iterationsAfterRebuild_ = result.iterations;
+                    }
+                }
+                if (autoTuner_) {
+                    recordAutoTuning(setupTime_ + applyTimer.elapsed(), result.converged);
+                }
             }
 
             // Check convergence, iterations etc.
@@ -305,9 +475,34 @@ namespace Opm
         /// \copydoc NewtonIterationBlackoilInterface::iterations
         int iterations () const { return iterations_; }
 
+        /// Let solve() only start the exchange of the ghost entries of the solution if
+        /// they have to be made consistent, such that the caller can do work which only
+        /// needs the owner entries until finishSolutionExchange().
+        void setDeferSolutionExchange(const bool defer) { deferSolutionExchange_ = defer; }
+
+        /// Wait for the ghost entries of the solution x of the last solve(), if
+        /// their exchange was deferred.
+        void finishSolutionExchange([[maybe_unused]] Vector& x)
+        {
+#if HAVE_MPI
+            if (solutionExchange_) {
+                solutionExchange_->finish(x);
+            }
+#endif
+        }
+
         /// \copydoc NewtonIterationBlackoilInterface::parallelInformation
         const std::any& parallelInformation() const { return parallelInformation_; }
 
+        /// Add the bytes of the preconditioner and of the matrices owned by the
+        /// solver to the report.
+        void memoryUsage(MemoryReport& report) const
+        {
+            report.add("Preconditioner", flexibleSolver_ ? flexibleSolver_->preconditioner().memoryUsage() : 0);
+            report.add("Linear solver matrices", wellPreconditionerMatrix_ ? matrixMemoryUsage(*wellPreconditionerMatrix_) : 0);
+            report.add("Linear solver matrices", floatOperator_ ? floatOperator_->memoryUsage() : 0);
+        }
+
     protected:
         // 3x3 matrix block inversion was unstable at least 2.3 until and including
         // 2.5.0. There may still be some issue with the 4x4 matrix block inversion
@@ -346,52 +541,199 @@ namespace Opm
 #endif
         }
 
+#if (HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA) && HAVE_MPI
+        /// Wrap the owner-overlap-copy communication of the linear system for the openclSolver
+        std::shared_ptr<bda::BdaCommunication> createBdaCommunication() const
+        {
+            auto bdaComm = std::make_shared<bda::BdaCommunication>();
+            const std::size_t size = getMatrix().N();
+
+            Vector mask(size);
+            mask = 1.0;
+            comm_->project(mask);
+            bdaComm->ownerMask.assign(&mask[0][0], &mask[0][0] + size * block_size);
+
+            auto comm = comm_;
+            auto halo = std::make_shared<Vector>(size);
+            bdaComm->copyOwnerToAll = [comm, halo, size](double* x) {
+                std::copy(x, x + size * block_size, &(*halo)[0][0]);
+                comm->copyOwnerToAll(*halo, *halo);
+                std::copy(&(*halo)[0][0], &(*halo)[0][0] + size * block_size, x);
+            };
+            bdaComm->sum = [comm](double v) { return comm->communicator().sum(v); };
+            bdaComm->min = [comm](double v) { return comm->communicator().min(v); };
+            return bdaComm;
+        }
+#endif
+
+        /// Record the time to solution of the last solve with the auto-tuner,
+        /// and set up the solver again on the next prepare() if it chose another
+        /// configuration. The maximum time over the processes is used such that
+        /// all processes make the same choice.
+        void recordAutoTuning(double seconds, const bool converged)
+        {
+            if (isParallel()) {
+                seconds = comm_->communicator().max(seconds);
+            }
+            const bool wasTuning = autoTuner_->tuning();
+            if (autoTuner_->record(seconds, converged)) {
+                prm_ = autoTuner_->configuration();
+                flexibleSolver_.reset();
+            }
+            if (simulator_.gridView().comm().rank() == 0) {
+                if (wasTuning && !autoTuner_->tuning()) {
+                    OpmLog::info(autoTuner_->summary());
+                } else if (!wasTuning && autoTuner_->tuning()) {
+                    OpmLog::info("Linear solver auto-tuning: trying the variants again");
+                }
+            }
+        }
+
+        /// Whether the CPU solver is set up during the accelerator solve instead of
+        /// in prepare(). Only in serial runs, as the setup of the parallel
+        /// preconditioners communicates.
+        bool concurrentFallbackSetup()
+        {
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
+            return !isParallel() && !autoTuner_ && (bdaBridge->getUseGpu() || bdaBridge->getUseFpga());
+#else
+            return false;
+#endif
+        }
+
+        /// Wait for the setup of the CPU solver started during the accelerator solve,
+        /// or do it now if the accelerator skipped the solve.
+        void finishFallbackSetup(std::future<void>& fallbackSetup)
+        {
+            if (fallbackSetup.valid()) {
+                fallbackSetup.get();
+            } else if (flexibleSetupPending_) {
+                Dune::Timer setupTimer;
+                prepareFlexibleSolver();
+                setupTime_ = setupTimer.elapsed();
+            }
+            flexibleSetupPending_ = false;
+        }
+
         void prepareFlexibleSolver()
         {
+            OPM_TRACE_SCOPE("linear solver setup");
 
             std::function<Vector()> weightsCalculator = getWeightsCalculator();
 
             if (shouldCreateSolver()) {
+                floatOperator_ = nullptr;
+                if (wellAwarePreconditioner_) {
+                    updateWellPreconditionerMatrix();
+                }
+                if (subdomainPreconditioner_) {
+                    setSubdomainSeeds(prm_, subdomainSeeds_);
+                }
                 if (isParallel()) {
 #if HAVE_MPI
                     if (useWellConn_) {
                         using ParOperatorType = Dune::OverlappingSchwarzOperator<Matrix, Vector, Vector, Comm>;
                         linearOperatorForFlexibleSolver_ = std::make_unique<ParOperatorType>(getMatrix(), *comm_);
                         flexibleSolver_ = std::make_unique<FlexibleSolverType>(*linearOperatorForFlexibleSolver_, *comm_, prm_, weightsCalculator);
+                    } else if (overlapHaloExchange_) {
+                        using ParOperatorType = WellModelGhostLastOverlappedMatrixAdapter<Matrix, Vector, Vector, true>;
+                        wellOperator_ = std::make_unique<WellModelOperator>(simulator_.problem().wellModel());
+                        if (wellAwarePreconditioner_) {
+                            linearOperatorForFlexibleSolver_ = std::make_unique<WellModelPreconditionerMatrixAdapter<ParOperatorType>>(
+                                *wellPreconditionerMatrix_, getMatrix(), *wellOperator_, interiorCellNum_, *comm_);
+                        } else {
+                            linearOperatorForFlexibleSolver_ = std::make_unique<ParOperatorType>(getMatrix(), *wellOperator_, interiorCellNum_, *comm_);
+                        }
+                        flexibleSolver_ = std::make_unique<FlexibleSolverType>(*linearOperatorForFlexibleSolver_, *comm_, prm_, weightsCalculator);
                     } else {
                         using ParOperatorType = WellModelGhostLastMatrixAdapter<Matrix, Vector, Vector, true>;
                         wellOperator_ = std::make_unique<WellModelOperator>(simulator_.problem().wellModel());
-                        linearOperatorForFlexibleSolver_ = std::make_unique<ParOperatorType>(getMatrix(), *wellOperator_, interiorCellNum_);
+                        if (wellAwarePreconditioner_) {
+                            linearOperatorForFlexibleSolver_ = std::make_unique<WellModelPreconditionerMatrixAdapter<ParOperatorType>>(
+                                *wellPreconditionerMatrix_, getMatrix(), *wellOperator_, interiorCellNum_);
+                        } else {
+                            linearOperatorForFlexibleSolver_ = std::make_unique<ParOperatorType>(getMatrix(), *wellOperator_, interiorCellNum_);
+                        }
                         flexibleSolver_ = std::make_unique<FlexibleSolverType>(*linearOperatorForFlexibleSolver_, *comm_, prm_, weightsCalculator);
                     }
 #endif
                 } else {
-                    if (useWellConn_) {
+                    if (useWellConn_ && floatMatrix_) {
+                        auto op = std::make_unique<FloatMatrixAdapter<Matrix, Vector, Vector>>(getMatrix());
+                        floatOperator_ = op.get();
+                        linearOperatorForFlexibleSolver_ = std::move(op);
+                        flexibleSolver_ = std::make_unique<FlexibleSolverType>(*linearOperatorForFlexibleSolver_, prm_, weightsCalculator);
+                    } else if (useWellConn_) {
                         using SeqOperatorType = Dune::MatrixAdapter<Matrix, Vector, Vector>;
                         linearOperatorForFlexibleSolver_ = std::make_unique<SeqOperatorType>(getMatrix());
                         flexibleSolver_ = std::make_unique<FlexibleSolverType>(*linearOperatorForFlexibleSolver_, prm_, weightsCalculator);
                     } else {
                         using SeqOperatorType = WellModelMatrixAdapter<Matrix, Vector, Vector, false>;
                         wellOperator_ = std::make_unique<WellModelOperator>(simulator_.problem().wellModel());
-                        linearOperatorForFlexibleSolver_ = std::make_unique<SeqOperatorType>(getMatrix(), *wellOperator_);
+                        if (wellAwarePreconditioner_) {
+                            linearOperatorForFlexibleSolver_ = std::make_unique<WellModelPreconditionerMatrixAdapter<SeqOperatorType>>(
+                                *wellPreconditionerMatrix_, getMatrix(), *wellOperator_);
+                        } else {
+                            linearOperatorForFlexibleSolver_ = std::make_unique<SeqOperatorType>(getMatrix(), *wellOperator_);
+                        }
                         flexibleSolver_ = std::make_unique<FlexibleSolverType>(*linearOperatorForFlexibleSolver_, prm_, weightsCalculator);
                     }
                 }
+                preconditionerIsFresh_ = true;
+                solverIsFresh_ = true;
+                updatesSinceRebuild_ = 0;
+                rebuildAfterAbort_ = false;
             }
-            else
+            else if (shouldUpdatePreconditioner())
             {
+                if (floatOperator_) {
+                    floatOperator_->update();
+                }
+                if (wellAwarePreconditioner_) {
+                    updateWellPreconditionerMatrix();
+                }
+                // The AMG of the amg and cpr preconditioners keeps its aggregates
+                // and its coarse sparsity on update, only the Galerkin products
+                // are recomputed.
                 flexibleSolver_->preconditioner().update();
+                preconditionerIsFresh_ = true;
+                solverIsFresh_ = false;
+                ++updatesSinceRebuild_;
+            }
+            else
+            {
+                if (floatOperator_) {
+                    floatOperator_->update();
+                }
+                preconditionerIsFresh_ = false;
+                solverIsFresh_ = false;
             }
         }
 
 
+        /// Copy the current matrix into the matrix the preconditioner is set up
+        /// from, and add the well contributions on its sparsity pattern. The
+        /// couplings between perforated cells which are not neighbours are
+        /// dropped, so neither the pattern of the Jacobian nor the operator
+        /// changes, only the preconditioner sees the wells.
+        void updateWellPreconditionerMatrix()
+        {
+            if (!wellPreconditionerMatrix_) {
+                wellPreconditionerMatrix_ = std::make_unique<Matrix>(getMatrix());
+            } else {
+                *wellPreconditionerMatrix_ = getMatrix();
+            }
+            simulator_.problem().wellModel().addWellContributionsInPattern(*wellPreconditionerMatrix_);
+        }
+
+
         /// Return true if we should (re)create the whole solver,
         /// instead of just calling update() on the preconditioner.
         bool shouldCreateSolver() const
         {
             // Decide if we should recreate the solver or just do
             // a minimal preconditioner update.
-            if (!flexibleSolver_) {
+            if (!flexibleSolver_ || rebuildAfterAbort_) {
                 return true;
             }
             if (this->parameters_.cpr_reuse_setup_ == 0) {
@@ -407,14 +749,94 @@ namespace Opm
                 // Recreate solver if the last solve used more than 10 iterations.
                 return this->iterations() > 10;
             }
+            if (this->parameters_.cpr_reuse_setup_ == 5) {
+                // Recreate solver, and with it the AMG aggregates, if the last
+                // solve failed, after a number of value-only updates, or if the
+                // linear iterations have grown too much since the last rebuild.
+                if (iterationsAfterRebuild_ < 0) {
+                    return true;
+                }
+                const int interval = this->parameters_.cpr_rebuild_interval_;
+                if (interval > 0 && updatesSinceRebuild_ >= interval) {
+                    return true;
+                }
+                const double threshold = this->parameters_.cpr_reuse_iteration_factor_
+                    * std::max(iterationsAfterRebuild_, 1);
+                return this->iterations() > threshold;
+            }
 
             // Otherwise, do not recreate solver.
-            assert(this->parameters_.cpr_reuse_setup_ == 3);
+            assert(this->parameters_.cpr_reuse_setup_ == 3 ||
+                   this->parameters_.cpr_reuse_setup_ == 4);
 
             return false;
         }
 
 
+        /// Return true if the preconditioner of an existing solver
+        /// should be updated for the current matrix, false if it
+        /// may be reused as it is.
+        bool shouldUpdatePreconditioner() const
+        {
+            if (this->parameters_.cpr_reuse_setup_ != 4) {
+                return true;
+            }
+            // Update if the last solve failed or if there was no solve
+            // since the last update.
+            if (iterationsAfterSetup_ < 0) {
+                return true;
+            }
+            // Update if the linear iterations have grown too much compared
+            // to the first solve after the last update.
+            const double threshold = this->parameters_.cpr_reuse_iteration_factor_
+                * std::max(iterationsAfterSetup_, 1);
+            return this->iterations() > threshold;
+        }
+
+
+        /// The linear solver reduction for the current Newton iteration,
+        /// chosen from the reduction of the nonlinear residual as in
+        /// Eisenstat and Walker's second choice of the forcing term,
+        /// eta_k = 0.9 * (|r_k| / |r_{k-1}|)^2, with their safeguard
+        /// against decreasing it too fast. If the Newton iteration
+        /// stagnates the tight reduction is required instead.
+        /// Must be called before the right hand side is modified by the solve.
+        double adaptiveReduction()
+        {
+            const double tight = prm_.get<double>("tol", parameters_.linear_solver_reduction_);
+            const double loose = std::max(parameters_.linear_solver_max_reduction_, tight);
+            double norm = 0.0;
+#if HAVE_MPI
+            if (isParallel()) {
+                norm = comm_->norm(*rhs_);
+            } else
+#endif
+            {
+                norm = rhs_->two_norm();
+            }
+
+            const int newton_iteration = simulator_.model().newtonMethod().numIterations();
+            double eta = loose;
+            if (newton_iteration > 0 && lastResidualNorm_ > 0.0) {
+                const double gamma = 0.9;
+                const double ratio = norm / lastResidualNorm_;
+                eta = gamma * ratio * ratio;
+                const double safeguard = gamma * lastReduction_ * lastReduction_;
+                if (safeguard > 0.1) {
+                    eta = std::max(eta, safeguard);
+                }
+                if (ratio > gamma) {
+                    // stagnation, a loose solve will not help
+                    eta = tight;
+                }
+                eta = std::clamp(eta, tight, loose);
+            }
+            lastResidualNorm_ = norm;
+            lastReduction_ = eta;
+            return eta;
+        }
+
+
         /// Return an appropriate weight function if a cpr preconditioner is asked for.
         std::function<Vector()> getWeightsCalculator() const
         {
@@ -450,10 +872,7 @@ namespace Opm
         Vector getTrueImpesWeights(int pressureVarIndex) const
         {
             Vector weights(rhs_->size());
-            ElementContext elemCtx(simulator_);
-            Amg::getTrueImpesWeights(pressureVarIndex, weights, simulator_.vanguard().gridView(),
-                                     elemCtx, simulator_.model(),
-                                     ThreadManager::threadId());
+            Amg::getTrueImpesWeights<ElementContext, ThreadManager>(pressureVarIndex, weights, simulator_);
             return weights;
         }
 
@@ -509,6 +928,43 @@ namespace Opm
 
         bool useWellConn_;
         size_t interiorCellNum_;
+        bool overlapHaloExchange_ = false;
+        bool deferSolutionExchange_ = false;
+#if HAVE_MPI
+        std::unique_ptr<HaloExchange<Vector, CommunicationType>> solutionExchange_;
+#endif
+        bool wellAwarePreconditioner_ = false;
+        // the operator of --linear-solver-float-matrix, owned by linearOperatorForFlexibleSolver_
+        bool floatMatrix_ = false;
+        FloatMatrixAdapter<Matrix, Vector, Vector>* floatOperator_ = nullptr;
+        // copy of the matrix with the well contributions, for the preconditioner only
+        std::unique_ptr<Matrix> wellPreconditionerMatrix_;
+        bool bdaCommunicationSet_ = false;
+
+        // The perforated cells of the open wells, the seeds of the subdomain_direct preconditioner.
+        bool subdomainPreconditioner_ = false;
+        std::vector<std::vector<int>> subdomainSeeds_;
+
+        // Choice of the solver configuration on the run (--linear-solver-auto-tune).
+        std::unique_ptr<LinearSolverAutoTuner> autoTuner_;
+        double setupTime_ = 0.0;
+        // The CPU solver is set up during the next accelerator solve.
+        bool flexibleSetupPending_ = false;
+
+        // State of the preconditioner reuse policy (--cpr-reuse-setup=4).
+        bool preconditionerIsFresh_ = true;
+        int iterationsAfterSetup_ = -1;
+
+        // State of the value-only update policy (--cpr-reuse-setup=5).
+        bool solverIsFresh_ = true;
+        int iterationsAfterRebuild_ = -1;
+        int updatesSinceRebuild_ = 0;
+        // The last solve stopped early (--linear-solver-stagnation-iterations).
+        bool rebuildAfterAbort_ = false;
+
+        // State of the adaptive linear reduction (--linear-solver-adaptive-reduction).
+        double lastResidualNorm_ = 0.0;
+        double lastReduction_ = 0.0;
 
         FlowLinearSolverParameters parameters_;
         boost::property_tree::ptree prm_;
@@ -217,6 +217,15 @@ public:
         return res_.iterations;
     }
 
+    // The solution of this solver is always consistent, there is no exchange to defer.
+    void setDeferSolutionExchange(const bool /* defer */)
+    {
+    }
+
+    void finishSolutionExchange(VectorType& /* x */)
+    {
+    }
+
     void setResidual(VectorType& /* b */)
     {
         // rhs_ = &b; // Must be handled in prepare() instead.
@@ -252,9 +261,12 @@ protected:
                 recreate_solver = true;
             }
         } else {
-            assert(this->parameters_.cpr_reuse_setup_ == 3);
+            assert(this->parameters_.cpr_reuse_setup_ == 3 ||
+                   this->parameters_.cpr_reuse_setup_ == 4 ||
+                   this->parameters_.cpr_reuse_setup_ == 5);
             assert(recreate_solver == false);
-            // Never recreate solver.
+            // Never recreate solver. The iteration based reuse policies (4, 5)
+            // are only implemented by ISTLSolverEbos, here they behave as 3.
         }
         return recreate_solver;
     }
@@ -311,10 +323,7 @@ protected:
     VectorType getTrueImpesWeights(const VectorType& b, const int pressureVarIndex) const
     {
         VectorType weights(b.size());
-        ElementContext elemCtx(simulator_);
-        Opm::Amg::getTrueImpesWeights(pressureVarIndex, weights, simulator_.vanguard().gridView(),
-                                      elemCtx, simulator_.model(),
-                                      ThreadManager::threadId());
+        Opm::Amg::getTrueImpesWeights<ElementContext, ThreadManager>(pressureVarIndex, weights, simulator_);
         return weights;
     }
 
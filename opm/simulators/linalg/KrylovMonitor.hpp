@@ -0,0 +1,102 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_KRYLOV_MONITOR_HEADER_INCLUDED
+#define OPM_KRYLOV_MONITOR_HEADER_INCLUDED
+
+#include <cmath>
+
+namespace Dune
+{
+
+/// Watches the residual norms of a Krylov iteration and tells it to give up
+/// early if it is going nowhere, instead of spending the whole iteration
+/// budget on a system that will not converge.
+///
+/// The iteration has stagnated if the residual has not dropped below
+/// progress times the best residual so far within the last window
+/// iterations, and has diverged if the residual has grown beyond
+/// divergence times the initial residual or is not finite. A window or a
+/// divergence factor of zero switches the respective check off, such that
+/// a default constructed monitor never stops an iteration.
+class KrylovMonitor
+{
+public:
+    enum class Status { Continue, Stagnated, Diverged };
+
+    KrylovMonitor() = default;
+
+    KrylovMonitor(const int window, const double progress, const double divergence)
+        : window_(window)
+        , progress_(progress)
+        , divergence_(divergence)
+    {
+    }
+
+    /// Start watching an iteration with the initial residual norm def0.
+    void start(const double def0)
+    {
+        def0_ = def0;
+        best_ = def0;
+        bestIteration_ = 0;
+    }
+
+    /// The status after iteration it with the residual norm def.
+    Status check(const int it, const double def)
+    {
+        if (!std::isfinite(def) || (divergence_ > 0.0 && def > divergence_ * def0_)) {
+            return Status::Diverged;
+        }
+        if (def < progress_ * best_) {
+            best_ = def;
+            bestIteration_ = it;
+        }
+        if (window_ > 0 && it - bestIteration_ >= window_) {
+            return Status::Stagnated;
+        }
+        return Status::Continue;
+    }
+
+    bool active() const
+    { return window_ > 0 || divergence_ > 0.0; }
+
+    static const char* name(const Status status)
+    {
+        switch (status) {
+        case Status::Stagnated:
+            return "stagnated";
+        case Status::Diverged:
+            return "diverged";
+        default:
+            return "running";
+        }
+    }
+
+private:
+    int window_ = 0;
+    double progress_ = 1.0;
+    double divergence_ = 0.0;
+    double def0_ = 0.0;
+    double best_ = 0.0;
+    int bestIteration_ = 0;
+};
+
+} // namespace Dune
+
+#endif // OPM_KRYLOV_MONITOR_HEADER_INCLUDED
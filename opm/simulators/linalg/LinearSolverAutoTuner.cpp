@@ -0,0 +1,163 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/linalg/LinearSolverAutoTuner.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace Opm
+{
+
+LinearSolverAutoTuner::LinearSolverAutoTuner(const PropertyTree& base,
+                                             const int trialSolves,
+                                             const int retuneInterval)
+    : trialSolves_(std::max(trialSolves, 1))
+    , retuneInterval_(std::max(retuneInterval, 0))
+{
+    for (auto& variant : variants(base)) {
+        Candidate candidate;
+        candidate.name = std::move(variant.first);
+        candidate.prm = std::move(variant.second);
+        candidates_.push_back(std::move(candidate));
+    }
+    tuning_ = candidates_.size() > 1;
+}
+
+std::vector<std::pair<std::string, LinearSolverAutoTuner::PropertyTree>>
+LinearSolverAutoTuner::variants(const PropertyTree& base)
+{
+    std::vector<std::pair<std::string, PropertyTree>> result;
+    result.emplace_back("configured", base);
+    auto add = [&base, &result](const std::string& name, const std::function<void(PropertyTree&)>& change)
+    {
+        PropertyTree prm = base;
+        change(prm);
+        result.emplace_back(name, std::move(prm));
+    };
+
+    // the ILU variants of a ParOverILU0 or ILU0 preconditioner or smoother at prefix
+    auto iluVariants = [&base, &add](const std::string& prefix, const std::string& what)
+    {
+        const std::string type = base.get<std::string>(prefix + "type", "");
+        if (type != "ParOverILU0" && type != "ILU0") {
+            return;
+        }
+        if (base.get<int>(prefix + "ilulevel", 0) == 0) {
+            add(what + " ILU(1)", [&prefix](PropertyTree& prm) {
+                prm.put(prefix + "ilulevel", 1);
+            });
+        }
+        if (!base.get<bool>(prefix + "redblack", false)) {
+            add(what + " red-black ordering", [&prefix](PropertyTree& prm) {
+                prm.put(prefix + "redblack", true);
+                prm.put(prefix + "reorder_spheres", true);
+            });
+        }
+    };
+
+    // the coarsening variants of an AMG at prefix
+    auto amgVariants = [&base, &add](const std::string& prefix, const std::string& what)
+    {
+        const int target = base.get<int>(prefix + "coarsenTarget", 1200);
+        add(fmt::format("{} coarsening target {}", what, 4 * target), [&prefix, target](PropertyTree& prm) {
+            prm.put(prefix + "coarsenTarget", 4 * target);
+        });
+        add(what + " aggregates up to 8 cells", [&prefix](PropertyTree& prm) {
+            prm.put(prefix + "maxaggsize", 8);
+            prm.put(prefix + "minaggsize", 6);
+        });
+    };
+
+    const std::string type = base.get<std::string>("preconditioner.type", "");
+    if (type == "cpr" || type == "cprt") {
+        iluVariants("preconditioner.finesmoother.", "CPR smoother");
+        if (base.get<std::string>("preconditioner.coarsesolver.preconditioner.type", "") == "amg") {
+            amgVariants("preconditioner.coarsesolver.preconditioner.", "CPR pressure AMG");
+        }
+    } else if (type == "amg") {
+        amgVariants("preconditioner.", "AMG");
+    } else {
+        iluVariants("preconditioner.", "Preconditioner");
+    }
+    return result;
+}
+
+bool LinearSolverAutoTuner::record(const double seconds, const bool converged)
+{
+    if (!tuning_) {
+        if (retuneInterval_ == 0 || ++solvesSinceTuning_ < retuneInterval_) {
+            return false;
+        }
+        // try all candidates again
+        for (auto& candidate : candidates_) {
+            candidate.seconds = 0.0;
+            candidate.solves = 0;
+            candidate.failed = false;
+        }
+        tuning_ = true;
+        const bool changed = current_ != 0;
+        current_ = 0;
+        return changed;
+    }
+
+    auto& candidate = candidates_[current_];
+    candidate.seconds += seconds;
+    ++candidate.solves;
+    candidate.failed = candidate.failed || !converged;
+    if (candidate.solves < trialSolves_ && !candidate.failed) {
+        return false;
+    }
+    if (current_ + 1 < candidates_.size()) {
+        ++current_;
+        return true;
+    }
+
+    // all candidates are tried, keep the fastest one which converged, or the
+    // configured one if all failed
+    std::size_t best = 0;
+    for (std::size_t i = 0; i < candidates_.size(); ++i) {
+        const auto& c = candidates_[i];
+        if (!c.failed && (candidates_[best].failed || c.meanSeconds() < candidates_[best].meanSeconds())) {
+            best = i;
+        }
+    }
+    tuning_ = false;
+    solvesSinceTuning_ = 0;
+    const bool changed = best != current_;
+    current_ = best;
+    return changed;
+}
+
+std::string LinearSolverAutoTuner::summary() const
+{
+    std::string result = "Linear solver auto-tuning, mean time per linear solve:\n";
+    for (std::size_t i = 0; i < candidates_.size(); ++i) {
+        const auto& c = candidates_[i];
+        result += fmt::format("  {:<44} {:>10}{}\n", c.name,
+                              c.failed ? "failed" : fmt::format("{:.4f} s", c.meanSeconds()),
+                              i == current_ && !tuning_ ? "  <- chosen" : "");
+    }
+    return result;
+}
+
+} // namespace Opm
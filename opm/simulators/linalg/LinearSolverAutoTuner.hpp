@@ -0,0 +1,103 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LINEARSOLVERAUTOTUNER_HEADER_INCLUDED
+#define OPM_LINEARSOLVERAUTOTUNER_HEADER_INCLUDED
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// Chooses the fastest of a few variants of the linear solver configuration
+/// on the systems of the run itself. Each candidate is used for a number of
+/// linear solves in turn, and the one with the smallest mean time to solution,
+/// setup included, is kept. After a number of solves the candidates are tried
+/// again, since other phases of a run may favour other settings.
+///
+/// A candidate which fails to converge is not chosen. The times must be the
+/// same on all processes, e.g. the maximum over the processes, such that all
+/// make the same choice.
+class LinearSolverAutoTuner
+{
+public:
+    using PropertyTree = boost::property_tree::ptree;
+
+    struct Candidate
+    {
+        std::string name;
+        PropertyTree prm;
+        double seconds = 0.0;
+        int solves = 0;
+        bool failed = false;
+
+        double meanSeconds() const
+        { return solves > 0 ? seconds / solves : 0.0; }
+    };
+
+    /// \param base            the configured solver, the first candidate
+    /// \param trialSolves     the number of linear solves with each candidate
+    /// \param retuneInterval  the number of solves after which the candidates
+    ///                        are tried again, 0 to keep the choice
+    LinearSolverAutoTuner(const PropertyTree& base, int trialSolves, int retuneInterval);
+
+    /// The variants of the configuration which are tried: the fill-in level
+    /// and the ordering of the ILU smoother and the coarsening of the AMG,
+    /// depending on the type of the preconditioner. The first is the
+    /// configuration itself.
+    static std::vector<std::pair<std::string, PropertyTree>> variants(const PropertyTree& base);
+
+    const PropertyTree& configuration() const
+    { return candidates_[current_].prm; }
+
+    const std::string& name() const
+    { return candidates_[current_].name; }
+
+    /// True while the candidates are being tried.
+    bool tuning() const
+    { return tuning_; }
+
+    const std::vector<Candidate>& candidates() const
+    { return candidates_; }
+
+    /// Record the time to solution of a linear solve with the current
+    /// configuration. Returns true if the configuration changed, the solver
+    /// must then be set up again from configuration().
+    bool record(double seconds, bool converged);
+
+    /// The mean times of the candidates of the last tuning.
+    std::string summary() const;
+
+private:
+    std::vector<Candidate> candidates_;
+    std::size_t current_ = 0;
+    bool tuning_ = true;
+    int trialSolves_;
+    int retuneInterval_;
+    int solvesSinceTuning_ = 0;
+};
+
+} // namespace Opm
+
+#endif // OPM_LINEARSOLVERAUTOTUNER_HEADER_INCLUDED
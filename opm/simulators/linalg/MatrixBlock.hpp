@@ -28,6 +28,10 @@
 #include <dune/istl/umfpack.hh>
 #include <dune/istl/superlu.hh>
 
+#include <opm/simulators/linalg/SmallBlockKernels.hpp>
+
+#include <type_traits>
+
 namespace Dune
 {
 namespace FMatrixHelp {
@@ -320,6 +324,12 @@ static inline void invertMatrix(FieldMatrix<K,2,2>& matrix)
 template <typename K>
 static inline void invertMatrix(FieldMatrix<K,3,3>& matrix)
 {
+#if OPM_HAVE_SIMD_BLOCK_KERNELS
+    if constexpr (std::is_same_v<K, double>) {
+        if (Opm::Detail::Simd::invert<3>(&matrix[0][0], &matrix[0][0]))
+            return;
+    }
+#endif
     FieldMatrix<K,3,3> A ( matrix );
     FMatrixHelp::invertMatrix(A, matrix );
 }
@@ -328,6 +338,13 @@ static inline void invertMatrix(FieldMatrix<K,3,3>& matrix)
 template <typename K>
 static inline void invertMatrix(FieldMatrix<K,4,4>& matrix)
 {
+#if OPM_HAVE_SIMD_BLOCK_KERNELS
+    // a zero pivot falls back to FMatrixHelp, which handles singular matrices
+    if constexpr (std::is_same_v<K, double>) {
+        if (Opm::Detail::Simd::invert<4>(&matrix[0][0], &matrix[0][0]))
+            return;
+    }
+#endif
     FieldMatrix<K,4,4> A ( matrix );
     FMatrixHelp::invertMatrix(A, matrix );
 }
@@ -342,6 +359,25 @@ static inline void invertMatrix(FieldMatrix<K,n,n>& matrix)
     matrix.invert();
 }
 
+//! invert an n x n dynamic matrix with the closed form of the fixed size one,
+//! returns false without changing it if it is (nearly) singular
+template <int n, typename K>
+static inline bool invertDynamicMatrixClosedForm(Dune::DynamicMatrix<K>& matrix)
+{
+    FieldMatrix<K,n,n> A;
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            A[i][j] = matrix[i][j];
+    FieldMatrix<K,n,n> inverse;
+    const K det = FMatrixHelp::invertMatrix(A, inverse);
+    if (!(std::abs(det) >= 1e-40))
+        return false;
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            matrix[i][j] = inverse[i][j];
+    return true;
+}
+
 //! invert matrix by calling matrix.invert
 template <typename K>
 static inline void invertMatrix(Dune::DynamicMatrix<K>& matrix)
@@ -356,6 +392,15 @@ static inline void invertMatrix(Dune::DynamicMatrix<K>& matrix)
         return;
     }
 
+    // the well blocks of up to three equations use the closed forms, the
+    // singular ones go to the elimination below, which reports them
+    if (matrix.rows() == 3 && invertDynamicMatrixClosedForm<3>(matrix))
+        return;
+    if (matrix.rows() == 2 && invertDynamicMatrixClosedForm<2>(matrix))
+        return;
+    if (matrix.rows() == 1 && invertDynamicMatrixClosedForm<1>(matrix))
+        return;
+
 #if ! DUNE_VERSION_NEWER( DUNE_COMMON, 2, 7 )
     Dune::FMatrixPrecision<K>::set_singular_limit(1.e-30);
 #endif
@@ -458,6 +503,74 @@ namespace Opm
 {
 namespace Detail
 {
+    //! whether the block operations below use the kernels of SmallBlockKernels.hpp
+    template <class MatrixK, class VectorK, int n, int m>
+    constexpr bool useSimdBlockKernels()
+    {
+        return Simd::available && std::is_same_v<MatrixK, double> && std::is_same_v<VectorK, double>
+            && n == m && (n == 3 || n == 4);
+    }
+
+    //! y = A * x, vectorized for 3x3 and 4x4 blocks of doubles
+    template <class MatrixK, class VectorK, int n, int m>
+    inline void blockMv(const Dune::FieldMatrix<MatrixK, n, m>& A,
+                        const Dune::FieldVector<VectorK, m>& x,
+                        Dune::FieldVector<VectorK, n>& y)
+    {
+#if OPM_HAVE_SIMD_BLOCK_KERNELS
+        if constexpr (useSimdBlockKernels<MatrixK, VectorK, n, m>()) {
+            Simd::mv<n>(&A[0][0], &x[0], &y[0]);
+            return;
+        }
+#endif
+        A.mv(x, y);
+    }
+
+    //! y -= A * x, vectorized for 3x3 and 4x4 blocks of doubles
+    template <class MatrixK, class VectorK, int n, int m>
+    inline void blockMmv(const Dune::FieldMatrix<MatrixK, n, m>& A,
+                         const Dune::FieldVector<VectorK, m>& x,
+                         Dune::FieldVector<VectorK, n>& y)
+    {
+#if OPM_HAVE_SIMD_BLOCK_KERNELS
+        if constexpr (useSimdBlockKernels<MatrixK, VectorK, n, m>()) {
+            Simd::mmv<n>(&A[0][0], &x[0], &y[0]);
+            return;
+        }
+#endif
+        A.mmv(x, y);
+    }
+
+    //! A = A * B, vectorized for 3x3 and 4x4 blocks of doubles
+    template <class K, int n>
+    inline void blockRightMultiply(Dune::FieldMatrix<K, n, n>& A, const Dune::FieldMatrix<K, n, n>& B)
+    {
+#if OPM_HAVE_SIMD_BLOCK_KERNELS
+        if constexpr (useSimdBlockKernels<K, K, n, n>()) {
+            Simd::matMul<n>(&A[0][0], &B[0][0], &A[0][0]);
+            return;
+        }
+#endif
+        A.rightmultiply(B);
+    }
+
+    //! C -= A * B, vectorized for 3x3 and 4x4 blocks of doubles
+    template <class K, int n>
+    inline void blockSubtractProduct(const Dune::FieldMatrix<K, n, n>& A,
+                                     const Dune::FieldMatrix<K, n, n>& B,
+                                     Dune::FieldMatrix<K, n, n>& C)
+    {
+#if OPM_HAVE_SIMD_BLOCK_KERNELS
+        if constexpr (useSimdBlockKernels<K, K, n, n>()) {
+            Simd::subtractProduct<n>(&A[0][0], &B[0][0], &C[0][0]);
+            return;
+        }
+#endif
+        Dune::FieldMatrix<K, n, n> product(B);
+        product.leftmultiply(A);
+        C -= product;
+    }
+
     //! calculates ret = A * B
     template< class TA, class TB, class TC, class PositiveSign >
     static inline void multMatrixImpl( const TA &A, // n x m
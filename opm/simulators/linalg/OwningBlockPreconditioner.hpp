@@ -68,6 +68,11 @@ public:
         orig_precond_.update();
     }
 
+    virtual std::size_t memoryUsage() const override
+    {
+        return orig_precond_.memoryUsage();
+    }
+
 private:
     OriginalPreconditioner orig_precond_;
     BlockPreconditioner<X, Y, Comm, OriginalPreconditioner> block_precond_;
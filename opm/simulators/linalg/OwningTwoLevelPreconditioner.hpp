@@ -25,6 +25,7 @@
 #include <opm/simulators/linalg/PressureTransferPolicy.hpp>
 #include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
 #include <opm/simulators/linalg/twolevelmethodcpr.hh>
+#include <opm/simulators/utils/MemoryReport.hpp>
 
 #include <opm/common/ErrorMacros.hpp>
 
@@ -95,7 +96,8 @@ public:
         , comm_(nullptr)
         , weightsCalculator_(weightsCalculator)
         , weights_(weightsCalculator())
-        , levelTransferPolicy_(dummy_comm_, weights_, prm.get<int>("pressure_var_index"))
+        , fusedWeights_(useFusedWeights(prm))
+        , levelTransferPolicy_(dummy_comm_, weights_, prm.get<int>("pressure_var_index"), fusedWeights_)
         , coarseSolverPolicy_(prm.get_child_optional("coarsesolver")? prm.get_child("coarsesolver") : pt())
         , twolevel_method_(linearoperator,
                            finesmoother_,
@@ -124,7 +126,8 @@ public:
         , comm_(&comm)
         , weightsCalculator_(weightsCalculator)
         , weights_(weightsCalculator())
-        , levelTransferPolicy_(*comm_, weights_, prm.get<int>("pressure_var_index", 1))
+        , fusedWeights_(useFusedWeights(prm))
+        , levelTransferPolicy_(*comm_, weights_, prm.get<int>("pressure_var_index", 1), fusedWeights_)
         , coarseSolverPolicy_(prm.get_child_optional("coarsesolver")? prm.get_child("coarsesolver") : pt())
         , twolevel_method_(linearoperator,
                            finesmoother_,
@@ -161,10 +164,21 @@ public:
 
     virtual void update() override
     {
-        weights_ = weightsCalculator_();
+        // with fused weights the transfer policy updates them together with the coarse matrix
+        if (!fusedWeights_) {
+            weights_ = weightsCalculator_();
+        }
         updateImpl(comm_);
     }
 
+    virtual std::size_t memoryUsage() const override
+    {
+        const auto* smoother = dynamic_cast<const Dune::PreconditionerWithUpdate<VectorType, VectorType>*>(finesmoother_.get());
+        return (smoother ? smoother->memoryUsage() : 0)
+            + Opm::vectorMemoryUsage(weights_)
+            + twolevel_method_.coarseMemoryUsage();
+    }
+
     virtual Dune::SolverCategory::Category category() const override
     {
         return linear_operator_.category();
@@ -186,6 +200,13 @@ private:
     using TwoLevelMethod
         = Dune::Amg::TwoLevelMethodCpr<OperatorType, CoarseSolverPolicy, Dune::Preconditioner<VectorType, VectorType>>;
 
+    // Only the quasi-IMPES weights of a row depend on that row alone.
+    static bool useFusedWeights(const pt& prm)
+    {
+        return !transpose && prm.get<bool>("fused_weights", false)
+            && prm.get<std::string>("weight_type", "quasiimpes") == "quasiimpes";
+    }
+
     // Handling parallel vs serial instantiation of preconditioner factory.
     template <class Comm>
     void updateImpl(const Comm*)
@@ -209,6 +230,7 @@ private:
     const Communication* comm_;
     std::function<VectorType()> weightsCalculator_;
     VectorType weights_;
+    bool fusedWeights_;
     LevelTransferPolicy levelTransferPolicy_;
     CoarseSolverPolicy coarseSolverPolicy_;
     TwoLevelMethod twolevel_method_;
@@ -21,20 +21,34 @@
 #define OPM_PARALLELOVERLAPPINGILU0_HEADER_INCLUDED
 
 #include <opm/simulators/linalg/GraphColoring.hpp>
+#include <opm/simulators/linalg/MatrixBlock.hpp>
 #include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
+#include <opm/simulators/utils/PerfCounters.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <dune/common/version.hh>
+#include <dune/common/fmatrix.hh>
 #include <dune/istl/preconditioner.hh>
 #include <dune/istl/paamg/smoother.hh>
 #include <dune/istl/paamg/graph.hh>
 #include <dune/istl/paamg/pinfo.hh>
 
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
 #include <type_traits>
+#include <vector>
 #include <numeric>
 #include <limits>
 #include <cstddef>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Opm
 {
 
@@ -79,7 +93,7 @@ class ParallelOverlappingILU0Args
 {
  public:
     ParallelOverlappingILU0Args(MILU_VARIANT milu = MILU_VARIANT::ILU )
-        : milu_(milu), n_(0)
+        : milu_(milu), n_(0), mixedPrecision_(false)
     {}
     void setMilu(MILU_VARIANT milu)
     {
@@ -97,9 +111,18 @@ class ParallelOverlappingILU0Args
     {
         return n_;
     }
+    void setMixedPrecision(bool mixedPrecision)
+    {
+        mixedPrecision_ = mixedPrecision;
+    }
+    bool getMixedPrecision() const
+    {
+        return mixedPrecision_;
+    }
  private:
     MILU_VARIANT milu_;
     int n_;
+    bool mixedPrecision_;
 };
 } // end namespace Opm
 
@@ -141,7 +164,10 @@ struct ConstructionTraits<Opm::ParallelOverlappingILU0<Matrix,Domain,Range,Paral
                       args.getComm(),
                       args.getArgs().getN(),
                       args.getArgs().relaxationFactor,
-                      args.getArgs().getMilu()) );
+                      args.getArgs().getMilu(),
+                      /*redblack=*/false, /*reorder_sphere=*/true,
+                      /*level_scheduling=*/false,
+                      args.getArgs().getMixedPrecision()) );
     }
 
 #if ! DUNE_VERSION_NEWER(DUNE_ISTL, 2, 7)
@@ -271,7 +297,7 @@ namespace Opm
                 auto k = a_ik.index();
                 auto a_kk = A[k].find(k);
                 // L_ik = A_kk^-1 * A_ik
-                a_ik->rightmultiply(*a_kk);
+                Opm::Detail::blockRightMultiply(*a_ik, *a_kk);
 
                 // modify the rest of the row, everything right of a_ik
                 // a_i* -=a_ik * a_k*
@@ -338,9 +364,14 @@ namespace Opm
                             diagonal);
     }
 
+    //! \brief Create the fill pattern of the ILU(n) decomposition of the reordered A.
+    //!
+    //! The pattern only depends on the sparsity pattern of A. ILU must be
+    //! empty and in row_wise build mode, the values of its entries are
+    //! undefined afterwards.
     template<class M>
-    void milun_decomposition(const M& A, int n, MILU_VARIANT milu, M& ILU,
-                             Reorderer& ordering, Reorderer& inverseOrdering)
+    void milun_symbolic(const M& A, int n, M& ILU,
+                        Reorderer& ordering, Reorderer& inverseOrdering)
     {
         using Map = std::map<std::size_t, int>;
 
@@ -395,7 +426,13 @@ namespace Opm
                 (*col)[0][0] = generationPair->second;
             }
         }
+    }
 
+    //! \brief Compute the ILU(n) decomposition on the fill pattern created
+    //! by milun_symbolic(), copying the values of the reordered A into it.
+    template<class M>
+    void milun_numeric(const M& A, MILU_VARIANT milu, M& ILU, Reorderer& ordering)
+    {
         // copy Entries from A
         for(auto iter=A.begin(), iend = A.end(); iter != iend; ++iter)
         {
@@ -435,6 +472,141 @@ namespace Opm
         }
     }
 
+    template<class M>
+    void milun_decomposition(const M& A, int n, MILU_VARIANT milu, M& ILU,
+                             Reorderer& ordering, Reorderer& inverseOrdering)
+    {
+        milun_symbolic(A, n, ILU, ordering, inverseOrdering);
+        milun_numeric(A, milu, ILU, ordering);
+    }
+
+    //! \brief Compute a blocked ILUT decomposition of the reordered A.
+    //!
+    //! An entry of L, and an entry of the row being eliminated before it is
+    //! stored, is dropped if the Frobenius norm of its block is below threshold
+    //! times the mean block norm of the row of A. Of the remaining entries at
+    //! most fill more than A has are kept in the L and in the U part of each
+    //! row, the largest ones. The diagonal is never dropped and stores its
+    //! inverse as for bilu0_decomposition. ILU must be empty and in row_wise
+    //! build mode.
+    template<class M>
+    void bilut_decomposition(const M& A, double threshold, int fill, M& ILU,
+                             Reorderer& ordering, Reorderer& inverseOrdering)
+    {
+        using Block = typename M::block_type;
+        using size_type = typename M::size_type;
+        using Entry = std::pair<size_type, Block>;
+
+        const size_type numRows = A.N();
+        // the factored rows, the diagonal of row i is rows[i][diagonal[i]]
+        std::vector<std::vector<Entry>> rows(numRows);
+        std::vector<size_type> diagonal(numRows);
+        std::map<size_type, Block> work;
+        std::vector<Entry> lower, upper;
+
+        auto keepLargest = [](std::vector<Entry>& entries, const double tol, const size_type maxEntries)
+        {
+            entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                         [tol](const Entry& e) { return e.second.frobenius_norm() < tol; }),
+                          entries.end());
+            if (entries.size() > maxEntries) {
+                std::nth_element(entries.begin(), entries.begin() + maxEntries, entries.end(),
+                                 [](const Entry& a, const Entry& b)
+                                 { return a.second.frobenius_norm() > b.second.frobenius_norm(); });
+                entries.resize(maxEntries);
+            }
+            std::sort(entries.begin(), entries.end(),
+                      [](const Entry& a, const Entry& b) { return a.first < b.first; });
+        };
+
+        for (size_type i = 0; i < numRows; ++i)
+        {
+            const auto& row = A[inverseOrdering[i]];
+            work.clear();
+            double norm = 0.0;
+            size_type numLower = 0;
+            size_type numUpper = 0;
+            for (auto col = row.begin(), cend = row.end(); col != cend; ++col)
+            {
+                const size_type j = ordering[col.index()];
+                work[j] = *col;
+                norm += col->frobenius_norm();
+                numLower += j < i;
+                numUpper += j > i;
+            }
+            const double tol = threshold * norm / std::max<size_type>(row.size(), 1);
+
+            // eliminate with the rows above, the fill-in is inserted into work
+            // and reached later in increasing column order
+            for (auto ik = work.begin(); ik != work.end() && ik->first < i; ++ik)
+            {
+                const size_type k = ik->first;
+                Opm::Detail::blockRightMultiply(ik->second, rows[k][diagonal[k]].second);
+                if (ik->second.frobenius_norm() < tol)
+                {
+                    ik->second = 0.0;
+                    continue;
+                }
+                for (size_type kj = diagonal[k] + 1; kj < rows[k].size(); ++kj)
+                {
+                    auto ij = work.find(rows[k][kj].first);
+                    if (ij == work.end())
+                    {
+                        Block zero;
+                        zero = 0.0;
+                        ij = work.emplace(rows[k][kj].first, zero).first;
+                    }
+                    Opm::Detail::blockSubtractProduct(ik->second, rows[k][kj].second, ij->second);
+                }
+            }
+
+            auto ii = work.find(i);
+            if (ii == work.end())
+            {
+                DUNE_THROW(Dune::MatrixBlockError, "ILUT: diagonal entry missing in row " << i);
+            }
+            lower.assign(work.begin(), ii);
+            upper.assign(std::next(ii), work.end());
+            keepLargest(lower, tol, numLower + fill);
+            keepLargest(upper, tol, numUpper + fill);
+
+            auto& iluRow = rows[i];
+            iluRow.reserve(lower.size() + 1 + upper.size());
+            iluRow.assign(lower.begin(), lower.end());
+            diagonal[i] = iluRow.size();
+            iluRow.push_back(*ii);
+            try
+            {
+                iluRow.back().second.invert();
+            }
+            catch (Dune::FMatrixError&)
+            {
+                DUNE_THROW(Dune::MatrixBlockError, "ILUT failed to invert the diagonal block of row " << i);
+            }
+            iluRow.insert(iluRow.end(), upper.begin(), upper.end());
+        }
+
+        for (auto iter = ILU.createbegin(), iend = ILU.createend(); iter != iend; ++iter)
+        {
+            for (const auto& entry : rows[iter.index()])
+            {
+                iter.insert(entry.first);
+            }
+        }
+        for (size_type i = 0; i < numRows; ++i)
+        {
+            auto& iluRow = ILU[i];
+            auto col = iluRow.begin();
+            for (const auto& entry : rows[i])
+            {
+                *col = entry.second;
+                ++col;
+            }
+            // the factored row is not needed anymore
+            std::vector<Entry>().swap(rows[i]);
+        }
+    }
+
     //! Compute Blocked ILU0 decomposition, when we know junk ghost rows are located at the end of A
     template<class M>
     void ghost_last_bilu0_decomposition (M& A, size_t interiorSize)
@@ -442,7 +614,6 @@ namespace Opm
         // iterator types
         typedef typename M::RowIterator rowiterator;
         typedef typename M::ColIterator coliterator;
-        typedef typename M::block_type block;
 
         // implement left looking variant with stored inverse
         for (rowiterator i = A.begin(); i.index() < interiorSize; ++i)
@@ -458,7 +629,7 @@ namespace Opm
                 coliterator jj = A[ij.index()].find(ij.index());
                 
                 // compute L_ij = A_jj^-1 * A_ij
-                (*ij).rightmultiply(*jj);
+                Opm::Detail::blockRightMultiply(*ij, *jj);
 
                 // modify row
                 coliterator endjk=A[ij.index()].end();    // end of row j
@@ -467,9 +638,7 @@ namespace Opm
                 while (ik!=endij && jk!=endjk)
                     if (ik.index()==jk.index())
                     {
-                        block B(*jk);
-                        B.leftmultiply(*ij);
-                        *ik -= B;
+                        Opm::Detail::blockSubtractProduct(*ij, *jk, *ik);
                         ++ik; ++jk;
                     }
                     else
@@ -506,6 +675,11 @@ namespace Opm
 
         typedef typename M :: size_type size_type;
 
+        if ( A.M() > std::numeric_limits< typename CRS::index_type >::max() )
+        {
+          OPM_THROW(std::invalid_argument, "The ILU0 preconditioner supports at most 2^32 - 1 columns");
+        }
+
         lower.clear();
         upper.clear();
         inv.clear();
@@ -621,9 +795,14 @@ public:
     typedef typename matrix_type::size_type   size_type;
 
 protected:
-    struct CRS
+    template<class BlockT>
+    struct CRSImpl
     {
-      CRS() : nRows_( 0 ) {}
+      // 32 bit column indices, the triangular solves are bound by the memory
+      // bandwidth and read one index per block
+      using index_type = std::uint32_t;
+
+      CRSImpl() : nRows_( 0 ) {}
 
       size_type rows() const { return nRows_; }
 
@@ -653,10 +832,10 @@ protected:
           }
       }
 
-      void push_back( const block_type& value, const size_type index )
+      void push_back( const BlockT& value, const size_type index )
       {
           values_.push_back( value );
-          cols_.push_back( index );
+          cols_.push_back( static_cast< index_type >( index ) );
       }
 
       void clear()
@@ -668,11 +847,16 @@ protected:
       }
 
       std::vector< size_type  > rows_;
-      std::vector< block_type > values_;
-      std::vector< size_type  > cols_;
+      std::vector< BlockT > values_;
+      std::vector< index_type > cols_;
       size_type nRows_;
     };
 
+    using CRS = CRSImpl< block_type >;
+    //! \brief Single precision block used to store the factors if requested.
+    using float_block_type = Dune::FieldMatrix< float, block_type::rows, block_type::cols >;
+    using FloatCRS = CRSImpl< float_block_type >;
+
 public:
     Dune::SolverCategory::Category category() const override
     {
@@ -692,19 +876,36 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param level_scheduling If true, rows of the triangular solves that do not
+                            depend on each other are processed by multiple threads.
+      \param mixed_precision If true, the factors are stored in single precision,
+                            while the vectors are kept in double.
+      \param ilut_threshold If positive, an ILUT decomposition is computed instead
+                            of ILU(n), dropping the entries whose block norm is
+                            below this times the mean block norm of their row.
+      \param ilut_fill The number of entries which ILUT keeps in the L and in the
+                            U part of a row in addition to those of A.
+      \param cuthill_mckee If true and no red-black ordering is used, the unknowns
+                            are renumbered in reverse Cuthill-McKee order for the
+                            factorization and the triangular solves.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const int n, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool level_scheduling=false,
+                             bool mixed_precision=false, double ilut_threshold=0.0,
+                             int ilut_fill=0, bool cuthill_mckee=false)
         : lower_(),
           upper_(),
           inv_(),
           comm_(nullptr), w_(w),
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(n),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          levelScheduling_(level_scheduling), mixedPrecision_(mixed_precision),
+          ilutThreshold_(ilut_threshold), ilutFill_(ilut_fill),
+          cuthillMcKee_(cuthill_mckee)
     {
         interiorSize_ = A.N();
         // BlockMatrix is a Subclass of FieldMatrix that just adds
@@ -723,19 +924,36 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param level_scheduling If true, rows of the triangular solves that do not
+                            depend on each other are processed by multiple threads.
+      \param mixed_precision If true, the factors are stored in single precision,
+                            while the vectors are kept in double.
+      \param ilut_threshold If positive, an ILUT decomposition is computed instead
+                            of ILU(n), dropping the entries whose block norm is
+                            below this times the mean block norm of their row.
+      \param ilut_fill The number of entries which ILUT keeps in the L and in the
+                            U part of a row in addition to those of A.
+      \param cuthill_mckee If true and no red-black ordering is used, the unknowns
+                            are renumbered in reverse Cuthill-McKee order for the
+                            factorization and the triangular solves.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm, const int n, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool level_scheduling=false,
+                             bool mixed_precision=false, double ilut_threshold=0.0,
+                             int ilut_fill=0, bool cuthill_mckee=false)
         : lower_(),
           upper_(),
           inv_(),
           comm_(&comm), w_(w),
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(n),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          levelScheduling_(level_scheduling), mixedPrecision_(mixed_precision),
+          ilutThreshold_(ilut_threshold), ilutFill_(ilut_fill),
+          cuthillMcKee_(cuthill_mckee)
     {
         interiorSize_ = A.N();
         // BlockMatrix is a Subclass of FieldMatrix that just adds
@@ -754,12 +972,17 @@ public:
                   The vertices on each layer aound it (same distance) are
                   ordered consecutivly. If false, we preserver the order of
                   the vertices with the same color.
+      \param level_scheduling If true, rows of the triangular solves that do not
+                  depend on each other are processed by multiple threads.
+      \param mixed_precision If true, the factors are stored in single precision,
+                  while the vectors are kept in double.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const field_type w, MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
-        : ParallelOverlappingILU0( A, 0, w, milu, redblack, reorder_sphere )
+                             bool reorder_sphere=true, bool level_scheduling=false,
+                             bool mixed_precision=false)
+        : ParallelOverlappingILU0( A, 0, w, milu, redblack, reorder_sphere, level_scheduling, mixed_precision )
     {
     }
 
@@ -775,19 +998,25 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param level_scheduling If true, rows of the triangular solves that do not
+                            depend on each other are processed by multiple threads.
+      \param mixed_precision If true, the factors are stored in single precision,
+                            while the vectors are kept in double.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool level_scheduling=false,
+                             bool mixed_precision=false)
         : lower_(),
           upper_(),
           inv_(),
           comm_(&comm), w_(w),
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(0),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          levelScheduling_(level_scheduling), mixedPrecision_(mixed_precision)
     {
         interiorSize_ = A.N();
         // BlockMatrix is a Subclass of FieldMatrix that just adds
@@ -808,13 +1037,21 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param level_scheduling If true, rows of the triangular solves that do not
+                            depend on each other are processed by multiple threads.
+      \param mixed_precision If true, the factors are stored in single precision,
+                            while the vectors are kept in double.
+      \param cuthill_mckee If true and no red-black ordering is used, the interior
+                            unknowns are renumbered in reverse Cuthill-McKee order for
+                            the factorization and the triangular solves.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm,
                              const field_type w, MILU_VARIANT milu,
                              size_type interiorSize, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool level_scheduling=false,
+                             bool mixed_precision=false, bool cuthill_mckee=false)
         : lower_(),
           upper_(),
           inv_(),
@@ -822,7 +1059,9 @@ public:
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           interiorSize_(interiorSize),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(0),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          levelScheduling_(level_scheduling), mixedPrecision_(mixed_precision),
+          cuthillMcKee_(cuthill_mckee)
     {
         // BlockMatrix is a Subclass of FieldMatrix that just adds
         // methods. Therefore this cast should be safe.
@@ -847,61 +1086,54 @@ public:
     */
     virtual void apply (Domain& v, const Range& d) override
     {
+        OPM_PERF_SCOPE("ilu apply", mixedPrecision_ ? memoryTraffic(lowerFloat_, upperFloat_, invFloat_, v)
+                                                    : memoryTraffic(lower_, upper_, inv_, v));
         Range& md = reorderD(d);
         Domain& mv = reorderV(v);
 
-        // iterator types
-        typedef typename Range ::block_type  dblock;
-        typedef typename Domain::block_type  vblock;
-
-        const size_type iEnd = lower_.rows();
-        const size_type lastRow = iEnd - 1;
-        size_type upperLoppStart = iEnd - interiorSize_;
-        size_type lowerLoopEnd = interiorSize_;
-        if( iEnd != upper_.rows() )
+        if( mixedPrecision_ )
         {
-            OPM_THROW(std::logic_error,"ILU: number of lower and upper rows must be the same");
+            triangularSolves( lowerFloat_, upperFloat_, invFloat_, mv, md );
         }
-
-        // lower triangular solve
-        for( size_type i=0; i<lowerLoopEnd; ++ i )
+        else
         {
-          dblock rhs( md[ i ] );
-          const size_type rowI     = lower_.rows_[ i ];
-          const size_type rowINext = lower_.rows_[ i+1 ];
-
-          for( size_type col = rowI; col < rowINext; ++ col )
-          {
-            lower_.values_[ col ].mmv( mv[ lower_.cols_[ col ] ], rhs );
-          }
-
-          mv[ i ] = rhs;  // Lii = I
+            triangularSolves( lower_, upper_, inv_, mv, md );
         }
 
-        for( size_type i=upperLoppStart; i<iEnd; ++ i )
-        {
-            vblock& vBlock = mv[ lastRow - i ];
-            vblock rhs ( vBlock );
-            const size_type rowI     = upper_.rows_[ i ];
-            const size_type rowINext = upper_.rows_[ i+1 ];
-
-            for( size_type col = rowI; col < rowINext; ++ col )
-            {
-                upper_.values_[ col ].mmv( mv[ upper_.cols_[ col ] ], rhs );
-            }
-
-            // apply inverse and store result
-            inv_[ i ].mv( rhs, vBlock);
+        if( copyOwnerToAll_ ) {
+            copyOwnerToAll( mv );
         }
 
-        copyOwnerToAll( mv );
-
         if( relaxation_ ) {
             mv *= w_;
         }
         reorderBack(mv, v);
     }
 
+    //! \brief The bytes triangularSolves() reads and writes at least: the factors with
+    //! their indices, the input and twice the output.
+    template<class CRSType, class InvVector>
+    static double memoryTraffic(const CRSType& lower, const CRSType& upper, const InvVector& inv, const Domain& v)
+    {
+        using BlockT = typename decltype(lower.values_)::value_type;
+        const double entries = lower.values_.size() + upper.values_.size();
+        return entries * (sizeof(BlockT) + sizeof(size_type))
+            + (lower.rows_.size() + upper.rows_.size()) * sizeof(size_type)
+            + inv.size() * sizeof(typename InvVector::value_type)
+            + 3.0 * v.size() * sizeof(typename Domain::block_type);
+    }
+
+    /*!
+      \brief Whether apply() makes its result consistent.
+
+      This can be switched off if the operator that is applied next
+      does the halo exchange itself, see WellModelGhostLastOverlappedMatrixAdapter.
+    */
+    void setCopyOwnerToAll( bool copy )
+    {
+        copyOwnerToAll_ = copy;
+    }
+
     template <class V>
     void copyOwnerToAll( V& v ) const
     {
@@ -920,6 +1152,30 @@ public:
         DUNE_UNUSED_PARAMETER(x);
     }
 
+    virtual std::size_t memoryUsage() const override
+    {
+        auto crsUsage = [](const auto& crs)
+        {
+            return crs.rows_.capacity() * sizeof(size_type)
+                + crs.values_.capacity() * sizeof(typename decltype(crs.values_)::value_type)
+                + crs.cols_.capacity() * sizeof(typename decltype(crs.cols_)::value_type);
+        };
+        auto nestedUsage = [](const std::vector< std::vector< size_type > >& levels)
+        {
+            std::size_t bytes = 0;
+            for (const auto& level : levels)
+                bytes += level.capacity() * sizeof(size_type);
+            return bytes;
+        };
+        return crsUsage(lower_) + crsUsage(upper_) + inv_.capacity() * sizeof(block_type)
+            + crsUsage(lowerFloat_) + crsUsage(upperFloat_) + invFloat_.capacity() * sizeof(float_block_type)
+            + ordering_.capacity() * sizeof(std::size_t)
+            + reorderedD_.size() * sizeof(typename Range::block_type)
+            + reorderedV_.size() * sizeof(typename Domain::block_type)
+            + nestedUsage(lowerLevels_) + nestedUsage(upperLevels_)
+            + (iluFactors_ ? Opm::matrixMemoryUsage(*iluFactors_) : 0);
+    }
+
     virtual void update() override
     {
         // (For older DUNE versions the communicator might be
@@ -944,11 +1200,30 @@ public:
 
         std::unique_ptr< Matrix > ILU;
 
-        if ( redBlack_ )
+        // The ordering and the ILU(n) fill pattern only depend on the sparsity
+        // pattern of A, they are kept as long as that does not change.
+        const bool patternChanged = !patternKnown_ || A_->N() != patternRows_
+            || A_->nonzeroes() != patternNonzeroes_;
+        patternKnown_ = true;
+        patternRows_ = A_->N();
+        patternNonzeroes_ = A_->nonzeroes();
+        if ( patternChanged )
+        {
+            iluFactors_.reset();
+        }
+
+        if ( redBlack_ && patternChanged )
         {
             using Graph = Dune::Amg::MatrixGraph<const Matrix>;
             Graph graph(*A_);
-            auto colorsTuple = colorVerticesWelshPowell(graph);
+            // With several threads the threaded coloring is used, it needs
+            // more colors than the sequential one of Welsh and Powell.
+            bool threadedColoring = false;
+#ifdef _OPENMP
+            threadedColoring = omp_get_max_threads() > 1;
+#endif
+            auto colorsTuple = threadedColoring ? colorVerticesJonesPlassmann(graph)
+                                                : colorVerticesWelshPowell(graph);
             const auto& colors = std::get<0>(colorsTuple);
             const auto& verticesPerColor = std::get<2>(colorsTuple);
             auto noColors = std::get<1>(colorsTuple);
@@ -963,6 +1238,15 @@ public:
                                                       graph);
             }
         }
+        else if ( cuthillMcKee_ && patternChanged )
+        {
+            // A narrow band keeps the rows that the factorization and the
+            // triangular solves touch together close in memory. The ghost
+            // rows keep their place at the end.
+            using Graph = Dune::Amg::MatrixGraph<const Matrix>;
+            Graph graph(*A_);
+            ordering_ = reorderVerticesReverseCuthillMcKee(graph, interiorSize_);
+        }
 
         std::vector<std::size_t> inverseOrdering(ordering_.size());
         std::size_t index = 0;
@@ -971,9 +1255,30 @@ public:
             inverseOrdering[newIndex] = index++;
         }
 
+        // the matrix whose decomposition is stored
+        const Matrix* factors = nullptr;
+
         try
         {
-            if( iluIteration_ == 0 ) {
+            if( ilutThreshold_ > 0 ) {
+                // create ILUT decomposition
+                ILU.reset( new Matrix( A_->N(), A_->M(), Matrix::row_wise) );
+                std::unique_ptr<detail::Reorderer> reorderer, inverseReorderer;
+                if ( ordering_.empty() )
+                {
+                    reorderer.reset(new detail::NoReorderer());
+                    inverseReorderer.reset(new detail::NoReorderer());
+                }
+                else
+                {
+                    reorderer.reset(new detail::RealReorderer(ordering_));
+                    inverseReorderer.reset(new detail::RealReorderer(inverseOrdering));
+                }
+
+                detail::bilut_decomposition( *A_, ilutThreshold_, ilutFill_, *ILU, *reorderer, *inverseReorderer );
+                factors = ILU.get();
+            }
+            else if( iluIteration_ == 0 ) {
                 // create ILU-0 decomposition
                 if ( ordering_.empty() )
                 {
@@ -1027,10 +1332,10 @@ public:
                         detail::ghost_last_bilu0_decomposition(*ILU, interiorSize_);
                     break;
                 }
+                factors = ILU.get();
             }
             else {
-                // create ILU-n decomposition
-                ILU.reset( new Matrix( A_->N(), A_->M(), Matrix::row_wise) );
+                // create ILU-n decomposition, the fill pattern is computed once
                 std::unique_ptr<detail::Reorderer> reorderer, inverseReorderer;
                 if ( ordering_.empty() )
                 {
@@ -1043,7 +1348,13 @@ public:
                     inverseReorderer.reset(new detail::RealReorderer(inverseOrdering));
                 }
 
-                milun_decomposition( *A_, iluIteration_, milu_, *ILU, *reorderer, *inverseReorderer );
+                if ( !iluFactors_ )
+                {
+                    iluFactors_.reset( new Matrix( A_->N(), A_->M(), Matrix::row_wise) );
+                    detail::milun_symbolic( *A_, iluIteration_, *iluFactors_, *reorderer, *inverseReorderer );
+                }
+                detail::milun_numeric( *A_, milu_, *iluFactors_, *reorderer );
+                factors = iluFactors_.get();
             }
         }
         catch (const Dune::MatrixBlockError& error)
@@ -1064,10 +1375,199 @@ public:
         }
 
         // store ILU in simple CRS format
-        detail::convertToCRS( *ILU, lower_, upper_, inv_ );
+        detail::convertToCRS( *factors, lower_, upper_, inv_ );
+
+        if( levelScheduling_ )
+        {
+            computeLevels();
+        }
+
+        if( mixedPrecision_ )
+        {
+            convertToFloat( lower_, lowerFloat_ );
+            convertToFloat( upper_, upperFloat_ );
+            invFloat_.resize( inv_.size() );
+            std::transform( inv_.begin(), inv_.end(), invFloat_.begin(), toFloat );
+            // only the single precision copy is used in apply()
+            lower_.clear();
+            upper_.clear();
+            inv_.clear();
+        }
     }
 
 protected:
+    /// \brief Solve L U mv = md with the given factors.
+    template<class LowerCRS, class UpperCRS, class InvVector>
+    void triangularSolves( const LowerCRS& lower, const UpperCRS& upper,
+                           const InvVector& inv, Domain& mv, const Range& md ) const
+    {
+        // iterator types
+        typedef typename Range ::block_type  dblock;
+        typedef typename Domain::block_type  vblock;
+
+        const size_type iEnd = lower.rows();
+        const size_type lastRow = iEnd - 1;
+        size_type upperLoppStart = iEnd - interiorSize_;
+        size_type lowerLoopEnd = interiorSize_;
+        if( iEnd != upper.rows() )
+        {
+            OPM_THROW(std::logic_error,"ILU: number of lower and upper rows must be the same");
+        }
+
+        auto lowerSolveRow = [&]( const size_type i )
+        {
+          dblock rhs( md[ i ] );
+          const size_type rowI     = lower.rows_[ i ];
+          const size_type rowINext = lower.rows_[ i+1 ];
+
+          for( size_type col = rowI; col < rowINext; ++ col )
+          {
+            Opm::Detail::blockMmv( lower.values_[ col ], mv[ lower.cols_[ col ] ], rhs );
+          }
+
+          mv[ i ] = rhs;  // Lii = I
+        };
+
+        auto upperSolveRow = [&]( const size_type i )
+        {
+            vblock& vBlock = mv[ lastRow - i ];
+            vblock rhs ( vBlock );
+            const size_type rowI     = upper.rows_[ i ];
+            const size_type rowINext = upper.rows_[ i+1 ];
+
+            for( size_type col = rowI; col < rowINext; ++ col )
+            {
+                Opm::Detail::blockMmv( upper.values_[ col ], mv[ upper.cols_[ col ] ], rhs );
+            }
+
+            // apply inverse and store result
+            Opm::Detail::blockMv( inv[ i ], rhs, vBlock );
+        };
+
+        if( levelScheduling_ )
+        {
+            // rows within a level only depend on rows of previous levels
+            for( const auto& level : lowerLevels_ )
+            {
+                const int levelSize = level.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+                for( int k=0; k<levelSize; ++ k )
+                {
+                    lowerSolveRow( level[ k ] );
+                }
+            }
+
+            for( const auto& level : upperLevels_ )
+            {
+                const int levelSize = level.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+                for( int k=0; k<levelSize; ++ k )
+                {
+                    upperSolveRow( level[ k ] );
+                }
+            }
+        }
+        else
+        {
+            // lower triangular solve
+            for( size_type i=0; i<lowerLoopEnd; ++ i )
+            {
+                lowerSolveRow( i );
+            }
+
+            for( size_type i=upperLoppStart; i<iEnd; ++ i )
+            {
+                upperSolveRow( i );
+            }
+        }
+
+    }
+
+    /// \brief Group the rows of the triangular solves into levels.
+    ///
+    /// A row is put into the level after the last level of the rows it
+    /// depends on, so all rows of a level can be solved concurrently.
+    /// Ghost rows are skipped as in the sequential sweeps of apply().
+    void computeLevels()
+    {
+        const size_type iEnd = lower_.rows();
+        const size_type lastRow = iEnd - 1;
+        const size_type upperLoopStart = iEnd - interiorSize_;
+        const size_type lowerLoopEnd = interiorSize_;
+
+        auto groupRows = [](const std::vector<int>& rowLevel, const size_type begin,
+                            const size_type end, const int numLevels,
+                            std::vector<std::vector<size_type>>& levels)
+        {
+            levels.clear();
+            levels.resize(numLevels);
+            for( size_type i=begin; i<end; ++ i )
+            {
+                levels[ rowLevel[ i ] ].push_back( i );
+            }
+        };
+
+        std::vector<int> rowLevel(iEnd, 0);
+        int numLevels = 0;
+        for( size_type i=0; i<lowerLoopEnd; ++ i )
+        {
+            int level = 0;
+            for( size_type col = lower_.rows_[ i ]; col < lower_.rows_[ i+1 ]; ++ col )
+            {
+                level = std::max( level, rowLevel[ lower_.cols_[ col ] ] + 1 );
+            }
+            rowLevel[ i ] = level;
+            numLevels = std::max( numLevels, level + 1 );
+        }
+        groupRows( rowLevel, 0, lowerLoopEnd, numLevels, lowerLevels_ );
+
+        // upper_ is stored in reverse row order, entry i belongs to row lastRow - i
+        std::fill( rowLevel.begin(), rowLevel.end(), 0 );
+        numLevels = 0;
+        for( size_type i=upperLoopStart; i<iEnd; ++ i )
+        {
+            int level = 0;
+            for( size_type col = upper_.rows_[ i ]; col < upper_.rows_[ i+1 ]; ++ col )
+            {
+                const size_type dependency = lastRow - upper_.cols_[ col ];
+                if( dependency >= upperLoopStart )
+                {
+                    level = std::max( level, rowLevel[ dependency ] + 1 );
+                }
+            }
+            rowLevel[ i ] = level;
+            numLevels = std::max( numLevels, level + 1 );
+        }
+        groupRows( rowLevel, upperLoopStart, iEnd, numLevels, upperLevels_ );
+    }
+
+    static float_block_type toFloat( const block_type& block )
+    {
+        float_block_type result;
+        for( int i = 0; i < block_type::rows; ++i )
+        {
+            for( int j = 0; j < block_type::cols; ++j )
+            {
+                result[ i ][ j ] = block[ i ][ j ];
+            }
+        }
+        return result;
+    }
+
+    static void convertToFloat( const CRS& from, FloatCRS& to )
+    {
+        to.clear();
+        to.nRows_ = from.nRows_;
+        to.rows_ = from.rows_;
+        to.cols_ = from.cols_;
+        to.values_.resize( from.values_.size() );
+        std::transform( from.values_.begin(), from.values_.end(), to.values_.begin(), toFloat );
+    }
+
     /// \brief Reorder D if needed and return a reference to it.
     Range& reorderD(const Range& d)
     {
@@ -1143,6 +1643,31 @@ protected:
     MILU_VARIANT milu_;
     bool redBlack_;
     bool reorderSphere_;
+    //! \brief Whether the triangular solves run level by level on multiple threads.
+    bool levelScheduling_;
+    //! \brief The rows of the lower and upper triangular solve grouped by level.
+    std::vector< std::vector< size_type > > lowerLevels_;
+    std::vector< std::vector< size_type > > upperLevels_;
+    //! \brief Whether the factors are stored in single precision.
+    bool mixedPrecision_;
+    FloatCRS lowerFloat_;
+    FloatCRS upperFloat_;
+    std::vector< float_block_type > invFloat_;
+    //! \brief Whether apply() copies the owner values to the copies.
+    bool copyOwnerToAll_ = true;
+    //! \brief The drop tolerance and the additional fill per row of ILUT,
+    //! which is used instead of ILU(n) for a positive tolerance.
+    double ilutThreshold_ = 0.0;
+    int ilutFill_ = 0;
+    //! \brief Whether the unknowns are renumbered in reverse Cuthill-McKee order.
+    bool cuthillMcKee_ = false;
+    //! \brief The sparsity pattern of A the ordering and the fill pattern were
+    //! computed for.
+    bool patternKnown_ = false;
+    size_type patternRows_ = 0;
+    size_type patternNonzeroes_ = 0;
+    //! \brief The ILU(n) decomposition, kept for its fill pattern.
+    std::unique_ptr< Matrix > iluFactors_;
 };
 
 } // end namespace Opm
@@ -0,0 +1,343 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PIPELINED_BICGSTAB_SOLVER_HEADER_INCLUDED
+#define OPM_PIPELINED_BICGSTAB_SOLVER_HEADER_INCLUDED
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solver.hh>
+
+#include <opm/simulators/linalg/KrylovMonitor.hpp>
+
+#if HAVE_MPI
+#include <mpi.h>
+#include <dune/common/parallel/mpitraits.hh>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Dune
+{
+
+/// Computes a batch of dot products with a single global reduction,
+/// which can be overlapped with other work between start() and wait().
+template <class X>
+class NonblockingDots
+{
+public:
+    using field_type = typename X::field_type;
+    using Pairs = std::vector<std::pair<const X*, const X*>>;
+
+    virtual ~NonblockingDots() = default;
+
+    /// Start computing the dot products of all pairs.
+    virtual void start(const Pairs& pairs) = 0;
+
+    /// Wait for the results of the last start(), in the order of the pairs.
+    virtual const std::vector<field_type>& wait() = 0;
+
+protected:
+    /// Local part of the dot products, the entries with a zero mask are skipped.
+    void localDots(const Pairs& pairs, const X* mask)
+    {
+        results_.assign(pairs.size(), 0.0);
+        for (std::size_t k = 0; k < pairs.size(); ++k) {
+            const X& x = *pairs[k].first;
+            const X& y = *pairs[k].second;
+            field_type sum = 0.0;
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                for (std::size_t j = 0; j < x[i].size(); ++j) {
+                    const field_type m = mask ? (*mask)[i][j] : 1.0;
+                    sum += m * x[i][j] * y[i][j];
+                }
+            }
+            results_[k] = sum;
+        }
+    }
+
+    std::vector<field_type> results_;
+};
+
+
+/// Sequential version, the dot products are done in start().
+template <class X>
+class SequentialNonblockingDots : public NonblockingDots<X>
+{
+public:
+    using typename NonblockingDots<X>::field_type;
+    using typename NonblockingDots<X>::Pairs;
+
+    void start(const Pairs& pairs) override
+    {
+        this->localDots(pairs, nullptr);
+    }
+
+    const std::vector<field_type>& wait() override
+    {
+        return this->results_;
+    }
+};
+
+
+#if HAVE_MPI
+/// Parallel version for an OwnerOverlapCopyCommunication, only the owned entries contribute
+/// and the local sums are reduced with MPI_Iallreduce.
+template <class X, class Comm>
+class ParallelNonblockingDots : public NonblockingDots<X>
+{
+public:
+    using typename NonblockingDots<X>::field_type;
+    using typename NonblockingDots<X>::Pairs;
+
+    explicit ParallelNonblockingDots(const Comm& comm)
+        : comm_(comm)
+    {
+    }
+
+    void start(const Pairs& pairs) override
+    {
+        const X& x = *pairs.front().first;
+        if (mask_.size() != x.size()) {
+            mask_ = x;
+            mask_ = 1.0;
+            comm_.project(mask_);
+        }
+        this->localDots(pairs, &mask_);
+        MPI_Iallreduce(MPI_IN_PLACE, this->results_.data(), this->results_.size(),
+                       MPITraits<field_type>::getType(), MPI_SUM, comm_.communicator(), &request_);
+    }
+
+    const std::vector<field_type>& wait() override
+    {
+        MPI_Wait(&request_, MPI_STATUS_IGNORE);
+        return this->results_;
+    }
+
+private:
+    const Comm& comm_;
+    X mask_;
+    MPI_Request request_ = MPI_REQUEST_NULL;
+};
+#endif // HAVE_MPI
+
+
+/// Pipelined, preconditioned BiCGSTAB, following Algorithm 5 of
+///    S. Cools, W. Vanroose, "The communication-hiding pipelined BiCGStab method for the parallel solution of large unsymmetric linear systems",
+///    Parallel Computing 65, 2017, https://doi.org/10.1016/j.parco.2017.04.005
+/// Every iteration has two global reductions (instead of four in Dune::BiCGSTABSolver),
+/// and each of them is overlapped with one preconditioner apply and one operator apply.
+/// The price is a number of extra vectors and vector updates.
+template <class X>
+class PipelinedBiCGSTABSolver : public InverseOperator<X, X>
+{
+public:
+    using field_type = typename X::field_type;
+    using real_type = typename FieldTraits<field_type>::real_type;
+
+    PipelinedBiCGSTABSolver(LinearOperator<X, X>& op,
+                            Preconditioner<X, X>& prec,
+                            std::shared_ptr<NonblockingDots<X>> dots,
+                            real_type reduction,
+                            int maxit,
+                            int verbose,
+                            const KrylovMonitor& monitor = KrylovMonitor())
+        : op_(op)
+        , prec_(prec)
+        , dots_(dots)
+        , reduction_(reduction)
+        , maxit_(maxit)
+        , verbose_(verbose)
+        , monitor_(monitor)
+    {
+    }
+
+    void apply(X& x, X& b, InverseOperatorResult& res) override
+    {
+        apply(x, b, reduction_, res);
+    }
+
+    /// Solve A x = b, b is overwritten by the residual, like the Dune solvers do.
+    void apply(X& x, X& b, double reduction, InverseOperatorResult& res) override
+    {
+        const real_type EPSILON = 1e-80;
+        res.clear();
+        Timer watch;
+
+        X& r = b;
+        op_.applyscaleadd(-1.0, x, r);  // r = b - A * x
+        prec_.pre(x, r);
+
+        X rt(r), rhat(r), w(r), what(r), t(r);
+        X p(r), phat(r), s(r), shat(r), z(r), zhat(r);
+        X q(r), qhat(r), y(r), v(r);
+
+        rhat = 0.0;
+        prec_.apply(rhat, r);
+        op_.apply(rhat, w);
+        dots_->start({{&r, &r}, {&r, &w}});
+        what = 0.0;
+        prec_.apply(what, w);
+        op_.apply(what, t);
+        const auto& d0 = dots_->wait();
+        field_type rho = d0[0];
+        const field_type rtw = d0[1];
+
+        const real_type def0 = std::sqrt(std::abs(rho));
+        real_type def = def0;
+        if (verbose_ > 1) {
+            this->printHeader(std::cout);
+            this->printOutput(std::cout, 0, def0);
+        }
+        if (def0 == 0.0) {
+            prec_.post(x);
+            res.converged = true;
+            res.elapsed = watch.elapsed();
+            return;
+        }
+        if (std::abs(rtw) < EPSILON) {
+            DUNE_THROW(SolverAbort, "breakdown in pipelined BiCGSTAB - (r0, w0) = " << rtw);
+        }
+
+        field_type alpha = rho / rtw;
+        field_type beta = 0.0;
+        field_type omega = 0.0;
+        monitor_.start(def0);
+        auto status = KrylovMonitor::Status::Continue;
+        int it = 1;
+        for (; it <= maxit_; ++it) {
+            if (it == 1) {
+                p = r;
+                phat = rhat;
+                s = w;
+                shat = what;
+                z = t;
+            } else {
+                p.axpy(-omega, s);       p *= beta;    p += r;
+                phat.axpy(-omega, shat); phat *= beta; phat += rhat;
+                s.axpy(-omega, z);       s *= beta;    s += w;
+                shat.axpy(-omega, zhat); shat *= beta; shat += what;
+                z.axpy(-omega, v);       z *= beta;    z += t;
+            }
+            q = r;    q.axpy(-alpha, s);
+            qhat = rhat; qhat.axpy(-alpha, shat);
+            y = w;    y.axpy(-alpha, z);
+
+            // first reduction, overlapped with zhat = M^-1 z and v = A zhat
+            dots_->start({{&q, &y}, {&y, &y}});
+            zhat = 0.0;
+            prec_.apply(zhat, z);
+            op_.apply(zhat, v);
+            const auto& d1 = dots_->wait();
+            const field_type qy = d1[0];
+            const field_type yy = d1[1];
+            if (std::abs(yy) < EPSILON) {
+                DUNE_THROW(SolverAbort, "breakdown in pipelined BiCGSTAB - (y, y) = " << yy);
+            }
+            omega = qy / yy;
+
+            x.axpy(alpha, phat);
+            x.axpy(omega, qhat);
+            r = q;
+            r.axpy(-omega, y);
+            // rhat = qhat - omega * (what - alpha * zhat)
+            rhat = what; rhat.axpy(-alpha, zhat); rhat *= -omega; rhat += qhat;
+            // w = y - omega * (t - alpha * v)
+            w = t;       w.axpy(-alpha, v);       w *= -omega;    w += y;
+
+            // second reduction, overlapped with what = M^-1 w and t = A what
+            dots_->start({{&rt, &r}, {&rt, &w}, {&rt, &s}, {&rt, &z}, {&r, &r}});
+            what = 0.0;
+            prec_.apply(what, w);
+            op_.apply(what, t);
+            const auto& d2 = dots_->wait();
+            const field_type rho_new = d2[0];
+            const field_type rtw_new = d2[1];
+            const field_type rts = d2[2];
+            const field_type rtz = d2[3];
+            const real_type def_old = def;
+            def = std::sqrt(std::abs(d2[4]));
+
+            if (verbose_ > 1) {
+                this->printOutput(std::cout, it, def, def_old);
+            }
+            if (def < reduction * def0) {
+                res.converged = true;
+                break;
+            }
+            status = monitor_.check(it, def);
+            if (status != KrylovMonitor::Status::Continue) {
+                break;
+            }
+
+            if (std::abs(rho) < EPSILON || std::abs(omega) < EPSILON) {
+                DUNE_THROW(SolverAbort, "breakdown in pipelined BiCGSTAB - rho = " << rho << ", omega = " << omega);
+            }
+            beta = (alpha / omega) * (rho_new / rho);
+            const field_type denominator = rtw_new + beta * rts - beta * omega * rtz;
+            if (std::abs(denominator) < EPSILON) {
+                DUNE_THROW(SolverAbort, "breakdown in pipelined BiCGSTAB - (r0, w + beta * (s - omega * z)) = " << denominator);
+            }
+            alpha = rho_new / denominator;
+            rho = rho_new;
+        }
+
+        prec_.post(x);
+        res.iterations = std::min(it, maxit_);
+        res.reduction = def / def0;
+        res.conv_rate = std::pow(res.reduction, 1.0 / std::max(res.iterations, 1));
+        res.elapsed = watch.elapsed();
+        if (verbose_ > 0) {
+            std::cout << "=== rate=" << res.conv_rate
+                      << ", T=" << res.elapsed
+                      << ", TIT=" << res.elapsed / std::max(res.iterations, 1)
+                      << ", IT=" << res.iterations << std::endl;
+            if (status != KrylovMonitor::Status::Continue) {
+                std::cout << "=== stopped early, the iteration " << KrylovMonitor::name(status) << std::endl;
+            }
+        }
+    }
+
+    SolverCategory::Category category() const override
+    {
+        return op_.category();
+    }
+
+private:
+    LinearOperator<X, X>& op_;
+    Preconditioner<X, X>& prec_;
+    std::shared_ptr<NonblockingDots<X>> dots_;
+    real_type reduction_;
+    int maxit_;
+    int verbose_;
+    KrylovMonitor monitor_;
+};
+
+} // namespace Dune
+
+#endif // OPM_PIPELINED_BICGSTAB_SOLVER_HEADER_INCLUDED
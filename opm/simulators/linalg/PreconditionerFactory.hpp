@@ -22,10 +22,12 @@
 #ifndef OPM_PRECONDITIONERFACTORY_HEADER
 #define OPM_PRECONDITIONERFACTORY_HEADER
 
+#include <opm/simulators/linalg/AmgxPreconditioner.hpp>
 #include <opm/simulators/linalg/OwningBlockPreconditioner.hpp>
 #include <opm/simulators/linalg/OwningTwoLevelPreconditioner.hpp>
 #include <opm/simulators/linalg/ParallelOverlappingILU0.hpp>
 #include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
+#include <opm/simulators/linalg/SubdomainDirectPreconditioner.hpp>
 #include <opm/simulators/linalg/amgcpr.hh>
 
 #include <dune/istl/paamg/amg.hh>
@@ -181,6 +183,7 @@ private:
         smootherArgs.setN(iluwitdh);
         const MILU_VARIANT milu = convertString2Milu(prm.get<std::string>("milutype", std::string("ilu")));
         smootherArgs.setMilu(milu);
+        smootherArgs.setMixedPrecision(prm.get<bool>("mixed_precision", false));
         // smootherArgs.overlap=SmootherArgs::vertex;
         // smootherArgs.overlap=SmootherArgs::none;
         // smootherArgs.overlap=SmootherArgs::aggregate;
@@ -230,20 +233,49 @@ private:
     }
 
     static PrecPtr
-    createParILU(const Operator& op, const boost::property_tree::ptree& prm, const Comm& comm, const int ilulevel)
+    createParILU(const Operator& op, const boost::property_tree::ptree& prm, const Comm& comm, const int ilulevel,
+                 const double ilut_threshold = 0.0)
     {
         const double w = prm.get<double>("relaxation", 1.0);
         const bool redblack = prm.get<bool>("redblack", false);
         const bool reorder_spheres = prm.get<bool>("reorder_spheres", false);
+        const bool level_scheduling = prm.get<bool>("level_scheduling", false);
+        const bool mixed_precision = prm.get<bool>("mixed_precision", false);
+        const bool cuthill_mckee = prm.get<bool>("cuthill_mckee", false);
         // Already a parallel preconditioner. Need to pass comm, but no need to wrap it in a BlockPreconditioner.
-        if (ilulevel == 0) {
+        // Switched off when the operator exchanges the halo itself.
+        const bool copy_owner_to_all = prm.get<bool>("copy_owner_to_all", true);
+        using ParILU = Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm>;
+        const int ilut_fill = prm.get<int>("fill", 5);
+        std::shared_ptr<ParILU> prec;
+        if (ilulevel == 0 && ilut_threshold <= 0.0) {
             const size_t num_interior = interiorIfGhostLast(comm);
-            return std::make_shared<Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm>>(
-                op.getmat(), comm, w, Opm::MILU_VARIANT::ILU, num_interior, redblack, reorder_spheres);
+            prec = std::make_shared<ParILU>(
+                op.getmat(), comm, w, Opm::MILU_VARIANT::ILU, num_interior, redblack, reorder_spheres, level_scheduling,
+                mixed_precision, cuthill_mckee);
         } else {
-            return std::make_shared<Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Comm>>(
-                op.getmat(), comm, ilulevel, w, Opm::MILU_VARIANT::ILU, redblack, reorder_spheres);
+            prec = std::make_shared<ParILU>(
+                op.getmat(), comm, ilulevel, w, Opm::MILU_VARIANT::ILU, redblack, reorder_spheres, level_scheduling,
+                mixed_precision, ilut_threshold, ilut_fill, cuthill_mckee);
         }
+        prec->setCopyOwnerToAll(copy_owner_to_all);
+        return prec;
+    }
+
+    static PrecPtr
+    createSeqILU(const Operator& op, const boost::property_tree::ptree& prm, const int ilulevel,
+                 const double ilut_threshold = 0.0)
+    {
+        const double w = prm.get<double>("relaxation", 1.0);
+        const bool redblack = prm.get<bool>("redblack", false);
+        const bool reorder_spheres = prm.get<bool>("reorder_spheres", false);
+        const bool level_scheduling = prm.get<bool>("level_scheduling", false);
+        const bool mixed_precision = prm.get<bool>("mixed_precision", false);
+        const int ilut_fill = prm.get<int>("fill", 5);
+        const bool cuthill_mckee = prm.get<bool>("cuthill_mckee", false);
+        return std::make_shared<Opm::ParallelOverlappingILU0<Matrix, Vector, Vector>>(
+            op.getmat(), ilulevel, w, Opm::MILU_VARIANT::ILU, redblack, reorder_spheres, level_scheduling,
+            mixed_precision, ilut_threshold, ilut_fill, cuthill_mckee);
     }
 
     // Add a useful default set of preconditioners to the factory.
@@ -267,6 +299,12 @@ private:
         doAddCreator("ILUn", [](const O& op, const P& prm, const std::function<Vector()>&, const C& comm) {
             return createParILU(op, prm, comm, prm.get<int>("ilulevel", 0));
         });
+        doAddCreator("ILUT", [](const O& op, const P& prm, const std::function<Vector()>&, const C& comm) {
+            return createParILU(op, prm, comm, 0, prm.get<double>("threshold", 1e-3));
+        });
+        doAddCreator("subdomain_direct", [](const O& op, const P& prm, const std::function<Vector()>&, const C& comm) {
+            return std::make_shared<Opm::SubdomainDirectPreconditioner<O, V, C>>(op, prm, comm, interiorIfGhostLast(comm));
+        });
         doAddCreator("Jac", [](const O& op, const P& prm, const std::function<Vector()>&,
                                const C& comm) {
             const int n = prm.get<int>("repeats", 1);
@@ -327,21 +365,19 @@ private:
         using V = Vector;
         using P = boost::property_tree::ptree;
         doAddCreator("ILU0", [](const O& op, const P& prm, const std::function<Vector()>&) {
-            const double w = prm.get<double>("relaxation", 1.0);
-            return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V>>(
-                op.getmat(), 0, w, Opm::MILU_VARIANT::ILU);
+            return createSeqILU(op, prm, 0);
         });
         doAddCreator("ParOverILU0", [](const O& op, const P& prm, const std::function<Vector()>&) {
-            const double w = prm.get<double>("relaxation", 1.0);
-            const int n = prm.get<int>("ilulevel", 0);
-            return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V>>(
-                op.getmat(), n, w, Opm::MILU_VARIANT::ILU);
+            return createSeqILU(op, prm, prm.get<int>("ilulevel", 0));
         });
         doAddCreator("ILUn", [](const O& op, const P& prm, const std::function<Vector()>&) {
-            const int n = prm.get<int>("ilulevel", 0);
-            const double w = prm.get<double>("relaxation", 1.0);
-            return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V>>(
-                op.getmat(), n, w, Opm::MILU_VARIANT::ILU);
+            return createSeqILU(op, prm, prm.get<int>("ilulevel", 0));
+        });
+        doAddCreator("ILUT", [](const O& op, const P& prm, const std::function<Vector()>&) {
+            return createSeqILU(op, prm, 0, prm.get<double>("threshold", 1e-3));
+        });
+        doAddCreator("subdomain_direct", [](const O& op, const P& prm, const std::function<Vector()>&) {
+            return std::make_shared<Opm::SubdomainDirectPreconditioner<O, V>>(op, prm);
         });
         doAddCreator("Jac", [](const O& op, const P& prm, const std::function<Vector()>&) {
             const int n = prm.get<int>("repeats", 1);
@@ -435,6 +471,14 @@ private:
                 parms.setNoPostSmoothSteps(1);
                 return wrapPreconditioner<Dune::Amg::FastAMG<O, V>>(op, crit, parms);
             });
+#if HAVE_AMGX
+            // e.g. for the pressure system of CPR, as coarsesolver.preconditioner
+            if constexpr (M::block_type::rows == 1) {
+                doAddCreator("amgx", [](const O& op, const P& prm, const std::function<Vector()>&) {
+                    return std::make_shared<Opm::AmgxPreconditioner<O, V>>(op, prm);
+                });
+            }
+#endif
         }
         doAddCreator("cpr", [](const O& op, const P& prm, const std::function<Vector()>& weightsCalculator) {
             return std::make_shared<OwningTwoLevelPreconditioner<O, V, false>>(op, prm, weightsCalculator);
@@ -21,6 +21,7 @@
 #define OPM_PRECONDITIONERWITHUPDATE_HEADER_INCLUDED
 
 #include <dune/istl/preconditioner.hh>
+#include <cstddef>
 #include <memory>
 #include <boost/property_tree/ptree.hpp>
 namespace Dune
@@ -32,6 +33,12 @@ class PreconditionerWithUpdate : public Preconditioner<X, Y>
 {
 public:
     virtual void update() = 0;
+
+    /// The bytes of the data stored by the preconditioner, 0 if not known.
+    virtual std::size_t memoryUsage() const
+    {
+        return 0;
+    }
 };
 
 template <class OriginalPreconditioner>
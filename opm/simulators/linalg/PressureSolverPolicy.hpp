@@ -95,11 +95,19 @@ namespace Amg
                 linsolver_->apply(x, b, res);
             }
 
+            /// Update the preconditioner of the pressure solver with the new
+            /// values of the coarse operator. An AMG keeps its aggregates and
+            /// only recomputes the Galerkin products of the coarser levels.
             void updatePreconditioner()
             {
                 linsolver_->preconditioner().update();
             }
 
+            std::size_t memoryUsage() const
+            {
+                return linsolver_->preconditioner().memoryUsage();
+            }
+
         private:
             std::unique_ptr<Solver> linsolver_;
         };
@@ -22,6 +22,7 @@
 #define OPM_PRESSURE_TRANSFER_POLICY_HEADER_INCLUDED
 
 
+#include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
 #include <opm/simulators/linalg/twolevelmethodcpr.hh>
 
 
@@ -37,11 +38,18 @@ public:
     typedef typename FineOperator::domain_type FineVectorType;
 
 public:
-    PressureTransferPolicy(const Communication& comm, const FineVectorType& weights, int pressure_var_index)
+    /// \param fuse_quasi_impes_weights  compute the quasi-IMPES weights of a row, stored
+    ///                                  in weights, right before its coarse row instead
+    ///                                  of in a separate pass over the matrix
+    PressureTransferPolicy(const Communication& comm, const FineVectorType& weights, int pressure_var_index,
+                           bool fuse_quasi_impes_weights = false)
         : communication_(&const_cast<Communication&>(comm))
         , weights_(weights)
         , pressure_var_index_(pressure_var_index)
+        , fusedWeights_(fuse_quasi_impes_weights ? &const_cast<FineVectorType&>(weights) : nullptr)
     {
+        // the coarse rows of the transposed system need the weights of the other rows
+        assert(!(transpose && fuse_quasi_impes_weights));
     }
 
     virtual void createCoarseLevelSystem(const FineOperator& fineOperator) override
@@ -75,13 +83,25 @@ public:
 
     virtual void calculateCoarseEntries(const FineOperator& fineOperator) override
     {
+        using VectorBlockType = typename FineVectorType::block_type;
         const auto& fineMatrix = fineOperator.getmat();
-        *coarseLevelMatrix_ = 0;
-        auto rowCoarse = coarseLevelMatrix_->begin();
-        for (auto row = fineMatrix.begin(), rowEnd = fineMatrix.end(); row != rowEnd; ++row, ++rowCoarse) {
-            assert(row.index() == rowCoarse.index());
-            auto entryCoarse = rowCoarse->begin();
-            for (auto entry = row->begin(), entryEnd = row->end(); entry != entryEnd; ++entry, ++entryCoarse) {
+        auto& coarseMatrix = *coarseLevelMatrix_;
+        assert(fineMatrix.N() == coarseMatrix.N());
+        // The coarse matrix has the sparsity pattern of the fine matrix, so
+        // the rows are independent and can be computed concurrently.
+        const int numRows = fineMatrix.N();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            const auto& row = fineMatrix[rowIdx];
+            if (!transpose && fusedWeights_) {
+                (*fusedWeights_)[rowIdx] = Amg::getQuasiImpesRowWeights<VectorBlockType>(
+                    row, rowIdx, pressure_var_index_, /*transpose=*/false);
+            }
+            auto& rowCoarse = coarseMatrix[rowIdx];
+            auto entryCoarse = rowCoarse.begin();
+            for (auto entry = row.begin(), entryEnd = row.end(); entry != entryEnd; ++entry, ++entryCoarse) {
                 assert(entry.index() == entryCoarse.index());
                 double matrix_el = 0;
                 if (transpose) {
@@ -90,15 +110,15 @@ public:
                         matrix_el += (*entry)[pressure_var_index_][i] * bw[i];
                     }
                 } else {
-                    const auto& bw = weights_[row.index()];
+                    const auto& bw = weights_[rowIdx];
                     for (size_t i = 0; i < bw.size(); ++i) {
                         matrix_el += (*entry)[i][pressure_var_index_] * bw[i];
                     }
                 }
                 (*entryCoarse) = matrix_el;
             }
+            assert(entryCoarse == rowCoarse.end());
         }
-        assert(rowCoarse == coarseLevelMatrix_->end());
     }
 
     virtual void moveToCoarseLevel(const typename ParentType::FineRangeType& fine) override
@@ -106,19 +126,22 @@ public:
         // Set coarse vector to zero
         this->rhs_ = 0;
 
-        auto end = fine.end(), begin = fine.begin();
-
-        for (auto block = begin; block != end; ++block) {
-            const auto& bw = weights_[block.index()];
+        const int numBlocks = fine.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int blockIdx = 0; blockIdx < numBlocks; ++blockIdx) {
+            const auto& block = fine[blockIdx];
+            const auto& bw = weights_[blockIdx];
             double rhs_el = 0.0;
             if (transpose) {
-                rhs_el = (*block)[pressure_var_index_];
+                rhs_el = block[pressure_var_index_];
             } else {
-                for (size_t i = 0; i < block->size(); ++i) {
-                    rhs_el += (*block)[i] * bw[i];
+                for (size_t i = 0; i < block.size(); ++i) {
+                    rhs_el += block[i] * bw[i];
                 }
             }
-            this->rhs_[block - begin] = rhs_el;
+            this->rhs_[blockIdx] = rhs_el;
         }
 
         this->lhs_ = 0;
@@ -126,16 +149,19 @@ public:
 
     virtual void moveToFineLevel(typename ParentType::FineDomainType& fine) override
     {
-        auto end = fine.end(), begin = fine.begin();
-
-        for (auto block = begin; block != end; ++block) {
+        const int numBlocks = fine.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int blockIdx = 0; blockIdx < numBlocks; ++blockIdx) {
+            auto& block = fine[blockIdx];
             if (transpose) {
-                const auto& bw = weights_[block.index()];
-                for (size_t i = 0; i < block->size(); ++i) {
-                    (*block)[i] = this->lhs_[block - begin] * bw[i];
+                const auto& bw = weights_[blockIdx];
+                for (size_t i = 0; i < block.size(); ++i) {
+                    block[i] = this->lhs_[blockIdx] * bw[i];
                 }
             } else {
-                (*block)[pressure_var_index_] = this->lhs_[block - begin];
+                block[pressure_var_index_] = this->lhs_[blockIdx];
             }
         }
     }
@@ -154,6 +180,7 @@ private:
     Communication* communication_;
     const FineVectorType& weights_;
     const int pressure_var_index_;
+    FineVectorType* fusedWeights_;
     std::shared_ptr<Communication> coarseLevelCommunication_;
     std::shared_ptr<typename CoarseOperator::matrix_type> coarseLevelMatrix_;
 };
@@ -0,0 +1,257 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_RECYCLING_GCRO_SOLVER_HEADER_INCLUDED
+#define OPM_RECYCLING_GCRO_SOLVER_HEADER_INCLUDED
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solver.hh>
+
+#include <opm/simulators/linalg/KrylovMonitor.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace Dune
+{
+
+/// Restarted, flexible GCR with a recycled subspace, in the spirit of GCRO-DR:
+///    M. L. Parks, E. de Sturler et al., "Recycling Krylov subspaces for sequences of linear systems",
+///    SIAM J. Sci. Comput. 28(5), 2006, https://doi.org/10.1137/040607277
+/// The solver keeps the search directions u_j that contributed most to the solution of the
+/// previous solve. At the start of the next solve, C = A * U is recomputed and orthonormalized
+/// for the current matrix, the solution is corrected by the projection of the residual onto C,
+/// and the GCR directions are kept orthogonal to C. Consecutive Newton systems are closely
+/// related, so this removes the slowest converging components up front.
+/// Instead of harmonic Ritz vectors, the recycled directions are selected by the size of
+/// their coefficient in the solution, which needs no extra eigenvalue problem.
+/// Flexible GCR allows a preconditioner that changes between iterations and solves.
+template <class X>
+class RecyclingGCROSolver : public InverseOperator<X, X>
+{
+public:
+    using field_type = typename X::field_type;
+    using real_type = typename FieldTraits<field_type>::real_type;
+
+    RecyclingGCROSolver(LinearOperator<X, X>& op,
+                        ScalarProduct<X>& sp,
+                        Preconditioner<X, X>& prec,
+                        real_type reduction,
+                        int restart,
+                        int recycle,
+                        int maxit,
+                        int verbose,
+                        const KrylovMonitor& monitor = KrylovMonitor())
+        : op_(op)
+        , sp_(sp)
+        , prec_(prec)
+        , reduction_(reduction)
+        , restart_(std::max(restart, 1))
+        , recycle_(std::max(recycle, 0))
+        , maxit_(maxit)
+        , verbose_(verbose)
+        , monitor_(monitor)
+    {
+    }
+
+    void apply(X& x, X& b, InverseOperatorResult& res) override
+    {
+        apply(x, b, reduction_, res);
+    }
+
+    /// Solve A x = b, b is overwritten by the residual, like the Dune solvers do.
+    void apply(X& x, X& b, double reduction, InverseOperatorResult& res) override
+    {
+        res.clear();
+        Timer watch;
+
+        X& r = b;
+        op_.applyscaleadd(-1.0, x, r);  // r = b - A * x
+        prec_.pre(x, r);
+
+        const real_type def0 = sp_.norm(r);
+        real_type def = def0;
+        if (verbose_ > 1) {
+            this->printHeader(std::cout);
+            this->printOutput(std::cout, 0, def0);
+        }
+        if (def0 == 0.0) {
+            prec_.post(x);
+            res.converged = true;
+            res.elapsed = watch.elapsed();
+            return;
+        }
+
+        // directions of this solve, the first ones are the recycled directions
+        std::vector<X> U, C;
+        // candidates for the next solve, with the size of their coefficient
+        std::vector<std::pair<real_type, X>> candidates;
+
+        // recompute C = A * U for the current matrix, and orthonormalize it
+        for (X& u : recycled_) {
+            if (u.size() != r.size()) {
+                continue;
+            }
+            X c(r);
+            op_.apply(u, c);
+            if (orthonormalize(U, C, u, c)) {
+                const field_type alpha = sp_.dot(C.back(), r);
+                x.axpy(alpha, U.back());
+                r.axpy(-alpha, C.back());
+                addCandidate(candidates, std::abs(alpha), U.back());
+            }
+        }
+        recycled_.clear();
+        const std::size_t num_recycled = U.size();
+        if (num_recycled > 0) {
+            def = sp_.norm(r);
+        }
+
+        monitor_.start(def0);
+        auto status = KrylovMonitor::Status::Continue;
+        int it = 0;
+        while (def >= reduction * def0 && it < maxit_) {
+            if (U.size() == num_recycled + restart_) {
+                // restart, the recycled directions are kept
+                U.resize(num_recycled);
+                C.resize(num_recycled);
+            }
+
+            X z(r), c(r);
+            z = 0.0;
+            prec_.apply(z, r);
+            op_.apply(z, c);
+            if (!orthonormalize(U, C, z, c)) {
+                // the new direction does not add anything, stagnation
+                break;
+            }
+            const field_type alpha = sp_.dot(C.back(), r);
+            x.axpy(alpha, U.back());
+            r.axpy(-alpha, C.back());
+            addCandidate(candidates, std::abs(alpha), U.back());
+
+            ++it;
+            const real_type def_old = def;
+            def = sp_.norm(r);
+            if (verbose_ > 1) {
+                this->printOutput(std::cout, it, def, def_old);
+            }
+            if (def >= reduction * def0) {
+                status = monitor_.check(it, def);
+                if (status != KrylovMonitor::Status::Continue) {
+                    break;
+                }
+            }
+        }
+
+        // the directions of a diverged solve are not worth keeping
+        if (status != KrylovMonitor::Status::Diverged) {
+            for (auto& candidate : candidates) {
+                recycled_.push_back(std::move(candidate.second));
+            }
+        }
+
+        prec_.post(x);
+        res.converged = def < reduction * def0;
+        res.iterations = it;
+        res.reduction = def / def0;
+        res.conv_rate = std::pow(res.reduction, 1.0 / std::max(it, 1));
+        res.elapsed = watch.elapsed();
+        if (verbose_ > 0) {
+            std::cout << "=== rate=" << res.conv_rate
+                      << ", T=" << res.elapsed
+                      << ", TIT=" << res.elapsed / std::max(it, 1)
+                      << ", IT=" << it
+                      << ", recycled=" << num_recycled << std::endl;
+            if (status != KrylovMonitor::Status::Continue) {
+                std::cout << "=== stopped early, the iteration " << KrylovMonitor::name(status) << std::endl;
+            }
+        }
+    }
+
+    SolverCategory::Category category() const override
+    {
+        return op_.category();
+    }
+
+private:
+    /// Orthonormalize c against C with modified Gram-Schmidt, applying the same operations to u,
+    /// and append both on success.
+    /// \return false if c is (numerically) in the span of C
+    bool orthonormalize(std::vector<X>& U, std::vector<X>& C, X& u, X& c)
+    {
+        const real_type norm_before = sp_.norm(c);
+        for (std::size_t j = 0; j < C.size(); ++j) {
+            const field_type beta = sp_.dot(C[j], c);
+            c.axpy(-beta, C[j]);
+            u.axpy(-beta, U[j]);
+        }
+        const real_type norm = sp_.norm(c);
+        if (norm <= 1e-12 * norm_before || norm == 0.0) {
+            return false;
+        }
+        c *= 1.0 / norm;
+        u *= 1.0 / norm;
+        U.push_back(u);
+        C.push_back(c);
+        return true;
+    }
+
+    /// Keep the recycle_ directions with the largest coefficients.
+    void addCandidate(std::vector<std::pair<real_type, X>>& candidates, real_type weight, const X& u)
+    {
+        if (recycle_ == 0) {
+            return;
+        }
+        if (static_cast<int>(candidates.size()) < recycle_) {
+            candidates.emplace_back(weight, u);
+            return;
+        }
+        auto smallest = std::min_element(candidates.begin(), candidates.end(),
+                                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        if (smallest->first < weight) {
+            smallest->first = weight;
+            smallest->second = u;
+        }
+    }
+
+    LinearOperator<X, X>& op_;
+    ScalarProduct<X>& sp_;
+    Preconditioner<X, X>& prec_;
+    real_type reduction_;
+    int restart_;
+    int recycle_;
+    int maxit_;
+    int verbose_;
+    KrylovMonitor monitor_;
+    std::vector<X> recycled_;  // directions kept from the previous solve
+};
+
+} // namespace Dune
+
+#endif // OPM_RECYCLING_GCRO_SOLVER_HEADER_INCLUDED
@@ -0,0 +1,239 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SEQUENTIALIMPLICITSOLVER_HEADER_INCLUDED
+#define OPM_SEQUENTIALIMPLICITSOLVER_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/PressureTransferPolicy.hpp>
+#include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/paamg/amg.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// Computes the Newton update of a linearized system sequentially: first the
+/// pressure from the quasi-IMPES pressure system of the CPR preconditioner,
+/// then the transport with the pressure update fixed, by one block
+/// Gauss-Seidel sweep over the cells ordered by decreasing pressure, i.e.
+/// roughly from upstream to downstream.
+///
+/// In contrast to the fully implicit linear solve, the pressure system is
+/// solved once and the transport is only iterated locally, the outer Newton
+/// iterations of the fully implicit residual make the solution consistent.
+/// The transport of the refined cells, e.g. the ones around wells where the
+/// throughput is high, gets additional sweeps restricted to them.
+/// Only for serial runs whose matrix contains the well contributions.
+template <class Matrix, class Vector>
+class SequentialImplicitSolver
+{
+public:
+    using CoarseMatrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+    using CoarseVector = Dune::BlockVector<Dune::FieldVector<double, 1>>;
+    using FineOperator = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+    using CoarseOperator = Dune::MatrixAdapter<CoarseMatrix, CoarseVector, CoarseVector>;
+    using Communication = Dune::Amg::SequentialInformation;
+    using TransferPolicy = PressureTransferPolicy<FineOperator, CoarseOperator, Communication>;
+
+    /// \param pressureVarIndex   the index of the pressure in the blocks
+    /// \param pressureTolerance  the relative residual reduction of the pressure solve
+    /// \param pressureMaxIter    the maximum number of iterations of the pressure solve
+    SequentialImplicitSolver(int pressureVarIndex, double pressureTolerance, int pressureMaxIter)
+        : pressureVarIndex_(pressureVarIndex)
+        , pressureTolerance_(pressureTolerance)
+        , pressureMaxIter_(pressureMaxIter)
+    {
+    }
+
+    /// Set the cells whose transport gets additional sweeps.
+    /// \param refined  nonzero for the refined cells
+    /// \param sweeps   the number of additional sweeps, 0 for none
+    void setRefinedCells(std::vector<char> refined, int sweeps)
+    {
+        refined_ = std::move(refined);
+        refinementSweeps_ = sweeps;
+    }
+
+    /// Compute the update x of A x = r.
+    /// \param pressures  the current pressures of the cells, the update is
+    ///                   subtracted from them like in ebos
+    void solve(const Matrix& A, const Vector& r, const std::vector<double>& pressures, Vector& x)
+    {
+        x.resize(r.size());
+        x = 0.0;
+
+        Dune::Timer timer;
+        timer.start();
+        solvePressure_(A, r, x);
+        pressureTime_ = timer.stop();
+
+        timer.reset();
+        timer.start();
+        solveTransport_(A, r, pressures, x);
+        transportTime_ = timer.stop();
+    }
+
+    int pressureIterations() const
+    { return pressureIterations_; }
+
+    double pressureTime() const
+    { return pressureTime_; }
+
+    double transportTime() const
+    { return transportTime_; }
+
+private:
+    void solvePressure_(const Matrix& A, const Vector& r, Vector& x)
+    {
+        weights_.resize(A.N());
+        Amg::getQuasiImpesWeights(A, pressureVarIndex_, /*transpose=*/false, weights_);
+
+        FineOperator fineOperator(A);
+        const bool patternChanged = !transfer_ || patternRows_ != A.N() || patternNonzeroes_ != A.nonzeroes();
+        if (patternChanged) {
+            transfer_ = std::make_unique<TransferPolicy>(comm_, weights_, pressureVarIndex_);
+            transfer_->createCoarseLevelSystem(fineOperator);
+            patternRows_ = A.N();
+            patternNonzeroes_ = A.nonzeroes();
+        } else {
+            transfer_->calculateCoarseEntries(fineOperator);
+        }
+        transfer_->moveToCoarseLevel(r);
+
+        using Smoother = Dune::SeqSSOR<CoarseMatrix, CoarseVector, CoarseVector>;
+        using Criterion = Dune::Amg::CoarsenCriterion<
+            Dune::Amg::SymmetricCriterion<CoarseMatrix, Dune::Amg::FirstDiagonal>>;
+        using AMG = Dune::Amg::AMG<CoarseOperator, CoarseVector, Smoother, Communication>;
+
+        typename Dune::Amg::SmootherTraits<Smoother>::Arguments smootherArgs;
+        smootherArgs.iterations = 1;
+        smootherArgs.relaxationFactor = 1.0;
+        Criterion criterion;
+        criterion.setDefaultValuesIsotropic(2);
+        criterion.setCoarsenTarget(1200);
+
+        auto& coarseOperator = *transfer_->getCoarseLevelOperator();
+        AMG amg(coarseOperator, criterion, smootherArgs, comm_);
+        Dune::BiCGSTABSolver<CoarseVector> solver(coarseOperator, amg, pressureTolerance_,
+                                                  pressureMaxIter_, /*verbose=*/0);
+        Dune::InverseOperatorResult result;
+        auto rhs = transfer_->getCoarseLevelRhs();
+        solver.apply(transfer_->getCoarseLevelLhs(), rhs, result);
+        pressureIterations_ = result.iterations;
+
+        transfer_->moveToFineLevel(x);
+    }
+
+    void solveTransport_(const Matrix& A, const Vector& r, const std::vector<double>& pressures, Vector& x)
+    {
+        // the residual left by the pressure update
+        Vector rhs(r);
+        A.mmv(x, rhs);
+
+        const std::size_t numCells = A.N();
+        std::vector<std::size_t> order(numCells);
+        std::iota(order.begin(), order.end(), 0);
+        auto newPressure = [&pressures, &x, this](std::size_t cell)
+        {
+            return pressures[cell] - x[cell][pressureVarIndex_];
+        };
+        std::stable_sort(order.begin(), order.end(),
+                         [&newPressure](std::size_t c1, std::size_t c2)
+                         {
+                             return newPressure(c1) > newPressure(c2);
+                         });
+
+        Vector dx(numCells);
+        dx = 0.0;
+        std::vector<char> done(numCells, 0);
+        for (const auto cell : order) {
+            auto b = rhs[cell];
+            const typename Matrix::block_type* diagonal = nullptr;
+            const auto& row = A[cell];
+            for (auto col = row.begin(); col != row.end(); ++col) {
+                if (col.index() == cell) {
+                    diagonal = &(*col);
+                } else if (done[col.index()]) {
+                    col->mmv(dx[col.index()], b);
+                }
+            }
+            if (diagonal != nullptr) {
+                diagonal->solve(dx[cell], b);
+            }
+            done[cell] = 1;
+        }
+
+        // Gauss-Seidel sweeps over the refined cells only, in the same order
+        const bool refine = refinementSweeps_ > 0 && refined_.size() == numCells;
+        for (int sweep = 0; refine && sweep < refinementSweeps_; ++sweep) {
+            for (const auto cell : order) {
+                if (!refined_[cell]) {
+                    continue;
+                }
+                auto b = rhs[cell];
+                const typename Matrix::block_type* diagonal = nullptr;
+                const auto& row = A[cell];
+                for (auto col = row.begin(); col != row.end(); ++col) {
+                    if (col.index() == cell) {
+                        diagonal = &(*col);
+                    } else {
+                        col->mmv(dx[col.index()], b);
+                    }
+                }
+                if (diagonal != nullptr) {
+                    diagonal->solve(dx[cell], b);
+                }
+            }
+        }
+        x += dx;
+    }
+
+    int pressureVarIndex_;
+    double pressureTolerance_;
+    int pressureMaxIter_;
+    std::vector<char> refined_;
+    int refinementSweeps_ = 0;
+    Communication comm_;
+    Vector weights_;
+    std::unique_ptr<TransferPolicy> transfer_;
+    std::size_t patternRows_ = 0;
+    std::size_t patternNonzeroes_ = 0;
+    int pressureIterations_ = 0;
+    double pressureTime_ = 0.0;
+    double transportTime_ = 0.0;
+};
+
+} // namespace Opm
+
+#endif // OPM_SEQUENTIALIMPLICITSOLVER_HEADER_INCLUDED
@@ -0,0 +1,196 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SMALL_BLOCK_KERNELS_HEADER_INCLUDED
+#define OPM_SMALL_BLOCK_KERNELS_HEADER_INCLUDED
+
+#include <cmath>
+#include <utility>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#define OPM_HAVE_SIMD_BLOCK_KERNELS 1
+#include <immintrin.h>
+#else
+#define OPM_HAVE_SIMD_BLOCK_KERNELS 0
+#endif
+
+namespace Opm
+{
+namespace Detail
+{
+namespace Simd
+{
+    //! Hand vectorized kernels for row-major 3x3 and 4x4 blocks of doubles.
+    //! One row of a block fits into one AVX2 register, 3x3 rows are loaded
+    //! with a mask so that no memory after the block is touched.
+    //! The kernels are only available if the code is compiled with AVX2 and FMA,
+    //! wider registers do not help for rows of at most 4 entries.
+    constexpr bool available = OPM_HAVE_SIMD_BLOCK_KERNELS;
+
+#if OPM_HAVE_SIMD_BLOCK_KERNELS
+    template <int n>
+    inline __m256d load(const double* p)
+    {
+        if constexpr (n == 4) {
+            return _mm256_loadu_pd(p);
+        } else {
+            return _mm256_maskload_pd(p, _mm256_setr_epi64x(-1, -1, -1, 0));
+        }
+    }
+
+    template <int n>
+    inline void store(double* p, __m256d v)
+    {
+        if constexpr (n == 4) {
+            _mm256_storeu_pd(p, v);
+        } else {
+            _mm256_maskstore_pd(p, _mm256_setr_epi64x(-1, -1, -1, 0), v);
+        }
+    }
+
+    //! returns (A * x) for a row-major n x n block, n = 3 or 4
+    template <int n>
+    inline __m256d product(const double* A, __m256d x)
+    {
+        const __m256d t0 = _mm256_mul_pd(load<n>(A), x);
+        const __m256d t1 = _mm256_mul_pd(load<n>(A + n), x);
+        const __m256d t2 = _mm256_mul_pd(load<n>(A + 2 * n), x);
+        __m256d t3 = _mm256_setzero_pd();
+        if constexpr (n == 4) {
+            t3 = _mm256_mul_pd(load<n>(A + 3 * n), x);
+        }
+        // horizontal sums of the four rows: [t0a+t0b, t1a+t1b, t0c+t0d, t1c+t1d]
+        const __m256d h01 = _mm256_hadd_pd(t0, t1);
+        const __m256d h23 = _mm256_hadd_pd(t2, t3);
+        return _mm256_add_pd(_mm256_permute2f128_pd(h01, h23, 0x20),
+                             _mm256_permute2f128_pd(h01, h23, 0x31));
+    }
+
+    //! y = A * x
+    template <int n>
+    inline void mv(const double* A, const double* x, double* y)
+    {
+        store<n>(y, product<n>(A, load<n>(x)));
+    }
+
+    //! y -= A * x
+    template <int n>
+    inline void mmv(const double* A, const double* x, double* y)
+    {
+        store<n>(y, _mm256_sub_pd(load<n>(y), product<n>(A, load<n>(x))));
+    }
+
+    //! row i of A * B, rows of B are combined with the entries of row i of A
+    template <int n>
+    inline __m256d productRow(const double* Ai, const double* B)
+    {
+        __m256d row = _mm256_mul_pd(_mm256_broadcast_sd(Ai), load<n>(B));
+        for (int k = 1; k < n; ++k) {
+            row = _mm256_fmadd_pd(_mm256_broadcast_sd(Ai + k), load<n>(B + k * n), row);
+        }
+        return row;
+    }
+
+    //! C = A * B, C may be A or B
+    template <int n>
+    inline void matMul(const double* A, const double* B, double* C)
+    {
+        __m256d rows[n];
+        for (int i = 0; i < n; ++i) {
+            rows[i] = productRow<n>(A + i * n, B);
+        }
+        for (int i = 0; i < n; ++i) {
+            store<n>(C + i * n, rows[i]);
+        }
+    }
+
+    //! C -= A * B
+    template <int n>
+    inline void subtractProduct(const double* A, const double* B, double* C)
+    {
+        for (int i = 0; i < n; ++i) {
+            store<n>(C + i * n, _mm256_sub_pd(load<n>(C + i * n), productRow<n>(A + i * n, B)));
+        }
+    }
+
+    //! inverse = A^-1 by Gauss-Jordan elimination with partial pivoting,
+    //! every row operation is one fused multiply-add on the block and on the inverse.
+    //! \return false if a pivot is zero, inverse is undefined then
+    template <int n>
+    inline bool invert(const double* A, double* inverse)
+    {
+        __m256d a[n], b[n];
+        for (int i = 0; i < n; ++i) {
+            a[i] = load<n>(A + i * n);
+            b[i] = _mm256_setzero_pd();
+        }
+        alignas(32) double unit[4] = {0.0, 0.0, 0.0, 0.0};
+        for (int i = 0; i < n; ++i) {
+            unit[i] = 1.0;
+            b[i] = _mm256_load_pd(unit);
+            unit[i] = 0.0;
+        }
+
+        alignas(32) double column[n][4];
+        for (int k = 0; k < n; ++k) {
+            for (int i = k; i < n; ++i) {
+                _mm256_store_pd(column[i], a[i]);
+            }
+            int p = k;
+            for (int i = k + 1; i < n; ++i) {
+                if (std::abs(column[i][k]) > std::abs(column[p][k])) {
+                    p = i;
+                }
+            }
+            const double pivot = column[p][k];
+            if (pivot == 0.0) {
+                return false;
+            }
+            if (p != k) {
+                std::swap(a[p], a[k]);
+                std::swap(b[p], b[k]);
+            }
+            const __m256d scale = _mm256_set1_pd(1.0 / pivot);
+            a[k] = _mm256_mul_pd(a[k], scale);
+            b[k] = _mm256_mul_pd(b[k], scale);
+
+            for (int i = 0; i < n; ++i) {
+                _mm256_store_pd(column[i], a[i]);
+            }
+            for (int i = 0; i < n; ++i) {
+                if (i == k) {
+                    continue;
+                }
+                const __m256d factor = _mm256_set1_pd(-column[i][k]);
+                a[i] = _mm256_fmadd_pd(factor, a[k], a[i]);
+                b[i] = _mm256_fmadd_pd(factor, b[k], b[i]);
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            store<n>(inverse + i * n, b[i]);
+        }
+        return true;
+    }
+#endif // OPM_HAVE_SIMD_BLOCK_KERNELS
+
+} // namespace Simd
+} // namespace Detail
+} // namespace Opm
+
+#endif // OPM_SMALL_BLOCK_KERNELS_HEADER_INCLUDED
@@ -0,0 +1,364 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SUBDOMAINDIRECTPRECONDITIONER_HEADER_INCLUDED
+#define OPM_SUBDOMAINDIRECTPRECONDITIONER_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+// Circular dependency between PreconditionerFactory [which can make a SubdomainDirectPreconditioner]
+// and SubdomainDirectPreconditioner [which uses PreconditionerFactory to choose the global preconditioner]
+// must be broken, accomplished by forward-declaration here.
+template <class Operator, class Comm>
+class PreconditionerFactory;
+
+/// Store the seed cells of the subdomains in every preconditioner of type
+/// subdomain_direct of the tree, as the child "subdomains" with one entry of
+/// space separated local cell indices per subdomain. Returns true if the
+/// tree contains such a preconditioner.
+inline bool setSubdomainSeeds(boost::property_tree::ptree& prm,
+                              const std::vector<std::vector<int>>& seeds)
+{
+    bool found = false;
+    if (prm.get<std::string>("type", "") == "subdomain_direct") {
+        boost::property_tree::ptree subdomains;
+        for (const auto& cells : seeds) {
+            std::ostringstream os;
+            for (const int cell : cells) {
+                os << cell << ' ';
+            }
+            boost::property_tree::ptree entry;
+            entry.put_value(os.str());
+            subdomains.push_back({"", entry});
+        }
+        prm.erase("subdomains");
+        prm.add_child("subdomains", subdomains);
+        found = true;
+    }
+    for (auto& child : prm) {
+        if (child.first != "subdomains") {
+            found = setSubdomainSeeds(child.second, seeds) || found;
+        }
+    }
+    return found;
+}
+
+/// Return true if the tree contains a preconditioner of type subdomain_direct.
+inline bool hasSubdomainPreconditioner(const boost::property_tree::ptree& prm)
+{
+    if (prm.get<std::string>("type", "") == "subdomain_direct") {
+        return true;
+    }
+    return std::any_of(prm.begin(), prm.end(),
+                       [](const auto& child) { return hasSubdomainPreconditioner(child.second); });
+}
+
+/// A preconditioner which improves a global preconditioner, ILU0 by
+/// default, with exact solves on small subdomains, e.g. the cells around
+/// the wells where ILU0 struggles. After the global preconditioner is
+/// applied, the residual on each subdomain is computed and corrected with
+/// the inverse of the matrix restricted to the subdomain, as one step of
+/// block Jacobi over the subdomains.
+///
+/// The subdomains are grown from their seed cells by a number of layers of
+/// neighbours in the matrix graph, and subdomains which overlap are merged.
+/// Since they are small, the subdomain matrices are inverted as dense
+/// matrices. The inverses are kept for a number of updates, i.e. across
+/// Newton iterations, while the global preconditioner is updated every time.
+///
+/// Parameters:
+///   smoother            the global preconditioner (default ParOverILU0)
+///   subdomains          the seed cells, see setSubdomainSeeds()
+///   overlap             the layers of neighbours added to the seeds (default 1)
+///   max_cells           larger subdomains are not solved (default 200)
+///   refactor_interval   the number of updates between the inversions (default 5)
+///   copy_owner_to_all   make the result consistent in parallel (default true)
+template <class OperatorType, class VectorType, class Communication = Dune::Amg::SequentialInformation>
+class SubdomainDirectPreconditioner : public Dune::PreconditionerWithUpdate<VectorType, VectorType>
+{
+public:
+    using pt = boost::property_tree::ptree;
+    using MatrixType = typename OperatorType::matrix_type;
+    using PrecFactory = PreconditionerFactory<OperatorType, Communication>;
+    using field_type = typename VectorType::field_type;
+    static constexpr int blockSize = VectorType::block_type::dimension;
+
+    SubdomainDirectPreconditioner(const OperatorType& linearoperator, const pt& prm)
+        : linear_operator_(linearoperator)
+        , smoother_(PrecFactory::create(linearoperator, smootherPrm(prm)))
+        , comm_(nullptr)
+    {
+        init(prm, linearoperator.getmat().N());
+    }
+
+    /// \param interiorSize The number of rows before the ghost rows, which
+    ///                     are not part of any subdomain.
+    SubdomainDirectPreconditioner(const OperatorType& linearoperator, const pt& prm,
+                                  const Communication& comm, const std::size_t interiorSize)
+        : linear_operator_(linearoperator)
+        , smoother_(PrecFactory::create(linearoperator, smootherPrm(prm), comm))
+        , comm_(&comm)
+    {
+        init(prm, interiorSize);
+    }
+
+    virtual void pre(VectorType& x, VectorType& b) override
+    {
+        smoother_->pre(x, b);
+    }
+
+    virtual void apply(VectorType& v, const VectorType& d) override
+    {
+        smoother_->apply(v, d);
+
+        // the residuals of all subdomains before any correction
+        const auto& A = linear_operator_.getmat();
+        for (std::size_t s = 0; s < subdomains_.size(); ++s) {
+            auto& r = residuals_[s];
+            const auto& cells = subdomains_[s];
+            for (std::size_t p = 0; p < cells.size(); ++p) {
+                auto rc = d[cells[p]];
+                const auto& row = A[cells[p]];
+                for (auto col = row.begin(), cend = row.end(); col != cend; ++col) {
+                    col->mmv(v[col.index()], rc);
+                }
+                for (int b = 0; b < blockSize; ++b) {
+                    r[p * blockSize + b] = rc[b];
+                }
+            }
+        }
+
+        for (std::size_t s = 0; s < subdomains_.size(); ++s) {
+            const auto& cells = subdomains_[s];
+            auto& correction = corrections_[s];
+            inverses_[s].mv(residuals_[s], correction);
+            for (std::size_t p = 0; p < cells.size(); ++p) {
+                for (int b = 0; b < blockSize; ++b) {
+                    v[cells[p]][b] += correction[p * blockSize + b];
+                }
+            }
+        }
+
+        if (comm_ && copyOwnerToAll_) {
+            comm_->copyOwnerToAll(v, v);
+        }
+    }
+
+    virtual void post(VectorType& x) override
+    {
+        smoother_->post(x);
+    }
+
+    virtual void update() override
+    {
+        smoother_->update();
+        if (++updatesSinceFactorization_ >= refactorInterval_) {
+            factorize();
+        }
+    }
+
+    virtual std::size_t memoryUsage() const override
+    {
+        std::size_t bytes = smoother_->memoryUsage();
+        for (std::size_t s = 0; s < subdomains_.size(); ++s) {
+            bytes += subdomains_[s].capacity() * sizeof(std::size_t)
+                + inverses_[s].N() * inverses_[s].M() * sizeof(field_type)
+                + (residuals_[s].size() + corrections_[s].size()) * sizeof(field_type);
+        }
+        return bytes;
+    }
+
+    virtual Dune::SolverCategory::Category category() const override
+    {
+        return linear_operator_.category();
+    }
+
+    /// The cells of the subdomains which are solved.
+    const std::vector<std::vector<std::size_t>>& subdomains() const
+    {
+        return subdomains_;
+    }
+
+private:
+    static pt smootherPrm(const pt& prm)
+    {
+        auto child = prm.get_child_optional("smoother");
+        return child ? *child : pt();
+    }
+
+    void init(const pt& prm, const std::size_t interiorSize)
+    {
+        const auto& A = linear_operator_.getmat();
+        const int overlap = prm.get<int>("overlap", 1);
+        const std::size_t maxCells = prm.get<std::size_t>("max_cells", 200);
+        refactorInterval_ = std::max(prm.get<int>("refactor_interval", 5), 1);
+        copyOwnerToAll_ = prm.get<bool>("copy_owner_to_all", true);
+
+        // grow the seeds by the layers of neighbours
+        const std::size_t numCells = std::min<std::size_t>(interiorSize, A.N());
+        std::vector<std::vector<std::size_t>> grown;
+        std::vector<int> mark(numCells, -1);
+        auto seeds = prm.get_child_optional("subdomains");
+        if (seeds) {
+            for (const auto& entry : *seeds) {
+                std::vector<std::size_t> cells;
+                std::istringstream is(entry.second.get_value<std::string>());
+                long cell;
+                while (is >> cell) {
+                    if (cell >= 0 && static_cast<std::size_t>(cell) < numCells && mark[cell] != int(grown.size())) {
+                        mark[cell] = grown.size();
+                        cells.push_back(cell);
+                    }
+                }
+                std::size_t layerBegin = 0;
+                for (int layer = 0; layer < overlap; ++layer) {
+                    const std::size_t layerEnd = cells.size();
+                    for (std::size_t i = layerBegin; i < layerEnd; ++i) {
+                        const auto& row = A[cells[i]];
+                        for (auto col = row.begin(), cend = row.end(); col != cend; ++col) {
+                            const std::size_t j = col.index();
+                            if (j < numCells && mark[j] != int(grown.size())) {
+                                mark[j] = grown.size();
+                                cells.push_back(j);
+                            }
+                        }
+                    }
+                    layerBegin = layerEnd;
+                }
+                grown.push_back(std::move(cells));
+            }
+        }
+
+        // merge the subdomains which share cells
+        std::vector<std::size_t> parent(grown.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        auto root = [&parent](std::size_t s)
+        {
+            while (parent[s] != s) {
+                s = parent[s] = parent[parent[s]];
+            }
+            return s;
+        };
+        std::vector<int> owner(numCells, -1);
+        for (std::size_t s = 0; s < grown.size(); ++s) {
+            for (const auto cell : grown[s]) {
+                if (owner[cell] < 0) {
+                    owner[cell] = s;
+                } else {
+                    parent[root(s)] = root(owner[cell]);
+                }
+            }
+        }
+        std::vector<std::vector<std::size_t>> merged(grown.size());
+        for (std::size_t cell = 0; cell < numCells; ++cell) {
+            if (owner[cell] >= 0) {
+                merged[root(owner[cell])].push_back(cell);
+            }
+        }
+        for (auto& cells : merged) {
+            if (!cells.empty() && cells.size() <= maxCells) {
+                subdomains_.push_back(std::move(cells));
+            }
+        }
+
+        inverses_.resize(subdomains_.size());
+        residuals_.resize(subdomains_.size());
+        corrections_.resize(subdomains_.size());
+        for (std::size_t s = 0; s < subdomains_.size(); ++s) {
+            const std::size_t m = subdomains_[s].size() * blockSize;
+            residuals_[s].resize(m);
+            corrections_[s].resize(m);
+        }
+        factorize();
+    }
+
+    void factorize()
+    {
+        const auto& A = linear_operator_.getmat();
+        std::vector<int> local(A.N(), -1);
+        for (std::size_t s = 0; s < subdomains_.size(); ++s) {
+            const auto& cells = subdomains_[s];
+            for (std::size_t p = 0; p < cells.size(); ++p) {
+                local[cells[p]] = p;
+            }
+            const std::size_t m = cells.size() * blockSize;
+            auto& dense = inverses_[s];
+            dense.resize(m, m);
+            dense = 0.0;
+            for (std::size_t p = 0; p < cells.size(); ++p) {
+                const auto& row = A[cells[p]];
+                for (auto col = row.begin(), cend = row.end(); col != cend; ++col) {
+                    const int q = local[col.index()];
+                    if (q < 0) {
+                        continue;
+                    }
+                    for (int a = 0; a < blockSize; ++a) {
+                        for (int b = 0; b < blockSize; ++b) {
+                            dense[p * blockSize + a][q * blockSize + b] = (*col)[a][b];
+                        }
+                    }
+                }
+            }
+            try {
+                dense.invert();
+            }
+            catch (Dune::FMatrixError&) {
+                DUNE_THROW(Dune::MatrixBlockError, "Singular matrix of a subdomain of " << cells.size() << " cells");
+            }
+            for (const auto cell : cells) {
+                local[cell] = -1;
+            }
+        }
+        updatesSinceFactorization_ = 0;
+    }
+
+    const OperatorType& linear_operator_;
+    std::shared_ptr<Dune::PreconditionerWithUpdate<VectorType, VectorType>> smoother_;
+    const Communication* comm_;
+    std::vector<std::vector<std::size_t>> subdomains_;
+    // the explicit inverses of the subdomain matrices
+    std::vector<Dune::DynamicMatrix<field_type>> inverses_;
+    std::vector<Dune::DynamicVector<field_type>> residuals_;
+    std::vector<Dune::DynamicVector<field_type>> corrections_;
+    int refactorInterval_ = 5;
+    int updatesSinceFactorization_ = 0;
+    bool copyOwnerToAll_ = true;
+};
+
+} // namespace Opm
+
+#endif // OPM_SUBDOMAINDIRECTPRECONDITIONER_HEADER_INCLUDED
@@ -24,6 +24,17 @@
 
 #include <dune/istl/operators.hh>
 
+#include <opm/simulators/utils/PerfCounters.hpp>
+
+#if HAVE_MPI
+#include <opm/simulators/linalg/HaloExchange.hpp>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
 
 namespace Opm
 {
@@ -36,6 +47,21 @@ namespace Opm
 // and subsequently modified.
 //=====================================================================
 
+namespace detail
+{
+
+/// The bytes a sparse matrix vector product reads and writes at least: the
+/// blocks with their column indices, the input and the output.
+template <class M, class X>
+double spmvMemoryTraffic(const M& A, const X& x)
+{
+    return A.nonzeroes() * double(sizeof(typename M::block_type) + sizeof(typename M::size_type))
+        + A.N() * double(sizeof(typename M::size_type))
+        + 2.0 * x.size() * sizeof(typename X::block_type);
+}
+
+} // namespace detail
+
 /// Linear operator wrapper for well model.
 ///
 /// This class is intended to hide the actual type of the well model
@@ -126,6 +152,7 @@ public:
 
   virtual void apply( const X& x, Y& y ) const override
   {
+    OPM_PERF_SCOPE("spmv", detail::spmvMemoryTraffic(A_, x));
     A_.mv( x, y );
 
     // add well model modification to y
@@ -199,6 +226,7 @@ public:
 
     virtual void apply( const X& x, Y& y ) const override
     {
+        OPM_PERF_SCOPE("spmv", detail::spmvMemoryTraffic(A_, x));
         for (auto row = A_.begin(); row.index() < interiorSize_; ++row)
         {
             y[row.index()]=0;
@@ -243,6 +271,153 @@ protected:
     size_t interiorSize_;
 };
 
+#if HAVE_MPI
+/*!
+   \brief Adapter like WellModelGhostLastMatrixAdapter, which does the
+   halo exchange of the input vector itself and overlaps it with the
+   interior rows.
+
+   The interior rows are split into rows that only couple to owner
+   rows, and boundary rows that also couple to ghost rows. apply()
+   posts nonblocking sends of the owner values and receives of the
+   ghost values, computes the rows that do not need the ghosts, waits,
+   and then computes the boundary rows. Only the owner entries of the
+   input need to be valid: the received ghost values are written into
+   the input vector before the well operator is applied, so afterwards
+   it is consistent. The preconditioner does then not have to make its
+   result consistent.
+ */
+template<class M, class X, class Y, bool overlapping >
+class WellModelGhostLastOverlappedMatrixAdapter : public WellModelGhostLastMatrixAdapter<M,X,Y,overlapping>
+{
+public:
+    using Base = WellModelGhostLastMatrixAdapter<M,X,Y,overlapping>;
+    using typename Base::field_type;
+    using typename Base::communication_type;
+    using block_type = typename X::block_type;
+
+    WellModelGhostLastOverlappedMatrixAdapter (const M& A,
+                                               const Dune::LinearOperator<X, Y>& wellOper,
+                                               const size_t interiorSize,
+                                               const communication_type& comm)
+        : Base( A, wellOper, interiorSize ), exchange_( comm, /*tag=*/3468 )
+    {
+        setupRows();
+    }
+
+    virtual void apply( const X& x, Y& y ) const override
+    {
+        OPM_PERF_SCOPE("spmv", detail::spmvMemoryTraffic(this->A_, x));
+        startExchange( x );
+        for (const auto row : innerRows_) {
+            y[row] = 0;
+            multiplyRow( row, 1.0, x, y );
+        }
+        finishExchange( x );
+        for (const auto row : boundaryRows_) {
+            y[row] = 0;
+            multiplyRow( row, 1.0, x, y );
+        }
+
+        // add well model modification to y
+        this->wellOper_.apply(x, y );
+
+        this->ghostLastProject( y );
+    }
+
+    // y += \alpha * A * x
+    virtual void applyscaleadd (field_type alpha, const X& x, Y& y) const override
+    {
+        startExchange( x );
+        for (const auto row : innerRows_) {
+            multiplyRow( row, alpha, x, y );
+        }
+        finishExchange( x );
+        for (const auto row : boundaryRows_) {
+            multiplyRow( row, alpha, x, y );
+        }
+        // add scaled well model modification to y
+        this->wellOper_.applyscaleadd( alpha, x, y );
+
+        this->ghostLastProject( y );
+    }
+
+private:
+    void multiplyRow( size_t row, field_type alpha, const X& x, Y& y ) const
+    {
+        const auto& r = this->A_[row];
+        const auto endc = r.end();
+        for (auto col = r.begin(); col != endc; ++col)
+            (*col).usmv(alpha, x[col.index()], y[row]);
+    }
+
+    void setupRows()
+    {
+        std::vector<bool> received(this->A_.N(), false);
+        exchange_.markReceived(received);
+
+        for (auto row = this->A_.begin(); row.index() < this->interiorSize_; ++row)
+        {
+            const auto endc = (*row).end();
+            bool couplesToGhost = false;
+            for (auto col = (*row).begin(); col != endc; ++col) {
+                if (received[col.index()]) {
+                    couplesToGhost = true;
+                    break;
+                }
+            }
+            if (couplesToGhost)
+                boundaryRows_.push_back(row.index());
+            else
+                innerRows_.push_back(row.index());
+        }
+    }
+
+    void startExchange( const X& x ) const
+    {
+        exchange_.start( x );
+    }
+
+    void finishExchange( const X& x ) const
+    {
+        // x is only const in the interface, the ghost entries are overwritten
+        // with the values of their owners
+        exchange_.finish( const_cast<X&>(x) );
+    }
+
+    mutable HaloExchange<X, communication_type> exchange_;
+    std::vector<size_t> innerRows_;
+    std::vector<size_t> boundaryRows_;
+};
+#endif // HAVE_MPI
+
+/*!
+   \brief Adapter which applies another well model operator, but returns
+   a separate matrix from getmat().
+
+   The preconditioners are set up from the matrix returned by getmat().
+   This adapter lets them see a matrix which contains the well
+   contributions on the sparsity pattern of the reservoir matrix, while
+   apply() and applyscaleadd() still use the exact well model of the
+   base operator.
+ */
+template<class BaseOperator>
+class WellModelPreconditionerMatrixAdapter : public BaseOperator
+{
+public:
+    using typename BaseOperator::matrix_type;
+
+    template<class... Args>
+    WellModelPreconditionerMatrixAdapter (const matrix_type& precondMatrix, Args&&... args)
+        : BaseOperator( std::forward<Args>(args)... ), precondMatrix_( precondMatrix )
+    {}
+
+    virtual const matrix_type& getmat() const override { return precondMatrix_; }
+
+private:
+    const matrix_type& precondMatrix_;
+};
+
 } // namespace Opm
 
 #endif // OPM_WELLOPERATORS_HEADER_INCLUDED
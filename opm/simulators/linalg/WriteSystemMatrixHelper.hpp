@@ -21,18 +21,24 @@
 #define OPM_WRITESYSTEMMATRIXHELPER_HEADER_INCLUDED
 
 #include <dune/istl/matrixmarket.hh>
+#include <opm/common/OpmLog/OpmLog.hpp>
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
 #include <opm/simulators/linalg/MatrixMarketSpecializations.hpp>
+#include <opm/simulators/wells/PackedWellSchurComplement.hpp>
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 
 namespace Opm
 {
 namespace Helper
 {
-    template <class SimulatorType, class MatrixType, class VectorType, class Communicator>
-    void writeSystem(const SimulatorType& simulator,
-                     const MatrixType& matrix,
-                     const VectorType& rhs,
-                     [[maybe_unused]] const Communicator* comm)
+    /// The common part of the file names of the dumps of the current system.
+    template <class SimulatorType>
+    std::string systemDumpPrefix(const SimulatorType& simulator)
     {
         std::string dir = simulator.problem().outputDir();
         if (dir == ".") {
@@ -55,7 +61,16 @@ namespace Helper
         oss << "_nit_" << nit << "_";
         std::string output_file(oss.str());
         fs::path full_path = output_dir / output_file;
-        std::string prefix = full_path.string();
+        return full_path.string();
+    }
+
+    template <class SimulatorType, class MatrixType, class VectorType, class Communicator>
+    void writeSystem(const SimulatorType& simulator,
+                     const MatrixType& matrix,
+                     const VectorType& rhs,
+                     [[maybe_unused]] const Communicator* comm)
+    {
+        const std::string prefix = systemDumpPrefix(simulator);
         {
             std::string filename = prefix + "matrix_istl";
 #if HAVE_MPI
@@ -80,6 +95,43 @@ namespace Helper
         }
     }
 
+    /// Write the system in the binary format of BinarySystemDump.hpp, together
+    /// with the standard wells if they are applied by the operator, and the
+    /// parallel index set. In parallel runs every process writes a file of its own.
+    template <class SimulatorType, class MatrixType, class VectorType, class Communicator>
+    void writeSystemBinary(const SimulatorType& simulator,
+                           const MatrixType& matrix,
+                           const VectorType& rhs,
+                           const bool includeWells,
+                           [[maybe_unused]] const Communicator* comm)
+    {
+        std::string fileName = systemDumpPrefix(simulator) + "system_istl";
+        std::vector<BinarySystemIndex> indices;
+#if HAVE_MPI
+        if (comm != nullptr) { // comm is not set in serial runs
+            fileName += "_" + std::to_string(comm->communicator().rank());
+            indices.reserve(comm->indexSet().size());
+            for (const auto& idx : comm->indexSet()) {
+                indices.push_back({static_cast<std::int64_t>(idx.global()),
+                                   static_cast<std::int32_t>(idx.local().local()),
+                                   static_cast<std::int32_t>(idx.local().attribute())});
+            }
+        }
+#endif
+        fileName += ".bin";
+
+        const auto& wellModel = simulator.problem().wellModel();
+        using WellModel = std::decay_t<decltype(wellModel)>;
+        PackedWellSchurComplement<typename WellModel::Scalar, WellModel::numEq> wells;
+        if (includeWells) {
+            const int unpacked = wellModel.packedWellSchurComplements(wells);
+            if (unpacked > 0) {
+                OpmLog::warning("The system dump " + fileName + " does not contain "
+                                + std::to_string(unpacked) + " multisegment or distributed wells");
+            }
+        }
+        writeBinarySystem(fileName, matrix, rhs, &wells, indices);
+    }
 
 } // namespace Helper
 } // namespace Opm
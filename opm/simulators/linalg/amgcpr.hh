@@ -7,6 +7,8 @@
 // dune-istl release 2.6.0. Modifications have been kept as minimal as possible.
 
 #include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
+#include <opm/simulators/utils/MemoryReport.hpp>
+#include <opm/simulators/utils/PerfCounters.hpp>
 
 #include <dune/common/exceptions.hh>
 #include <dune/istl/paamg/smoother.hh>
@@ -241,6 +243,25 @@ namespace Dune
        */
       virtual void update();
 
+      /**
+       * @brief The bytes of the matrices of all levels, without the
+       * smoothers and the coarse solver.
+       */
+      virtual std::size_t memoryUsage() const
+      {
+        std::size_t bytes = 0;
+        if (!matrices_) {
+          return bytes;
+        }
+        const auto& levels = matrices_->matrices();
+        for (auto level = levels.finest(); ; ++level) {
+          bytes += Opm::matrixMemoryUsage(level->getmat());
+          if (level == levels.coarsest())
+            break;
+        }
+        return bytes;
+      }
+
       /**
        * @brief Check whether the coarse solver used is a direct solver.
        * @return True if the coarse level solver is a direct solver.
@@ -720,6 +741,7 @@ namespace Dune
     template<class M, class X, class S, class PI, class A>
     void AMGCPR<M,X,S,PI,A>::apply(Domain& v, const Range& d)
     {
+      OPM_PERF_SCOPE("amg cycle", 0);
       LevelContext levelContext;
 
       if(additive) {
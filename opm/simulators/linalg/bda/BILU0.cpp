@@ -47,6 +47,28 @@ BILU0<block_size>::~BILU0()
     delete[] invDiagVals;
 }
 
+template <unsigned int block_size>
+void BILU0<block_size>::setChowPatel(int sweeps, double tolerance)
+{
+    if (block_size != 3) {
+        OPM_THROW(std::logic_error, "Error the ChowPatelIlu decomposition only supports blocksize 3");
+    }
+    chow_patel = true;
+    chow_patel_sweeps = sweeps;
+    chow_patel_tolerance = tolerance;
+}
+
+    template <unsigned int block_size>
+    std::unique_ptr<BlockedMatrix<block_size> > BILU0<block_size>::createLUmat(const BlockedMatrix<block_size>& pattern) const
+    {
+        if (chow_patel) {
+            // the ChowPatel decomposition needs a host copy of the entries
+            return std::make_unique<BlockedMatrix<block_size> >(pattern);
+        }
+        // otherwise the entries are only on the GPU, LUmat just shares the sparsity pattern
+        return std::make_unique<BlockedMatrix<block_size> >(pattern.Nb, pattern.nnzbs, nullptr, pattern.colIndices, pattern.rowPointers);
+    }
+
     template <unsigned int block_size>
     bool BILU0<block_size>::init(BlockedMatrix<block_size> *mat)
     {
@@ -61,14 +83,14 @@ BILU0<block_size>::~BILU0()
         int *CSCColPointers = nullptr;
 
         if (opencl_ilu_reorder == ILUReorder::NONE) {
-            LUmat = std::make_unique<BlockedMatrix<block_size> >(*mat);
+            LUmat = createLUmat(*mat);
         } else {
             toOrder.resize(Nb);
             fromOrder.resize(Nb);
             CSCRowIndices = new int[nnzbs];
             CSCColPointers = new int[Nb + 1];
             rmat = std::make_shared<BlockedMatrix<block_size> >(mat->Nb, mat->nnzbs);
-            LUmat = std::make_unique<BlockedMatrix<block_size> >(*rmat);
+            LUmat = createLUmat(*rmat);
 
             Timer t_convert;
             csrPatternToCsc(mat->colIndices, mat->rowPointers, CSCRowIndices, CSCColPointers, mat->Nb);
@@ -86,7 +108,7 @@ BILU0<block_size>::~BILU0()
             findLevelScheduling(mat->colIndices, mat->rowPointers, CSCRowIndices, CSCColPointers, mat->Nb, &numColors, toOrder.data(), fromOrder.data(), rowsPerColor);
         } else if (opencl_ilu_reorder == ILUReorder::GRAPH_COLORING) {
             out << "BILU0 reordering strategy: " << "graph_coloring\n";
-            findGraphColoring<block_size>(mat->colIndices, mat->rowPointers, CSCRowIndices, CSCColPointers, mat->Nb, mat->Nb, mat->Nb, &numColors, toOrder.data(), fromOrder.data(), rowsPerColor);
+            findGraphColoring<block_size>(mat->colIndices, mat->rowPointers, CSCRowIndices, CSCColPointers, mat->Nb, N, N, &numColors, toOrder.data(), fromOrder.data(), rowsPerColor);
         } else if (opencl_ilu_reorder == ILUReorder::NONE) {
             out << "BILU0 reordering strategy: none\n";
             // numColors = 1;
@@ -101,9 +123,9 @@ BILU0<block_size>::~BILU0()
         if(verbosity >= 1){
             out << "BILU0 analysis took: " << t_analysis.stop() << " s, " << numColors << " colors\n";
         }
-#if CHOW_PATEL
-        out << "BILU0 CHOW_PATEL: " << CHOW_PATEL << ", CHOW_PATEL_GPU: " << CHOW_PATEL_GPU;
-#endif
+        if (chow_patel) {
+            out << "BILU0 ChowPatel sweeps: " << chow_patel_sweeps << ", tolerance: " << chow_patel_tolerance << ", CHOW_PATEL_GPU: " << CHOW_PATEL_GPU;
+        }
         OpmLog::info(out.str());
 
 
@@ -115,28 +137,27 @@ BILU0<block_size>::~BILU0()
         diagIndex.resize(mat->Nb);
         invDiagVals = new double[mat->Nb * bs * bs];
 
-#if CHOW_PATEL
-        Lmat = std::make_unique<BlockedMatrix<block_size> >(mat->Nb, (mat->nnzbs - mat->Nb) / 2);
-        Umat = std::make_unique<BlockedMatrix<block_size> >(mat->Nb, (mat->nnzbs - mat->Nb) / 2);
-#endif
+        if (chow_patel) {
+            Lmat = std::make_unique<BlockedMatrix<block_size> >(mat->Nb, (mat->nnzbs - mat->Nb) / 2);
+            Umat = std::make_unique<BlockedMatrix<block_size> >(mat->Nb, (mat->nnzbs - mat->Nb) / 2);
+        }
 
-        LUmat->nnzValues = new double[mat->nnzbs * bs * bs];
 
         s.invDiagVals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * bs * bs * mat->Nb);
         s.rowsPerColor = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (numColors + 1));
         s.diagIndex = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * LUmat->Nb);
-#if CHOW_PATEL
-        s.Lvals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * bs * bs * Lmat->nnzbs);
-        s.Lcols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * Lmat->nnzbs);
-        s.Lrows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (Lmat->Nb + 1));
-        s.Uvals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * bs * bs * Lmat->nnzbs);
-        s.Ucols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * Lmat->nnzbs);
-        s.Urows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (Lmat->Nb + 1));
-#else
-        s.LUvals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * bs * bs * LUmat->nnzbs);
-        s.LUcols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * LUmat->nnzbs);
-        s.LUrows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (LUmat->Nb + 1));
-#endif
+        if (chow_patel) {
+            s.Lvals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * bs * bs * Lmat->nnzbs);
+            s.Lcols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * Lmat->nnzbs);
+            s.Lrows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (Lmat->Nb + 1));
+            s.Uvals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * bs * bs * Lmat->nnzbs);
+            s.Ucols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * Lmat->nnzbs);
+            s.Urows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (Lmat->Nb + 1));
+        } else {
+            s.LUvals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * bs * bs * LUmat->nnzbs);
+            s.LUcols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * LUmat->nnzbs);
+            s.LUrows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (LUmat->Nb + 1));
+        }
 
         events.resize(2);
         err = queue->enqueueWriteBuffer(s.invDiagVals, CL_FALSE, 0, mat->Nb * sizeof(double) * bs * bs, invDiagVals, nullptr, &events[0]);
@@ -162,9 +183,8 @@ BILU0<block_size>::~BILU0()
     template <unsigned int block_size>
     void BILU0<block_size>::chow_patel_decomposition()
     {
-#if CHOW_PATEL
         const unsigned int bs = block_size;
-        int num_sweeps = 6;
+        const int num_sweeps = chow_patel_sweeps;
 
         // split matrix into L and U
         // also convert U into BSC format (Ut)
@@ -291,7 +311,7 @@ BILU0<block_size>::~BILU0()
                     Ut->rowPointers, Ut->colIndices, Ut->nnzValues, Ut->nnzbs,
                     Lmat->rowPointers, Lmat->colIndices, Lmat->nnzValues, Lmat->nnzbs,
                     LUmat->rowPointers, LUmat->colIndices, LUmat->nnzValues, LUmat->nnzbs,
-                    Nb, num_sweeps, verbosity);
+                    Nb, num_sweeps, chow_patel_tolerance, verbosity);
 #else
         double *Ltmp = new double[Lmat->nnzbs * block_size * block_size];
         for (int sweep = 0; sweep < num_sweeps; ++sweep) {
@@ -500,7 +520,6 @@ BILU0<block_size>::~BILU0()
         }
 
         delete[] Utmp;
-#endif // CHOW_PATEL
     }
 
     template <unsigned int block_size>
@@ -521,24 +540,28 @@ BILU0<block_size>::~BILU0()
             }
         }
 
-        // TODO: remove this copy by replacing inplace ilu decomp by out-of-place ilu decomp
-        // this copy can have mat or rmat ->nnzValues as origin, depending on the reorder strategy
-        Timer t_copy;
-        memcpy(LUmat->nnzValues, m->nnzValues, sizeof(double) * bs * bs * m->nnzbs);
+        if (chow_patel) {
+            // the ChowPatel decomposition reads the entries from LUmat on the host
+            // this copy can have mat or rmat ->nnzValues as origin, depending on the reorder strategy
+            Timer t_copy;
+            memcpy(LUmat->nnzValues, m->nnzValues, sizeof(double) * bs * bs * m->nnzbs);
 
-        if (verbosity >= 3){
-            std::ostringstream out;
-            out << "BILU0 memcpy: " << t_copy.stop() << " s";
-            OpmLog::info(out.str());
+            if (verbosity >= 3){
+                std::ostringstream out;
+                out << "BILU0 memcpy: " << t_copy.stop() << " s";
+                OpmLog::info(out.str());
+            }
+
+            chow_patel_decomposition();
+            return true;
         }
 
-#if CHOW_PATEL
-        chow_patel_decomposition();
-#else
         Timer t_copyToGpu;
 
+        // the decomposition is done in-place on the GPU, so the entries are uploaded
+        // directly from mat or rmat, which have the same sparsity pattern as LUmat
         events.resize(1);
-        queue->enqueueWriteBuffer(s.LUvals, CL_FALSE, 0, LUmat->nnzbs * bs * bs * sizeof(double), LUmat->nnzValues, nullptr, &events[0]);
+        queue->enqueueWriteBuffer(s.LUvals, CL_FALSE, 0, LUmat->nnzbs * bs * bs * sizeof(double), m->nnzValues, nullptr, &events[0]);
 
         std::call_once(pattern_uploaded, [&](){
             // find the positions of each diagonal block
@@ -592,7 +615,6 @@ BILU0<block_size>::~BILU0()
             out << "BILU0 decomposition: " << t_decomposition.stop() << " s";
             OpmLog::info(out.str());
         }
-#endif // CHOW_PATEL
 
         return true;
     } // end create_preconditioner()
@@ -607,20 +629,20 @@ BILU0<block_size>::~BILU0()
         Timer t_apply;
 
         for(int color = 0; color < numColors; ++color){
-#if CHOW_PATEL
-            event = (*ILU_apply1)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), s.Lvals, s.Lcols, s.Lrows, s.diagIndex, x, y, s.rowsPerColor, color, block_size, cl::Local(lmem_per_work_group));
-#else
-            event = (*ILU_apply1)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), s.LUvals, s.LUcols, s.LUrows, s.diagIndex, x, y, s.rowsPerColor, color, block_size, cl::Local(lmem_per_work_group));
-#endif
+            if (chow_patel) {
+                event = (*ILU_apply1)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), s.Lvals, s.Lcols, s.Lrows, s.diagIndex, x, y, s.rowsPerColor, color, block_size, cl::Local(lmem_per_work_group));
+            } else {
+                event = (*ILU_apply1)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), s.LUvals, s.LUcols, s.LUrows, s.diagIndex, x, y, s.rowsPerColor, color, block_size, cl::Local(lmem_per_work_group));
+            }
             // event.wait();
         }
 
         for(int color = numColors-1; color >= 0; --color){
-#if CHOW_PATEL
-            event = (*ILU_apply2)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), s.Uvals, s.Ucols, s.Urows, s.diagIndex, s.invDiagVals, y, s.rowsPerColor, color, block_size, cl::Local(lmem_per_work_group));
-#else
-            event = (*ILU_apply2)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), s.LUvals, s.LUcols, s.LUrows, s.diagIndex, s.invDiagVals, y, s.rowsPerColor, color, block_size, cl::Local(lmem_per_work_group));
-#endif
+            if (chow_patel) {
+                event = (*ILU_apply2)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), s.Uvals, s.Ucols, s.Urows, s.diagIndex, s.invDiagVals, y, s.rowsPerColor, color, block_size, cl::Local(lmem_per_work_group));
+            } else {
+                event = (*ILU_apply2)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), s.LUvals, s.LUcols, s.LUrows, s.diagIndex, s.invDiagVals, y, s.rowsPerColor, color, block_size, cl::Local(lmem_per_work_group));
+            }
             // event.wait();
         }
 
@@ -662,6 +684,7 @@ void BILU0<block_size>::setKernels(
 #define INSTANTIATE_BDA_FUNCTIONS(n)                                                     \
 template BILU0<n>::BILU0(ILUReorder, int);                                               \
 template BILU0<n>::~BILU0();                                                             \
+template void BILU0<n>::setChowPatel(int, double);                                       \
 template bool BILU0<n>::init(BlockedMatrix<n>*);                                         \
 template void BILU0<n>::chow_patel_decomposition();                                      \
 template bool BILU0<n>::create_preconditioner(BlockedMatrix<n>*);                        \
@@ -29,15 +29,14 @@
 #include <opm/simulators/linalg/bda/openclKernels.hpp>
 #include <opm/simulators/linalg/bda/ChowPatelIlu.hpp>
 
-// if CHOW_PATEL is 0, exact ILU decomposition is performed on CPU
-// if CHOW_PATEL is 1, iterative ILU decomposition (FGPILU) is done, as described in:
+// by default, exact ILU decomposition is performed on GPU
+// with chow_patel, iterative ILU decomposition (FGPILU) is done, as described in:
 //    FINE-GRAINED PARALLEL INCOMPLETE LU FACTORIZATION, E. Chow and A. Patel, SIAM 2015, https://doi.org/10.1137/140968896
-// if CHOW_PATEL_GPU is 0, the decomposition is done on CPU
-// if CHOW_PATEL_GPU is 1, the decomposition is done by bda::FGPILU::decomposition() on GPU
+// if CHOW_PATEL_GPU is 0, the iterative decomposition is done on CPU
+// if CHOW_PATEL_GPU is 1, the iterative decomposition is done by bda::ChowPatelIlu::decomposition() on GPU
 // the apply phase of the ChowPatelIlu uses two triangular matrices: L and U
 // the exact decomposition uses a full matrix LU which is the superposition of L and U
 // ChowPatelIlu could also operate on a full matrix LU when L and U are merged, but it is generally better to keep them split
-#define CHOW_PATEL     0
 #define CHOW_PATEL_GPU 1
 
 
@@ -57,9 +56,7 @@ namespace bda
         int nnzbs;   // number of blocks of the matrix
         std::unique_ptr<BlockedMatrix<block_size> > LUmat = nullptr;
         std::shared_ptr<BlockedMatrix<block_size> > rmat = nullptr; // only used with PAR_SIM
-#if CHOW_PATEL
-        std::unique_ptr<BlockedMatrix<block_size> > Lmat = nullptr, Umat = nullptr;
-#endif
+        std::unique_ptr<BlockedMatrix<block_size> > Lmat = nullptr, Umat = nullptr; // only used with chow_patel
         double *invDiagVals = nullptr;
         std::vector<int> diagIndex;
         std::vector<int> rowsPerColor;  // color i contains rowsPerColor[i] rows, which are processed in parallel
@@ -71,16 +68,17 @@ namespace bda
 
         ILUReorder opencl_ilu_reorder;
 
+        bool chow_patel = false;           // use the iterative decomposition instead of the exact one
+        int chow_patel_sweeps = 6;         // maximum number of sweeps of the iterative decomposition
+        double chow_patel_tolerance = 0.0; // stop the sweeps when the relative change drops below, 0.0 disables
+
         typedef struct {
             cl::Buffer invDiagVals;
             cl::Buffer diagIndex;
             cl::Buffer rowsPerColor;
-#if CHOW_PATEL
-            cl::Buffer Lvals, Lcols, Lrows;
-            cl::Buffer Uvals, Ucols, Urows;
-#else
-            cl::Buffer LUvals, LUcols, LUrows;
-#endif
+            cl::Buffer Lvals, Lcols, Lrows;    // only used with chow_patel
+            cl::Buffer Uvals, Ucols, Urows;    // only used with chow_patel
+            cl::Buffer LUvals, LUcols, LUrows; // only used without chow_patel
         } GPU_storage;
 
         ilu_apply1_kernel_type *ILU_apply1;
@@ -102,10 +100,18 @@ namespace bda
 
         void chow_patel_decomposition();
 
+        // create LUmat with the sparsity pattern of mat or rmat, with host entries only if chow_patel is used
+        std::unique_ptr<BlockedMatrix<block_size> > createLUmat(const BlockedMatrix<block_size>& pattern) const;
+
     public:
 
         BILU0(ILUReorder opencl_ilu_reorder, int verbosity);
 
+        /// Select the iterative decomposition of Chow and Patel, must be called before init()
+        /// \param[in] sweeps       maximum number of sweeps
+        /// \param[in] tolerance    stop when the relative change of the factors during a sweep is below tolerance, 0.0 always does all sweeps
+        void setChowPatel(int sweeps, double tolerance);
+
         ~BILU0();
 
         // analysis
@@ -25,6 +25,7 @@
 
 #include <opm/simulators/linalg/bda/BdaBridge.hpp>
 #include <opm/simulators/linalg/bda/BdaResult.hpp>
+#include <opm/simulators/utils/Tracing.hpp>
 
 #if HAVE_CUDA
 #include <opm/simulators/linalg/bda/cusparseSolverBackend.hpp>
@@ -53,12 +54,27 @@ namespace Opm
 
 template <class BridgeMatrix, class BridgeVector, int block_size>
 BdaBridge<BridgeMatrix, BridgeVector, block_size>::BdaBridge(std::string accelerator_mode_,
-                                                             [[maybe_unused]] std::string fpga_bitstream,
-                                                             int linear_solver_verbosity, int maxit,
-                                                             double tolerance, unsigned int platformID,
-                                                             unsigned int deviceID,
-                                                             [[maybe_unused]] std::string opencl_ilu_reorder)
+                                                             std::string fpga_bitstream_,
+                                                             int linear_solver_verbosity_, int maxit_,
+                                                             double tolerance_, unsigned int platformID_,
+                                                             unsigned int deviceID_,
+                                                             std::string opencl_ilu_reorder_)
 : accelerator_mode(accelerator_mode_)
+, fpga_bitstream(fpga_bitstream_)
+, linear_solver_verbosity(linear_solver_verbosity_)
+, maxit(maxit_)
+, tolerance(tolerance_)
+, platformID(platformID_)
+, deviceID(deviceID_)
+, opencl_ilu_reorder(opencl_ilu_reorder_)
+{
+    createBackend();
+}
+
+
+
+template <class BridgeMatrix, class BridgeVector, int block_size>
+void BdaBridge<BridgeMatrix, BridgeVector, block_size>::createBackend()
 {
     if (accelerator_mode.compare("cusparse") == 0) {
 #if HAVE_CUDA
@@ -109,15 +125,84 @@ BdaBridge<BridgeMatrix, BridgeVector, block_size>::BdaBridge(std::string acceler
     } else {
         OPM_THROW(std::logic_error, "Error unknown value for parameter 'AcceleratorMode', should be passed like '--accelerator-mode=[none|cusparse|opencl|fpga]");
     }
+    if (backend && communication) {
+        backend->setCommunication(communication);
+    }
+    if (backend && chow_patel) {
+        backend->setChowPatel(chow_patel_sweeps, chow_patel_tolerance);
+    }
+    if (backend && use_cpr) {
+        backend->setCpr(cpr_pressure_idx);
+    }
+    if (backend && !kernel_cache_dir.empty()) {
+        backend->setKernelCache(kernel_cache_dir);
+    }
+}
+
+
+template <class BridgeMatrix, class BridgeVector, int block_size>
+void BdaBridge<BridgeMatrix, BridgeVector, block_size>::setChowPatel(int sweeps, double tolerance)
+{
+    if (accelerator_mode != "cusparse" && accelerator_mode != "opencl") {
+        OPM_THROW(std::logic_error, "Error the ChowPatel decomposition is only supported by the cusparseSolver and openclSolver");
+    }
+    if (sweeps < 1) {
+        OPM_THROW(std::logic_error, "Error the ChowPatel decomposition needs at least one sweep");
+    }
+    chow_patel = true;
+    chow_patel_sweeps = sweeps;
+    chow_patel_tolerance = tolerance;
+    if (backend) {
+        backend->setChowPatel(chow_patel_sweeps, chow_patel_tolerance);
+    }
+}
+
+
+template <class BridgeMatrix, class BridgeVector, int block_size>
+void BdaBridge<BridgeMatrix, BridgeVector, block_size>::setCpr(int pressure_idx)
+{
+    if (accelerator_mode != "opencl") {
+        OPM_THROW(std::logic_error, "Error the CPR preconditioner is only supported by the openclSolver");
+    }
+    if (pressure_idx < 0 || pressure_idx >= block_size) {
+        OPM_THROW(std::logic_error, "Error the pressure index for CPR is out of range");
+    }
+    use_cpr = true;
+    cpr_pressure_idx = pressure_idx;
+    if (backend) {
+        backend->setCpr(cpr_pressure_idx);
+    }
+}
+
+
+template <class BridgeMatrix, class BridgeVector, int block_size>
+void BdaBridge<BridgeMatrix, BridgeVector, block_size>::setKernelCache(const std::string& dir)
+{
+    kernel_cache_dir = dir;
+    if (backend) {
+        backend->setKernelCache(kernel_cache_dir);
+    }
+}
+
+
+template <class BridgeMatrix, class BridgeVector, int block_size>
+void BdaBridge<BridgeMatrix, BridgeVector, block_size>::setCommunication(std::shared_ptr<bda::BdaCommunication> comm)
+{
+    if (comm && accelerator_mode != "opencl") {
+        OPM_THROW(std::logic_error, "Error only the openclSolver can be used in parallel");
+    }
+    communication = comm;
+    if (backend) {
+        backend->setCommunication(communication);
+    }
 }
 
 
 
 template <class BridgeMatrix>
-int checkZeroDiagonal(BridgeMatrix& mat) {
-    static std::vector<typename BridgeMatrix::size_type> diag_indices;   // contains offsets of the diagonal nnzs
+int checkZeroDiagonal(BridgeMatrix& mat, std::vector<typename BridgeMatrix::size_type>& diag_indices) {
     int numZeros = 0;
-    const int dim = 3;                    // might be replaced with mat[0][0].N() or BridgeMatrix::block_type::size()
+    const int dim = BridgeMatrix::block_type::rows;
     const double zero_replace = 1e-15;
     if (diag_indices.size() == 0) {
         int N = mat.N();
@@ -152,6 +237,25 @@ int checkZeroDiagonal(BridgeMatrix& mat) {
 }
 
 
+// compute a hash of the sparsity pattern, to detect whether it changed since the last call
+// only the column indices and row sizes are used, the values are ignored
+template <class BridgeMatrix>
+std::size_t getSparsityPatternHash(const BridgeMatrix& mat) {
+    std::size_t seed = mat.N();
+    auto combine = [&seed](std::size_t v) {
+        // same mixing as boost::hash_combine
+        seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    };
+    for (auto r = mat.begin(); r != mat.end(); ++r) {
+        combine(r->size());
+        for (auto c = r->begin(); c != r->end(); ++c) {
+            combine(c.index());
+        }
+    }
+    return seed;
+}
+
+
 // iterate sparsity pattern from Matrix and put colIndices and rowPointers in arrays
 // sparsity pattern should stay the same
 // this could be removed if Dune::BCRSMatrix features an API call that returns colIndices and rowPointers
@@ -181,27 +285,52 @@ void getSparsityPattern(BridgeMatrix& mat, std::vector<int> &h_rows, std::vector
 
 
 template <class BridgeMatrix, class BridgeVector, int block_size>
-void BdaBridge<BridgeMatrix, BridgeVector, block_size>::solve_system(BridgeMatrix *mat OPM_UNUSED, BridgeVector &b OPM_UNUSED, WellContributions& wellContribs OPM_UNUSED, InverseOperatorResult &res OPM_UNUSED)
+void BdaBridge<BridgeMatrix, BridgeVector, block_size>::solve_system(BridgeMatrix *mat OPM_UNUSED, BridgeVector &b OPM_UNUSED, WellContributions& wellContribs OPM_UNUSED, InverseOperatorResult &res OPM_UNUSED,
+                                                                    const std::function<void()>& matrixReady OPM_UNUSED)
 {
+    OPM_TRACE_SCOPE("bda solve");
 
     if (use_gpu || use_fpga) {
         BdaResult result;
         result.converged = false;
-        static std::vector<int> h_rows;
-        static std::vector<int> h_cols;
         const int dim = (*mat)[0][0].N();
         const int Nb = mat->N();
         const int N = Nb * dim;
-        const int nnzb = (h_rows.empty()) ? mat->nonzeroes() : h_rows.back();
+        const int nnzb = mat->nonzeroes();
         const int nnz = nnzb * dim * dim;
 
-        if (dim != 3) {
-            OpmLog::warning("cusparseSolver only accepts blocksize = 3 at this time, will use Dune for the remainder of the program");
+        if (dim < 2 || dim > 4) {
+            OpmLog::warning(std::string(use_fpga ? "fpgaSolver" : "gpuSolver") + " only accepts blocksize = 2, 3 or 4"
+                            + " at this time, will use Dune for the remainder of the program");
             use_gpu = false;
+            use_fpga = false;
+            res.converged = false;
+            return;
+        }
+
+        // The backends keep the sparsity pattern and the analysis of it on the device,
+        // only the values of the matrix and the right hand side are copied for each solve.
+        // If the pattern changed, the backend has to be set up again.
+        const std::size_t hash = getSparsityPatternHash(*mat);
+        const bool pattern_changed = !h_rows.empty() && hash != pattern_hash;
+        // in parallel runs all processes must skip the solve, if the pattern changed on any of them
+        const bool skip_solve = communication ? (communication->min(pattern_changed ? 0.0 : 1.0) < 1.0) : pattern_changed;
+        if (pattern_changed) {
+            OpmLog::info("BdaBridge: sparsity pattern of the matrix changed, reinitializing " + accelerator_mode + " backend");
+            h_rows.clear();
+            h_cols.clear();
+            diag_indices.clear();
+            createBackend();
+        }
+        if (skip_solve) {
+            // the WellContributions of this solve were set up for the old backend,
+            // let the caller solve this system with Dune
+            res.converged = false;
             return;
         }
+        pattern_hash = hash;
 
-        if (h_rows.capacity() == 0) {
+        if (h_rows.empty()) {
             h_rows.reserve(Nb+1);
             h_cols.reserve(nnzb);
 #if PRINT_TIMERS_BRIDGE
@@ -217,14 +346,19 @@ void BdaBridge<BridgeMatrix, BridgeVector, block_size>::solve_system(BridgeMatri
 
 #if PRINT_TIMERS_BRIDGE
         Dune::Timer t_zeros;
-        int numZeros = checkZeroDiagonal(*mat);
+        int numZeros = checkZeroDiagonal(*mat, diag_indices);
         std::ostringstream out;
         out << "Checking zeros took: " << t_zeros.stop() << " s, found " << numZeros << " zeros";
         OpmLog::info(out.str());
 #else
-        checkZeroDiagonal(*mat);
+        checkZeroDiagonal(*mat, diag_indices);
 #endif
 
+        // the matrix is only read from here on
+        if (matrixReady) {
+            matrixReady();
+        }
+
 
         /////////////////////////
         // actually solve
@@ -241,6 +375,9 @@ void BdaBridge<BridgeMatrix, BridgeVector, block_size>::solve_system(BridgeMatri
         case SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED:
             OpmLog::warning("BdaSolver could not create preconditioner, perhaps there is still a 0.0 on the diagonal of a block on the diagonal");
             break;
+        case SolverStatus::BDA_SOLVER_FAILED_ON_OTHER_PROCESS:
+            OpmLog::warning("BdaSolver failed on another process");
+            break;
         default:
             OpmLog::warning("BdaSolver returned unknown status code");
         }
@@ -287,7 +424,7 @@ Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector
 n>::solve_system                                                                                                                    \
 (Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >*,                               \
     Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >&,                               \
-    WellContributions&, InverseOperatorResult&);                                                                                    \
+    WellContributions&, InverseOperatorResult&, const std::function<void()>&);                                                      \
                                                                                                                                     \
 template void BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >,         \
 Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >,                                    \
@@ -296,7 +433,23 @@ n>::get_result
                                                                                                                                     \
 template void BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >,         \
 Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >,                                    \
-n>::initWellContributions(WellContributions&)
+n>::initWellContributions(WellContributions&);                                                                                   \
+                                                                                                                                    \
+template void BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >,         \
+Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >,                                    \
+n>::setCommunication(std::shared_ptr<bda::BdaCommunication>);                                                                    \
+                                                                                                                                    \
+template void BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >,         \
+Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >,                                    \
+n>::setChowPatel(int, double);                                                                                                  \
+                                                                                                                                    \
+template void BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >,         \
+Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >,                                    \
+n>::setCpr(int);                                                                                                                     \
+                                                                                                                                    \
+template void BdaBridge<Dune::BCRSMatrix<Opm::MatrixBlock<double, n, n>, std::allocator<Opm::MatrixBlock<double, n, n> > >,         \
+Dune::BlockVector<Dune::FieldVector<double, n>, std::allocator<Dune::FieldVector<double, n> > >,                                    \
+n>::setKernelCache(const std::string&)
 
 
 INSTANTIATE_BDA_FUNCTIONS(1);
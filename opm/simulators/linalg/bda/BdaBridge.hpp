@@ -29,6 +29,11 @@
 #include <opm/simulators/linalg/bda/ILUReorder.hpp>
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
 #if HAVE_FPGA
 #include <opm/simulators/linalg/bda/FPGASolverBackend.hpp>
@@ -50,6 +55,33 @@ private:
     std::string accelerator_mode;
     std::unique_ptr<bda::BdaSolver<block_size> > backend;
 
+    // arguments of the backend, kept to be able to recreate it
+    std::string fpga_bitstream;
+    int linear_solver_verbosity;
+    int maxit;
+    double tolerance;
+    unsigned int platformID;
+    unsigned int deviceID;
+    std::string opencl_ilu_reorder;
+    std::shared_ptr<bda::BdaCommunication> communication; // only set in parallel runs
+    bool chow_patel = false;
+    int chow_patel_sweeps = 6;
+    double chow_patel_tolerance = 0.0;
+    bool use_cpr = false;
+    std::string kernel_cache_dir;
+    int cpr_pressure_idx = 0;
+
+    // sparsity pattern of the matrix that the backend was set up for, in CSR format,
+    // together with a hash of it to detect changes of the pattern
+    std::vector<int> h_rows;
+    std::vector<int> h_cols;
+    std::size_t pattern_hash = 0;
+    // offsets of the diagonal blocks in each row
+    std::vector<typename BridgeMatrix::size_type> diag_indices;
+
+    /// Create the backend selected by accelerator_mode
+    void createBackend();
+
 public:
     /// Construct a BdaBridge
     /// \param[in] accelerator_mode           to select if an accelerated solver is used, is passed via command-line: '--accelerator-mode=[none|cusparse|opencl|fpga]'
@@ -69,7 +101,11 @@ public:
     /// \param[in] b            vector b, should be of type Dune::BlockVector
     /// \param[in] wellContribs contains all WellContributions, to apply them separately, instead of adding them to matrix A
     /// \param[inout] result    summary of solver result
-    void solve_system(BridgeMatrix *mat, BridgeVector &b, WellContributions& wellContribs, InverseOperatorResult &result);
+    /// \param[in] matrixReady  if set, called once the values of A are final and before the
+    ///                         backend solves, e.g. to set up a CPU fallback concurrently.
+    ///                         It is not called if the solve is skipped.
+    void solve_system(BridgeMatrix *mat, BridgeVector &b, WellContributions& wellContribs, InverseOperatorResult &result,
+                      const std::function<void()>& matrixReady = {});
 
     /// Get the resulting x vector
     /// \param[inout] x    vector x, should be of type Dune::BlockVector
@@ -81,6 +117,27 @@ public:
         return use_gpu;
     }
 
+    /// Let the backend take part in a parallel solve, only supported by the openclSolver
+    /// The communication is kept when the backend is recreated
+    /// \param[in] comm   communication callbacks, the ownerMask must match the size of the matrix
+    void setCommunication(std::shared_ptr<bda::BdaCommunication> comm);
+
+    /// Use the iterative ILU0 decomposition of Chow and Patel on the GPU, only supported by the cusparse- and openclSolvers
+    /// must be called before the first solve, is kept when the backend is recreated
+    /// \param[in] sweeps      maximum number of sweeps
+    /// \param[in] tolerance   stop when the relative change of the factors during a sweep is below tolerance, 0.0 always does all sweeps
+    void setChowPatel(int sweeps, double tolerance);
+
+    /// Use the CPR preconditioner instead of BILU0, only supported by the openclSolver
+    /// must be called before the first solve, is kept when the backend is recreated
+    /// \param[in] pressure_idx   index of the pressure in a block
+    void setCpr(int pressure_idx);
+
+    /// Cache the binaries of the OpenCL kernels on disk, so that later runs do not compile them again
+    /// only used by the openclSolver, must be called before the first solve, is kept when the backend is recreated
+    /// \param[in] dir   directory of the cached binaries
+    void setKernelCache(const std::string& dir);
+
     /// Initialize the WellContributions object with opencl context and queue
     /// those must be set before calling BlackOilWellModel::getWellContributions() in ISTL
     /// \param[in] wellContribs   container to hold all WellContributions
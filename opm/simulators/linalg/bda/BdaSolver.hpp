@@ -24,6 +24,10 @@
 #include <opm/simulators/linalg/bda/BdaResult.hpp>
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace bda
 {
 
@@ -33,9 +37,21 @@ namespace bda
         BDA_SOLVER_SUCCESS,
         BDA_SOLVER_ANALYSIS_FAILED,
         BDA_SOLVER_CREATE_PRECONDITIONER_FAILED,
+        BDA_SOLVER_FAILED_ON_OTHER_PROCESS,
         BDA_SOLVER_UNKNOWN_ERROR
     };
 
+    /// Callbacks that let a BdaSolver take part in a parallel (MPI) solve
+    /// Every process solves its own part of the system, including the overlap rows,
+    /// all vectors passed to the callbacks are in the original ordering of the matrix
+    struct BdaCommunication
+    {
+        std::vector<double> ownerMask;               // 1.0 for the scalar rows owned by this process, 0.0 otherwise
+        std::function<void(double*)> copyOwnerToAll; // overwrite the non-owned entries of a vector by the values of their owner
+        std::function<double(double)> sum;           // sum over all processes
+        std::function<double(double)> min;           // minimum over all processes
+    };
+
     /// This class serves to simplify choosing between different backend solvers, such as cusparseSolver and openclSolver
     /// This class is abstract, no instantiations can of it can be made, only of its children
     template <unsigned int block_size>
@@ -67,6 +83,23 @@ namespace bda
 
         bool initialized = false;
 
+        std::shared_ptr<BdaCommunication> comm; // only set in parallel runs
+
+        // iterative ILU0 decomposition of Chow and Patel, instead of the exact decomposition
+        // only used by cusparseSolver and openclSolver
+        bool chow_patel = false;
+        int chow_patel_sweeps = 6;           // maximum number of sweeps
+        double chow_patel_tolerance = 0.0;   // stop the sweeps when the relative change of the factors is below, 0.0 always does all sweeps
+
+        // CPR preconditioner with a pressure AMG and BILU0 as second stage, instead of only BILU0
+        // only used by openclSolver
+        bool use_cpr = false;
+        int cpr_pressure_idx = 0;            // index of the pressure in a block
+
+        // directory of the cached OpenCL program binaries, empty to always build the kernels from the sources
+        // only used by openclSolver
+        std::string kernel_cache_dir;
+
     public:
         /// Construct a BdaSolver, can be cusparseSolver, openclSolver, fpgaSolver
         /// \param[in] fpga_bitstream             FPGA bitstream file name (only for fpgaSolver)
@@ -89,6 +122,34 @@ namespace bda
 
         virtual void get_result(double *x) = 0;
 
+        /// Let the solver take part in a parallel solve, must be called before the first solve
+        /// \param[in] comm_     communication callbacks, nullptr for a serial solve
+        void setCommunication(std::shared_ptr<BdaCommunication> comm_) {
+            comm = comm_;
+        }
+
+        /// Use the iterative ILU0 decomposition of Chow and Patel, must be called before the first solve
+        /// \param[in] sweeps       maximum number of sweeps
+        /// \param[in] tolerance    stop when the relative change of the factors during a sweep is below tolerance, 0.0 always does all sweeps
+        void setChowPatel(int sweeps, double tolerance) {
+            chow_patel = true;
+            chow_patel_sweeps = sweeps;
+            chow_patel_tolerance = tolerance;
+        }
+
+        /// Use the CPR preconditioner instead of BILU0, must be called before the first solve
+        /// \param[in] pressure_idx    index of the pressure in a block
+        void setCpr(int pressure_idx) {
+            use_cpr = true;
+            cpr_pressure_idx = pressure_idx;
+        }
+
+        /// Cache the binaries of the OpenCL kernels, must be called before the first solve
+        /// \param[in] dir    directory of the cached binaries, created if needed
+        void setKernelCache(const std::string& dir) {
+            kernel_cache_dir = dir;
+        }
+
     }; // end class BdaSolver
 
 } // end namespace bda
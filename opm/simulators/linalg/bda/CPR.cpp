@@ -0,0 +1,540 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include <opm/common/OpmLog/OpmLog.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <dune/common/timer.hh>
+
+#include <opm/simulators/linalg/bda/CPR.hpp>
+
+
+namespace bda
+{
+
+using Opm::OpmLog;
+using Dune::Timer;
+
+template <unsigned int block_size>
+CPR<block_size>::CPR(int verbosity_, int pressure_idx_) :
+    verbosity(verbosity_), pressure_idx(pressure_idx_)
+{
+    if (block_size > 4) {
+        OPM_THROW(std::logic_error, "Error CPR only supports blocksizes up to 4");
+    }
+    if (pressure_idx < 0 || pressure_idx >= static_cast<int>(block_size)) {
+        OPM_THROW(std::logic_error, "Error CPR pressure index is out of range");
+    }
+}
+
+
+template <unsigned int block_size>
+void CPR<block_size>::setOpenCLContext(cl::Context *context_) {
+    this->context = context_;
+}
+
+template <unsigned int block_size>
+void CPR<block_size>::setOpenCLQueue(cl::CommandQueue *queue_) {
+    this->queue = queue_;
+}
+
+template <unsigned int block_size>
+void CPR<block_size>::setKernelCache(const std::string& dir) {
+    this->kernel_cache_dir = dir;
+}
+
+
+template <unsigned int block_size>
+unsigned int CPR<block_size>::num_work_items(unsigned int size) {
+    const unsigned int work_group_size = 32;
+    return ((size + work_group_size - 1) / work_group_size) * work_group_size;
+}
+
+
+template <unsigned int block_size>
+void CPR<block_size>::build_kernels() {
+    std::call_once(kernels_built, [&](){
+        cl::Program::Sources sources;
+        std::string cpr_weights_s = get_cpr_weights_string();
+        std::string cpr_coarse_matrix_s = get_cpr_coarse_matrix_string();
+        std::string cpr_restrict_s = get_cpr_restrict_string();
+        std::string cpr_prolongate_s = get_cpr_prolongate_string();
+        std::string amg_residual_s = get_amg_residual_string();
+        std::string amg_jacobi_s = get_amg_jacobi_string();
+        std::string amg_restrict_s = get_amg_restrict_string();
+        std::string amg_prolongate_s = get_amg_prolongate_string();
+        std::string amg_dense_mv_s = get_amg_dense_mv_string();
+        std::string spmv_blocked_s = get_spmv_blocked_string();
+        std::string axpy_s = get_axpy_string();
+        for (const std::string *source : {&cpr_weights_s, &cpr_coarse_matrix_s, &cpr_restrict_s, &cpr_prolongate_s,
+                                          &amg_residual_s, &amg_jacobi_s, &amg_restrict_s, &amg_prolongate_s,
+                                          &amg_dense_mv_s, &spmv_blocked_s, &axpy_s}) {
+            sources.emplace_back(std::make_pair(source->c_str(), source->size()));
+        }
+
+        std::vector<cl::Device> devices = context->getInfo<CL_CONTEXT_DEVICES>();
+        cl::Program program = buildProgram(*context, devices, sources, kernel_cache_dir);
+
+        cpr_weights_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, const unsigned int>(cl::Kernel(program, "cpr_weights")));
+        cpr_coarse_matrix_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, const unsigned int>(cl::Kernel(program, "cpr_coarse_matrix")));
+        cpr_restrict_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int>(cl::Kernel(program, "cpr_restrict")));
+        cpr_prolongate_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, const unsigned int>(cl::Kernel(program, "cpr_prolongate")));
+        amg_residual_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, cl::Buffer&, cl::Buffer&, cl::Buffer&>(cl::Kernel(program, "amg_residual")));
+        amg_jacobi_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const double, const unsigned int>(cl::Kernel(program, "amg_jacobi")));
+        amg_restrict_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, const unsigned int, cl::Buffer&, cl::Buffer&>(cl::Kernel(program, "amg_restrict")));
+        amg_prolongate_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int>(cl::Kernel(program, "amg_prolongate")));
+        amg_dense_mv_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int>(cl::Kernel(program, "amg_dense_mv")));
+        spmv_blocked_k.reset(new spmv_kernel_type(cl::Kernel(program, "spmv_blocked")));
+        axpy_k.reset(new cl::make_kernel<cl::Buffer&, const double, cl::Buffer&, const unsigned int>(cl::Kernel(program, "axpy")));
+    });
+}
+
+
+template <unsigned int block_size>
+bool CPR<block_size>::init(BlockedMatrix<block_size> *rmat, cl::Buffer& d_Avals_, cl::Buffer& d_Acols_, cl::Buffer& d_Arows_, BILU0<block_size> *bilu0_) {
+    Nb = rmat->Nb;
+    N = Nb * block_size;
+    nnzb = rmat->nnzbs;
+    d_Avals = d_Avals_;
+    d_Acols = d_Acols_;
+    d_Arows = d_Arows_;
+    bilu0 = bilu0_;
+
+    diagIndex.resize(Nb);
+    for (int row = 0; row < Nb; ++row) {
+        int *rowStart = rmat->colIndices + rmat->rowPointers[row];
+        int *rowEnd = rmat->colIndices + rmat->rowPointers[row + 1];
+        int *candidate = std::find(rowStart, rowEnd, row);
+        if (candidate == rowEnd) {
+            OpmLog::error("CPR could not find a diagonal block in row " + std::to_string(row));
+            return false;
+        }
+        diagIndex[row] = candidate - rmat->colIndices;
+    }
+
+    // the pressure matrix has the sparsity pattern of the blocked matrix
+    levels.resize(1);
+    AmgLevel& pressure = levels[0];
+    pressure.N = Nb;
+    pressure.vals.resize(nnzb);
+    pressure.rows.assign(rmat->rowPointers, rmat->rowPointers + Nb + 1);
+    pressure.cols.assign(rmat->colIndices, rmat->colIndices + nnzb);
+
+    try {
+        build_kernels();
+
+        d_weights = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
+        d_diagIndex = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * Nb);
+        d_t = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
+        d_rs = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
+        pressure.d_vals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * nnzb);
+        pressure.d_cols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * nnzb);
+        pressure.d_rows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (Nb + 1));
+        pressure.d_invDiag = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * Nb);
+        pressure.d_x = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * Nb);
+        pressure.d_b = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * Nb);
+        pressure.d_r = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * Nb);
+
+        err = queue->enqueueWriteBuffer(d_diagIndex, CL_TRUE, 0, sizeof(int) * Nb, diagIndex.data());
+        err |= queue->enqueueWriteBuffer(pressure.d_cols, CL_TRUE, 0, sizeof(int) * nnzb, pressure.cols.data());
+        err |= queue->enqueueWriteBuffer(pressure.d_rows, CL_TRUE, 0, sizeof(int) * (Nb + 1), pressure.rows.data());
+        if (err != CL_SUCCESS) {
+            // enqueueWriteBuffer is C and does not throw exceptions like C++ OpenCL
+            OPM_THROW(std::logic_error, "CPR OpenCL enqueueWriteBuffer error");
+        }
+    } catch (const cl::Error& error) {
+        std::ostringstream oss;
+        oss << "CPR OpenCL Error: " << error.what() << "(" << error.err() << ")";
+        OpmLog::error(oss.str());
+        return false;
+    }
+
+    return true;
+} // end init()
+
+
+template <unsigned int block_size>
+void CPR<block_size>::set_inv_diag(AmgLevel& level) {
+    level.invDiag.assign(level.N, 0.0);
+    for (int row = 0; row < level.N; ++row) {
+        for (int k = level.rows[row]; k < level.rows[row + 1]; ++k) {
+            if (level.cols[k] == row && level.vals[k] != 0.0) {
+                level.invDiag[row] = 1.0 / level.vals[k];
+            }
+        }
+    }
+}
+
+
+template <unsigned int block_size>
+int CPR<block_size>::aggregate(AmgLevel& level) {
+    const int n = level.N;
+    level.aggregates.assign(n, -1);
+
+    std::vector<double> max_offdiag(n, 0.0);
+    for (int row = 0; row < n; ++row) {
+        for (int k = level.rows[row]; k < level.rows[row + 1]; ++k) {
+            if (level.cols[k] != row) {
+                max_offdiag[row] = std::max(max_offdiag[row], std::fabs(level.vals[k]));
+            }
+        }
+    }
+    auto strong = [&](int row, int k) {
+        return level.cols[k] != row && max_offdiag[row] > 0.0
+            && std::fabs(level.vals[k]) >= strength_threshold * max_offdiag[row];
+    };
+
+    int num_aggs = 0;
+    // pass 1: a row whose strong neighbours are all free starts a new aggregate with them
+    for (int row = 0; row < n; ++row) {
+        if (level.aggregates[row] != -1) {
+            continue;
+        }
+        bool all_free = true;
+        for (int k = level.rows[row]; k < level.rows[row + 1] && all_free; ++k) {
+            if (strong(row, k) && level.aggregates[level.cols[k]] != -1) {
+                all_free = false;
+            }
+        }
+        if (!all_free) {
+            continue;
+        }
+        level.aggregates[row] = num_aggs;
+        for (int k = level.rows[row]; k < level.rows[row + 1]; ++k) {
+            if (strong(row, k)) {
+                level.aggregates[level.cols[k]] = num_aggs;
+            }
+        }
+        num_aggs++;
+    }
+
+    // pass 2: the remaining rows join the aggregate of their strongest aggregated neighbour
+    for (int row = 0; row < n; ++row) {
+        if (level.aggregates[row] != -1) {
+            continue;
+        }
+        int best = -1;
+        double best_val = 0.0;
+        for (int k = level.rows[row]; k < level.rows[row + 1]; ++k) {
+            const int agg = level.aggregates[level.cols[k]];
+            if (strong(row, k) && agg != -1 && std::fabs(level.vals[k]) > best_val) {
+                best = agg;
+                best_val = std::fabs(level.vals[k]);
+            }
+        }
+        level.aggregates[row] = (best == -1) ? num_aggs++ : best;
+    }
+
+    return num_aggs;
+} // end aggregate()
+
+
+template <unsigned int block_size>
+void CPR<block_size>::galerkin_product(AmgLevel& fine, AmgLevel& coarse, int num_aggs) {
+    // P^T as CSR, lists the fine rows of every aggregate
+    fine.ptRows.assign(num_aggs + 1, 0);
+    for (int row = 0; row < fine.N; ++row) {
+        fine.ptRows[fine.aggregates[row] + 1]++;
+    }
+    for (int agg = 0; agg < num_aggs; ++agg) {
+        fine.ptRows[agg + 1] += fine.ptRows[agg];
+    }
+    fine.ptCols.resize(fine.N);
+    std::vector<int> pos(fine.ptRows.begin(), fine.ptRows.end() - 1);
+    for (int row = 0; row < fine.N; ++row) {
+        fine.ptCols[pos[fine.aggregates[row]]++] = row;
+    }
+
+    // with a piecewise constant P, every a_ij is added to A_c[agg(i)][agg(j)]
+    coarse.N = num_aggs;
+    coarse.rows.resize(num_aggs + 1);
+    coarse.rows[0] = 0;
+    coarse.cols.clear();
+    coarse.vals.clear();
+    std::vector<int> marker(num_aggs, -1);
+    for (int agg = 0; agg < num_aggs; ++agg) {
+        const int row_start = coarse.cols.size();
+        for (int p = fine.ptRows[agg]; p < fine.ptRows[agg + 1]; ++p) {
+            const int row = fine.ptCols[p];
+            for (int k = fine.rows[row]; k < fine.rows[row + 1]; ++k) {
+                const int col = fine.aggregates[fine.cols[k]];
+                if (marker[col] < row_start) {
+                    marker[col] = coarse.cols.size();
+                    coarse.cols.push_back(col);
+                    coarse.vals.push_back(fine.vals[k]);
+                } else {
+                    coarse.vals[marker[col]] += fine.vals[k];
+                }
+            }
+        }
+        coarse.rows[agg + 1] = coarse.cols.size();
+    }
+    set_inv_diag(coarse);
+} // end galerkin_product()
+
+
+template <unsigned int block_size>
+bool CPR<block_size>::invert_coarsest() {
+    const AmgLevel& level = levels.back();
+    const int n = level.N;
+    coarse_inv.clear();
+    if (n > coarse_size) {
+        return false;
+    }
+
+    std::vector<double> A(n * n, 0.0);
+    double max_abs = 0.0;
+    for (int row = 0; row < n; ++row) {
+        for (int k = level.rows[row]; k < level.rows[row + 1]; ++k) {
+            A[row * n + level.cols[k]] += level.vals[k];
+            max_abs = std::max(max_abs, std::fabs(level.vals[k]));
+        }
+    }
+    std::vector<double> inv(n * n, 0.0);
+    for (int row = 0; row < n; ++row) {
+        inv[row * n + row] = 1.0;
+    }
+
+    // gauss-jordan elimination with partial pivoting
+    for (int k = 0; k < n; ++k) {
+        int piv = k;
+        for (int i = k + 1; i < n; ++i) {
+            if (std::fabs(A[i * n + k]) > std::fabs(A[piv * n + k])) {
+                piv = i;
+            }
+        }
+        if (std::fabs(A[piv * n + k]) <= 1e-14 * max_abs) {
+            return false;
+        }
+        if (piv != k) {
+            std::swap_ranges(A.begin() + k * n, A.begin() + (k + 1) * n, A.begin() + piv * n);
+            std::swap_ranges(inv.begin() + k * n, inv.begin() + (k + 1) * n, inv.begin() + piv * n);
+        }
+        const double pivot = A[k * n + k];
+        for (int j = 0; j < n; ++j) {
+            A[k * n + j] /= pivot;
+            inv[k * n + j] /= pivot;
+        }
+        for (int i = 0; i < n; ++i) {
+            const double f = A[i * n + k];
+            if (i == k || f == 0.0) {
+                continue;
+            }
+            for (int j = 0; j < n; ++j) {
+                A[i * n + j] -= f * A[k * n + j];
+                inv[i * n + j] -= f * inv[k * n + j];
+            }
+        }
+    }
+
+    coarse_inv = std::move(inv);
+    return true;
+} // end invert_coarsest()
+
+
+template <unsigned int block_size>
+void CPR<block_size>::upload_hierarchy() {
+    // the pattern of levels[0] is uploaded in init(), its values are computed on GPU
+    err = queue->enqueueWriteBuffer(levels[0].d_invDiag, CL_TRUE, 0, sizeof(double) * Nb, levels[0].invDiag.data());
+
+    // the coarser levels change with every matrix, their buffers are made again
+    for (unsigned int l = 0; l < levels.size(); ++l) {
+        AmgLevel& level = levels[l];
+        if (l > 0) {
+            const int nnz = level.rows[level.N];
+            level.d_vals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * nnz);
+            level.d_cols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * nnz);
+            level.d_rows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (level.N + 1));
+            level.d_invDiag = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * level.N);
+            level.d_x = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * level.N);
+            level.d_b = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * level.N);
+            level.d_r = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * level.N);
+            err |= queue->enqueueWriteBuffer(level.d_vals, CL_TRUE, 0, sizeof(double) * nnz, level.vals.data());
+            err |= queue->enqueueWriteBuffer(level.d_cols, CL_TRUE, 0, sizeof(int) * nnz, level.cols.data());
+            err |= queue->enqueueWriteBuffer(level.d_rows, CL_TRUE, 0, sizeof(int) * (level.N + 1), level.rows.data());
+            err |= queue->enqueueWriteBuffer(level.d_invDiag, CL_TRUE, 0, sizeof(double) * level.N, level.invDiag.data());
+        }
+        if (l + 1 < levels.size()) {
+            const int num_aggs = levels[l + 1].N;
+            level.d_aggregates = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * level.N);
+            level.d_ptRows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * (num_aggs + 1));
+            level.d_ptCols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * level.N);
+            err |= queue->enqueueWriteBuffer(level.d_aggregates, CL_TRUE, 0, sizeof(int) * level.N, level.aggregates.data());
+            err |= queue->enqueueWriteBuffer(level.d_ptRows, CL_TRUE, 0, sizeof(int) * (num_aggs + 1), level.ptRows.data());
+            err |= queue->enqueueWriteBuffer(level.d_ptCols, CL_TRUE, 0, sizeof(int) * level.N, level.ptCols.data());
+        }
+    }
+
+    if (!coarse_inv.empty()) {
+        d_coarse_inv = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * coarse_inv.size());
+        err |= queue->enqueueWriteBuffer(d_coarse_inv, CL_TRUE, 0, sizeof(double) * coarse_inv.size(), coarse_inv.data());
+    }
+
+    if (err != CL_SUCCESS) {
+        // enqueueWriteBuffer is C and does not throw exceptions like C++ OpenCL
+        OPM_THROW(std::logic_error, "CPR OpenCL enqueueWriteBuffer error");
+    }
+} // end upload_hierarchy()
+
+
+template <unsigned int block_size>
+bool CPR<block_size>::create_preconditioner() {
+    Timer t;
+    const unsigned int work_group_size = 32;
+
+    try {
+        // the queue is in-order, so these run after the upload of the matrix by the solver backend
+        (*cpr_weights_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(Nb)), cl::NDRange(work_group_size)), d_Avals, d_diagIndex, d_weights, Nb, block_size, pressure_idx);
+        (*cpr_coarse_matrix_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(Nb)), cl::NDRange(work_group_size)), d_Avals, d_Arows, d_weights, levels[0].d_vals, Nb, block_size, pressure_idx);
+        err = queue->enqueueReadBuffer(levels[0].d_vals, CL_TRUE, 0, sizeof(double) * nnzb, levels[0].vals.data());
+        if (err != CL_SUCCESS) {
+            OPM_THROW(std::logic_error, "CPR OpenCL enqueueReadBuffer error");
+        }
+
+        Timer t_amg;
+        levels.resize(1);
+        set_inv_diag(levels[0]);
+        while (static_cast<int>(levels.size()) < max_levels && levels.back().N > coarse_size) {
+            const int fine = levels.size() - 1;
+            const int num_aggs = aggregate(levels[fine]);
+            if (num_aggs >= levels[fine].N) {
+                // no coarsening possible
+                levels[fine].aggregates.clear();
+                break;
+            }
+            levels.emplace_back();
+            galerkin_product(levels[fine], levels.back(), num_aggs);
+        }
+        if (!invert_coarsest() && verbosity >= 3) {
+            OpmLog::info("CPR coarsest level is not inverted, using jacobi sweeps");
+        }
+
+        if (verbosity >= 3) {
+            std::ostringstream out;
+            out << "CPR AMG setup: " << t_amg.stop() << " s, levels:";
+            for (const auto& level : levels) {
+                out << " " << level.N;
+            }
+            OpmLog::info(out.str());
+        }
+
+        upload_hierarchy();
+    } catch (const cl::Error& error) {
+        std::ostringstream oss;
+        oss << "CPR OpenCL Error: " << error.what() << "(" << error.err() << ")";
+        OpmLog::error(oss.str());
+        return false;
+    }
+
+    if (verbosity >= 3) {
+        std::ostringstream out;
+        out << "CPR create_preconditioner: " << t.stop() << " s";
+        OpmLog::info(out.str());
+    }
+    return true;
+} // end create_preconditioner()
+
+
+template <unsigned int block_size>
+void CPR<block_size>::jacobi_sweeps(AmgLevel& level, int sweeps) {
+    const unsigned int work_group_size = 32;
+    const unsigned int total_work_items = num_work_items(level.N);
+    for (int s = 0; s < sweeps; ++s) {
+        (*amg_residual_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), level.d_vals, level.d_cols, level.d_rows, level.N, level.d_x, level.d_b, level.d_r);
+        (*amg_jacobi_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), level.d_invDiag, level.d_r, level.d_x, jacobi_omega, level.N);
+    }
+}
+
+
+template <unsigned int block_size>
+void CPR<block_size>::amg_cycle(int l) {
+    const unsigned int work_group_size = 32;
+    AmgLevel& level = levels[l];
+
+    if (l + 1 == static_cast<int>(levels.size())) {
+        if (!coarse_inv.empty()) {
+            (*amg_dense_mv_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(level.N)), cl::NDRange(work_group_size)), d_coarse_inv, level.d_b, level.d_x, level.N);
+        } else {
+            queue->enqueueFillBuffer(level.d_x, 0, 0, sizeof(double) * level.N);
+            jacobi_sweeps(level, num_coarse_sweeps);
+        }
+        return;
+    }
+
+    AmgLevel& next = levels[l + 1];
+    queue->enqueueFillBuffer(level.d_x, 0, 0, sizeof(double) * level.N);
+    jacobi_sweeps(level, num_pre_smooth);
+    (*amg_residual_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(level.N)), cl::NDRange(work_group_size)), level.d_vals, level.d_cols, level.d_rows, level.N, level.d_x, level.d_b, level.d_r);
+    (*amg_restrict_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(next.N)), cl::NDRange(work_group_size)), level.d_ptCols, level.d_ptRows, next.N, level.d_r, next.d_b);
+    amg_cycle(l + 1);
+    (*amg_prolongate_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(level.N)), cl::NDRange(work_group_size)), level.d_aggregates, next.d_x, level.d_x, level.N);
+    jacobi_sweeps(level, num_post_smooth);
+}
+
+
+// kernels are blocking on an NVIDIA GPU, so waiting for events is not needed
+// behavior on other GPUs is untested
+template <unsigned int block_size>
+void CPR<block_size>::apply(cl::Buffer& b, cl::Buffer& x) {
+    const unsigned int work_group_size = 32;
+    const unsigned int lmem_per_work_group = sizeof(double) * work_group_size;
+    Timer t_apply;
+
+    // first stage: x = P * AMG(R * b)
+    (*cpr_restrict_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(Nb)), cl::NDRange(work_group_size)), d_weights, b, levels[0].d_b, Nb, block_size);
+    amg_cycle(0);
+    (*cpr_prolongate_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(N)), cl::NDRange(work_group_size)), levels[0].d_x, x, Nb, block_size, pressure_idx);
+
+    // second stage: x += BILU0(b - A * x)
+    (*spmv_blocked_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(N)), cl::NDRange(work_group_size)), d_Avals, d_Acols, d_Arows, Nb, x, d_t, block_size, cl::Local(lmem_per_work_group));
+    queue->enqueueCopyBuffer(b, d_rs, 0, 0, sizeof(double) * N);
+    (*axpy_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(N)), cl::NDRange(work_group_size)), d_t, -1.0, d_rs, N);
+    bilu0->apply(d_rs, d_t);
+    cl::Event event = (*axpy_k)(cl::EnqueueArgs(*queue, cl::NDRange(num_work_items(N)), cl::NDRange(work_group_size)), d_t, 1.0, x, N);
+
+    if (verbosity >= 4) {
+        event.wait();
+        std::ostringstream out;
+        out << "CPR apply: " << t_apply.stop() << " s";
+        OpmLog::info(out.str());
+    }
+}
+
+
+#define INSTANTIATE_BDA_FUNCTIONS(n)                                                                        \
+template CPR<n>::CPR(int, int);                                                                             \
+template bool CPR<n>::init(BlockedMatrix<n>*, cl::Buffer&, cl::Buffer&, cl::Buffer&, BILU0<n>*);           \
+template bool CPR<n>::create_preconditioner();                                                              \
+template void CPR<n>::apply(cl::Buffer&, cl::Buffer&);                                                      \
+template void CPR<n>::setOpenCLContext(cl::Context*);                                                       \
+template void CPR<n>::setOpenCLQueue(cl::CommandQueue*);
+
+INSTANTIATE_BDA_FUNCTIONS(1);
+INSTANTIATE_BDA_FUNCTIONS(2);
+INSTANTIATE_BDA_FUNCTIONS(3);
+INSTANTIATE_BDA_FUNCTIONS(4);
+
+#undef INSTANTIATE_BDA_FUNCTIONS
+
+} // end namespace bda
@@ -0,0 +1,162 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CPR_HPP
+#define CPR_HPP
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <opm/simulators/linalg/bda/BlockedMatrix.hpp>
+#include <opm/simulators/linalg/bda/BILU0.hpp>
+
+#include <opm/simulators/linalg/bda/opencl.hpp>
+#include <opm/simulators/linalg/bda/openclKernels.hpp>
+
+namespace bda
+{
+
+    /// This class implements a two-stage CPR preconditioner on GPU
+    /// The quasi-IMPES weights and the pressure matrix are computed on GPU,
+    /// the pressure matrix is copied to the CPU, where an aggregation AMG hierarchy is set up.
+    /// The hierarchy is copied back and applied on GPU as a V-cycle with damped jacobi smoothing.
+    /// The second stage is the BILU0 of the full system:
+    ///     x = P * AMG(R * b)
+    ///     x += BILU0(b - A * x)
+    /// Well contributions that are not added to the matrix are not seen by the preconditioner
+    template <unsigned int block_size>
+    class CPR
+    {
+
+    private:
+        // AMG settings
+        static constexpr int max_levels = 10;              // maximum number of levels, including the pressure level
+        static constexpr int coarse_size = 200;            // stop coarsening when a level has at most this many rows
+        static constexpr double strength_threshold = 0.25; // a_ij is strong if |a_ij| >= threshold * max_k(|a_ik|), k != i
+        static constexpr double jacobi_omega = 2.0 / 3.0;  // damping of the jacobi smoother
+        static constexpr int num_pre_smooth = 1;
+        static constexpr int num_post_smooth = 1;
+        static constexpr int num_coarse_sweeps = 20;       // jacobi sweeps on the coarsest level, if it is too large to invert
+
+        // one level of the AMG hierarchy, the matrix is scalar CSR
+        struct AmgLevel {
+            int N = 0;
+            std::vector<double> vals, invDiag;
+            std::vector<int> rows, cols;
+            std::vector<int> aggregates;    // aggregate in the next level of every row, empty on the coarsest level
+            std::vector<int> ptRows, ptCols; // rows of every aggregate, as CSR
+            cl::Buffer d_vals, d_cols, d_rows, d_invDiag;
+            cl::Buffer d_aggregates, d_ptRows, d_ptCols;
+            cl::Buffer d_x, d_b, d_r;
+        };
+
+        int N;       // number of rows of the blocked matrix
+        int Nb;      // number of blockrows of the blocked matrix
+        int nnzb;    // number of blocks of the blocked matrix
+        int verbosity;
+        int pressure_idx;
+
+        BILU0<block_size> *bilu0;          // second stage, owned by the solver backend
+        std::vector<AmgLevel> levels;      // levels[0] is the pressure matrix, with the pattern of the blocked matrix
+        std::vector<double> coarse_inv;    // dense inverse of the coarsest level, empty if it could not be made
+        std::vector<int> diagIndex;
+
+        cl::Buffer d_Avals, d_Acols, d_Arows;     // blocked matrix on GPU, filled by the solver backend
+        cl::Buffer d_weights, d_diagIndex, d_coarse_inv;
+        cl::Buffer d_t, d_rs;                     // blocked vectors for the second stage
+
+        cl::Context *context;
+        cl::CommandQueue *queue;
+        std::once_flag kernels_built;
+        std::string kernel_cache_dir;     // directory of the cached program binaries, empty to always build from the sources
+        cl_int err;
+
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, const unsigned int> > cpr_weights_k;
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, const unsigned int> > cpr_coarse_matrix_k;
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int> > cpr_restrict_k;
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, const unsigned int> > cpr_prolongate_k;
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, cl::Buffer&, cl::Buffer&, cl::Buffer&> > amg_residual_k;
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const double, const unsigned int> > amg_jacobi_k;
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, const unsigned int, cl::Buffer&, cl::Buffer&> > amg_restrict_k;
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int> > amg_prolongate_k;
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int> > amg_dense_mv_k;
+        std::unique_ptr<spmv_kernel_type> spmv_blocked_k;
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, const double, cl::Buffer&, const unsigned int> > axpy_k;
+
+        void build_kernels();
+
+        /// Make the aggregates of a level, based on the strong couplings
+        /// \param[inout] level    level to be coarsened, its aggregates are set
+        /// \return                number of aggregates
+        int aggregate(AmgLevel& level);
+
+        /// Make the next level with the galerkin product P^T * A * P, P is the piecewise constant prolongation of the aggregates
+        /// \param[inout] fine       fine level, its ptRows and ptCols are set
+        /// \param[out] coarse       coarse level
+        /// \param[in] num_aggs      number of aggregates of the fine level
+        void galerkin_product(AmgLevel& fine, AmgLevel& coarse, int num_aggs);
+
+        /// Store the inverse of the diagonal of a level, for the jacobi smoother
+        void set_inv_diag(AmgLevel& level);
+
+        /// Invert the dense matrix of the coarsest level
+        /// \return                  false if the matrix is (close to) singular
+        bool invert_coarsest();
+
+        /// Copy the hierarchy to the GPU
+        void upload_hierarchy();
+
+        /// Apply a V-cycle on level, solves levels[level].x = AMG(levels[level].b)
+        void amg_cycle(int level);
+
+        /// Apply damped jacobi sweeps on a level
+        void jacobi_sweeps(AmgLevel& level, int sweeps);
+
+        unsigned int num_work_items(unsigned int size);
+
+    public:
+
+        CPR(int verbosity, int pressure_idx);
+
+        /// Set up the parts that depend only on the sparsity pattern, must be called after the BILU0 is initialized
+        /// \param[in] rmat       (reordered) blocked matrix, as used on the GPU
+        /// \param[in] d_Avals    nonzeroes of rmat on GPU
+        /// \param[in] d_Acols    columnindices of rmat on GPU
+        /// \param[in] d_Arows    rowpointers of rmat on GPU
+        /// \param[in] bilu0      the BILU0 used as second stage
+        bool init(BlockedMatrix<block_size> *rmat, cl::Buffer& d_Avals, cl::Buffer& d_Acols, cl::Buffer& d_Arows, BILU0<block_size> *bilu0);
+
+        /// Compute the weights, pressure matrix and AMG hierarchy, d_Avals must contain the current matrix
+        /// The BILU0 must be created separately
+        bool create_preconditioner();
+
+        /// apply preconditioner, x = prec(b)
+        void apply(cl::Buffer& b, cl::Buffer& x);
+
+        void setOpenCLContext(cl::Context *context);
+        void setOpenCLQueue(cl::CommandQueue *queue);
+        void setKernelCache(const std::string& dir);
+
+    };
+
+} // end namespace bda
+
+#endif
+
@@ -18,6 +18,9 @@
 */
 
 
+#include <algorithm>
+#include <cmath>
+
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <dune/common/timer.hh>
@@ -470,25 +473,98 @@ __kernel void chow_patel_ilu_sweep(
 
 #endif
 
+// computes partial sums of the squared difference between two arrays, and of the squares of the new array
+// each workgroup writes 2 values: out[2*group] = sum (new-old)^2, out[2*group+1] = sum new^2
+inline const char* chow_patel_ilu_diff_s  = R"(
+__kernel void chow_patel_ilu_diff(
+    __global const double *new_vals,
+    __global const double *old_vals,
+    __global double *out,
+    const unsigned int N,
+    __local double *tmp_diff,
+    __local double *tmp_vals)
+{
+    unsigned int tid = get_local_id(0);
+    unsigned int bsize = get_local_size(0);
+    unsigned int bid = get_global_id(0) / bsize;
+    unsigned int i = get_global_id(0);
+    unsigned int NUM_THREADS = get_global_size(0);
+
+    double diff = 0.0;
+    double vals = 0.0;
+    while(i < N){
+        double d = new_vals[i] - old_vals[i];
+        diff += d * d;
+        vals += new_vals[i] * new_vals[i];
+        i += NUM_THREADS;
+    }
+    tmp_diff[tid] = diff;
+    tmp_vals[tid] = vals;
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // do reduction in shared mem
+    for(unsigned int s = get_local_size(0) / 2; s > 0; s >>= 1)
+    {
+        if (tid < s)
+        {
+            tmp_diff[tid] += tmp_diff[tid + s];
+            tmp_vals[tid] += tmp_vals[tid + s];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    // write result for this block to global mem
+    if (tid == 0){
+        out[2 * bid] = tmp_diff[0];
+        out[2 * bid + 1] = tmp_vals[0];
+    }
+}
+)";
+
 
+double ChowPatelIlu::relative_change(cl::CommandQueue *queue, cl::Buffer& new_vals, cl::Buffer& old_vals, int size)
+{
+    const unsigned int work_group_size = 256;
+    const unsigned int num_work_groups = 64;
+    const unsigned int total_work_items = num_work_groups * work_group_size;
+    const unsigned int lmem_per_work_group = sizeof(double) * work_group_size;
 
+    (*chow_patel_ilu_diff_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)),
+        new_vals, old_vals, d_diff, size, cl::Local(lmem_per_work_group), cl::Local(lmem_per_work_group));
 
+    h_diff.resize(2 * num_work_groups);
+    queue->enqueueReadBuffer(d_diff, CL_TRUE, 0, sizeof(double) * 2 * num_work_groups, h_diff.data());
+
+    double diff = 0.0, vals = 0.0;
+    for (unsigned int i = 0; i < num_work_groups; ++i) {
+        diff += h_diff[2 * i];
+        vals += h_diff[2 * i + 1];
+    }
+    return vals > 0.0 ? std::sqrt(diff / vals) : 0.0;
+}
 
 
 
-void ChowPatelIlu::decomposition(
+
+
+
+
+int ChowPatelIlu::decomposition(
     cl::CommandQueue *queue, cl::Context *context,
     int *Ut_ptrs, int *Ut_idxs, double *Ut_vals, int Ut_nnzbs,
     int *L_rows, int *L_cols, double *L_vals, int L_nnzbs,
     int *LU_rows, int *LU_cols, double *LU_vals, int LU_nnzbs,
-    int Nb, int num_sweeps, int verbosity)
+    int Nb, int num_sweeps, double tolerance, int verbosity)
 {
     const int block_size = 3;
+    int sweeps_done = 0;
 
     try {
         // just put everything in the capture list
         std::call_once(initialize_flag, [&](){
             cl::Program::Sources source(1, std::make_pair(chow_patel_ilu_sweep_s, strlen(chow_patel_ilu_sweep_s)));  // what does this '1' mean? cl::Program::Sources is of type 'std::vector<std::pair<const char*, long unsigned int> >'
+            source.emplace_back(std::make_pair(chow_patel_ilu_diff_s, strlen(chow_patel_ilu_diff_s)));
             cl::Program program = cl::Program(*context, source, &err);
             if (err != CL_SUCCESS) {
                 OPM_THROW(std::logic_error, "ChowPatelIlu OpenCL could not create Program");
@@ -505,6 +581,11 @@ void ChowPatelIlu::decomposition(
             if (err != CL_SUCCESS) {
                 OPM_THROW(std::logic_error, "ChowPatelIlu OpenCL could not create Kernel");
             }
+            chow_patel_ilu_diff_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int,
+                                                    cl::LocalSpaceArg, cl::LocalSpaceArg>(cl::Kernel(program, "chow_patel_ilu_diff", &err)));
+            if (err != CL_SUCCESS) {
+                OPM_THROW(std::logic_error, "ChowPatelIlu OpenCL could not create Kernel");
+            }
 
             // allocate GPU memory
             d_Ut_vals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * Ut_nnzbs * block_size * block_size);
@@ -518,6 +599,7 @@ void ChowPatelIlu::decomposition(
             d_LU_cols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * LU_nnzbs);
             d_Ltmp = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * L_nnzbs * block_size * block_size);
             d_Utmp = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * Ut_nnzbs * block_size * block_size);
+            d_diff = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * 2 * 64);
 
             Dune::Timer t_copy_pattern;
             events.resize(6);
@@ -588,12 +670,27 @@ void ChowPatelIlu::decomposition(
                 out << "ChowPatelIlu sweep kernel time: " << t_kernel.stop() << " s";
                 OpmLog::info(out.str());
             }
+            sweeps_done++;
+
+            // stop early if the factors hardly changed during this sweep
+            if (tolerance > 0.0 && sweeps_done < num_sweeps) {
+                const double change = std::max(relative_change(queue, *Larg2, *Larg1, L_nnzbs * block_size * block_size),
+                                               relative_change(queue, *Uarg2, *Uarg1, Ut_nnzbs * block_size * block_size));
+                if (verbosity >= 4){
+                    std::ostringstream out;
+                    out << "ChowPatelIlu sweep " << sweep << ", relative change: " << change;
+                    OpmLog::info(out.str());
+                }
+                if (change < tolerance) {
+                    break;
+                }
+            }
         }
 
         // copy back
         Dune::Timer t_copy2;
         events.resize(2);
-        if (num_sweeps % 2 == 0) {
+        if (sweeps_done % 2 == 0) {
             err = queue->enqueueReadBuffer(d_Ut_vals, CL_FALSE, 0, sizeof(double) * Ut_nnzbs * block_size * block_size, Ut_vals, nullptr, &events[0]);
             err |= queue->enqueueReadBuffer(d_L_vals, CL_FALSE, 0, sizeof(double) * L_nnzbs * block_size * block_size, L_vals, nullptr, &events[1]);
         } else {
@@ -622,6 +719,13 @@ void ChowPatelIlu::decomposition(
         // rethrow exception by OPM_THROW in the try{}
         throw error;
     }
+
+    if (verbosity >= 3){
+        std::ostringstream out;
+        out << "ChowPatelIlu sweeps: " << sweeps_done;
+        OpmLog::info(out.str());
+    }
+    return sweeps_done;
 }
 
 
@@ -22,6 +22,7 @@
 
 
 #include <mutex>
+#include <vector>
 
 #include <opm/simulators/linalg/bda/opencl.hpp>
 
@@ -41,6 +42,8 @@ namespace bda
         cl::Buffer d_L_rows, d_L_cols;
         cl::Buffer d_LU_rows, d_LU_cols;
         cl::Buffer d_Ltmp, d_Utmp;
+        cl::Buffer d_diff;           // partial sums for the stopping criterion
+        std::vector<double> h_diff;
 
         cl::Event event;
         std::vector<cl::Event> events;
@@ -52,6 +55,16 @@ namespace bda
                                         cl::Buffer&, cl::Buffer&, cl::Buffer&,
                                         cl::Buffer&, cl::Buffer&,
                                         const int, cl::LocalSpaceArg, cl::LocalSpaceArg> > chow_patel_ilu_sweep_k;
+        std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int,
+                                        cl::LocalSpaceArg, cl::LocalSpaceArg> > chow_patel_ilu_diff_k;
+
+        /// Calculate ||new_vals - old_vals|| / ||new_vals|| on the GPU, only the partial sums are copied to the CPU
+        /// \param[in] queue       OpenCL commandqueue
+        /// \param[in] new_vals    values after the sweep
+        /// \param[in] old_vals    values before the sweep
+        /// \param[in] size        number of doubles in new_vals and old_vals
+        /// \return                relative change
+        double relative_change(cl::CommandQueue *queue, cl::Buffer& new_vals, cl::Buffer& old_vals, int size);
 
     public:
         /// Executes the ChowPatelIlu sweeps
@@ -71,14 +84,16 @@ namespace bda
         /// \param[in] LU_vals       actual nonzeroes for LU (original matrix)
         /// \param[in] LU_nnzbs      number of blocks in LU
         /// \param[in] Nb            number of blockrows
-        /// \param[in] num_sweeps    number of sweeps to be done
+        /// \param[in] num_sweeps    maximum number of sweeps to be done
+        /// \param[in] tolerance     stop when the relative change of L and U during a sweep is below tolerance, 0.0 always does num_sweeps sweeps
         /// \param[in] verbosity     print verbosity
-        void decomposition(
+        /// \return                  number of sweeps done
+        int decomposition(
             cl::CommandQueue *queue, cl::Context *context,
             int *Ut_ptrs, int *Ut_idxs, double *Ut_vals, int Ut_nnzbs,
             int *L_rows, int *L_cols, double *L_vals, int L_nnzbs,
             int *LU_rows, int *LU_cols, double *LU_vals, int LU_nnzbs,
-            int Nb, int num_sweeps, int verbosity);
+            int Nb, int num_sweeps, double tolerance, int verbosity);
 
     };
 
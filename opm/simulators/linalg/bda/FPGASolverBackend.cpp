@@ -19,6 +19,7 @@
 
 #include <config.h>
 
+#include <algorithm>
 #include <cmath>
 
 #include <opm/common/OpmLog/OpmLog.hpp>
@@ -51,8 +52,10 @@ FpgaSolverBackend<block_size>::FpgaSolverBackend(std::string fpga_bitstream, int
     std::ostringstream oss;
     double start = second();
 
-    // currently, only block size == 3 is supported by the FPGA backend
-    assert(block_size == 3);
+    // the bitstream must be built for the block size, the host side supports 2, 3 and 4
+    if (block_size < 2 || block_size > 4) {
+        OPM_THROW(std::logic_error, "fpgaSolver only supports block sizes 2, 3 and 4");
+    }
 
     if (verbosity < 1) {
         perf_call_enabled = false;
@@ -212,8 +215,13 @@ void FpgaSolverBackend<block_size>::get_result(double *x_)
     if (perf_call_enabled) {
         start = second();
     }
-    // apply to results the reordering (stored in toOrder)
-    reorderBlockedVectorByPattern<block_size>(mat->Nb, rx, toOrder, x_);
+    if (wells_applied) {
+        // the solution of the defect correction is in the natural ordering already
+        std::copy(h_x.begin(), h_x.end(), x_);
+    } else {
+        // apply to results the reordering (stored in toOrder)
+        reorderBlockedVectorByPattern<block_size>(mat->Nb, rx, toOrder, x_);
+    }
     // TODO: check if it is more efficient to avoid copying resultsBuffer[0] to rx in solve_system (private)
     if (perf_call_enabled) {
         perf_call.back().s_postprocess = second() - start;
@@ -222,7 +230,7 @@ void FpgaSolverBackend<block_size>::get_result(double *x_)
 
 
 template <unsigned int block_size>
-SolverStatus FpgaSolverBackend<block_size>::solve_system(int N_, int nnz_, int dim, double *vals, int *rows, int *cols, double *b, WellContributions& wellContribs OPM_UNUSED, BdaResult &res)
+SolverStatus FpgaSolverBackend<block_size>::solve_system(int N_, int nnz_, int dim, double *vals, int *rows, int *cols, double *b, WellContributions& wellContribs, BdaResult &res)
 {
     if (initialized == false) {
         initialize(N_, nnz_,  dim, vals, rows, cols);
@@ -235,7 +243,12 @@ SolverStatus FpgaSolverBackend<block_size>::solve_system(int N_, int nnz_, int d
     if (!create_preconditioner()) {
         return SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
     }
-    solve_system(res);
+    wells_applied = wellContribs.getNumWells() > 0;
+    if (wells_applied) {
+        solve_system_with_wells(b, wellContribs, res);
+    } else {
+        solve_system(res);
+    }
 
     if (verbosity >= 1) {
         std::ostringstream oss;
@@ -588,6 +601,98 @@ void FpgaSolverBackend<block_size>::solve_system(BdaResult &res)
 } // end solve_system()
 
 
+template <unsigned int block_size>
+void FpgaSolverBackend<block_size>::solve_system_with_wells(double *b, WellContributions& wellContribs, BdaResult &res)
+{
+    const double start = second();
+    h_x.assign(N, 0.0);
+    h_dx.resize(N);
+    h_r.assign(b, b + N);
+
+    double norm_0 = 0.0;
+    for (double r : h_r) {
+        norm_0 += r * r;
+    }
+    norm_0 = std::sqrt(norm_0);
+    double norm = norm_0;
+
+    BdaResult inner;
+    int corrections = 0;
+    res.iterations = 0;
+    res.converged = norm_0 == 0.0;
+    while (!res.converged && corrections < max_well_corrections) {
+        // the first right hand side was reordered in update_system()
+        if (corrections > 0) {
+            reorderBlockedVectorByPattern<block_size>(mat->Nb, h_r.data(), fromOrder, rb);
+        }
+        solve_system(inner);
+        res.iterations += inner.iterations;
+        ++corrections;
+        if (!inner.converged) {
+            break;
+        }
+        reorderBlockedVectorByPattern<block_size>(mat->Nb, rx, toOrder, h_dx.data());
+        for (int i = 0; i < N; ++i) {
+            h_x[i] += h_dx[i];
+        }
+        const double previous = norm;
+        norm = residual_with_wells(b, wellContribs);
+        res.converged = norm <= tolerance * norm_0;
+        if (norm >= previous) {
+            // the wells are too strong for the defect correction to converge
+            break;
+        }
+    }
+
+    res.reduction = norm_0 > 0.0 ? norm / norm_0 : 0.0;
+    res.conv_rate = std::pow(res.reduction, 1.0 / std::max(res.iterations, 1));
+    res.elapsed = second() - start;
+
+    if (verbosity >= 1) {
+        std::ostringstream oss;
+        oss << "fpgaSolverBackend::" << __func__ << " - corrections: " << corrections << \
+            ", converged: " << res.converged << ", reduction: " << res.reduction;
+        OpmLog::info(oss.str());
+    }
+} // end solve_system_with_wells()
+
+
+template <unsigned int block_size>
+double FpgaSolverBackend<block_size>::residual_with_wells(double *b, WellContributions& wellContribs)
+{
+    const unsigned int bs = block_size;
+
+    // r = b - A * x
+    for (int row = 0; row < mat->Nb; ++row) {
+        double *r = h_r.data() + row * bs;
+        for (unsigned int i = 0; i < bs; ++i) {
+            r[i] = b[row * bs + i];
+        }
+        for (int ij = mat->rowPointers[row]; ij < mat->rowPointers[row + 1]; ++ij) {
+            const double *block = mat->nnzValues + ij * bs * bs;
+            const double *x = h_x.data() + mat->colIndices[ij] * bs;
+            for (unsigned int i = 0; i < bs; ++i) {
+                for (unsigned int j = 0; j < bs; ++j) {
+                    r[i] -= block[i * bs + j] * x[j];
+                }
+            }
+        }
+    }
+
+    // the wells perform y -= C^T * D^-1 * B * x, so apply them to -r to end up with r += C^T * D^-1 * B * x
+    for (double& r : h_r) {
+        r = -r;
+    }
+    wellContribs.applyOnHost(h_x.data(), h_r.data());
+    double norm = 0.0;
+    for (double& r : h_r) {
+        r = -r;
+        norm += r * r;
+    }
+    return std::sqrt(norm);
+} // end residual_with_wells()
+
+
 template <unsigned int block_size>
 void FpgaSolverBackend<block_size>::update_system(double *vals, double *b)
 {
@@ -27,6 +27,8 @@
 #include <linearalgebra/ilu0bicgstab/xilinx/src/sda_app/common/opencl_lib.hpp>
 #include <linearalgebra/ilu0bicgstab/xilinx/src/sda_app/common/fpga_functions_bicgstab.hpp>
 
+#include <vector>
+
 namespace bda
 {
 
@@ -49,6 +51,11 @@ class FpgaSolverBackend : public BdaSolver<block_size>
 private:
     double *rx = nullptr; // reordered x
     double *rb = nullptr; // reordered b
+
+    // the system with the wells is solved by defect correction on the host, see solve_system_with_wells()
+    static constexpr int max_well_corrections = 20;
+    bool wells_applied = false;
+    std::vector<double> h_x, h_dx, h_r;     // solution, correction and residual in the natural ordering
     int *fromOrder = nullptr, *toOrder = nullptr;
     bool analysis_done = false;
     bool level_scheduling = false;
@@ -224,6 +231,20 @@ private:
     /// \param[inout] res         summary of solver result
     void solve_system(BdaResult &res);
 
+    /// Solve the linear system including the wells by defect correction: the
+    /// FPGA kernel runs the complete bicgstab, so the wells cannot be applied in
+    /// its iterations. The residual of the system with the wells is computed on
+    /// the host, and the FPGA solves the system without the wells for the
+    /// correction, until the residual is reduced by the tolerance.
+    /// \param[in] b              input vector, contains N values
+    /// \param[in] wellContribs   WellContributions, applied on the host
+    /// \param[inout] res         summary of solver result
+    void solve_system_with_wells(double *b, WellContributions& wellContribs, BdaResult &res);
+
+    /// Compute r = b - (A - C^T * D^-1 * B) * x on the host, in the natural ordering
+    /// \return                   the 2-norm of r
+    double residual_with_wells(double *b, WellContributions& wellContribs);
+
     /// Generate FPGA backend statistics
     void generate_statistics(void);
 
@@ -248,7 +269,7 @@ public:
     /// \param[in] rows           array of rowPointers, contains N/dim+1 values
     /// \param[in] cols           array of columnIndices, contains nnz values
     /// \param[in] b              input vector, contains N values
-    /// \param[in] wellContribs   WellContributions, not used in FPGA solver because it requires them already added to matrix A
+    /// \param[in] wellContribs   WellContributions, applied on the host, see solve_system_with_wells()
     /// \param[inout] res         summary of solver result
     /// \return                   status code
     SolverStatus solve_system(int N, int nnz, int dim, double *vals, int *rows, int *cols, double *b, WellContributions& wellContribs, BdaResult &res) override;
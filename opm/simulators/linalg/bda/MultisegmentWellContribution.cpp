@@ -109,6 +109,21 @@ void MultisegmentWellContribution::apply(double *h_x, double *h_y)
     }
 }
 
+// the columns of D^-1 are the solutions for the unit vectors
+void MultisegmentWellContribution::denseInverseD(double *Dinv) const
+{
+    std::vector<double> unit(M, 0.0);
+    std::vector<double> column(M);
+    for (unsigned int c = 0; c < M; ++c) {
+        unit[c] = 1.0;
+        umfpack_di_solve(UMFPACK_A, Dcols.data(), Drows.data(), Dvals.data(), column.data(), unit.data(), UMFPACK_Numeric, nullptr, nullptr);
+        unit[c] = 0.0;
+        for (unsigned int r = 0; r < M; ++r) {
+            Dinv[r * M + c] = column[r];
+        }
+    }
+}
+
 #if HAVE_CUDA
 void MultisegmentWellContribution::setCudaStream(cudaStream_t stream_)
 {
@@ -123,6 +123,18 @@ public:
     /// \param[in] toOrder    array with mappings
     /// \param[in] reorder    whether reordering is actually used or not
     void setReordering(int *toOrder, bool reorder);
+
+    /// Compute D^-1 as a dense matrix from the factorization of D
+    /// \param[out] Dinv      M*M doubles, D^-1 in row-major order
+    void denseInverseD(double *Dinv) const;
+
+    /// The data of B and C, to apply the well on a GPU
+    unsigned int getM() const { return M; }
+    unsigned int getMb() const { return Mb; }
+    const std::vector<double>& getBvals() const { return Bvals; }
+    const std::vector<double>& getCvals() const { return Cvals; }
+    const std::vector<unsigned int>& getBcols() const { return Bcols; }
+    const std::vector<unsigned int>& getBrows() const { return Brows; }
 };
 
 } //namespace Opm
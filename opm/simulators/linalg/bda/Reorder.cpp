@@ -21,6 +21,7 @@
 
 #include <opm/common/ErrorMacros.hpp>
 
+#include <opm/simulators/linalg/GraphColoring.hpp>
 #include <opm/simulators/linalg/bda/Reorder.hpp>
 #include <opm/simulators/linalg/bda/BlockedMatrix.hpp>
 
@@ -37,6 +38,23 @@ namespace bda
 template <unsigned int block_size>
 int colorBlockedNodes(int rows, const int *CSRRowPointers, const int *CSRColIndices, const int *CSCColPointers, const int *CSCRowIndices, std::vector<int>& colors, int maxRowsPerColor, int maxColsPerColor)
 {
+    // without restrictions on the size of the colors, the threaded coloring shared with the CPU ILU is used
+    const int totalRows = rows * static_cast<int>(block_size);
+    if (maxRowsPerColor >= totalRows && maxColsPerColor >= totalRows) {
+        auto forEachNeighbor = [CSRRowPointers, CSRColIndices, CSCColPointers, CSCRowIndices](std::size_t i, auto functor) {
+            for (int k = CSRRowPointers[i]; k < CSRRowPointers[i + 1]; k++) {
+                functor(static_cast<std::size_t>(CSRColIndices[k]));
+            }
+            for (int k = CSCColPointers[i]; k < CSCColPointers[i + 1]; k++) {
+                functor(static_cast<std::size_t>(CSCRowIndices[k]));
+            }
+        };
+        auto colorsTuple = Opm::Detail::colorJonesPlassmann(rows, forEachNeighbor);
+        const auto& nodeColors = std::get<0>(colorsTuple);
+        std::copy(nodeColors.begin(), nodeColors.end(), colors.begin());
+        return std::get<1>(colorsTuple);
+    }
+
     int left, c;
     const int max_tries = 100;            // since coloring is random, it is possible that a coloring fails. In that case, try again.
     std::vector<int> randoms;
@@ -33,6 +33,7 @@ namespace bda
 /// The color array must be allocated already
 /// This function with throw an error if no coloring can be found within the given restrictions
 /// This function does graph coloring based on random numbers
+/// If the restrictions are at least rows*block_size, the threaded coloring of GraphColoring.hpp is used
 /// \param[in] rows            number of rows in the matrix
 /// \param[in] CSRRowPointers  array of row pointers of the sparsity pattern stored in the CSR format
 /// \param[in] CSRColIndices   array of column indices of the sparsity pattern stored in the CSR format
@@ -20,6 +20,10 @@
 #include <config.h> // CMake
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
@@ -36,7 +40,7 @@ WellContributions::WellContributions(std::string accelerator_mode){
         opencl_gpu = true;
     }
     else if(accelerator_mode.compare("fpga") == 0){
-        // unused for FPGA, but must be defined to avoid error
+        fpga = true;
     }
     else{
         OPM_THROW(std::logic_error, "Invalid accelerator mode");
@@ -63,6 +67,9 @@ WellContributions::~WellContributions()
 
 #if HAVE_OPENCL
     if(opencl_gpu){
+        // the staging buffers must outlive any copy still in flight
+        waitForStandardWellsUpload();
+
         if(num_ms_wells > 0){
             delete[] h_x;
             delete[] h_y;
@@ -82,12 +89,36 @@ void WellContributions::setKernel(stdwell_apply_kernel_type *kernel_, stdwell_ap
     this->kernel_no_reorder = kernel_no_reorder_;
 }
 
+void WellContributions::setMultisegmentKernel(mswell_apply_kernel_type *kernel_, mswell_apply_no_reorder_kernel_type *kernel_no_reorder_){
+    this->ms_kernel = kernel_;
+    this->ms_kernel_no_reorder = kernel_no_reorder_;
+}
+
 void WellContributions::setReordering(int *h_toOrder_, bool reorder_)
 {
     this->h_toOrder = h_toOrder_;
     this->reorder = reorder_;
 }
 
+void WellContributions::enqueueStandardWellsUpload()
+{
+    upload_events.resize(6);
+    queue->enqueueWriteBuffer(*d_Cnnzs_ocl, CL_FALSE, 0, sizeof(double) * h_Cnnzs.size(), h_Cnnzs.data(), nullptr, &upload_events[0]);
+    queue->enqueueWriteBuffer(*d_Dnnzs_ocl, CL_FALSE, 0, sizeof(double) * h_Dnnzs.size(), h_Dnnzs.data(), nullptr, &upload_events[1]);
+    queue->enqueueWriteBuffer(*d_Bnnzs_ocl, CL_FALSE, 0, sizeof(double) * h_Bnnzs.size(), h_Bnnzs.data(), nullptr, &upload_events[2]);
+    queue->enqueueWriteBuffer(*d_Ccols_ocl, CL_FALSE, 0, sizeof(int) * h_Ccols.size(), h_Ccols.data(), nullptr, &upload_events[3]);
+    queue->enqueueWriteBuffer(*d_Bcols_ocl, CL_FALSE, 0, sizeof(int) * h_Bcols.size(), h_Bcols.data(), nullptr, &upload_events[4]);
+    queue->enqueueWriteBuffer(*d_val_pointers_ocl, CL_FALSE, 0, sizeof(unsigned int) * (num_std_wells + 1), val_pointers, nullptr, &upload_events[5]);
+}
+
+void WellContributions::waitForStandardWellsUpload()
+{
+    if (!upload_events.empty()) {
+        cl::WaitForEvents(upload_events);
+        upload_events.clear();
+    }
+}
+
 void WellContributions::apply_stdwells(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrder){
     const unsigned int work_group_size = 32;
     const unsigned int total_work_items = num_std_wells * work_group_size;
@@ -107,7 +138,98 @@ void WellContributions::apply_stdwells(cl::Buffer d_x, cl::Buffer d_y, cl::Buffe
     event.wait();
 }
 
-void WellContributions::apply_mswells(cl::Buffer d_x, cl::Buffer d_y){
+void WellContributions::uploadMultisegmentWells()
+{
+    ms_wells_uploaded = true;
+
+    std::vector<MultisegmentWellContribution*> device_wells;
+    host_multisegments.clear();
+    for (MultisegmentWellContribution *well : multisegments) {
+        if (ms_kernel != nullptr && well->getM() <= max_dense_ms_rows) {
+            device_wells.push_back(well);
+        } else {
+            host_multisegments.push_back(well);
+        }
+    }
+    num_device_ms_wells = device_wells.size();
+    if (num_device_ms_wells == 0) {
+        return;
+    }
+
+    // concatenate the wells, the row pointers are shifted to index the blocks of all wells
+    std::vector<double> h_Cvals, h_Bvals, h_Dinv;
+    std::vector<unsigned int> h_cols, h_rows, h_blockRows, h_wellInfo;
+    std::size_t z_size = 0;
+    for (MultisegmentWellContribution *well : device_wells) {
+        const unsigned int firstBlock = h_cols.size();
+        h_wellInfo.push_back(h_rows.size());
+        h_wellInfo.push_back(well->getMb());
+        h_wellInfo.push_back(h_Dinv.size());
+        h_wellInfo.push_back(z_size);
+
+        const auto& rows = well->getBrows();
+        for (unsigned int row = 0; row < well->getMb(); ++row) {
+            h_rows.push_back(firstBlock + rows[row]);
+            for (unsigned int b = rows[row]; b < rows[row + 1]; ++b) {
+                h_blockRows.push_back(row);
+            }
+        }
+        h_rows.push_back(firstBlock + rows[well->getMb()]);
+
+        h_cols.insert(h_cols.end(), well->getBcols().begin(), well->getBcols().end());
+        h_Bvals.insert(h_Bvals.end(), well->getBvals().begin(), well->getBvals().end());
+        h_Cvals.insert(h_Cvals.end(), well->getCvals().begin(), well->getCvals().end());
+
+        const std::size_t M = well->getM();
+        h_Dinv.resize(h_Dinv.size() + M * M);
+        well->denseInverseD(h_Dinv.data() + h_Dinv.size() - M * M);
+        z_size += 2 * M;
+    }
+
+    auto upload = [this](const auto& h_data) {
+        using T = typename std::decay_t<decltype(h_data)>::value_type;
+        // a buffer of size zero is not allowed
+        auto buffer = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(T) * std::max<std::size_t>(h_data.size(), 1));
+        if (!h_data.empty()) {
+            queue->enqueueWriteBuffer(*buffer, CL_TRUE, 0, sizeof(T) * h_data.size(), h_data.data());
+        }
+        return buffer;
+    };
+    d_ms_Cnnzs = upload(h_Cvals);
+    d_ms_Bnnzs = upload(h_Bvals);
+    d_ms_Dinv = upload(h_Dinv);
+    d_ms_Bcols = upload(h_cols);
+    d_ms_Brows = upload(h_rows);
+    d_ms_blockRows = upload(h_blockRows);
+    d_ms_wellInfo = upload(h_wellInfo);
+    d_ms_z = std::make_unique<cl::Buffer>(*context, CL_MEM_READ_WRITE, sizeof(double) * z_size);
+}
+
+void WellContributions::apply_mswells(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrder){
+    if (!ms_wells_uploaded) {
+        uploadMultisegmentWells();
+    }
+
+    if (num_device_ms_wells > 0) {
+        const unsigned int work_group_size = 64;
+        const unsigned int total_work_items = num_device_ms_wells * work_group_size;
+        cl::Event event;
+        if (reorder) {
+            event = (*ms_kernel)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)),
+                                 *d_ms_Cnnzs, *d_ms_Bnnzs, *d_ms_Dinv, *d_ms_Bcols, *d_ms_Brows, *d_ms_blockRows,
+                                 *d_ms_wellInfo, *d_ms_z, d_x, d_y, d_toOrder, dim, dim_wells);
+        } else {
+            event = (*ms_kernel_no_reorder)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)),
+                                            *d_ms_Cnnzs, *d_ms_Bnnzs, *d_ms_Dinv, *d_ms_Bcols, *d_ms_Brows, *d_ms_blockRows,
+                                            *d_ms_wellInfo, *d_ms_z, d_x, d_y, dim, dim_wells);
+        }
+        event.wait();
+    }
+
+    if (host_multisegments.empty()) {
+        return;
+    }
+
     if(h_x == nullptr){
         h_x = new double[N];
         h_y = new double[N];
@@ -119,8 +241,8 @@ void WellContributions::apply_mswells(cl::Buffer d_x, cl::Buffer d_y){
     cl::WaitForEvents(events);
     events.clear();
 
-    // actually apply MultisegmentWells
-    for(Opm::MultisegmentWellContribution *well: multisegments){
+    // actually apply the MultisegmentWells which are too large for the GPU
+    for(Opm::MultisegmentWellContribution *well: host_multisegments){
         well->setReordering(h_toOrder, reorder);
         well->apply(h_x, h_y);
     }
@@ -134,74 +256,116 @@ void WellContributions::apply_mswells(cl::Buffer d_x, cl::Buffer d_y){
 
 void WellContributions::apply(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrder){
     if(num_std_wells > 0){
+        waitForStandardWellsUpload();
         apply_stdwells(d_x, d_y, d_toOrder);
     }
 
     if(num_ms_wells > 0){
-        apply_mswells(d_x, d_y);
+        apply_mswells(d_x, d_y, d_toOrder);
     }
 }
 #endif
 
-void WellContributions::addMatrix([[maybe_unused]] MatrixType type, [[maybe_unused]] int *colIndices, [[maybe_unused]] double *values, [[maybe_unused]] unsigned int val_size)
+void WellContributions::setVectorSize(unsigned int N_)
+{
+    N = N_;
+}
+
+void WellContributions::applyOnHost(double *h_x_, double *h_y_)
+{
+    std::vector<double> z1(dim_wells), z2(dim_wells);
+    for (unsigned int w = 0; w < num_std_wells; ++w) {
+        const unsigned int first = val_pointers[w];
+        const unsigned int last = val_pointers[w + 1];
+
+        // z1 = B * x
+        std::fill(z1.begin(), z1.end(), 0.0);
+        for (unsigned int b = first; b < last; ++b) {
+            const double *x = h_x_ + h_Bcols[b] * dim;
+            const double *B = h_Bnnzs.data() + b * dim * dim_wells;
+            for (unsigned int r = 0; r < dim_wells; ++r) {
+                for (unsigned int c = 0; c < dim; ++c) {
+                    z1[r] += B[r * dim + c] * x[c];
+                }
+            }
+        }
+
+        // z2 = D^-1 * z1
+        const double *D = h_Dnnzs.data() + w * dim_wells * dim_wells;
+        for (unsigned int r = 0; r < dim_wells; ++r) {
+            z2[r] = 0.0;
+            for (unsigned int c = 0; c < dim_wells; ++c) {
+                z2[r] += D[r * dim_wells + c] * z1[c];
+            }
+        }
+
+        // y -= C^T * z2
+        for (unsigned int b = first; b < last; ++b) {
+            double *y = h_y_ + h_Ccols[b] * dim;
+            const double *C = h_Cnnzs.data() + b * dim * dim_wells;
+            for (unsigned int c = 0; c < dim; ++c) {
+                double temp = 0.0;
+                for (unsigned int j = 0; j < dim_wells; ++j) {
+                    temp += C[j * dim + c] * z2[j];
+                }
+                y[c] -= temp;
+            }
+        }
+    }
+
+    for (Opm::MultisegmentWellContribution *well: multisegments) {
+        well->apply(h_x_, h_y_);
+    }
+}
+
+void WellContributions::addMatrix(MatrixType type, int *colIndices, double *values, unsigned int val_size)
 {
     if (!allocated) {
         OPM_THROW(std::logic_error, "Error cannot add wellcontribution before allocating memory in WellContributions");
     }
 
+    // Only stage the data on the host here, so that adding a well does not
+    // cost a host-device synchronization; everything is copied to the GPU
+    // at once after the last StandardWell is added.
+    switch (type) {
+    case MatrixType::C:
+        std::copy(values, values + val_size * dim * dim_wells, h_Cnnzs.begin() + num_blocks_so_far * dim * dim_wells);
+        std::copy(colIndices, colIndices + val_size, h_Ccols.begin() + num_blocks_so_far);
+        break;
+
+    case MatrixType::D:
+        std::copy(values, values + dim_wells * dim_wells, h_Dnnzs.begin() + num_std_wells_so_far * dim_wells * dim_wells);
+        break;
+
+    case MatrixType::B:
+        std::copy(values, values + val_size * dim * dim_wells, h_Bnnzs.begin() + num_blocks_so_far * dim * dim_wells);
+        std::copy(colIndices, colIndices + val_size, h_Bcols.begin() + num_blocks_so_far);
+        val_pointers[num_std_wells_so_far] = num_blocks_so_far;
+        if (num_std_wells_so_far == num_std_wells - 1) {
+            val_pointers[num_std_wells] = num_blocks;
 #if HAVE_CUDA
-    if(cuda_gpu){
-        addMatrixGpu(type, colIndices, values, val_size);
-    }
+            if(cuda_gpu){
+                copyStandardWellsToGpu();
+            }
 #endif
-
 #if HAVE_OPENCL
-    if(opencl_gpu){
-        switch (type) {
-        case MatrixType::C:
-            events.resize(2);
-            queue->enqueueWriteBuffer(*d_Cnnzs_ocl, CL_FALSE, sizeof(double) * num_blocks_so_far * dim * dim_wells, sizeof(double) * val_size * dim * dim_wells, values, nullptr, &events[0]);
-            queue->enqueueWriteBuffer(*d_Ccols_ocl, CL_FALSE, sizeof(int) * num_blocks_so_far, sizeof(int) * val_size, colIndices, nullptr, &events[1]);
-            cl::WaitForEvents(events);
-            events.clear();
-            break;
-
-        case MatrixType::D:
-            events.resize(1);
-            queue->enqueueWriteBuffer(*d_Dnnzs_ocl, CL_FALSE, sizeof(double) * num_std_wells_so_far * dim_wells * dim_wells, sizeof(double) * dim_wells * dim_wells, values, nullptr, &events[0]);
-            events[0].wait();
-            events.clear();
-            break;
-
-        case MatrixType::B:
-            events.resize(2);
-            queue->enqueueWriteBuffer(*d_Bnnzs_ocl, CL_FALSE, sizeof(double) * num_blocks_so_far * dim * dim_wells, sizeof(double) * val_size * dim * dim_wells, values, nullptr, &events[0]);
-            queue->enqueueWriteBuffer(*d_Bcols_ocl, CL_FALSE, sizeof(int) * num_blocks_so_far, sizeof(int) * val_size, colIndices, nullptr, &events[1]);
-            cl::WaitForEvents(events);
-            events.clear();
-
-            val_pointers[num_std_wells_so_far] = num_blocks_so_far;
-            if (num_std_wells_so_far == num_std_wells - 1) {
-                val_pointers[num_std_wells] = num_blocks;
-                events.resize(1);
-                queue->enqueueWriteBuffer(*d_val_pointers_ocl, CL_FALSE, 0, sizeof(unsigned int) * (num_std_wells + 1), val_pointers, nullptr, &events[0]);
-                events[0].wait();
-                events.clear();
+            if(opencl_gpu){
+                enqueueStandardWellsUpload();
             }
-            break;
-
-        default:
-            OPM_THROW(std::logic_error, "Error unsupported matrix ID for WellContributions::addMatrix()");
+#endif
         }
+        break;
+
+    default:
+        OPM_THROW(std::logic_error, "Error unsupported matrix ID for WellContributions::addMatrix()");
     }
-#endif
 
     if(MatrixType::B == type) {
         num_blocks_so_far += val_size;
         num_std_wells_so_far++;
     }
 
-#if !HAVE_CUDA && !HAVE_OPENCL
+#if !HAVE_CUDA && !HAVE_OPENCL && !HAVE_FPGA
     OPM_THROW(std::logic_error, "Error cannot add StandardWell matrix on GPU because neither CUDA nor OpenCL were found by cmake");
 #endif
 }
@@ -211,9 +375,11 @@ void WellContributions::setBlockSize(unsigned int dim_, unsigned int dim_wells_)
     dim = dim_;
     dim_wells = dim_wells_;
 
-    if(dim != 3 || dim_wells != 4){
+    // the FPGA applies the wells on the host, which works for any block size
+    // the GPU kernels need a whole block to fit in a warp of 32 threads
+    if(!fpga && (dim < 2 || dim > 4 || dim * dim_wells > 32)){
         std::ostringstream oss;
-        oss << "WellContributions::setBlockSize error: dim and dim_wells must be equal to 3 and 4, repectivelly, otherwise the add well contributions kernel won't work.\n";
+        oss << "WellContributions::setBlockSize error: dim must be 2, 3 or 4 and dim * dim_wells at most 32, otherwise the add well contributions kernel won't work.\n";
         OPM_THROW(std::logic_error, oss.str());
     }
 }
@@ -231,6 +397,11 @@ void WellContributions::alloc()
 {
     if (num_std_wells > 0) {
         val_pointers = new unsigned int[num_std_wells + 1];
+        h_Cnnzs.resize(num_blocks * dim * dim_wells);
+        h_Dnnzs.resize(num_std_wells * dim_wells * dim_wells);
+        h_Bnnzs.resize(num_blocks * dim * dim_wells);
+        h_Ccols.resize(num_blocks);
+        h_Bcols.resize(num_blocks);
 
 #if HAVE_CUDA
         if(cuda_gpu){
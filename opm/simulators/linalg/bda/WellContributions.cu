@@ -50,7 +50,7 @@ __global__ void apply_well_contributions(
     const int idx_t = threadIdx.x;
     const unsigned int val_size = val_pointers[idx_b + 1] - val_pointers[idx_b];
 
-    const int vals_per_block = dim * dim_wells;        // 12
+    const int vals_per_block = dim * dim_wells;        // 12 for dim == 3
     const int num_active_threads = (32 / vals_per_block) * vals_per_block; // 24
     const int num_blocks_per_warp = 32 / vals_per_block; // 2
     const int lane = idx_t % 32;
@@ -60,41 +60,32 @@ __global__ void apply_well_contributions(
     extern __shared__ double smem[];
     double * __restrict__ z1 = smem;
     double * __restrict__ z2 = z1 + dim_wells;
-
-    if (idx_t < dim_wells) {
-        z1[idx_t] = 0.0;
-    }
-
-    __syncthreads();
+    double * __restrict__ partial = z2 + dim_wells;     // one partial sum per thread
 
     // z1 = B * x
+    // multiply all blocks with x
+    double sum_b = 0.0;
     if (idx_t < num_active_threads) {
-        // multiply all blocks with x
-        double temp = 0.0;
         int b = idx_t / vals_per_block + val_pointers[idx_b];       // block id, val_size indicates number of blocks
         while (b < val_size + val_pointers[idx_b]) {
             int colIdx = Bcols[b];
-            temp += Bnnzs[b * dim * dim_wells + r * dim + c] * x[colIdx * dim + c];
+            sum_b += Bnnzs[b * dim * dim_wells + r * dim + c] * x[colIdx * dim + c];
             b += num_blocks_per_warp;
         }
+    }
+    partial[lane] = sum_b;
 
-        // merge all blocks into 1 dim*dim_wells block
-        // since NORNE has only 2 parallel blocks, do not use a loop
-        temp += __shfl_down_sync(0x00ffffff, temp, dim * dim_wells);
-
-        b = idx_t / vals_per_block + val_pointers[idx_b];
-
-        // merge all (dim) columns of 1 block, results in a single 1*dim_wells vector, which is used to multiply with invD
-        if (idx_t < vals_per_block) {
-            // should be a loop as well, now only works for dim == 3
-            if (c == 0 || c == 2) {temp += __shfl_down_sync(0x00000B6D, temp, 2);} // add col 2 to col 0
-            if (c == 0 || c == 1) {temp += __shfl_down_sync(0x000006DB, temp, 1);} // add col 1 to col 0
-        }
+    __syncthreads();
 
-        // write 1*dim_wells vector to gmem, could be replaced with shfl broadcast to remove z1 altogether
-        if (c == 0 && idx_t < vals_per_block) {
-            z1[r] = temp;
+    // merge all blocks and all (dim) columns of a row, results in a single 1*dim_wells vector, which is used to multiply with invD
+    if (idx_t < dim_wells) {
+        double sum = 0.0;
+        for (int i = 0; i < num_blocks_per_warp; ++i) {
+            for (int j = 0; j < dim; ++j) {
+                sum += partial[i * vals_per_block + idx_t * dim + j];
+            }
         }
+        z1[idx_t] = sum;
     }
 
     __syncthreads();
@@ -188,35 +179,21 @@ void WellContributions::apply(double *d_x, double *d_y)
 
     // apply StandardWells
     if (num_std_wells > 0) {
-        int smem_size = 2 * sizeof(double) * dim_wells;
+        int smem_size = sizeof(double) * (2 * dim_wells + 32);
         apply_well_contributions <<< num_std_wells, 32, smem_size, stream>>>(d_Cnnzs, d_Dnnzs, d_Bnnzs, d_Ccols, d_Bcols, d_x, d_y, dim, dim_wells, d_val_pointers);
     }
 }
 
 
-void WellContributions::addMatrixGpu(MatrixType type, int *colIndices, double *values, unsigned int val_size)
+void WellContributions::copyStandardWellsToGpu()
 {
-    switch (type) {
-    case MatrixType::C:
-        cudaMemcpy(d_Cnnzs + num_blocks_so_far * dim * dim_wells, values, sizeof(double) * val_size * dim * dim_wells, cudaMemcpyHostToDevice);
-        cudaMemcpy(d_Ccols + num_blocks_so_far, colIndices, sizeof(int) * val_size, cudaMemcpyHostToDevice);
-        break;
-    case MatrixType::D:
-        cudaMemcpy(d_Dnnzs + num_std_wells_so_far * dim_wells * dim_wells, values, sizeof(double) * dim_wells * dim_wells, cudaMemcpyHostToDevice);
-        break;
-    case MatrixType::B:
-        cudaMemcpy(d_Bnnzs + num_blocks_so_far * dim * dim_wells, values, sizeof(double) * val_size * dim * dim_wells, cudaMemcpyHostToDevice);
-        cudaMemcpy(d_Bcols + num_blocks_so_far, colIndices, sizeof(int) * val_size, cudaMemcpyHostToDevice);
-        val_pointers[num_std_wells_so_far] = num_blocks_so_far;
-        if (num_std_wells_so_far == num_std_wells - 1) {
-            val_pointers[num_std_wells] = num_blocks;
-            cudaMemcpy(d_val_pointers, val_pointers, sizeof(unsigned int) * (num_std_wells + 1), cudaMemcpyHostToDevice);
-        }
-        break;
-    default:
-        OPM_THROW(std::logic_error, "Error unsupported matrix ID for WellContributions::addMatrix()");
-    }
-    cudaCheckLastError("WellContributions::addMatrix() failed");
+    cudaMemcpy(d_Cnnzs, h_Cnnzs.data(), sizeof(double) * h_Cnnzs.size(), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_Dnnzs, h_Dnnzs.data(), sizeof(double) * h_Dnnzs.size(), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_Bnnzs, h_Bnnzs.data(), sizeof(double) * h_Bnnzs.size(), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_Ccols, h_Ccols.data(), sizeof(int) * h_Ccols.size(), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_Bcols, h_Bcols.data(), sizeof(int) * h_Bcols.size(), cudaMemcpyHostToDevice);
+    cudaMemcpy(d_val_pointers, val_pointers, sizeof(unsigned int) * (num_std_wells + 1), cudaMemcpyHostToDevice);
+    cudaCheckLastError("WellContributions::copyStandardWellsToGpu() failed");
 }
 
 void WellContributions::setCudaStream(cudaStream_t stream_)
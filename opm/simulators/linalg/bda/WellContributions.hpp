@@ -42,11 +42,14 @@ namespace Opm
 
 using bda::stdwell_apply_kernel_type;
 using bda::stdwell_apply_no_reorder_kernel_type;
+using bda::mswell_apply_kernel_type;
+using bda::mswell_apply_no_reorder_kernel_type;
 
 /// This class serves to eliminate the need to include the WellContributions into the matrix (with --matrix-add-well-contributions=true) for the cusparseSolver
 /// If the --matrix-add-well-contributions commandline parameter is true, this class should not be used
 /// So far, StandardWell and MultisegmentWell are supported
-/// StandardWells are only supported for cusparseSolver (CUDA), MultisegmentWells are supported for both cusparseSolver and openclSolver
+/// StandardWells are supported for cusparseSolver (CUDA) and openclSolver, MultisegmentWells for cusparseSolver and openclSolver
+/// For the fpgaSolver, all wells are applied on the host, see applyOnHost()
 /// A single instance (or pointer) of this class is passed to the BdaSolver.
 /// For StandardWell, this class contains all the data and handles the computation. For MultisegmentWell, the vector 'multisegments' contains all the data. For more information, check the MultisegmentWellContribution class.
 
@@ -78,9 +81,10 @@ public:
 private:
     bool opencl_gpu = false;
     bool cuda_gpu = false;
+    bool fpga = false;                       // the StandardWells are only staged on the host
     bool allocated = false;
 
-    unsigned int N;                          // number of rows (not blockrows) in vectors x and y
+    unsigned int N = 0;                      // number of rows (not blockrows) in vectors x and y
     unsigned int dim;                        // number of columns in blocks in B and C, equal to StandardWell::numEq
     unsigned int dim_wells;                  // number of rows in blocks in B and C, equal to StandardWell::numStaticWellEq
     unsigned int num_blocks = 0;             // total number of blocks in all wells
@@ -90,6 +94,10 @@ private:
     unsigned int num_std_wells_so_far = 0;   // keep track of where next data is written
     unsigned int *val_pointers = nullptr;    // val_pointers[wellID] == index of first block for this well in Ccols and Bcols
 
+    // host-side staging of the StandardWell data, it is copied to the GPU in one go after the last well is added
+    std::vector<double> h_Cnnzs, h_Dnnzs, h_Bnnzs;
+    std::vector<int> h_Ccols, h_Bcols;
+
     double *h_x = nullptr;
     double *h_y = nullptr;
     std::vector<MultisegmentWellContribution*> multisegments;
@@ -100,6 +108,7 @@ private:
     stdwell_apply_kernel_type *kernel;
     stdwell_apply_no_reorder_kernel_type *kernel_no_reorder;
     std::vector<cl::Event> events;
+    std::vector<cl::Event> upload_events;   // pending copies of the StandardWell data, waited for before first use
 
     std::unique_ptr<cl::Buffer> d_Cnnzs_ocl, d_Dnnzs_ocl, d_Bnnzs_ocl;
     std::unique_ptr<cl::Buffer> d_Ccols_ocl, d_Bcols_ocl;
@@ -107,6 +116,17 @@ private:
 
     bool reorder = false;
     int *h_toOrder = nullptr;
+
+    // MultisegmentWells with at most max_dense_ms_rows rows in D are applied on the GPU, with D^-1 stored densely,
+    // larger ones are applied on the host
+    static constexpr unsigned int max_dense_ms_rows = 1024;
+    mswell_apply_kernel_type *ms_kernel = nullptr;
+    mswell_apply_no_reorder_kernel_type *ms_kernel_no_reorder = nullptr;
+    std::vector<MultisegmentWellContribution*> host_multisegments;
+    unsigned int num_device_ms_wells = 0;
+    bool ms_wells_uploaded = false;
+    std::unique_ptr<cl::Buffer> d_ms_Cnnzs, d_ms_Bnnzs, d_ms_Dinv;
+    std::unique_ptr<cl::Buffer> d_ms_Bcols, d_ms_Brows, d_ms_blockRows, d_ms_wellInfo, d_ms_z;
 #endif
 
 #if HAVE_CUDA
@@ -128,12 +148,21 @@ private:
     /// Free GPU memory allocated with cuda.
     void freeCudaMemory();
 
-    /// Store a matrix in this object, in blocked csr format, can only be called after alloc() is called
-    /// \param[in] type        indicate if C, D or B is sent
-    /// \param[in] colIndices  columnindices of blocks in C or B, ignored for D
-    /// \param[in] values      array of nonzeroes
-    /// \param[in] val_size    number of blocks in C or B, ignored for D
-    void addMatrixGpu(MatrixType type, int *colIndices, double *values, unsigned int val_size);
+    /// Copy the staged StandardWell data to the GPU, called once after the last StandardWell is added
+    void copyStandardWellsToGpu();
+#endif
+
+#if HAVE_OPENCL
+    /// Enqueue non-blocking copies of the staged StandardWell data, called once after the last StandardWell is added
+    /// The copies are waited for in apply(), so the host can continue with the rest of the assembly meanwhile
+    void enqueueStandardWellsUpload();
+
+    /// Wait until the StandardWell data is on the GPU
+    void waitForStandardWellsUpload();
+
+    /// Copy the MultisegmentWells which are small enough to the GPU, with D^-1 as a dense matrix
+    /// Called once, in the first apply()
+    void uploadMultisegmentWells();
 #endif
 
 public:
@@ -151,6 +180,7 @@ public:
 
 #if HAVE_OPENCL
     void setKernel(stdwell_apply_kernel_type *kernel_, stdwell_apply_no_reorder_kernel_type *kernel_no_reorder_);
+    void setMultisegmentKernel(mswell_apply_kernel_type *kernel_, mswell_apply_no_reorder_kernel_type *kernel_no_reorder_);
     void setOpenCLEnv(cl::Context *context_, cl::CommandQueue *queue_);
 
     /// Since the rows of the matrix are reordered, the columnindices of the matrixdata is incorrect
@@ -159,10 +189,19 @@ public:
     /// \param[in] reorder    whether reordering is actually used or not
     void setReordering(int *toOrder, bool reorder);
     void apply_stdwells(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrder);
-    void apply_mswells(cl::Buffer d_x, cl::Buffer d_y);
+    void apply_mswells(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrder);
     void apply(cl::Buffer d_x, cl::Buffer d_y, cl::Buffer d_toOrder);
 #endif
 
+    /// Apply all Wells in this object to vectors on the host, in the natural ordering
+    /// performs y -= (C^T * (D^-1 * (B*x))) for all Wells
+    /// \param[in] h_x       vector x
+    /// \param[inout] h_y    vector y
+    void applyOnHost(double *h_x, double *h_y);
+
+    /// Set the number of rows (not blockrows) in the vectors x and y
+    void setVectorSize(unsigned int N);
+
     unsigned int getNumWells(){
         return num_std_wells + num_ms_wells;
     }
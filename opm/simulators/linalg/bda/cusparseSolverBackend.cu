@@ -20,7 +20,10 @@
 #include <config.h>
 
 #include <cuda_runtime.h>
+#include <algorithm>
+#include <cmath>
 #include <sstream>
+#include <vector>
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <dune/common/timer.hh>
@@ -48,6 +51,174 @@ const cusparseOperation_t operation  = CUSPARSE_OPERATION_NON_TRANSPOSE;
 const cusparseDirection_t order = CUSPARSE_DIRECTION_ROW;
 
 
+// invert the diagonal blocks of LU, Gauss-Jordan without pivoting, one thread per blockrow
+template <unsigned int bs>
+__global__ void chow_patel_invert_diagonal(
+    const double * __restrict__ LU,
+    const int * __restrict__ diagIndex,
+    double * __restrict__ invDiag,
+    const int Nb)
+{
+    for (int row = blockIdx.x * blockDim.x + threadIdx.x; row < Nb; row += blockDim.x * gridDim.x) {
+        double a[bs * bs];
+        double inv[bs * bs];
+        for (unsigned int e = 0; e < bs * bs; ++e) {
+            a[e] = LU[diagIndex[row] * bs * bs + e];
+            inv[e] = (e / bs == e % bs) ? 1.0 : 0.0;
+        }
+        for (unsigned int k = 0; k < bs; ++k) {
+            const double pivot = 1.0 / a[k * bs + k];
+            for (unsigned int c = 0; c < bs; ++c) {
+                a[k * bs + c] *= pivot;
+                inv[k * bs + c] *= pivot;
+            }
+            for (unsigned int r = 0; r < bs; ++r) {
+                if (r != k) {
+                    const double factor = a[r * bs + k];
+                    for (unsigned int c = 0; c < bs; ++c) {
+                        a[r * bs + c] -= factor * a[k * bs + c];
+                        inv[r * bs + c] -= factor * inv[k * bs + c];
+                    }
+                }
+            }
+        }
+        for (unsigned int e = 0; e < bs * bs; ++e) {
+            invDiag[row * bs * bs + e] = inv[e];
+        }
+    }
+}
+
+// initial guess of the Chow and Patel sweeps: L = L_A * inv(D_A), U = U_A
+template <unsigned int bs>
+__global__ void chow_patel_init(
+    const double * __restrict__ A,
+    double * __restrict__ LU,
+    const int * __restrict__ rows,
+    const int * __restrict__ cols,
+    const double * __restrict__ invDiag,
+    const int Nb)
+{
+    for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < Nb; i += blockDim.x * gridDim.x) {
+        for (int ij = rows[i]; ij < rows[i + 1]; ++ij) {
+            const int j = cols[ij];
+            for (unsigned int r = 0; r < bs; ++r) {
+                for (unsigned int c = 0; c < bs; ++c) {
+                    double temp = A[ij * bs * bs + r * bs + c];
+                    if (i > j) {
+                        temp = 0.0;
+                        for (unsigned int k = 0; k < bs; ++k) {
+                            temp += A[ij * bs * bs + r * bs + k] * invDiag[j * bs * bs + k * bs + c];
+                        }
+                    }
+                    LU[ij * bs * bs + r * bs + c] = temp;
+                }
+            }
+        }
+    }
+}
+
+// one sweep of the Fine-Grained Parallel ILU of Chow and Patel, one thread per blockrow
+// for every block (i,j): s = A_ij - sum_{k < min(i,j)} L_ik * U_kj
+// then L_ij = s * inv(U_jj) if i > j, otherwise U_ij = s
+// L and U are stored in the same matrix, like the exact decomposition of cusparse
+template <unsigned int bs>
+__global__ void chow_patel_sweep(
+    const double * __restrict__ A,
+    const double * __restrict__ LUin,
+    double * __restrict__ LUout,
+    const int * __restrict__ rows,
+    const int * __restrict__ cols,
+    const double * __restrict__ invDiag,
+    double * __restrict__ rowDiff,
+    const int Nb)
+{
+    for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < Nb; i += blockDim.x * gridDim.x) {
+        double diff = 0.0;
+        for (int ij = rows[i]; ij < rows[i + 1]; ++ij) {
+            const int j = cols[ij];
+            const int kmax = min(i, j);
+            double sum[bs * bs];
+            for (unsigned int e = 0; e < bs * bs; ++e) {
+                sum[e] = A[ij * bs * bs + e];
+            }
+            for (int ik = rows[i]; ik < rows[i + 1] && cols[ik] < kmax; ++ik) {
+                const int k = cols[ik];
+                // find block (k,j), the columns of every row are sorted
+                int lo = rows[k], hi = rows[k + 1] - 1, kj = -1;
+                while (lo <= hi) {
+                    const int mid = (lo + hi) / 2;
+                    if (cols[mid] == j) {
+                        kj = mid;
+                        break;
+                    } else if (cols[mid] < j) {
+                        lo = mid + 1;
+                    } else {
+                        hi = mid - 1;
+                    }
+                }
+                if (kj >= 0) {
+                    for (unsigned int r = 0; r < bs; ++r) {
+                        for (unsigned int c = 0; c < bs; ++c) {
+                            double temp = 0.0;
+                            for (unsigned int m = 0; m < bs; ++m) {
+                                temp += LUin[ik * bs * bs + r * bs + m] * LUin[kj * bs * bs + m * bs + c];
+                            }
+                            sum[r * bs + c] -= temp;
+                        }
+                    }
+                }
+            }
+            for (unsigned int r = 0; r < bs; ++r) {
+                for (unsigned int c = 0; c < bs; ++c) {
+                    double temp = sum[r * bs + c];
+                    if (i > j) {
+                        temp = 0.0;
+                        for (unsigned int m = 0; m < bs; ++m) {
+                            temp += sum[r * bs + m] * invDiag[j * bs * bs + m * bs + c];
+                        }
+                    }
+                    const double d = temp - LUin[ij * bs * bs + r * bs + c];
+                    diff += d * d;
+                    LUout[ij * bs * bs + r * bs + c] = temp;
+                }
+            }
+        }
+        rowDiff[i] = diff;
+    }
+}
+
+
+// the scalar parts of the bicgstab iterations, one thread each
+// once the solver converged, the step lengths are zero so x and r do not change anymore
+__global__ void bicgstab_alpha(BicgstabScalars *sc)
+{
+    sc->alpha = sc->done ? 0.0 : sc->rho / sc->tmp1;
+    sc->nalpha = -sc->alpha;
+}
+
+__global__ void bicgstab_omega(BicgstabScalars *sc)
+{
+    sc->omega = sc->done ? 0.0 : sc->tmp1 / sc->tmp2;
+    sc->nomega = -sc->omega;
+}
+
+__global__ void bicgstab_beta(BicgstabScalars *sc)
+{
+    sc->beta = sc->done ? 0.0 : (sc->rho / sc->rhop) * (sc->alpha / sc->omega);
+}
+
+__global__ void bicgstab_check(BicgstabScalars *sc, const double tolerance, const bool save_rho)
+{
+    if (!sc->done) {
+        sc->halfIts++;
+        sc->done = sc->norm < tolerance * sc->norm_0;
+    }
+    if (save_rho) {
+        sc->rhop = sc->rho;
+    }
+}
+
+
 template <unsigned int block_size>
 cusparseSolverBackend<block_size>::cusparseSolverBackend(int verbosity_, int maxit_, double tolerance_, unsigned int deviceID_) : BdaSolver<block_size>(verbosity_, maxit_, tolerance_, deviceID_) {}
 
@@ -60,14 +231,11 @@ template <unsigned int block_size>
 void cusparseSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContribs, BdaResult& res) {
     Timer t_total, t_prec(false), t_spmv(false), t_well(false), t_rest(false);
     int n = N;
-    double rho = 1.0, rhop;
-    double alpha, nalpha, beta;
-    double omega, nomega, tmp1, tmp2;
-    double norm, norm_0;
     double zero = 0.0;
     double one  = 1.0;
     double mone = -1.0;
     float it;
+    BicgstabScalars *sc = d_scalars;
 
     if (wellContribs.getNumWells() > 0) {
         wellContribs.setCudaStream(stream);
@@ -79,24 +247,35 @@ void cusparseSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellCon
     cublasDaxpy(cublasHandle, n, &one, d_b, 1, d_r, 1);
     cublasDcopy(cublasHandle, n, d_r, 1, d_rw, 1);
     cublasDcopy(cublasHandle, n, d_r, 1, d_p, 1);
-    cublasDnrm2(cublasHandle, n, d_r, 1, &norm_0);
+
+    h_scalars->rho = 1.0;
+    h_scalars->one = 1.0;
+    h_scalars->done = 0;
+    h_scalars->halfIts = 0;
+    cudaMemcpyAsync(sc, h_scalars, sizeof(BicgstabScalars), cudaMemcpyHostToDevice, stream);
+
+    // all scalars of cublas are in GPU memory during the iterations
+    cublasSetPointerMode(cublasHandle, CUBLAS_POINTER_MODE_DEVICE);
+    cublasDnrm2(cublasHandle, n, d_r, 1, &sc->norm_0);
 
     if (verbosity > 1) {
+        cudaMemcpyAsync(h_scalars, sc, sizeof(BicgstabScalars), cudaMemcpyDeviceToHost, stream);
+        cudaStreamSynchronize(stream);
         std::ostringstream out;
-        out << std::scientific << "cusparseSolver initial norm: " << norm_0;
+        out << std::scientific << "cusparseSolver initial norm: " << h_scalars->norm_0;
         OpmLog::info(out.str());
     }
 
+    // without output of every iteration, the CPU only waits for the GPU every convergence_poll_interval iterations
+    const int poll_interval = verbosity > 1 ? 1 : convergence_poll_interval;
     for (it = 0.5; it < maxit; it += 0.5) {
-        rhop = rho;
-        cublasDdot(cublasHandle, n, d_rw, 1, d_r, 1, &rho);
+        cublasDdot(cublasHandle, n, d_rw, 1, d_r, 1, &sc->rho);
 
         if (it > 1) {
-            beta = (rho / rhop) * (alpha / omega);
-            nomega = -omega;
-            cublasDaxpy(cublasHandle, n, &nomega, d_v, 1, d_p, 1);
-            cublasDscal(cublasHandle, n, &beta, d_p, 1);
-            cublasDaxpy(cublasHandle, n, &one, d_r, 1, d_p, 1);
+            bicgstab_beta<<<1, 1, 0, stream>>>(sc);
+            cublasDaxpy(cublasHandle, n, &sc->nomega, d_v, 1, d_p, 1);
+            cublasDscal(cublasHandle, n, &sc->beta, d_p, 1);
+            cublasDaxpy(cublasHandle, n, &sc->one, d_r, 1, d_p, 1);
         }
 
         // apply ilu0
@@ -117,16 +296,12 @@ void cusparseSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellCon
             wellContribs.apply(d_pw, d_v);
         }
 
-        cublasDdot(cublasHandle, n, d_rw, 1, d_v, 1, &tmp1);
-        alpha = rho / tmp1;
-        nalpha = -alpha;
-        cublasDaxpy(cublasHandle, n, &nalpha, d_v, 1, d_r, 1);
-        cublasDaxpy(cublasHandle, n, &alpha, d_pw, 1, d_x, 1);
-        cublasDnrm2(cublasHandle, n, d_r, 1, &norm);
-
-        if (norm < tolerance * norm_0) {
-            break;
-        }
+        cublasDdot(cublasHandle, n, d_rw, 1, d_v, 1, &sc->tmp1);
+        bicgstab_alpha<<<1, 1, 0, stream>>>(sc);
+        cublasDaxpy(cublasHandle, n, &sc->nalpha, d_v, 1, d_r, 1);
+        cublasDaxpy(cublasHandle, n, &sc->alpha, d_pw, 1, d_x, 1);
+        cublasDnrm2(cublasHandle, n, d_r, 1, &sc->norm);
+        bicgstab_check<<<1, 1, 0, stream>>>(sc, tolerance, false);
 
         it += 0.5;
 
@@ -148,32 +323,39 @@ void cusparseSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellCon
             wellContribs.apply(d_s, d_t);
         }
 
-        cublasDdot(cublasHandle, n, d_t, 1, d_r, 1, &tmp1);
-        cublasDdot(cublasHandle, n, d_t, 1, d_t, 1, &tmp2);
-        omega = tmp1 / tmp2;
-        nomega = -omega;
-        cublasDaxpy(cublasHandle, n, &omega, d_s, 1, d_x, 1);
-        cublasDaxpy(cublasHandle, n, &nomega, d_t, 1, d_r, 1);
-
-        cublasDnrm2(cublasHandle, n, d_r, 1, &norm);
-
-
-        if (norm < tolerance * norm_0) {
-            break;
-        }
-
-        if (verbosity > 1) {
-            std::ostringstream out;
-            out << "it: " << it << std::scientific << ", norm: " << norm;
-            OpmLog::info(out.str());
+        cublasDdot(cublasHandle, n, d_t, 1, d_r, 1, &sc->tmp1);
+        cublasDdot(cublasHandle, n, d_t, 1, d_t, 1, &sc->tmp2);
+        bicgstab_omega<<<1, 1, 0, stream>>>(sc);
+        cublasDaxpy(cublasHandle, n, &sc->omega, d_s, 1, d_x, 1);
+        cublasDaxpy(cublasHandle, n, &sc->nomega, d_t, 1, d_r, 1);
+
+        cublasDnrm2(cublasHandle, n, d_r, 1, &sc->norm);
+        bicgstab_check<<<1, 1, 0, stream>>>(sc, tolerance, true);
+
+        if (static_cast<int>(it) % poll_interval == 0) {
+            cudaMemcpyAsync(h_scalars, sc, sizeof(BicgstabScalars), cudaMemcpyDeviceToHost, stream);
+            cudaStreamSynchronize(stream);
+            if (h_scalars->done) {
+                break;
+            }
+            if (verbosity > 1) {
+                std::ostringstream out;
+                out << "it: " << it << std::scientific << ", norm: " << h_scalars->norm;
+                OpmLog::info(out.str());
+            }
         }
     }
 
+    cublasSetPointerMode(cublasHandle, CUBLAS_POINTER_MODE_HOST);
+    cudaMemcpyAsync(h_scalars, sc, sizeof(BicgstabScalars), cudaMemcpyDeviceToHost, stream);
+    cudaStreamSynchronize(stream);
+
+    res.converged = h_scalars->done;
+    it = res.converged ? 0.5f * h_scalars->halfIts : static_cast<float>(maxit);
     res.iterations = std::min(it, (float)maxit);
-    res.reduction = norm / norm_0;
+    res.reduction = h_scalars->norm / h_scalars->norm_0;
     res.conv_rate  = static_cast<double>(pow(res.reduction, 1.0 / it));
     res.elapsed = t_total.stop();
-    res.converged = (it != (maxit + 0.5));
 
     if (verbosity > 0) {
         std::ostringstream out;
@@ -230,6 +412,13 @@ void cusparseSolverBackend<block_size>::initialize(int N, int nnz, int dim) {
     cudaMalloc((void**)&d_bCols, sizeof(double) * nnz);
     cudaMalloc((void**)&d_bRows, sizeof(double) * (Nb + 1));
     cudaMalloc((void**)&d_mVals, sizeof(double) * nnz);
+    cudaMalloc((void**)&d_scalars, sizeof(BicgstabScalars));
+    if (chow_patel) {
+        cudaMalloc((void**)&d_mTmp, sizeof(double) * nnz);
+        cudaMalloc((void**)&d_invDiag, sizeof(double) * Nb * block_size * block_size);
+        cudaMalloc((void**)&d_rowDiff, sizeof(double) * Nb);
+        cudaMalloc((void**)&d_diagIndex, sizeof(int) * Nb);
+    }
     cudaCheckLastError("Could not allocate enough memory on GPU");
 
     cublasSetStream(cublasHandle, stream);
@@ -241,6 +430,8 @@ void cusparseSolverBackend<block_size>::initialize(int N, int nnz, int dim) {
     cudaMallocHost((void**)&vals_contiguous, sizeof(double) * nnz);
     cudaCheckLastError("Could not allocate pinned memory");
 #endif
+    cudaMallocHost((void**)&h_scalars, sizeof(BicgstabScalars));
+    cudaCheckLastError("Could not allocate pinned memory");
 
     initialized = true;
 } // end initialize()
@@ -258,6 +449,13 @@ void cusparseSolverBackend<block_size>::finalize() {
         cudaFree(d_t);
         cudaFree(d_v);
         cudaFree(d_mVals);
+        cudaFree(d_scalars);
+        if (chow_patel) {
+            cudaFree(d_mTmp);
+            cudaFree(d_invDiag);
+            cudaFree(d_rowDiff);
+            cudaFree(d_diagIndex);
+        }
         cudaFree(d_bVals);
         cudaFree(d_bCols);
         cudaFree(d_bRows);
@@ -274,6 +472,7 @@ void cusparseSolverBackend<block_size>::finalize() {
 #if COPY_ROW_BY_ROW
         cudaFreeHost(vals_contiguous);
 #endif
+        cudaFreeHost(h_scalars);
         cudaStreamDestroy(stream);
     }
 } // end finalize()
@@ -297,6 +496,14 @@ void cusparseSolverBackend<block_size>::copy_system_to_gpu(double *vals, int *ro
 
     cudaMemcpyAsync(d_bCols, cols, nnz * sizeof(int), cudaMemcpyHostToDevice, stream);
     cudaMemcpyAsync(d_bRows, rows, (Nb + 1) * sizeof(int), cudaMemcpyHostToDevice, stream);
+    if (chow_patel) {
+        // the pattern does not change, so the positions of the diagonal blocks are only computed once
+        std::vector<int> diagIndex(Nb);
+        for (int row = 0; row < Nb; ++row) {
+            diagIndex[row] = std::find(cols + rows[row], cols + rows[row + 1], row) - cols;
+        }
+        cudaMemcpy(d_diagIndex, diagIndex.data(), Nb * sizeof(int), cudaMemcpyHostToDevice);
+    }
     cudaMemcpyAsync(d_b, b, N * sizeof(double), cudaMemcpyHostToDevice, stream);
     cudaMemsetAsync(d_x, 0, sizeof(double) * N, stream);
 
@@ -421,22 +628,68 @@ bool cusparseSolverBackend<block_size>::analyse_matrix() {
     return true;
 } // end analyse_matrix()
 
+template <unsigned int block_size>
+void cusparseSolverBackend<block_size>::chow_patel_decomposition() {
+    const unsigned int threads_per_block = 256;
+    const unsigned int num_blocks = (Nb + threads_per_block - 1) / threads_per_block;
+
+    // d_mVals holds a copy of A, see reset_prec_on_gpu()
+    chow_patel_invert_diagonal<block_size><<<num_blocks, threads_per_block, 0, stream>>>(d_bVals, d_diagIndex, d_invDiag, Nb);
+    chow_patel_init<block_size><<<num_blocks, threads_per_block, 0, stream>>>(d_bVals, d_mVals, d_bRows, d_bCols, d_invDiag, Nb);
+
+    int sweep = 0;
+    while (sweep < chow_patel_sweeps) {
+        chow_patel_invert_diagonal<block_size><<<num_blocks, threads_per_block, 0, stream>>>(d_mVals, d_diagIndex, d_invDiag, Nb);
+        chow_patel_sweep<block_size><<<num_blocks, threads_per_block, 0, stream>>>(d_bVals, d_mVals, d_mTmp, d_bRows, d_bCols, d_invDiag, d_rowDiff, Nb);
+        std::swap(d_mVals, d_mTmp);
+        ++sweep;
+
+        // stop early if the factors hardly changed, only two scalars are copied to the host
+        if (chow_patel_tolerance > 0.0 && sweep < chow_patel_sweeps) {
+            double diff, norm;
+            cublasDasum(cublasHandle, Nb, d_rowDiff, 1, &diff);  // rowDiff contains squares
+            cublasDnrm2(cublasHandle, nnz, d_mVals, 1, &norm);
+            const double change = norm > 0.0 ? std::sqrt(diff) / norm : 0.0;
+            if (verbosity >= 4) {
+                std::ostringstream out;
+                out << "cusparseSolver ChowPatel sweep " << sweep << ", relative change: " << change;
+                OpmLog::info(out.str());
+            }
+            if (change < chow_patel_tolerance) {
+                break;
+            }
+        }
+    }
+    cudaCheckLastError("Could not perform ChowPatel decomposition");
+
+    if (verbosity >= 3) {
+        std::ostringstream out;
+        out << "cusparseSolver ChowPatel sweeps: " << sweep;
+        OpmLog::info(out.str());
+    }
+}
+
+
 template <unsigned int block_size>
 bool cusparseSolverBackend<block_size>::create_preconditioner() {
     Timer t;
 
     d_mCols = d_bCols;
     d_mRows = d_bRows;
-    cusparseDbsrilu02(cusparseHandle, order, \
-                      Nb, nnzb, descr_M, d_mVals, d_mRows, d_mCols, \
-                      block_size, info_M, policy, d_buffer);
-    cudaCheckLastError("Could not perform ilu decomposition");
-
-    int structural_zero;
-    // cusparseXbsrilu02_zeroPivot() calls cudaDeviceSynchronize()
-    cusparseStatus_t status = cusparseXbsrilu02_zeroPivot(cusparseHandle, info_M, &structural_zero);
-    if (CUSPARSE_STATUS_ZERO_PIVOT == status) {
-        return false;
+    if (chow_patel) {
+        chow_patel_decomposition();
+    } else {
+        cusparseDbsrilu02(cusparseHandle, order, \
+                          Nb, nnzb, descr_M, d_mVals, d_mRows, d_mCols, \
+                          block_size, info_M, policy, d_buffer);
+        cudaCheckLastError("Could not perform ilu decomposition");
+
+        int structural_zero;
+        // cusparseXbsrilu02_zeroPivot() calls cudaDeviceSynchronize()
+        cusparseStatus_t status = cusparseXbsrilu02_zeroPivot(cusparseHandle, info_M, &structural_zero);
+        if (CUSPARSE_STATUS_ZERO_PIVOT == status) {
+            return false;
+        }
     }
 
     if (verbosity > 2) {
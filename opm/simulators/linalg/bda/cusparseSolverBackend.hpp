@@ -31,6 +31,17 @@
 namespace bda
 {
 
+/// The scalars of the bicgstab iterations, kept in GPU memory such that the
+/// iterations do not wait for the CPU
+struct BicgstabScalars
+{
+    double rho, rhop, alpha, nalpha, beta, omega, nomega, tmp1, tmp2;
+    double norm, norm_0;
+    double one;
+    int done;        // 1 iff the solver converged, the remaining iterations leave x and r unchanged
+    int halfIts;     // number of half iterations until convergence
+};
+
 /// This class implements a cusparse-based ilu0-bicgstab solver on GPU
 template <unsigned int block_size>
 class cusparseSolverBackend : public BdaSolver<block_size> {
@@ -46,6 +57,9 @@ class cusparseSolverBackend : public BdaSolver<block_size> {
     using Base::maxit;
     using Base::tolerance;
     using Base::initialized;
+    using Base::chow_patel;
+    using Base::chow_patel_sweeps;
+    using Base::chow_patel_tolerance;
 
 private:
 
@@ -64,8 +78,19 @@ private:
     void *d_buffer;
     double *vals_contiguous;                  // only used if COPY_ROW_BY_ROW is true in cusparseSolverBackend.cpp
 
+    // only used by the ChowPatel decomposition
+    double *d_mTmp = nullptr;                 // the sweeps alternate between d_mVals and d_mTmp
+    double *d_invDiag = nullptr;              // inverted diagonal blocks of the current U
+    double *d_rowDiff = nullptr;              // squared change per blockrow during a sweep
+    int *d_diagIndex = nullptr;               // position of the diagonal block of every blockrow
+
     bool analysis_done = false;
 
+    // the convergence is checked on the GPU, the CPU only reads the result every so many iterations
+    static constexpr int convergence_poll_interval = 8;
+    BicgstabScalars *d_scalars = nullptr;
+    BicgstabScalars *h_scalars = nullptr;     // pinned memory
+
 
     /// Solve linear system using ilu0-bicgstab
     /// \param[in] wellContribs   contains all WellContributions, to apply them separately, instead of adding them to matrix A
@@ -105,6 +130,10 @@ private:
     /// \return true iff decomposition was successful
     bool create_preconditioner();
 
+    /// Perform the iterative ilu0-decomposition of Chow and Patel on the GPU, replaces cusparseDbsrilu02()
+    /// The factors are stored in d_mVals in the same layout as cusparse uses, so the bsrsv2 solves are unchanged
+    void chow_patel_decomposition();
+
     /// Solve linear system
     /// \param[in] wellContribs   contains all WellContributions, to apply them separately, instead of adding them to matrix A
     /// \param[inout] res         summary of solver result
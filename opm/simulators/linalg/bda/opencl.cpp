@@ -18,7 +18,19 @@
 */
 
 #include <opm/simulators/linalg/bda/opencl.hpp>
+#include <opm/common/OpmLog/OpmLog.hpp>
+#include <opm/common/utility/FileSystem.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
 #include <string>
+#include <system_error>
+
+#include <unistd.h>
 
 /// Translate OpenCL error codes to strings
 /// Integer - String combinations are defined in CL/cl.h
@@ -94,3 +106,85 @@ std::string getErrorString(cl_int error)
         default: return "UNKNOWN_CL_CODE";
     }
 }
+
+
+namespace
+{
+
+// FNV-1a, unlike std::hash the same for every build
+std::uint64_t fnvHash(std::uint64_t hash, const char *data, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // anonymous namespace
+
+cl::Program buildProgram(const cl::Context& context, const std::vector<cl::Device>& devices,
+                         const cl::Program::Sources& sources, const std::string& cache_dir)
+{
+    if (cache_dir.empty() || devices.size() != 1) {
+        cl::Program program(context, sources);
+        program.build(devices);
+        return program;
+    }
+
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const cl_device_info info : {CL_DEVICE_NAME, CL_DEVICE_VENDOR, CL_DEVICE_VERSION, CL_DRIVER_VERSION}) {
+        std::string value;
+        devices[0].getInfo(info, &value);
+        // with the terminating zero, which separates the fields
+        hash = fnvHash(hash, value.c_str(), value.size() + 1);
+    }
+    for (const auto& source : sources) {
+        hash = fnvHash(hash, source.first, source.second);
+    }
+    std::ostringstream name;
+    name << cache_dir << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".clbin";
+    const std::string file = name.str();
+
+    std::ifstream in(file, std::ios::binary);
+    if (in) {
+        const std::vector<char> binary((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        try {
+            const cl::Program::Binaries binaries(1, std::make_pair(binary.data(), binary.size()));
+            cl::Program program(context, devices, binaries);
+            program.build(devices);
+            return program;
+        } catch (const cl::Error&) {
+            // e.g. a truncated file or a binary rejected by the driver, build from the sources instead
+        }
+    }
+
+    cl::Program program(context, sources);
+    program.build(devices);
+
+    std::size_t size = 0;
+    cl_int err = clGetProgramInfo(program(), CL_PROGRAM_BINARY_SIZES, sizeof(size), &size, nullptr);
+    if (err != CL_SUCCESS || size == 0) {
+        return program;
+    }
+    std::vector<unsigned char> binary(size);
+    unsigned char *data = binary.data();
+    err = clGetProgramInfo(program(), CL_PROGRAM_BINARIES, sizeof(data), &data, nullptr);
+    if (err != CL_SUCCESS) {
+        return program;
+    }
+
+    // every process of a parallel run can build the same program,
+    // each writes its own file, the rename makes the cached file appear complete
+    std::error_code ec;
+    Opm::filesystem::create_directories(cache_dir, ec);
+    const std::string tmp = file + "." + std::to_string(getpid()) + ".tmp";
+    std::ofstream out(tmp, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(data), size);
+    out.close();
+    if (!out || std::rename(tmp.c_str(), file.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        Opm::OpmLog::warning("Could not write the OpenCL kernel binary " + file + ", the kernels are built from the sources in the next run");
+    }
+    return program;
+}
@@ -25,8 +25,20 @@
 #include <CL/cl.hpp>                   // supports up to OpenCL 1.2
 
 #include <string>
+#include <vector>
 
 /// Translate OpenCL error codes to strings
 /// Integer - String combinations are defined in CL/cl.h
 /// \param[in] error     error code
 std::string getErrorString(cl_int error);
+
+/// Build a program from the sources for the devices
+/// The binary is cached in cache_dir, with a name made from a hash of the device, the driver version
+/// and the sources, later builds of the same sources load it instead of compiling them again
+/// \param[in] context     the OpenCL context
+/// \param[in] devices     the devices to build for, the cache is only used for a single device
+/// \param[in] sources     the kernel sources
+/// \param[in] cache_dir   directory of the cached binaries, empty to always build from the sources
+/// \return                the built program
+cl::Program buildProgram(const cl::Context& context, const std::vector<cl::Device>& devices,
+                         const cl::Program::Sources& sources, const std::string& cache_dir);
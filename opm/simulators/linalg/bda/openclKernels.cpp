@@ -42,6 +42,26 @@ namespace bda
     }
 
 
+    // multiply a vector elementwise by a mask, used to zero the rows not owned by this process
+    std::string get_project_string() {
+        return R"(
+        __kernel void project(
+            __global const double *mask,
+            __global double *vec,
+            const int N)
+        {
+            unsigned int NUM_THREADS = get_global_size(0);
+            int idx = get_global_id(0);
+
+            while(idx < N){
+                vec[idx] *= mask[idx];
+                idx += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
     // returns partial sums, instead of the final dot product
     std::string get_dot_1_string() {
         return R"(
@@ -126,6 +146,113 @@ namespace bda
     }
 
 
+    // returns partial sums of in1 * in2 and in1 * in3, instead of the final dot products
+    // the first are stored in out[0, num_groups), the second in out[num_groups, 2*num_groups)
+    std::string get_dot_2_string() {
+        return R"(
+        __kernel void dot_2(
+            __global double *in1,
+            __global double *in2,
+            __global double *in3,
+            __global double *out,
+            const unsigned int N,
+            __local double *tmp1,
+            __local double *tmp2)
+        {
+            unsigned int tid = get_local_id(0);
+            unsigned int i = get_global_id(0);
+            unsigned int NUM_THREADS = get_global_size(0);
+
+            double sum1 = 0.0;
+            double sum2 = 0.0;
+            while(i < N){
+                sum1 += in1[i] * in2[i];
+                sum2 += in1[i] * in3[i];
+                i += NUM_THREADS;
+            }
+            tmp1[tid] = sum1;
+            tmp2[tid] = sum2;
+
+            barrier(CLK_LOCAL_MEM_FENCE);
+
+            // do reduction in shared mem
+            for(unsigned int s = get_local_size(0) / 2; s > 0; s >>= 1)
+            {
+                if (tid < s)
+                {
+                    tmp1[tid] += tmp1[tid + s];
+                    tmp2[tid] += tmp2[tid + s];
+                }
+                barrier(CLK_LOCAL_MEM_FENCE);
+            }
+
+            // write result for this block to global mem
+            if (tid == 0) {
+                out[get_group_id(0)] = tmp1[0];
+                out[get_num_groups(0) + get_group_id(0)] = tmp2[0];
+            }
+        }
+        )";
+    }
+
+
+    // x += a * p, r -= a * v
+    // returns partial sums of r * r and rw * r of the updated r
+    // the first are stored in out[0, num_groups), the second in out[num_groups, 2*num_groups)
+    std::string get_bicgstab_update_string() {
+        return R"(
+        __kernel void bicgstab_update(
+            __global double *x,
+            __global double *p,
+            __global double *r,
+            __global double *v,
+            __global double *rw,
+            const double a,
+            __global double *out,
+            const unsigned int N,
+            __local double *tmp1,
+            __local double *tmp2)
+        {
+            unsigned int tid = get_local_id(0);
+            unsigned int i = get_global_id(0);
+            unsigned int NUM_THREADS = get_global_size(0);
+
+            double norm = 0.0;
+            double dot = 0.0;
+            while(i < N){
+                x[i] += a * p[i];
+                double ri = r[i] - a * v[i];
+                r[i] = ri;
+                norm += ri * ri;
+                dot += rw[i] * ri;
+                i += NUM_THREADS;
+            }
+            tmp1[tid] = norm;
+            tmp2[tid] = dot;
+
+            barrier(CLK_LOCAL_MEM_FENCE);
+
+            // do reduction in shared mem
+            for(unsigned int s = get_local_size(0) / 2; s > 0; s >>= 1)
+            {
+                if (tid < s)
+                {
+                    tmp1[tid] += tmp1[tid + s];
+                    tmp2[tid] += tmp2[tid + s];
+                }
+                barrier(CLK_LOCAL_MEM_FENCE);
+            }
+
+            // write result for this block to global mem
+            if (tid == 0) {
+                out[get_group_id(0)] = tmp1[0];
+                out[get_num_groups(0) + get_group_id(0)] = tmp2[0];
+            }
+        }
+        )";
+    }
+
+
     // p = (p - omega * v) * beta + r
     std::string get_custom_string() {
         return R"(
@@ -182,6 +309,7 @@ namespace bda
             // for 3x3 blocks:
             // num_active_threads: 27
             // num_blocks_per_warp: 3
+            // the partial sums of row r are in the lanes r, r+bs, r+2*bs, ...
 
             while(target_block_row < Nb){
                 unsigned int first_block = rows[target_block_row];
@@ -201,7 +329,7 @@ namespace bda
                 tmp[lane] = local_out;
                 barrier(CLK_LOCAL_MEM_FENCE);
 
-                for(unsigned int offset = 3; offset <= 24; offset <<= 1)
+                for(unsigned int offset = bs; offset < warpsize; offset <<= 1)
                 {
                     if (lane + offset < warpsize)
                     {
@@ -222,6 +350,72 @@ namespace bda
 
 
 
+    std::string get_spmv_sell_string() {
+        return R"(
+        __kernel void spmv_sell(
+            __global const double *vals,
+            __global const int *cols,
+            __global const unsigned int *slices,
+            __global const int *rows,
+            const unsigned int Nb,
+            __global const double *x,
+            __global double *b,
+            const unsigned int block_size,
+            const unsigned int slice_height)
+        {
+            const unsigned int bs = block_size;
+            const unsigned int NUM_THREADS = get_global_size(0);
+            const unsigned int num_slices = (Nb + slice_height - 1) / slice_height;
+            unsigned int idx = get_global_id(0);
+
+            // every work item computes one scalar row
+            while(idx < num_slices * slice_height * bs){
+                const unsigned int pos = idx / bs;
+                const unsigned int r = idx % bs;
+                const unsigned int slice = pos / slice_height;
+                const unsigned int lane = pos % slice_height;
+                const int row = rows[pos];
+
+                if(row >= 0){
+                    double sum = 0.0;
+                    for(unsigned int block = slices[slice] + lane; block < slices[slice + 1]; block += slice_height){
+                        const int col = cols[block];
+                        for(unsigned int c = 0; c < bs; ++c){
+                            sum += vals[block*bs*bs + r*bs + c] * x[col*bs + c];
+                        }
+                    }
+                    b[row*bs + r] = sum;
+                }
+                idx += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+    std::string get_sell_gather_string() {
+        return R"(
+        __kernel void sell_gather(
+            __global const double *vals,
+            __global const int *map,
+            __global double *sell_vals,
+            const unsigned int num_blocks,
+            const unsigned int block_size)
+        {
+            const unsigned int bs = block_size;
+            const unsigned int NUM_THREADS = get_global_size(0);
+            unsigned int idx = get_global_id(0);
+
+            while(idx < num_blocks * bs * bs){
+                const int src = map[idx / (bs*bs)];
+                sell_vals[idx] = (src >= 0) ? vals[src*bs*bs + idx % (bs*bs)] : 0.0;
+                idx += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+
     std::string get_ILU_apply1_string(bool full_matrix) {
         std::string s = R"(
             __kernel void ILU_apply1(
@@ -276,7 +470,7 @@ namespace bda
                     tmp[lane] = local_out;
                     barrier(CLK_LOCAL_MEM_FENCE);
 
-                    for(unsigned int offset = 3; offset <= 24; offset <<= 1)
+                    for(unsigned int offset = bs; offset < warpsize; offset <<= 1)
                     {
                         if (lane + offset < warpsize)
                         {
@@ -354,7 +548,7 @@ namespace bda
                     tmp[lane] = local_out;
                     barrier(CLK_LOCAL_MEM_FENCE);
 
-                    for(unsigned int offset = 3; offset <= 24; offset <<= 1)
+                    for(unsigned int offset = bs; offset < warpsize; offset <<= 1)
                     {
                         if (lane + offset < warpsize)
                         {
@@ -429,19 +623,19 @@ namespace bda
                         localSum[wiId] += Bnnzs[b*dim*dim_wells + r*dim + c]*x[colIdx*dim + c];
                         b += numBlocksPerWarp;
                     }
+                }
 
-                    if(wiId < valsPerBlock){
-                        localSum[wiId] += localSum[wiId + valsPerBlock];
-                    }
-
-                    b = wiId/valsPerBlock + val_pointers[wgId];
+                barrier(CLK_LOCAL_MEM_FENCE);
 
-                    if(c == 0 && wiId < valsPerBlock){
-                        for(unsigned int stride = 2; stride > 0; stride >>= 1){
-                            localSum[wiId] += localSum[wiId + stride];
+                // merge all blocks and all (dim) columns of a row, results in a single 1*dim_wells vector
+                if(wiId < dim_wells){
+                    temp = 0.0;
+                    for(int i = 0; i < numBlocksPerWarp; ++i){
+                        for(unsigned int j = 0; j < dim; ++j){
+                            temp += localSum[i*valsPerBlock + wiId*dim + j];
                         }
-                        z1[r] = localSum[wiId];
                     }
+                    z1[wiId] = temp;
                 }
 
                 barrier(CLK_LOCAL_MEM_FENCE);
@@ -477,13 +671,105 @@ namespace bda
     }
 
 
-    std::string get_ilu_decomp_string() {
-        return R"(
+    std::string get_mswell_apply_string(bool reorder) {
+        std::string kernel_name = reorder ? "mswell_apply" : "mswell_apply_no_reorder";
+        std::string s = "__kernel void " + kernel_name + R"((
+                        __global const double *Cnnzs,
+                        __global const double *Bnnzs,
+                        __global const double *Dinv,
+                        __global const unsigned int *Bcols,
+                        __global const unsigned int *Brows,
+                        __global const unsigned int *blockRows,
+                        __global const unsigned int *wellInfo,
+                        __global double *z,
+                        __global const double *x,
+                        __global double *y,
+                        )";
+        if (reorder) {
+            s +=     R"(__global const int *toOrder,
+                        )";
+        }
+        s +=         R"(const unsigned int dim,
+                        const unsigned int dim_wells){
+                // one work group per well
+                const unsigned int wgId = get_group_id(0);
+                const unsigned int wiId = get_local_id(0);
+                const unsigned int wgSize = get_local_size(0);
+                __global const unsigned int *rows = Brows + wellInfo[4*wgId];
+                const unsigned int Mb = wellInfo[4*wgId + 1];
+                const unsigned int M = Mb*dim_wells;
+                __global const double *D = Dinv + wellInfo[4*wgId + 2];
+                __global double *z1 = z + wellInfo[4*wgId + 3];
+                __global double *z2 = z1 + M;
+                const unsigned int valsPerBlock = dim*dim_wells;
+
+                // z1 = B * x
+                for(unsigned int i = wiId; i < M; i += wgSize){
+                    const unsigned int row = i / dim_wells;
+                    const unsigned int r = i % dim_wells;
+                    double temp = 0.0;
+                    for(unsigned int b = rows[row]; b < rows[row + 1]; ++b){
+                        )";
+        if (reorder) {
+            s +=       "const unsigned int colIdx = toOrder[Bcols[b]];";
+        } else {
+            s +=       "const unsigned int colIdx = Bcols[b];";
+        }
+        s += R"(
+                        for(unsigned int c = 0; c < dim; ++c){
+                            temp += Bnnzs[b*valsPerBlock + r*dim + c]*x[colIdx*dim + c];
+                        }
+                    }
+                    z1[i] = temp;
+                }
+
+                barrier(CLK_GLOBAL_MEM_FENCE);
+
+                // z2 = D^-1 * z1
+                for(unsigned int i = wiId; i < M; i += wgSize){
+                    double temp = 0.0;
+                    for(unsigned int j = 0; j < M; ++j){
+                        temp += D[i*M + j]*z1[j];
+                    }
+                    z2[i] = temp;
+                }
+
+                barrier(CLK_GLOBAL_MEM_FENCE);
+
+                // y -= C^T * z2, a cell is connected to a single segment of the well
+                const unsigned int firstBlock = rows[0];
+                const unsigned int numValues = (rows[Mb] - firstBlock)*dim;
+                for(unsigned int i = wiId; i < numValues; i += wgSize){
+                    const unsigned int b = firstBlock + i / dim;
+                    const unsigned int c = i % dim;
+                    const unsigned int row = blockRows[b];
+                    double temp = 0.0;
+                    for(unsigned int j = 0; j < dim_wells; ++j){
+                        temp += Cnnzs[b*valsPerBlock + j*dim + c]*z2[row*dim_wells + j];
+                    }
+                    )";
+        if (reorder) {
+            s +=   "const unsigned int colIdx = toOrder[Bcols[b]];";
+        } else {
+            s +=   "const unsigned int colIdx = Bcols[b];";
+        }
+        s += R"(
+                    y[colIdx*dim + c] -= temp;
+                }
+            }
+            )";
+        return s;
+    }
+
+
+    std::string get_ilu_decomp_string(unsigned int block_size) {
+        const std::string bs = std::to_string(block_size);
+        std::string s = R"(
 
         // a = a - (b * c)
         __kernel void block_mult_sub(__global double *a, __local double *b, __global double *c)
         {
-            const unsigned int block_size = 3;
+            const unsigned int block_size = )" + bs + R"(;
             const unsigned int hwarp_size = 16;
             const unsigned int idx_t = get_local_id(0);                   // thread id in work group
             const unsigned int thread_id_in_hwarp = idx_t % hwarp_size;   // thread id in warp (16 threads)
@@ -500,7 +786,7 @@ namespace bda
 
         // c = a * b
         __kernel void block_mult(__global double *a, __global double *b, __local double *c) {
-            const unsigned int block_size = 3;
+            const unsigned int block_size = )" + bs + R"(;
             const unsigned int hwarp_size = 16;
             const unsigned int idx_t = get_local_id(0);                   // thread id in work group
             const unsigned int thread_id_in_hwarp = idx_t % hwarp_size;   // thread id in warp (16 threads)
@@ -515,14 +801,39 @@ namespace bda
             }
         }
 
-        // invert 3x3 matrix
+        // determinant of the 3x3 submatrix with rows i0, i1, i2 and columns j0, j1, j2
+        double ilu_det3(__global const double *m, const unsigned int bs,
+                        const unsigned int i0, const unsigned int i1, const unsigned int i2,
+                        const unsigned int j0, const unsigned int j1, const unsigned int j2)
+        {
+            return m[i0*bs+j0] * (m[i1*bs+j1] * m[i2*bs+j2] - m[i1*bs+j2] * m[i2*bs+j1])
+                 - m[i0*bs+j1] * (m[i1*bs+j0] * m[i2*bs+j2] - m[i1*bs+j2] * m[i2*bs+j0])
+                 + m[i0*bs+j2] * (m[i1*bs+j0] * m[i2*bs+j1] - m[i1*bs+j1] * m[i2*bs+j0]);
+        }
+
+        // invert a block, every thread computes one entry of the inverse
         __kernel void inverter(__global double *matrix, __global double *inverse) {
-            const unsigned int block_size = 3;
+            const unsigned int block_size = )" + bs + R"(;
             const unsigned int bs = block_size;                           // rename to shorter name
             const unsigned int hwarp_size = 16;
             const unsigned int idx_t = get_local_id(0);                   // thread id in work group
             const unsigned int thread_id_in_hwarp = idx_t % hwarp_size;   // thread id in warp (16 threads)
             if(thread_id_in_hwarp < bs * bs){
+                const unsigned int r = thread_id_in_hwarp / bs;
+                const unsigned int c = thread_id_in_hwarp % bs;
+                )";
+        if (block_size == 1) {
+            s += R"(
+                inverse[0] = 1.0 / matrix[0];
+                )";
+        } else if (block_size == 2) {
+            s += R"(
+                double det = matrix[0] * matrix[3] - matrix[1] * matrix[2];
+                double sign = ((r + c) % 2 == 0) ? 1.0 : -1.0;
+                inverse[c*bs+r] = sign * matrix[(1-r)*bs+(1-c)] / det;
+                )";
+        } else if (block_size == 3) {
+            s += R"(
                 double t4  = matrix[0] * matrix[4];
                 double t6  = matrix[0] * matrix[5];
                 double t8  = matrix[1] * matrix[3];
@@ -534,13 +845,30 @@ namespace bda
                               t10 * matrix[7] + t12 * matrix[5] - t14 * matrix[4]);
                 double t17 = 1.0 / det;
 
-                const unsigned int r = thread_id_in_hwarp / bs;
-                const unsigned int c = thread_id_in_hwarp % bs;
                 const unsigned int r1 = (r+1) % bs;
                 const unsigned int c1 = (c+1) % bs;
                 const unsigned int r2 = (r+bs-1) % bs;
                 const unsigned int c2 = (c+bs-1) % bs;
                 inverse[c*bs+r] = ((matrix[r1*bs+c1] * matrix[r2*bs+c2]) - (matrix[r1*bs+c2] * matrix[r2*bs+c1])) * t17;
+                )";
+        } else {
+            // cofactor expansion, the rows and columns without r and c form the minor
+            s += R"(
+                double det = matrix[0] * ilu_det3(matrix, bs, 1, 2, 3, 1, 2, 3)
+                           - matrix[1] * ilu_det3(matrix, bs, 1, 2, 3, 0, 2, 3)
+                           + matrix[2] * ilu_det3(matrix, bs, 1, 2, 3, 0, 1, 3)
+                           - matrix[3] * ilu_det3(matrix, bs, 1, 2, 3, 0, 1, 2);
+                const unsigned int i0 = r < 1 ? 1 : 0;
+                const unsigned int i1 = r < 2 ? 2 : 1;
+                const unsigned int i2 = r < 3 ? 3 : 2;
+                const unsigned int j0 = c < 1 ? 1 : 0;
+                const unsigned int j1 = c < 2 ? 2 : 1;
+                const unsigned int j2 = c < 3 ? 3 : 2;
+                double sign = ((r + c) % 2 == 0) ? 1.0 : -1.0;
+                inverse[c*bs+r] = sign * ilu_det3(matrix, bs, i0, i1, i2, j0, j1, j2) / det;
+                )";
+        }
+        s += R"(
             }
         }
 
@@ -554,7 +882,7 @@ namespace bda
                                  const unsigned int Nb,
                                  __local double *pivot){
 
-            const unsigned int bs = 3;
+            const unsigned int bs = )" + bs + R"(;
             const unsigned int hwarp_size = 16;
             const unsigned int work_group_size = get_local_size(0);
             const unsigned int work_group_id = get_group_id(0);
@@ -615,7 +943,287 @@ namespace bda
             }
         }
         )";
+        return s;
     }
 
-} // end namespace bda
+    // quasi-IMPES weights: solve D^T w = e_p for every blockrow, D is the diagonal block
+    // w is scaled so that its largest absolute entry is 1, like Opm::Amg::getQuasiImpesWeights()
+    std::string get_cpr_weights_string() {
+        return R"(
+        __kernel void cpr_weights(
+            __global const double *vals,
+            __global const int *diagIndex,
+            __global double *weights,
+            const unsigned int Nb,
+            const unsigned int block_size,
+            const unsigned int pressure_idx)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            const unsigned int bs = block_size;
+            unsigned int row = get_global_id(0);
+
+            // supports block_size up to 4
+            double M[16];
+            double w[4];
+
+            while(row < Nb){
+                __global const double *D = vals + diagIndex[row] * bs * bs;
+                for(unsigned int i = 0; i < bs; ++i){
+                    for(unsigned int j = 0; j < bs; ++j){
+                        M[i * bs + j] = D[j * bs + i];
+                    }
+                    w[i] = (i == pressure_idx) ? 1.0 : 0.0;
+                }
+
+                // gaussian elimination with partial pivoting
+                for(unsigned int k = 0; k < bs; ++k){
+                    unsigned int piv = k;
+                    for(unsigned int i = k + 1; i < bs; ++i){
+                        if(fabs(M[i * bs + k]) > fabs(M[piv * bs + k])){
+                            piv = i;
+                        }
+                    }
+                    if(piv != k){
+                        for(unsigned int j = 0; j < bs; ++j){
+                            double t = M[k * bs + j];
+                            M[k * bs + j] = M[piv * bs + j];
+                            M[piv * bs + j] = t;
+                        }
+                        double t = w[k];
+                        w[k] = w[piv];
+                        w[piv] = t;
+                    }
+                    for(unsigned int i = k + 1; i < bs; ++i){
+                        double f = M[i * bs + k] / M[k * bs + k];
+                        for(unsigned int j = k; j < bs; ++j){
+                            M[i * bs + j] -= f * M[k * bs + j];
+                        }
+                        w[i] -= f * w[k];
+                    }
+                }
+                for(int i = bs - 1; i >= 0; --i){
+                    double sum = w[i];
+                    for(unsigned int j = i + 1; j < bs; ++j){
+                        sum -= M[i * bs + j] * w[j];
+                    }
+                    w[i] = sum / M[i * bs + i];
+                }
+
+                double abs_max = 0.0;
+                for(unsigned int i = 0; i < bs; ++i){
+                    abs_max = fmax(abs_max, fabs(w[i]));
+                }
+                for(unsigned int i = 0; i < bs; ++i){
+                    weights[row * bs + i] = w[i] / abs_max;
+                }
+
+                row += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    // coarse pressure matrix, every block is reduced to the weighted sum of its pressure column
+    std::string get_cpr_coarse_matrix_string() {
+        return R"(
+        __kernel void cpr_coarse_matrix(
+            __global const double *vals,
+            __global const int *rows,
+            __global const double *weights,
+            __global double *coarse_vals,
+            const unsigned int Nb,
+            const unsigned int block_size,
+            const unsigned int pressure_idx)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            const unsigned int bs = block_size;
+            unsigned int row = get_global_id(0);
+
+            while(row < Nb){
+                for(int block = rows[row]; block < rows[row + 1]; ++block){
+                    double sum = 0.0;
+                    for(unsigned int r = 0; r < bs; ++r){
+                        sum += weights[row * bs + r] * vals[block * bs * bs + r * bs + pressure_idx];
+                    }
+                    coarse_vals[block] = sum;
+                }
+                row += NUM_THREADS;
+            }
+        }
+        )";
+    }
 
+
+    // restrict a blocked vector to the pressure system: rp[i] = w_i . r_i
+    std::string get_cpr_restrict_string() {
+        return R"(
+        __kernel void cpr_restrict(
+            __global const double *weights,
+            __global const double *r,
+            __global double *rp,
+            const unsigned int Nb,
+            const unsigned int block_size)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            unsigned int row = get_global_id(0);
+
+            while(row < Nb){
+                double sum = 0.0;
+                for(unsigned int k = 0; k < block_size; ++k){
+                    sum += weights[row * block_size + k] * r[row * block_size + k];
+                }
+                rp[row] = sum;
+                row += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    // prolongate the pressure solution, the other components are set to zero
+    std::string get_cpr_prolongate_string() {
+        return R"(
+        __kernel void cpr_prolongate(
+            __global const double *xp,
+            __global double *x,
+            const unsigned int Nb,
+            const unsigned int block_size,
+            const unsigned int pressure_idx)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            unsigned int idx = get_global_id(0);
+
+            while(idx < Nb * block_size){
+                const unsigned int row = idx / block_size;
+                x[idx] = (idx % block_size == pressure_idx) ? xp[row] : 0.0;
+                idx += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    // r = b - A * x, for a scalar CSR matrix, one thread per row
+    std::string get_amg_residual_string() {
+        return R"(
+        __kernel void amg_residual(
+            __global const double *vals,
+            __global const int *cols,
+            __global const int *rows,
+            const unsigned int N,
+            __global const double *x,
+            __global const double *b,
+            __global double *r)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            unsigned int row = get_global_id(0);
+
+            while(row < N){
+                double sum = b[row];
+                for(int k = rows[row]; k < rows[row + 1]; ++k){
+                    sum -= vals[k] * x[cols[k]];
+                }
+                r[row] = sum;
+                row += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    // damped jacobi update: x += omega * inv(D) * r
+    std::string get_amg_jacobi_string() {
+        return R"(
+        __kernel void amg_jacobi(
+            __global const double *invDiag,
+            __global const double *r,
+            __global double *x,
+            const double omega,
+            const unsigned int N)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            unsigned int row = get_global_id(0);
+
+            while(row < N){
+                x[row] += omega * invDiag[row] * r[row];
+                row += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    // restrict to the next level by summing the entries of every aggregate
+    // ptRows and ptCols list the fine rows of every aggregate
+    std::string get_amg_restrict_string() {
+        return R"(
+        __kernel void amg_restrict(
+            __global const int *ptCols,
+            __global const int *ptRows,
+            const unsigned int Nc,
+            __global const double *r,
+            __global double *rc)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            unsigned int agg = get_global_id(0);
+
+            while(agg < Nc){
+                double sum = 0.0;
+                for(int k = ptRows[agg]; k < ptRows[agg + 1]; ++k){
+                    sum += r[ptCols[k]];
+                }
+                rc[agg] = sum;
+                agg += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    // add the correction of the next level: x[i] += xc[aggregates[i]]
+    std::string get_amg_prolongate_string() {
+        return R"(
+        __kernel void amg_prolongate(
+            __global const int *aggregates,
+            __global const double *xc,
+            __global double *x,
+            const unsigned int N)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            unsigned int row = get_global_id(0);
+
+            while(row < N){
+                x[row] += xc[aggregates[row]];
+                row += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+
+    // x = Ainv * b, with Ainv a dense row-major matrix, used as direct solver on the coarsest level
+    std::string get_amg_dense_mv_string() {
+        return R"(
+        __kernel void amg_dense_mv(
+            __global const double *Ainv,
+            __global const double *b,
+            __global double *x,
+            const unsigned int N)
+        {
+            const unsigned int NUM_THREADS = get_global_size(0);
+            unsigned int row = get_global_id(0);
+
+            while(row < N){
+                double sum = 0.0;
+                for(unsigned int j = 0; j < N; ++j){
+                    sum += Ainv[row * N + j] * b[j];
+                }
+                x[row] = sum;
+                row += NUM_THREADS;
+            }
+        }
+        )";
+    }
+
+} // end namespace bda
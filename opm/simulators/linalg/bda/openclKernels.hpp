@@ -27,8 +27,15 @@
 namespace bda
 {
 
+using dot_2_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int,
+                                          cl::LocalSpaceArg, cl::LocalSpaceArg>;
+using bicgstab_update_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const double,
+                                                    cl::Buffer&, const unsigned int, cl::LocalSpaceArg, cl::LocalSpaceArg>;
 using spmv_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int,
                                          cl::Buffer&, cl::Buffer&, const unsigned int, cl::LocalSpaceArg>;
+using spmv_sell_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int,
+                                              cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int>;
+using sell_gather_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int>;
 using ilu_apply1_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
                                                cl::Buffer&, cl::Buffer&, const unsigned int, const unsigned int, cl::LocalSpaceArg>;
 using ilu_apply2_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
@@ -41,6 +48,14 @@ using stdwell_apply_no_reorder_kernel_type = cl::make_kernel<cl::Buffer&, cl::Bu
                                                              cl::Buffer&, cl::Buffer&, cl::Buffer&,
                                                              const unsigned int, const unsigned int, cl::Buffer&,
                                                              cl::LocalSpaceArg, cl::LocalSpaceArg, cl::LocalSpaceArg>;
+using mswell_apply_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                 cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                 cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                 const unsigned int, const unsigned int>;
+using mswell_apply_no_reorder_kernel_type = cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                            cl::Buffer&, cl::Buffer&, cl::Buffer&, cl::Buffer&,
+                                                            cl::Buffer&, cl::Buffer&,
+                                                            const unsigned int, const unsigned int>;
 using ilu_decomp_kernel_type = cl::make_kernel<const unsigned int, const unsigned int, cl::Buffer&, cl::Buffer&,
                                                cl::Buffer&, cl::Buffer&, cl::Buffer&, const int, cl::LocalSpaceArg>;
 
@@ -48,6 +63,10 @@ using ilu_decomp_kernel_type = cl::make_kernel<const unsigned int, const unsigne
     /// a = a + alpha * b
     std::string get_axpy_string();
 
+    /// Generate string with project kernel
+    /// vec *= mask, elementwise
+    std::string get_project_string();
+
     /// returns partial sums, instead of the final dot product
     /// partial sums are added on CPU
     std::string get_dot_1_string();
@@ -56,6 +75,15 @@ using ilu_decomp_kernel_type = cl::make_kernel<const unsigned int, const unsigne
     /// the square root must be computed on CPU
     std::string get_norm_string();
 
+    /// returns partial sums of in1*in2 and in1*in3 in one pass
+    /// partial sums are added on CPU
+    std::string get_dot_2_string();
+
+    /// Generate string with the fused bicgstab update kernel
+    /// x += a * p, r -= a * v, returns the partial sums of r*r and rw*r of the updated r
+    /// partial sums are added on CPU
+    std::string get_bicgstab_update_string();
+
     /// Generate string with custom kernel
     /// This kernel combines some ilubicgstab vector operations into 1
     /// p = (p - omega * v) * beta + r
@@ -67,6 +95,16 @@ using ilu_decomp_kernel_type = cl::make_kernel<const unsigned int, const unsigne
     /// Ryan Eberhardt, Mark Hoemmen, 2016, https://doi.org/10.1109/IPDPSW.2016.42
     std::string get_spmv_blocked_string();
 
+    /// b = mat * x, with mat stored in blocked SELL-C-sigma format
+    /// Slices of slice_height blockrows are padded to the longest blockrow in the slice,
+    /// the blocks of a slice are stored column by column, so neighbouring rows are read contiguously.
+    /// Blockrows are sorted by length within a window, rows[] maps back to the original blockrow.
+    std::string get_spmv_sell_string();
+
+    /// Copy the nonzeroes of a BSR matrix into its SELL-C-sigma layout
+    /// map[] contains the BSR block index for each SELL block, or -1 for padding
+    std::string get_sell_gather_string();
+
     /// ILU apply part 1: forward substitution
     /// solves L*x=y where L is a lower triangular sparse blocked matrix
     /// this L can be it's own BSR matrix (if full_matrix is false),
@@ -87,9 +125,52 @@ using ilu_decomp_kernel_type = cl::make_kernel<const unsigned int, const unsigne
     /// \param[in] reorder   whether the matrix is reordered or not
     std::string get_stdwell_apply_string(bool reorder);
 
+    /// Generate string with the mswell_apply kernels
+    /// One work group per MultisegmentWell performs y -= C^T * (D^-1 * (B * x)), with D^-1 stored as a dense matrix
+    /// If reorder is true, the B/Ccols do not correspond with the x/y vector, use toOrder to address that
+    /// \param[in] reorder   whether the matrix is reordered or not
+    std::string get_mswell_apply_string(bool reorder);
+
     /// Generate string with the exact ilu decomposition kernel
     /// The kernel takes a full BSR matrix and performs inplace ILU decomposition
-    std::string get_ilu_decomp_string();
+    /// \param[in] block_size   size of the blocks, 1 to 4, the kernels are generated for it
+    std::string get_ilu_decomp_string(unsigned int block_size);
+
+    /// Generate string with the quasi-IMPES weights kernel for CPR
+    /// solves D^T w = e_p for the diagonal block D of every blockrow
+    std::string get_cpr_weights_string();
+
+    /// Generate string with the kernel that extracts the CPR pressure matrix
+    /// coarse_vals[block] = sum_r w[r] * block[r][pressure_idx], keeps the sparsity pattern of the blocked matrix
+    std::string get_cpr_coarse_matrix_string();
+
+    /// Generate string with the CPR restriction kernel
+    /// rp[i] = sum_k w[i][k] * r[i][k]
+    std::string get_cpr_restrict_string();
+
+    /// Generate string with the CPR prolongation kernel
+    /// x[i][pressure_idx] = xp[i], the other components are set to 0
+    std::string get_cpr_prolongate_string();
+
+    /// Generate string with the AMG residual kernel
+    /// r = b - A * x, for a scalar CSR matrix
+    std::string get_amg_residual_string();
+
+    /// Generate string with the AMG jacobi smoother kernel
+    /// x += omega * invDiag * r
+    std::string get_amg_jacobi_string();
+
+    /// Generate string with the AMG restriction kernel
+    /// rc[a] = sum of r over the rows in aggregate a
+    std::string get_amg_restrict_string();
+
+    /// Generate string with the AMG prolongation kernel
+    /// x[i] += xc[aggregates[i]]
+    std::string get_amg_prolongate_string();
+
+    /// Generate string with the dense matrix-vector kernel
+    /// x = Ainv * b, used to apply the inverse of the coarsest AMG level
+    std::string get_amg_dense_mv_string();
 
 } // end namespace bda
 
@@ -18,7 +18,9 @@
 */
 
 #include <config.h>
+#include <algorithm>
 #include <cmath>
+#include <numeric>
 #include <sstream>
 
 #include <opm/common/OpmLog/OpmLog.hpp>
@@ -35,6 +37,11 @@
 // otherwise, the nonzeroes of the matrix are assumed to be in a contiguous array, and a single GPU memcpy is enough
 #define COPY_ROW_BY_ROW 0
 
+// iff true, the spmv in bicgstab uses a blocked SELL-C-sigma copy of the matrix instead of the BSR matrix
+// this gives better coalesced memory access for matrices with irregular rowlengths (faults, NNCs)
+// the copy is made on the GPU after every update of the matrix
+#define SPMV_SELL 0
+
 namespace bda
 {
 
@@ -151,18 +158,20 @@ openclSolverBackend<block_size>::openclSolverBackend(int verbosity_, int maxit_,
         out.clear();
 
         if (devices.size() <= deviceID){
-            OPM_THROW(std::logic_error, "Error chosen too high OpenCL device ID");
-        } else {
-            std::string device_info;
-            out << "Chosen:\n";
-            devices[deviceID].getInfo(CL_DEVICE_NAME, &device_info);
-            out << "CL_DEVICE_NAME            : " << device_info << "\n";
-            devices[deviceID].getInfo(CL_DEVICE_VERSION, &device_info);
-            out << "CL_DEVICE_VERSION         : " << device_info << "\n";
-            OpmLog::info(out.str());
-            out.str("");
-            out.clear();
+            // in parallel runs every process adds its rank to the deviceID,
+            // so that the processes are distributed over the available devices
+            out << "OpenCL device ID " << deviceID << " is too high, using device " << deviceID % devices.size() << "\n";
+            deviceID = deviceID % devices.size();
         }
+        std::string device_info;
+        out << "Chosen:\n";
+        devices[deviceID].getInfo(CL_DEVICE_NAME, &device_info);
+        out << "CL_DEVICE_NAME            : " << device_info << "\n";
+        devices[deviceID].getInfo(CL_DEVICE_VERSION, &device_info);
+        out << "CL_DEVICE_VERSION         : " << device_info << "\n";
+        OpmLog::info(out.str());
+        out.str("");
+        out.clear();
 
         // removed all unused devices
         if (deviceID != 0)
@@ -218,6 +227,9 @@ double openclSolverBackend<block_size>::dot_w(cl::Buffer in1, cl::Buffer in2, cl
     for (unsigned int i = 0; i < num_work_groups; ++i) {
         gpu_sum += tmp[i];
     }
+    if (comm) {
+        gpu_sum = comm->sum(gpu_sum);
+    }
 
     if (verbosity >= 4) {
         event.wait();
@@ -246,6 +258,9 @@ double openclSolverBackend<block_size>::norm_w(cl::Buffer in, cl::Buffer out)
     for (unsigned int i = 0; i < num_work_groups; ++i) {
         gpu_norm += tmp[i];
     }
+    if (comm) {
+        gpu_norm = comm->sum(gpu_norm);
+    }
     gpu_norm = sqrt(gpu_norm);
 
     if (verbosity >= 4) {
@@ -258,6 +273,114 @@ double openclSolverBackend<block_size>::norm_w(cl::Buffer in, cl::Buffer out)
     return gpu_norm;
 }
 
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::dot2_w(cl::Buffer in1, cl::Buffer in2, cl::Buffer in3, cl::Buffer out, double& dot12, double& dot13)
+{
+    const unsigned int work_group_size = 256;
+    const unsigned int num_work_groups = ceilDivision(N, work_group_size);
+    const unsigned int total_work_items = num_work_groups * work_group_size;
+    const unsigned int lmem_per_work_group = sizeof(double) * work_group_size;
+    Timer t_dot;
+
+    cl::Event event = (*dot_2_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), in1, in2, in3, out, N, cl::Local(lmem_per_work_group), cl::Local(lmem_per_work_group));
+
+    queue->enqueueReadBuffer(out, CL_TRUE, 0, sizeof(double) * 2 * num_work_groups, tmp);
+
+    dot12 = 0.0;
+    dot13 = 0.0;
+    for (unsigned int i = 0; i < num_work_groups; ++i) {
+        dot12 += tmp[i];
+        dot13 += tmp[num_work_groups + i];
+    }
+    if (comm) {
+        dot12 = comm->sum(dot12);
+        dot13 = comm->sum(dot13);
+    }
+
+    if (verbosity >= 4) {
+        event.wait();
+        std::ostringstream oss;
+        oss << std::scientific << "openclSolver dot2_w time: " << t_dot.stop() << " s";
+        OpmLog::info(oss.str());
+    }
+}
+
+template <unsigned int block_size>
+double openclSolverBackend<block_size>::bicgstab_update_w(cl::Buffer x, cl::Buffer p, cl::Buffer r, cl::Buffer v, const double a, cl::Buffer out, double& rw_dot_r)
+{
+    const unsigned int work_group_size = 256;
+    const unsigned int num_work_groups = ceilDivision(N, work_group_size);
+    const unsigned int total_work_items = num_work_groups * work_group_size;
+    const unsigned int lmem_per_work_group = sizeof(double) * work_group_size;
+    Timer t_update;
+
+    cl::Event event = (*bicgstab_update_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), x, p, r, v, d_rw, a, out, N, cl::Local(lmem_per_work_group), cl::Local(lmem_per_work_group));
+
+    queue->enqueueReadBuffer(out, CL_TRUE, 0, sizeof(double) * 2 * num_work_groups, tmp);
+
+    double gpu_norm = 0.0;
+    rw_dot_r = 0.0;
+    for (unsigned int i = 0; i < num_work_groups; ++i) {
+        gpu_norm += tmp[i];
+        rw_dot_r += tmp[num_work_groups + i];
+    }
+    if (comm) {
+        gpu_norm = comm->sum(gpu_norm);
+        rw_dot_r = comm->sum(rw_dot_r);
+    }
+    gpu_norm = sqrt(gpu_norm);
+
+    if (verbosity >= 4) {
+        event.wait();
+        std::ostringstream oss;
+        oss << std::scientific << "openclSolver bicgstab_update_w time: " << t_update.stop() << " s";
+        OpmLog::info(oss.str());
+    }
+
+    return gpu_norm;
+}
+
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::project_w(cl::Buffer vec)
+{
+    const unsigned int work_group_size = 32;
+    const unsigned int num_work_groups = ceilDivision(N, work_group_size);
+    const unsigned int total_work_items = num_work_groups * work_group_size;
+    Timer t_project;
+
+    cl::Event event = (*project_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), d_mask, vec, N);
+
+    if (verbosity >= 4) {
+        event.wait();
+        std::ostringstream oss;
+        oss << std::scientific << "openclSolver project_w time: " << t_project.stop() << " s";
+        OpmLog::info(oss.str());
+    }
+}
+
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::halo_exchange_w(cl::Buffer vec)
+{
+    Timer t_halo;
+
+    // the communication works on the original ordering
+    queue->enqueueReadBuffer(vec, CL_TRUE, 0, sizeof(double) * N, h_halo.data());
+    if (opencl_ilu_reorder != ILUReorder::NONE) {
+        reorderBlockedVectorByPattern<block_size>(Nb, h_halo.data(), toOrder, h_halo_ordered.data());
+        comm->copyOwnerToAll(h_halo_ordered.data());
+        reorderBlockedVectorByPattern<block_size>(Nb, h_halo_ordered.data(), fromOrder, h_halo.data());
+    } else {
+        comm->copyOwnerToAll(h_halo.data());
+    }
+    queue->enqueueWriteBuffer(vec, CL_TRUE, 0, sizeof(double) * N, h_halo.data());
+
+    if (verbosity >= 4) {
+        std::ostringstream oss;
+        oss << std::scientific << "openclSolver halo_exchange_w time: " << t_halo.stop() << " s";
+        OpmLog::info(oss.str());
+    }
+}
+
 template <unsigned int block_size>
 void openclSolverBackend<block_size>::axpy_w(cl::Buffer in, const double a, cl::Buffer out)
 {
@@ -294,6 +417,16 @@ void openclSolverBackend<block_size>::custom_w(cl::Buffer p, cl::Buffer v, cl::B
     }
 }
 
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::apply_preconditioner(cl::Buffer& x, cl::Buffer& y)
+{
+    if (use_cpr) {
+        cpr->apply(x, y);
+    } else {
+        prec->apply(x, y);
+    }
+}
+
 template <unsigned int block_size>
 void openclSolverBackend<block_size>::spmv_blocked_w(cl::Buffer vals, cl::Buffer cols, cl::Buffer rows, cl::Buffer x, cl::Buffer b)
 {
@@ -313,14 +446,34 @@ void openclSolverBackend<block_size>::spmv_blocked_w(cl::Buffer vals, cl::Buffer
     }
 }
 
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::spmv_sell_w(cl::Buffer x, cl::Buffer b)
+{
+    const unsigned int work_group_size = 32;
+    const unsigned int num_work_groups = ceilDivision(ceilDivision(Nb, sell_slice_height) * sell_slice_height * block_size, work_group_size);
+    const unsigned int total_work_items = num_work_groups * work_group_size;
+    Timer t_spmv;
+
+    cl::Event event = (*spmv_sell_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), d_sell_vals, d_sell_cols, d_sell_slices, d_sell_rows, Nb, x, b, block_size, sell_slice_height);
+
+    if (verbosity >= 4) {
+        event.wait();
+        std::ostringstream oss;
+        oss << std::scientific << "openclSolver spmv_sell_w time: " << t_spmv.stop() << " s";
+        OpmLog::info(oss.str());
+    }
+}
+
 template <unsigned int block_size>
 void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContribs, BdaResult& res) {
     float it;
-    double rho, rhop, beta, alpha, omega, tmp1, tmp2;
+    double rho, rhop, rw_dot_r, beta, alpha, omega, tmp1, tmp2;
     double norm, norm_0;
 
     if(wellContribs.getNumWells() > 0){
         wellContribs.setKernel(stdwell_apply_k.get(), stdwell_apply_no_reorder_k.get());
+        wellContribs.setMultisegmentKernel(mswell_apply_k.get(), mswell_apply_no_reorder_k.get());
+        wellContribs.setVectorSize(N);
     }
 
     Timer t_total, t_prec(false), t_spmv(false), t_well(false), t_rest(false);
@@ -350,6 +503,8 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
 
     norm = norm_w(d_r, d_tmp);
     norm_0 = norm;
+    // rw is a copy of r
+    rw_dot_r = norm * norm;
 
     if (verbosity > 1) {
         std::ostringstream out;
@@ -360,7 +515,7 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
     t_rest.start();
     for (it = 0.5; it < maxit; it += 0.5) {
         rhop = rho;
-        rho = dot_w(d_rw, d_r, d_tmp);
+        rho = rw_dot_r;     // computed by the last update of r
 
         if (it > 1) {
             beta = (rho / rhop) * (alpha / omega);
@@ -370,12 +525,19 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
 
         // pw = prec(p)
         t_prec.start();
-        prec->apply(d_p, d_pw);
+        apply_preconditioner(d_p, d_pw);
+        if (comm) {
+            halo_exchange_w(d_pw);
+        }
         t_prec.stop();
 
         // v = A * pw
         t_spmv.start();
+#if SPMV_SELL
+        spmv_sell_w(d_pw, d_v);
+#else
         spmv_blocked_w(d_Avals, d_Acols, d_Arows, d_pw, d_v);
+#endif
         t_spmv.stop();
 
         // apply wellContributions
@@ -385,12 +547,16 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
         }
         t_well.stop();
 
+        // the rows not owned by this process are not complete
+        if (comm) {
+            project_w(d_v);
+        }
+
         t_rest.start();
         tmp1 = dot_w(d_rw, d_v, d_tmp);
         alpha = rho / tmp1;
-        axpy_w(d_v, -alpha, d_r);      // r = r - alpha * v
-        axpy_w(d_pw, alpha, d_x);      // x = x + alpha * pw
-        norm = norm_w(d_r, d_tmp);
+        // x = x + alpha * pw, r = r - alpha * v
+        norm = bicgstab_update_w(d_x, d_pw, d_r, d_v, alpha, d_tmp, rw_dot_r);
         t_rest.stop();
 
         if (norm < tolerance * norm_0) {
@@ -401,12 +567,19 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
 
         // s = prec(r)
         t_prec.start();
-        prec->apply(d_r, d_s);
+        apply_preconditioner(d_r, d_s);
+        if (comm) {
+            halo_exchange_w(d_s);
+        }
         t_prec.stop();
 
         // t = A * s
         t_spmv.start();
+#if SPMV_SELL
+        spmv_sell_w(d_s, d_t);
+#else
         spmv_blocked_w(d_Avals, d_Acols, d_Arows, d_s, d_t);
+#endif
         t_spmv.stop();
 
         // apply wellContributions
@@ -416,13 +589,15 @@ void openclSolverBackend<block_size>::gpu_pbicgstab(WellContributions& wellContr
         }
         t_well.stop();
 
+        if (comm) {
+            project_w(d_t);
+        }
+
         t_rest.start();
-        tmp1 = dot_w(d_t, d_r, d_tmp);
-        tmp2 = dot_w(d_t, d_t, d_tmp);
+        dot2_w(d_t, d_r, d_t, d_tmp, tmp1, tmp2);
         omega = tmp1 / tmp2;
-        axpy_w(d_s, omega, d_x);     // x = x + omega * s
-        axpy_w(d_t, -omega, d_r);    // r = r - omega * t
-        norm = norm_w(d_r, d_tmp);
+        // x = x + omega * s, r = r - omega * t
+        norm = bicgstab_update_w(d_x, d_s, d_r, d_t, omega, d_tmp, rw_dot_r);
         t_rest.stop();
 
         if (norm < tolerance * norm_0) {
@@ -478,8 +653,19 @@ void openclSolverBackend<block_size>::initialize(int N_, int nnz_, int dim, doub
     try {
         prec->setOpenCLContext(context.get());
         prec->setOpenCLQueue(queue.get());
+        if (chow_patel) {
+            prec->setChowPatel(chow_patel_sweeps, chow_patel_tolerance);
+        }
+        if (use_cpr) {
+            cpr.reset(new CPR<block_size>(verbosity, cpr_pressure_idx));
+            cpr->setOpenCLContext(context.get());
+            cpr->setOpenCLQueue(queue.get());
+            cpr->setKernelCache(kernel_cache_dir);
+        }
 
-        tmp = new double[N];
+        // the fused reductions store two partial sums per work group
+        const unsigned int tmp_size = std::max(static_cast<unsigned int>(N), 2 * ceilDivision(N, 256));
+        tmp = new double[tmp_size];
 #if COPY_ROW_BY_ROW
         vals_contiguous = new double[N];
 #endif
@@ -495,7 +681,7 @@ void openclSolverBackend<block_size>::initialize(int N_, int nnz_, int dim, doub
         d_s = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
         d_t = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
         d_v = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
-        d_tmp = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
+        d_tmp = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * tmp_size);
 
         d_Avals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * nnz);
         d_Acols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * nnzb);
@@ -503,9 +689,22 @@ void openclSolverBackend<block_size>::initialize(int N_, int nnz_, int dim, doub
 
         bool reorder = (opencl_ilu_reorder != ILUReorder::NONE);
         if (reorder) {
-            rb = new double[N];
             d_toOrder = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * Nb);
         }
+        // in parallel runs b is projected, which must not change the b of the caller
+        if (reorder || comm) {
+            rb = new double[N];
+            rb_allocated = true;
+        }
+        if (comm) {
+            if (comm->ownerMask.size() != static_cast<std::size_t>(N)) {
+                OPM_THROW(std::logic_error, "Error size of ownerMask does not match the size of the matrix in openclSolverBackend");
+            }
+            d_mask = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * N);
+            h_mask.resize(N);
+            h_halo.resize(N);
+            h_halo_ordered.resize(N);
+        }
 
         get_opencl_kernels();
 
@@ -539,15 +738,22 @@ void openclSolverBackend<block_size>::get_opencl_kernels() {
         add_kernel_string(sources, dot_1_s);
         std::string norm_s = get_norm_string();
         add_kernel_string(sources, norm_s);
+        std::string dot_2_s = get_dot_2_string();
+        add_kernel_string(sources, dot_2_s);
+        std::string bicgstab_update_s = get_bicgstab_update_string();
+        add_kernel_string(sources, bicgstab_update_s);
         std::string custom_s = get_custom_string();
         add_kernel_string(sources, custom_s);
+        std::string project_s = get_project_string();
+        add_kernel_string(sources, project_s);
         std::string spmv_blocked_s = get_spmv_blocked_string();
         add_kernel_string(sources, spmv_blocked_s);
-#if CHOW_PATEL
-        bool ilu_operate_on_full_matrix = false;
-#else
-        bool ilu_operate_on_full_matrix = true;
-#endif
+        std::string spmv_sell_s = get_spmv_sell_string();
+        add_kernel_string(sources, spmv_sell_s);
+        std::string sell_gather_s = get_sell_gather_string();
+        add_kernel_string(sources, sell_gather_s);
+        // the ChowPatelIlu keeps L and U in separate matrices
+        bool ilu_operate_on_full_matrix = !chow_patel;
         std::string ILU_apply1_s = get_ILU_apply1_string(ilu_operate_on_full_matrix);
         add_kernel_string(sources, ILU_apply1_s);
         std::string ILU_apply2_s = get_ILU_apply2_string(ilu_operate_on_full_matrix);
@@ -556,11 +762,14 @@ void openclSolverBackend<block_size>::get_opencl_kernels() {
         add_kernel_string(sources, stdwell_apply_s);
         std::string stdwell_apply_no_reorder_s = get_stdwell_apply_string(false);
         add_kernel_string(sources, stdwell_apply_no_reorder_s);
-        std::string ilu_decomp_s = get_ilu_decomp_string();
+        std::string mswell_apply_s = get_mswell_apply_string(true);
+        add_kernel_string(sources, mswell_apply_s);
+        std::string mswell_apply_no_reorder_s = get_mswell_apply_string(false);
+        add_kernel_string(sources, mswell_apply_no_reorder_s);
+        std::string ilu_decomp_s = get_ilu_decomp_string(block_size);
         add_kernel_string(sources, ilu_decomp_s);
 
-        cl::Program program = cl::Program(*context, sources);
-        program.build(devices);
+        cl::Program program = buildProgram(*context, devices, sources, kernel_cache_dir);
 
         // queue.enqueueNDRangeKernel() is a blocking/synchronous call, at least for NVIDIA
         // cl::make_kernel<> myKernel(); myKernel(args, arg1, arg2); is also blocking
@@ -568,19 +777,26 @@ void openclSolverBackend<block_size>::get_opencl_kernels() {
         // actually creating the kernels
         dot_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, cl::LocalSpaceArg>(cl::Kernel(program, "dot_1")));
         norm_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, const unsigned int, cl::LocalSpaceArg>(cl::Kernel(program, "norm")));
+        dot_2_k.reset(new dot_2_kernel_type(cl::Kernel(program, "dot_2")));
+        bicgstab_update_k.reset(new bicgstab_update_kernel_type(cl::Kernel(program, "bicgstab_update")));
         axpy_k.reset(new cl::make_kernel<cl::Buffer&, const double, cl::Buffer&, const unsigned int>(cl::Kernel(program, "axpy")));
         custom_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const double, const double, const unsigned int>(cl::Kernel(program, "custom")));
+        project_k.reset(new cl::make_kernel<cl::Buffer&, cl::Buffer&, const unsigned int>(cl::Kernel(program, "project")));
         spmv_blocked_k.reset(new spmv_kernel_type(cl::Kernel(program, "spmv_blocked")));
+        spmv_sell_k.reset(new spmv_sell_kernel_type(cl::Kernel(program, "spmv_sell")));
+        sell_gather_k.reset(new sell_gather_kernel_type(cl::Kernel(program, "sell_gather")));
         ILU_apply1_k.reset(new ilu_apply1_kernel_type(cl::Kernel(program, "ILU_apply1")));
         ILU_apply2_k.reset(new ilu_apply2_kernel_type(cl::Kernel(program, "ILU_apply2")));
         stdwell_apply_k.reset(new stdwell_apply_kernel_type(cl::Kernel(program, "stdwell_apply")));
         stdwell_apply_no_reorder_k.reset(new stdwell_apply_no_reorder_kernel_type(cl::Kernel(program, "stdwell_apply_no_reorder")));
+        mswell_apply_k.reset(new mswell_apply_kernel_type(cl::Kernel(program, "mswell_apply")));
+        mswell_apply_no_reorder_k.reset(new mswell_apply_no_reorder_kernel_type(cl::Kernel(program, "mswell_apply_no_reorder")));
         ilu_decomp_k.reset(new ilu_decomp_kernel_type(cl::Kernel(program, "ilu_decomp")));
 } // end get_opencl_kernels()
 
 template <unsigned int block_size>
 void openclSolverBackend<block_size>::finalize() {
-    if (opencl_ilu_reorder != ILUReorder::NONE) {
+    if (rb_allocated) {
         delete[] rb;
     }
     delete[] tmp;
@@ -615,6 +831,10 @@ void openclSolverBackend<block_size>::copy_system_to_gpu() {
         events.resize(6);
         queue->enqueueWriteBuffer(d_toOrder, CL_TRUE, 0, sizeof(int) * Nb, toOrder, nullptr, &events[5]);
     }
+    if (comm) {
+        events.resize(events.size() + 1);
+        err |= queue->enqueueWriteBuffer(d_mask, CL_TRUE, 0, sizeof(double) * N, h_mask.data(), nullptr, &events.back());
+    }
     cl::WaitForEvents(events);
     events.clear();
     if (err != CL_SUCCESS) {
@@ -633,6 +853,8 @@ void openclSolverBackend<block_size>::copy_system_to_gpu() {
 template <unsigned int block_size>
 void openclSolverBackend<block_size>::update_system_on_gpu() {
     Timer t;
+    // the writes are not blocking, so that the transfers of the matrix and the vectors
+    // can overlap, the host buffers stay valid until all events are finished
     events.resize(3);
 
 #if COPY_ROW_BY_ROW
@@ -642,12 +864,12 @@ void openclSolverBackend<block_size>::update_system_on_gpu() {
         memcpy(vals_contiguous + sum, reinterpret_cast<double*>(rmat->nnzValues) + sum, size_row * sizeof(double) * block_size * block_size);
         sum += size_row * block_size * block_size;
     }
-    err = queue->enqueueWriteBuffer(d_Avals, CL_TRUE, 0, sizeof(double) * nnz, vals_contiguous, nullptr, &events[0]);
+    err = queue->enqueueWriteBuffer(d_Avals, CL_FALSE, 0, sizeof(double) * nnz, vals_contiguous, nullptr, &events[0]);
 #else
-    err = queue->enqueueWriteBuffer(d_Avals, CL_TRUE, 0, sizeof(double) * nnz, rmat->nnzValues, nullptr, &events[0]);
+    err = queue->enqueueWriteBuffer(d_Avals, CL_FALSE, 0, sizeof(double) * nnz, rmat->nnzValues, nullptr, &events[0]);
 #endif
 
-    err |= queue->enqueueWriteBuffer(d_b, CL_TRUE, 0, sizeof(double) * N, rb, nullptr, &events[1]);
+    err |= queue->enqueueWriteBuffer(d_b, CL_FALSE, 0, sizeof(double) * N, rb, nullptr, &events[1]);
     err |= queue->enqueueFillBuffer(d_x, 0, 0, sizeof(double) * N, nullptr, &events[2]);
     cl::WaitForEvents(events);
     events.clear();
@@ -664,6 +886,92 @@ void openclSolverBackend<block_size>::update_system_on_gpu() {
 } // end update_system_on_gpu()
 
 
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::setup_sell() {
+    Timer t;
+
+    const unsigned int C = sell_slice_height;
+    const unsigned int num_slices = ceilDivision(Nb, C);
+    const int *rowPointers = rmat->rowPointers;
+    auto rowLength = [rowPointers](int row) { return rowPointers[row + 1] - rowPointers[row]; };
+
+    // sort the blockrows by length within every window of sell_sigma blockrows
+    std::vector<int> rows(num_slices * C, -1);
+    std::iota(rows.begin(), rows.begin() + Nb, 0);
+    for (int start = 0; start < Nb; start += sell_sigma) {
+        const int end = std::min(start + static_cast<int>(sell_sigma), static_cast<int>(Nb));
+        std::stable_sort(rows.begin() + start, rows.begin() + end,
+                         [&rowLength](int a, int b) { return rowLength(a) > rowLength(b); });
+    }
+
+    std::vector<unsigned int> slices(num_slices + 1, 0);
+    for (unsigned int slice = 0; slice < num_slices; ++slice) {
+        int width = 0;
+        for (unsigned int lane = 0; lane < C; ++lane) {
+            const int row = rows[slice * C + lane];
+            if (row >= 0) {
+                width = std::max(width, rowLength(row));
+            }
+        }
+        slices[slice + 1] = slices[slice] + width * C;
+    }
+    sell_num_blocks = slices[num_slices];
+
+    // padding blocks point to column 0 and are filled with zeroes by update_sell()
+    std::vector<int> cols(sell_num_blocks, 0);
+    std::vector<int> map(sell_num_blocks, -1);
+    for (unsigned int slice = 0; slice < num_slices; ++slice) {
+        for (unsigned int lane = 0; lane < C; ++lane) {
+            const int row = rows[slice * C + lane];
+            if (row < 0) {
+                continue;
+            }
+            for (int k = 0; k < rowLength(row); ++k) {
+                const unsigned int pos = slices[slice] + k * C + lane;
+                cols[pos] = rmat->colIndices[rowPointers[row] + k];
+                map[pos] = rowPointers[row] + k;
+            }
+        }
+    }
+
+    d_sell_vals = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(double) * sell_num_blocks * block_size * block_size);
+    d_sell_cols = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * sell_num_blocks);
+    d_sell_map = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * sell_num_blocks);
+    d_sell_slices = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(unsigned int) * (num_slices + 1));
+    d_sell_rows = cl::Buffer(*context, CL_MEM_READ_WRITE, sizeof(int) * rows.size());
+
+    events.resize(4);
+    err = queue->enqueueWriteBuffer(d_sell_cols, CL_FALSE, 0, sizeof(int) * sell_num_blocks, cols.data(), nullptr, &events[0]);
+    err |= queue->enqueueWriteBuffer(d_sell_map, CL_FALSE, 0, sizeof(int) * sell_num_blocks, map.data(), nullptr, &events[1]);
+    err |= queue->enqueueWriteBuffer(d_sell_slices, CL_FALSE, 0, sizeof(unsigned int) * (num_slices + 1), slices.data(), nullptr, &events[2]);
+    err |= queue->enqueueWriteBuffer(d_sell_rows, CL_FALSE, 0, sizeof(int) * rows.size(), rows.data(), nullptr, &events[3]);
+    cl::WaitForEvents(events);
+    events.clear();
+    if (err != CL_SUCCESS) {
+        // enqueueWriteBuffer is C and does not throw exceptions like C++ OpenCL
+        OPM_THROW(std::logic_error, "openclSolverBackend OpenCL enqueueWriteBuffer error");
+    }
+
+    if (verbosity > 2) {
+        std::ostringstream out;
+        out << "openclSolver::setup_sell(): " << t.stop() << " s, padding: "
+            << sell_num_blocks - nnzb << " blocks";
+        OpmLog::info(out.str());
+    }
+} // end setup_sell()
+
+
+template <unsigned int block_size>
+void openclSolverBackend<block_size>::update_sell() {
+    const unsigned int work_group_size = 32;
+    const unsigned int num_work_groups = ceilDivision(sell_num_blocks * block_size * block_size, work_group_size);
+    const unsigned int total_work_items = num_work_groups * work_group_size;
+
+    // the queue is in-order, so the gather runs after the matrix upload and before the first spmv
+    (*sell_gather_k)(cl::EnqueueArgs(*queue, cl::NDRange(total_work_items), cl::NDRange(work_group_size)), d_Avals, d_sell_map, d_sell_vals, sell_num_blocks, block_size);
+} // end update_sell()
+
+
 template <unsigned int block_size>
 bool openclSolverBackend<block_size>::analyse_matrix() {
     Timer t;
@@ -683,6 +991,18 @@ bool openclSolverBackend<block_size>::analyse_matrix() {
         rmat = prec->getRMat();
     }
 
+    if (success && use_cpr) {
+        success = cpr->init(rmat, d_Avals, d_Acols, d_Arows, prec);
+    }
+
+    if (comm) {
+        if (opencl_ilu_reorder == ILUReorder::NONE) {
+            std::copy(comm->ownerMask.begin(), comm->ownerMask.end(), h_mask.begin());
+        } else {
+            reorderBlockedVectorByPattern<block_size>(Nb, comm->ownerMask.data(), fromOrder, h_mask.data());
+        }
+    }
+
     if (verbosity > 2) {
         std::ostringstream out;
         out << "openclSolver::analyse_matrix(): " << t.stop() << " s";
@@ -704,10 +1024,21 @@ void openclSolverBackend<block_size>::update_system(double *vals, double *b, Wel
         reorderBlockedVectorByPattern<block_size>(mat->Nb, b, fromOrder, rb);
         wellContribs.setReordering(toOrder, true);
     } else {
-        rb = b;
+        if (comm) {
+            std::copy(b, b + N, rb);
+        } else {
+            rb = b;
+        }
         wellContribs.setReordering(nullptr, false);
     }
 
+    // only the rows owned by this process contribute to the residual
+    if (comm) {
+        for (int i = 0; i < N; ++i) {
+            rb[i] *= h_mask[i];
+        }
+    }
+
     if (verbosity > 2) {
         std::ostringstream out;
         out << "openclSolver::update_system(): " << t.stop() << " s";
@@ -781,25 +1112,56 @@ void openclSolverBackend<block_size>::get_result(double *x) {
 
 template <unsigned int block_size>
 SolverStatus openclSolverBackend<block_size>::solve_system(int N_, int nnz_, int dim, double *vals, int *rows, int *cols, double *b, WellContributions& wellContribs, BdaResult &res) {
+    SolverStatus status = SolverStatus::BDA_SOLVER_SUCCESS;
     if (initialized == false) {
         initialize(N_, nnz_,  dim, vals, rows, cols);
         if (analysis_done == false) {
             if (!analyse_matrix()) {
-                return SolverStatus::BDA_SOLVER_ANALYSIS_FAILED;
+                status = SolverStatus::BDA_SOLVER_ANALYSIS_FAILED;
             }
         }
-        update_system(vals, b, wellContribs);
-        if (!create_preconditioner()) {
-            return SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
+        if (status == SolverStatus::BDA_SOLVER_SUCCESS) {
+            update_system(vals, b, wellContribs);
+            if (!create_preconditioner()) {
+                status = SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
+            } else {
+                copy_system_to_gpu();
+#if SPMV_SELL
+                setup_sell();
+                update_sell();
+#endif
+                // the CPR weights and pressure matrix are computed from the matrix on the GPU
+                if (use_cpr && !cpr->create_preconditioner()) {
+                    status = SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
+                }
+            }
         }
-        copy_system_to_gpu();
     } else {
         update_system(vals, b, wellContribs);
         if (!create_preconditioner()) {
-            return SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
+            status = SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
+        } else {
+            update_system_on_gpu();
+#if SPMV_SELL
+            update_sell();
+#endif
+            if (use_cpr && !cpr->create_preconditioner()) {
+                status = SolverStatus::BDA_SOLVER_CREATE_PRECONDITIONER_FAILED;
+            }
         }
-        update_system_on_gpu();
     }
+
+    // the solve contains global reductions, either all processes solve or none
+    if (comm) {
+        const double success = comm->min(status == SolverStatus::BDA_SOLVER_SUCCESS ? 1.0 : 0.0);
+        if (status == SolverStatus::BDA_SOLVER_SUCCESS && success < 1.0) {
+            status = SolverStatus::BDA_SOLVER_FAILED_ON_OTHER_PROCESS;
+        }
+    }
+    if (status != SolverStatus::BDA_SOLVER_SUCCESS) {
+        return status;
+    }
+
     solve_system(wellContribs, res);
     return SolverStatus::BDA_SOLVER_SUCCESS;
 }
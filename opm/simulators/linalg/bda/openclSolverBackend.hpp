@@ -27,6 +27,7 @@
 #include <opm/simulators/linalg/bda/ILUReorder.hpp>
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
 #include <opm/simulators/linalg/bda/BILU0.hpp>
+#include <opm/simulators/linalg/bda/CPR.hpp>
 
 #include <tuple>
 
@@ -50,6 +51,13 @@ class openclSolverBackend : public BdaSolver<block_size>
     using Base::maxit;
     using Base::tolerance;
     using Base::initialized;
+    using Base::comm;
+    using Base::chow_patel;
+    using Base::chow_patel_sweeps;
+    using Base::chow_patel_tolerance;
+    using Base::use_cpr;
+    using Base::cpr_pressure_idx;
+    using Base::kernel_cache_dir;
 
 private:
     double *rb = nullptr;                 // reordered b vector, if the matrix is reordered, rb is newly allocated, otherwise it just points to b
@@ -62,21 +70,41 @@ private:
     cl::Buffer d_tmp;                            // used as tmp GPU buffer for dot() and norm()
     cl::Buffer d_toOrder;                        // only used when reordering is used
     double *tmp = nullptr;                       // used as tmp CPU buffer for dot() and norm()
+    bool rb_allocated = false;                   // rb is allocated if the matrix is reordered or the solve is parallel
+
+    // only used in parallel runs
+    cl::Buffer d_mask;                           // (reordered) ownerMask of the BdaCommunication
+    std::vector<double> h_mask;                  // (reordered) ownerMask, used to project b
+    std::vector<double> h_halo, h_halo_ordered;  // CPU buffers for halo_exchange_w()
+
+    // blocked SELL-C-sigma copy of rmat, only used if SPMV_SELL is true in openclSolverBackend.cpp
+    static constexpr unsigned int sell_slice_height = 32;   // number of blockrows per slice
+    static constexpr unsigned int sell_sigma = 1024;        // blockrows are sorted by length within windows of this size
+    cl::Buffer d_sell_vals, d_sell_cols, d_sell_slices, d_sell_rows, d_sell_map;
+    unsigned int sell_num_blocks = 0;                       // number of blocks in the SELL layout, including padding
 
     // shared pointers are also passed to other objects
     std::vector<cl::Device> devices;
     std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const unsigned int, cl::LocalSpaceArg> > dot_k;
     std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, const unsigned int, cl::LocalSpaceArg> > norm_k;
+    std::unique_ptr<dot_2_kernel_type> dot_2_k;
+    std::unique_ptr<bicgstab_update_kernel_type> bicgstab_update_k;
     std::unique_ptr<cl::make_kernel<cl::Buffer&, const double, cl::Buffer&, const unsigned int> > axpy_k;
     std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, cl::Buffer&, const double, const double, const unsigned int> > custom_k;
+    std::unique_ptr<cl::make_kernel<cl::Buffer&, cl::Buffer&, const unsigned int> > project_k;
     std::unique_ptr<spmv_kernel_type> spmv_blocked_k;
+    std::unique_ptr<spmv_sell_kernel_type> spmv_sell_k;
+    std::unique_ptr<sell_gather_kernel_type> sell_gather_k;
     std::shared_ptr<ilu_apply1_kernel_type> ILU_apply1_k;
     std::shared_ptr<ilu_apply2_kernel_type> ILU_apply2_k;
     std::shared_ptr<stdwell_apply_kernel_type> stdwell_apply_k;
     std::shared_ptr<stdwell_apply_no_reorder_kernel_type> stdwell_apply_no_reorder_k;
+    std::shared_ptr<mswell_apply_kernel_type> mswell_apply_k;
+    std::shared_ptr<mswell_apply_no_reorder_kernel_type> mswell_apply_no_reorder_k;
     std::shared_ptr<ilu_decomp_kernel_type> ilu_decomp_k;
 
-    Preconditioner *prec = nullptr;                               // only supported preconditioner is BILU0
+    Preconditioner *prec = nullptr;                               // BILU0, also the second stage of CPR
+    std::unique_ptr<CPR<block_size> > cpr = nullptr;              // only used if use_cpr is true
     int *toOrder = nullptr, *fromOrder = nullptr;                 // BILU0 reorders rows of the matrix via these mappings
     bool analysis_done = false;
     std::unique_ptr<BlockedMatrix<block_size> > mat = nullptr;    // original matrix 
@@ -105,6 +133,36 @@ private:
     /// \return                norm
     double norm_w(cl::Buffer in, cl::Buffer out);
 
+    /// Calculate the dot products of in1 with in2 and in3 in one pass, partial sums are stored in out, which are summed on the CPU
+    /// \param[in] in1          input vector 1
+    /// \param[in] in2          input vector 2
+    /// \param[in] in3          input vector 3
+    /// \param[out] out         output vector containing partial sums, at least 2 per work group
+    /// \param[out] dot12       dot product of in1 and in2
+    /// \param[out] dot13       dot product of in1 and in3
+    void dot2_w(cl::Buffer in1, cl::Buffer in2, cl::Buffer in3, cl::Buffer out, double& dot12, double& dot13);
+
+    /// Perform x += a * p and r -= a * v, and calculate the norm of the updated r and its dot product with rw
+    /// in the same pass, partial sums are stored in out, which are summed on the CPU
+    /// \param[inout] x         solution vector
+    /// \param[in] p            search direction
+    /// \param[inout] r         residual vector
+    /// \param[in] v            A times p
+    /// \param[in] a            step length
+    /// \param[out] out         output vector containing partial sums, at least 2 per work group
+    /// \param[out] rw_dot_r    dot product of rw and the updated r
+    /// \return                 norm of the updated r
+    double bicgstab_update_w(cl::Buffer x, cl::Buffer p, cl::Buffer r, cl::Buffer v, const double a, cl::Buffer out, double& rw_dot_r);
+
+    /// Zero the rows of vec that are not owned by this process, only used in parallel runs
+    /// \param[inout] vec    vector to be projected
+    void project_w(cl::Buffer vec);
+
+    /// Give the non-owned rows of vec the values of their owner, only used in parallel runs
+    /// The vector is copied to the CPU and back, the communication is done by comm->copyOwnerToAll
+    /// \param[inout] vec    vector to be made consistent
+    void halo_exchange_w(cl::Buffer vec);
+
     /// Perform axpy: out += a * in
     /// \param[in] in         input vector
     /// \param[in] a          scalar value to multiply input vector
@@ -130,6 +188,24 @@ private:
     /// \param[out] b       output vector
     void spmv_blocked_w(cl::Buffer vals, cl::Buffer cols, cl::Buffer rows, cl::Buffer x, cl::Buffer b);
 
+    /// Sparse matrix-vector multiply with the SELL-C-sigma copy of the matrix
+    /// b = A * x
+    /// \param[in] x        input vector
+    /// \param[out] b       output vector
+    void spmv_sell_w(cl::Buffer x, cl::Buffer b);
+
+    /// Build the SELL-C-sigma structure from the sparsity pattern of rmat and copy it to the GPU
+    /// Must be called once after the sparsity pattern is known, the values are set by update_sell()
+    void setup_sell();
+
+    /// Copy the nonzeroes in d_Avals into the SELL-C-sigma layout
+    void update_sell();
+
+    /// Apply the selected preconditioner, y = prec(x)
+    /// \param[in] x             input vector
+    /// \param[out] y            output vector
+    void apply_preconditioner(cl::Buffer& x, cl::Buffer& y);
+
     /// Solve linear system using ilu0-bicgstab
     /// \param[in] wellContribs   WellContributions, to apply them separately, instead of adding them to matrix A
     /// \param[inout] res         summary of solver result
@@ -20,10 +20,15 @@
 #ifndef OPM_GET_QUASI_IMPES_WEIGHTS_HEADER_INCLUDED
 #define OPM_GET_QUASI_IMPES_WEIGHTS_HEADER_INCLUDED
 
+#include <opm/models/parallel/threadedentityiterator.hh>
+
 #include <dune/common/fvector.hh>
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <exception>
+#include <type_traits>
 
 namespace Opm
 {
@@ -44,37 +49,48 @@ namespace Details
 
 namespace Amg
 {
+    /// The quasi-IMPES weights of a single row, computed from its diagonal block.
+    template <class VectorBlockType, class MatrixRow>
+    VectorBlockType getQuasiImpesRowWeights(const MatrixRow& row, const std::size_t rowIdx,
+                                            const int pressureVarIndex, const bool transpose)
+    {
+        using MatrixBlockType = std::decay_t<decltype(*row.begin())>;
+        VectorBlockType rhs(0.0);
+        rhs[pressureVarIndex] = 1.0;
+        MatrixBlockType diag_block(0.0);
+        const auto endj = row.end();
+        for (auto j = row.begin(); j != endj; ++j) {
+            if (j.index() == rowIdx) {
+                diag_block = (*j);
+                break;
+            }
+        }
+        VectorBlockType bweights;
+        if (transpose) {
+            diag_block.solve(bweights, rhs);
+        } else {
+            auto diag_block_transpose = Details::transposeDenseMatrix(diag_block);
+            diag_block_transpose.solve(bweights, rhs);
+        }
+        double abs_max = *std::max_element(
+            bweights.begin(), bweights.end(), [](double a, double b) { return std::fabs(a) < std::fabs(b); });
+        bweights /= std::fabs(abs_max);
+        return bweights;
+    }
+
     template <class Matrix, class Vector>
     void getQuasiImpesWeights(const Matrix& matrix, const int pressureVarIndex, const bool transpose, Vector& weights)
     {
         using VectorBlockType = typename Vector::block_type;
-        using MatrixBlockType = typename Matrix::block_type;
         const Matrix& A = matrix;
-        VectorBlockType rhs(0.0);
-        rhs[pressureVarIndex] = 1.0;
-        const auto endi = A.end();
-        for (auto i = A.begin(); i != endi; ++i) {
-            const auto endj = (*i).end();
-            MatrixBlockType diag_block(0.0);
-            for (auto j = (*i).begin(); j != endj; ++j) {
-                if (i.index() == j.index()) {
-                    diag_block = (*j);
-                    break;
-                }
-            }
-            VectorBlockType bweights;
-            if (transpose) {
-                diag_block.solve(bweights, rhs);
-            } else {
-                auto diag_block_transpose = Details::transposeDenseMatrix(diag_block);
-                diag_block_transpose.solve(bweights, rhs);
-            }
-            double abs_max = *std::max_element(
-                bweights.begin(), bweights.end(), [](double a, double b) { return std::fabs(a) < std::fabs(b); });
-            bweights /= std::fabs(abs_max);
-            weights[i.index()] = bweights;
+        // Every row only reads its own diagonal block and writes its own weight.
+        const int numRows = A.N();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            weights[rowIdx] = getQuasiImpesRowWeights<VectorBlockType>(A[rowIdx], rowIdx, pressureVarIndex, transpose);
         }
-        // return weights;
     }
 
     template <class Matrix, class Vector>
@@ -85,11 +101,12 @@ namespace Amg
         return weights;
     }
 
-    template<class Vector, class GridView, class ElementContext, class Model>
-    void getTrueImpesWeights(int pressureVarIndex, Vector& weights, const GridView& gridView,
-                             ElementContext& elemCtx, const Model& model, std::size_t threadId)
+    /// The true-IMPES weights of the cell of an element context whose primary
+    /// stencil and intensive quantities are up to date.
+    template<class VectorBlockType, class ElementContext, class Model>
+    VectorBlockType getTrueImpesCellWeights(int pressureVarIndex, ElementContext& elemCtx,
+                                            const Model& model, std::size_t threadId)
     {
-        using VectorBlockType = typename Vector::block_type;
         using Matrix = typename std::decay_t<decltype(model.linearizer().jacobian())>;
         using MatrixBlockType = typename Matrix::MatrixBlock;
         constexpr int numEq = VectorBlockType::size();
@@ -97,34 +114,66 @@ namespace Amg
             ::block_type;
         VectorBlockType rhs(0.0);
         rhs[pressureVarIndex] = 1.0;
-        int index = 0;
-        auto elemIt = gridView.template begin</*codim=*/0>();
-        const auto& elemEndIt = gridView.template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            elemCtx.updatePrimaryStencil(*elemIt);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-            Dune::FieldVector<Evaluation, numEq> storage;
-            model.localLinearizer(threadId).localResidual().computeStorage(storage,elemCtx,/*spaceIdx=*/0, /*timeIdx=*/0);
-            auto extrusionFactor = elemCtx.intensiveQuantities(0, /*timeIdx=*/0).extrusionFactor();
-            auto scvVolume = elemCtx.stencil(/*timeIdx=*/0).subControlVolume(0).volume() * extrusionFactor;
-            auto storage_scale = scvVolume / elemCtx.simulator().timeStepSize();
-            MatrixBlockType block;
-            double pressure_scale = 50e5;
-            for (int ii = 0; ii < numEq; ++ii) {
-                for (int jj = 0; jj < numEq; ++jj) {
-                    block[ii][jj] = storage[ii].derivative(jj)/storage_scale;
-                    if (jj == pressureVarIndex) {
-                        block[ii][jj] *= pressure_scale;
-                    }
+        Dune::FieldVector<Evaluation, numEq> storage;
+        model.localLinearizer(threadId).localResidual().computeStorage(storage,elemCtx,/*spaceIdx=*/0, /*timeIdx=*/0);
+        auto extrusionFactor = elemCtx.intensiveQuantities(0, /*timeIdx=*/0).extrusionFactor();
+        auto scvVolume = elemCtx.stencil(/*timeIdx=*/0).subControlVolume(0).volume() * extrusionFactor;
+        auto storage_scale = scvVolume / elemCtx.simulator().timeStepSize();
+        MatrixBlockType block;
+        double pressure_scale = 50e5;
+        for (int ii = 0; ii < numEq; ++ii) {
+            for (int jj = 0; jj < numEq; ++jj) {
+                block[ii][jj] = storage[ii].derivative(jj)/storage_scale;
+                if (jj == pressureVarIndex) {
+                    block[ii][jj] *= pressure_scale;
                 }
             }
-            VectorBlockType bweights;
-            MatrixBlockType block_transpose = Details::transposeDenseMatrix(block);
-            block_transpose.solve(bweights, rhs);
-            bweights /= 1000.0; // given normal densities this scales weights to about 1.
-            weights[index] = bweights;
-            ++index;
         }
+        VectorBlockType bweights;
+        MatrixBlockType block_transpose = Details::transposeDenseMatrix(block);
+        block_transpose.solve(bweights, rhs);
+        bweights /= 1000.0; // given normal densities this scales weights to about 1.
+        return bweights;
+    }
+
+    /// The true-IMPES weights computed by all threads of the thread manager, each
+    /// with its own element context. The weights are stored at the global index of
+    /// the cells, such that the order in which the threads visit them does not matter.
+    template<class ElementContext, class ThreadManager, class Vector, class Simulator>
+    void getTrueImpesWeights(int pressureVarIndex, Vector& weights, const Simulator& simulator)
+    {
+        using VectorBlockType = typename Vector::block_type;
+        using GridView = std::decay_t<decltype(simulator.vanguard().gridView())>;
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(simulator.vanguard().gridView());
+        std::exception_ptr exc;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator);
+            const std::size_t threadId = ThreadManager::threadId();
+            auto elemIt = threadedElemIt.beginParallel();
+            try {
+                for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                    elemCtx.updatePrimaryStencil(*elemIt);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    const unsigned globalIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+                    weights[globalIdx] = getTrueImpesCellWeights<VectorBlockType>(pressureVarIndex, elemCtx,
+                                                                                  simulator.model(), threadId);
+                }
+            }
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                exc = std::current_exception();
+                // let this thread stop picking up elements, the others run out of work as well
+                while (!threadedElemIt.isFinished(elemIt))
+                    elemIt = threadedElemIt.increment();
+            }
+        }
+        if (exc)
+            std::rethrow_exception(exc);
     }
 } // namespace Amg
 
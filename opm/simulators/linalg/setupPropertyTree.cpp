@@ -34,15 +34,22 @@ setupCPR(const std::string& conf, const FlowLinearSolverParameters& p)
     prm.put("maxiter", p.linear_solver_maxiter_);
     prm.put("tol", p.linear_solver_reduction_);
     prm.put("verbosity", p.linear_solver_verbosity_);
+    prm.put("stagnation_iterations", p.linear_solver_stagnation_iterations_);
+    prm.put("stagnation_reduction", p.linear_solver_stagnation_reduction_);
+    prm.put("divergence_factor", p.linear_solver_divergence_factor_);
     prm.put("solver", "bicgstab");
     prm.put("preconditioner.type", "cpr");
     if (conf == "cpr_quasiimpes") {
         prm.put("preconditioner.weight_type", "quasiimpes");
+        prm.put("preconditioner.fused_weights", p.cpr_fused_weights_);
     } else {
         prm.put("preconditioner.weight_type", "trueimpes");
     }
     prm.put("preconditioner.finesmoother.type", "ParOverILU0");
     prm.put("preconditioner.finesmoother.relaxation", 1.0);
+    prm.put("preconditioner.finesmoother.level_scheduling", p.ilu_level_scheduling_);
+    prm.put("preconditioner.finesmoother.mixed_precision", p.ilu_mixed_precision_);
+    prm.put("preconditioner.finesmoother.cuthill_mckee", p.ilu_cuthill_mckee_);
     prm.put("preconditioner.pressure_var_index", 1);
     prm.put("preconditioner.verbosity", 0);
     prm.put("preconditioner.coarsesolver.maxiter", 1);
@@ -58,6 +65,7 @@ setupCPR(const std::string& conf, const FlowLinearSolverParameters& p)
     prm.put("preconditioner.coarsesolver.preconditioner.post_smooth", 1);
     prm.put("preconditioner.coarsesolver.preconditioner.beta", 1e-5);
     prm.put("preconditioner.coarsesolver.preconditioner.smoother", "ILU0");
+    prm.put("preconditioner.coarsesolver.preconditioner.mixed_precision", p.ilu_mixed_precision_);
     prm.put("preconditioner.coarsesolver.preconditioner.verbosity", 0);
     prm.put("preconditioner.coarsesolver.preconditioner.maxlevel", 15);
     prm.put("preconditioner.coarsesolver.preconditioner.skip_isolated", 0);
@@ -81,6 +89,9 @@ setupAMG([[maybe_unused]] const std::string& conf, const FlowLinearSolverParamet
     prm.put("tol", p.linear_solver_reduction_);
     prm.put("maxiter", p.linear_solver_maxiter_);
     prm.put("verbosity", p.linear_solver_verbosity_);
+    prm.put("stagnation_iterations", p.linear_solver_stagnation_iterations_);
+    prm.put("stagnation_reduction", p.linear_solver_stagnation_reduction_);
+    prm.put("divergence_factor", p.linear_solver_divergence_factor_);
     prm.put("solver", "bicgstab");
     prm.put("preconditioner.type", "amg");
     prm.put("preconditioner.alpha", 0.333333333333);
@@ -114,10 +125,16 @@ setupILU([[maybe_unused]] const std::string& conf, const FlowLinearSolverParamet
     prm.put("tol", p.linear_solver_reduction_);
     prm.put("maxiter", p.linear_solver_maxiter_);
     prm.put("verbosity", p.linear_solver_verbosity_);
+    prm.put("stagnation_iterations", p.linear_solver_stagnation_iterations_);
+    prm.put("stagnation_reduction", p.linear_solver_stagnation_reduction_);
+    prm.put("divergence_factor", p.linear_solver_divergence_factor_);
     prm.put("solver", "bicgstab");
     prm.put("preconditioner.type", "ParOverILU0");
     prm.put("preconditioner.relaxation", p.ilu_relaxation_);
     prm.put("preconditioner.ilulevel", p.ilu_fillin_level_);
+    prm.put("preconditioner.level_scheduling", p.ilu_level_scheduling_);
+    prm.put("preconditioner.mixed_precision", p.ilu_mixed_precision_);
+    prm.put("preconditioner.cuthill_mckee", p.ilu_cuthill_mckee_);
     return prm;
 }
 
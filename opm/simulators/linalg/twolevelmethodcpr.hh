@@ -17,6 +17,7 @@
 
 #include<dune/common/unused.hh>
 #include<dune/common/version.hh>
+#include <opm/simulators/utils/MemoryReport.hpp>
 
 /**
  * @addtogroup ISTL_PAAMG
@@ -463,6 +464,17 @@ public:
     }
   }
 
+  /**
+   * @brief The bytes of the coarse level matrix and of the data stored by
+   * the coarse level solver.
+   */
+  std::size_t coarseMemoryUsage() const
+  {
+    const auto& coarseOperator = policy_->getCoarseLevelOperator();
+    return (coarseOperator ? Opm::matrixMemoryUsage(coarseOperator->getmat()) : 0)
+      + (coarseSolver_ ? coarseSolver_->memoryUsage() : 0);
+  }
+
   void pre(FineDomainType& x, FineRangeType& b)
   {
     smoother_->pre(x,b);
@@ -87,6 +87,10 @@ struct TimeStepControlTargetNewtonIterations {
     using type = UndefinedProperty;
 };
 template<class TypeTag, class MyTypeTag>
+struct TimeStepControlHistoryLength {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
 struct TimeStepControlDecayRate {
     using type = UndefinedProperty;
 };
@@ -184,6 +188,10 @@ struct TimeStepControlTargetNewtonIterations<TypeTag, TTag::FlowTimeSteppingPara
     static constexpr int value = 8;
 };
 template<class TypeTag>
+struct TimeStepControlHistoryLength<TypeTag, TTag::FlowTimeSteppingParameters> {
+    static constexpr int value = 5;
+};
+template<class TypeTag>
 struct TimeStepControlDecayRate<TypeTag, TTag::FlowTimeSteppingParameters> {
     using type = GetPropType<TypeTag, Scalar>;
     static constexpr type value = 0.75;
@@ -328,13 +336,15 @@ namespace Opm {
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepAfterEventInDays,
                                  "Time step size of the first time step after an event occurs during the simulation in days");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, TimeStepControl,
-                                 "The algorithm used to determine time-step sizes. valid options are: 'pid' (default), 'pid+iteration', 'pid+newtoniteration', 'iterationcount', 'newtoniterationcount' and 'hardcoded'");
+                                 "The algorithm used to determine time-step sizes. valid options are: 'pid' (default), 'pid+iteration', 'pid+newtoniteration', 'history', 'iterationcount', 'newtoniterationcount' and 'hardcoded'");
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepControlTolerance,
                                  "The tolerance used by the time step size control algorithm");
             EWOMS_REGISTER_PARAM(TypeTag, int, TimeStepControlTargetIterations,
                                  "The number of linear iterations which the time step control scheme should aim for (if applicable)");
             EWOMS_REGISTER_PARAM(TypeTag, int, TimeStepControlTargetNewtonIterations,
                                  "The number of Newton iterations which the time step control scheme should aim for (if applicable)");
+            EWOMS_REGISTER_PARAM(TypeTag, int, TimeStepControlHistoryLength,
+                                 "The number of previous substeps which the 'history' time step control takes into account");
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepControlDecayRate,
                                  "The decay rate of the time step size of the number of target iterations is exceeded");
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepControlGrowthRate,
@@ -404,6 +414,8 @@ namespace Opm {
 
                 SimulatorReportSingle substepReport;
                 std::string causeOfFailure = "";
+                time::StopWatch substepWatch;
+                substepWatch.start();
                 try {
                     substepReport = solver.step(substepTimer);
                     if (solverVerbose_) {
@@ -451,6 +463,13 @@ namespace Opm {
                     // this can be thrown by ISTL's ILU0 in block mode, yet is not an ISTLError
                 }
 
+                timeStepControl_->recordSubStep(substepReport.total_newton_iterations,
+                                                substepReport.total_linear_iterations,
+                                                substepReport.converged);
+                if (!substepReport.converged) {
+                    // all the work of a failed substep is repeated with a shorter step
+                    substepReport.wasted_time = substepWatch.secsSinceStart();
+                }
                 report += substepReport;
 
                 if (substepReport.converged) {
@@ -553,6 +572,8 @@ namespace Opm {
                             OpmLog::problem(msg);
                         }
                         ++restarts;
+                        ++report.failure.time_step_chops;
+                        ebosProblem.convergenceHotspots().recordChop();
                     };
 
                     const double minimumChoppedTimestep = minTimeStepBeforeShuttingProblematicWells_;
@@ -659,6 +680,19 @@ namespace Opm {
                                                                       growthDampingFactor, tol, minTimeStepReducedByIterations));
                 useNewtonIteration_ = true;
             }
+            else if (control == "history") {
+                const int iterations =  EWOMS_GET_PARAM(TypeTag, int, TimeStepControlTargetNewtonIterations); // 8
+                const int linearIterations =  EWOMS_GET_PARAM(TypeTag, int, TimeStepControlTargetIterations); // 30
+                const int historyLength =  EWOMS_GET_PARAM(TypeTag, int, TimeStepControlHistoryLength); // 5
+                const double decayDampingFactor = EWOMS_GET_PARAM(TypeTag, double, TimeStepControlDecayDampingFactor); // 1.0
+                const double growthDampingFactor = EWOMS_GET_PARAM(TypeTag, double, TimeStepControlGrowthDampingFactor); // 3.2
+                const double nonDimensionalMinTimeStepIterations = EWOMS_GET_PARAM(TypeTag, double, MinTimeStepBasedOnNewtonIterations); // 0.0 by default
+                double minTimeStepReducedByIterations = unitSystem.to_si(UnitSystem::measure::time, nonDimensionalMinTimeStepIterations);
+                timeStepControl_ = TimeStepControlType(new HistoryTimeStepControl(iterations, linearIterations, historyLength,
+                                                                                  decayDampingFactor, growthDampingFactor,
+                                                                                  tol, minTimeStepReducedByIterations));
+                useNewtonIteration_ = true;
+            }
             else if (control == "iterationcount") {
                 const int iterations =  EWOMS_GET_PARAM(TypeTag, int, TimeStepControlTargetIterations); // 30
                 const double decayrate = EWOMS_GET_PARAM(TypeTag, double, TimeStepControlDecayRate); // 0.75
@@ -0,0 +1,186 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/timestepping/LoadBalanceReport.hpp>
+#include <opm/parser/eclipse/Units/Units.hpp>
+
+#include <algorithm>
+#include <ostream>
+#include <fmt/format.h>
+
+namespace
+{
+
+    using Opm::LoadBalanceReport;
+
+    void localValues(const Opm::SimulatorReportSingle& sr,
+                     const std::size_t cells,
+                     const std::size_t wells,
+                     double* values)
+    {
+        values[LoadBalanceReport::Cells] = cells;
+        values[LoadBalanceReport::Wells] = wells;
+        values[LoadBalanceReport::SolverTime] = sr.solver_time;
+        values[LoadBalanceReport::AssemblyTime] = sr.assemble_time;
+        values[LoadBalanceReport::WellAssemblyTime] = sr.assemble_time_well;
+        values[LoadBalanceReport::LinearSetupTime] = sr.linear_solve_setup_time;
+        values[LoadBalanceReport::LinearSolveTime] = sr.linear_solve_time;
+        values[LoadBalanceReport::UpdateTime] = sr.update_time;
+        values[LoadBalanceReport::PrePostTime] = sr.pre_post_time;
+        values[LoadBalanceReport::OutputWriteTime] = sr.output_write_time;
+        values[LoadBalanceReport::WellIterations] = sr.total_well_iterations;
+        values[LoadBalanceReport::IntensiveQuantities] = sr.intensive_quantities_computed;
+    }
+
+    bool isCount(const LoadBalanceReport::Category category)
+    {
+        return category == LoadBalanceReport::Cells
+            || category == LoadBalanceReport::Wells
+            || category == LoadBalanceReport::WellIterations
+            || category == LoadBalanceReport::IntensiveQuantities;
+    }
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+    LoadBalanceReport::LoadBalanceReport(const SimulatorReport& localReport,
+                                         const std::size_t localCells,
+                                         const std::size_t localWells,
+                                         const bool perStep,
+                                         const Communication& comm)
+        : numProcesses_(comm.size())
+    {
+        // the number of report steps is the same on all processes
+        const std::size_t numSteps = perStep ? localReport.stepreports.size() : 0;
+        const std::size_t numValues = NumCategories * (1 + numSteps);
+
+        SimulatorReportSingle all = localReport.success;
+        all += localReport.failure;
+        std::vector<double> local(numValues);
+        localValues(all, localCells, localWells, local.data());
+        for (std::size_t step = 0; step < numSteps; ++step) {
+            localValues(localReport.stepreports[step], localCells, localWells,
+                        local.data() + NumCategories * (1 + step));
+        }
+
+        std::vector<double> global(comm.rank() == 0 ? numValues * numProcesses_ : 0);
+        comm.gather(local.data(), global.data(), numValues, 0);
+        if (comm.rank() != 0) {
+            return;
+        }
+
+        std::vector<double> perProcess(numProcesses_);
+        auto collect = [&](const std::size_t offset, CategoryStatistics& stats)
+        {
+            for (int c = 0; c < NumCategories; ++c) {
+                for (int rank = 0; rank < numProcesses_; ++rank) {
+                    perProcess[rank] = global[rank * numValues + offset + c];
+                }
+                stats[c] = statistics(perProcess);
+            }
+        };
+        collect(0, total_);
+        steps_.resize(numSteps);
+        stepTimes_.resize(numSteps);
+        for (std::size_t step = 0; step < numSteps; ++step) {
+            collect(NumCategories * (1 + step), steps_[step]);
+            stepTimes_[step] = localReport.stepreports[step].global_time;
+        }
+    }
+
+    LoadBalanceReport::Statistics LoadBalanceReport::statistics(const std::vector<double>& perProcess)
+    {
+        Statistics stats;
+        if (perProcess.empty()) {
+            return stats;
+        }
+        const auto [minIt, maxIt] = std::minmax_element(perProcess.begin(), perProcess.end());
+        stats.min = *minIt;
+        stats.max = *maxIt;
+        stats.maxRank = maxIt - perProcess.begin();
+        for (const double value : perProcess) {
+            stats.mean += value;
+        }
+        stats.mean /= perProcess.size();
+        return stats;
+    }
+
+    const char* LoadBalanceReport::name(const Category category)
+    {
+        switch (category) {
+        case Cells: return "Interior cells";
+        case Wells: return "Open wells";
+        case SolverTime: return "Solver time";
+        case AssemblyTime: return " Assembly time";
+        case WellAssemblyTime: return "   Well assembly";
+        case LinearSetupTime: return " Linear setup";
+        case LinearSolveTime: return " Linear solve time";
+        case UpdateTime: return " Update time";
+        case PrePostTime: return " Pre/post step";
+        case OutputWriteTime: return " Output write time";
+        case WellIterations: return "Well iterations";
+        case IntensiveQuantities: return "Int. quantities computed";
+        case NumCategories: break;
+        }
+        return "";
+    }
+
+    void LoadBalanceReport::report(std::ostream& os) const
+    {
+        os << fmt::format("Load balance over {} processes (times in seconds):\n", numProcesses_);
+        os << fmt::format("{:<28}{:>11}  {:>11}  {:>11}  {:>8}  (rank of max)\n",
+                          "", "min", "mean", "max", "max/mean");
+        for (int c = 0; c < NumCategories; ++c) {
+            const auto category = static_cast<Category>(c);
+            const auto& stats = total_[c];
+            if (isCount(category)) {
+                os << fmt::format("{:<28}{:11.0f}  {:11.1f}  {:11.0f}  {:8.2f}  ({})\n",
+                                  name(category), stats.min, stats.mean, stats.max,
+                                  stats.imbalance(), stats.maxRank);
+            } else {
+                os << fmt::format("{:<28}{:11.2f}  {:11.2f}  {:11.2f}  {:8.2f}  ({})\n",
+                                  name(category), stats.min, stats.mean, stats.max,
+                                  stats.imbalance(), stats.maxRank);
+            }
+        }
+    }
+
+    void LoadBalanceReport::reportSteps(std::ostream& os) const
+    {
+        const Category timings[] = { AssemblyTime, WellAssemblyTime, LinearSetupTime, LinearSolveTime, UpdateTime };
+        os << "  Time(day)";
+        for (const auto category : { "Assembly", "WellAssembly", "LSetup", "LSolve", "Update" }) {
+            os << fmt::format("  {:>12} max/mean rank", category);
+        }
+        os << '\n';
+        for (std::size_t step = 0; step < steps_.size(); ++step) {
+            os << fmt::format("{:11.3f}", unit::convert::to(stepTimes_[step], unit::day));
+            for (const auto category : timings) {
+                const auto& stats = steps_[step][category];
+                os << fmt::format("  {:12.4f} {:8.2f} {:4}", stats.mean, stats.imbalance(), stats.maxRank);
+            }
+            os << '\n';
+        }
+    }
+
+} // namespace Opm
@@ -0,0 +1,114 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LOADBALANCEREPORT_HEADER_INCLUDED
+#define OPM_LOADBALANCEREPORT_HEADER_INCLUDED
+
+#include <opm/simulators/timestepping/SimulatorReport.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <array>
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace Opm
+{
+
+    /// The distribution over the processes of the timings of the simulator
+    /// reports and of the local work, to see whether the partitioning balances
+    /// the load.
+    class LoadBalanceReport
+    {
+    public:
+        using Communication = Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>;
+
+        enum Category {
+            Cells,
+            Wells,
+            SolverTime,
+            AssemblyTime,
+            WellAssemblyTime,
+            LinearSetupTime,
+            LinearSolveTime,
+            UpdateTime,
+            PrePostTime,
+            OutputWriteTime,
+            WellIterations,
+            IntensiveQuantities,
+            NumCategories
+        };
+
+        struct Statistics
+        {
+            double min = 0.0;
+            double mean = 0.0;
+            double max = 0.0;
+            int maxRank = 0;
+
+            /// The maximum over the mean, 1 if the load is balanced.
+            double imbalance() const
+            { return mean > 0.0 ? max / mean : 1.0; }
+        };
+
+        /// Collect the reports of all processes, the numbers of interior cells
+        /// and of open wells of this process. The failed substeps are included.
+        /// This is collective, the statistics are available on rank 0 only.
+        /// \param perStep Whether to collect the statistics of each report step too.
+        LoadBalanceReport(const SimulatorReport& localReport,
+                          std::size_t localCells,
+                          std::size_t localWells,
+                          bool perStep,
+                          const Communication& comm);
+
+        static Statistics statistics(const std::vector<double>& perProcess);
+
+        static const char* name(Category category);
+
+        int numProcesses() const
+        { return numProcesses_; }
+
+        const Statistics& total(Category category) const
+        { return total_[category]; }
+
+        std::size_t numSteps() const
+        { return steps_.size(); }
+
+        const Statistics& step(std::size_t step, Category category) const
+        { return steps_[step][category]; }
+
+        /// Print the statistics of the whole run.
+        void report(std::ostream& os) const;
+
+        /// Print the mean and the imbalance of the timings of each report step.
+        void reportSteps(std::ostream& os) const;
+
+    private:
+        using CategoryStatistics = std::array<Statistics, NumCategories>;
+
+        int numProcesses_;
+        CategoryStatistics total_;
+        std::vector<CategoryStatistics> steps_;
+        std::vector<double> stepTimes_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_LOADBALANCEREPORT_HEADER_INCLUDED
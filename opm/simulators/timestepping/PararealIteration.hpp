@@ -0,0 +1,174 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PARAREAL_ITERATION_HEADER_INCLUDED
+#define OPM_PARAREAL_ITERATION_HEADER_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// The parareal iteration, which computes the states at the ends of a number
+/// of time windows, e.g. groups of report steps, with the fine propagations
+/// of the windows running at the same time.
+///
+/// The coarse propagator G, e.g. large time steps with loose tolerances,
+/// marches through the windows sequentially. In every iteration the fine
+/// propagator F is applied to the start states of all windows independently,
+/// and the states are corrected sequentially by
+///
+///     U[n+1] = G(U[n]) + F(U_old[n]) - G(U_old[n]).
+///
+/// After k iterations the first k windows agree with the sequential fine
+/// propagation, the iteration stops earlier once the states change less
+/// than the tolerance. The fine propagations of an iteration are started by
+/// the fineAll callback, which runs them where it likes, e.g. on separate
+/// groups of processes, by default they run one after the other.
+template <class State>
+class PararealIteration
+{
+public:
+    /// The state at the end of a window from the state at its start.
+    using Propagator = std::function<State(const State& start, int window)>;
+    /// The fine states at the ends of the windows from firstWindow on from their start states.
+    using MultiPropagator = std::function<std::vector<State>(const std::vector<State>& starts, int firstWindow)>;
+    /// coarseNew + fine - coarseOld
+    using Correction = std::function<State(const State& coarseNew, const State& fine, const State& coarseOld)>;
+    /// The distance between two states, compared to the tolerance.
+    using Distance = std::function<double(const State& a, const State& b)>;
+
+    PararealIteration(Propagator coarse, Propagator fine, Correction correct, Distance distance)
+        : coarse_(std::move(coarse))
+        , correct_(std::move(correct))
+        , distance_(std::move(distance))
+    {
+        fineAll_ = [fine = std::move(fine)](const std::vector<State>& starts, const int firstWindow)
+        {
+            std::vector<State> ends;
+            ends.reserve(starts.size());
+            for (std::size_t n = 0; n < starts.size(); ++n) {
+                ends.push_back(fine(starts[n], firstWindow + static_cast<int>(n)));
+            }
+            return ends;
+        };
+    }
+
+    /// Run the fine propagations of an iteration with fineAll instead.
+    void setFinePropagation(MultiPropagator fineAll)
+    { fineAll_ = std::move(fineAll); }
+
+    /// The states at the ends of the windows.
+    /// \param initial        the state at the start of the first window
+    /// \param numWindows     the number of windows
+    /// \param maxIterations  the maximum number of iterations, at most numWindows are useful
+    /// \param tolerance      the maximum distance of the states of two iterations at convergence
+    std::vector<State> run(const State& initial, const int numWindows,
+                           const int maxIterations, const double tolerance)
+    {
+        if (numWindows < 1) {
+            throw std::invalid_argument("The parareal iteration needs at least one window");
+        }
+
+        // U[n] is the state at the start of window n, U[numWindows] the final one
+        std::vector<State> U;
+        std::vector<State> coarseEnds;
+        U.reserve(numWindows + 1);
+        coarseEnds.reserve(numWindows);
+        U.push_back(initial);
+        for (int n = 0; n < numWindows; ++n) {
+            coarseEnds.push_back(coarse_(U[n], n));
+            U.push_back(coarseEnds.back());
+        }
+
+        iterations_ = 0;
+        lastChange_ = 0.0;
+        const int iterations = std::min(maxIterations, numWindows);
+        for (int k = 0; k < iterations; ++k) {
+            // the windows before k are exact already, so are their fine propagations
+            const std::vector<State> starts(U.begin() + k, U.end() - 1);
+            const std::vector<State> fineEnds = fineAll_(starts, k);
+
+            // the state at the start of window k + 1 is the exact one now
+            lastChange_ = distance_(fineEnds[0], U[k + 1]);
+            U[k + 1] = fineEnds[0];
+            for (int n = k + 1; n < numWindows; ++n) {
+                State coarseNew = coarse_(U[n], n);
+                State updated = correct_(coarseNew, fineEnds[n - k], coarseEnds[n]);
+                lastChange_ = std::max(lastChange_, distance_(updated, U[n + 1]));
+                coarseEnds[n] = std::move(coarseNew);
+                U[n + 1] = std::move(updated);
+            }
+            ++iterations_;
+            if (lastChange_ <= tolerance) {
+                break;
+            }
+        }
+
+        return std::vector<State>(U.begin() + 1, U.end());
+    }
+
+    /// The number of iterations of the last run.
+    int iterations() const
+    { return iterations_; }
+
+    /// The largest change of a state in the last iteration of the last run.
+    double lastChange() const
+    { return lastChange_; }
+
+    /// The correction for states stored as vectors of values.
+    static std::vector<double> correctVector(const std::vector<double>& coarseNew,
+                                             const std::vector<double>& fine,
+                                             const std::vector<double>& coarseOld)
+    {
+        std::vector<double> result(coarseNew.size());
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            result[i] = coarseNew[i] + fine[i] - coarseOld[i];
+        }
+        return result;
+    }
+
+    /// The largest difference of the values of two states stored as vectors.
+    static double maxDistance(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        double result = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            result = std::max(result, std::abs(a[i] - b[i]));
+        }
+        return result;
+    }
+
+private:
+    Propagator coarse_;
+    MultiPropagator fineAll_;
+    Correction correct_;
+    Distance distance_;
+    int iterations_ = 0;
+    double lastChange_ = 0.0;
+};
+
+} // namespace Opm
+
+#endif // OPM_PARAREAL_ITERATION_HEADER_INCLUDED
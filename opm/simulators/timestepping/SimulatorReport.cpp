@@ -23,6 +23,7 @@
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 
+#include <algorithm>
 #include <iomanip>
 #include <ostream>
 #include <sstream>
@@ -42,10 +43,15 @@ namespace Opm
           linear_solve_time(0.0),
           update_time(0.0),
           output_write_time(0.0),
+          wasted_time(0.0),
           total_well_iterations(0),
           total_linearizations( 0 ),
           total_newton_iterations( 0 ),
           total_linear_iterations( 0 ),
+          max_output_queue_depth( 0 ),
+          intensive_quantities_computed( 0 ),
+          intensive_quantities_reused( 0 ),
+          time_step_chops( 0 ),
           converged(false),
           exit_status(EXIT_SUCCESS),
           global_time(0),
@@ -65,11 +71,16 @@ namespace Opm
         assemble_time_well += sr.assemble_time_well;
         update_time += sr.update_time;
         output_write_time += sr.output_write_time;
+        wasted_time += sr.wasted_time;
         total_time += sr.total_time;
         total_well_iterations += sr.total_well_iterations;
         total_linearizations += sr.total_linearizations;
         total_newton_iterations += sr.total_newton_iterations;
         total_linear_iterations += sr.total_linear_iterations;
+        max_output_queue_depth = std::max(max_output_queue_depth, sr.max_output_queue_depth);
+        intensive_quantities_computed += sr.intensive_quantities_computed;
+        intensive_quantities_reused += sr.intensive_quantities_reused;
+        time_step_chops += sr.time_step_chops;
         // It makes no sense adding time points. Therefore, do not 
         // overwrite the value of global_time which gets set in 
         // NonlinearSolverEbos.hpp by the line:
@@ -136,6 +147,15 @@ namespace Opm
             }
             os << std::endl;
 
+            if (pressure_time > 0.0 || transport_time > 0.0) {
+                os << fmt::format("   Pressure solves (seconds): {:7.2f}",
+                                  pressure_time + (failureReport ? failureReport->pressure_time : 0.0));
+                os << std::endl;
+                os << fmt::format("   Transport sweeps (seconds):{:7.2f}",
+                                  transport_time + (failureReport ? failureReport->transport_time : 0.0));
+                os << std::endl;
+            }
+
             t = update_time + (failureReport ? failureReport->update_time : 0.0);
             os << fmt::format(" Update time (seconds):       {:7.2f}", t);
             if (failureReport) {
@@ -144,6 +164,11 @@ namespace Opm
                                 100*failureReport->update_time/t);
             }
             os << std::endl;
+            if (intensive_quantities_reused > 0) {
+                const double n = intensive_quantities_reused + intensive_quantities_computed;
+                os << fmt::format("   Int. quantities reused:    {:6.1f}%", 100.0*intensive_quantities_reused/n);
+                os << std::endl;
+            }
             t = pre_post_time + (failureReport ? failureReport->pre_post_time : 0.0);
             os << fmt::format(" Pre/post step (seconds):     {:7.2f}", t);
             if (failureReport) {
@@ -156,6 +181,10 @@ namespace Opm
             os << fmt::format(" Output write time (seconds): {:7.2f}", 
                               output_write_time + (failureReport ? failureReport->output_write_time : 0.0));
             os << std::endl;
+            if (max_output_queue_depth > 0) {
+                os << fmt::format("   Output queue depth (max):  {:7}", max_output_queue_depth);
+                os << std::endl;
+            }
 
         }
 
@@ -185,6 +214,29 @@ namespace Opm
                             100.0*failureReport->total_linear_iterations/n);
         }
         os << std::endl;
+
+        if (failureReport && failureReport->time_step_chops > 0) {
+            os << fmt::format("Time step chops:           {:7}    (Wasted time: {:2.1f} sec; {:2.1f}%)",
+                              failureReport->time_step_chops,
+                              failureReport->wasted_time,
+                              total_time > 0.0 ? 100.0*failureReport->wasted_time/total_time : 0.0);
+            os << std::endl;
+        }
+    }
+
+    void SimulatorReportSingle::reportJson(std::ostream& os) const
+    {
+        os << fmt::format("{{\"total_time\": {}, \"solver_time\": {}, \"assemble_time\": {}, "
+                          "\"assemble_time_well\": {}, \"linear_solve_setup_time\": {}, "
+                          "\"linear_solve_time\": {}, \"update_time\": {}, \"pre_post_time\": {}, "
+                          "\"output_write_time\": {}, ",
+                          total_time, solver_time, assemble_time, assemble_time_well,
+                          linear_solve_setup_time, linear_solve_time, update_time,
+                          pre_post_time, output_write_time);
+        os << fmt::format("\"well_iterations\": {}, \"linearizations\": {}, \"newton_iterations\": {}, "
+                          "\"linear_iterations\": {}, \"time_step_chops\": {}}}",
+                          total_well_iterations, total_linearizations, total_newton_iterations,
+                          total_linear_iterations, time_step_chops);
     }
 
     void SimulatorReport::operator+=(const SimulatorReportSingle& sr)
@@ -209,6 +261,15 @@ namespace Opm
         success.reportFullyImplicit(os, &failure);
     }
 
+    void SimulatorReport::reportJson(std::ostream& os) const
+    {
+        os << "{\"steps\": " << stepreports.size() << ", \"success\": ";
+        success.reportJson(os);
+        os << ", \"failure\": ";
+        failure.reportJson(os);
+        os << '}';
+    }
+
     void SimulatorReport::fullReports(std::ostream& os) const
     {
         os << "  Time(day)  TStep(day)  Assembly    LSetup    LSolve    Update    Output WellIt Lins NewtIt LinIt Conv\n";
@@ -40,11 +40,16 @@ namespace Opm
         double linear_solve_time;
         double update_time;
         double output_write_time;
+        double wasted_time; // wall time of failed substeps
 
         unsigned int total_well_iterations;
         unsigned int total_linearizations;
         unsigned int total_newton_iterations;
         unsigned int total_linear_iterations;
+        unsigned int max_output_queue_depth;
+        unsigned long intensive_quantities_computed;
+        unsigned long intensive_quantities_reused;
+        unsigned int time_step_chops;
 
         bool converged;
         int exit_status;
@@ -60,6 +65,8 @@ namespace Opm
         void reportStep(std::ostringstream& os) const;
         /// Print a report suitable for the end of a fully implicit case, leaving out the pressure/transport time.
         void reportFullyImplicit(std::ostream& os, const SimulatorReportSingle* failedReport = nullptr) const;
+        /// Print the times and the iteration counts as the members of a JSON object.
+        void reportJson(std::ostream& os) const;
     };
 
     struct SimulatorReport
@@ -72,6 +79,8 @@ namespace Opm
         void operator+=(const SimulatorReport& sr);
         void reportFullyImplicit(std::ostream& os) const;
         void fullReports(std::ostream& os) const;
+        /// Print the totals of the converged and of the failed substeps as a JSON object.
+        void reportJson(std::ostream& os) const;
     };
 
     } // namespace Opm
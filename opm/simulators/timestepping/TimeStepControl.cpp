@@ -19,6 +19,7 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <config.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -206,4 +207,84 @@ namespace Opm
         return std::min(dtEstimatePID, dtEstimateIter);
     }
 
+
+
+    ////////////////////////////////////////////////////////////
+    //
+    //  HistoryTimeStepControl  Implementation
+    //
+    ////////////////////////////////////////////////////////////
+
+    HistoryTimeStepControl::
+    HistoryTimeStepControl( const int target_iterations,
+                            const int target_linear_iterations,
+                            const int history_length,
+                            const double decayDampingFactor,
+                            const double growthDampingFactor,
+                            const double tol,
+                            const double minTimeStepBasedOnIterations,
+                            const bool verbose)
+        : PIDAndIterationCountTimeStepControl( target_iterations, decayDampingFactor, growthDampingFactor,
+                                               tol, minTimeStepBasedOnIterations, verbose )
+        , target_linear_iterations_( target_linear_iterations )
+        , history_length_( std::max(history_length, 1) )
+    {
+        if( target_iterations <= 0 || target_linear_iterations_ <= 0 ) {
+            OPM_THROW(std::runtime_error,"HistoryTimeStepControl: the target iterations should be positive");
+        }
+    }
+
+    void HistoryTimeStepControl::
+    recordSubStep( const int newtonIterations, const int linearIterations, const bool converged )
+    {
+        history_.push_back({newtonIterations, linearIterations, converged});
+        if (history_.size() > history_length_) {
+            history_.pop_front();
+        }
+    }
+
+    double HistoryTimeStepControl::
+    failureRisk() const
+    {
+        double newtonRatio = 0.0;
+        double linearRatio = 0.0;
+        double weights = 0.0;
+        double weight = 0.0;
+        for (const auto& step : history_) {
+            weight += 1.0;
+            if (!step.converged) {
+                continue;
+            }
+            newtonRatio += weight * step.newton_iterations / target_iterations_;
+            linearRatio += weight * step.linear_iterations / target_linear_iterations_;
+            weights += weight;
+        }
+        if (weights == 0.0) {
+            return 0.0;
+        }
+        return std::max(newtonRatio, linearRatio) / weights;
+    }
+
+    double HistoryTimeStepControl::
+    computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relChange,  const double simulationTimeElapsed ) const
+    {
+        double dtEstimate = BaseType :: computeTimeStepSize( dt, iterations, relChange, simulationTimeElapsed);
+
+        // a chop is expensive, do not increase the step size again while it is recent
+        const bool recentChop = std::any_of(history_.begin(), history_.end(),
+                                            [](const SubStep& step) { return !step.converged; });
+        if (recentChop) {
+            dtEstimate = std::min(dtEstimate, dt);
+        }
+
+        const double risk = failureRisk();
+        if (risk > 1.0) {
+            dtEstimate = std::min(dtEstimate, std::max(dt / risk, minTimeStepBasedOnIterations_));
+        }
+        if( verbose_ )
+            std::cout << "Computed step size (history): " << unit::convert::to( dtEstimate, unit::day ) << " (days), failure risk " << risk << std::endl;
+
+        return dtEstimate;
+    }
+
 } // end namespace Opm
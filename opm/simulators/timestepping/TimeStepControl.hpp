@@ -21,6 +21,8 @@
 #ifndef OPM_TIMESTEPCONTROL_HEADER_INCLUDED
 #define OPM_TIMESTEPCONTROL_HEADER_INCLUDED
 
+#include <cstddef>
+#include <deque>
 #include <vector>
 
 #include <boost/range/iterator_range.hpp>
@@ -122,6 +124,58 @@ namespace Opm
         const double  minTimeStepBasedOnIterations_;
     };
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///  PID and Newton iteration count based time step control as above that also
+    ///  takes the history of the last substeps into account. The Newton and linear
+    ///  iterations of the recent converged substeps estimate the risk that the next
+    ///  step fails, which limits the step size, and the step size is not increased
+    ///  while a chopped substep is part of the history.
+    //
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    class HistoryTimeStepControl : public PIDAndIterationCountTimeStepControl
+    {
+        typedef PIDAndIterationCountTimeStepControl BaseType;
+    public:
+        /// \brief constructor
+        /// \param target_iterations         number of desired Newton iterations per time step
+        /// \param target_linear_iterations  number of desired linear iterations per time step
+        /// \param history_length            number of substeps which are taken into account
+        /// \param tol        tolerance for the relative changes of the numerical solution to be accepted
+        ///                   in one time step (default is 1e-3)
+        /// \param verbose    if true get some output (default = false)
+        HistoryTimeStepControl( const int target_iterations = 8,
+                                const int target_linear_iterations = 30,
+                                const int history_length = 5,
+                                const double decayDampingFactor = 1.0,
+                                const double growthDampingFactor = 1.0/1.2,
+                                const double tol = 1e-3,
+                                const double minTimeStepBasedOnIterations = 0.,
+                                const bool verbose = false);
+
+        /// \brief \copydoc TimeStepControlInterface::computeTimeStepSize
+        double computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relativeChange, const double simulationTimeElapsed ) const;
+
+        /// \brief \copydoc TimeStepControlInterface::recordSubStep
+        void recordSubStep( const int newtonIterations, const int linearIterations, const bool converged );
+
+        /// The ratio of the recent iteration counts to their targets, weighing the
+        /// later substeps more. Values above one indicate a step size at risk of failing.
+        double failureRisk() const;
+
+    protected:
+        struct SubStep
+        {
+            int newton_iterations;
+            int linear_iterations;
+            bool converged;
+        };
+
+        const int target_linear_iterations_;
+        const std::size_t history_length_;
+        std::deque<SubStep> history_;
+    };
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///  HardcodedTimeStepControl
@@ -58,6 +58,13 @@ namespace Opm
         /// \return suggested time step size for the next step
         virtual double computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relativeChange , const double simulationTimeElapsed) const = 0;
 
+        /// record the outcome of a substep, for controls which take the history of
+        /// the previous substeps into account (default: ignored)
+        /// \param newtonIterations  number of Newton iterations of the substep
+        /// \param linearIterations  number of linear iterations of the substep
+        /// \param converged         false if the substep failed and is chopped
+        virtual void recordSubStep( const int /* newtonIterations */, const int /* linearIterations */, const bool /* converged */ ) {}
+
         /// virtual destructor (empty)
         virtual ~TimeStepControlInterface () {}
     };
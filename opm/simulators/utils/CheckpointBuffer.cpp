@@ -0,0 +1,212 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/utils/CheckpointBuffer.hpp>
+
+#include <opm/common/utility/FileSystem.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OPM_CHECKPOINT_BUFFER_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define OPM_CHECKPOINT_BUFFER_MMAP 0
+#endif
+
+namespace
+{
+
+// Write to a temporary file first, such that an existing file is only
+// replaced once the new one is complete.
+template <class WriteFunc>
+void saveAtomically(const std::string& fileName, WriteFunc&& writeFunc)
+{
+    const std::string tmpName = fileName + ".tmp";
+    {
+        std::ofstream os(tmpName, std::ios::binary | std::ios::trunc);
+        if (!os) {
+            throw std::runtime_error("Cannot open checkpoint file " + tmpName + " for writing");
+        }
+        writeFunc(os);
+        os.flush();
+        if (!os) {
+            throw std::runtime_error("Failed to write checkpoint file " + tmpName);
+        }
+    }
+    Opm::filesystem::rename(tmpName, fileName);
+}
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+void CheckpointBuffer::write(const std::string& value)
+{
+    write(value.size());
+    writeBytes_(value.data(), value.size());
+}
+
+void CheckpointBuffer::read(std::string& value)
+{
+    std::size_t size = 0;
+    read(size);
+    value.resize(size);
+    readBytes_(value.data(), size);
+}
+
+void CheckpointBuffer::writeBytes_(const void* bytes, std::size_t count)
+{
+    if (mapped_) {
+        throw std::logic_error("Cannot write to a memory mapped checkpoint");
+    }
+    const char* begin = static_cast<const char*>(bytes);
+    data_.insert(data_.end(), begin, begin + count);
+}
+
+void CheckpointBuffer::readBytes_(void* bytes, std::size_t count)
+{
+    if (count > size() - pos_) {
+        throw std::runtime_error("Checkpoint is truncated or was written by another version");
+    }
+    if (count > 0) {
+        std::memcpy(bytes, begin_() + pos_, count);
+    }
+    pos_ += count;
+}
+
+void CheckpointBuffer::save(const std::string& fileName) const
+{
+    saveAtomically(fileName, [this](std::ofstream& os)
+    {
+        os.write(begin_(), size());
+    });
+}
+
+CheckpointBuffer CheckpointBuffer::load(const std::string& fileName, const bool mapFile)
+{
+#if OPM_CHECKPOINT_BUFFER_MMAP
+    if (mapFile) {
+        CheckpointBuffer buffer;
+        const int fd = ::open(fileName.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd >= 0 && ::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                const std::size_t size = st.st_size;
+                buffer.mapped_ = std::shared_ptr<const char>(static_cast<const char*>(addr),
+                                                             [size](const char* ptr)
+                                                             { ::munmap(const_cast<char*>(ptr), size); });
+                buffer.mappedSize_ = size;
+            }
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        if (buffer.mapped_) {
+            return buffer;
+        }
+    }
+#else
+    static_cast<void>(mapFile);
+#endif
+
+    std::ifstream is(fileName, std::ios::binary | std::ios::ate);
+    if (!is) {
+        throw std::runtime_error("Cannot open checkpoint file " + fileName);
+    }
+
+    CheckpointBuffer buffer;
+    buffer.data_.resize(is.tellg());
+    is.seekg(0);
+    is.read(buffer.data_.data(), buffer.data_.size());
+    if (!is) {
+        throw std::runtime_error("Failed to read checkpoint file " + fileName);
+    }
+    return buffer;
+}
+
+void CheckpointManifest::save(const std::string& fileName) const
+{
+    saveAtomically(fileName, [this](std::ofstream& os)
+    {
+        os << "version " << version << '\n'
+           << "case " << caseName << '\n'
+           << "processes " << processes << '\n'
+           << "report_step " << reportStep << '\n'
+           << "time " << std::setprecision(17) << time << '\n';
+    });
+}
+
+CheckpointManifest CheckpointManifest::load(const std::string& fileName)
+{
+    std::ifstream is(fileName);
+    if (!is) {
+        throw std::runtime_error("Cannot open checkpoint manifest " + fileName);
+    }
+
+    CheckpointManifest manifest;
+    bool hasVersion = false;
+    bool hasReportStep = false;
+    std::string line;
+    while (std::getline(is, line)) {
+        std::istringstream ls(line);
+        std::string key;
+        if (!(ls >> key)) {
+            continue;
+        }
+        if (key == "version") {
+            ls >> manifest.version;
+            hasVersion = true;
+        }
+        else if (key == "case") {
+            ls >> std::ws;
+            std::getline(ls, manifest.caseName);
+            continue;
+        }
+        else if (key == "processes") {
+            ls >> manifest.processes;
+        }
+        else if (key == "report_step") {
+            ls >> manifest.reportStep;
+            hasReportStep = true;
+        }
+        else if (key == "time") {
+            ls >> manifest.time;
+        }
+        if (ls.fail()) {
+            throw std::runtime_error("Invalid line '" + line + "' in checkpoint manifest " + fileName);
+        }
+    }
+    if (!hasVersion || !hasReportStep) {
+        throw std::runtime_error("Incomplete checkpoint manifest " + fileName);
+    }
+    return manifest;
+}
+
+} // namespace Opm
@@ -0,0 +1,138 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CHECKPOINT_BUFFER_HEADER_INCLUDED
+#define OPM_CHECKPOINT_BUFFER_HEADER_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Opm
+{
+
+/// Binary buffer of the rank local checkpoints of the simulator.
+///
+/// The values are stored in the native representation of the machine, a
+/// checkpoint can therefore only be read on the kind of machine which wrote
+/// it. write() and read() have the interface of the message buffers of the
+/// parallel communication, such that data::Wells and the other output
+/// structures can be stored with their own write() and read() methods.
+///
+/// Loaded files are memory mapped where possible, such that the runs which
+/// start from the same checkpoint on a node share its pages. Nothing can be
+/// written to a mapped buffer.
+class CheckpointBuffer
+{
+public:
+    template <class T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Only trivially copyable values can be written to a checkpoint");
+        writeBytes_(&value, sizeof(T));
+    }
+
+    void write(const std::string& value);
+
+    template <class T, class Allocator>
+    void write(const std::vector<T, Allocator>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Only vectors of trivially copyable values can be written to a checkpoint");
+        write(values.size());
+        writeBytes_(values.data(), values.size() * sizeof(T));
+    }
+
+    template <class T>
+    void read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Only trivially copyable values can be read from a checkpoint");
+        readBytes_(&value, sizeof(T));
+    }
+
+    void read(std::string& value);
+
+    template <class T, class Allocator>
+    void read(std::vector<T, Allocator>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Only vectors of trivially copyable values can be read from a checkpoint");
+        std::size_t size = 0;
+        read(size);
+        values.resize(size);
+        readBytes_(values.data(), size * sizeof(T));
+    }
+
+    /// Number of bytes in the buffer.
+    std::size_t size() const
+    { return mapped_ ? mappedSize_ : data_.size(); }
+
+    /// Whether all values have been read.
+    bool atEnd() const
+    { return pos_ == size(); }
+
+    /// Whether the buffer is a memory mapped file.
+    bool isMapped() const
+    { return mapped_ != nullptr; }
+
+    /// Write the buffer to a file. The file is written under a temporary name
+    /// and renamed afterwards, such that a failure does not leave a partially
+    /// written file behind.
+    void save(const std::string& fileName) const;
+
+    /// Read a buffer written by save(), reading starts at its beginning.
+    /// The file is mapped into memory if mapFile is set and the platform
+    /// supports it, otherwise it is read.
+    static CheckpointBuffer load(const std::string& fileName, bool mapFile = true);
+
+private:
+    void writeBytes_(const void* bytes, std::size_t count);
+    void readBytes_(void* bytes, std::size_t count);
+
+    const char* begin_() const
+    { return mapped_ ? mapped_.get() : data_.data(); }
+
+    std::vector<char> data_;
+    // unmapped when the last copy of the buffer is destroyed
+    std::shared_ptr<const char> mapped_;
+    std::size_t mappedSize_ = 0;
+    std::size_t pos_ = 0;
+};
+
+/// Description of the checkpoint of all processes, written by the first one.
+struct CheckpointManifest
+{
+    int version = 0;
+    std::string caseName;
+    int processes = 0;
+    int reportStep = 0;
+    double time = 0.0;
+
+    /// Written as text with one "key value" pair per line.
+    void save(const std::string& fileName) const;
+    static CheckpointManifest load(const std::string& fileName);
+};
+
+} // namespace Opm
+
+#endif // OPM_CHECKPOINT_BUFFER_HEADER_INCLUDED
@@ -0,0 +1,187 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_COMPACTBUFFER_HEADER_INCLUDED
+#define OPM_COMPACTBUFFER_HEADER_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#include <numeric>
+#endif
+
+namespace Opm
+{
+
+/// Writes integers with a variable number of bytes, seven bits per byte, and
+/// strings as their length followed by their characters.
+///
+/// Interned strings, e.g. well names or message tags, are written once per
+/// buffer and then referred to by their index.
+class CompactBufferWriter
+{
+public:
+    void writeUnsigned(std::uint64_t value)
+    {
+        while (value >= 0x80) {
+            buffer_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        buffer_.push_back(static_cast<char>(value));
+    }
+
+    void writeSigned(const std::int64_t value)
+    {
+        // zigzag, such that small negative values are short as well
+        writeUnsigned((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    void writeString(const std::string& value)
+    {
+        writeUnsigned(value.size());
+        buffer_.insert(buffer_.end(), value.begin(), value.end());
+    }
+
+    void writeInterned(const std::string& value)
+    {
+        const auto [it, inserted] = interned_.emplace(value, interned_.size());
+        if (inserted) {
+            writeUnsigned(0);
+            writeString(value);
+        } else {
+            writeUnsigned(it->second + 1);
+        }
+    }
+
+    const std::vector<char>& buffer() const
+    { return buffer_; }
+
+private:
+    std::vector<char> buffer_;
+    std::unordered_map<std::string, std::size_t> interned_;
+};
+
+/// Reads the values of a CompactBufferWriter in the order they were written.
+class CompactBufferReader
+{
+public:
+    CompactBufferReader(const char* begin, const char* end)
+        : pos_(begin)
+        , end_(end)
+    {
+    }
+
+    bool atEnd() const
+    { return pos_ == end_; }
+
+    std::uint64_t readUnsigned()
+    {
+        std::uint64_t value = 0;
+        for (int shift = 0; ; shift += 7) {
+            if (pos_ == end_ || shift > 63) {
+                throw std::runtime_error("Corrupt compact buffer");
+            }
+            const auto byte = static_cast<unsigned char>(*pos_++);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+    }
+
+    std::int64_t readSigned()
+    {
+        const std::uint64_t value = readUnsigned();
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    std::string readString()
+    {
+        const std::uint64_t size = readUnsigned();
+        if (size > static_cast<std::uint64_t>(end_ - pos_)) {
+            throw std::runtime_error("Corrupt compact buffer");
+        }
+        std::string value(pos_, size);
+        pos_ += size;
+        return value;
+    }
+
+    std::string readInterned()
+    {
+        const std::uint64_t index = readUnsigned();
+        if (index == 0) {
+            interned_.push_back(readString());
+            return interned_.back();
+        }
+        if (index > interned_.size()) {
+            throw std::runtime_error("Corrupt compact buffer");
+        }
+        return interned_[index - 1];
+    }
+
+private:
+    const char* pos_;
+    const char* end_;
+    std::vector<std::string> interned_;
+};
+
+#if HAVE_MPI
+/// Gather the buffers of all processes to all processes.
+///
+/// \param displ  on return the offset of the buffer of each process in the
+///               result, followed by its size
+/// \return       the concatenated buffers
+///
+/// If all buffers are empty, which is the common case, only a single integer
+/// is reduced instead of gathering the sizes and the buffers.
+inline std::vector<char> allGatherCompactBuffers(const std::vector<char>& buffer,
+                                                 std::vector<int>& displ,
+                                                 MPI_Comm comm = MPI_COMM_WORLD)
+{
+    int num_processes = -1;
+    MPI_Comm_size(comm, &num_processes);
+    displ.assign(num_processes + 1, 0);
+
+    int size = buffer.size();
+    int any = size > 0;
+    MPI_Allreduce(MPI_IN_PLACE, &any, 1, MPI_INT, MPI_MAX, comm);
+    if (!any) {
+        return {};
+    }
+
+    std::vector<int> sizes(num_processes);
+    MPI_Allgather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, comm);
+    std::partial_sum(sizes.begin(), sizes.end(), displ.begin() + 1);
+
+    std::vector<char> result(displ.back());
+    MPI_Allgatherv(buffer.data(), size, MPI_CHAR,
+                   result.data(), sizes.data(), displ.data(), MPI_CHAR, comm);
+    return result;
+}
+#endif // HAVE_MPI
+
+} // namespace Opm
+
+#endif // OPM_COMPACTBUFFER_HEADER_INCLUDED
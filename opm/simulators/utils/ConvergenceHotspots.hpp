@@ -0,0 +1,100 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CONVERGENCE_HOTSPOTS_HEADER_INCLUDED
+#define OPM_CONVERGENCE_HOTSPOTS_HEADER_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+namespace Opm
+{
+
+/// Per cell counters of the places which limit the convergence of the
+/// nonlinear solver, accumulated over the run and written as extra cell
+/// arrays, such that the grid or property problems which drive the run time
+/// can be located.
+///
+/// For every convergence check the cell with the largest CNV over all
+/// processes is recorded, the linear iterations of the following solve and
+/// a chop of the time step are attributed to that cell. The counters are
+/// indexed by the local element index, the cell of the last check is only
+/// known to the process which owns it.
+class ConvergenceHotspots
+{
+public:
+    /// Start counting on a process with this number of cells.
+    void resize(const std::size_t numCells)
+    {
+        maxCnvCount_.assign(numCells, 0.0);
+        chopCount_.assign(numCells, 0.0);
+        linearIterations_.assign(numCells, 0.0);
+        lastCell_ = -1;
+    }
+
+    bool enabled() const
+    { return !maxCnvCount_.empty(); }
+
+    /// The cell with the largest CNV of a convergence check, -1 if it is on
+    /// another process.
+    void recordMaxCnv(const int cell)
+    {
+        lastCell_ = cell;
+        if (cell >= 0) {
+            maxCnvCount_[cell] += 1.0;
+        }
+    }
+
+    void recordLinearIterations(const int iterations)
+    {
+        if (lastCell_ >= 0) {
+            linearIterations_[lastCell_] += iterations;
+        }
+    }
+
+    void recordChop()
+    {
+        if (lastCell_ >= 0) {
+            chopCount_[lastCell_] += 1.0;
+        }
+    }
+
+    /// How often the cell had the largest CNV.
+    const std::vector<double>& maxCnvCount() const
+    { return maxCnvCount_; }
+
+    /// How often a time step was chopped while the cell had the largest CNV.
+    const std::vector<double>& chopCount() const
+    { return chopCount_; }
+
+    /// The linear iterations of the solves while the cell had the largest CNV.
+    const std::vector<double>& linearIterations() const
+    { return linearIterations_; }
+
+private:
+    // doubles, as they are written as cell data
+    std::vector<double> maxCnvCount_;
+    std::vector<double> chopCount_;
+    std::vector<double> linearIterations_;
+    int lastCell_ = -1;
+};
+
+} // namespace Opm
+
+#endif // OPM_CONVERGENCE_HOTSPOTS_HEADER_INCLUDED
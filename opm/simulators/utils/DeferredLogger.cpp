@@ -25,60 +25,67 @@ namespace Opm
 
     void DeferredLogger::info(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Info, tag, message});
+        addMessage(Log::MessageType::Info, tag, message);
     }
     void DeferredLogger::warning(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Warning, tag, message});
+        addMessage(Log::MessageType::Warning, tag, message);
     }
     void DeferredLogger::error(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Error, tag, message});
+        addMessage(Log::MessageType::Error, tag, message);
     }
     void DeferredLogger::problem(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Problem, tag, message});
+        addMessage(Log::MessageType::Problem, tag, message);
     }
     void DeferredLogger::bug(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Bug, tag, message});
+        addMessage(Log::MessageType::Bug, tag, message);
     }
     void DeferredLogger::debug(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Debug, tag, message});
+        addMessage(Log::MessageType::Debug, tag, message);
     }
     void DeferredLogger::note(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Note, tag, message});
+        addMessage(Log::MessageType::Note, tag, message);
     }
 
     void DeferredLogger::info(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Info, "", message});
+        addMessage(Log::MessageType::Info, "", message);
     }
     void DeferredLogger::warning(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Warning, "", message});
+        addMessage(Log::MessageType::Warning, "", message);
     }
     void DeferredLogger::error(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Error, "", message});
+        addMessage(Log::MessageType::Error, "", message);
     }
     void DeferredLogger::problem(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Problem, "", message});
+        addMessage(Log::MessageType::Problem, "", message);
     }
     void DeferredLogger::bug(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Bug, "", message});
+        addMessage(Log::MessageType::Bug, "", message);
     }
     void DeferredLogger::debug(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Debug, "", message});
+        addMessage(Log::MessageType::Debug, "", message);
     }
     void DeferredLogger::note(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Note, "", message});
+        addMessage(Log::MessageType::Note, "", message);
+    }
+
+    void DeferredLogger::addMessage(int64_t flag, const std::string& tag, const std::string& message)
+    {
+        if (enabled(flag)) {
+            messages_.push_back({flag, tag, message});
+        }
     }
 
     void DeferredLogger::logMessages()
@@ -94,4 +101,9 @@ namespace Opm
         messages_.clear();
     }
 
+    void DeferredLogger::append(const DeferredLogger& other)
+    {
+        messages_.insert(messages_.end(), other.messages_.begin(), other.messages_.end());
+    }
+
 } // namespace Opm
@@ -22,7 +22,9 @@
 #define OPM_DEFERREDLOGGER_HEADER_INCLUDED
 
 #include <opm/common/OpmLog/OpmLog.hpp>
+#include <opm/common/OpmLog/LogUtil.hpp>
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -86,7 +88,30 @@ enum ExcEnum {
         /// Clear the message container without logging them.
         void clearMessages();
 
+        /// Append the messages of other to the message container.
+        void append(const DeferredLogger& other);
+
+        /// Whether messages of the given type are collected. The messages
+        /// of the other types are dropped right away, such that callers may
+        /// skip building them.
+        static bool enabled(int64_t messageType)
+        {
+            return (enabled_message_types_ & messageType) != 0;
+        }
+
+        /// Set the message types collected by the deferred loggers of this
+        /// process. The messages are gathered on the I/O process, hence all
+        /// processes must use the same types.
+        static void setEnabledMessageTypes(int64_t messageTypes)
+        {
+            enabled_message_types_ = messageTypes;
+        }
+
     private:
+        void addMessage(int64_t flag, const std::string& tag, const std::string& message);
+
+        inline static int64_t enabled_message_types_ = Log::DefaultMessageTypes;
+
         std::vector<Message> messages_;
         friend DeferredLogger gatherDeferredLogger(const DeferredLogger& local_deferredlogger);
     };
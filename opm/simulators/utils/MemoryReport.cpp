@@ -0,0 +1,79 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/utils/MemoryReport.hpp>
+#include <opm/simulators/utils/StartupProfile.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <ostream>
+
+namespace Opm
+{
+
+void MemoryReport::add(const std::string& subsystem, const std::size_t bytes)
+{
+    auto it = std::find_if(subsystems_.begin(), subsystems_.end(),
+                           [&subsystem](const auto& s) { return s.first == subsystem; });
+    if (it == subsystems_.end()) {
+        subsystems_.emplace_back(subsystem, bytes);
+    } else {
+        it->second += bytes;
+    }
+}
+
+void MemoryReport::print(std::ostream& os, const std::string& title, const Communication& comm) const
+{
+    constexpr double megabyte = 1024.0 * 1024.0;
+
+    // the subsystems, the resident set size and the unaccounted memory
+    const std::size_t n = subsystems_.size();
+    std::vector<double> values(n + 2, 0.0);
+    double accounted = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        values[i] = subsystems_[i].second / megabyte;
+        accounted += values[i];
+    }
+    values[n] = StartupProfile::currentRss() / 1024.0;
+    values[n + 1] = std::max(values[n] - accounted, 0.0);
+
+    std::vector<double> maxValues = values;
+    comm.max(maxValues.data(), maxValues.size());
+    std::vector<double> sumValues = values;
+    comm.sum(sumValues.data(), sumValues.size());
+    if (comm.rank() != 0) {
+        return;
+    }
+
+    os << title << '\n'
+       << fmt::format("{:<36}{:>14} {:>14}\n", "Memory (MiB)", "max process", "all processes");
+    auto line = [&os](const std::string& name, const double maxValue, const double sumValue)
+    {
+        os << fmt::format("{:<36}{:14.1f} {:14.1f}\n", name, maxValue, sumValue);
+    };
+    for (std::size_t i = 0; i < n; ++i) {
+        line(subsystems_[i].first, maxValues[i], sumValues[i]);
+    }
+    line("Not accounted for", maxValues[n + 1], sumValues[n + 1]);
+    line("Resident set size", maxValues[n], sumValues[n]);
+}
+
+} // namespace Opm
@@ -0,0 +1,84 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_MEMORY_REPORT_HEADER_INCLUDED
+#define OPM_MEMORY_REPORT_HEADER_INCLUDED
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// The bytes allocated by a vector.
+template <class T>
+std::size_t memoryUsage(const std::vector<T>& v)
+{
+    return v.capacity() * sizeof(T);
+}
+
+/// The bytes of the blocks and the indices of an ISTL BCRSMatrix.
+template <class Matrix>
+std::size_t matrixMemoryUsage(const Matrix& m)
+{
+    using size_type = typename Matrix::size_type;
+    return m.nonzeroes() * (sizeof(typename Matrix::block_type) + sizeof(size_type))
+        + m.N() * (sizeof(typename Matrix::row_type) + sizeof(size_type));
+}
+
+/// The bytes of the blocks of an ISTL BlockVector.
+template <class Vector>
+std::size_t vectorMemoryUsage(const Vector& v)
+{
+    return v.size() * sizeof(typename Vector::block_type);
+}
+
+/// The sizes of the major data structures of the simulator by subsystem,
+/// reported next to the resident set size of the process. The remainder
+/// is memory which is not accounted for, the EclipseState and the Schedule
+/// for example.
+class MemoryReport
+{
+public:
+    using Communication = Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>;
+
+    /// Add bytes to a subsystem. All processes have to add the same subsystems
+    /// in the same order.
+    void add(const std::string& subsystem, std::size_t bytes);
+
+    const std::vector<std::pair<std::string, std::size_t>>& subsystems() const
+    { return subsystems_; }
+
+    /// Print the maximum and the sum over the processes of each subsystem, of
+    /// the resident set size and of the memory which is not accounted for.
+    /// This is collective, only the process with rank 0 prints.
+    void print(std::ostream& os, const std::string& title, const Communication& comm) const;
+
+private:
+    std::vector<std::pair<std::string, std::size_t>> subsystems_;
+};
+
+} // namespace Opm
+
+#endif // OPM_MEMORY_REPORT_HEADER_INCLUDED
@@ -18,20 +18,42 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <config.h>
 #include <opm/simulators/utils/ParallelFileMerger.hpp>
+
+#include <algorithm>
+#include <cctype>
 #include <iostream>
+#include <system_error>
 
 namespace Opm
 {
 namespace detail
 {
 
+namespace
+{
+
+/// The contents of a file, read in one block.
+std::string readFile(const fs::path& file)
+{
+    std::ifstream in(file, std::ios::binary | std::ios::ate);
+    std::string contents;
+    if (in) {
+        contents.resize(in.tellg());
+        in.seekg(0);
+        in.read(contents.data(), contents.size());
+        contents.resize(in.gcount());
+    }
+    return contents;
+}
+
+} // anonymous namespace
+
 ParallelFileMerger::ParallelFileMerger(const fs::path& output_dir,
                                        const std::string& deckname,
                                        bool show_fallout)
-    : debugFileRegex_(deckname+"\\.\\d+\\.DBG"),
-      logFileRegex_(deckname+"\\.\\d+\\.PRT"),
-      fileWarningRegex_(deckname+"\\.(\\d+)\\.[^.]+"),
+    : deckname_(deckname),
       show_fallout_(show_fallout)
 {
     if ( show_fallout_ )
@@ -49,64 +71,101 @@ ParallelFileMerger::ParallelFileMerger(const fs::path& output_dir,
 
 void ParallelFileMerger::operator()(const fs::path& file)
 {
-    std::smatch matches;
-    std::string filename = file.filename().native();
-
-    if ( std::regex_match(filename, matches, fileWarningRegex_) )
+    // match CASENAME.[0-9]+.[^.]+
+    const std::string filename = file.filename().native();
+    const std::size_t prefix = deckname_.size() + 1;
+    if (filename.size() <= prefix || filename.compare(0, deckname_.size(), deckname_) != 0 ||
+        filename[deckname_.size()] != '.')
     {
-        std::string rank = std::regex_replace(filename, fileWarningRegex_, "\\1");
+        return;
+    }
+    const std::size_t dot = filename.find('.', prefix);
+    if (dot == std::string::npos || dot == prefix || dot + 1 == filename.size() ||
+        filename.find('.', dot + 1) != std::string::npos ||
+        !std::all_of(filename.begin() + prefix, filename.begin() + dot,
+                     [](unsigned char c) { return std::isdigit(c); }))
+    {
+        return;
+    }
 
-        if( std::regex_match(filename, logFileRegex_) )
-        {
-            if ( show_fallout_ ){
-                appendFile(*logStream_, file, rank);
-            }else{
-                fs::remove(file);
-            }
-        }
-        else
-        {
-            if (std::regex_match(filename, debugFileRegex_)  )
-            {
-                if ( show_fallout_ ){
-                    appendFile(*debugStream_, file, rank);
-                }else{
-                    fs::remove(file);
-                }
-            }
-            else
-            {
-                if ( show_fallout_ ){
-                    std::cerr << "WARNING: Unrecognized file with name "
-                                  << filename
-                                  << " that might stem from a  parallel run."
-                                  << std::endl;
-                }
-            }
-        }
+    const int rank = std::stoi(filename.substr(prefix, dot - prefix));
+    const std::string extension = filename.substr(dot + 1);
+    if (extension == "PRT")
+    {
+        logFiles_.emplace_back(rank, file);
+    }
+    else if (extension == "DBG")
+    {
+        debugFiles_.emplace_back(rank, file);
+    }
+    else if ( show_fallout_ )
+    {
+        std::cerr << "WARNING: Unrecognized file with name "
+                  << filename
+                  << " that might stem from a  parallel run."
+                  << std::endl;
     }
 }
 
-void ParallelFileMerger::appendFile(std::ofstream& of, const fs::path& file, const std::string& rank)
+void ParallelFileMerger::merge()
 {
-    if( fs::file_size(file) )
+    appendFiles(logStream_.get(), logFiles_);
+    appendFiles(debugStream_.get(), debugFiles_);
+    if (logStream_)
+        logStream_->flush();
+    if (debugStream_)
+        debugStream_->flush();
+}
+
+void ParallelFileMerger::appendFiles(std::ofstream* of, std::vector<RankFile>& files) const
+{
+    std::sort(files.begin(), files.end());
+
+    // bounds the memory of the contents read ahead of writing them
+    const int batchSize = 64;
+    const int numFiles = files.size();
+    std::vector<std::string> contents(batchSize);
+    for (int begin = 0; begin < numFiles; begin += batchSize)
     {
-        std::cerr << "WARNING: There has been logging to file "
+        const int end = std::min(numFiles, begin + batchSize);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = begin; i < end; ++i)
+        {
+            if (of)
+                contents[i - begin] = readFile(files[i].second);
+            std::error_code ec;
+            fs::remove(files[i].second, ec);
+        }
+
+        if (!of)
+            continue;
+
+        for (int i = begin; i < end; ++i)
+        {
+            auto& content = contents[i - begin];
+            if (content.empty())
+                continue;
+
+            const auto& file = files[i].second;
+            std::cerr << "WARNING: There has been logging to file "
                       << file.string() <<" by process "
-                      << rank << std::endl;
-
-        std::ifstream in(file);
-        of<<std::endl<< std::endl;
-        of<<"=======================================================";
-        of<<std::endl<<std::endl;
-        of << " Output written by rank " << rank << " to file " << file.string();
-        of << ":" << std::endl << std::endl;
-        of << in.rdbuf() << std::endl << std::endl;
-        of << "======================== end output =====================";
-        of << std::endl;
-        in.close();
+                      << files[i].first << std::endl;
+
+            *of << "\n\n";
+            *of << "=======================================================";
+            *of << "\n\n";
+            *of << " Output written by rank " << files[i].first << " to file " << file.string();
+            *of << ":\n\n";
+            of->write(content.data(), content.size());
+            *of << "\n\n";
+            *of << "======================== end output =====================";
+            *of << "\n";
+            std::string().swap(content);
+        }
     }
-    fs::remove(file);
+    files.clear();
 }
 
 } // end namespace detail
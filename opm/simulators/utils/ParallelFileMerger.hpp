@@ -23,8 +23,9 @@
 
 #include <fstream>
 #include <memory>
-#include <regex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <opm/common/utility/FileSystem.hpp>
 
@@ -40,8 +41,9 @@ namespace fs = ::Opm::filesystem;
 ///
 /// Without care multiple processes might log messages in a parallel run.
 /// Non-root processes will do that to seperate files
-/// <basename>.<rank>.<extension. This functor will append those file
-/// to usual ones and delete the other files.
+/// <basename>.<rank>.<extension. This functor collects those files,
+/// merge() then appends them to the usual ones in the order of the ranks
+/// and deletes them.
 class ParallelFileMerger
 {
 public:
@@ -52,21 +54,29 @@ public:
                        const std::string& deckname,
                        bool show_fallout = false);
 
+    /// \brief Record a file if it was written by a non-root process.
     void operator()(const fs::path& file);
 
+    /// \brief Append the recorded files and remove them.
+    ///
+    /// The files are read concurrently in batches with large block reads,
+    /// and written in the order of the ranks.
+    void merge();
+
 private:
-    /// \brief Append contents of a file to a stream
-    /// \brief of The output stream to use.
-    /// \brief file The file whose content to append.
-    /// \brief rank The rank that wrote the file.
-    void appendFile(std::ofstream& of, const fs::path& file, const std::string& rank);
-
-    /// \brief Regex to capture *.DBG
-    std::regex debugFileRegex_;
-    /// \brief Regex to capture  *.PRT
-    std::regex logFileRegex_;
-    /// \brief Regex to capture  CASENAME.[0-9]+.[A-Z]+
-    std::regex fileWarningRegex_;
+    using RankFile = std::pair<int, fs::path>;
+
+    /// \brief Append the contents of files to a stream and remove them.
+    /// \param of The output stream to use, the files are only removed if null.
+    /// \param files The ranks that wrote the files and the files.
+    void appendFiles(std::ofstream* of, std::vector<RankFile>& files) const;
+
+    /// \brief The name of the deck, the prefix of the files.
+    std::string deckname_;
+    /// \brief The *.DBG files of the other ranks.
+    std::vector<RankFile> debugFiles_;
+    /// \brief The *.PRT files of the other ranks.
+    std::vector<RankFile> logFiles_;
     /// \brief Stream to *.DBG file
     std::unique_ptr<std::ofstream> debugStream_;
     /// \brief Stream to *.PRT file
@@ -24,6 +24,7 @@
 #include "ParallelRestart.hpp"
 #include <ctime>
 #include <cstring>
+#include <utility>
 #include <dune/common/parallel/mpitraits.hh>
 #include <opm/output/data/Cells.hpp>
 #include <opm/output/data/Groups.hpp>
@@ -976,7 +977,8 @@ INSTANTIATE_PACK(std::set<std::string>)
 RestartValue loadParallelRestart(const EclipseIO* eclIO, Action::State& actionState, SummaryState& summaryState,
                                  const std::vector<Opm::RestartKey>& solutionKeys,
                                  const std::vector<Opm::RestartKey>& extraKeys,
-                                 Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> comm)
+                                 Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> comm,
+                                 bool broadcastSolution)
 {
 #if HAVE_MPI
     data::Solution sol;
@@ -988,12 +990,18 @@ RestartValue loadParallelRestart(const EclipseIO* eclIO, Action::State& actionSt
     {
         assert(comm.rank() == 0);
         restartValues = eclIO->loadRestart(actionState, summaryState, solutionKeys, extraKeys);
+        // keep the cell data out of the broadcast if the caller distributes it
+        data::Solution solution;
+        if (!broadcastSolution)
+            std::swap(solution, restartValues.solution);
         int packedSize = Mpi::packSize(restartValues, comm);
         std::vector<char> buffer(packedSize);
         int position=0;
         Mpi::pack(restartValues, buffer, position, comm);
         comm.broadcast(&position, 1, 0);
         comm.broadcast(buffer.data(), position, 0);
+        if (!broadcastSolution)
+            std::swap(solution, restartValues.solution);
         std::vector<char> buf2 = summaryState.serialize();
         int size = buf2.size();
         comm.broadcast(&size, 1, 0);
@@ -1015,6 +1023,7 @@ RestartValue loadParallelRestart(const EclipseIO* eclIO, Action::State& actionSt
     return restartValues;
 #else
     (void) comm;
+    (void) broadcastSolution;
     return eclIO->loadRestart(actionState, summaryState, solutionKeys, extraKeys);
 #endif
 }
@@ -352,10 +352,14 @@ ADD_PACK_PROTOTYPES(time_point)
 
 } // end namespace Mpi
 
+/// Load the restart values on rank 0 and broadcast them. If broadcastSolution is
+/// false, the cell data stays on rank 0 and the other ranks get an empty solution,
+/// the caller distributes the cell values of each rank itself.
 RestartValue loadParallelRestart(const EclipseIO* eclIO, Action::State& actionState, SummaryState& summaryState,
                                  const std::vector<RestartKey>& solutionKeys,
                                  const std::vector<RestartKey>& extraKeys,
-                                 Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> comm);
+                                 Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> comm,
+                                 bool broadcastSolution = true);
 
 } // end namespace Opm
 #endif // PARALLEL_RESTART_HPP
@@ -48,9 +48,22 @@ void eclStateBroadcast(EclipseState& eclState, Schedule& schedule,
     ser.broadcast(summaryConfig);
 }
 
+void eclStateBroadcast(EclipseState& eclState)
+{
+    Opm::EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication());
+    ser.broadcast(eclState);
+}
+
 void eclScheduleBroadcast(Schedule& schedule)
 {
     Opm::EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication());
     ser.broadcast(schedule);
 }
+
+void eclScheduleBroadcast(Schedule& schedule, SummaryConfig& summaryConfig)
+{
+    Opm::EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication());
+    ser.broadcast(schedule);
+    ser.broadcast(summaryConfig);
+}
 }
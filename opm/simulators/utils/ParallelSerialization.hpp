@@ -33,9 +33,18 @@ class SummaryConfig;
 void eclStateBroadcast(EclipseState& eclState, Schedule& schedule,
                        SummaryConfig& summaryConfig);
 
+/*! \brief Broadcasts only the eclipse state from root node in parallel runs.
+ *! \details Allows the other ranks to unpack the eclipse state while
+ *!          the root node still constructs the schedule.
+*/
+void eclStateBroadcast(EclipseState& eclState);
+
 /// \brief Broadcasts an schedule from root node in parallel runs.
 void eclScheduleBroadcast(Schedule& schedule);
 
+/// \brief Broadcasts a schedule and summary config from root node in parallel runs.
+void eclScheduleBroadcast(Schedule& schedule, SummaryConfig& summaryConfig);
+
 } // end namespace Opm
 
 #endif // PARALLEL_SERIALIZATION_HPP
@@ -0,0 +1,238 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/utils/PerfCounters.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+using Opm::PerfCounters;
+
+// The counters of a thread, opened on the first scope of the thread.
+class ThreadCounters
+{
+public:
+    ThreadCounters()
+    {
+#if defined(__linux__)
+        const std::uint64_t configs[PerfCounters::NumCounters] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_REFERENCES,
+            PERF_COUNT_HW_CACHE_MISSES
+        };
+        for (int c = 0; c < PerfCounters::NumCounters; ++c) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[c];
+            attr.disabled = c == 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            fds_[c] = syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                              /*group_fd=*/c == 0 ? -1 : fds_[0], /*flags=*/0);
+            if (fds_[c] < 0) {
+                close_();
+                return;
+            }
+        }
+        ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    ~ThreadCounters()
+    {
+        close_();
+    }
+
+    bool available() const
+    {
+        return fds_[0] >= 0;
+    }
+
+    void read(PerfCounters::Values& values) const
+    {
+#if defined(__linux__)
+        std::uint64_t buffer[1 + PerfCounters::NumCounters];
+        if (available() && ::read(fds_[0], buffer, sizeof(buffer)) == sizeof(buffer)) {
+            std::copy(buffer + 1, buffer + 1 + PerfCounters::NumCounters, values.begin());
+            return;
+        }
+#endif
+        values.fill(0);
+    }
+
+private:
+    void close_()
+    {
+#if defined(__linux__)
+        for (auto& fd : fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            fd = -1;
+        }
+#endif
+    }
+
+    int fds_[PerfCounters::NumCounters] = { -1, -1, -1, -1 };
+};
+
+const ThreadCounters& threadCounters()
+{
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+struct PerfState
+{
+    std::mutex mutex;
+    // few kernels, so a linear search for the name is fine
+    std::vector<std::pair<const char*, PerfCounters::KernelStatistics>> kernels;
+    std::atomic<bool> enabled{false};
+};
+
+PerfState& perfState()
+{
+    static PerfState state;
+    return state;
+}
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+PerfCounters::Scope::Scope(const char* name, const double bytes)
+    : name_(enabled() ? name : nullptr)
+    , bytes_(bytes)
+    , counters_{}
+{
+    if (name_) {
+        threadCounters().read(counters_);
+        begin_ = std::chrono::steady_clock::now();
+    }
+}
+
+PerfCounters::Scope::~Scope()
+{
+    if (!name_) {
+        return;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    Values counters;
+    threadCounters().read(counters);
+
+    auto& state = perfState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto kernel = std::find_if(state.kernels.begin(), state.kernels.end(),
+                               [this](const auto& k) { return k.first == name_; });
+    if (kernel == state.kernels.end()) {
+        state.kernels.emplace_back(name_, KernelStatistics{});
+        kernel = state.kernels.end() - 1;
+        kernel->second.name = name_;
+    }
+    auto& stats = kernel->second;
+    ++stats.calls;
+    stats.seconds += std::chrono::duration<double>(end - begin_).count();
+    stats.bytes += bytes_;
+    for (int c = 0; c < NumCounters; ++c) {
+        stats.counters[c] += counters[c] - counters_[c];
+    }
+}
+
+void PerfCounters::start()
+{
+    auto& state = perfState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.kernels.clear();
+    state.enabled = true;
+}
+
+void PerfCounters::stop()
+{
+    perfState().enabled = false;
+}
+
+bool PerfCounters::enabled()
+{
+    return perfState().enabled.load(std::memory_order_relaxed);
+}
+
+bool PerfCounters::countersAvailable()
+{
+    return threadCounters().available();
+}
+
+std::vector<PerfCounters::KernelStatistics> PerfCounters::statistics()
+{
+    auto& state = perfState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::vector<KernelStatistics> result;
+    for (const auto& kernel : state.kernels) {
+        result.push_back(kernel.second);
+    }
+    return result;
+}
+
+void PerfCounters::report(std::ostream& os)
+{
+    // the bytes moved for a last level cache miss
+    constexpr double cacheLineSize = 64.0;
+
+    os << fmt::format("{:<24}{:>10} {:>11} {:>13} {:>13} {:>6} {:>11}\n",
+                      "kernel", "calls", "time [s]", "GB/s (scope)", "GB/s (LLC)", "IPC", "LLC miss %");
+    for (const auto& k : statistics()) {
+        const double seconds = std::max(k.seconds, 1e-12);
+        os << fmt::format("{:<24}{:10} {:11.4f}", k.name, k.calls, k.seconds);
+        if (k.bytes > 0.0) {
+            os << fmt::format(" {:13.2f}", 1e-9 * k.bytes / seconds);
+        } else {
+            os << fmt::format(" {:>13}", "n/a");
+        }
+        if (k.counters[Cycles] > 0) {
+            const double misses = k.counters[CacheMisses];
+            os << fmt::format(" {:13.2f} {:6.2f} {:11.1f}\n",
+                              1e-9 * misses * cacheLineSize / seconds,
+                              static_cast<double>(k.counters[Instructions]) / k.counters[Cycles],
+                              k.counters[CacheReferences] > 0 ? 100.0 * misses / k.counters[CacheReferences] : 0.0);
+        } else {
+            os << fmt::format(" {:>13} {:>6} {:>11}\n", "n/a", "n/a", "n/a");
+        }
+    }
+}
+
+} // namespace Opm
@@ -0,0 +1,114 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PERFCOUNTERS_HEADER_INCLUDED
+#define OPM_PERFCOUNTERS_HEADER_INCLUDED
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+/// Accumulates the hardware performance counters of the kernels of the
+/// solver: cycles, instructions, last level cache references and misses,
+/// read with perf_event_open() on Linux. Together with the number of bytes a
+/// kernel has to move at least, this shows whether a kernel runs at the memory
+/// bandwidth or is limited by the instructions.
+///
+/// The counters are those of the calling thread, so the work of other OpenMP
+/// threads in the scope is in the time but not in the counts. If the counters
+/// are not available, for example because of kernel.perf_event_paranoid, only
+/// the times are recorded.
+///
+/// The scopes are compiled in with the ENABLE_PERF_COUNTERS CMake option
+/// only, see OPM_PERF_SCOPE().
+class PerfCounters
+{
+public:
+    enum Counter { Cycles, Instructions, CacheReferences, CacheMisses, NumCounters };
+    using Values = std::array<std::uint64_t, NumCounters>;
+
+    struct KernelStatistics
+    {
+        std::string name;
+        std::size_t calls = 0;
+        double seconds = 0.0;
+        double bytes = 0.0;
+        Values counters{};
+    };
+
+    /// Adds the counters from construction to destruction to the kernel. The
+    /// name must be a string literal, kernels are identified by the pointer.
+    class Scope
+    {
+    public:
+        Scope(const char* name, double bytes);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name_;
+        double bytes_;
+        std::chrono::steady_clock::time_point begin_;
+        Values counters_;
+    };
+
+    /// Start recording, the statistics recorded before are dropped.
+    static void start();
+
+    static void stop();
+
+    static bool enabled();
+
+    /// Whether this thread reads the hardware counters, false if only the
+    /// times are recorded.
+    static bool countersAvailable();
+
+    static std::vector<KernelStatistics> statistics();
+
+    /// Print the time, the achieved bandwidth from the bytes of the scopes and
+    /// from the cache misses, the instructions per cycle and the cache miss
+    /// rate of each kernel.
+    static void report(std::ostream& os);
+};
+
+} // namespace Opm
+
+#define OPM_PERF_CONCAT_IMPL(a, b) a##b
+#define OPM_PERF_CONCAT(a, b) OPM_PERF_CONCAT_IMPL(a, b)
+
+/// Count the rest of the scope as the kernel name, which moves at least
+/// bytes to or from memory, 0 if not known. The bytes are only evaluated
+/// when recording.
+#if HAVE_PERF_COUNTERS
+#define OPM_PERF_SCOPE(name, bytes) \
+    ::Opm::PerfCounters::Scope OPM_PERF_CONCAT(opmPerfScope, __LINE__)(name, ::Opm::PerfCounters::enabled() ? static_cast<double>(bytes) : 0.0)
+#else
+#define OPM_PERF_SCOPE(name, bytes) ((void)0)
+#endif
+
+#endif // OPM_PERFCOUNTERS_HEADER_INCLUDED
@@ -0,0 +1,57 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PHASEACTIVITY_HEADER_INCLUDED
+#define OPM_PHASEACTIVITY_HEADER_INCLUDED
+
+namespace Opm
+{
+
+/// The phases which can be active in a model, known at compile time.
+///
+/// The flow variants for two phases use Indices which contain the equations of
+/// two phases only, the third phase can then never be active. phaseIsActive()
+/// combines this with the run time check of the fluid system, such that the
+/// branches of a phase which is disabled by the Indices compile away, while a
+/// phase enabled by the Indices is checked at run time as before.
+template <class FluidSystem, class Indices>
+struct PhaseActivity
+{
+    static constexpr bool waterEnabled = Indices::waterEnabled;
+    static constexpr bool oilEnabled = Indices::oilEnabled;
+    static constexpr bool gasEnabled = Indices::gasEnabled;
+
+    /// Whether the phase can be active, known at compile time.
+    static constexpr bool phaseIsEnabled(unsigned phaseIdx)
+    {
+        return (phaseIdx == static_cast<unsigned>(FluidSystem::waterPhaseIdx) && waterEnabled)
+            || (phaseIdx == static_cast<unsigned>(FluidSystem::oilPhaseIdx) && oilEnabled)
+            || (phaseIdx == static_cast<unsigned>(FluidSystem::gasPhaseIdx) && gasEnabled);
+    }
+
+    /// Whether the phase is active, the same as FluidSystem::phaseIsActive().
+    static bool phaseIsActive(unsigned phaseIdx)
+    {
+        return phaseIsEnabled(phaseIdx) && FluidSystem::phaseIsActive(phaseIdx);
+    }
+};
+
+} // namespace Opm
+
+#endif // OPM_PHASEACTIVITY_HEADER_INCLUDED
@@ -33,24 +33,31 @@
 #include <dune/grid/common/mcmgmapper.hh>
 #include <dune/grid/common/partitionset.hh>
 #include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/mpitraits.hh>
+#include <cassert>
 #include <unordered_map>
-#include <iostream>
+#include <vector>
 
 namespace Opm
 {
 
 /*!
  * \brief A Data handle to communicate the field properties and cell centroids during load balance.
+ *
+ * Nothing is sent through the grid's per element communication. Instead the
+ * destructor, which runs once the grid is distributed, collects the global
+ * cells of all processes on the root and sends every property as one
+ * contiguous column with MPI_Alltoallv, ordered like the local cells of the
+ * receiving process.
  * \tparam Grid The type of grid where the load balancing is happening.
- * \todo Maybe specialize this for CpGrid to save some space, later.
  */
 template<class Grid>
 class PropsCentroidsDataHandle
     : public Dune::CommDataHandleIF< PropsCentroidsDataHandle<Grid>, double>
 {
 public:
-    //! \brief the data type we send (ints are converted to double)
-    using DataType = std::pair<double, unsigned char>;
+    //! \brief the data type of the (empty) per element communication
+    using DataType = double;
 
     //! \brief Constructor
     //! \param grid The grid where the loadbalancing is happening.
@@ -73,6 +80,7 @@ public:
         if (comm.rank() == 0)
         {
             const auto& globalProps = eclState.globalFieldProps();
+            m_globalProps = &globalProps;
             m_intKeys = globalProps.keys<int>();
             m_doubleKeys = globalProps.keys<double>();
             std::size_t packSize = Mpi::packSize(m_intKeys, comm) +
@@ -93,43 +101,25 @@ public:
             // Unpack Calculator as we need it here, too.
             m_distributed_fieldProps.deserialize_tran( std::vector<char>(buffer.begin() + calcStart, buffer.end()) );
 
-            // copy data to persistent map based on local id
-            m_no_data = m_intKeys.size() + m_doubleKeys.size() +
-                Grid::dimensionworld;
+            // The index of each id and the centroids of the global grid, the
+            // cartesian mapper follows the grid once it is distributed.
             const auto& idSet = m_grid.localIdSet();
             const auto& gridView = m_grid.levelGridView(0);
             using ElementMapper =
                 Dune::MultipleCodimMultipleGeomTypeMapper<typename Grid::LevelGridView>;
             ElementMapper elemMapper(gridView, Dune::mcmgElementLayout());
 
+            m_rootCentroids.resize(m_grid.size(0) * Grid::dimensionworld);
+            m_rootIndex.reserve(m_grid.size(0));
             for( const auto &element : elements( gridView, Dune::Partitions::interiorBorder ) )
             {
-                const auto& id = idSet.id(element);
                 auto index = elemMapper.index(element);
-                auto& data = elementData_[id];
-                data.reserve(m_no_data);
-
-                for (const auto& intKey : m_intKeys)
-                {
-                    const auto& fieldData = globalProps.get_int_field_data(intKey);
-                    data.emplace_back(fieldData.data[index],
-                                      static_cast<unsigned char>(fieldData.value_status[index]));
-                }
-
-                for (const auto& doubleKey : m_doubleKeys)
-                {
-                    // We need to allow unsupported keywords to get the data
-                    // for TranCalculator, too.
-                    const auto& fieldData = globalProps.get_double_field_data(doubleKey,
-                                                                              /* allow_unsupported = */ true);
-                    data.emplace_back(fieldData.data[index],
-                                      static_cast<unsigned char>(fieldData.value_status[index]));
-                }
+                m_rootIndex.emplace(idSet.id(element), index);
 
                 auto cartIndex = cartMapper.cartesianIndex(index);
                 const auto& center = eclGridOnRoot->getCellCenter(cartIndex);
                 for (int dim = 0; dim < Grid::dimensionworld; ++dim)
-                    data.emplace_back(center[dim], '1'); // write garbage for value_status
+                    m_rootCentroids[Grid::dimensionworld * index + dim] = center[dim];
             }
         }
         else
@@ -142,67 +132,99 @@ public:
             Mpi::unpack(m_intKeys, buffer, position, comm);
             Mpi::unpack(m_doubleKeys, buffer, position, comm);
             m_distributed_fieldProps.deserialize_tran( std::vector<char>(buffer.begin() + position, buffer.end()) );
-            m_no_data = m_intKeys.size() + m_doubleKeys.size() +
-                Grid::dimensionworld;
         }
     }
 
     ~PropsCentroidsDataHandle()
     {
         // distributed grid is now correctly set up.
-        for(const auto& intKey : m_intKeys)
-        {
-            m_distributed_fieldProps.m_intProps[intKey].data.resize(m_grid.size(0));
-            m_distributed_fieldProps.m_intProps[intKey].value_status.resize(m_grid.size(0));
-        }
-
-        for(const auto& doubleKey : m_doubleKeys)
-        {
-            m_distributed_fieldProps.m_doubleProps[doubleKey].data.resize(m_grid.size(0));
-            m_distributed_fieldProps.m_doubleProps[doubleKey].value_status.resize(m_grid.size(0));
-        }
-
-        m_centroids.resize(m_grid.size(0) * Grid::dimensionworld);
-
-        // copy data for the persistent mao to the field properties
+        const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
         const auto& idSet = m_grid.localIdSet();
         const auto& gridView = m_grid.levelGridView(0);
         using ElementMapper =
             Dune::MultipleCodimMultipleGeomTypeMapper<typename Grid::LevelGridView>;
         ElementMapper elemMapper(gridView, Dune::mcmgElementLayout());
 
+        // the global ids of the local cells, in the order of their indices
+        const int numCells = m_grid.size(0);
+        std::vector<int> ids(numCells);
         for( const auto &element : elements( gridView, Dune::Partitions::all ) )
         {
-            std::size_t counter{};
-            const auto& id = idSet.id(element);
-            auto index = elemMapper.index(element);
-            auto data = elementData_.find(id);
-            assert(data != elementData_.end());
+            ids[elemMapper.index(element)] = idSet.id(element);
+        }
 
-            for(const auto& intKey : m_intKeys)
+        m_counts.resize(comm.size());
+        comm.gather(&numCells, m_counts.data(), 1, 0);
+        m_displs.assign(comm.size() + 1, 0);
+        for (int rank = 0; rank < comm.size(); ++rank)
+        {
+            m_displs[rank + 1] = m_displs[rank] + m_counts[rank];
+        }
+        std::vector<int> allIds(comm.rank() == 0 ? m_displs.back() : 0);
+        comm.gatherv(ids.data(), numCells, allIds.data(), m_counts.data(), m_displs.data(), 0);
+
+        // the index in the global grid of each cell sent by the root
+        std::vector<int> sendIndex;
+        if (comm.rank() == 0)
+        {
+            sendIndex.reserve(allIds.size());
+            for (const auto id : allIds)
             {
-                const auto& pair = data->second[counter++];
-                m_distributed_fieldProps.m_intProps[intKey].data[index] = static_cast<int>(pair.first);
-                m_distributed_fieldProps.m_intProps[intKey].value_status[index] = static_cast<value::status>(pair.second);
+                const auto index = m_rootIndex.find(id);
+                assert(index != m_rootIndex.end());
+                sendIndex.push_back(index->second);
             }
+        }
 
-            for(const auto& doubleKey : m_doubleKeys)
+        for(const auto& intKey : m_intKeys)
+        {
+            auto& fieldData = m_distributed_fieldProps.m_intProps[intKey];
+            std::vector<int> data;
+            std::vector<unsigned char> status;
+            if (comm.rank() == 0)
             {
-                const auto& pair = data->second[counter++];
-                m_distributed_fieldProps.m_doubleProps[doubleKey].data[index] = pair.first;
-                m_distributed_fieldProps.m_doubleProps[doubleKey].value_status[index] = static_cast<value::status>(pair.second);
+                const auto& globalData = m_globalProps->get_int_field_data(intKey);
+                data = gatherColumn_(globalData.data, sendIndex);
+                status = statusColumn_(globalData.value_status, sendIndex);
             }
+            sendColumn_(data, fieldData.data, numCells, 1);
+            receiveStatus_(status, fieldData.value_status, numCells);
+        }
 
-            auto centroidIter = m_centroids.begin() + Grid::dimensionworld * index;
-            auto centroidIterEnd = centroidIter + Grid::dimensionworld;
-            for ( ; centroidIter != centroidIterEnd; ++centroidIter )
-                *centroidIter = data->second[counter++].first; // value_status discarded
+        for(const auto& doubleKey : m_doubleKeys)
+        {
+            auto& fieldData = m_distributed_fieldProps.m_doubleProps[doubleKey];
+            std::vector<double> data;
+            std::vector<unsigned char> status;
+            if (comm.rank() == 0)
+            {
+                // We need to allow unsupported keywords to get the data
+                // for TranCalculator, too.
+                const auto& globalData = m_globalProps->get_double_field_data(doubleKey,
+                                                                              /* allow_unsupported = */ true);
+                data = gatherColumn_(globalData.data, sendIndex);
+                status = statusColumn_(globalData.value_status, sendIndex);
+            }
+            sendColumn_(data, fieldData.data, numCells, 1);
+            receiveStatus_(status, fieldData.value_status, numCells);
         }
+
+        std::vector<double> centroids;
+        if (comm.rank() == 0)
+        {
+            centroids.reserve(sendIndex.size() * Grid::dimensionworld);
+            for (const auto index : sendIndex)
+            {
+                const auto center = m_rootCentroids.begin() + Grid::dimensionworld * index;
+                centroids.insert(centroids.end(), center, center + Grid::dimensionworld);
+            }
+        }
+        sendColumn_(centroids, m_centroids, numCells, Grid::dimensionworld);
     }
 
-    bool contains(int /* dim */, int codim)
+    bool contains(int /* dim */, int /* codim */)
     {
-        return codim == 0;
+        return false;
     }
 
     bool fixedsize(int /* dim */, int /* codim */)
@@ -217,49 +239,95 @@ public:
     template<class EntityType>
     std::size_t size(const EntityType /* entity */)
     {
-        return m_no_data;
+        return 0;
     }
 
     template<class BufferType, class EntityType>
-    void gather(BufferType& buffer, const EntityType& e) const
+    void gather(BufferType& /* buffer */, const EntityType& /* e */) const
     {
-        auto iter = elementData_.find(m_grid.localIdSet().id(e));
-        assert(iter != elementData_.end());
-        for(const auto& data : iter->second)
-        {
-            buffer.write(data);
-        }
     }
 
     template<class BufferType, class EntityType>
-    void scatter(BufferType& buffer, const EntityType& e, std::size_t n)
+    void scatter(BufferType& /* buffer */, const EntityType& /* e */, std::size_t /* n */)
+    {
+    }
+
+private:
+    template<class T>
+    static std::vector<T> gatherColumn_(const std::vector<T>& global, const std::vector<int>& index)
+    {
+        std::vector<T> column;
+        column.reserve(index.size());
+        for (const auto i : index)
+            column.push_back(global[i]);
+        return column;
+    }
+
+    static std::vector<unsigned char> statusColumn_(const std::vector<value::status>& global,
+                                                    const std::vector<int>& index)
     {
-        assert(n == m_no_data);
-        auto& array = elementData_[m_grid.localIdSet().id(e)];
-        array.resize(n);
-        for(auto& data: array)
+        std::vector<unsigned char> column;
+        column.reserve(index.size());
+        for (const auto i : index)
+            column.push_back(static_cast<unsigned char>(global[i]));
+        return column;
+    }
+
+    //! \brief Send the blocks of a column from the root, ordered by the
+    //!        receiving process, to the local cells of each process.
+    template<class T>
+    void sendColumn_(const std::vector<T>& send, std::vector<T>& recv,
+                     const int numCells, const int blockSize) const
+    {
+        const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+        const int size = comm.size();
+        std::vector<int> sendCounts(size, 0), sendDispls(size, 0);
+        std::vector<int> recvCounts(size, 0), recvDispls(size, 0);
+        if (comm.rank() == 0)
         {
-            buffer.read(data);
+            for (int rank = 0; rank < size; ++rank)
+            {
+                sendCounts[rank] = blockSize * m_counts[rank];
+                sendDispls[rank] = blockSize * m_displs[rank];
+            }
         }
+        recvCounts[0] = blockSize * numCells;
+        recv.resize(blockSize * numCells);
+        const auto type = Dune::MPITraits<T>::getType();
+        MPI_Alltoallv(send.data(), sendCounts.data(), sendDispls.data(), type,
+                      recv.data(), recvCounts.data(), recvDispls.data(), type,
+                      Dune::MPIHelper::getCommunicator());
+    }
+
+    void receiveStatus_(const std::vector<unsigned char>& send,
+                        std::vector<value::status>& status, const int numCells) const
+    {
+        std::vector<unsigned char> recv;
+        sendColumn_(send, recv, numCells, 1);
+        status.resize(numCells);
+        for (int i = 0; i < numCells; ++i)
+            status[i] = static_cast<value::status>(recv[i]);
     }
 
-private:
     using LocalIdSet = typename Grid::LocalIdSet;
     const Grid& m_grid;
     //! \brief The distributed field properties for receiving
     ParallelFieldPropsManager& m_distributed_fieldProps;
+    //! \brief The field properties of the global grid, only on the root.
+    const FieldPropsManager* m_globalProps = nullptr;
     //! \brief The names of the keys of the integer fields.
     std::vector<std::string> m_intKeys;
     //! \brief The names of the keys of the double fields.
     std::vector<std::string> m_doubleKeys;
-    /// \brief The data per element as a vector mapped from the local id.
-    ///
-    /// each entry is a pair of data and value_status.
-    std::unordered_map<typename LocalIdSet::IdType, std::vector<std::pair<double,unsigned char> > > elementData_;
+    //! \brief The index in the global grid of each id, only on the root.
+    std::unordered_map<typename LocalIdSet::IdType, int> m_rootIndex;
+    //! \brief The centroids of the global grid, only on the root.
+    std::vector<double> m_rootCentroids;
+    //! \brief The number of local cells of each process and their offsets, only on the root.
+    std::vector<int> m_counts;
+    std::vector<int> m_displs;
     /// \brief The cell centroids of the distributed grid.
     std::vector<double>& m_centroids;
-    /// \brief The amount of data to send for each element
-    std::size_t m_no_data;
 };
 
 } // end namespace Opm
@@ -0,0 +1,105 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_REGIONBATCHES_HEADER_INCLUDED
+#define OPM_REGIONBATCHES_HEADER_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+/// Items, e.g. cells, grouped by a small non-negative key, e.g. the
+/// combination of their PVT and saturation function regions, into batches
+/// of items with the same key.
+///
+/// The items of a key keep their original order and are split into batches
+/// of at most maxBatchSize items, such that the batches can be distributed
+/// over threads, while all the items of a batch use the same tables.
+class RegionBatches
+{
+public:
+    RegionBatches() = default;
+
+    RegionBatches(const std::vector<int>& keys, const std::size_t maxBatchSize)
+    {
+        build(keys, maxBatchSize);
+    }
+
+    void build(const std::vector<int>& keys, const std::size_t maxBatchSize)
+    {
+        if (maxBatchSize == 0) {
+            throw std::invalid_argument("The batches must hold at least one item");
+        }
+        int numKeys = 0;
+        for (const int key : keys) {
+            if (key < 0) {
+                throw std::invalid_argument("The keys of the batches must not be negative");
+            }
+            numKeys = std::max(numKeys, key + 1);
+        }
+
+        // counting sort, stable within each key
+        std::vector<std::size_t> keyStart(numKeys + 1, 0);
+        for (const int key : keys) {
+            ++keyStart[key + 1];
+        }
+        for (int key = 0; key < numKeys; ++key) {
+            keyStart[key + 1] += keyStart[key];
+        }
+        order_.resize(keys.size());
+        std::vector<std::size_t> next(keyStart.begin(), keyStart.end() - 1);
+        for (std::size_t item = 0; item < keys.size(); ++item) {
+            order_[next[keys[item]]++] = item;
+        }
+
+        batchStart_.clear();
+        batchStart_.push_back(0);
+        for (int key = 0; key < numKeys; ++key) {
+            for (std::size_t pos = keyStart[key]; pos < keyStart[key + 1]; pos += maxBatchSize) {
+                batchStart_.push_back(std::min(pos + maxBatchSize, keyStart[key + 1]));
+            }
+        }
+    }
+
+    std::size_t numBatches() const
+    { return batchStart_.empty() ? 0 : batchStart_.size() - 1; }
+
+    /// The items of batch b are order()[batchBegin(b)] to order()[batchEnd(b) - 1].
+    std::size_t batchBegin(const std::size_t b) const
+    { return batchStart_[b]; }
+
+    std::size_t batchEnd(const std::size_t b) const
+    { return batchStart_[b + 1]; }
+
+    /// The items sorted by their keys.
+    const std::vector<std::size_t>& order() const
+    { return order_; }
+
+private:
+    std::vector<std::size_t> order_;
+    std::vector<std::size_t> batchStart_;
+};
+
+} // namespace Opm
+
+#endif // OPM_REGIONBATCHES_HEADER_INCLUDED
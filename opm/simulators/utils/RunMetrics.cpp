@@ -0,0 +1,153 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/utils/RunMetrics.hpp>
+
+#include <fmt/format.h>
+
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+
+double perWallHour(const double days, const double seconds)
+{
+    return seconds > 0.0 ? days / (seconds / 3600.0) : 0.0;
+}
+
+// the case name as a JSON string or a Prometheus label value
+std::string escaped(const std::string& s)
+{
+    std::string result;
+    result.reserve(s.size());
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        if (c == '\n') {
+            result += "\\n";
+            continue;
+        }
+        result += c;
+    }
+    return result;
+}
+
+bool endsWith(const std::string& s, const std::string& suffix)
+{
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+double RunMetrics::daysPerWallHour() const
+{
+    return perWallHour(simulatedDays, wallSeconds);
+}
+
+double RunMetrics::stepDaysPerWallHour() const
+{
+    return perWallHour(stepSimulatedDays, stepWallSeconds);
+}
+
+double RunMetrics::chopRate() const
+{
+    return substeps > 0 ? static_cast<double>(timeStepChops) / substeps : 0.0;
+}
+
+void RunMetrics::writeJson(std::ostream& os) const
+{
+    os << fmt::format("{{\"case\": \"{}\", \"report_step\": {}, \"report_steps\": {}, "
+                      "\"simulated_days\": {}, \"total_days\": {}, \"wall_seconds\": {}, "
+                      "\"days_per_wall_hour\": {}, \"step_days_per_wall_hour\": {}, ",
+                      escaped(caseName), reportStep, numReportSteps,
+                      simulatedDays, totalDays, wallSeconds,
+                      daysPerWallHour(), stepDaysPerWallHour());
+    os << fmt::format("\"substeps\": {}, \"time_step_chops\": {}, \"chop_rate\": {}, "
+                      "\"newton_iterations\": {}, \"linear_iterations\": {}, "
+                      "\"step_newton_iterations\": {}, \"step_linear_iterations\": {}, "
+                      "\"max_rss_kib\": {}, \"sum_rss_kib\": {}, \"output_queue_depth\": {}}}\n",
+                      substeps, timeStepChops, chopRate(),
+                      newtonIterations, linearIterations,
+                      stepNewtonIterations, stepLinearIterations,
+                      maxRss, sumRss, outputQueueDepth);
+}
+
+void RunMetrics::writePrometheus(std::ostream& os) const
+{
+    const std::string label = fmt::format("{{case=\"{}\"}}", escaped(caseName));
+    const auto metric = [&os, &label](const char* name, const char* type,
+                                      const char* help, const auto value)
+    {
+        os << fmt::format("# HELP opm_flow_{} {}\n# TYPE opm_flow_{} {}\nopm_flow_{}{} {}\n",
+                          name, help, name, type, name, label, value);
+    };
+    metric("report_step", "gauge", "The number of completed report steps.", reportStep);
+    metric("report_steps", "gauge", "The number of report steps of the run.", numReportSteps);
+    metric("simulated_days", "gauge", "The simulated time in days.", simulatedDays);
+    metric("total_days", "gauge", "The time to simulate in days.", totalDays);
+    metric("wall_seconds", "gauge", "The wall clock time of the simulation in seconds.", wallSeconds);
+    metric("days_per_wall_hour", "gauge", "Simulated days per wall clock hour since the start.",
+           daysPerWallHour());
+    metric("step_days_per_wall_hour", "gauge", "Simulated days per wall clock hour of the last report step.",
+           stepDaysPerWallHour());
+    metric("substeps_total", "counter", "The attempted time steps.", substeps);
+    metric("time_step_chops_total", "counter", "The chopped time steps.", timeStepChops);
+    metric("chop_rate", "gauge", "The fraction of the attempted time steps which were chopped.", chopRate());
+    metric("newton_iterations_total", "counter", "The Newton iterations.", newtonIterations);
+    metric("linear_iterations_total", "counter", "The linear iterations.", linearIterations);
+    metric("step_newton_iterations", "gauge", "The Newton iterations of the last report step.",
+           stepNewtonIterations);
+    metric("step_linear_iterations", "gauge", "The linear iterations of the last report step.",
+           stepLinearIterations);
+    metric("max_rss_bytes", "gauge", "The largest resident set size of a process.", 1024 * maxRss);
+    metric("sum_rss_bytes", "gauge", "The resident set size of all processes.", 1024 * sumRss);
+    metric("output_queue_depth", "gauge", "The report steps waiting for the output writer.", outputQueueDepth);
+}
+
+void RunMetrics::save(const std::string& fileName) const
+{
+    const std::string tmpName = fileName + ".tmp";
+    {
+        std::ofstream os(tmpName);
+        if (!os) {
+            throw std::runtime_error("Cannot write the metrics file " + tmpName);
+        }
+        if (endsWith(fileName, ".prom")) {
+            writePrometheus(os);
+        } else {
+            writeJson(os);
+        }
+        if (!os) {
+            throw std::runtime_error("Writing the metrics file " + tmpName + " failed");
+        }
+    }
+    if (std::rename(tmpName.c_str(), fileName.c_str()) != 0) {
+        throw std::runtime_error("Cannot replace the metrics file " + fileName);
+    }
+}
+
+} // namespace Opm
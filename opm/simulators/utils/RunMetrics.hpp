@@ -0,0 +1,80 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_RUN_METRICS_HEADER_INCLUDED
+#define OPM_RUN_METRICS_HEADER_INCLUDED
+
+#include <iosfwd>
+#include <string>
+
+namespace Opm
+{
+
+/// The progress, throughput and resource usage of a running simulation,
+/// which is written to a file after every report step, such that a job
+/// scheduler can watch long runs, e.g. through the textfile collector of
+/// the Prometheus node exporter.
+struct RunMetrics
+{
+    std::string caseName;
+    int reportStep = 0;
+    int numReportSteps = 0;
+    double simulatedDays = 0.0;
+    double totalDays = 0.0;
+    double wallSeconds = 0.0;
+    // of the last report step
+    double stepSimulatedDays = 0.0;
+    double stepWallSeconds = 0.0;
+
+    unsigned long substeps = 0;
+    unsigned long timeStepChops = 0;
+    unsigned long newtonIterations = 0;
+    unsigned long linearIterations = 0;
+    unsigned long stepNewtonIterations = 0;
+    unsigned long stepLinearIterations = 0;
+
+    // in KiB, over all processes
+    long maxRss = 0;
+    long sumRss = 0;
+    unsigned int outputQueueDepth = 0;
+
+    /// Simulated days per wall clock hour since the start, 0 before the first step.
+    double daysPerWallHour() const;
+
+    /// Simulated days per wall clock hour of the last report step.
+    double stepDaysPerWallHour() const;
+
+    /// The fraction of the attempted substeps which were chopped.
+    double chopRate() const;
+
+    void writeJson(std::ostream& os) const;
+
+    /// The Prometheus text exposition format, the metrics are prefixed with
+    /// opm_flow_ and labelled with the case name.
+    void writePrometheus(std::ostream& os) const;
+
+    /// Replace the file, in the Prometheus text format if the name ends with
+    /// .prom and as JSON otherwise. The file is written under a temporary
+    /// name and renamed, such that readers never see a partial file.
+    void save(const std::string& fileName) const;
+};
+
+} // namespace Opm
+
+#endif // OPM_RUN_METRICS_HEADER_INCLUDED
@@ -0,0 +1,183 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SCRATCHARENA_HEADER_INCLUDED
+#define OPM_SCRATCHARENA_HEADER_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace Opm
+{
+
+/// Memory for short lived temporaries, which is taken from large blocks and
+/// given back all at once by reset().
+///
+/// Memory which is freed in the reverse order of its allocation, e.g. the
+/// local vectors of nested function calls, is reused right away, the rest is
+/// only reused after reset(). reset() keeps one block of the size of all the
+/// blocks used since the last reset, such that an iteration which needs as
+/// much memory as the previous one does not allocate. Not thread safe, every
+/// thread needs its own arena.
+class ScratchArena
+{
+public:
+    explicit ScratchArena(const std::size_t blockSize = 64 * 1024)
+        : blockSize_(blockSize)
+    {
+    }
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+    ScratchArena(ScratchArena&&) = default;
+    ScratchArena& operator=(ScratchArena&&) = default;
+
+    void* allocate(const std::size_t bytes, const std::size_t alignment = alignof(std::max_align_t))
+    {
+        if (!blocks_.empty()) {
+            Block& block = blocks_.back();
+            const std::size_t offset = alignUp(block.data.get(), used_, alignment);
+            if (offset + bytes <= block.size) {
+                used_ = offset + bytes;
+                return block.data.get() + offset;
+            }
+        }
+        const std::size_t size = std::max(blockSize_, bytes + alignment);
+        blocks_.push_back({std::make_unique<char[]>(size), size});
+        totalSize_ += size;
+        Block& block = blocks_.back();
+        const std::size_t offset = alignUp(block.data.get(), 0, alignment);
+        used_ = offset + bytes;
+        return block.data.get() + offset;
+    }
+
+    /// Only the most recent allocation of the current block is given back,
+    /// the others stay used until reset().
+    void deallocate(void* ptr, const std::size_t bytes)
+    {
+        if (blocks_.empty()) {
+            return;
+        }
+        char* begin = blocks_.back().data.get();
+        if (static_cast<char*>(ptr) + bytes == begin + used_) {
+            used_ = static_cast<char*>(ptr) - begin;
+        }
+    }
+
+    /// Give back all the memory, nothing allocated from the arena may be used
+    /// afterwards.
+    void reset()
+    {
+        if (blocks_.size() > 1) {
+            blocks_.clear();
+            blocks_.push_back({std::make_unique<char[]>(totalSize_), totalSize_});
+        }
+        used_ = 0;
+    }
+
+    /// The bytes of the blocks.
+    std::size_t capacity() const
+    { return totalSize_; }
+
+    std::size_t numBlocks() const
+    { return blocks_.size(); }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    static std::size_t alignUp(const char* base, const std::size_t offset, const std::size_t alignment)
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(base) + offset;
+        const auto aligned = (address + alignment - 1) / alignment * alignment;
+        return offset + (aligned - address);
+    }
+
+    std::size_t blockSize_;
+    std::vector<Block> blocks_;
+    std::size_t totalSize_ = 0;
+    std::size_t used_ = 0;
+};
+
+/// An allocator which takes its memory from a ScratchArena, or from the heap
+/// if it has none.
+template <class T>
+class ScratchAllocator
+{
+public:
+    using value_type = T;
+
+    ScratchAllocator() noexcept = default;
+
+    explicit ScratchAllocator(ScratchArena* arena) noexcept
+        : arena_(arena)
+    {
+    }
+
+    template <class U>
+    ScratchAllocator(const ScratchAllocator<U>& other) noexcept
+        : arena_(other.arena())
+    {
+    }
+
+    T* allocate(const std::size_t n)
+    {
+        if (arena_ == nullptr) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, const std::size_t n) noexcept
+    {
+        if (arena_ == nullptr) {
+            ::operator delete(ptr);
+        } else {
+            arena_->deallocate(ptr, n * sizeof(T));
+        }
+    }
+
+    ScratchArena* arena() const noexcept
+    { return arena_; }
+
+    template <class U>
+    bool operator==(const ScratchAllocator<U>& other) const noexcept
+    { return arena_ == other.arena(); }
+
+    template <class U>
+    bool operator!=(const ScratchAllocator<U>& other) const noexcept
+    { return arena_ != other.arena(); }
+
+private:
+    ScratchArena* arena_ = nullptr;
+};
+
+template <class T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+} // namespace Opm
+
+#endif // OPM_SCRATCHARENA_HEADER_INCLUDED
@@ -0,0 +1,186 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/utils/StartupProfile.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace
+{
+
+struct PhaseRecord
+{
+    std::string name;
+    double seconds = 0.0;
+    long rssIncrease = 0;
+    long peakRss = 0;
+};
+
+std::vector<PhaseRecord>& phaseRecords()
+{
+    static std::vector<PhaseRecord> records;
+    return records;
+}
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+StartupProfile::Phase::Phase(const std::string& name)
+    : name_(name)
+    , start_(std::chrono::steady_clock::now())
+    , rssStart_(currentRss())
+{
+}
+
+StartupProfile::Phase::~Phase()
+{
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+    record(name_, elapsed.count(), currentRss() - rssStart_, peakRss());
+}
+
+void StartupProfile::record(const std::string& name, double seconds, long rssIncrease, long peakRss)
+{
+    auto& records = phaseRecords();
+    auto it = std::find_if(records.begin(), records.end(),
+                           [&name](const PhaseRecord& r) { return r.name == name; });
+    if (it == records.end()) {
+        records.push_back({name, 0.0, 0, 0});
+        it = records.end() - 1;
+    }
+    it->seconds += seconds;
+    it->rssIncrease += rssIncrease;
+    it->peakRss = std::max(it->peakRss, peakRss);
+}
+
+long StartupProfile::currentRss()
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0;
+    long residentPages = 0;
+    if (statm >> pages >> residentPages) {
+        return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+#endif
+    return 0;
+}
+
+long StartupProfile::peakRss()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // bytes
+#else
+    return usage.ru_maxrss; // KiB
+#endif
+}
+
+void StartupProfile::writeJson(const std::string& fileName, const Communication& comm)
+{
+    const auto& records = phaseRecords();
+
+    // the phases of rank 0 define the list, in the order they were entered
+    std::string names;
+    if (comm.rank() == 0) {
+        for (const auto& r : records) {
+            names += r.name + '\n';
+        }
+    }
+    int size = names.size();
+    comm.broadcast(&size, 1, 0);
+    names.resize(size);
+    comm.broadcast(names.data(), size, 0);
+
+    std::vector<std::string> phases;
+    {
+        std::istringstream is(names);
+        std::string name;
+        while (std::getline(is, name)) {
+            phases.push_back(name);
+        }
+    }
+
+    const std::size_t n = phases.size();
+    std::vector<double> minTime(n, std::numeric_limits<double>::max());
+    std::vector<double> maxTime(n, 0.0);
+    std::vector<double> sumTime(n, 0.0);
+    std::vector<int> count(n, 0);
+    std::vector<long> minPeak(n, std::numeric_limits<long>::max());
+    std::vector<long> maxPeak(n, 0);
+    std::vector<long> maxIncrease(n, std::numeric_limits<long>::lowest());
+    for (std::size_t i = 0; i < n; ++i) {
+        auto it = std::find_if(records.begin(), records.end(),
+                               [&phases, i](const PhaseRecord& r) { return r.name == phases[i]; });
+        if (it == records.end()) {
+            continue;
+        }
+        minTime[i] = maxTime[i] = sumTime[i] = it->seconds;
+        count[i] = 1;
+        minPeak[i] = maxPeak[i] = it->peakRss;
+        maxIncrease[i] = it->rssIncrease;
+    }
+    if (n > 0) {
+        comm.min(minTime.data(), n);
+        comm.max(maxTime.data(), n);
+        comm.sum(sumTime.data(), n);
+        comm.sum(count.data(), n);
+        comm.min(minPeak.data(), n);
+        comm.max(maxPeak.data(), n);
+        comm.max(maxIncrease.data(), n);
+    }
+
+    if (comm.rank() != 0) {
+        return;
+    }
+
+    std::ofstream os(fileName);
+    os << "{\n";
+    os << fmt::format("  \"processes\": {},\n", comm.size());
+    os << "  \"phases\": [";
+    for (std::size_t i = 0; i < n; ++i) {
+        const double mean = sumTime[i] / std::max(count[i], 1);
+        os << (i == 0 ? "\n" : ",\n");
+        os << "    {\n";
+        os << fmt::format("      \"name\": \"{}\",\n", phases[i]);
+        os << fmt::format("      \"processes\": {},\n", count[i]);
+        os << fmt::format("      \"wall_time\": {{ \"min\": {:.6f}, \"max\": {:.6f}, \"mean\": {:.6f}, \"imbalance\": {:.4f} }},\n",
+                          minTime[i], maxTime[i], mean, mean > 0.0 ? maxTime[i] / mean : 1.0);
+        os << fmt::format("      \"peak_rss_kib\": {{ \"min\": {}, \"max\": {} }},\n", minPeak[i], maxPeak[i]);
+        os << fmt::format("      \"rss_increase_kib\": {{ \"max\": {} }}\n", maxIncrease[i]);
+        os << "    }";
+    }
+    os << "\n  ]\n}\n";
+}
+
+} // namespace Opm
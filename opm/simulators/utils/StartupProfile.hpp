@@ -0,0 +1,75 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_STARTUP_PROFILE_HEADER_INCLUDED
+#define OPM_STARTUP_PROFILE_HEADER_INCLUDED
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <chrono>
+#include <string>
+
+namespace Opm
+{
+
+/// Records the wall time and memory usage of the phases of the simulator
+/// startup (deck reading, grid processing, load balancing, ...), such that
+/// they can be written to a JSON file once the setup is complete.
+///
+/// A phase which is entered several times on a process accumulates its
+/// times. Phases are matched between processes by their names.
+class StartupProfile
+{
+public:
+    using Communication = Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>;
+
+    /// Measures the phase from construction to destruction.
+    class Phase
+    {
+    public:
+        explicit Phase(const std::string& name);
+        ~Phase();
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+    private:
+        std::string name_;
+        std::chrono::steady_clock::time_point start_;
+        long rssStart_;
+    };
+
+    /// Add the measurement of one phase on this process.
+    static void record(const std::string& name, double seconds, long rssIncrease, long peakRss);
+
+    /// Write all phases as JSON, with the minimum, maximum and mean over the
+    /// processes and the imbalance max/mean of the wall time.
+    /// This is collective, only the process with rank 0 writes the file.
+    static void writeJson(const std::string& fileName, const Communication& comm);
+
+    /// Resident set size of this process in KiB, 0 if unknown.
+    static long currentRss();
+
+    /// Peak resident set size of this process in KiB, 0 if unknown.
+    static long peakRss();
+};
+
+} // namespace Opm
+
+#endif // OPM_STARTUP_PROFILE_HEADER_INCLUDED
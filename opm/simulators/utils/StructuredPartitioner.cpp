@@ -0,0 +1,164 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/utils/StructuredPartitioner.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace Opm
+{
+
+namespace
+{
+
+// A set of columns which go to the same part.
+struct ColumnUnit
+{
+    double weight = 0.0;
+    double i = 0.0;
+    double j = 0.0;
+};
+
+int findRoot(std::vector<int>& parent, int column)
+{
+    while (parent[column] != column) {
+        parent[column] = parent[parent[column]];
+        column = parent[column];
+    }
+    return column;
+}
+
+void bisect(const std::vector<ColumnUnit>& units,
+            std::vector<int>::iterator begin,
+            std::vector<int>::iterator end,
+            const int firstPart,
+            const int numParts,
+            std::vector<int>& unitPart)
+{
+    if (numParts == 1 || end - begin <= 1) {
+        for (auto it = begin; it != end; ++it) {
+            unitPart[*it] = firstPart;
+        }
+        return;
+    }
+
+    // split along the longer extent of the column centres
+    double minI = std::numeric_limits<double>::max(), maxI = std::numeric_limits<double>::lowest();
+    double minJ = minI, maxJ = maxI;
+    double total = 0.0;
+    for (auto it = begin; it != end; ++it) {
+        const auto& unit = units[*it];
+        minI = std::min(minI, unit.i);
+        maxI = std::max(maxI, unit.i);
+        minJ = std::min(minJ, unit.j);
+        maxJ = std::max(maxJ, unit.j);
+        total += unit.weight;
+    }
+    const bool alongI = maxI - minI >= maxJ - minJ;
+    std::sort(begin, end, [&units, alongI](const int a, const int b) {
+        const double ca = alongI ? units[a].i : units[a].j;
+        const double cb = alongI ? units[b].i : units[b].j;
+        return ca < cb || (ca == cb && a < b);
+    });
+
+    // the split which comes closest to the share of the first half of the
+    // parts, leaving at least one unit on each side
+    const int leftParts = numParts / 2;
+    const double target = total * leftParts / numParts;
+    auto split = begin + 1;
+    double left = units[*begin].weight;
+    while (split + 1 != end
+           && std::abs(left + units[*split].weight - target) < std::abs(left - target)) {
+        left += units[*split].weight;
+        ++split;
+    }
+
+    bisect(units, begin, split, firstPart, leftParts, unitPart);
+    bisect(units, split, end, firstPart + leftParts, numParts - leftParts, unitPart);
+}
+
+} // anonymous namespace
+
+std::vector<int> structuredColumnPartition(const std::array<int, 3>& cartDims,
+                                           const std::vector<int>& cartesianIndices,
+                                           const int numParts,
+                                           const std::vector<std::vector<int>>& wellCells)
+{
+    if (numParts < 1) {
+        throw std::invalid_argument("The number of parts must be positive");
+    }
+
+    const int numColumns = cartDims[0] * cartDims[1];
+    std::vector<int> parent(numColumns);
+    std::iota(parent.begin(), parent.end(), 0);
+
+    // keep the columns of each well together
+    for (const auto& cells : wellCells) {
+        if (cells.empty()) {
+            continue;
+        }
+        const int first = findRoot(parent, cells.front() % numColumns);
+        for (const int cell : cells) {
+            const int root = findRoot(parent, cell % numColumns);
+            if (root != first) {
+                parent[root] = first;
+            }
+        }
+    }
+
+    std::vector<int> columnUnit(numColumns, -1);
+    std::vector<ColumnUnit> units;
+    std::vector<int> cellUnit(cartesianIndices.size());
+    for (std::size_t cell = 0; cell < cartesianIndices.size(); ++cell) {
+        const int column = cartesianIndices[cell] % numColumns;
+        const int root = findRoot(parent, column);
+        if (columnUnit[root] < 0) {
+            columnUnit[root] = units.size();
+            units.emplace_back();
+        }
+        auto& unit = units[columnUnit[root]];
+        unit.weight += 1.0;
+        unit.i += column % cartDims[0];
+        unit.j += column / cartDims[0];
+        cellUnit[cell] = columnUnit[root];
+    }
+    for (auto& unit : units) {
+        unit.i /= unit.weight;
+        unit.j /= unit.weight;
+    }
+
+    std::vector<int> order(units.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<int> unitPart(units.size(), 0);
+    bisect(units, order.begin(), order.end(), 0, numParts, unitPart);
+
+    std::vector<int> parts(cartesianIndices.size());
+    for (std::size_t cell = 0; cell < cartesianIndices.size(); ++cell) {
+        parts[cell] = unitPart[cellUnit[cell]];
+    }
+    return parts;
+}
+
+} // namespace Opm
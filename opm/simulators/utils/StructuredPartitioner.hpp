@@ -0,0 +1,48 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_STRUCTUREDPARTITIONER_HEADER_INCLUDED
+#define OPM_STRUCTUREDPARTITIONER_HEADER_INCLUDED
+
+#include <array>
+#include <vector>
+
+namespace Opm
+{
+
+/// Partition the active cells of a Cartesian-like grid by recursive
+/// coordinate bisection of its (I,J) columns. Each column is kept whole, and
+/// the columns connected by a well are kept together, such that no well is
+/// split. The parts are balanced by the number of active cells. This needs
+/// no graph of the grid and is much cheaper than a graph partitioner, at the
+/// price of ignoring the transmissibilities.
+///
+/// \param cartDims          the Cartesian dimensions of the grid
+/// \param cartesianIndices  the Cartesian index of each active cell
+/// \param numParts          the number of parts
+/// \param wellCells         the Cartesian indices of the connections of each well
+/// \return the part of each active cell, in [0, numParts)
+std::vector<int> structuredColumnPartition(const std::array<int, 3>& cartDims,
+                                           const std::vector<int>& cartesianIndices,
+                                           int numParts,
+                                           const std::vector<std::vector<int>>& wellCells = {});
+
+} // namespace Opm
+
+#endif // OPM_STRUCTUREDPARTITIONER_HEADER_INCLUDED
@@ -0,0 +1,193 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/utils/Tracing.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+struct Event
+{
+    const char* name;
+    std::int64_t begin;
+    std::int64_t end;
+};
+
+struct ThreadBuffer
+{
+    std::vector<Event> events;
+    std::size_t next = 0;
+    std::size_t recorded = 0;
+};
+
+struct TraceState
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::size_t capacity = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::atomic<bool> enabled{false};
+};
+
+TraceState& traceState()
+{
+    static TraceState state;
+    return state;
+}
+
+// The buffers live until the end of the program, such that the buffer of a
+// thread stays valid after start() was called again.
+ThreadBuffer& threadBuffer()
+{
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        auto& state = traceState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = state.buffers.back().get();
+        buffer->events.resize(state.capacity);
+    }
+    return *buffer;
+}
+
+// Escape the characters of a name which are not allowed in JSON strings.
+std::string jsonString(const char* name)
+{
+    std::string result;
+    for (const char* c = name; *c; ++c) {
+        if (*c == '"' || *c == '\\')
+            result += '\\';
+        result += *c;
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+namespace Opm
+{
+
+void Tracing::start(const std::size_t eventsPerThread, const Communication& comm)
+{
+    auto& state = traceState();
+    state.enabled = false;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.capacity = eventsPerThread;
+        for (auto& buffer : state.buffers) {
+            buffer->events.assign(eventsPerThread, Event{});
+            buffer->next = 0;
+            buffer->recorded = 0;
+        }
+    }
+    comm.barrier();
+    state.start = std::chrono::steady_clock::now();
+    state.enabled = eventsPerThread > 0;
+}
+
+void Tracing::stop()
+{
+    traceState().enabled = false;
+}
+
+bool Tracing::enabled()
+{
+    return traceState().enabled.load(std::memory_order_relaxed);
+}
+
+std::int64_t Tracing::now()
+{
+    const auto elapsed = std::chrono::steady_clock::now() - traceState().start;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void Tracing::record(const char* name, const std::int64_t begin, const std::int64_t end)
+{
+    auto& buffer = threadBuffer();
+    if (buffer.events.empty())
+        return;
+    buffer.events[buffer.next] = Event{name, begin, end};
+    buffer.next = (buffer.next + 1) % buffer.events.size();
+    ++buffer.recorded;
+}
+
+void Tracing::writeChromeTrace(const std::string& fileName, const Communication& comm)
+{
+    const int rank = comm.rank();
+
+    // the events of this process as a list of JSON objects, each followed by a comma
+    std::string local;
+    std::size_t dropped = 0;
+    {
+        auto& state = traceState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (std::size_t tid = 0; tid < state.buffers.size(); ++tid) {
+            const auto& buffer = *state.buffers[tid];
+            const std::size_t size = buffer.events.size();
+            const std::size_t count = std::min(buffer.recorded, size);
+            dropped += buffer.recorded - count;
+            // the oldest event is at next once the buffer has wrapped around
+            const std::size_t first = buffer.recorded > size ? buffer.next : 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto& event = buffer.events[(first + i) % size];
+                local += fmt::format("{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}},\n",
+                                     jsonString(event.name), rank, tid,
+                                     event.begin * 1e-3, (event.end - event.begin) * 1e-3);
+            }
+        }
+    }
+    local += fmt::format("{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"name\":\"rank {}\"}}}},\n",
+                         rank, rank);
+    local += fmt::format("{{\"name\":\"dropped_events\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"count\":{}}}}},\n",
+                         rank, dropped);
+
+    int size = local.size();
+    std::vector<int> sizes(comm.size());
+    comm.gather(&size, sizes.data(), 1, 0);
+    std::vector<int> displacements(comm.size() + 1, 0);
+    for (int r = 0; r < comm.size(); ++r)
+        displacements[r + 1] = displacements[r] + sizes[r];
+    std::string all(rank == 0 ? displacements.back() : 0, ' ');
+    comm.gatherv(local.data(), size, all.data(), sizes.data(), displacements.data(), 0);
+
+    if (rank != 0)
+        return;
+
+    // drop the comma after the last event
+    all.resize(all.size() - 2);
+    std::ofstream os(fileName);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" << all << "\n]}\n";
+    if (!os) {
+        throw std::runtime_error("Could not write the trace to " + fileName);
+    }
+}
+
+} // namespace Opm
@@ -0,0 +1,105 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_TRACING_HEADER_INCLUDED
+#define OPM_TRACING_HEADER_INCLUDED
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Opm
+{
+
+/// Records the begin and end of scopes in the hot paths of the simulator,
+/// such that the Newton iterations, the waiting in the collectives and the
+/// load imbalance between the processes can be inspected in a trace viewer.
+///
+/// Every thread records into its own ring buffer of fixed capacity, so the
+/// recording needs no locking and the oldest events are overwritten when the
+/// buffer is full. The events of all processes are written in the Chrome
+/// trace event format, which is read by chrome://tracing and Perfetto.
+///
+/// The scopes are compiled in with the ENABLE_TRACING CMake option only, see
+/// OPM_TRACE_SCOPE(). Otherwise nothing is recorded.
+class Tracing
+{
+public:
+    using Communication = Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>;
+
+    /// Records the scope from construction to destruction. The name must be
+    /// a string literal, only the pointer is stored.
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name)
+            : name_(enabled() ? name : nullptr)
+            , begin_(name_ ? now() : 0)
+        {}
+
+        ~Scope()
+        {
+            if (name_)
+                record(name_, begin_, now());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name_;
+        std::int64_t begin_;
+    };
+
+    /// Start recording with the given number of events per thread, the
+    /// events recorded before are dropped. This is collective, the clocks
+    /// of the processes are aligned at the start.
+    static void start(std::size_t eventsPerThread, const Communication& comm);
+
+    /// Stop recording, the recorded events are kept until the next start().
+    static void stop();
+
+    static bool enabled();
+
+    /// Nanoseconds since start().
+    static std::int64_t now();
+
+    /// Add an event of this thread, with the times from now().
+    static void record(const char* name, std::int64_t begin, std::int64_t end);
+
+    /// Write the events of all processes to a JSON file in the Chrome trace
+    /// event format. The process id of the events is the rank. This is
+    /// collective, only the process with rank 0 writes the file.
+    static void writeChromeTrace(const std::string& fileName, const Communication& comm);
+};
+
+} // namespace Opm
+
+#define OPM_TRACE_CONCAT_IMPL(a, b) a##b
+#define OPM_TRACE_CONCAT(a, b) OPM_TRACE_CONCAT_IMPL(a, b)
+
+#if HAVE_TRACING
+#define OPM_TRACE_SCOPE(name) ::Opm::Tracing::Scope OPM_TRACE_CONCAT(opmTraceScope, __LINE__)(name)
+#else
+#define OPM_TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif // OPM_TRACING_HEADER_INCLUDED
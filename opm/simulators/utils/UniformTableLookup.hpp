@@ -0,0 +1,153 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_UNIFORMTABLELOOKUP_HEADER_INCLUDED
+#define OPM_UNIFORMTABLELOOKUP_HEADER_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+/// A piecewise linear function of a table, e.g. a column of a MISC, MSFN or
+/// SSFN table, with a constant time lookup of the segment.
+///
+/// The range of the table is covered by a uniform grid of buckets, each of
+/// which stores the first segment overlapping it, and the slopes of the
+/// segments are computed once. Unless the grid is capped, the buckets are
+/// not wider than the shortest segment, such that the segment of a point is
+/// the one of its bucket or the next one. The values are the same as the
+/// ones of the linear interpolation of the table.
+class UniformTableLookup
+{
+public:
+    UniformTableLookup() = default;
+
+    /// \param x  the strictly increasing sampling points, at least two
+    /// \param y  the values at the sampling points
+    /// \param maxBuckets  the maximum number of buckets
+    UniformTableLookup(const std::vector<double>& x, const std::vector<double>& y,
+                       const std::size_t maxBuckets = 1 << 16)
+        : x_(x)
+        , y_(y)
+    {
+        if (x_.size() < 2 || x_.size() != y_.size()) {
+            throw std::invalid_argument("A table lookup needs at least two sampling points and one value for each");
+        }
+        double minSpacing = x_.back() - x_.front();
+        slope_.resize(x_.size() - 1);
+        for (std::size_t i = 0; i + 1 < x_.size(); ++i) {
+            const double dx = x_[i + 1] - x_[i];
+            if (!(dx > 0.0)) {
+                throw std::invalid_argument("The sampling points of a table lookup must be strictly increasing");
+            }
+            minSpacing = std::min(minSpacing, dx);
+            slope_[i] = (y_[i + 1] - y_[i]) / dx;
+        }
+
+        const double range = x_.back() - x_.front();
+        const double wanted = std::ceil(range / minSpacing);
+        const std::size_t numBuckets = std::clamp<std::size_t>(static_cast<std::size_t>(wanted), 1, maxBuckets);
+        invBucketWidth_ = numBuckets / range;
+        bucketSegment_.resize(numBuckets);
+        std::size_t segment = 0;
+        for (std::size_t b = 0; b < numBuckets; ++b) {
+            const double left = x_.front() + b / invBucketWidth_;
+            while (segment + 2 < x_.size() && x_[segment + 1] <= left) {
+                ++segment;
+            }
+            bucketSegment_[b] = segment;
+        }
+    }
+
+    double xMin() const
+    { return x_.front(); }
+
+    double xMax() const
+    { return x_.back(); }
+
+    std::size_t numBuckets() const
+    { return bucketSegment_.size(); }
+
+    /// The index of the segment containing x, the first or last one outside of
+    /// the range.
+    std::size_t segment(const double x) const
+    {
+        const double pos = (x - x_.front()) * invBucketWidth_;
+        const double maxPos = static_cast<double>(bucketSegment_.size() - 1);
+        const std::size_t bucket = static_cast<std::size_t>(std::clamp(pos, 0.0, maxPos));
+        std::size_t seg = bucketSegment_[bucket];
+        // at most one step if the buckets are not wider than the segments
+        while (seg + 2 < x_.size() && x >= x_[seg + 1]) {
+            ++seg;
+        }
+        return seg;
+    }
+
+    /// The value at x, for a scalar or an automatic differentiation type.
+    /// \param extrapolate  extend the first and last segments beyond the
+    ///                     range, otherwise the end values are used there
+    template <class Evaluation>
+    Evaluation eval(const Evaluation& x, const bool extrapolate = false) const
+    {
+        const double xValue = scalarValue_(x);
+        if (!extrapolate) {
+            if (xValue <= x_.front()) {
+                return Evaluation(y_.front());
+            }
+            if (xValue >= x_.back()) {
+                return Evaluation(y_.back());
+            }
+        }
+        const std::size_t seg = segment(xValue);
+        return (x - x_[seg]) * slope_[seg] + y_[seg];
+    }
+
+    /// The derivative with respect to x at x, zero outside of the range unless
+    /// extrapolated.
+    double evalDerivative(const double x, const bool extrapolate = false) const
+    {
+        if (!extrapolate && (x < x_.front() || x > x_.back())) {
+            return 0.0;
+        }
+        return slope_[segment(x)];
+    }
+
+private:
+    static double scalarValue_(const double x)
+    { return x; }
+
+    template <class Evaluation>
+    static double scalarValue_(const Evaluation& x)
+    { return x.value(); }
+
+    std::vector<double> x_;
+    std::vector<double> y_;
+    std::vector<double> slope_;
+    std::vector<std::size_t> bucketSegment_;
+    double invBucketWidth_ = 0.0;
+};
+
+} // namespace Opm
+
+#endif // OPM_UNIFORMTABLELOOKUP_HEADER_INCLUDED
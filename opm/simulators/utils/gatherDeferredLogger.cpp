@@ -24,76 +24,42 @@
 
 #if HAVE_MPI
 
-#include <cassert>
-#include <cstdint>
-#include <numeric>
+#include <opm/simulators/utils/CompactBuffer.hpp>
+
 #include <mpi.h>
 
+#include <cstdint>
+#include <utility>
+
 namespace
 {
 
-    void packMessages(const std::vector<Opm::DeferredLogger::Message>& local_messages, std::vector<char>& buf, int& offset)
+    // the messages of a process are written one after the other, the buffer of a
+    // process without messages is empty
+    std::vector<char> packMessages(const std::vector<Opm::DeferredLogger::Message>& local_messages)
     {
-
-        int messagesize = local_messages.size();
-        MPI_Pack(&messagesize, 1, MPI_UNSIGNED, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-
+        Opm::CompactBufferWriter writer;
         for (const auto& lm : local_messages) {
-            MPI_Pack(static_cast<void*>(const_cast<std::int64_t*>(&lm.flag)), 1, MPI_INT64_T, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-            int tagsize = lm.tag.size();
-            MPI_Pack(&tagsize, 1, MPI_UNSIGNED, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-            if (tagsize>0) {
-                MPI_Pack(const_cast<char*>(lm.tag.c_str()), lm.tag.size(), MPI_CHAR, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-            }
-            int textsize = lm.text.size();
-            MPI_Pack(&textsize, 1, MPI_UNSIGNED, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-            if (textsize>0) {
-                MPI_Pack(const_cast<char*>(lm.text.c_str()), lm.text.size(), MPI_CHAR, buf.data(), buf.size(), &offset, MPI_COMM_WORLD);
-            }
+            writer.writeSigned(lm.flag);
+            writer.writeInterned(lm.tag);
+            writer.writeString(lm.text);
         }
-    }
-
-    Opm::DeferredLogger::Message unpackSingleMessage(const std::vector<char>& recv_buffer, int& offset)
-    {
-        int64_t flag;
-        auto* data = const_cast<char*>(recv_buffer.data());
-        MPI_Unpack(data, recv_buffer.size(), &offset, &flag, 1, MPI_INT64_T, MPI_COMM_WORLD);
-
-        // unpack tag
-        unsigned int tagsize;
-        MPI_Unpack(data, recv_buffer.size(), &offset, &tagsize, 1, MPI_UNSIGNED, MPI_COMM_WORLD);
-        std::string tag;
-        if (tagsize>0) {
-            std::vector<char> tagchars(tagsize);
-            MPI_Unpack(data, recv_buffer.size(), &offset, tagchars.data(), tagsize, MPI_CHAR, MPI_COMM_WORLD);
-            tag = std::string(tagchars.data(), tagsize);
-        }
-        // unpack text
-        unsigned int textsize;
-        MPI_Unpack(data, recv_buffer.size(), &offset, &textsize, 1, MPI_UNSIGNED, MPI_COMM_WORLD);
-        std::string text;
-        if (textsize>0) {
-            std::vector<char> textchars(textsize);
-            MPI_Unpack(data, recv_buffer.size(), &offset, textchars.data(), textsize, MPI_CHAR, MPI_COMM_WORLD);
-            text = std::string (textchars.data(), textsize);
-        }
-        return Opm::DeferredLogger::Message({flag, tag, text});
+        return writer.buffer();
     }
 
     std::vector<Opm::DeferredLogger::Message> unpackMessages(const std::vector<char>& recv_buffer, const std::vector<int>& displ)
     {
         std::vector<Opm::DeferredLogger::Message> messages;
         const int num_processes = displ.size() - 1;
-        auto* data = const_cast<char*>(recv_buffer.data());
         for (int process = 0; process < num_processes; ++process) {
-            int offset = displ[process];
-            // unpack number of messages
-            unsigned int messagesize;
-            MPI_Unpack(data, recv_buffer.size(), &offset, &messagesize, 1, MPI_UNSIGNED, MPI_COMM_WORLD);
-            for (unsigned int i=0; i<messagesize; i++) {
-                messages.push_back(unpackSingleMessage(recv_buffer, offset));
+            Opm::CompactBufferReader reader(recv_buffer.data() + displ[process],
+                                            recv_buffer.data() + displ[process + 1]);
+            while (!reader.atEnd()) {
+                const std::int64_t flag = reader.readSigned();
+                std::string tag = reader.readInterned();
+                std::string text = reader.readString();
+                messages.push_back({flag, std::move(tag), std::move(text)});
             }
-            assert(offset == displ[process + 1]);
         }
         return messages;
     }
@@ -107,52 +73,11 @@ namespace Opm
     /// combine (per-process) messages
     Opm::DeferredLogger gatherDeferredLogger(const Opm::DeferredLogger& local_deferredlogger)
     {
+        const std::vector<char> buffer = packMessages(local_deferredlogger.messages_);
 
-        int num_messages = local_deferredlogger.messages_.size();
-
-        int int64_mpi_pack_size;
-        MPI_Pack_size(1, MPI_INT64_T, MPI_COMM_WORLD, &int64_mpi_pack_size);
-        int unsigned_int_mpi_pack_size;
-        MPI_Pack_size(1, MPI_UNSIGNED, MPI_COMM_WORLD, &unsigned_int_mpi_pack_size);
-
-        // store number of messages;
-        int message_size = unsigned_int_mpi_pack_size;
-        // store 1 int64 per message for flag
-        message_size += num_messages*int64_mpi_pack_size;
-        // store 2 unsigned ints per message for length of tag and length of text
-        message_size += num_messages*2*unsigned_int_mpi_pack_size;
-
-        for (const auto& lm : local_deferredlogger.messages_) {
-            int string_mpi_pack_size;
-            MPI_Pack_size(lm.tag.size(), MPI_CHAR, MPI_COMM_WORLD, &string_mpi_pack_size);
-            message_size += string_mpi_pack_size;
-            MPI_Pack_size(lm.text.size(), MPI_CHAR, MPI_COMM_WORLD, &string_mpi_pack_size);
-            message_size += string_mpi_pack_size;
-        }
+        std::vector<int> displ;
+        const std::vector<char> recv_buffer = allGatherCompactBuffers(buffer, displ);
 
-        // Pack local messages.
-        std::vector<char> buffer(message_size);
-
-        int offset = 0;
-        packMessages(local_deferredlogger.messages_, buffer, offset);
-        assert(offset == message_size);
-
-        // Get message sizes and create offset/displacement array for gathering.
-        int num_processes = -1;
-        MPI_Comm_size(MPI_COMM_WORLD, &num_processes);
-        std::vector<int> message_sizes(num_processes);
-        MPI_Allgather(&message_size, 1, MPI_INT, message_sizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
-        std::vector<int> displ(num_processes + 1, 0);
-        std::partial_sum(message_sizes.begin(), message_sizes.end(), displ.begin() + 1);
-
-        // Gather.
-        std::vector<char> recv_buffer(displ.back());
-        MPI_Allgatherv(buffer.data(), buffer.size(), MPI_PACKED,
-                       const_cast<char*>(recv_buffer.data()), message_sizes.data(),
-                       displ.data(), MPI_PACKED,
-                       MPI_COMM_WORLD);
-
-        // Unpack.
         Opm::DeferredLogger global_deferredlogger;
         global_deferredlogger.messages_ = unpackMessages(recv_buffer, displ);
         return global_deferredlogger;
@@ -54,6 +54,7 @@
 
 #include <opm/simulators/utils/ParallelEclipseState.hpp>
 #include <opm/simulators/utils/ParallelSerialization.hpp>
+#include <opm/simulators/utils/StartupProfile.hpp>
 
 #include <fmt/format.h>
 
@@ -186,6 +187,8 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
               std::unique_ptr<ErrorGuard> errorGuard, std::shared_ptr<Opm::Python>& python, std::unique_ptr<ParseContext> parseContext,
               bool initFromRestart, bool checkDeck, const std::optional<int>& outputInterval)
 {
+    StartupProfile::Phase profilePhase("read deck");
+
     if (!errorGuard)
     {
         errorGuard = std::make_unique<ErrorGuard>();
@@ -193,6 +196,17 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
 
     int parseSuccess = 1; // > 0 is success
     std::string failureMessage;
+    auto comm = Dune::MPIHelper::getCollectiveCommunication();
+
+#if HAVE_MPI
+    auto broadcastFailed = [&failureMessage, &parseSuccess](const std::exception& broadcast_error)
+    {
+        failureMessage = broadcast_error.what();
+        OpmLog::error(fmt::format("Distributing properties to all processes failed\n"
+                                  "Internal error message: {}", broadcast_error.what()));
+        parseSuccess = 0;
+    };
+#endif
 
     if (rank==0) {
         try
@@ -224,6 +238,46 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
                 eclipseState = std::make_unique<Opm::EclipseState>(*deck);
 #endif
             }
+        }
+        catch(const OpmInputError& input_error) {
+            failureMessage = input_error.what();
+            parseSuccess = 0;
+        }
+        catch(const std::exception& std_error)
+        {
+            failureMessage = std_error.what();
+            parseSuccess = 0;
+        }
+    }
+#if HAVE_MPI
+    else {
+        if (!summaryConfig)
+            summaryConfig = std::make_unique<Opm::SummaryConfig>();
+        if (!schedule)
+            schedule = std::make_unique<Opm::Schedule>(python);
+        if (!eclipseState)
+            eclipseState = std::make_unique<Opm::ParallelEclipseState>();
+    }
+
+    // The eclipse state is distributed before the schedule is set up, the
+    // other processes unpack it while the root process works through the
+    // SCHEDULE section.
+    parseSuccess = comm.min(parseSuccess);
+    if (parseSuccess) {
+        try
+        {
+            Opm::eclStateBroadcast(*eclipseState);
+        }
+        catch(const std::exception& broadcast_error)
+        {
+            broadcastFailed(broadcast_error);
+        }
+    }
+#endif
+
+    if (rank==0 && parseSuccess) {
+        try
+        {
             /*
               For the time being initializing wells and groups from the
               restart file is not possible, but work is underways and it is
@@ -263,27 +317,17 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
         }
     }
 #if HAVE_MPI
-    else {
-        if (!summaryConfig)
-            summaryConfig = std::make_unique<Opm::SummaryConfig>();
-        if (!schedule)
-            schedule = std::make_unique<Opm::Schedule>(python);
-        if (!eclipseState)
-            eclipseState = std::make_unique<Opm::ParallelEclipseState>();
-    }
-
-    try
-    {
-        Opm::eclStateBroadcast(*eclipseState, *schedule, *summaryConfig);
-    }
-    catch(const std::exception& broadcast_error)
-    {
-        failureMessage = broadcast_error.what();
-        OpmLog::error(fmt::format("Distributing properties to all processes failed\n"
-                                  "Internal error message: {}", broadcast_error.what()));
-        parseSuccess = 0;
+    parseSuccess = comm.min(parseSuccess);
+    if (parseSuccess) {
+        try
+        {
+            Opm::eclScheduleBroadcast(*schedule, *summaryConfig);
+        }
+        catch(const std::exception& broadcast_error)
+        {
+            broadcastFailed(broadcast_error);
+        }
     }
-
 #endif
 
     if (*errorGuard) { // errors encountered
@@ -292,8 +336,6 @@ void readDeck(int rank, std::string& deckFilename, std::unique_ptr<Opm::Deck>& d
         errorGuard->clear();
     }
 
-
-    auto comm = Dune::MPIHelper::getCollectiveCommunication();
     parseSuccess = comm.min(parseSuccess);
 
     if (!parseSuccess)
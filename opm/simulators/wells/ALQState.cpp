@@ -17,6 +17,7 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <cstddef>
+#include <algorithm>
 #include <stdexcept>
 
 
@@ -24,99 +25,126 @@
 
 namespace Opm {
 
-double ALQState::get(const std::string& wname) const {
-    auto iter = this->current_alq_.find(wname);
-    if (iter != this->current_alq_.end())
-        return iter->second;
-
-    auto default_iter = this->default_alq_.find(wname);
-    if (default_iter != this->default_alq_.end())
-        return default_iter->second;
+const ALQState::WellALQ* ALQState::find_well(const std::string& wname) const {
+    auto index_iter = this->well_index_.find(wname);
+    if (index_iter == this->well_index_.end())
+        return nullptr;
 
-    throw std::logic_error("No ALQ value registered for well: " + wname);
+    return &this->wells_[index_iter->second];
 }
 
-void ALQState::update_default(const std::string& wname, double value) {
-    auto default_iter = this->default_alq_.find(wname);
-    if (default_iter == this->default_alq_.end() || default_iter->second != value) {
-        this->default_alq_.insert_or_assign(wname, value);
-        this->current_alq_.insert_or_assign(wname, value);
+ALQState::WellALQ& ALQState::well(const std::string& wname) {
+    auto [index_iter, inserted] = this->well_index_.try_emplace(wname, this->wells_.size());
+    if (inserted) {
+        this->wells_.emplace_back();
+        this->well_names_.push_back(wname);
     }
+    return this->wells_[index_iter->second];
 }
 
-void ALQState::set(const std::string& wname, double value) {
-    this->current_alq_[wname] = value;
+// The wells with a current ALQ value in the order of their names, such that
+// all processes pack the values in the same order.
+std::vector<std::size_t> ALQState::sorted_current() const {
+    std::vector<std::size_t> order;
+    for (std::size_t index = 0; index < this->wells_.size(); ++index) {
+        if (this->wells_[index].current)
+            order.push_back(index);
+    }
+    std::sort(order.begin(), order.end(), [this](std::size_t i1, std::size_t i2) {
+        return this->well_names_[i1] < this->well_names_[i2];
+    });
+    return order;
 }
 
-namespace {
+double ALQState::get(const std::string& wname) const {
+    const auto* well = this->find_well(wname);
+    if (well != nullptr) {
+        if (well->current)
+            return *well->current;
+
+        if (well->default_value)
+            return *well->default_value;
+    }
+
+    throw std::logic_error("No ALQ value registered for well: " + wname);
+}
 
-int get_counter(const std::map<std::string, int>& count_map, const std::string& wname) {
-    auto count_iter = count_map.find(wname);
-    if (count_iter == count_map.end())
-        return 0;
-    return count_iter->second;
+void ALQState::update_default(const std::string& wname, double value) {
+    auto& well = this->well(wname);
+    if (!well.default_value || *well.default_value != value) {
+        well.default_value = value;
+        well.current = value;
+    }
 }
 
+void ALQState::set(const std::string& wname, double value) {
+    this->well(wname).current = value;
 }
 
 bool ALQState::oscillation(const std::string& wname) const {
-    auto inc_count = get_counter(this->alq_increase_count_, wname);
+    auto inc_count = this->get_increment_count(wname);
     if (inc_count == 0)
         return false;
 
-    auto dec_count = get_counter(this->alq_decrease_count_, wname);
+    auto dec_count = this->get_decrement_count(wname);
     return dec_count >= 1;
 }
 
 
 void ALQState::update_count(const std::string& wname, bool increase) {
+    auto& well = this->well(wname);
     if (increase)
-        this->alq_increase_count_[wname] += 1;
+        well.increase_count += 1;
     else
-        this->alq_decrease_count_[wname] += 1;
+        well.decrease_count += 1;
+
+}
+
 
+// Create the counters of the well, such that the counters of different wells
+// can then be updated concurrently.
+void ALQState::insert_count(const std::string& wname) {
+    this->well(wname);
 }
 
 
 void ALQState::reset_count() {
-    this->alq_decrease_count_.clear();
-    this->alq_increase_count_.clear();
+    for (auto& well : this->wells_) {
+        well.increase_count = 0;
+        well.decrease_count = 0;
+    }
 }
 
 
 int ALQState::get_increment_count(const std::string& wname) const {
-    return get_counter(this->alq_increase_count_, wname);
+    const auto* well = this->find_well(wname);
+    return well == nullptr ? 0 : well->increase_count;
 }
 
 int ALQState::get_decrement_count(const std::string& wname) const {
-    return get_counter(this->alq_decrease_count_, wname);
+    const auto* well = this->find_well(wname);
+    return well == nullptr ? 0 : well->decrease_count;
 }
 
 std::size_t ALQState::pack_size() const {
-    return this->current_alq_.size();
+    return std::count_if(this->wells_.begin(), this->wells_.end(),
+                         [](const WellALQ& well) { return well.current.has_value(); });
 }
 
 std::size_t ALQState::pack_data(double * data) const {
     std::size_t index = 0;
-    for (const auto& [_, value] : this->current_alq_) {
-        (void)_;
-        data[index++] = value;
-    }
+    for (const auto well_index : this->sorted_current())
+        data[index++] = *this->wells_[well_index].current;
     return index;
 }
 
 std::size_t ALQState::unpack_data(const double * data) {
     std::size_t index = 0;
-    for (auto& [_, value] : this->current_alq_) {
-        (void)_;
-        value = data[index++];
-    }
+    for (const auto well_index : this->sorted_current())
+        this->wells_[well_index].current = data[index++];
     return index;
 }
 
 
 
 }
-
-
-
@@ -20,8 +20,9 @@
 #ifndef OPM_ALQ_STATE_HEADER_INCLUDED
 #define OPM_ALQ_STATE_HEADER_INCLUDED
 
-#include <map>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -39,15 +40,29 @@ public:
     void set(const std::string& wname, double value);
     bool oscillation(const std::string& wname) const;
     void update_count(const std::string& wname, bool increase);
+    void insert_count(const std::string& wname);
     void reset_count();
     int  get_increment_count(const std::string& wname) const;
     int  get_decrement_count(const std::string& wname) const;
 
 private:
-    std::map<std::string, double> current_alq_;
-    std::map<std::string, double> default_alq_;
-    std::map<std::string, int> alq_increase_count_;
-    std::map<std::string, int> alq_decrease_count_;
+    // The state of one well, the counters of a well without any are zero.
+    struct WellALQ {
+        std::optional<double> current;
+        std::optional<double> default_value;
+        int increase_count{0};
+        int decrease_count{0};
+    };
+
+    const WellALQ* find_well(const std::string& wname) const;
+    WellALQ& well(const std::string& wname);
+    std::vector<std::size_t> sorted_current() const;
+
+    // The wells are stored in the order they were first updated, the names
+    // are only looked up once per call.
+    std::vector<WellALQ> wells_;
+    std::vector<std::string> well_names_;
+    std::unordered_map<std::string, std::size_t> well_index_;
 };
 
 
@@ -32,6 +32,7 @@
 
 #include <cassert>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <optional>
@@ -44,6 +45,9 @@
 
 #include <opm/parser/eclipse/EclipseState/Runspec.hpp>
 
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Action/Actions.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Action/ActionX.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Well/WellTestState.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Group/GuideRate.hpp>
@@ -55,6 +59,7 @@
 #include <opm/simulators/wells/GasLiftSingleWell.hpp>
 #include <opm/simulators/wells/GasLiftStage2.hpp>
 #include <opm/simulators/wells/GasLiftWellState.hpp>
+#include <opm/simulators/wells/GroupTree.hpp>
 #include <opm/simulators/wells/PerforationData.hpp>
 #include <opm/simulators/wells/VFPInjProperties.hpp>
 #include <opm/simulators/wells/VFPProdProperties.hpp>
@@ -64,6 +69,7 @@
 #include <opm/simulators/wells/WellInterface.hpp>
 #include <opm/simulators/wells/StandardWell.hpp>
 #include <opm/simulators/wells/MultisegmentWell.hpp>
+#include <opm/simulators/wells/PackedWellSchurComplement.hpp>
 #include <opm/simulators/wells/WellGroupHelpers.hpp>
 #include <opm/simulators/wells/WellProdIndexCalculator.hpp>
 #include <opm/simulators/wells/ParallelWellInfo.hpp>
@@ -75,6 +81,9 @@
 #include <opm/material/densead/Math.hpp>
 
 #include <opm/simulators/utils/DeferredLogger.hpp>
+#include <opm/simulators/utils/MemoryReport.hpp>
+#include <opm/simulators/utils/ScratchArena.hpp>
+#include <opm/simulators/utils/Tracing.hpp>
 
 namespace Opm::Properties {
 
@@ -190,7 +199,9 @@ namespace Opm {
             }
 
             void endIteration()
-            { }
+            {
+                finishWellEqAssembly();
+            }
 
             void endTimeStep()
             {
@@ -214,6 +225,13 @@ namespace Opm {
 
             void initFromRestartFile(const RestartValue& restartValues);
 
+            /// Initialize the wells from the well and group data stored in a
+            /// rank local checkpoint written at the end of report step
+            /// reportStep - 1.
+            void initFromCheckpoint(const data::Wells& wells,
+                                    const data::GroupAndNetworkValues& grp_nwrk_values,
+                                    const int reportStep);
+
             data::GroupAndNetworkValues
             groupAndNetworkData(const int reportStepIdx, const Schedule& sched) const
             {
@@ -260,6 +278,7 @@ namespace Opm {
             */
             WellState& wellState()
             {
+                this->active_wgstate_committed_ = false;
                 return this->active_wgstate_.well_state;
             }
 
@@ -296,7 +315,8 @@ namespace Opm {
             */
             void commitWGState()
             {
-                this->last_valid_wgstate_ = this->active_wgstate_;
+                this->last_valid_wgstate_.assignValues(this->active_wgstate_);
+                this->active_wgstate_committed_ = true;
             }
 
             /*
@@ -307,6 +327,7 @@ namespace Opm {
             void commitWGState(WGState wgstate)
             {
                 this->last_valid_wgstate_ = std::move(wgstate);
+                this->active_wgstate_committed_ = false;
             }
 
             /*
@@ -316,7 +337,12 @@ namespace Opm {
             */
             void resetWGState()
             {
-                this->active_wgstate_ = this->last_valid_wgstate_;
+                // nothing to do if the active state has not been accessed
+                // mutably since it was committed or reset
+                if (!this->active_wgstate_committed_) {
+                    this->active_wgstate_.assignValues(this->last_valid_wgstate_);
+                    this->active_wgstate_committed_ = true;
+                }
             }
 
             /*
@@ -326,7 +352,7 @@ namespace Opm {
             */
             void updateNupcolWGState()
             {
-                this->nupcol_wgstate_ = this->active_wgstate_;
+                this->nupcol_wgstate_.assignValues(this->active_wgstate_);
             }
 
             const GroupState& groupState() const
@@ -334,13 +360,15 @@ namespace Opm {
                 return this->active_wgstate_.group_state;
             }
 
-            data::Wells wellData() const
+            // reportDetails selects the wells with connection and segment results, all if empty
+            data::Wells wellData(const std::function<bool(const std::string&)>& reportDetails = {}) const
             {
                 auto wsrpt = this->wellState().report(UgGridHelpers::globalCell(grid()),
                                                       [this](const int well_ndex) -> bool
                                                       {
                                                           return this->wasDynamicallyShutThisTimeStep(well_ndex);
-                                                      });
+                                                      },
+                                                      reportDetails);
 
                 this->assignWellGuideRates(wsrpt);
                 this->assignShutConnections(wsrpt);
@@ -354,11 +382,15 @@ namespace Opm {
             // subtract B*inv(D)*C * x from A*x
             void apply(const BVector& x, BVector& Ax) const;
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
             // accumulate the contributions of all Wells in the WellContributions object
             void getWellContributions(WellContributions& x) const;
 #endif
 
+            /// copy the Schur complements of the wells which can be packed into packed
+            /// \return the number of wells which are not included
+            int packedWellSchurComplements(PackedWellSchurComplement<Scalar, numEq>& packed) const;
+
             // apply well model with scaling of alpha
             void applyScaleAdd(const Scalar alpha, const BVector& x, BVector& Ax) const;
 
@@ -376,12 +408,50 @@ namespace Opm {
                 }
             }
 
+            // add the well contributions to the existing blocks of the matrix only,
+            // used for the matrix of the well aware preconditioner
+            void addWellContributionsInPattern(typename SparseMatrixAdapter::IstlMatrix& mat) const
+            {
+                for ( const auto& well: well_container_ ) {
+                    well->addWellContributionsInPattern(mat);
+                }
+            }
+
             // called at the beginning of a report step
             void beginReportStep(const int time_step);
 
             /// Return true if any well has a THP constraint.
             bool hasTHPConstraints() const;
 
+            /// Return for every local cell whether it is perforated by an open well.
+            const std::vector<bool>& isCellPerforated() const
+            { return is_cell_perforated_; }
+
+            /// Return the number of wells which are open on this process.
+            std::size_t numLocalOpenWells() const
+            { return well_container_.size(); }
+
+            /// Return the local cells perforated by each open well of this process.
+            std::vector<std::vector<int>> localWellCells() const
+            {
+                std::vector<std::vector<int>> cells;
+                cells.reserve(well_container_.size());
+                for (const auto& well : well_container_) {
+                    cells.push_back(well->cells());
+                }
+                return cells;
+            }
+
+            /// Add the bytes of the well states and of the packed well equations to the report.
+            void memoryUsage(MemoryReport& report) const
+            {
+                report.add("Well state", active_wgstate_.well_state.memoryUsage()
+                           + last_valid_wgstate_.well_state.memoryUsage()
+                           + nupcol_wgstate_.well_state.memoryUsage());
+                report.add("Well equations", Opm::memoryUsage(packed_wells_.cells())
+                           + Opm::memoryUsage(packed_wells_.values()));
+            }
+
             /// Shut down any single well, but only if it is in prediction mode.
             /// Returns true if the well was actually found and shut.
             bool forceShutWellByNameIfPredictionMode(const std::string& wellname, const double simulation_time);
@@ -404,6 +474,15 @@ namespace Opm {
             void initPrimaryVariablesEvaluation() const;
             void updateWellControls(DeferredLogger& deferred_logger, const bool checkGroupControls);
             WellInterfacePtr getWell(const std::string& well_name) const;
+
+            /// Set factors of the connection transmissibility factors of a well, one
+            /// for each of its connections in the schedule. They are applied from the
+            /// next report step on.
+            void setConnectionMultipliers(const std::string& well_name,
+                                          const std::vector<double>& multipliers)
+            {
+                connection_multipliers_[well_name] = multipliers;
+            }
         protected:
             Simulator& ebosSimulator_;
 
@@ -412,6 +491,11 @@ namespace Opm {
             std::vector< WellProdIndexCalculator > prod_index_calc_{};
             std::vector<int> local_shut_wells_{};
 
+            // factors of the connection transmissibility factors, per well name and connection
+            std::map<std::string, std::vector<double>> connection_multipliers_{};
+
+            double connectionTransFactor_(const Well& well, const std::size_t conn_index) const;
+
             std::vector< ParallelWellInfo > parallel_well_info_;
             std::vector< ParallelWellInfo* > local_parallel_well_info_;
 
@@ -427,16 +511,28 @@ namespace Opm {
 
             std::vector<bool> is_cell_perforated_{};
 
+            // The sorted cells of each well which are coupled with each other
+            // in the sparsity pattern of the Jacobian, set by addNeighbors().
+            mutable std::map<std::string, std::vector<int>> pattern_well_cells_{};
+
             std::function<bool(const Well&)> not_on_process_{};
 
             void initializeWellProdIndCalculators();
             void initializeWellPerfData();
+
+            void initFromRestartData_(const data::Wells& wells,
+                                      const data::GroupAndNetworkValues& grp_nwrk_values,
+                                      const int report_step);
             void initializeWellState(const int           timeStepIdx,
                                      const SummaryState& summaryState);
 
             // create the well container
             std::vector<WellInterfacePtr > createWellContainer(const int time_step);
 
+            // whether the well object of an earlier time step can be used for
+            // the well wellID of wells_ecl_
+            bool canReuseWell(const WellInterface<TypeTag>& well, const int wellID) const;
+
             void inferLocalShutWells();
 
             WellInterfacePtr
@@ -450,6 +546,13 @@ namespace Opm {
 
             WellInterfacePtr createWellForWellTest(const std::string& well_name, const int report_step, DeferredLogger& deferred_logger) const;
 
+            // create a well for a well test and prepare it to be solved
+            WellInterfacePtr prepareWellForWellTest(const std::string& well_name, const int report_step, DeferredLogger& deferred_logger) const;
+
+            // the pressures and saturations of the cells of a well, to detect
+            // whether the reservoir around a closed well changed
+            std::vector<double> wellTestConditions(const WellInterface<TypeTag>& well) const;
+
 
             const ModelParameters param_;
             bool terminal_output_{false};
@@ -473,7 +576,12 @@ namespace Opm {
             SimulatorReportSingle last_report_{};
 
             WellTestState wellTestState_{};
+            // the report step and the conditions of the cells of the wells whose last
+            // well test failed, see wellTestConditions()
+            std::map<std::string, std::pair<int, std::vector<double>>> failed_well_test_conditions_{};
             std::unique_ptr<GuideRate> guideRate_{};
+            // the group tree of the current report step, built on first use
+            std::unique_ptr<GroupTree> group_tree_{};
 
             std::map<std::string, double> node_pressures_{}; // Storing network pressures for output.
             mutable std::unordered_set<std::string> closed_this_step_{};
@@ -481,6 +589,21 @@ namespace Opm {
             // used to better efficiency of calcuation
             mutable BVector scaleAddRes_{};
 
+            // Schur complements of the standard wells in one buffer, used by apply()
+            // with --use-packed-well-operator, wells that can not be packed are applied by themselves
+            PackedWellSchurComplement<Scalar, numEq> packed_wells_{};
+            std::vector<const WellInterface<TypeTag>*> unpacked_wells_{};
+            bool packed_wells_valid_ = false;
+
+            // the well equations assembled by another thread with --overlap-well-assembly,
+            // the perforated cells wait for it when the reservoir is linearized
+            std::shared_future<void> well_assembly_{};
+            DeferredLogger well_assembly_logger_{};
+
+            // the temporaries of the well equations, one arena per thread, given
+            // back at the start of every assembly
+            std::vector<ScratchArena> scratch_arenas_{};
+
             std::vector<Scalar> B_avg_{};
 
             const Grid& grid() const
@@ -511,6 +634,20 @@ namespace Opm {
             void assemble(const int iterationIdx,
                           const double dt);
 
+            // start the assembly of the well equations on another thread
+            void startWellEqAssembly(const double dt, const double elapsed);
+
+            // wait for the well equations started by startWellEqAssembly(), if any
+            void finishWellEqAssembly();
+
+            // wait for the well equations before they are used by the reservoir
+            void waitForWellEqAssembly() const
+            {
+                if (well_assembly_.valid()) {
+                    well_assembly_.wait();
+                }
+            }
+
             // called at the end of a time step
             void timeStepSucceeded(const double& simulationTime, const double dt);
 
@@ -529,6 +666,14 @@ namespace Opm {
 
             void setupCartesianToCompressed_(const int* global_cell, int local_num__cells);
 
+            // the cells of the connections which the COMPDAT keywords of the
+            // actions of the schedule may add, by well
+            std::map<std::string, std::vector<int>> actionConnectionCells_() const;
+
+            // throw if a well couples cells which are not coupled in the
+            // sparsity pattern when the well contributions are added to the matrix
+            void checkWellCellsInPattern_() const;
+
             void setRepRadiusPerfLength();
 
 
@@ -543,6 +688,8 @@ namespace Opm {
 
             void calculateProductivityIndexValuesShutWells(const int reportStepIdx, DeferredLogger& deferred_logger);
             void calculateProductivityIndexValues(DeferredLogger& deferred_logger);
+            // only for the wells whose PI/II values are output in this report step
+            void calculateProductivityIndexValuesForOutput(const int reportStepIdx, DeferredLogger& deferred_logger);
             void calculateProductivityIndexValues(const WellInterface<TypeTag>* wellPtr,
                                                   DeferredLogger& deferred_logger);
 
@@ -557,6 +704,9 @@ namespace Opm {
 
             void assembleWellEq(const double dt, DeferredLogger& deferred_logger);
 
+            /// copy the Schur complements of the standard wells into packed_wells_
+            void packWellSchurComplements();
+
             void maybeDoGasLiftOptimize(DeferredLogger& deferred_logger);
 
             void gliftDebugShowALQ(DeferredLogger& deferred_logger);
@@ -642,7 +792,11 @@ namespace Opm {
 
              void computeWellTemperature();                       
         private:
-            GroupState& groupState() { return this->active_wgstate_.group_state; }
+            GroupState& groupState()
+            {
+                this->active_wgstate_committed_ = false;
+                return this->active_wgstate_.group_state;
+            }
             BlackoilWellModel(Simulator& ebosSimulator, const PhaseUsage& pu);
             /*
               The various wellState members should be accessed and modified
@@ -653,6 +807,8 @@ namespace Opm {
             WGState active_wgstate_;
             WGState last_valid_wgstate_;
             WGState nupcol_wgstate_;
+            // true while active_wgstate_ is known to equal last_valid_wgstate_
+            bool active_wgstate_committed_ = false;
 
         };
 
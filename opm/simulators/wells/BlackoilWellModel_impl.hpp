@@ -26,10 +26,18 @@
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <exception>
+#include <string>
 #include <utility>
 
 #include <fmt/format.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Opm {
     template<typename TypeTag>
     BlackoilWellModel<TypeTag>::
@@ -116,16 +124,18 @@ namespace Opm {
             return;
         }
 
-        // Create cartesian to compressed mapping
-        const auto& schedule_wells = schedule().getWellsatEnd();
+        // The connections the actions may add are coupled as well, such that
+        // the sparsity pattern does not need to change when they do.
+        auto well_cells = this->actionConnectionCells_();
 
         // initialize the additional cell connections introduced by wells.
+        const auto& schedule_wells = schedule().getWellsatEnd();
         for (const auto& well : schedule_wells)
         {
-            std::vector<int> wellCells;
             // All possible connections of the well
+            auto& wellCells = well_cells[well.name()];
             const auto& connectionSet = well.getConnections();
-            wellCells.reserve(connectionSet.size());
+            wellCells.reserve(wellCells.size() + connectionSet.size());
 
             for ( size_t c=0; c < connectionSet.size(); c++ )
             {
@@ -137,12 +147,106 @@ namespace Opm {
                     wellCells.push_back(compressed_idx);
                 }
             }
+        }
 
+        for (auto& [wname, wellCells] : well_cells) {
+            std::sort(wellCells.begin(), wellCells.end());
+            wellCells.erase(std::unique(wellCells.begin(), wellCells.end()), wellCells.end());
             for (int cellIdx : wellCells) {
                 neighbors[cellIdx].insert(wellCells.begin(),
                                           wellCells.end());
             }
         }
+        pattern_well_cells_ = std::move(well_cells);
+    }
+
+    template<typename TypeTag>
+    std::map<std::string, std::vector<int>>
+    BlackoilWellModel<TypeTag>::
+    actionConnectionCells_() const
+    {
+        std::map<std::string, std::vector<int>> well_cells;
+        const auto& sched = this->schedule();
+        const auto& cartDims = UgGridHelpers::cartDims(this->ebosSimulator_.vanguard().grid());
+
+        for (std::size_t step = 0; step < sched.size(); ++step) {
+            for (const auto& action : sched[step].actions()) {
+                // the well heads of the wells the action defines itself
+                std::map<std::string, std::pair<int, int>> heads;
+                for (const auto& keyword : action) {
+                    if (keyword.name() == "WELSPECS") {
+                        for (const auto& record : keyword) {
+                            heads[record.getItem("WELL").getTrimmedString(0)] =
+                                { record.getItem("HEAD_I").get<int>(0) - 1,
+                                  record.getItem("HEAD_J").get<int>(0) - 1 };
+                        }
+                        continue;
+                    }
+                    if (keyword.name() != "COMPDAT") {
+                        continue;
+                    }
+
+                    for (const auto& record : keyword) {
+                        const auto wname = record.getItem("WELL").getTrimmedString(0);
+                        std::pair<int, int> head;
+                        if (auto head_iter = heads.find(wname); head_iter != heads.end()) {
+                            head = head_iter->second;
+                        } else if (sched.hasWell(wname)) {
+                            const auto& well = sched.getWellatEnd(wname);
+                            head = { well.getHeadI(), well.getHeadJ() };
+                        } else {
+                            // e.g. a pattern of well names, matched when the action runs
+                            continue;
+                        }
+
+                        // a defaulted I or J is the one of the well head
+                        const int I = record.getItem("I").get<int>(0);
+                        const int J = record.getItem("J").get<int>(0);
+                        const int i = I > 0 ? I - 1 : head.first;
+                        const int j = J > 0 ? J - 1 : head.second;
+                        const int k1 = record.getItem("K1").get<int>(0) - 1;
+                        const int k2 = record.getItem("K2").get<int>(0) - 1;
+                        if (i < 0 || i >= cartDims[0] || j < 0 || j >= cartDims[1]) {
+                            continue;
+                        }
+
+                        auto& cells = well_cells[wname];
+                        for (int k = std::max(k1, 0); k <= std::min(k2, cartDims[2] - 1); ++k) {
+                            const int compressed_idx =
+                                cartesian_to_compressed_[i + cartDims[0]*(j + cartDims[1]*k)];
+                            if (compressed_idx >= 0) {
+                                cells.push_back(compressed_idx);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return well_cells;
+    }
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    checkWellCellsInPattern_() const
+    {
+        // The pattern is set up when the reservoir is linearized the first time.
+        if (pattern_well_cells_.empty()) {
+            return;
+        }
+
+        for (std::size_t w = 0; w < wells_ecl_.size(); ++w) {
+            const auto& wname = wells_ecl_[w].name();
+            const auto cells_iter = pattern_well_cells_.find(wname);
+            for (const auto& perf : well_perf_data_[w]) {
+                if (cells_iter == pattern_well_cells_.end() ||
+                    !std::binary_search(cells_iter->second.begin(), cells_iter->second.end(), perf.cell_index)) {
+                    OPM_THROW(std::runtime_error, "The connections of well " << wname << " couple cells which are not"
+                              " coupled in the sparsity pattern of the Jacobian, its contributions can not be added"
+                              " to the matrix. Use --matrix-add-well-contributions=false for this case.");
+                }
+            }
+        }
     }
 
     template<typename TypeTag>
@@ -153,6 +257,7 @@ namespace Opm {
         if (!localWellsActive())
             return;
 
+        waitForWellEqAssembly();
         if (!param_.matrix_add_well_contributions_) {
             // if the well contributions are not supposed to be included explicitly in
             // the matrix, we only apply the vector part of the Schur complement here.
@@ -160,6 +265,9 @@ namespace Opm {
                 // r = r - duneC_^T * invDuneD_ * resWell_
                 well->apply(res);
             }
+            if (param_.use_packed_well_operator_) {
+                packWellSchurComplements();
+            }
             return;
         }
 
@@ -272,7 +380,11 @@ namespace Opm {
         // The well state initialize bhp with the cell pressure in the top cell.
         // We must therefore provide it with updated cell pressures
         this->initializeWellPerfData();
+        if (param_.matrix_add_well_contributions_) {
+            this->checkWellCellsInPattern_();
+        }
         this->initializeWellState(timeStepIdx, summaryState);
+        group_tree_.reset();
 
         // Wells are active if they are active wells on at least
         // one process.
@@ -287,9 +399,13 @@ namespace Opm {
         const Group& fieldGroup = schedule().getGroup("FIELD", timeStepIdx);
         WellGroupHelpers::setCmodeGroup(fieldGroup, schedule(), summaryState, timeStepIdx, this->wellState(), this->groupState());
 
-        // Compute reservoir volumes for RESV controls.
-        rateConverter_.reset(new RateConverterType (phase_usage_,
-                                                    std::vector<int>(local_num_cells_, 0)));
+        // Compute reservoir volumes for RESV controls. The converter is
+        // referenced by the well objects, which may be kept for the next
+        // report step.
+        if (!rateConverter_) {
+            rateConverter_.reset(new RateConverterType (phase_usage_,
+                                                        std::vector<int>(local_num_cells_, 0)));
+        }
         rateConverter_->template defineState<ElementContext>(ebosSimulator_);
 
         {
@@ -473,33 +589,157 @@ namespace Opm {
                                             DeferredLogger& deferred_logger)
     {
         const auto& wtest_config = schedule()[timeStepIdx].wtest_config();
-        if (wtest_config.size() != 0) { // there is a WTEST request
-            const auto wellsForTesting = wellTestState_
-                .updateWells(wtest_config, wells_ecl_, simulationTime);
+        if (wtest_config.size() == 0) { // there is no WTEST request
+            return;
+        }
+        const auto wellsForTesting = wellTestState_
+            .updateWells(wtest_config, wells_ecl_, simulationTime);
 
-            for (const auto& testWell : wellsForTesting) {
-                const std::string& well_name = testWell.first;
+        // Each test solves the well against a copy of the well state and the
+        // well test state, such that the wells which are not distributed can
+        // be tested concurrently. The tests which open their well are repeated
+        // against the states themselves, in the order of the wells.
+        struct TestCase
+        {
+            std::string well_name;
+            WellTestConfig::Reason reason;
+            WellInterfacePtr well;
+            std::vector<double> conditions;
+            DeferredLogger logger;
+            bool passed = false;
+        };
+        std::vector<TestCase> cases;
+        std::vector<int> local_cases;
+        const double tolerance = param_.well_test_unchanged_tolerance_;
+        for (const auto& testWell : wellsForTesting) {
+            TestCase test_case;
+            test_case.well_name = testWell.first;
+            test_case.reason = testWell.second;
+            test_case.well = prepareWellForWellTest(test_case.well_name, timeStepIdx, deferred_logger);
+            if (test_case.well->parallelWellInfo().communication().size() == 1) {
+                test_case.conditions = wellTestConditions(*test_case.well);
+                // the test failed the last time, and will fail again if neither the
+                // schedule nor the reservoir around the well changed since
+                const auto last = failed_well_test_conditions_.find(test_case.well_name);
+                if (tolerance > 0.0 && !test_case.conditions.empty()
+                    && last != failed_well_test_conditions_.end()
+                    && last->second.first == timeStepIdx
+                    && last->second.second.size() == test_case.conditions.size()
+                    && std::equal(test_case.conditions.begin(), test_case.conditions.end(),
+                                  last->second.second.begin(),
+                                  [tolerance](const double a, const double b)
+                                  { return std::abs(a - b) <= tolerance * std::max(std::abs(b), 1.0); })) {
+                    deferred_logger.debug("WellTest: skipping the test of well " + test_case.well_name
+                                          + ", its cells did not change since its last failed test");
+                    continue;
+                }
+                local_cases.push_back(cases.size());
+            }
+            cases.push_back(std::move(test_case));
+        }
+
+        auto testWell = [this, simulationTime, timeStepIdx](TestCase& test_case)
+        {
+            auto well_state = this->wellState();
+            auto well_test_state = wellTestState_;
+            test_case.well->wellTesting(ebosSimulator_, simulationTime, timeStepIdx, test_case.reason,
+                                        well_state, this->groupState(), well_test_state, test_case.logger);
+            test_case.passed = !well_test_state.hasWellClosed(test_case.well_name, test_case.reason);
+        };
+
+        std::exception_ptr exc;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < static_cast<int>(local_cases.size()); ++i) {
+            try {
+                testWell(cases[local_cases[i]]);
+            }
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                exc = std::current_exception();
+            }
+        }
+        if (exc) {
+            std::rethrow_exception(exc);
+        }
+
+        for (auto& test_case : cases) {
+            if (test_case.well->parallelWellInfo().communication().size() > 1) {
+                // the well communicates, all processes must test it in the same order
+                test_case.well->wellTesting(ebosSimulator_, simulationTime, timeStepIdx, test_case.reason,
+                                            this->wellState(), this->groupState(), wellTestState_, deferred_logger);
+                continue;
+            }
+            if (!test_case.passed) {
+                deferred_logger.append(test_case.logger);
+                failed_well_test_conditions_[test_case.well_name] = {timeStepIdx, std::move(test_case.conditions)};
+                continue;
+            }
+            failed_well_test_conditions_.erase(test_case.well_name);
+            // the well is opened, repeat the test with a new well against the
+            // well state, with the other wells opened before
+            auto well = prepareWellForWellTest(test_case.well_name, timeStepIdx, deferred_logger);
+            well->wellTesting(ebosSimulator_, simulationTime, timeStepIdx, test_case.reason,
+                              this->wellState(), this->groupState(), wellTestState_, deferred_logger);
+        }
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    typename BlackoilWellModel<TypeTag>::WellInterfacePtr
+    BlackoilWellModel<TypeTag>::
+    prepareWellForWellTest(const std::string& well_name,
+                           const int report_step,
+                           DeferredLogger& deferred_logger) const
+    {
+        // this is the well we will test
+        WellInterfacePtr well = createWellForWellTest(well_name, report_step, deferred_logger);
+
+        // some preparation before the well can be used
+        well->init(&phase_usage_, depth_, gravity_, local_num_cells_, B_avg_);
+        const Well& wellEcl = schedule().getWell(well_name, report_step);
+        double well_efficiency_factor = wellEcl.getEfficiencyFactor();
+        WellGroupHelpers::accumulateGroupEfficiencyFactor(schedule().getGroup(wellEcl.groupName(), report_step),
+                                                          schedule(), report_step, well_efficiency_factor);
+
+        well->setWellEfficiencyFactor(well_efficiency_factor);
+        well->setVFPProperties(vfp_properties_.get());
+        well->setGuideRate(guideRate_.get());
+        return well;
+    }
 
-                // this is the well we will test
-                WellInterfacePtr well = createWellForWellTest(well_name, timeStepIdx, deferred_logger);
 
-                // some preparation before the well can be used
-                well->init(&phase_usage_, depth_, gravity_, local_num_cells_, B_avg_);
-                const Well& wellEcl = schedule().getWell(well_name, timeStepIdx);
-                double well_efficiency_factor = wellEcl.getEfficiencyFactor();
-                WellGroupHelpers::accumulateGroupEfficiencyFactor(schedule().getGroup(wellEcl.groupName(), timeStepIdx),
-                                                                  schedule(), timeStepIdx, well_efficiency_factor);
 
-                well->setWellEfficiencyFactor(well_efficiency_factor);
-                well->setVFPProperties(vfp_properties_.get());
-                well->setGuideRate(guideRate_.get());
 
-                const WellTestConfig::Reason testing_reason = testWell.second;
 
-                well->wellTesting(ebosSimulator_, simulationTime, timeStepIdx,
-                                  testing_reason, this->wellState(), this->groupState(), wellTestState_, deferred_logger);
+    template<typename TypeTag>
+    std::vector<double>
+    BlackoilWellModel<TypeTag>::
+    wellTestConditions(const WellInterface<TypeTag>& well) const
+    {
+        std::vector<double> conditions;
+        conditions.reserve(well.cells().size() * (1 + FluidSystem::numPhases));
+        for (const int cell_idx : well.cells()) {
+            const auto* intQuants = ebosSimulator_.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0);
+            if (intQuants == nullptr) {
+                // without the cached quantities nothing is known, never skip the test
+                return {};
+            }
+            const auto& fs = intQuants->fluidState();
+            conditions.push_back(fs.pressure(FluidSystem::oilPhaseIdx).value());
+            for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+                if (FluidSystem::phaseIsActive(phaseIdx)) {
+                    conditions.push_back(fs.saturation(phaseIdx).value());
+                }
             }
         }
+        return conditions;
     }
 
 
@@ -568,7 +808,7 @@ namespace Opm {
         const Group& fieldGroup = schedule().getGroup("FIELD", reportStepIdx);
         checkGconsaleLimits(fieldGroup, this->wellState(), local_deferredLogger);
 
-        this->calculateProductivityIndexValues(local_deferredLogger);
+        this->calculateProductivityIndexValuesForOutput(reportStepIdx, local_deferredLogger);
 
         this->commitWGState();
 
@@ -597,6 +837,7 @@ namespace Opm {
         if (!is_cell_perforated_[elemIdx])
             return;
 
+        waitForWellEqAssembly();
         for (const auto& well : well_container_)
             well->addCellRates(rate, elemIdx);
     }
@@ -627,6 +868,28 @@ namespace Opm {
         // will not be present in a restart file. Use the previous time step to retrieve
         // wells that have information written to the restart file.
         const int report_step = std::max(eclState().getInitConfig().getRestartStep() - 1, 0);
+        initFromRestartData_(restartValues.wells, restartValues.grp_nwrk, report_step);
+    }
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    initFromCheckpoint(const data::Wells& wells,
+                       const data::GroupAndNetworkValues& grp_nwrk_values,
+                       const int reportStep)
+    {
+        // Same convention as for the ECL restart, the checkpoint is written at
+        // the end of the step before reportStep.
+        initFromRestartData_(wells, grp_nwrk_values, std::max(reportStep - 1, 0));
+    }
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    initFromRestartData_(const data::Wells& wells,
+                         const data::GroupAndNetworkValues& grp_nwrk_values,
+                         const int report_step)
+    {
         const auto& summaryState = ebosSimulator_.vanguard().summaryState();
         // wells_ecl_ should only contain wells on this processor.
         wells_ecl_ = getLocalWells(report_step);
@@ -641,7 +904,7 @@ namespace Opm {
             const size_t numCells = UgGridHelpers::numCells(grid());
             const bool handle_ms_well = (param_.use_multisegment_well_ && anyMSWellOpenLocal());
             this->wellState().resize(wells_ecl_, local_parallel_well_info_, schedule(), handle_ms_well, numCells, well_perf_data_, summaryState); // Resize for restart step
-            loadRestartData(restartValues.wells, restartValues.grp_nwrk, phaseUsage, handle_ms_well, this->wellState());
+            loadRestartData(wells, grp_nwrk_values, phaseUsage, handle_ms_well, this->wellState());
         }
 
         this->commitWGState();
@@ -699,7 +962,7 @@ namespace Opm {
                         checker.connectionFound(completion_index);
                         PerforationData pd;
                         pd.cell_index = active_index;
-                        pd.connection_transmissibility_factor = completion.CF();
+                        pd.connection_transmissibility_factor = connectionTransFactor_(well, completion_index);
                         pd.satnum_id = completion.satTableId();
                         pd.ecl_index = completion_index;
                         well_perf_data_[well_index].push_back(pd);
@@ -786,6 +1049,19 @@ namespace Opm {
 
         const int nw = numLocalWells();
 
+        // The well objects of the last time step by well index, the ones of
+        // unchanged standard wells are reused.
+        std::vector<WellInterfacePtr> previous_wells;
+        if (param_.reuse_well_objects_) {
+            previous_wells.resize(nw);
+            for (const auto& well : well_container_) {
+                const int w = well->indexOfWell();
+                if (w < nw) {
+                    previous_wells[w] = well;
+                }
+            }
+        }
+
         if (nw > 0) {
             well_container.reserve(nw);
 
@@ -894,13 +1170,30 @@ namespace Opm {
                     wellIsStopped = true;
                 }
 
-                well_container.emplace_back(this->createWellPointer(w, time_step));
+                if (!previous_wells.empty() && previous_wells[w] &&
+                    this->canReuseWell(*previous_wells[w], w)) {
+                    previous_wells[w]->resetForTimeStep(time_step);
+                    well_container.push_back(previous_wells[w]);
+                } else {
+                    well_container.emplace_back(this->createWellPointer(w, time_step));
+                }
 
                 if (wellIsStopped)
                     well_container.back()->stopWell();
             }
         }
 
+        if (scratch_arenas_.empty()) {
+#ifdef _OPENMP
+            scratch_arenas_.resize(omp_get_max_threads());
+#else
+            scratch_arenas_.resize(1);
+#endif
+        }
+        for (auto& well : well_container) {
+            well->setScratchArenas(&scratch_arenas_);
+        }
+
         // Collect log messages and print.
         DeferredLogger global_deferredLogger = gatherDeferredLogger(local_deferredLogger);
         if (terminal_output_) {
@@ -957,6 +1250,28 @@ namespace Opm {
 
 
 
+    template <typename TypeTag>
+    bool
+    BlackoilWellModel<TypeTag>::
+    canReuseWell(const WellInterface<TypeTag>& well, const int wellID) const
+    {
+        // Only standard wells, init() sets up the state of the other kinds anew.
+        const auto is_multiseg = this->wells_ecl_[wellID].isMultiSegment();
+        if ((this->param_.use_multisegment_well_ && is_multiseg) ||
+            dynamic_cast<const StandardWell<TypeTag>*>(&well) == nullptr) {
+            return false;
+        }
+
+        return well.canBeReused(this->wells_ecl_[wellID],
+                                *this->local_parallel_well_info_[wellID],
+                                this->wellState().firstPerfIndex()[wellID],
+                                this->well_perf_data_[wellID]);
+    }
+
+
+
+
+
     template <typename TypeTag>
     template <typename WellType>
     std::unique_ptr<WellType>
@@ -1023,6 +1338,7 @@ namespace Opm {
     assemble(const int iterationIdx,
              const double dt)
     {
+        OPM_TRACE_SCOPE("well assemble");
 
         DeferredLogger local_deferredLogger;
         if (this->glift_debug) {
@@ -1030,9 +1346,18 @@ namespace Opm {
                 "assemble() : iteration {}" , iterationIdx);
             gliftDebug(msg, local_deferredLogger);
         }
+        // an assembly left by an iteration which failed during the linearization
+        waitForWellEqAssembly();
+        well_assembly_ = std::shared_future<void>();
+        for (auto& arena : scratch_arenas_) {
+            arena.reset();
+        }
+
         last_report_ = SimulatorReportSingle();
         Dune::Timer perfTimer;
         perfTimer.start();
+        // the well matrices change, they are packed again in linearize()
+        packed_wells_valid_ = false;
 
         if ( ! wellsActive() ) {
             return;
@@ -1041,6 +1366,9 @@ namespace Opm {
 
         updatePerforationIntensiveQuantities();
 
+        // the well equations only overlap with the linearization if they do not
+        // communicate, the controls and the gas lift are still done before
+        const bool overlap = param_.overlap_well_assembly_ && grid().comm().size() == 1;
         auto exc_type = ExceptionType::NONE;
         std::string exc_msg;
         try {
@@ -1054,7 +1382,9 @@ namespace Opm {
             initPrimaryVariablesEvaluation();
 
             maybeDoGasLiftOptimize(local_deferredLogger);
-            assembleWellEq(dt, local_deferredLogger);
+            if (!overlap) {
+                assembleWellEq(dt, local_deferredLogger);
+            }
         } catch (const std::runtime_error& e) {
             exc_type = ExceptionType::RUNTIME_ERROR;
             exc_msg = e.what();
@@ -1069,28 +1399,143 @@ namespace Opm {
             exc_msg = e.what();
         }
         logAndCheckForExceptionsAndThrow(local_deferredLogger, exc_type, "assemble() failed: " + exc_msg, terminal_output_);
+        if (overlap) {
+            startWellEqAssembly(dt, perfTimer.stop());
+            return;
+        }
         last_report_.converged = true;
         last_report_.assemble_time_well += perfTimer.stop();
     }
 
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    startWellEqAssembly(const double dt, const double elapsed)
+    {
+        // The well equations only read the intensive quantities of the perforated
+        // cells, which updatePerforationIntensiveQuantities() has already stored in
+        // the cache, and the reservoir only reads the well rates after waiting for
+        // them. The reservoir is linearized by all threads meanwhile, hence the
+        // wells are assembled by this thread alone.
+        well_assembly_logger_ = DeferredLogger();
+        well_assembly_ = std::async(std::launch::async, [this, dt, elapsed]()
+        {
+            Dune::Timer timer;
+            timer.start();
+            for (auto& well : well_container_) {
+                well->assembleWellEq(ebosSimulator_, dt, this->wellState(), this->groupState(),
+                                     well_assembly_logger_);
+            }
+            last_report_.assemble_time_well += elapsed + timer.stop();
+        }).share();
+    }
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    finishWellEqAssembly()
+    {
+        if (!well_assembly_.valid()) {
+            return;
+        }
+
+        auto exc_type = ExceptionType::NONE;
+        std::string exc_msg;
+        try {
+            well_assembly_.get();
+        } catch (const std::runtime_error& e) {
+            exc_type = ExceptionType::RUNTIME_ERROR;
+            exc_msg = e.what();
+        } catch (const std::invalid_argument& e) {
+            exc_type = ExceptionType::INVALID_ARGUMENT;
+            exc_msg = e.what();
+        } catch (const std::logic_error& e) {
+            exc_type = ExceptionType::LOGIC_ERROR;
+            exc_msg = e.what();
+        } catch (const std::exception& e) {
+            exc_type = ExceptionType::DEFAULT;
+            exc_msg = e.what();
+        }
+        well_assembly_ = std::shared_future<void>();
+        logAndCheckForExceptionsAndThrow(well_assembly_logger_, exc_type, "assemble() failed: " + exc_msg, terminal_output_);
+        last_report_.converged = true;
+    }
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
     maybeDoGasLiftOptimize(DeferredLogger& deferred_logger)
     {
+        OPM_TRACE_SCOPE("gas lift optimization");
         this->wellState().enableGliftOptimization();
         GLiftOptWells glift_wells;
         GLiftProdWells prod_wells;
         GLiftWellStateMap state_map;
-        // Stage1: Optimize single wells not checking any group limits
-        for (auto& well : well_container_) {
-            well->gasLiftOptimizationStage1(
-                this->wellState(), ebosSimulator_, deferred_logger,
-                prod_wells, glift_wells, state_map);
+
+        // Stage1: Optimize single wells not checking any group limits.
+        // The wells are optimized independently of each other, so the wells
+        // which are not distributed over several processes are done in parallel.
+        // Each well gets its own containers and logger, which are merged in the
+        // order of the wells afterwards. The loggers are kept by the single well
+        // optimizers until stage 2 has finished.
+        struct Stage1Result
+        {
+            DeferredLogger logger;
+            GLiftProdWells prod_wells;
+            GLiftOptWells glift_wells;
+            GLiftWellStateMap state_map;
+        };
+        const int num_wells = well_container_.size();
+        std::vector<Stage1Result> results(num_wells);
+        std::vector<int> local_wells;
+        for (int w = 0; w < num_wells; ++w) {
+            auto& well = well_container_[w];
+            this->wellState().gliftPrepareConcurrentUpdate(well->name());
+            if (well->parallelWellInfo().communication().size() > 1) {
+                // the well communicates, all processes must handle it in the same order
+                auto& result = results[w];
+                well->gasLiftOptimizationStage1(
+                    this->wellState(), ebosSimulator_, result.logger,
+                    result.prod_wells, result.glift_wells, result.state_map);
+            }
+            else {
+                local_wells.push_back(w);
+            }
+        }
+
+        std::exception_ptr exc;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < static_cast<int>(local_wells.size()); ++i) {
+            try {
+                auto& result = results[local_wells[i]];
+                well_container_[local_wells[i]]->gasLiftOptimizationStage1(
+                    this->wellState(), ebosSimulator_, result.logger,
+                    result.prod_wells, result.glift_wells, result.state_map);
+            }
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                exc = std::current_exception();
+            }
+        }
+        if (exc) {
+            std::rethrow_exception(exc);
+        }
+
+        for (auto& result : results) {
+            prod_wells.merge(result.prod_wells);
+            glift_wells.merge(result.glift_wells);
+            state_map.merge(result.state_map);
         }
         gasLiftOptimizationStage2(deferred_logger, prod_wells, glift_wells, state_map);
         if (this->glift_debug) gliftDebugShowALQ(deferred_logger);
         this->wellState().disableGliftOptimization();
+        for (const auto& result : results) {
+            deferred_logger.append(result.logger);
+        }
     }
 
     // If a group has any production rate constraints, and/or a limit
@@ -1138,8 +1583,59 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     assembleWellEq(const double dt, DeferredLogger& deferred_logger)
     {
-        for (auto& well : well_container_) {
-            well->assembleWellEq(ebosSimulator_, dt, this->wellState(), this->groupState(), deferred_logger);
+        auto& well_state = this->wellState();
+        const auto& group_state = this->groupState();
+
+        if (!param_.parallel_well_assembly_) {
+            for (auto& well : well_container_) {
+                well->assembleWellEq(ebosSimulator_, dt, well_state, group_state, deferred_logger);
+            }
+            return;
+        }
+
+        // Every well only updates its own entries of the well state, so the
+        // wells which are not distributed over several processes are assembled
+        // concurrently, each with its own logger. The messages are appended in
+        // the order of the wells, such that the output does not depend on the
+        // number of threads.
+        const int num_wells = well_container_.size();
+        std::vector<DeferredLogger> loggers(num_wells);
+        std::vector<int> local_wells;
+        local_wells.reserve(num_wells);
+
+        // distributed wells communicate, all processes must handle them in the same order
+        for (int w = 0; w < num_wells; ++w) {
+            auto& well = well_container_[w];
+            if (well->parallelWellInfo().communication().size() > 1) {
+                well->assembleWellEq(ebosSimulator_, dt, well_state, group_state, loggers[w]);
+            } else {
+                local_wells.push_back(w);
+            }
+        }
+
+        std::exception_ptr exc_ptr;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < static_cast<int>(local_wells.size()); ++i) {
+            const int w = local_wells[i];
+            try {
+                well_container_[w]->assembleWellEq(ebosSimulator_, dt, well_state, group_state, loggers[w]);
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!exc_ptr) {
+                    exc_ptr = std::current_exception();
+                }
+            }
+        }
+
+        for (auto& logger : loggers) {
+            deferred_logger.append(logger);
+        }
+        if (exc_ptr) {
+            std::rethrow_exception(exc_ptr);
         }
     }
 
@@ -1169,12 +1665,54 @@ namespace Opm {
             return;
         }
 
+        if (packed_wells_valid_) {
+            packed_wells_.apply(x, Ax);
+            for (const auto* well : unpacked_wells_) {
+                well->apply(x, Ax);
+            }
+            return;
+        }
+
         for (auto& well : well_container_) {
             well->apply(x, Ax);
         }
     }
 
-#if HAVE_CUDA || HAVE_OPENCL
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    packWellSchurComplements()
+    {
+        packed_wells_.clear();
+        unpacked_wells_.clear();
+        for (const auto& well : well_container_) {
+            auto derived = std::dynamic_pointer_cast<StandardWell<TypeTag> >(well);
+            if (!derived || !derived->addPackedSchurComplement(packed_wells_)) {
+                unpacked_wells_.push_back(well.get());
+            }
+        }
+        packed_wells_valid_ = true;
+    }
+
+    template<typename TypeTag>
+    int
+    BlackoilWellModel<TypeTag>::
+    packedWellSchurComplements(PackedWellSchurComplement<Scalar, numEq>& packed) const
+    {
+        packed.clear();
+        int num_unpacked = 0;
+        for (const auto& well : well_container_) {
+            auto derived = std::dynamic_pointer_cast<StandardWell<TypeTag> >(well);
+            if (!derived || !derived->addPackedSchurComplement(packed)) {
+                ++num_unpacked;
+            }
+        }
+        return num_unpacked;
+    }
+
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -1244,6 +1782,7 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     recoverWellSolutionAndUpdateWellState(const BVector& x)
     {
+        OPM_TRACE_SCOPE("well recover");
         DeferredLogger local_deferredLogger;
         auto exc_type = ExceptionType::NONE;
         std::string exc_msg;
@@ -1328,6 +1867,7 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     getWellConvergence(const std::vector<Scalar>& B_avg, bool checkGroupConvergence) const
     {
+        OPM_TRACE_SCOPE("well convergence");
 
         DeferredLogger local_deferredLogger;
         // Get global (from all processes) convergence report.
@@ -1388,6 +1928,7 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     updateWellControls(DeferredLogger& deferred_logger, const bool checkGroupControls)
     {
+        OPM_TRACE_SCOPE("well controls");
         // Even if there are no wells active locally, we cannot
         // return as the DeferredLogger uses global communication.
         // For no well active globally we simply return.
@@ -1446,7 +1987,53 @@ namespace Opm {
         if (!network.active()) {
             return;
         }
-        node_pressures_ = WellGroupHelpers::computeNetworkPressures(network, this->wellState(), this->groupState(), *(vfp_properties_->getProd()), schedule(), reportStepIdx);
+
+        // The production rates of the wells under THP control change with the
+        // pressures of their nodes, as given by their inflow performance. Sum
+        // these derivatives for the groups, for the network to be balanced
+        // with the changed rates.
+        std::map<std::string, std::vector<double>> rate_derivatives;
+        if (!node_pressures_.empty()) {
+            const int np = numPhases();
+            std::vector<std::string> leaf_nodes;
+            std::vector<std::string> nodes{network.root().name()};
+            while (!nodes.empty()) {
+                const auto node = nodes.back();
+                nodes.pop_back();
+                const auto branches = network.downtree_branches(node);
+                if (branches.empty()) {
+                    leaf_nodes.push_back(node);
+                }
+                for (const auto& branch : branches) {
+                    nodes.push_back(branch.downtree_node());
+                }
+            }
+            std::vector<double> derivatives(leaf_nodes.size() * np, 0.0);
+            for (const auto& well : well_container_) {
+                const int w = well->indexOfWell();
+                if (!well->isProducer() || !well->parallelWellInfo().isOwner()
+                    || this->wellState().currentProductionControl(w) != Well::ProducerCMode::THP) {
+                    continue;
+                }
+                const auto node = std::find(leaf_nodes.begin(), leaf_nodes.end(), well->wellEcl().groupName());
+                if (node == leaf_nodes.end()) {
+                    continue;
+                }
+                const auto& ipr_b = well->iprB();
+                const auto offset = (node - leaf_nodes.begin()) * np;
+                for (int p = 0; p < np && p < static_cast<int>(ipr_b.size()); ++p) {
+                    derivatives[offset + p] -= ipr_b[p];
+                }
+            }
+            ebosSimulator_.vanguard().grid().comm().sum(derivatives.data(), derivatives.size());
+            for (std::size_t i = 0; i < leaf_nodes.size(); ++i) {
+                rate_derivatives[leaf_nodes[i]].assign(derivatives.begin() + i * np,
+                                                       derivatives.begin() + (i + 1) * np);
+            }
+        }
+
+        node_pressures_ = WellGroupHelpers::computeNetworkPressures(network, this->wellState(), this->groupState(), *(vfp_properties_->getProd()), schedule(), reportStepIdx,
+                                                                    rate_derivatives, node_pressures_);
 
         // Set the thp limits of wells
         for (auto& well : well_container_) {
@@ -1491,16 +2078,18 @@ namespace Opm {
         const auto& summaryState = ebosSimulator_.vanguard().summaryState();
         // the group target reduction rates needs to be update since wells may have swicthed to/from GRUP control
         // Currently the group target reduction does not honor NUPCOL. TODO: is that true?
-        std::vector<double> groupTargetReduction(numPhases(), 0.0);
-        WellGroupHelpers::updateGroupTargetReduction(fieldGroup, schedule(), reportStepIdx, /*isInjector*/ false, phase_usage_, *guideRate_, well_state_nupcol, well_state, this->groupState(), groupTargetReduction);
-        std::vector<double> groupTargetReductionInj(numPhases(), 0.0);
-        WellGroupHelpers::updateGroupTargetReduction(fieldGroup, schedule(), reportStepIdx, /*isInjector*/ true, phase_usage_, *guideRate_, well_state_nupcol, well_state, this->groupState(), groupTargetReductionInj);
+        if (!group_tree_ || group_tree_->reportStep() != reportStepIdx) {
+            group_tree_ = std::make_unique<GroupTree>(schedule(), reportStepIdx, well_state);
+        }
+        const auto& group_tree = *group_tree_;
+        WellGroupHelpers::updateGroupTargetReduction(group_tree, /*isInjector*/ false, phase_usage_, *guideRate_, well_state_nupcol, well_state, this->groupState());
+        WellGroupHelpers::updateGroupTargetReduction(group_tree, /*isInjector*/ true, phase_usage_, *guideRate_, well_state_nupcol, well_state, this->groupState());
 
-        WellGroupHelpers::updateREINForGroups(fieldGroup, schedule(), reportStepIdx, phase_usage_, summaryState, well_state_nupcol, well_state, this->groupState());
-        WellGroupHelpers::updateVREPForGroups(fieldGroup, schedule(), reportStepIdx, well_state_nupcol, well_state, this->groupState());
+        WellGroupHelpers::updateREINForGroups(group_tree, schedule(), phase_usage_, summaryState, well_state_nupcol, this->groupState());
+        WellGroupHelpers::updateVREPForGroups(group_tree, well_state_nupcol, this->groupState());
 
-        WellGroupHelpers::updateReservoirRatesInjectionGroups(fieldGroup, schedule(), reportStepIdx, well_state_nupcol, well_state, this->groupState());
-        WellGroupHelpers::updateGroupProductionRates(fieldGroup, schedule(), reportStepIdx, well_state_nupcol, well_state, this->groupState());
+        WellGroupHelpers::updateReservoirRatesInjectionGroups(group_tree, well_state_nupcol, this->groupState());
+        WellGroupHelpers::updateGroupProductionRates(group_tree, well_state_nupcol, this->groupState());
 
         // We use the rates from the privious time-step to reduce oscilations
         WellGroupHelpers::updateWellRates(fieldGroup, schedule(), reportStepIdx, this->prevWellState(), well_state);
@@ -1560,9 +2149,24 @@ namespace Opm {
 
         const SummaryConfig& summaryConfig = ebosSimulator_.vanguard().summaryConfig();
         const bool write_restart_file = ebosSimulator_.vanguard().schedule().write_rst_file(reportStepIdx);
-        auto exc_type = ExceptionType::NONE;
-        std::string exc_msg;
-        for (const auto& well : well_container_) {
+        // The potentials of the wells are computed independently of each
+        // other, from a copy of the well state. The wells which are not
+        // distributed over several processes are done in parallel, each with
+        // its own logger, and the results are collected in the order of the
+        // wells afterwards.
+        struct PotentialResult
+        {
+            std::vector<double> potentials;
+            DeferredLogger logger;
+            ExceptionType::ExcEnum exc_type = ExceptionType::NONE;
+            std::string exc_msg;
+        };
+        const int num_wells = well_container_.size();
+        std::vector<PotentialResult> results(num_wells);
+        std::vector<int> compute_wells;
+        std::vector<int> local_wells;
+        for (int w = 0; w < num_wells; ++w) {
+            const auto& well = well_container_[w];
             const bool needed_for_summary =
                     ((summaryConfig.hasSummaryKey( "WWPI:" + well->name()) ||
                       summaryConfig.hasSummaryKey( "WOPI:" + well->name()) ||
@@ -1598,32 +2202,65 @@ namespace Opm {
             const bool needPotentialsForGuideRates = well->underPredictionMode() && (!onlyAfterEvent || event);
             const bool needPotentialsForOutput = !onlyAfterEvent && (needed_for_summary || write_restart_file);
             const bool compute_potential = needPotentialsForOutput || needPotentialsForGuideRates;
-            if (compute_potential)
-            {
-                std::vector<double> potentials;
-                try {
-                    well->computeWellPotentials(ebosSimulator_, well_state_copy, potentials, deferred_logger);
-                 } catch (const std::runtime_error& e) {
-                    exc_type = ExceptionType::RUNTIME_ERROR;
-                    exc_msg = e.what();
-                } catch (const std::invalid_argument& e) {
-                    exc_type = ExceptionType::INVALID_ARGUMENT;
-                    exc_msg = e.what();
-                } catch (const std::logic_error& e) {
-                    exc_type = ExceptionType::LOGIC_ERROR;
-                    exc_msg = e.what();
-                } catch (const std::exception& e) {
-                    exc_type = ExceptionType::DEFAULT;
-                    exc_msg = e.what();
-                }
-                // Store it in the well state
-                // potentials is resized and set to zero in the beginning of well->ComputeWellPotentials
-                // and updated only if sucessfull. i.e. the potentials are zero for exceptions
-                for (int p = 0; p < np; ++p) {
-                    this->wellState().wellPotentials()[well->indexOfWell() * np + p] = std::abs(potentials[p]);
+            if (compute_potential) {
+                compute_wells.push_back(w);
+                if (well->parallelWellInfo().communication().size() == 1) {
+                    local_wells.push_back(w);
                 }
             }
         }
+
+        auto computePotentials = [this, &well_state_copy, &results](const int w)
+        {
+            auto& result = results[w];
+            try {
+                well_container_[w]->computeWellPotentials(ebosSimulator_, well_state_copy, result.potentials, result.logger);
+            } catch (const std::runtime_error& e) {
+                result.exc_type = ExceptionType::RUNTIME_ERROR;
+                result.exc_msg = e.what();
+            } catch (const std::invalid_argument& e) {
+                result.exc_type = ExceptionType::INVALID_ARGUMENT;
+                result.exc_msg = e.what();
+            } catch (const std::logic_error& e) {
+                result.exc_type = ExceptionType::LOGIC_ERROR;
+                result.exc_msg = e.what();
+            } catch (const std::exception& e) {
+                result.exc_type = ExceptionType::DEFAULT;
+                result.exc_msg = e.what();
+            }
+        };
+
+        // distributed wells communicate, all processes must handle them in the same order
+        for (const int w : compute_wells) {
+            if (well_container_[w]->parallelWellInfo().communication().size() > 1) {
+                computePotentials(w);
+            }
+        }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < static_cast<int>(local_wells.size()); ++i) {
+            computePotentials(local_wells[i]);
+        }
+
+        auto exc_type = ExceptionType::NONE;
+        std::string exc_msg;
+        auto& well_potentials = this->wellState().wellPotentials();
+        for (const int w : compute_wells) {
+            auto& result = results[w];
+            deferred_logger.append(result.logger);
+            if (result.exc_type != ExceptionType::NONE) {
+                exc_type = result.exc_type;
+                exc_msg = result.exc_msg;
+            }
+            // Store it in the well state
+            // potentials is resized and set to zero in the beginning of well->ComputeWellPotentials
+            // and updated only if sucessfull. i.e. the potentials are zero for exceptions
+            const int well_index = well_container_[w]->indexOfWell();
+            for (int p = 0; p < np; ++p) {
+                well_potentials[well_index * np + p] = std::abs(result.potentials[p]);
+            }
+        }
         logAndCheckForExceptionsAndThrow(deferred_logger, exc_type,
                                          "computeWellPotentials() failed: " + exc_msg,
                                          terminal_output_);
@@ -1649,6 +2286,36 @@ namespace Opm {
 
 
 
+    template <typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    calculateProductivityIndexValuesForOutput(const int reportStepIdx,
+                                              DeferredLogger& deferred_logger)
+    {
+        // The PI/II values of the well state are only used by the summary and
+        // restart output, WELPI scaling computes its own values. The values of
+        // the wells which are skipped are kept from the previous time step.
+        const SummaryConfig& summaryConfig = ebosSimulator_.vanguard().summaryConfig();
+        const bool write_restart_file = ebosSimulator_.vanguard().schedule().write_rst_file(reportStepIdx);
+        const bool connection_pi = summaryConfig.hasKeyword("CPI");
+        static const std::array<std::string, 5> well_pi_keywords = {"WPI", "WPIO", "WPIG", "WPIW", "WPIL"};
+
+        for (const auto& wellPtr : this->well_container_) {
+            const auto& name = wellPtr->name();
+            const bool needed = write_restart_file || connection_pi ||
+                std::any_of(well_pi_keywords.begin(), well_pi_keywords.end(),
+                            [&summaryConfig, &name](const std::string& keyword)
+                            { return summaryConfig.hasSummaryKey(keyword + ":" + name); });
+            if (needed) {
+                this->calculateProductivityIndexValues(wellPtr.get(), deferred_logger);
+            }
+        }
+    }
+
+
+
+
+
     template <typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -2752,25 +3419,56 @@ namespace Opm {
 
 
 
+    template<typename TypeTag>
+    double
+    BlackoilWellModel<TypeTag>::
+    connectionTransFactor_(const Well& well, const std::size_t conn_index) const
+    {
+        const double cf = well.getConnections()[conn_index].CF();
+        const auto it = connection_multipliers_.find(well.name());
+        if (it == connection_multipliers_.end() || conn_index >= it->second.size()) {
+            return cf;
+        }
+        return cf * it->second[conn_index];
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
     updateEclWells(const int timeStepIdx, const std::unordered_set<std::string>& wells) {
+        if (wells.empty()) {
+            return;
+        }
         const auto& schedule = this->ebosSimulator_.vanguard().schedule();
+        std::unordered_map<std::string, std::size_t> well_indices;
+        for (std::size_t well_index = 0; well_index < this->wells_ecl_.size(); ++well_index) {
+            well_indices.emplace(this->wells_ecl_[well_index].name(), well_index);
+        }
         for (const auto& wname : wells) {
-            auto well_iter = std::find_if( this->wells_ecl_.begin(), this->wells_ecl_.end(), [wname] (const auto& well) -> bool { return well.name() == wname;});
-            if (well_iter != this->wells_ecl_.end()) {
-                auto well_index = std::distance( this->wells_ecl_.begin(), well_iter );
-                this->wells_ecl_[well_index] = schedule.getWell(wname, timeStepIdx);
+            const auto well_iter = well_indices.find(wname);
+            if (well_iter != well_indices.end()) {
+                const auto well_index = well_iter->second;
+                const auto& schedule_well = schedule.getWell(wname, timeStepIdx);
+                if (this->wells_ecl_[well_index] == schedule_well) {
+                    // the action did not change this well
+                    continue;
+                }
+                this->wells_ecl_[well_index] = schedule_well;
 
                 const auto& well = this->wells_ecl_[well_index];
                 auto& pd     = this->well_perf_data_[well_index];
                 auto  pdIter = pd.begin();
+                std::size_t conn_index = 0;
                 for (const auto& conn : well.getConnections()) {
                     if (conn.state() != Connection::State::SHUT) {
-                        pdIter->connection_transmissibility_factor = conn.CF();
+                        pdIter->connection_transmissibility_factor = connectionTransFactor_(well, conn_index);
                         ++pdIter;
                     }
+                    ++conn_index;
                 }
                 this->wellState().updateStatus(well_index, well.getStatus());
                 this->wellState().resetConnectionTransFactors(well_index, pd);
@@ -2881,11 +3579,13 @@ namespace Opm {
             const auto& well = this->wells_ecl_[well_index];
             auto& pd     = this->well_perf_data_[well_index];
             auto  pdIter = pd.begin();
+            std::size_t conn_index = 0;
             for (const auto& conn : well.getConnections()) {
                 if (conn.state() != Connection::State::SHUT) {
-                    pdIter->connection_transmissibility_factor = conn.CF();
+                    pdIter->connection_transmissibility_factor = this->connectionTransFactor_(well, conn_index);
                     ++pdIter;
                 }
+                ++conn_index;
             }
             this->wellState().resetConnectionTransFactors(well_index, pd);
             this->prod_index_calc_[well_index].reInit(well);
@@ -86,6 +86,13 @@ GasLiftSingleWell(const StdWell &std_well,
         // TODO: adhoc value.. Should we keep max_iterations_ as a safety measure
         //   or does it not make sense to have it?
         this->max_iterations_ = 1000;
+
+        // The cached bhp values are reused as long as the inflow of the well at
+        // its bhp limit is unchanged, the tolerance is well below the one of the
+        // bhp solve in computeBhpAtThpLimitProdWithAlq()
+        std::vector<double> reference_rates(this->num_phases_, 0.0);
+        computeWellRates_(this->controls_.bhp_limit, reference_rates, /*debug_output=*/false);
+        this->std_well_.gliftCache().validate(reference_rates, 1.0e-6);
     }
 }
 
@@ -118,11 +125,19 @@ std::optional<double>
 GasLiftSingleWell<TypeTag>::
 computeBhpAtThpLimit_(double alq) const
 {
-    auto bhp_at_thp_limit = this->std_well_.computeBhpAtThpLimitProdWithAlq(
-        this->ebos_simulator_,
-        this->summary_state_,
-        this->deferred_logger_,
-        alq);
+    std::optional<double> bhp_at_thp_limit;
+    auto& cache = this->std_well_.gliftCache();
+    if (const auto* cached_bhp = cache.find(alq, ALQ_EPSILON)) {
+        bhp_at_thp_limit = *cached_bhp;
+    }
+    else {
+        bhp_at_thp_limit = this->std_well_.computeBhpAtThpLimitProdWithAlq(
+            this->ebos_simulator_,
+            this->summary_state_,
+            this->deferred_logger_,
+            alq);
+        cache.insert(alq, bhp_at_thp_limit);
+    }
     if (bhp_at_thp_limit) {
         if (*bhp_at_thp_limit < this->controls_.bhp_limit) {
             const std::string msg = fmt::format(
@@ -451,59 +451,87 @@ getGroupGliftWellsRecursive_(const Group &group,
     }
 }
 
+// The decremental and incremental gradients are synchronized together, such
+//   that each synchronization needs one allgather and one allgatherv.
 void
 GasLiftStage2::
-mpiSyncGlobalGradVector_(std::vector<GradPair> &grads_global) const
+mpiSyncGlobalGradVectors_(std::vector<GradPair> &dec_grads_global,
+                          std::vector<GradPair> &inc_grads_global) const
 {
     if (this->comm_.size() == 1)
         return;
 
-    std::vector<GradPair> grads_local;
-    for (auto itr = grads_global.begin(); itr != grads_global.end(); itr++) {
-        if (well_state_map_.count(itr->first) > 0) {
-            grads_local.push_back(*itr);
+    auto local_grads = [this](const std::vector<GradPair> &grads_global) {
+        std::vector<GradPair> grads_local;
+        for (auto itr = grads_global.begin(); itr != grads_global.end(); itr++) {
+            if (well_state_map_.count(itr->first) > 0) {
+                grads_local.push_back(*itr);
+            }
         }
-    }
-    mpiSyncLocalToGlobalGradVector_(grads_local, grads_global);
+        return grads_local;
+    };
+    mpiSyncLocalToGlobalGradVectors_(local_grads(dec_grads_global),
+                                     local_grads(inc_grads_global),
+                                     dec_grads_global, inc_grads_global);
 }
 
 void
 GasLiftStage2::
-mpiSyncLocalToGlobalGradVector_(
-    const std::vector<GradPair> &grads_local, std::vector<GradPair> &grads_global) const
+mpiSyncLocalToGlobalGradVectors_(
+    const std::vector<GradPair> &dec_grads_local,
+    const std::vector<GradPair> &inc_grads_local,
+    std::vector<GradPair> &dec_grads_global,
+    std::vector<GradPair> &inc_grads_global) const
 {
     assert(this->comm_.size() > 1);  // The parent should check if comm. size is > 1
     using Pair = std::pair<int, double>;
+    // the owned decremental gradients followed by the owned incremental gradients
     std::vector<Pair> grads_local_tmp;
-    grads_local_tmp.reserve(grads_local.size());
-    for (size_t i = 0; i < grads_local.size(); ++i) {
-        if(!this->well_state_.wellIsOwned(grads_local[i].first))
-            continue;
-        grads_local_tmp.push_back(
-           std::make_pair(
-              this->well_state_.wellNameToGlobalIdx(grads_local[i].first),
-              grads_local[i].second));
+    grads_local_tmp.reserve(dec_grads_local.size() + inc_grads_local.size());
+    auto addOwned = [this, &grads_local_tmp](const std::vector<GradPair> &grads_local) {
+        int count = 0;
+        for (size_t i = 0; i < grads_local.size(); ++i) {
+            if(!this->well_state_.wellIsOwned(grads_local[i].first))
+                continue;
+            grads_local_tmp.push_back(
+               std::make_pair(
+                  this->well_state_.wellNameToGlobalIdx(grads_local[i].first),
+                  grads_local[i].second));
+            ++count;
+        }
+        return count;
+    };
+    const int num_dec = addOwned(dec_grads_local);
+    const int num_inc = addOwned(inc_grads_local);
+
+    const int num_procs = this->comm_.size();
+    std::vector<int> counts(2 * num_procs);
+    const int my_counts[2] = {num_dec, num_inc};
+    this->comm_.allgather(my_counts, 2, counts.data());
+    std::vector<int> sizes_(num_procs);
+    for (int p = 0; p < num_procs; ++p) {
+        sizes_[p] = counts[2*p] + counts[2*p + 1];
     }
-
-    std::vector<int> sizes_(this->comm_.size());
-    std::vector<int> displ_(this->comm_.size() + 1, 0);
-    int mySize = grads_local_tmp.size();
-    this->comm_.allgather(&mySize, 1, sizes_.data());
+    std::vector<int> displ_(num_procs + 1, 0);
     std::partial_sum(sizes_.begin(), sizes_.end(), displ_.begin()+1);
     std::vector<Pair> grads_global_tmp(displ_.back());
 
     this->comm_.allgatherv(grads_local_tmp.data(), grads_local_tmp.size(),
         grads_global_tmp.data(), sizes_.data(), displ_.data());
 
-    // NOTE: This leaves the capacity of 'grads_global' unchanged, so
+    // NOTE: This leaves the capacity of the global vectors unchanged, so
     //   memory is not reallocated here
-    grads_global.clear();
-
-    for (size_t i = 0; i < grads_global_tmp.size(); ++i) {
-        grads_global.emplace_back(
-            std::make_pair(
-                well_state_.globalIdxToWellName(grads_global_tmp[i].first),
-                grads_global_tmp[i].second));
+    dec_grads_global.clear();
+    inc_grads_global.clear();
+
+    for (int p = 0; p < num_procs; ++p) {
+        for (int i = displ_[p]; i < displ_[p+1]; ++i) {
+            auto &grads_global = (i - displ_[p] < counts[2*p]) ? dec_grads_global : inc_grads_global;
+            grads_global.emplace_back(
+                std::make_pair(
+                    well_state_.globalIdxToWellName(grads_global_tmp[i].first),
+                    grads_global_tmp[i].second));
+        }
     }
 }
 
@@ -657,8 +685,8 @@ redistributeALQ_(std::vector<GasLiftSingleWell *> &wells,  const Group &group,
         dec_grads_local.reserve(wells.size());
         state.calculateEcoGradients(wells, inc_grads_local, dec_grads_local);
         // the gradients needs to be communicated to all ranks
-        mpiSyncLocalToGlobalGradVector_(dec_grads_local, dec_grads);
-        mpiSyncLocalToGlobalGradVector_(inc_grads_local, inc_grads);
+        mpiSyncLocalToGlobalGradVectors_(dec_grads_local, inc_grads_local,
+                                         dec_grads, inc_grads);
     }
 
     if (!state.checkAtLeastTwoWells(wells)) {
@@ -754,8 +782,7 @@ removeSurplusALQ_(const Group &group,
                         dec_grad_itr, /*increase=*/false, dec_grads, inc_grads);
 
             // The dec_grads and inc_grads needs to be syncronized across ranks
-            mpiSyncGlobalGradVector_(dec_grads);
-            mpiSyncGlobalGradVector_(inc_grads);
+            mpiSyncGlobalGradVectors_(dec_grads, inc_grads);
             // NOTE: recalculateGradientAndUpdateData_() will remove the current gradient
             //   from dec_grads if it cannot calculate a new decremental gradient.
             //   This will invalidate dec_grad_itr and well_name
@@ -955,8 +982,7 @@ recalculateGradients(
         min_dec_grad_itr, /*increase=*/false, dec_grads, inc_grads);
 
     // The dec_grads and inc_grads needs to be syncronized across ranks
-    this->parent.mpiSyncGlobalGradVector_(dec_grads);
-    this->parent.mpiSyncGlobalGradVector_(inc_grads);
+    this->parent.mpiSyncGlobalGradVectors_(dec_grads, inc_grads);
 }
 
 // Take one ALQ increment from well1, and give it to well2
@@ -121,10 +121,14 @@ class WellState;
             const std::string &name, GradInfo &grad, bool increase);
         void updateGradVector_(
             const std::string &name, std::vector<GradPair> &grads, double grad);
-        void mpiSyncGlobalGradVector_(std::vector<GradPair> &grads_global) const;
-        void mpiSyncLocalToGlobalGradVector_(
-            const std::vector<GradPair> &grads_local,
-            std::vector<GradPair> &grads_global) const;
+        void mpiSyncGlobalGradVectors_(
+            std::vector<GradPair> &dec_grads_global,
+            std::vector<GradPair> &inc_grads_global) const;
+        void mpiSyncLocalToGlobalGradVectors_(
+            const std::vector<GradPair> &dec_grads_local,
+            const std::vector<GradPair> &inc_grads_local,
+            std::vector<GradPair> &dec_grads_global,
+            std::vector<GradPair> &inc_grads_global) const;
 
 
         DeferredLogger &deferred_logger_;
@@ -20,8 +20,13 @@
 #ifndef OPM_GASLIFT_WELL_STATE_HEADER_INCLUDED
 #define OPM_GASLIFT_WELL_STATE_HEADER_INCLUDED
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <map>
 #include <optional>
 #include <utility>
+#include <vector>
 
 namespace Opm
 {
@@ -72,6 +77,62 @@ namespace Opm
         std::optional<bool> increase_;
     };
 
+    // The bhp at the thp limit as a function of the ALQ of a well, kept between the
+    // gas lift optimizations of the Newton iterations and time steps.
+    // The samples are only valid as long as the reservoir around the well does not
+    // change. This is checked by comparing the well rates at a reference bhp with
+    // the rates for which the samples were computed.
+    class GasLiftWellCache
+    {
+    public:
+        // Keep the samples if none of the reference rates changed by more than
+        // tolerance relative to the largest rate, drop them otherwise.
+        void validate(const std::vector<double>& reference_rates, double tolerance)
+        {
+            bool valid = reference_rates.size() == reference_rates_.size();
+            if (valid) {
+                double max_rate = 0.0;
+                double max_change = 0.0;
+                for (std::size_t i = 0; i < reference_rates.size(); ++i) {
+                    max_rate = std::max(max_rate, std::abs(reference_rates_[i]));
+                    max_change = std::max(max_change, std::abs(reference_rates[i] - reference_rates_[i]));
+                }
+                valid = max_change <= tolerance * max_rate;
+            }
+            if (!valid) {
+                samples_.clear();
+                reference_rates_ = reference_rates;
+            }
+        }
+
+        // The cached bhp for the alq, nullptr if there is none. The bhp itself
+        // is empty if it could not be computed for this alq.
+        const std::optional<double>* find(double alq, double alq_epsilon) const
+        {
+            auto it = samples_.lower_bound(alq - alq_epsilon);
+            if (it == samples_.end() || it->first > alq + alq_epsilon) {
+                ++misses_;
+                return nullptr;
+            }
+            ++hits_;
+            return &it->second;
+        }
+
+        void insert(double alq, std::optional<double> bhp)
+        {
+            samples_.insert_or_assign(alq, bhp);
+        }
+
+        int hits() const { return hits_; }
+        int misses() const { return misses_; }
+
+    private:
+        std::vector<double> reference_rates_;
+        std::map<double, std::optional<double>> samples_;
+        mutable int hits_ = 0;
+        mutable int misses_ = 0;
+    };
+
 } // namespace Opm
 
 #endif // OPM_GASLIFT_WELL_STATE_HEADER_INCLUDED
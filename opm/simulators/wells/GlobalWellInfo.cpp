@@ -41,6 +41,8 @@ GlobalWellInfo::GlobalWellInfo(const Schedule& sched, std::size_t report_step, c
         this->local_map.push_back( well.seqIndex() );
         this->is_injector.push_back( well.isInjector() );
     }
+    this->m_local_injecting_group.resize(this->local_map.size());
+    this->m_local_producing_group.resize(this->local_map.size());
 }
 
 
@@ -60,18 +62,28 @@ void GlobalWellInfo::update_group(const std::vector<Well::Status>& well_status,
     if (well_status.size() != this->local_map.size())
         throw std::logic_error("Size mismatch");
 
-    this->m_in_injecting_group.assign(this->name_map.size(), 0);
-    this->m_in_producing_group.assign(this->name_map.size(), 0);
     for (std::size_t well_index = 0; well_index < well_status.size(); well_index++) {
+        int injecting = 0;
+        int producing = 0;
         if (well_status[well_index] == Well::Status::OPEN) {
             if (this->is_injector[well_index]) {
                 if (injection_cmode[well_index] == Well::InjectorCMode::GRUP)
-                    this->m_in_injecting_group[this->local_map[well_index]] = 1;
+                    injecting = 1;
             } else {
                 if (production_cmode[well_index] == Well::ProducerCMode::GRUP)
-                    this->m_in_producing_group[this->local_map[well_index]] = 1;
+                    producing = 1;
             }
         }
+        if (injecting != this->m_local_injecting_group[well_index] ||
+            producing != this->m_local_producing_group[well_index])
+        {
+            this->m_local_injecting_group[well_index] = injecting;
+            this->m_local_producing_group[well_index] = producing;
+            // the local wells can be queried before communicate()
+            this->m_in_injecting_group[this->local_map[well_index]] = injecting;
+            this->m_in_producing_group[this->local_map[well_index]] = producing;
+            this->m_changed = true;
+        }
     }
 }
 
@@ -46,6 +46,10 @@ class Well;
 
   - Functionality to query well whether it is currently injecting or producing
     under group control.
+
+  The group control flags are only summed over the processes when the status
+  or the control of a local well on any process changed since the last time,
+  other calls only reduce a single flag.
 */
 
 
@@ -55,13 +59,26 @@ public:
 
     /*
       Will sum the m_in_injecting_group and m_in_producing_group vectors across
-      all processes, so that all processes can query for an arbitrary well.
+      all processes, so that all processes can query for an arbitrary well. The
+      sums are skipped if no process changed its local wells in update_group()
+      since the last call.
     */
     template <typename Comm>
     void communicate(const Comm& comm) {
+        if (comm.max(static_cast<int>(this->m_changed)) == 0)
+            return;
+
+        this->m_in_injecting_group.assign(this->name_map.size(), 0);
+        this->m_in_producing_group.assign(this->name_map.size(), 0);
+        for (std::size_t well_index = 0; well_index < this->local_map.size(); well_index++) {
+            this->m_in_injecting_group[this->local_map[well_index]] = this->m_local_injecting_group[well_index];
+            this->m_in_producing_group[this->local_map[well_index]] = this->m_local_producing_group[well_index];
+        }
+
         auto size = this->m_in_injecting_group.size();
         comm.sum( this->m_in_injecting_group.data(), size);
         comm.sum( this->m_in_producing_group.data(), size);
+        this->m_changed = false;
     };
 
 
@@ -80,6 +97,9 @@ private:
     std::map<std::string, std::size_t> name_map; // string -> global_index
     std::vector<int> m_in_injecting_group;       // global_index -> int/bool
     std::vector<int> m_in_producing_group;       // global_index -> int/bool
+    std::vector<int> m_local_injecting_group;    // local_index -> int/bool
+    std::vector<int> m_local_producing_group;    // local_index -> int/bool
+    bool m_changed = true;                       // whether the local flags changed since communicate()
 };
 
 
@@ -17,6 +17,7 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <iterator>
 
 #include <opm/json/JsonObject.hpp>
@@ -29,105 +30,149 @@ GroupState::GroupState(std::size_t np) :
     num_phases(np)
 {}
 
-bool GroupState::operator==(const GroupState& other) const {
-    return this->m_production_rates == other.m_production_rates &&
-           this->production_controls == other.production_controls &&
+bool GroupState::GroupData::operator==(const GroupData& other) const {
+    return this->production_rates == other.production_rates &&
+           this->production_control == other.production_control &&
            this->prod_red_rates == other.prod_red_rates &&
            this->inj_red_rates == other.inj_red_rates &&
            this->inj_resv_rates == other.inj_resv_rates &&
            this->inj_potentials == other.inj_potentials &&
            this->inj_rein_rates == other.inj_rein_rates &&
            this->inj_vrep_rate == other.inj_vrep_rate &&
-           this->m_grat_sales_target == other.m_grat_sales_target &&
+           this->grat_sales_target == other.grat_sales_target &&
            this->injection_controls == other.injection_controls;
 }
 
+bool GroupState::operator==(const GroupState& other) const {
+    if (this->m_groups.size() != other.m_groups.size())
+        return false;
+
+    if (this->m_group_names == other.m_group_names)
+        return this->m_groups == other.m_groups;
+
+    // The same groups added in a different order.
+    for (std::size_t index = 0; index < this->m_groups.size(); ++index) {
+        const auto* other_group = other.find_group(this->m_group_names[index]);
+        if (other_group == nullptr || !(*other_group == this->m_groups[index]))
+            return false;
+    }
+    return true;
+}
+
+const GroupState::GroupData* GroupState::find_group(const std::string& gname) const {
+    auto index_iter = this->m_group_index.find(gname);
+    if (index_iter == this->m_group_index.end())
+        return nullptr;
+
+    return &this->m_groups[index_iter->second];
+}
+
+GroupState::GroupData& GroupState::group(const std::string& gname) {
+    auto [index_iter, inserted] = this->m_group_index.try_emplace(gname, this->m_groups.size());
+    if (inserted) {
+        this->m_groups.emplace_back();
+        this->m_group_names.push_back(gname);
+    }
+    return this->m_groups[index_iter->second];
+}
+
+std::vector<std::size_t> GroupState::sorted_groups() const {
+    std::vector<std::size_t> order(this->m_groups.size());
+    for (std::size_t index = 0; index < order.size(); ++index)
+        order[index] = index;
+
+    std::sort(order.begin(), order.end(), [this](std::size_t i1, std::size_t i2) {
+        return this->m_group_names[i1] < this->m_group_names[i2];
+    });
+    return order;
+}
+
 //-------------------------------------------------------------------------
 
 bool GroupState::has_production_rates(const std::string& gname) const {
-    auto group_iter = this->m_production_rates.find(gname);
-    return (group_iter != this->m_production_rates.end());
+    const auto* group = this->find_group(gname);
+    return group != nullptr && group->production_rates.has_value();
 }
 
 void GroupState::update_production_rates(const std::string& gname, const std::vector<double>& rates) {
     if (rates.size() != this->num_phases)
         throw std::logic_error("Wrong number of phases");
 
-    this->m_production_rates[gname] = rates;
+    this->group(gname).production_rates = rates;
 }
 
 const std::vector<double>& GroupState::production_rates(const std::string& gname) const {
-    auto group_iter = this->m_production_rates.find(gname);
-    if (group_iter == this->m_production_rates.end())
+    const auto* group = this->find_group(gname);
+    if (group == nullptr || !group->production_rates)
         throw std::logic_error("No such group");
 
-    return group_iter->second;
+    return *group->production_rates;
 }
 
 //-------------------------------------------------------------------------
 
 bool GroupState::has_production_reduction_rates(const std::string& gname) const {
-    auto group_iter = this->prod_red_rates.find(gname);
-    return (group_iter != this->prod_red_rates.end());
+    const auto* group = this->find_group(gname);
+    return group != nullptr && group->prod_red_rates.has_value();
 }
 
 void GroupState::update_production_reduction_rates(const std::string& gname, const std::vector<double>& rates) {
     if (rates.size() != this->num_phases)
         throw std::logic_error("Wrong number of phases");
 
-    this->prod_red_rates[gname] = rates;
+    this->group(gname).prod_red_rates = rates;
 }
 
 const std::vector<double>& GroupState::production_reduction_rates(const std::string& gname) const {
-    auto group_iter = this->prod_red_rates.find(gname);
-    if (group_iter == this->prod_red_rates.end())
+    const auto* group = this->find_group(gname);
+    if (group == nullptr || !group->prod_red_rates)
         throw std::logic_error("No such group");
 
-    return group_iter->second;
+    return *group->prod_red_rates;
 }
 
 //-------------------------------------------------------------------------
 
 bool GroupState::has_injection_reduction_rates(const std::string& gname) const {
-    auto group_iter = this->inj_red_rates.find(gname);
-    return (group_iter != this->inj_red_rates.end());
+    const auto* group = this->find_group(gname);
+    return group != nullptr && group->inj_red_rates.has_value();
 }
 
 void GroupState::update_injection_reduction_rates(const std::string& gname, const std::vector<double>& rates) {
     if (rates.size() != this->num_phases)
         throw std::logic_error("Wrong number of phases");
 
-    this->inj_red_rates[gname] = rates;
+    this->group(gname).inj_red_rates = rates;
 }
 
 const std::vector<double>& GroupState::injection_reduction_rates(const std::string& gname) const {
-    auto group_iter = this->inj_red_rates.find(gname);
-    if (group_iter == this->inj_red_rates.end())
+    const auto* group = this->find_group(gname);
+    if (group == nullptr || !group->inj_red_rates)
         throw std::logic_error("No such group");
 
-    return group_iter->second;
+    return *group->inj_red_rates;
 }
 
 //-------------------------------------------------------------------------
 
 bool GroupState::has_injection_reservoir_rates(const std::string& gname) const {
-    auto group_iter = this->inj_resv_rates.find(gname);
-    return (group_iter != this->inj_resv_rates.end());
+    const auto* group = this->find_group(gname);
+    return group != nullptr && group->inj_resv_rates.has_value();
 }
 
 void GroupState::update_injection_reservoir_rates(const std::string& gname, const std::vector<double>& rates) {
     if (rates.size() != this->num_phases)
         throw std::logic_error("Wrong number of phases");
 
-    this->inj_resv_rates[gname] = rates;
+    this->group(gname).inj_resv_rates = rates;
 }
 
 const std::vector<double>& GroupState::injection_reservoir_rates(const std::string& gname) const {
-    auto group_iter = this->inj_resv_rates.find(gname);
-    if (group_iter == this->inj_resv_rates.end())
+    const auto* group = this->find_group(gname);
+    if (group == nullptr || !group->inj_resv_rates)
         throw std::logic_error("No such group");
 
-    return group_iter->second;
+    return *group->inj_resv_rates;
 }
 
 //-------------------------------------------------------------------------
@@ -136,47 +181,48 @@ void GroupState::update_injection_rein_rates(const std::string& gname, const std
     if (rates.size() != this->num_phases)
         throw std::logic_error("Wrong number of phases");
 
-    this->inj_rein_rates[gname] = rates;
+    this->group(gname).inj_rein_rates = rates;
 }
 
 const std::vector<double>& GroupState::injection_rein_rates(const std::string& gname) const {
-    auto group_iter = this->inj_rein_rates.find(gname);
-    if (group_iter == this->inj_rein_rates.end())
+    const auto* group = this->find_group(gname);
+    if (group == nullptr || !group->inj_rein_rates)
         throw std::logic_error("No such group");
 
-    return group_iter->second;
+    return *group->inj_rein_rates;
 }
 
 //-------------------------------------------------------------------------
 
 void GroupState::update_injection_vrep_rate(const std::string& gname, double rate) {
-    this->inj_vrep_rate[gname] = rate;
+    this->group(gname).inj_vrep_rate = rate;
 }
 
 double GroupState::injection_vrep_rate(const std::string& gname) const {
-    auto group_iter = this->inj_vrep_rate.find(gname);
-    if (group_iter == this->inj_vrep_rate.end())
+    const auto* group = this->find_group(gname);
+    if (group == nullptr || !group->inj_vrep_rate)
         throw std::logic_error("No such group");
 
-    return group_iter->second;
+    return *group->inj_vrep_rate;
 }
 
 //-------------------------------------------------------------------------
 
 void GroupState::update_grat_sales_target(const std::string& gname, double target) {
-    this->m_grat_sales_target[gname] = target;
+    this->group(gname).grat_sales_target = target;
 }
 
 double GroupState::grat_sales_target(const std::string& gname) const {
-    auto group_iter = this->m_grat_sales_target.find(gname);
-    if (group_iter == this->m_grat_sales_target.end())
+    const auto* group = this->find_group(gname);
+    if (group == nullptr || !group->grat_sales_target)
         throw std::logic_error("No such group");
 
-    return group_iter->second;
+    return *group->grat_sales_target;
 }
 
 bool GroupState::has_grat_sales_target(const std::string& gname) const {
-    return (this->m_grat_sales_target.count(gname) > 0);
+    const auto* group = this->find_group(gname);
+    return group != nullptr && group->grat_sales_target.has_value();
 }
 
 //-------------------------------------------------------------------------
@@ -185,56 +231,78 @@ void GroupState::update_injection_potentials(const std::string& gname, const std
     if (potentials.size() != this->num_phases)
         throw std::logic_error("Wrong number of phases");
 
-    this->inj_potentials[gname] = potentials;
+    this->group(gname).inj_potentials = potentials;
 }
 
 const std::vector<double>& GroupState::injection_potentials(const std::string& gname) const {
-    auto group_iter = this->inj_potentials.find(gname);
-    if (group_iter == this->inj_potentials.end())
+    const auto* group = this->find_group(gname);
+    if (group == nullptr || !group->inj_potentials)
         throw std::logic_error("No such group");
 
-    return group_iter->second;
+    return *group->inj_potentials;
 }
 
 //-------------------------------------------------------------------------
 
 bool GroupState::has_production_control(const std::string& gname) const {
-    auto group_iter = this->production_controls.find(gname);
-    if (group_iter == this->production_controls.end())
-        return false;
-
-    return true;
+    const auto* group = this->find_group(gname);
+    return group != nullptr && group->production_control.has_value();
 }
 
 void GroupState::production_control(const std::string& gname, Group::ProductionCMode cmode) {
-    this->production_controls[gname] = cmode;
+    this->group(gname).production_control = cmode;
 }
 
 Group::ProductionCMode GroupState::production_control(const std::string& gname) const {
-    auto group_iter = this->production_controls.find(gname);
-    if (group_iter == this->production_controls.end())
+    const auto* group = this->find_group(gname);
+    if (group == nullptr || !group->production_control)
         throw std::logic_error("Could not find any control for production group: " + gname);
 
-    return group_iter->second;
+    return *group->production_control;
 }
 
 //-------------------------------------------------------------------------
 
+namespace {
+
+template <typename Controls>
+auto find_control(Controls& controls, Phase phase) {
+    return std::find_if(controls.begin(), controls.end(),
+                        [phase](const auto& control) { return control.first == phase; });
+}
+
+}
+
 bool GroupState::has_injection_control(const std::string& gname, Phase phase) const {
-    return this->injection_controls.count(std::make_pair(phase, gname)) > 0;
+    const auto* group = this->find_group(gname);
+    if (group == nullptr)
+        return false;
+
+    return find_control(group->injection_controls, phase) != group->injection_controls.end();
 }
 
 void GroupState::injection_control(const std::string& gname, Phase phase, Group::InjectionCMode cmode) {
-    this->injection_controls[ std::make_pair(phase, gname) ] = cmode;
+    auto& controls = this->group(gname).injection_controls;
+    auto control_iter = find_control(controls, phase);
+    if (control_iter != controls.end()) {
+        control_iter->second = cmode;
+        return;
+    }
+
+    auto pos = std::find_if(controls.begin(), controls.end(),
+                            [phase](const auto& control) { return phase < control.first; });
+    controls.emplace(pos, phase, cmode);
 }
 
 Group::InjectionCMode GroupState::injection_control(const std::string& gname, Phase phase) const {
-    auto key = std::make_pair(phase, gname);
-    auto group_iter = this->injection_controls.find( key );
-    if (group_iter == this->injection_controls.end())
-        throw std::logic_error("Could not find ontrol for injection group: " + gname);
+    const auto* group = this->find_group(gname);
+    if (group != nullptr) {
+        auto control_iter = find_control(group->injection_controls, phase);
+        if (control_iter != group->injection_controls.end())
+            return control_iter->second;
+    }
 
-    return group_iter->second;
+    throw std::logic_error("Could not find ontrol for injection group: " + gname);
 }
 
 //-------------------------------------------------------------------------
@@ -250,49 +318,54 @@ void dump_vector(Json::JsonObject& root, const std::string& key, const std::vect
 
 
 template <typename T>
-void dump_groupmap(Json::JsonObject& root, const std::string& key, const std::map<std::string, std::vector<T>>& group_data) {
-    auto map_obj = root.add_object(key);
-    for (const auto& [gname, data] : group_data)
-        dump_vector(map_obj, gname, data);
+void dump_groupvalue(Json::JsonObject& map_obj, const std::string& gname, const std::vector<T>& data) {
+    dump_vector(map_obj, gname, data);
 }
 
-
 template <typename T>
-void dump_groupmap(Json::JsonObject& root, const std::string& key, const std::map<std::string, T>& group_data) {
-    auto map_obj = root.add_object(key);
-    for (const auto& [gname, value] : group_data)
-        map_obj.add_item(gname, value);
+void dump_groupvalue(Json::JsonObject& map_obj, const std::string& gname, const T& value) {
+    map_obj.add_item(gname, value);
 }
 
 }
 
 std::string GroupState::dump() const
 {
+    const auto order = this->sorted_groups();
+    auto dump_groupmap = [this, &order](Json::JsonObject& root, const std::string& key, auto member) {
+        auto map_obj = root.add_object(key);
+        for (const auto index : order) {
+            const auto& value = this->m_groups[index].*member;
+            if (value)
+                dump_groupvalue(map_obj, this->m_group_names[index], *value);
+        }
+    };
+
     Json::JsonObject root;
-    dump_groupmap(root, "production_rates", this->m_production_rates);
-    dump_groupmap(root, "prod_red_rates", this->prod_red_rates);
-    dump_groupmap(root, "inj_red_rates", this->inj_red_rates);
-    dump_groupmap(root, "inj_resv_rates", this->inj_resv_rates);
-    dump_groupmap(root, "inj_potentials", this->inj_potentials);
-    dump_groupmap(root, "inj_rein_rates", this->inj_rein_rates);
-    dump_groupmap(root, "vrep_rate", this->inj_vrep_rate);
-    dump_groupmap(root, "grat_sales_target", this->m_grat_sales_target);
+    dump_groupmap(root, "production_rates", &GroupData::production_rates);
+    dump_groupmap(root, "prod_red_rates", &GroupData::prod_red_rates);
+    dump_groupmap(root, "inj_red_rates", &GroupData::inj_red_rates);
+    dump_groupmap(root, "inj_resv_rates", &GroupData::inj_resv_rates);
+    dump_groupmap(root, "inj_potentials", &GroupData::inj_potentials);
+    dump_groupmap(root, "inj_rein_rates", &GroupData::inj_rein_rates);
+    dump_groupmap(root, "vrep_rate", &GroupData::inj_vrep_rate);
+    dump_groupmap(root, "grat_sales_target", &GroupData::grat_sales_target);
     {
-        std::map<std::string, int> int_controls;
-        for (const auto& [gname, control] : this->production_controls)
-            int_controls.insert({gname, static_cast<int>(control)});
-        dump_groupmap(root, "production_controls", int_controls);
+        auto map_obj = root.add_object("production_controls");
+        for (const auto index : order) {
+            const auto& control = this->m_groups[index].production_control;
+            if (control)
+                map_obj.add_item(this->m_group_names[index], static_cast<int>(*control));
+        }
     }
     {
-        std::map<std::string, std::vector<std::pair<Opm::Phase, Group::InjectionCMode>>> inj_cntrl;
-        for (const auto& [phase_name, cmode] : this->injection_controls) {
-            const auto& [phase, gname] = phase_name;
-            inj_cntrl[gname].emplace_back(phase, cmode);
-        }
-
         auto map_obj = root.add_object("injection_controls");
-        for (const auto& [gname, phase_cmode] : inj_cntrl) {
-            auto group_array = map_obj.add_array(gname);
+        for (const auto index : order) {
+            const auto& phase_cmode = this->m_groups[index].injection_controls;
+            if (phase_cmode.empty())
+                continue;
+
+            auto group_array = map_obj.add_array(this->m_group_names[index]);
             for (const auto& [phase, cmode] : phase_cmode) {
                 auto control_pair = group_array.add_array();
                 control_pair.add(static_cast<int>(phase));
@@ -20,7 +20,11 @@
 #ifndef OPM_GROUPSTATE_HEADER_INCLUDED
 #define OPM_GROUPSTATE_HEADER_INCLUDED
 
-#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <opm/core/props/BlackoilPhases.hpp>
@@ -83,22 +87,29 @@ public:
         // the forAllGroupData() function, since it contains single doubles,
         // not vectors.
 
+        // The groups are visited in the order of their names, such that all
+        // processes agree on the layout of the data also if they added the
+        // groups in different order.
+        const auto order = this->sorted_groups();
+
         // Create a function that calls some function
         // for all the individual data items to simplify
         // the further code.
-        auto iterateContainer = [](auto& container, auto& func) {
-            for (auto& x : container) {
-                func(x.second);
+        auto iterateContainer = [this, &order](auto member, auto& func) {
+            for (const auto index : order) {
+                auto& value = this->m_groups[index].*member;
+                if (value)
+                    func(*value);
             }
         };
 
 
         auto forAllGroupData = [&](auto& func) {
-            iterateContainer(m_production_rates, func);
-            iterateContainer(prod_red_rates, func);
-            iterateContainer(inj_red_rates, func);
-            iterateContainer(inj_resv_rates, func);
-            iterateContainer(inj_rein_rates, func);
+            iterateContainer(&GroupData::production_rates, func);
+            iterateContainer(&GroupData::prod_red_rates, func);
+            iterateContainer(&GroupData::inj_red_rates, func);
+            iterateContainer(&GroupData::inj_resv_rates, func);
+            iterateContainer(&GroupData::inj_rein_rates, func);
         };
 
         // Compute the size of the data.
@@ -107,7 +118,10 @@ public:
             sz += v.size();
         };
         forAllGroupData(computeSize);
-        sz += this->inj_vrep_rate.size();
+        auto countVrep = [&sz](const double) {
+            sz += 1;
+        };
+        iterateContainer(&GroupData::inj_vrep_rate, countVrep);
 
         // Make a vector and collect all data into it.
         std::vector<double> data(sz);
@@ -124,9 +138,10 @@ public:
             }
         };
         forAllGroupData(collect);
-        for (const auto& x : this->inj_vrep_rate) {
-            data[pos++] = x.second;
-        }
+        auto collectVrep = [&data, &pos](const double x) {
+            data[pos++] = x;
+        };
+        iterateContainer(&GroupData::inj_vrep_rate, collectVrep);
         if (pos != sz)
             throw std::logic_error("Internal size mismatch when collecting groupData");
 
@@ -141,9 +156,10 @@ public:
             }
         };
         forAllGroupData(distribute);
-        for (auto& x : this->inj_vrep_rate) {
-            x.second = data[pos++];
-        }
+        auto distributeVrep = [&data, &pos](double& x) {
+            x = data[pos++];
+        };
+        iterateContainer(&GroupData::inj_vrep_rate, distributeVrep);
         if (pos != sz)
             throw std::logic_error("Internal size mismatch when distributing groupData");
     }
@@ -152,19 +168,34 @@ public:
 
 
 private:
+    // All the quantities of one group, a quantity which has not been set is
+    // empty.
+    struct GroupData {
+        std::optional<std::vector<double>> production_rates;
+        std::optional<Group::ProductionCMode> production_control;
+        std::optional<std::vector<double>> prod_red_rates;
+        std::optional<std::vector<double>> inj_red_rates;
+        std::optional<std::vector<double>> inj_resv_rates;
+        std::optional<std::vector<double>> inj_potentials;
+        std::optional<std::vector<double>> inj_rein_rates;
+        std::optional<double> inj_vrep_rate;
+        std::optional<double> grat_sales_target;
+        // sorted by phase
+        std::vector<std::pair<Phase, Group::InjectionCMode>> injection_controls;
+
+        bool operator==(const GroupData& other) const;
+    };
+
+    const GroupData* find_group(const std::string& gname) const;
+    GroupData& group(const std::string& gname);
+    std::vector<std::size_t> sorted_groups() const;
+
     std::size_t num_phases;
-    std::map<std::string, std::vector<double>> m_production_rates;
-    std::map<std::string, Group::ProductionCMode> production_controls;
-    std::map<std::string, std::vector<double>> prod_red_rates;
-    std::map<std::string, std::vector<double>> inj_red_rates;
-    std::map<std::string, std::vector<double>> inj_resv_rates;
-    std::map<std::string, std::vector<double>> inj_potentials;
-    std::map<std::string, std::vector<double>> inj_rein_rates;
-    std::map<std::string, double> inj_vrep_rate;
-    std::map<std::string, double> m_grat_sales_target;
-
-
-    std::map<std::pair<Phase, std::string>, Group::InjectionCMode> injection_controls;
+    // The groups are stored in the order they were first updated, the names
+    // are only looked up once per call.
+    std::vector<GroupData> m_groups;
+    std::vector<std::string> m_group_names;
+    std::unordered_map<std::string, std::size_t> m_group_index;
 };
 
 }
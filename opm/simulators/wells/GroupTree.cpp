@@ -0,0 +1,147 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/wells/GroupTree.hpp>
+
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Group/Group.hpp>
+#include <opm/simulators/wells/GroupState.hpp>
+#include <opm/simulators/wells/WellContainer.hpp>
+#include <opm/simulators/wells/WellState.hpp>
+
+#include <functional>
+
+namespace Opm {
+
+GroupTree::GroupTree(const Schedule& schedule, const int report_step, const WellState& well_state)
+    : report_step_(report_step)
+{
+    const auto& well_map = well_state.wellMap();
+
+    std::function<int(const Group&, int)> addGroup = [&](const Group& group, int parent) {
+        const int idx = names_.size();
+        names_.push_back(group.name());
+        parents_.push_back(parent);
+        efficiencies_.push_back(group.getGroupEfficiencyFactor());
+        children_.emplace_back();
+        wells_.emplace_back(group.wells().begin(), group.wells().end());
+        local_wells_.emplace_back();
+        index_.emplace(group.name(), idx);
+
+        for (const std::string& wellName : group.wells()) {
+            const auto it = well_map.find(wellName);
+            if (it == well_map.end()) // the well is not on this process
+                continue;
+
+            const int well_index = it->second[0];
+            if (!well_state.wellIsOwned(well_index, wellName)) // Only sum once
+                continue;
+
+            const auto& wellEcl = schedule.getWell(wellName, report_step);
+            if (wellEcl.getStatus() == Well::Status::SHUT)
+                continue;
+
+            local_wells_[idx].push_back({static_cast<std::size_t>(well_index),
+                                         wellEcl.getEfficiencyFactor(),
+                                         wellEcl.isInjector()});
+        }
+
+        for (const std::string& groupName : group.groups()) {
+            const int child = addGroup(schedule.getGroup(groupName, report_step), idx);
+            children_[idx].push_back(child);
+        }
+        return idx;
+    };
+    addGroup(schedule.getGroup("FIELD", report_step), -1);
+}
+
+int GroupTree::index(const std::string& gname) const
+{
+    const auto it = index_.find(gname);
+    return it == index_.end() ? -1 : it->second;
+}
+
+std::vector<double>
+GroupTree::sumWellPhaseRates(const WellContainer<std::vector<double>>& rates,
+                             const int num_phases,
+                             const bool injector) const
+{
+    const std::size_t np = num_phases;
+    std::vector<double> sums(numGroups() * np, 0.0);
+    for (std::size_t group = numGroups(); group-- > 0;) {
+        double* rate = sums.data() + group * np;
+        for (const int child : children_[group]) {
+            for (std::size_t phase = 0; phase < np; ++phase) {
+                rate[phase] += sums[child * np + phase];
+            }
+        }
+        for (const auto& well : local_wells_[group]) {
+            // only count producers or injectors
+            if (well.is_injector != injector)
+                continue;
+
+            const auto& well_rates = rates[well.well_index];
+            for (std::size_t phase = 0; phase < np; ++phase) {
+                if (injector)
+                    rate[phase] += well.efficiency * well_rates[phase];
+                else
+                    rate[phase] -= well.efficiency * well_rates[phase];
+            }
+        }
+        for (std::size_t phase = 0; phase < np; ++phase) {
+            rate[phase] *= efficiencies_[group];
+        }
+    }
+    return sums;
+}
+
+std::vector<int>
+GroupTree::groupControlledWells(const WellState& well_state,
+                                const GroupState& group_state,
+                                const bool is_production_group,
+                                const Phase injection_phase) const
+{
+    std::vector<int> num_wells(numGroups(), 0);
+    for (std::size_t group = numGroups(); group-- > 0;) {
+        for (const int child : children_[group]) {
+            bool included = false;
+            if (is_production_group) {
+                const auto ctrl = group_state.production_control(names_[child]);
+                included = (ctrl == Group::ProductionCMode::FLD) || (ctrl == Group::ProductionCMode::NONE);
+            } else {
+                const auto ctrl = group_state.injection_control(names_[child], injection_phase);
+                included = (ctrl == Group::InjectionCMode::FLD) || (ctrl == Group::InjectionCMode::NONE);
+            }
+            if (included) {
+                num_wells[group] += num_wells[child];
+            }
+        }
+        for (const std::string& wellName : wells_[group]) {
+            const bool included = is_production_group ? well_state.isProductionGrup(wellName)
+                                                      : well_state.isInjectionGrup(wellName);
+            if (included) {
+                ++num_wells[group];
+            }
+        }
+    }
+    return num_wells;
+}
+
+} // namespace Opm
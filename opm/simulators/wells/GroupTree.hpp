@@ -0,0 +1,106 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GROUPTREE_HEADER_INCLUDED
+#define OPM_GROUPTREE_HEADER_INCLUDED
+
+#include <opm/parser/eclipse/EclipseState/Runspec.hpp>
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Opm {
+
+class GroupState;
+class Schedule;
+class WellState;
+
+template <typename>
+class WellContainer;
+
+/// The group tree of one report step, flattened into index based arrays.
+///
+/// The groups are stored in depth first order starting with FIELD, so a
+/// group always comes before its subgroups. Traversing the groups in
+/// reverse order therefore visits the subgroups of a group before the
+/// group itself, which lets the group rates be aggregated bottom-up in a
+/// single pass without looking up groups and wells by name.
+///
+/// The tree depends on the schedule and on the wells of the well state
+/// on this process, it must be rebuilt at the start of every report step.
+class GroupTree {
+public:
+    struct LocalWell {
+        std::size_t well_index; // index in the well state
+        double efficiency;
+        bool is_injector;
+    };
+
+    GroupTree(const Schedule& schedule, const int report_step, const WellState& well_state);
+
+    int reportStep() const { return report_step_; }
+    std::size_t numGroups() const { return names_.size(); }
+
+    const std::string& name(std::size_t group) const { return names_[group]; }
+    /// Index of the group, -1 if it is not part of the tree.
+    int index(const std::string& gname) const;
+    /// Index of the parent group, -1 for FIELD.
+    int parent(std::size_t group) const { return parents_[group]; }
+    double efficiency(std::size_t group) const { return efficiencies_[group]; }
+
+    /// Direct subgroups, in the order of the schedule.
+    const std::vector<int>& children(std::size_t group) const { return children_[group]; }
+
+    /// Names of all wells of the group, also the ones on other processes.
+    const std::vector<std::string>& wells(std::size_t group) const { return wells_[group]; }
+
+    /// Open wells of the group which are owned by this process.
+    const std::vector<LocalWell>& localWells(std::size_t group) const { return local_wells_[group]; }
+
+    /// The well rates of the open producers, or injectors, of this process summed
+    /// for all groups, including the efficiency factors, like
+    /// WellGroupHelpers::sumWellPhaseRates(). Producers count positive.
+    /// The result holds num_phases values per group.
+    std::vector<double> sumWellPhaseRates(const WellContainer<std::vector<double>>& rates,
+                                          const int num_phases,
+                                          const bool injector) const;
+
+    /// The number of wells under group control below each group, like
+    /// WellGroupHelpers::groupControlledWells() without an always included child.
+    std::vector<int> groupControlledWells(const WellState& well_state,
+                                          const GroupState& group_state,
+                                          const bool is_production_group,
+                                          const Phase injection_phase) const;
+
+private:
+    int report_step_;
+    std::vector<std::string> names_;
+    std::vector<int> parents_;
+    std::vector<double> efficiencies_;
+    std::vector<std::vector<int>> children_;
+    std::vector<std::vector<std::string>> wells_;
+    std::vector<std::vector<LocalWell>> local_wells_;
+    std::unordered_map<std::string, int> index_;
+};
+
+} // namespace Opm
+
+#endif // OPM_GROUPTREE_HEADER_INCLUDED
@@ -29,6 +29,9 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/MSW/SICD.hpp>
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <cassert>
 #include <dune/istl/solvers.hh>
 #if HAVE_UMFPACK
 #include <dune/istl/umfpack.hh>
@@ -169,6 +172,141 @@ namespace mswellhelpers
 
 
 
+    /// Direct solver for the D matrix of a multisegment well.
+    ///
+    /// The segments of a well form a tree, so D only couples a segment with
+    /// its outlet and its inlets. Eliminating the segments from the leaves
+    /// towards the top segment gives a block LU factorization without any
+    /// fill-in. The elimination order only depends on the segment topology
+    /// and is computed once in init(); factorize() only redoes the numerical
+    /// part and is needed whenever the values of D change.
+    template <typename MatrixType, typename VectorType>
+    class SegmentTreeSolver
+    {
+    public:
+        using Block = typename MatrixType::block_type;
+        using VectorBlock = typename VectorType::block_type;
+
+        /// \param[in] outlets  index of the outlet segment of each segment, -1 for the top segment
+        void init(const std::vector<int>& outlets)
+        {
+            const int n = outlets.size();
+            outlets_ = outlets;
+            inlets_.assign(n, {});
+            order_.clear();
+            order_.reserve(n);
+            std::vector<int> roots;
+            for (int seg = 0; seg < n; ++seg) {
+                if (outlets_[seg] < 0) {
+                    roots.push_back(seg);
+                } else {
+                    inlets_[outlets_[seg]].push_back(seg);
+                }
+            }
+            // pre-order traversal from the top segment, reversed below so
+            // that every segment comes after all of its inlets
+            std::vector<int> stack(roots.rbegin(), roots.rend());
+            while (!stack.empty()) {
+                const int seg = stack.back();
+                stack.pop_back();
+                order_.push_back(seg);
+                for (const int inlet : inlets_[seg]) {
+                    stack.push_back(inlet);
+                }
+            }
+            std::reverse(order_.begin(), order_.end());
+            valid_topology_ = (static_cast<int>(order_.size()) == n);
+            invalidate();
+        }
+
+        /// Discard the numerical factorization, to be called whenever D changes.
+        void invalidate()
+        {
+            factorized_ = false;
+            failed_ = false;
+        }
+
+        /// Whether the D matrix can be solved with this solver,
+        /// computes the numerical factorization if not yet done.
+        /// Returns false if the topology is not a tree or a pivot block is singular.
+        bool factorize(const MatrixType& D)
+        {
+            if (factorized_) {
+                return true;
+            }
+            if (failed_ || !valid_topology_) {
+                return false;
+            }
+            pivots_.resize(order_.size());
+            try {
+                for (const int seg : order_) {
+                    Block pivot = D[seg][seg];
+                    for (const int inlet : inlets_[seg]) {
+                        Block tmp = D[seg][inlet];
+                        tmp.rightmultiply(pivots_[inlet]);
+                        tmp.rightmultiply(D[inlet][seg]);
+                        pivot -= tmp;
+                    }
+                    pivot.invert();
+                    pivots_[seg] = pivot;
+                }
+            } catch (const Dune::FMatrixError&) {
+                failed_ = true;
+                return false;
+            }
+            factorized_ = true;
+            return true;
+        }
+
+        /// Solve D y = x, factorize() must have returned true for the same D.
+        VectorType solve(const MatrixType& D, VectorType x) const
+        {
+            assert(factorized_);
+            // eliminate the inlets from the leaves towards the top segment
+            VectorBlock tmp;
+            for (const int seg : order_) {
+                for (const int inlet : inlets_[seg]) {
+                    pivots_[inlet].mv(x[inlet], tmp);
+                    D[seg][inlet].mmv(tmp, x[seg]);
+                }
+            }
+            // back substitution from the top segment towards the leaves
+            VectorType y(x.size());
+            for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+                const int seg = *it;
+                if (outlets_[seg] >= 0) {
+                    D[seg][outlets_[seg]].mmv(y[outlets_[seg]], x[seg]);
+                }
+                pivots_[seg].mv(x[seg], y[seg]);
+            }
+
+            for (size_t i_block = 0; i_block < y.size(); ++i_block) {
+                for (size_t i_elem = 0; i_elem < y[i_block].size(); ++i_elem) {
+                    if (std::isinf(y[i_block][i_elem]) || std::isnan(y[i_block][i_elem]) ) {
+                        const std::string msg{"nan or inf value found after segment tree solve due to singular matrix"};
+                        OpmLog::debug(msg);
+                        OPM_THROW_NOLOG(NumericalIssue, msg);
+                    }
+                }
+            }
+            return y;
+        }
+
+    private:
+        std::vector<int> outlets_;
+        std::vector<std::vector<int>> inlets_;
+        // elimination order, every segment comes after all of its inlets
+        std::vector<int> order_;
+        // inverted pivot blocks of the factorization
+        std::vector<Block> pivots_;
+        bool valid_topology_ = false;
+        bool factorized_ = false;
+        bool failed_ = false;
+    };
+
+
+
+
     template <typename ValueType>
     inline ValueType haalandFormular(const ValueType& re, const double diameter, const double roughness)
     {
@@ -163,7 +163,7 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const override;
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
         /// add the contribution (C, D, B matrices) of this Well to the WellContributions object
         void addWellContribution(WellContributions& wellContribs) const;
 #endif
@@ -195,6 +195,8 @@ namespace Opm
 
         virtual void  addWellContributions(SparseMatrixAdapter& jacobian) const override;
 
+        virtual void addWellContributionsInPattern(typename SparseMatrixAdapter::IstlMatrix& mat) const override;
+
         /// number of segments for this well
         /// int number_of_segments_;
         int numberOfSegments() const;
@@ -297,6 +299,9 @@ namespace Opm
         ///
         /// This is a shared_ptr as MultisegmentWell is copied in computeWellPotentials...
         mutable std::shared_ptr<Dune::UMFPack<DiagMatWell> > duneDSolver_;
+        /// \brief direct solver exploiting the tree structure of the segments,
+        /// duneDSolver_ is only used when it fails.
+        mutable mswellhelpers::SegmentTreeSolver<DiagMatWell, BVectorWell> duneDTreeSolver_;
 
         // residuals of the well equations
         mutable BVectorWell resWell_;
@@ -334,6 +339,16 @@ namespace Opm
 
         std::vector<double> segment_depth_diffs_;
 
+        // the outlet segment and the geometry of each segment which enter the pressure
+        // drops, gathered once instead of looked up in the segment set for every
+        // evaluation. the length is the one to the outlet segment, zero for the top
+        // segment.
+        std::vector<int> segment_outlets_;
+        std::vector<double> segment_lengths_;
+        std::vector<double> segment_areas_;
+        std::vector<double> segment_diameters_;
+        std::vector<double> segment_roughnesses_;
+
         // the upwinding segment for each segment based on the flow direction
         std::vector<int> upwinding_segments_;
 
@@ -355,6 +370,9 @@ namespace Opm
         // xw = inv(D)*(rw - C*x)
         void recoverSolutionWell(const BVector& x, BVectorWell& xw) const;
 
+        // solve duneD_ * y = x
+        BVectorWell applyInvDuneD(const BVectorWell& x) const;
+
         // updating the well_state based on well solution dwells
         void updateWellState(const BVectorWell& dwells,
                              WellState& well_state,
@@ -24,8 +24,9 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/MSW/Valve.hpp>
 #include <opm/common/OpmLog/OpmLog.hpp>
 
-#include <string>
 #include <algorithm>
+#include <array>
+#include <string>
 
 namespace Opm
 {
@@ -55,6 +56,11 @@ namespace Opm
     , segment_viscosities_(numberOfSegments(), 0.0)
     , segment_mass_rates_(numberOfSegments(), 0.0)
     , segment_depth_diffs_(numberOfSegments(), 0.0)
+    , segment_outlets_(numberOfSegments(), 0)
+    , segment_lengths_(numberOfSegments(), 0.0)
+    , segment_areas_(numberOfSegments(), 0.0)
+    , segment_diameters_(numberOfSegments(), 0.0)
+    , segment_roughnesses_(numberOfSegments(), 0.0)
     , upwinding_segments_(numberOfSegments(), 0)
     , segment_phase_fractions_(numberOfSegments(), std::vector<EvalWell>(num_components_, 0.0)) // number of phase here?
     , segment_phase_viscosities_(numberOfSegments(), std::vector<EvalWell>(num_components_, 0.0)) // number of phase here?
@@ -124,6 +130,15 @@ namespace Opm
             const Segment& outlet_segment = segmentSet()[segmentNumberToIndex(outlet_segment_number)];
             const double outlet_depth = outlet_segment.depth();
             segment_depth_diffs_[seg] = segment_depth - outlet_depth;
+            segment_outlets_[seg] = segmentNumberToIndex(outlet_segment_number);
+            segment_lengths_[seg] = segmentSet()[seg].totalLength() - outlet_segment.totalLength();
+        }
+
+        for (int seg = 0; seg < numberOfSegments(); ++seg) {
+            const Segment& segment = segmentSet()[seg];
+            segment_areas_[seg] = segment.crossArea();
+            segment_diameters_[seg] = segment.internalDiameter();
+            segment_roughnesses_[seg] = segment.roughness();
         }
     }
 
@@ -231,6 +246,17 @@ namespace Opm
 
         resWell_.resize( numberOfSegments() );
 
+        {
+            std::vector<int> outlets(numberOfSegments(), -1);
+            for (int seg = 0; seg < numberOfSegments(); ++seg) {
+                const int outlet_segment_number = segmentSet()[seg].outletSegment();
+                if (outlet_segment_number > 0) {
+                    outlets[seg] = segmentNumberToIndex(outlet_segment_number);
+                }
+            }
+            duneDTreeSolver_.init(outlets);
+        }
+
         primary_variables_.resize(numberOfSegments());
         primary_variables_evaluation_.resize(numberOfSegments());
     }
@@ -419,7 +445,7 @@ namespace Opm
         duneB_.mv(x, Bx);
 
         // invDBx = duneD^-1 * Bx_
-        const BVectorWell invDBx = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, Bx);
+        const BVectorWell invDBx = applyInvDuneD(Bx);
 
         // Ax = Ax - duneC_^T * invDBx
         duneC_.mmtv(invDBx,Ax);
@@ -437,14 +463,14 @@ namespace Opm
         if (!this->isOperable() && !this->wellIsStopped()) return;
 
         // invDrw_ = duneD^-1 * resWell_
-        const BVectorWell invDrw = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+        const BVectorWell invDrw = applyInvDuneD(resWell_);
         // r = r - duneC_^T * invDrw
         duneC_.mmtv(invDrw, r);
     }
 
 
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
     template<typename TypeTag>
     void
     MultisegmentWell<TypeTag>::
@@ -793,7 +819,22 @@ namespace Opm
         // resWell = resWell - B * x
         duneB_.mmv(x, resWell);
         // xw = D^-1 * resWell
-        xw = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell);
+        xw = applyInvDuneD(resWell);
+    }
+
+
+
+
+
+    template <typename TypeTag>
+    typename MultisegmentWell<TypeTag>::BVectorWell
+    MultisegmentWell<TypeTag>::
+    applyInvDuneD(const BVectorWell& x) const
+    {
+        if (duneDTreeSolver_.factorize(duneD_)) {
+            return duneDTreeSolver_.solve(duneD_, x);
+        }
+        return mswellhelpers::applyUMFPack(duneD_, duneDSolver_, x);
     }
 
 
@@ -809,7 +850,7 @@ namespace Opm
 
         // We assemble the well equations, then we check the convergence,
         // which is why we do not put the assembleWellEq here.
-        const BVectorWell dx_well = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+        const BVectorWell dx_well = applyInvDuneD(resWell_);
 
         updateWellState(dx_well, well_state, deferred_logger);
     }
@@ -1075,6 +1116,40 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    void
+    MultisegmentWell<TypeTag>::
+    addWellContributionsInPattern(typename SparseMatrixAdapter::IstlMatrix& mat) const
+    {
+        const auto invDuneD = mswellhelpers::invertWithUMFPack<DiagMatWell, BVectorWell>(duneD_, duneDSolver_);
+
+        // Same as addWellContributions(), but only for the blocks of A
+        // which exist, the couplings between perforated cells which are
+        // not neighbours are dropped.
+        for (size_t rowC = 0; rowC < duneC_.N(); ++rowC) {
+            for (auto colC = duneC_[rowC].begin(), endC = duneC_[rowC].end(); colC != endC; ++colC) {
+                auto& row = mat[colC.index()];
+                for (size_t rowB = 0; rowB < duneB_.N(); ++rowB) {
+                    for (auto colB = duneB_[rowB].begin(), endB = duneB_[rowB].end(); colB != endB; ++colB) {
+                        auto block = row.find(colB.index());
+                        if (block == row.end()) {
+                            continue;
+                        }
+                        OffDiagMatrixBlockWellType tmp1;
+                        Detail::multMatrixImpl(invDuneD[rowC][rowB], (*colB), tmp1, std::true_type());
+                        typename SparseMatrixAdapter::MatrixBlock tmp2;
+                        Detail::multMatrixTransposedImpl((*colC), tmp1, tmp2, std::false_type());
+                        *block += tmp2;
+                    }
+                }
+            }
+        }
+    }
+
+
+
+
+
     template <typename TypeTag>
     const WellSegments&
     MultisegmentWell<TypeTag>::
@@ -1225,7 +1300,8 @@ namespace Opm
                             DeferredLogger& deferred_logger) const
 
     {
-        std::vector<EvalWell> cmix_s(num_components_, 0.0);
+        const ScratchAllocator<EvalWell> scratch(this->scratchArena());
+        ScratchVector<EvalWell> cmix_s(num_components_, 0.0, scratch);
 
         // the composition of the components inside wellbore
         for (int comp_idx = 0; comp_idx < num_components_; ++comp_idx) {
@@ -1239,7 +1315,7 @@ namespace Opm
         const EvalWell rv = extendEval(fs.Rv());
 
         // not using number_of_phases_ because of solvent
-        std::vector<EvalWell> b_perfcells(num_components_, 0.0);
+        ScratchVector<EvalWell> b_perfcells(num_components_, 0.0, scratch);
 
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
             if (!FluidSystem::phaseIsActive(phaseIdx)) {
@@ -1414,7 +1490,10 @@ namespace Opm
             pvt_region_index = fs.pvtRegionIndex();
         }
 
-        std::vector<double> surf_dens(num_components_);
+        // the components of a segment are kept on the stack, there are at most as many
+        // as well equations
+        assert(num_components_ <= numWellEq);
+        std::array<double, numWellEq> surf_dens{};
         // Surface density.
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
             if (!FluidSystem::phaseIsActive(phaseIdx)) {
@@ -1427,13 +1506,16 @@ namespace Opm
 
         for (int seg = 0; seg < numberOfSegments(); ++seg) {
             // the compostion of the components inside wellbore under surface condition
-            std::vector<EvalWell> mix_s(num_components_, 0.0);
+            std::array<EvalWell, numWellEq> mix_s;
+            mix_s.fill(EvalWell(0.0));
             for (int comp_idx = 0; comp_idx < num_components_; ++comp_idx) {
                 mix_s[comp_idx] = surfaceVolumeFraction(seg, comp_idx);
             }
 
-            std::vector<EvalWell> b(num_components_, 0.0);
-            std::vector<EvalWell> visc(num_components_, 0.0);
+            std::array<EvalWell, numWellEq> b;
+            b.fill(EvalWell(0.0));
+            std::array<EvalWell, numWellEq> visc;
+            visc.fill(EvalWell(0.0));
             std::vector<EvalWell>& phase_densities = this->segment_phase_densities_[seg];
 
             const EvalWell seg_pressure = getSegmentPressure(seg);
@@ -1522,9 +1604,9 @@ namespace Opm
                 }
             }
 
-            segment_phase_viscosities_[seg] = visc;
+            std::copy_n(visc.begin(), num_components_, segment_phase_viscosities_[seg].begin());
 
-            std::vector<EvalWell> mix(mix_s);
+            std::array<EvalWell, numWellEq> mix(mix_s);
             if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
@@ -1944,7 +2026,7 @@ namespace Opm
         }
 
         // contribution from the outlet segment
-        const int outlet_segment_index = segmentNumberToIndex(segmentSet()[seg].outletSegment());
+        const int outlet_segment_index = segment_outlets_[seg];
         const EvalWell outlet_pressure = getSegmentPressure(outlet_segment_index);
 
         resWell_[seg][SPres] -= outlet_pressure.value();
@@ -1989,12 +2071,11 @@ namespace Opm
             density.clearDerivatives();
             visc.clearDerivatives();
         }
-        const int outlet_segment_index = segmentNumberToIndex(segmentSet()[seg].outletSegment());
-        const double length = segmentSet()[seg].totalLength() - segmentSet()[outlet_segment_index].totalLength();
+        const double length = segment_lengths_[seg];
         assert(length > 0.);
-        const double roughness = segmentSet()[seg].roughness();
-        const double area = segmentSet()[seg].crossArea();
-        const double diameter = segmentSet()[seg].internalDiameter();
+        const double roughness = segment_roughnesses_[seg];
+        const double area = segment_areas_[seg];
+        const double diameter = segment_diameters_[seg];
 
         const double sign = mass_rate < 0. ? 1.0 : - 1.0;
 
@@ -2010,7 +2091,7 @@ namespace Opm
     MultisegmentWell<TypeTag>::
     handleAccelerationPressureLoss(const int seg, WellState& well_state) const
     {
-        const double area = segmentSet()[seg].crossArea();
+        const double area = segment_areas_[seg];
         const EvalWell mass_rate = segment_mass_rates_[seg];
         const int seg_upwind = upwinding_segments_[seg];
         EvalWell density = segment_densities_[seg_upwind];
@@ -2025,7 +2106,7 @@ namespace Opm
         // handling the velocity head of intlet segments
         for (const int inlet : segment_inlets_[seg]) {
             const int seg_upwind_inlet = upwinding_segments_[inlet];
-            const double inlet_area = segmentSet()[inlet].crossArea();
+            const double inlet_area = segment_areas_[inlet];
             EvalWell inlet_density = segment_densities_[seg_upwind_inlet];
             // WARNING
             // We disregard the derivatives from the upwind density to make sure derivatives
@@ -2442,7 +2523,7 @@ namespace Opm
 
             assembleWellEqWithoutIteration(ebosSimulator, dt, inj_controls, prod_controls, well_state, group_state, deferred_logger);
 
-            const BVectorWell dx_well = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+            const BVectorWell dx_well = applyInvDuneD(resWell_);
 
             if (it > param_.strict_inner_iter_ms_wells_)
                 relax_convergence = true;
@@ -2501,28 +2582,30 @@ namespace Opm
         }
 
         // TODO: we should decide whether to keep the updated well_state, or recover to use the old well_state
-        if (converged) {
-            std::ostringstream sstr;
-            sstr << "     Well " << name() << " converged in " << it << " inner iterations.";
-            if (relax_convergence)
-                sstr << "      (A relaxed tolerance was used after "<< param_.strict_inner_iter_ms_wells_ << " iterations)";
-            deferred_logger.debug(sstr.str());
-        } else {
-            std::ostringstream sstr;
-            sstr << "     Well " << name() << " did not converge in " << it << " inner iterations.";
+        if (DeferredLogger::enabled(Log::MessageType::Debug)) {
+            if (converged) {
+                std::ostringstream sstr;
+                sstr << "     Well " << name() << " converged in " << it << " inner iterations.";
+                if (relax_convergence)
+                    sstr << "      (A relaxed tolerance was used after "<< param_.strict_inner_iter_ms_wells_ << " iterations)";
+                deferred_logger.debug(sstr.str());
+            } else {
+                std::ostringstream sstr;
+                sstr << "     Well " << name() << " did not converge in " << it << " inner iterations.";
 #define EXTRA_DEBUG_MSW 0
 #if EXTRA_DEBUG_MSW
-            sstr << "***** Outputting the residual history for well " << name() << " during inner iterations:";
-            for (int i = 0; i < it; ++i) {
-                const auto& residual = residual_history[i];
-                sstr << " residual at " << i << "th iteration ";
-                for (const auto& res : residual) {
-                    sstr << " " << res;
+                sstr << "***** Outputting the residual history for well " << name() << " during inner iterations:";
+                for (int i = 0; i < it; ++i) {
+                    const auto& residual = residual_history[i];
+                    sstr << " residual at " << i << "th iteration ";
+                    for (const auto& res : residual) {
+                        sstr << " " << res;
+                    }
+                    sstr << " " << measure_history[i] << " \n";
                 }
-                sstr << " " << measure_history[i] << " \n";
-            }
 #endif
-            deferred_logger.debug(sstr.str());
+                deferred_logger.debug(sstr.str());
+            }
         }
 
         return converged;
@@ -2560,6 +2643,7 @@ namespace Opm
         resWell_ = 0.0;
 
         duneDSolver_.reset();
+        duneDTreeSolver_.invalidate();
 
         well_state.wellVaporizedOilRates(index_of_well_) = 0.;
         well_state.wellDissolvedGasRates(index_of_well_) = 0.;
@@ -2574,6 +2658,11 @@ namespace Opm
         const int nseg = numberOfSegments();
 
         for (int seg = 0; seg < nseg; ++seg) {
+            // the cells of the perforations of the segment are needed once the
+            // segment terms below are assembled
+            for (const int perf : segment_perforations_[seg]) {
+                this->prefetchPerforation(ebosSimulator, perf);
+            }
             // calculating the accumulation term
             // TODO: without considering the efficiencty factor for now
             {
@@ -2820,12 +2909,13 @@ namespace Opm
 
         const EvalWell seg_pressure = getSegmentPressure(seg_idx);
 
-        std::vector<EvalWell> mix_s(num_components_, 0.0);
+        const ScratchAllocator<EvalWell> scratch(this->scratchArena());
+        ScratchVector<EvalWell> mix_s(num_components_, 0.0, scratch);
         for (int comp_idx = 0; comp_idx < num_components_; ++comp_idx) {
             mix_s[comp_idx] = surfaceVolumeFraction(seg_idx, comp_idx);
         }
 
-        std::vector<EvalWell> b(num_components_, 0.);
+        ScratchVector<EvalWell> b(num_components_, 0., scratch);
         if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
             const unsigned waterCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx);
             b[waterCompIdx] =
@@ -2895,7 +2985,7 @@ namespace Opm
             }
         }
 
-        std::vector<EvalWell> mix(mix_s);
+        ScratchVector<EvalWell> mix(mix_s);
         if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
             const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
             const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
@@ -3220,7 +3310,7 @@ namespace Opm
             if (primary_variables_evaluation_[seg][GTotal] <= 0.) {
                 upwinding_segments_[seg] = seg;
             } else {
-                const int outlet_segment_index = segmentNumberToIndex(segmentSet()[seg].outletSegment());
+                const int outlet_segment_index = segment_outlets_[seg];
                 upwinding_segments_[seg] = outlet_segment_index;
             }
         }
@@ -3276,7 +3366,7 @@ namespace Opm
         }
 
         // contribution from the outlet segment
-        const int outlet_segment_index = segmentNumberToIndex(segmentSet()[seg].outletSegment());
+        const int outlet_segment_index = segment_outlets_[seg];
         const EvalWell outlet_pressure = getSegmentPressure(outlet_segment_index);
 
         resWell_[seg][SPres] -= outlet_pressure.value();
@@ -0,0 +1,212 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PACKED_WELL_SCHUR_COMPLEMENT_HEADER_INCLUDED
+#define OPM_PACKED_WELL_SCHUR_COMPLEMENT_HEADER_INCLUDED
+
+#include <dune/istl/bvector.hh>
+#include <dune/common/fvector.hh>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace Opm {
+
+
+/*
+  The PackedWellSchurComplement class stores the B, C and D^-1 matrices of
+  many wells in one contiguous buffer, so that applying the Schur complement
+
+      Ax = Ax - C^T D^-1 B x
+
+  for all wells streams through memory, instead of visiting one heap
+  allocated dynamic block per perforation. The contents are a copy, they
+  must be rebuilt whenever the well equations have been assembled.
+
+  Per well the buffer holds, with nw the number of well equations:
+    - for every perforation the nw x numEq block of B, then the nw x numEq
+      block of C, row major,
+    - the nw x nw block of D^-1, row major.
+*/
+template <class Scalar, int numEq>
+class PackedWellSchurComplement
+{
+public:
+    using BVector = Dune::BlockVector<Dune::FieldVector<Scalar, numEq>>;
+
+    void clear()
+    {
+        wells_.clear();
+        cells_.clear();
+        values_.clear();
+        max_well_eq_ = 0;
+    }
+
+    bool empty() const
+    {
+        return wells_.empty();
+    }
+
+    /// Add one well. B and C are 1 x num_cells BCRS matrices with equal
+    /// sparsity pattern, invD is the 1 x 1 BCRS matrix with D^-1.
+    template <class OffDiagMatWell, class DiagMatWell>
+    void addWell(const OffDiagMatWell& B, const OffDiagMatWell& C, const DiagMatWell& invD)
+    {
+        const auto& invDBlock = invD[0][0];
+        const int nw = invDBlock.N();
+
+        Well well;
+        well.num_well_eq = nw;
+        well.first_cell = cells_.size();
+        well.offset = values_.size();
+
+        auto c = C[0].begin();
+        for (auto b = B[0].begin(); b != B[0].end(); ++b, ++c) {
+            assert(c.index() == b.index());
+            cells_.push_back(b.index());
+            appendBlock(*b);
+            appendBlock(*c);
+        }
+        appendBlock(invDBlock);
+
+        well.num_perfs = cells_.size() - well.first_cell;
+        wells_.push_back(well);
+        max_well_eq_ = std::max(max_well_eq_, nw);
+    }
+
+    /// Add one well from values in the packed layout described above, as
+    /// stored in the binary system dumps.
+    void addPackedWell(const int num_well_eq, const int num_perfs,
+                       const int* cells, const Scalar* values)
+    {
+        Well well;
+        well.num_well_eq = num_well_eq;
+        well.num_perfs = num_perfs;
+        well.first_cell = cells_.size();
+        well.offset = values_.size();
+
+        cells_.insert(cells_.end(), cells, cells + num_perfs);
+        values_.insert(values_.end(), values, values + packedSize(num_well_eq, num_perfs));
+
+        wells_.push_back(well);
+        max_well_eq_ = std::max(max_well_eq_, num_well_eq);
+    }
+
+    /// Number of values of a well in the packed layout.
+    static std::size_t packedSize(const int num_well_eq, const int num_perfs)
+    {
+        return (2 * num_perfs * numEq + num_well_eq) * num_well_eq;
+    }
+
+    std::size_t numWells() const
+    { return wells_.size(); }
+
+    int numWellEq(const std::size_t well) const
+    { return wells_[well].num_well_eq; }
+
+    int numPerforations(const std::size_t well) const
+    { return wells_[well].num_perfs; }
+
+    /// The perforated cells of all wells, one after the other.
+    const std::vector<int>& cells() const
+    { return cells_; }
+
+    /// The packed values of all wells, one after the other.
+    const std::vector<Scalar>& values() const
+    { return values_; }
+
+    /// Ax = Ax - C^T D^-1 B x for all packed wells.
+    void apply(const BVector& x, BVector& Ax) const
+    {
+        Bx_.resize(max_well_eq_);
+        invDBx_.resize(max_well_eq_);
+
+        for (const auto& well : wells_) {
+            const int nw = well.num_well_eq;
+            const int blockSize = nw * numEq;
+            const Scalar* val = values_.data() + well.offset;
+            const int* cell = cells_.data() + well.first_cell;
+
+            // Bx = B * x
+            std::fill(Bx_.begin(), Bx_.begin() + nw, 0.0);
+            for (int perf = 0; perf < well.num_perfs; ++perf) {
+                const Scalar* Bblock = val + 2 * perf * blockSize;
+                const auto& xc = x[cell[perf]];
+                for (int i = 0; i < nw; ++i) {
+                    for (int j = 0; j < numEq; ++j) {
+                        Bx_[i] += Bblock[i * numEq + j] * xc[j];
+                    }
+                }
+            }
+
+            // invDBx = D^-1 * Bx
+            const Scalar* invDblock = val + 2 * well.num_perfs * blockSize;
+            for (int i = 0; i < nw; ++i) {
+                Scalar sum = 0.0;
+                for (int j = 0; j < nw; ++j) {
+                    sum += invDblock[i * nw + j] * Bx_[j];
+                }
+                invDBx_[i] = sum;
+            }
+
+            // Ax = Ax - C^T * invDBx
+            for (int perf = 0; perf < well.num_perfs; ++perf) {
+                const Scalar* Cblock = val + (2 * perf + 1) * blockSize;
+                auto& Axc = Ax[cell[perf]];
+                for (int i = 0; i < nw; ++i) {
+                    for (int j = 0; j < numEq; ++j) {
+                        Axc[j] -= Cblock[i * numEq + j] * invDBx_[i];
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    struct Well
+    {
+        int num_well_eq;
+        int num_perfs;
+        std::size_t first_cell; // index into cells_
+        std::size_t offset;     // index into values_
+    };
+
+    template <class Block>
+    void appendBlock(const Block& block)
+    {
+        for (std::size_t i = 0; i < block.N(); ++i) {
+            for (std::size_t j = 0; j < block.M(); ++j) {
+                values_.push_back(block[i][j]);
+            }
+        }
+    }
+
+    std::vector<Well> wells_;
+    std::vector<int> cells_;
+    std::vector<Scalar> values_;
+    int max_well_eq_ = 0;
+
+    mutable std::vector<Scalar> Bx_;
+    mutable std::vector<Scalar> invDBx_;
+};
+
+} // namespace Opm
+
+#endif // OPM_PACKED_WELL_SCHUR_COMPLEMENT_HEADER_INCLUDED
@@ -176,6 +176,23 @@ void GlobalPerfContainerFactory::copyGlobalToLocal(const std::vector<double>& gl
     }
 }
 
+void GlobalPerfContainerFactory::partialSumPerfValues(double* values, std::size_t num_local_perfs) const
+{
+    if (comm_.size() > 1)
+    {
+        std::vector<double> local(values, values + num_local_perfs);
+        auto global = createGlobal(local, 1);
+        // the global values are ordered by the ecl index
+        std::partial_sum(global.begin(), global.end(), global.begin());
+        copyGlobalToLocal(global, local, 1);
+        std::copy(local.begin(), local.end(), values);
+    }
+    else
+    {
+        std::partial_sum(values, values + num_local_perfs, values);
+    }
+}
+
 int GlobalPerfContainerFactory::numGlobalPerfs() const
 {
     return num_global_perfs_;
@@ -29,6 +29,7 @@
 #include <memory>
 #include <iterator>
 #include <numeric>
+#include <type_traits>
 
 namespace Opm
 {
@@ -226,6 +227,15 @@ public:
     void copyGlobalToLocal(const std::vector<double>& global, std::vector<double>& local,
                            std::size_t num_components) const;
 
+    /// \brief Do a (in place) partial sum on values attached to all perforations.
+    ///
+    /// Same as CommunicateAboveBelow::partialSumPerfValues, but as the layout of
+    /// the perforations on the processes is already known only the values are
+    /// gathered, with a single collective.
+    /// \param values The values at the local perforations.
+    /// \param num_local_perfs The number of local perforations.
+    void partialSumPerfValues(double* values, std::size_t num_local_perfs) const;
+
     int numGlobalPerfs() const;
 private:
     const IndexSet& local_indices_;
@@ -379,6 +389,14 @@ public:
     template<class RAIterator>
     void partialSumPerfValues(RAIterator begin, RAIterator end) const
     {
+        using Value = typename std::iterator_traits<RAIterator>::value_type;
+        if constexpr (std::is_same_v<Value, double>) {
+            if (globalPerfCont_) {
+                const std::size_t size = end - begin;
+                globalPerfCont_->partialSumPerfValues(size > 0 ? &(*begin) : nullptr, size);
+                return;
+            }
+        }
         commAboveBelow_->partialSumPerfValues(begin, end);
     }
 
@@ -27,6 +27,11 @@
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
 
 #include <dune/grid/common/gridenums.hh>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <algorithm>
 #include <cmath>
 #include <memory>
@@ -432,124 +437,98 @@ namespace Opm {
             template <typename ElementContext, class EbosSimulator>
             void defineState(const EbosSimulator& simulator)
             {
-
-                // create map from cell to region
-                // and set all attributes to zero
-                for (const auto& reg : rmap_.activeRegions()) {
-                    auto& ra = attr_.attributes(reg);
-                    ra.pressure = 0.0;
-                    ra.temperature = 0.0;
-                    ra.rs = 0.0;
-                    ra.rv = 0.0;
-                    ra.pv = 0.0;
-                    ra.saltConcentration = 0.0;
-
-                }
-
-                // quantities for pore volume average
-                std::unordered_map<RegionId, Attributes> attributes_pv;
-
-                // quantities for hydrocarbon volume average
-                std::unordered_map<RegionId, Attributes> attributes_hpv;
-
-                for (const auto& reg : rmap_.activeRegions()) {
-                    attributes_pv.insert({reg, Attributes()});
-                    attributes_hpv.insert({reg, Attributes()});
+                const auto& regions = rmap_.activeRegions();
+                const std::size_t numRegions = regions.size();
+                if (interiorCells_.empty()) {
+                    setupInteriorCells_<ElementContext>(simulator);
                 }
 
-                ElementContext elemCtx( simulator );
-                const auto& gridView = simulator.gridView();
-                const auto& comm = gridView.comm();
-
-                const auto& elemEndIt = gridView.template end</*codim=*/0>();
-                for (auto elemIt = gridView.template begin</*codim=*/0>();
-                     elemIt != elemEndIt;
-                     ++elemIt)
-                {
-
-                    const auto& elem = *elemIt;
-                    if (elem.partitionType() != Dune::InteriorEntity)
+                // Per region the hydrocarbon pore volume weighted sums
+                // followed by the pore volume weighted sums, see addCell_().
+                std::vector<double> sums(numRegions * 2 * numSums_, 0.0);
+
+                // The cached intensive quantities are used if they are
+                // available for all cells, otherwise the element context.
+                bool cacheComplete = true;
+                const auto& model = simulator.model();
+                const int numCells = interiorCells_.size();
+#ifdef _OPENMP
+                const int numThreads = omp_get_max_threads();
+#else
+                const int numThreads = 1;
+#endif
+                // one buffer per thread, summed in thread order afterwards
+                // such that the result does not depend on the scheduling
+                std::vector<std::vector<double>> threadSums(numThreads, std::vector<double>(sums.size(), 0.0));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(&&:cacheComplete)
+#endif
+                for (int i = 0; i < numCells; ++i) {
+#ifdef _OPENMP
+                    auto& localSums = threadSums[omp_get_thread_num()];
+#else
+                    auto& localSums = threadSums[0];
+#endif
+                    const unsigned cellIdx = interiorCells_[i];
+                    const auto* intQuants = model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0);
+                    if (intQuants == nullptr) {
+                        cacheComplete = false;
                         continue;
-
-                    elemCtx.updatePrimaryStencil(elem);
-                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                    const unsigned cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& fs = intQuants.fluidState();
-                    // use pore volume weighted averages.
-                    const double pv_cell =
-                            simulator.model().dofTotalVolume(cellIdx)
-                            * intQuants.porosity().value();
-
-                    // only count oil and gas filled parts of the domain
-                    double hydrocarbon = 1.0;
-                    const auto& pu = phaseUsage_;
-                    if (Details::PhaseUsed::water(pu)) {
-                        hydrocarbon -= fs.saturation(FluidSystem::waterPhaseIdx).value();
                     }
+                    addCell_(model.dofTotalVolume(cellIdx), *intQuants,
+                             localSums.data() + interiorCellRegions_[i] * 2 * numSums_);
+                }
 
-                    const int reg = rmap_.region(cellIdx);
-                    assert(reg >= 0);
-
-                    // sum p, rs, rv, and T.
-                    const double hydrocarbonPV = pv_cell*hydrocarbon;
-                    if (hydrocarbonPV > 0.) {
-                        auto& attr = attributes_hpv[reg];
-                        attr.pv += hydrocarbonPV;
-                        attr.pressure += fs.pressure(FluidSystem::oilPhaseIdx).value() * hydrocarbonPV;
-                        attr.rs += fs.Rs().value() * hydrocarbonPV;
-                        attr.rv += fs.Rv().value() * hydrocarbonPV;
-                        attr.temperature += fs.temperature(FluidSystem::oilPhaseIdx).value() * hydrocarbonPV;
-                        attr.saltConcentration += fs.saltConcentration().value() * hydrocarbonPV;
+                if (cacheComplete) {
+                    for (const auto& localSums : threadSums) {
+                        for (std::size_t k = 0; k < sums.size(); ++k) {
+                            sums[k] += localSums[k];
+                        }
                     }
-
-                    if (pv_cell > 0.) {
-                        auto& attr = attributes_pv[reg];
-                        attr.pv += pv_cell;
-                        attr.pressure += fs.pressure(FluidSystem::oilPhaseIdx).value() * pv_cell;
-                        attr.rs += fs.Rs().value() * pv_cell;
-                        attr.rv += fs.Rv().value() * pv_cell;
-                        attr.temperature += fs.temperature(FluidSystem::oilPhaseIdx).value() * pv_cell;
-                        attr.saltConcentration += fs.saltConcentration().value() * pv_cell;
+                }
+                else {
+                    ElementContext elemCtx( simulator );
+                    const auto& gridView = simulator.gridView();
+                    const auto& elemEndIt = gridView.template end</*codim=*/0>();
+                    int i = 0;
+                    for (auto elemIt = gridView.template begin</*codim=*/0>();
+                         elemIt != elemEndIt;
+                         ++elemIt)
+                    {
+                        const auto& elem = *elemIt;
+                        if (elem.partitionType() != Dune::InteriorEntity)
+                            continue;
+
+                        elemCtx.updatePrimaryStencil(elem);
+                        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                        const unsigned cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+                        addCell_(model.dofTotalVolume(cellIdx),
+                                 elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0),
+                                 sums.data() + interiorCellRegions_[i] * 2 * numSums_);
+                        ++i;
                     }
                 }
 
-                for (const auto& reg : rmap_.activeRegions()) {
-                      auto& ra = attr_.attributes(reg);
-                      const double hpv_sum = comm.sum(attributes_hpv[reg].pv);
-                      // TODO: should we have some epsilon here instead of zero?
-                      if (hpv_sum > 0.) {
-                          const auto& attri_hpv = attributes_hpv[reg];
-                          const double p_hpv_sum = comm.sum(attri_hpv.pressure);
-                          const double T_hpv_sum = comm.sum(attri_hpv.temperature);
-                          const double rs_hpv_sum = comm.sum(attri_hpv.rs);
-                          const double rv_hpv_sum = comm.sum(attri_hpv.rv);
-                          const double sc_hpv_sum = comm.sum(attri_hpv.saltConcentration);
-
-                          ra.pressure = p_hpv_sum / hpv_sum;
-                          ra.temperature = T_hpv_sum / hpv_sum;
-                          ra.rs = rs_hpv_sum / hpv_sum;
-                          ra.rv = rv_hpv_sum / hpv_sum;
-                          ra.pv = hpv_sum;
-                          ra.saltConcentration = sc_hpv_sum / hpv_sum;
-                      } else {
-                          // using the pore volume to do the averaging
-                          const auto& attri_pv = attributes_pv[reg];
-                          const double pv_sum = comm.sum(attri_pv.pv);
-                          assert(pv_sum > 0.);
-                          const double p_pv_sum = comm.sum(attri_pv.pressure);
-                          const double T_pv_sum = comm.sum(attri_pv.temperature);
-                          const double rs_pv_sum = comm.sum(attri_pv.rs);
-                          const double rv_pv_sum = comm.sum(attri_pv.rv);
-                          const double sc_pv_sum = comm.sum(attri_pv.saltConcentration);
-
-                          ra.pressure = p_pv_sum / pv_sum;
-                          ra.temperature = T_pv_sum / pv_sum;
-                          ra.rs = rs_pv_sum / pv_sum;
-                          ra.rv = rv_pv_sum / pv_sum;
-                          ra.pv = pv_sum;
-                          ra.saltConcentration = sc_pv_sum / pv_sum;
-                      }
+                // communicate the sums of all regions at once
+                const auto& comm = simulator.gridView().comm();
+                if (!sums.empty()) {
+                    comm.sum(sums.data(), sums.size());
+                }
+
+                for (std::size_t r = 0; r < numRegions; ++r) {
+                    auto& ra = attr_.attributes(regions[r]);
+                    const double* hpv = sums.data() + r * 2 * numSums_;
+                    const double* pv = hpv + numSums_;
+                    // TODO: should we have some epsilon here instead of zero?
+                    // Otherwise, using the pore volume to do the averaging
+                    const double* sum = hpv[0] > 0. ? hpv : pv;
+                    assert(sum[0] > 0.);
+                    ra.pv = sum[0];
+                    ra.pressure = sum[1] / sum[0];
+                    ra.temperature = sum[2] / sum[0];
+                    ra.rs = sum[3] / sum[0];
+                    ra.rv = sum[4] / sum[0];
+                    ra.saltConcentration = sum[5] / sum[0];
                 }
             }
 
@@ -800,6 +779,83 @@ namespace Opm {
 
             Details::RegionAttributes<RegionId, Attributes> attr_;
 
+            // Interior cells of this process in the order of the grid view,
+            // and the position of their region in rmap_.activeRegions().
+            std::vector<unsigned> interiorCells_;
+            std::vector<std::size_t> interiorCellRegions_;
+
+            // pore volume, pressure, temperature, rs, rv, salt concentration
+            static constexpr std::size_t numSums_ = 6;
+
+            template <typename ElementContext, class EbosSimulator>
+            void setupInteriorCells_(const EbosSimulator& simulator)
+            {
+                std::unordered_map<RegionId, std::size_t> regionPos;
+                for (const auto& reg : rmap_.activeRegions()) {
+                    regionPos.emplace(reg, regionPos.size());
+                }
+
+                ElementContext elemCtx( simulator );
+                const auto& gridView = simulator.gridView();
+                const auto& elemEndIt = gridView.template end</*codim=*/0>();
+                for (auto elemIt = gridView.template begin</*codim=*/0>();
+                     elemIt != elemEndIt;
+                     ++elemIt)
+                {
+                    const auto& elem = *elemIt;
+                    if (elem.partitionType() != Dune::InteriorEntity)
+                        continue;
+
+                    elemCtx.updatePrimaryStencil(elem);
+                    const unsigned cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+                    const int reg = rmap_.region(cellIdx);
+                    assert(reg >= 0);
+                    interiorCells_.push_back(cellIdx);
+                    interiorCellRegions_.push_back(regionPos.at(reg));
+                }
+            }
+
+            // Add the pore volume weighted state of one cell to the sums of its region.
+            template <class IntensiveQuantities>
+            void addCell_(const double totalVolume,
+                          const IntensiveQuantities& intQuants,
+                          double* regionSums) const
+            {
+                const auto& fs = intQuants.fluidState();
+                // use pore volume weighted averages.
+                const double pv_cell = totalVolume * intQuants.porosity().value();
+
+                // only count oil and gas filled parts of the domain
+                double hydrocarbon = 1.0;
+                const auto& pu = phaseUsage_;
+                if (Details::PhaseUsed::water(pu)) {
+                    hydrocarbon -= fs.saturation(FluidSystem::waterPhaseIdx).value();
+                }
+
+                const double values[numSums_] = {
+                    1.0,
+                    fs.pressure(FluidSystem::oilPhaseIdx).value(),
+                    fs.temperature(FluidSystem::oilPhaseIdx).value(),
+                    fs.Rs().value(),
+                    fs.Rv().value(),
+                    fs.saltConcentration().value(),
+                };
+
+                // sum p, rs, rv, and T.
+                const double hydrocarbonPV = pv_cell*hydrocarbon;
+                if (hydrocarbonPV > 0.) {
+                    for (std::size_t k = 0; k < numSums_; ++k) {
+                        regionSums[k] += values[k] * hydrocarbonPV;
+                    }
+                }
+
+                if (pv_cell > 0.) {
+                    for (std::size_t k = 0; k < numSums_; ++k) {
+                        regionSums[numSums_ + k] += values[k] * pv_cell;
+                    }
+                }
+            }
+
         };
     } // namespace RateConverter
 } // namespace Opm
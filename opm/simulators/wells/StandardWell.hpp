@@ -23,7 +23,7 @@
 #ifndef OPM_STANDARDWELL_HEADER_INCLUDED
 #define OPM_STANDARDWELL_HEADER_INCLUDED
 
-#if HAVE_CUDA || HAVE_OPENCL
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
 #endif
 
@@ -35,6 +35,9 @@
 #include <opm/simulators/wells/WellProdIndexCalculator.hpp>
 #include <opm/simulators/wells/ParallelWellInfo.hpp>
 #include <opm/simulators/wells/GasLiftSingleWell.hpp>
+#include <opm/simulators/wells/GasLiftWellState.hpp>
+#include <opm/simulators/wells/PackedWellSchurComplement.hpp>
+#include <opm/simulators/utils/PhaseActivity.hpp>
 
 #include <opm/models/blackoil/blackoilpolymermodules.hh>
 #include <opm/models/blackoil/blackoilsolventmodules.hh>
@@ -43,12 +46,14 @@
 #include <opm/models/blackoil/blackoilbrinemodules.hh>
 
 #include <opm/material/densead/DynamicEvaluation.hpp>
+#include <opm/material/densead/Evaluation.hpp>
 #include <opm/parser/eclipse/EclipseState/Runspec.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/ScheduleTypes.hpp>
 
 #include <dune/common/dynvector.hh>
 #include <dune/common/dynmatrix.hh>
 
+#include <array>
 #include <memory>
 #include <optional>
 #include <fmt/format.h>
@@ -72,6 +77,7 @@ namespace Opm
         using typename Base::MaterialLaw;
         using typename Base::ModelParameters;
         using typename Base::Indices;
+        using PhaseActivity = Opm::PhaseActivity<FluidSystem, Indices>;
         using typename Base::RateConverterType;
         using typename Base::SparseMatrixAdapter;
         using typename Base::FluidState;
@@ -196,7 +202,12 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const override;
 
-#if HAVE_CUDA || HAVE_OPENCL
+        /// add the C, D^-1 and B matrices of this well to the packed Schur complement
+        /// \return false if the well can not be packed and must be applied by itself,
+        ///         i.e. if it is distributed over several processes
+        bool addPackedSchurComplement(PackedWellSchurComplement<Scalar, numEq>& packed) const;
+
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
         /// add the contribution (C, D^-1, B matrices) of this Well to the WellContributions object
         void addWellContribution(WellContributions& wellContribs) const;
 
@@ -231,6 +242,8 @@ namespace Opm
 
         virtual void  addWellContributions(SparseMatrixAdapter& mat) const override;
 
+        virtual void addWellContributionsInPattern(typename SparseMatrixAdapter::IstlMatrix& mat) const override;
+
         // iterate well equations with the specified control until converged
         bool iterateWellEqWithControl(const Simulator& ebosSimulator,
                                       const double dt,
@@ -309,6 +322,9 @@ namespace Opm
         using Base::phaseUsage;
         using Base::vfp_properties_;
 
+        // NOTE: Used by GasLiftSingleWell, the cache is kept between the optimizations
+        GasLiftWellCache& gliftCache() const { return glift_cache_; }
+
         virtual std::vector<double> computeCurrentWellRates(const Simulator& ebosSimulator,
                                                             DeferredLogger& deferred_logger) const override;
 
@@ -381,6 +397,12 @@ namespace Opm
         // pressure drop between different perforations
         std::vector<double> perf_pressure_diffs_;
 
+        // the bhp, connection pressures and connection rates the connection pressures were
+        // computed from, used to reuse them while these change less than the tolerance
+        double conn_press_bhp_ = 0.0;
+        std::vector<double> conn_press_perf_press_;
+        std::vector<double> conn_press_perf_rates_;
+
         // residuals of the well equations
         BVectorWell resWell_;
 
@@ -413,6 +435,22 @@ namespace Opm
         // Optimize only wells under THP control
         bool glift_optimize_only_thp_wells = true;
 
+        // The bhp at the thp limit for the ALQ values tried by the gas lift optimization
+        mutable GasLiftWellCache glift_cache_;
+
+        // The shear factor of a perforation and its derivatives with respect to the
+        // polymer concentration and the water velocity, for the values it was computed for
+        struct ShearFactorCache
+        {
+            int region = -1;
+            double concentration = 0.0;
+            double velocity = 0.0;
+            double factor = 1.0;
+            double dConcentration = 0.0;
+            double dVelocity = 0.0;
+        };
+        mutable std::vector<ShearFactorCache> shear_factor_cache_;
+
         const EvalWell& getBhp() const;
 
         EvalWell getQs(const int comp_idx) const;
@@ -429,6 +467,10 @@ namespace Opm
 
         Eval getPerfCellPressure(const FluidState& fs) const;
 
+        // Ax = Ax - C^T * inv(D) * B * x in one pass over the perforations,
+        // for wells with the static number of equations on a single process
+        void applySchurComplementSerial(const BVector& x, BVector& Ax) const;
+
         // xw = inv(D)*(rw - C*x)
         void recoverSolutionWell(const BVector& x, BVectorWell& xw) const;
 
@@ -469,6 +511,12 @@ namespace Opm
         void computeWellConnectionPressures(const Simulator& ebosSimulator,
                                             const WellState& well_state);
 
+        // whether the state of the well changed by less than WellConnectionPressureTolerance
+        // since the connection pressures were computed, the same on all processes of the well
+        bool connectionPressuresUpToDate(const WellState& well_state) const;
+
+        void storeConnectionPressureState(const WellState& well_state);
+
         void computePerfRate(const IntensiveQuantities& intQuants,
                              const std::vector<EvalWell>& mob,
                              const EvalWell& bhp,
@@ -506,6 +554,13 @@ namespace Opm
                                             std::vector<EvalWell>& mob_water,
                                             DeferredLogger& deferred_logger) const;
 
+        // the shear factor of PLYSHLOG, reused while the concentration and the velocity
+        // of the perforation do not change
+        EvalWell computeShearFactor(const int perf,
+                                    const EvalWell& polymer_concentration,
+                                    const int region,
+                                    const EvalWell& water_velocity) const;
+
         void updatePrimaryVariablesNewton(const BVectorWell& dwells,
                                           const WellState& well_state) const;
 
@@ -542,10 +597,13 @@ namespace Opm
                                                 const GroupState& group_state,
                                                 DeferredLogger& deferred_logger);
 
+        // mob is used as scratch space for the perforation mobilities
         void calculateSinglePerf(const Simulator& ebosSimulator,
                                  const int perf,
+                                 const bool allow_cf,
                                  WellState& well_state,
                                  std::vector<RateVector>& connectionRates,
+                                 std::vector<EvalWell>& mob,
                                  std::vector<EvalWell>& cq_s,
                                  EvalWell& water_flux_s,
                                  EvalWell& cq_s_zfrac_effective,
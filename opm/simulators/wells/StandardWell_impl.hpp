@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 #include <numeric>
 
 namespace Opm
@@ -79,6 +80,7 @@ namespace Opm
         }
 
         // counting/updating primary variable numbers
+        numWellEq_ = numStaticWellEq;
         if constexpr (Base::has_polymermw) {
             if (this->isInjector()) {
                 // adding a primary variable for water perforation rate per connection
@@ -89,8 +91,13 @@ namespace Opm
         }
 
         // with the updated numWellEq_, we can initialize the primary variables and matrices now
-        primary_variables_.resize(numWellEq_, 0.0);
-        primary_variables_evaluation_.resize(numWellEq_, EvalWell{numWellEq_ + numEq, 0.0});
+        primary_variables_.assign(numWellEq_, 0.0);
+        primary_variables_evaluation_.assign(numWellEq_, EvalWell{numWellEq_ + numEq, 0.0});
+
+        // A reused well object keeps its matrices, the perforated cells did not change.
+        if (invDuneD_.N() == 1) {
+            return;
+        }
 
         // setup sparsity pattern for the matrices
         //[A C^T    [x    =  [ res
@@ -264,12 +271,12 @@ namespace Opm
             return EvalWell(numWellEq_ + numEq, 1.0);
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx)) {
                 return primary_variables_evaluation_[WFrac];
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx)) {
                 return primary_variables_evaluation_[GFrac];
             }
 
@@ -277,20 +284,20 @@ namespace Opm
                 return primary_variables_evaluation_[SFrac];
             }
         }
-        else if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx)) {
+        else if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx)) {
                 return primary_variables_evaluation_[GFrac];
             }
         }
 
         // Oil or WATER fraction
         EvalWell well_fraction(numWellEq_ + numEq, 1.0);
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 well_fraction -= primary_variables_evaluation_[WFrac];
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 well_fraction -= primary_variables_evaluation_[GFrac];
             }
 
@@ -298,7 +305,7 @@ namespace Opm
                 well_fraction -= primary_variables_evaluation_[SFrac];
             }
         }
-        else if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx))) {
+        else if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx) && (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx))) {
 
                 well_fraction -= primary_variables_evaluation_[GFrac];
         }
@@ -383,9 +390,10 @@ namespace Opm
         const EvalWell pressure = extendEval(getPerfCellPressure(fs));
         const EvalWell rs = extendEval(fs.Rs());
         const EvalWell rv = extendEval(fs.Rv());
-        std::vector<EvalWell> b_perfcells_dense(num_components_, EvalWell{numWellEq_ + numEq, 0.0});
+        const ScratchAllocator<EvalWell> scratch(this->scratchArena());
+        ScratchVector<EvalWell> b_perfcells_dense(num_components_, EvalWell{numWellEq_ + numEq, 0.0}, scratch);
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!PhaseActivity::phaseIsActive(phaseIdx)) {
                 continue;
             }
 
@@ -429,7 +437,7 @@ namespace Opm
                 cq_s[componentIdx] = b_perfcells_dense[componentIdx] * cq_p;
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx) && PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const EvalWell cq_sOil = cq_s[oilCompIdx];
@@ -463,14 +471,14 @@ namespace Opm
             const EvalWell cqt_i = - Tw * (total_mob_dense * drawdown);
 
             // surface volume fraction of fluids within wellbore
-            std::vector<EvalWell> cmix_s(num_components_, EvalWell{numWellEq_ + numEq});
+            ScratchVector<EvalWell> cmix_s(num_components_, EvalWell{numWellEq_ + numEq}, scratch);
             for (int componentIdx = 0; componentIdx < num_components_; ++componentIdx) {
                 cmix_s[componentIdx] = wellSurfaceVolumeFraction(componentIdx);
             }
 
             // compute volume ratio between connection at standard conditions
             EvalWell volumeRatio(numWellEq_ + numEq, 0.);
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 const unsigned waterCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx);
                 volumeRatio += cmix_s[waterCompIdx] / b_perfcells_dense[waterCompIdx];
             }
@@ -479,7 +487,7 @@ namespace Opm
                 volumeRatio += cmix_s[contiSolventEqIdx] / b_perfcells_dense[contiSolventEqIdx];
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx) && PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 // Incorporate RS/RV factors if both oil and gas active
@@ -499,11 +507,11 @@ namespace Opm
                 volumeRatio += tmp_gas / b_perfcells_dense[gasCompIdx];
             }
             else {
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx)) {
                     const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                     volumeRatio += cmix_s[oilCompIdx] / b_perfcells_dense[oilCompIdx];
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                     volumeRatio += cmix_s[gasCompIdx] / b_perfcells_dense[gasCompIdx];
                 }
@@ -518,7 +526,7 @@ namespace Opm
 
             // calculating the perforation solution gas rate and solution oil rates
             if (this->isProducer()) {
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx) && PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                     const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                     // TODO: the formulations here remain to be tested with cases with strong crossflow through production wells
@@ -592,12 +600,28 @@ namespace Opm
         std::vector<RateVector> connectionRates = connectionRates_; // Copy to get right size.
         const int rate_start_offset = first_perf_ * number_of_phases_;
         auto * perf_rates = &well_state.mutable_perfPhaseRates()[rate_start_offset];
+
+        // The cross flow decision only depends on the well, and checking for it
+        // involves a loop over all perforations (and a collective operation for
+        // distributed wells). Do it once for the well and not for every perforation.
+        const bool allow_cf = getAllowCrossFlow() || openCrossFlowAvoidSingularity(ebosSimulator);
+
+        // Temporaries for the perforation quantities, allocated once for the well
+        // and reset for each perforation.
+        std::vector<EvalWell> cq_s(num_components_, {numWellEq_ + numEq, 0.0});
+        std::vector<EvalWell> mob(num_components_, {numWellEq_ + numEq, 0.0});
+        EvalWell water_flux_s{numWellEq_ + numEq, 0.0};
+        EvalWell cq_s_zfrac_effective{numWellEq_ + numEq, 0.0};
+        this->prefetchPerforation(ebosSimulator, 0);
         for (int perf = 0; perf < number_of_perforations_; ++perf) {
+            this->prefetchPerforation(ebosSimulator, perf + 1);
             // Calculate perforation quantities.
-            std::vector<EvalWell> cq_s(num_components_, {numWellEq_ + numEq, 0.0});
-            EvalWell water_flux_s{numWellEq_ + numEq, 0.0};
-            EvalWell cq_s_zfrac_effective{numWellEq_ + numEq, 0.0};
-            calculateSinglePerf(ebosSimulator, perf, well_state, connectionRates, cq_s, water_flux_s, cq_s_zfrac_effective, deferred_logger);
+            for (auto& rate : cq_s) {
+                rate = 0.0;
+            }
+            water_flux_s = 0.0;
+            cq_s_zfrac_effective = 0.0;
+            calculateSinglePerf(ebosSimulator, perf, allow_cf, well_state, connectionRates, mob, cq_s, water_flux_s, cq_s_zfrac_effective, deferred_logger);
 
             // Equation assembly for this perforation.
             if constexpr (has_polymer && Base::has_polymermw) {
@@ -684,18 +708,18 @@ namespace Opm
     StandardWell<TypeTag>::
     calculateSinglePerf(const Simulator& ebosSimulator,
                         const int perf,
+                        const bool allow_cf,
                         WellState& well_state,
                         std::vector<RateVector>& connectionRates,
+                        std::vector<EvalWell>& mob,
                         std::vector<EvalWell>& cq_s,
                         EvalWell& water_flux_s,
                         EvalWell& cq_s_zfrac_effective,
                         DeferredLogger& deferred_logger) const
     {
-        const bool allow_cf = getAllowCrossFlow() || openCrossFlowAvoidSingularity(ebosSimulator);
         const EvalWell& bhp = getBhp();
         const int cell_idx = well_cells_[perf];
         const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
-        std::vector<EvalWell> mob(num_components_, {numWellEq_ + numEq, 0.});
         getMobility(ebosSimulator, perf, mob, deferred_logger);
 
         double perf_dis_gas_rate = 0.;
@@ -731,14 +755,14 @@ namespace Opm
 
             auto fs = intQuants.fluidState();
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!PhaseActivity::phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
                 const unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
                 // convert to reservoar conditions
                 EvalWell cq_r_thermal(numWellEq_ + numEq, 0.);
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx) && PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
 
                     if(FluidSystem::waterPhaseIdx == phaseIdx)
                         cq_r_thermal = cq_s[activeCompIdx] / extendEval(fs.invB(phaseIdx));
@@ -873,13 +897,13 @@ namespace Opm
 
         auto getRates = [&]() {
             std::vector<EvalWell> rates(3, EvalWell(numWellEq_ + numEq, 0.0));
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 rates[Water] = getQs(Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx));
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx)) {
                 rates[Oil] = getQs(Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx));
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 rates[Gas] = getQs(Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx));
             }
             return rates;
@@ -941,7 +965,7 @@ namespace Opm
         if( satid == satid_elem ) { // the same saturation number is used. i.e. just use the mobilty from the cell
 
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!PhaseActivity::phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -962,7 +986,7 @@ namespace Opm
 
             // compute the mobility
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!PhaseActivity::phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -978,7 +1002,7 @@ namespace Opm
 
         // modify the water mobility if polymer is present
         if constexpr (has_polymer) {
-            if (!FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (!PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 OPM_DEFLOG_THROW(std::runtime_error, "Water is required when polymer is active", deferred_logger);
             }
 
@@ -1030,14 +1054,14 @@ namespace Opm
                                        : 1.0;
 
         // update the second and third well variable (The flux fractions)
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
             const int sign2 = dwells[0][WFrac] > 0 ? 1: -1;
             const double dx2_limited = sign2 * std::min(std::abs(dwells[0][WFrac] * relaxation_factor_fractions), dFLimit);
             // primary_variables_[WFrac] = old_primary_variables[WFrac] - dx2_limited;
             primary_variables_[WFrac] = old_primary_variables[WFrac] - dx2_limited;
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
             const int sign3 = dwells[0][GFrac] > 0 ? 1: -1;
             const double dx3_limited = sign3 * std::min(std::abs(dwells[0][GFrac] * relaxation_factor_fractions), dFLimit);
             primary_variables_[GFrac] = old_primary_variables[GFrac] - dx3_limited;
@@ -1113,28 +1137,28 @@ namespace Opm
         const auto pu = phaseUsage();
         std::vector<double> F(number_of_phases_, 0.0);
 
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx)) {
             F[pu.phase_pos[Oil]] = 1.0;
 
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 F[pu.phase_pos[Water]] = primary_variables_[WFrac];
                 F[pu.phase_pos[Oil]] -= F[pu.phase_pos[Water]];
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 F[pu.phase_pos[Gas]] = primary_variables_[GFrac];
                 F[pu.phase_pos[Oil]] -= F[pu.phase_pos[Gas]];
             }
         }
-        else if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        else if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
             F[pu.phase_pos[Water]] = 1.0;
 
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 F[pu.phase_pos[Gas]] = primary_variables_[GFrac];
                 F[pu.phase_pos[Water]] -= F[pu.phase_pos[Gas]];
             }
         }
-        else if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        else if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
             F[pu.phase_pos[Gas]] = 1.0;
         }
 
@@ -1144,42 +1168,42 @@ namespace Opm
             F[pu.phase_pos[Oil]] -= F_solvent;
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
             if (F[Water] < 0.0) {
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                         F[pu.phase_pos[Gas]] /= (1.0 - F[pu.phase_pos[Water]]);
                 }
                 if constexpr (has_solvent) {
                     F_solvent /= (1.0 - F[pu.phase_pos[Water]]);
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx)) {
                     F[pu.phase_pos[Oil]] /= (1.0 - F[pu.phase_pos[Water]]);
                 }
                 F[pu.phase_pos[Water]] = 0.0;
             }
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
             if (F[pu.phase_pos[Gas]] < 0.0) {
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     F[pu.phase_pos[Water]] /= (1.0 - F[pu.phase_pos[Gas]]);
                 }
                 if constexpr (has_solvent) {
                     F_solvent /= (1.0 - F[pu.phase_pos[Gas]]);
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx)) {
                     F[pu.phase_pos[Oil]] /= (1.0 - F[pu.phase_pos[Gas]]);
                 }
                 F[pu.phase_pos[Gas]] = 0.0;
             }
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx)) {
             if (F[pu.phase_pos[Oil]] < 0.0) {
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     F[pu.phase_pos[Water]] /= (1.0 - F[pu.phase_pos[Oil]]);
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     F[pu.phase_pos[Gas]] /= (1.0 - F[pu.phase_pos[Oil]]);
                 }
                 if constexpr (has_solvent) {
@@ -1189,10 +1213,10 @@ namespace Opm
             }
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
             primary_variables_[WFrac] = F[pu.phase_pos[Water]];
         }
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
             primary_variables_[GFrac] = F[pu.phase_pos[Gas]];
         }
         if constexpr (has_solvent) {
@@ -1212,17 +1236,17 @@ namespace Opm
         const PhaseUsage& pu = phaseUsage();
         std::vector<double> F(number_of_phases_, 0.0);
         [[maybe_unused]] double F_solvent = 0.0;
-        if ( FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) ) {
+        if ( PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx) ) {
             const int oil_pos = pu.phase_pos[Oil];
             F[oil_pos] = 1.0;
 
-            if ( FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
+            if ( PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
                 const int water_pos = pu.phase_pos[Water];
                 F[water_pos] = primary_variables_[WFrac];
                 F[oil_pos] -= F[water_pos];
             }
 
-            if ( FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
+            if ( PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
                 const int gas_pos = pu.phase_pos[Gas];
                 F[gas_pos] = primary_variables_[GFrac];
                 F[oil_pos] -= F[gas_pos];
@@ -1233,17 +1257,17 @@ namespace Opm
                 F[oil_pos] -= F_solvent;
             }
         }
-        else if ( FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
+        else if ( PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
             const int water_pos = pu.phase_pos[Water];
             F[water_pos] = 1.0;
 
-            if ( FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
+            if ( PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
                 const int gas_pos = pu.phase_pos[Gas];
                 F[gas_pos] = primary_variables_[GFrac];
                 F[water_pos] -= F[gas_pos];
             }
         }
-        else if ( FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
+        else if ( PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
             const int gas_pos = pu.phase_pos[Gas];
             F[gas_pos] = 1.0;
         }
@@ -1333,13 +1357,13 @@ namespace Opm
         std::vector<double> rates(3, 0.0);
 
         const PhaseUsage& pu = phaseUsage();
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
             rates[ Water ] = well_state.wellRates(index_of_well_)[pu.phase_pos[ Water ] ];
         }
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx)) {
             rates[ Oil ] = well_state.wellRates(index_of_well_)[pu.phase_pos[ Oil ] ];
         }
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
             rates[ Gas ] = well_state.wellRates(index_of_well_)[pu.phase_pos[ Gas ] ];
         }
 
@@ -1399,7 +1423,7 @@ namespace Opm
             // calculating the b for the connection
             std::vector<double> b_perf(num_components_);
             for (size_t phase = 0; phase < FluidSystem::numPhases; ++phase) {
-                if (!FluidSystem::phaseIsActive(phase)) {
+                if (!PhaseActivity::phaseIsActive(phase)) {
                     continue;
                 }
                 const unsigned comp_idx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phase));
@@ -1433,7 +1457,7 @@ namespace Opm
             }
 
             // we need to handle the rs and rv when both oil and gas are present
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx) && PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oil_comp_idx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gas_comp_idx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const double rs = (fs.Rs()).value();
@@ -1458,8 +1482,15 @@ namespace Opm
                 ipr_b_[ebosCompIdxToFlowCompIdx(p)] += ipr_b_perf[p];
             }
         }
-        this->parallel_well_info_.communication().sum(ipr_a_.data(), ipr_a_.size());
-        this->parallel_well_info_.communication().sum(ipr_b_.data(), ipr_b_.size());
+        const auto& comm = this->parallel_well_info_.communication();
+        if (comm.size() > 1) {
+            // sum both coefficients with one collective
+            std::vector<double> ipr(ipr_a_);
+            ipr.insert(ipr.end(), ipr_b_.begin(), ipr_b_.end());
+            comm.sum(ipr.data(), ipr.size());
+            std::copy(ipr.begin(), ipr.begin() + ipr_a_.size(), ipr_a_.begin());
+            std::copy(ipr.begin() + ipr_a_.size(), ipr.end(), ipr_b_.begin());
+        }
     }
 
 
@@ -1660,9 +1691,9 @@ namespace Opm
         surf_dens_perf.resize(nperf * num_components_);
         const int w = index_of_well_;
 
-        const bool waterPresent = FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx);
-        const bool oilPresent = FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx);
-        const bool gasPresent = FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx);
+        const bool waterPresent = PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx);
+        const bool oilPresent = PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx);
+        const bool gasPresent = PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx);
 
         //rs and rv are only used if both oil and gas is present
         if (oilPresent && gasPresent) {
@@ -1676,7 +1707,9 @@ namespace Opm
                                                                          perf_press.data(),
                                                                          nperf);
 
+        this->prefetchPerforation(ebosSimulator, 0);
         for (int perf = 0; perf < nperf; ++perf) {
+            this->prefetchPerforation(ebosSimulator, perf + 1);
             const int cell_idx = well_cells_[perf];
             const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
             const auto& fs = intQuants.fluidState();
@@ -1743,7 +1776,7 @@ namespace Opm
 
             // Surface density.
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!PhaseActivity::phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -1878,7 +1911,7 @@ namespace Opm
             x = mix;
 
             // Subtract dissolved gas from oil phase and vapporized oil from gas phase
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx) && PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx)) {
                 const unsigned gaspos = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const unsigned oilpos = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 double rs = 0.0;
@@ -1989,7 +2022,7 @@ namespace Opm
         CR::WellFailure::Type type = CR::WellFailure::Type::MassBalance;
         // checking if any NaN or too large residuals found
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!PhaseActivity::phaseIsActive(phaseIdx)) {
                 continue;
             }
 
@@ -2167,6 +2200,10 @@ namespace Opm
     computeWellConnectionPressures(const Simulator& ebosSimulator,
                                    const WellState& well_state)
     {
+         if (connectionPressuresUpToDate(well_state)) {
+             return;
+         }
+
          // 1. Compute properties required by computeConnectionPressureDelta().
          //    Note that some of the complexity of this part is due to the function
          //    taking std::vector<double> arguments, and not Eigen objects.
@@ -2176,6 +2213,76 @@ namespace Opm
          std::vector<double> surf_dens_perf;
          computePropertiesForWellConnectionPressures(ebosSimulator, well_state, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
          computeWellConnectionDensitesPressures(ebosSimulator, well_state, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
+         storeConnectionPressureState(well_state);
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    bool
+    StandardWell<TypeTag>::
+    connectionPressuresUpToDate(const WellState& well_state) const
+    {
+        const double tolerance = param_.well_connection_pressure_tolerance_;
+        // the solvent rates are not part of the stored state
+        if (tolerance <= 0.0 || has_solvent) {
+            return false;
+        }
+
+        const int nperf = number_of_perforations_;
+        const int np = number_of_phases_;
+        const int w = index_of_well_;
+        const auto& well_rates = well_state.wellRates(w);
+        double rate_scale = 0.0;
+        for (int p = 0; p < np; ++p) {
+            rate_scale += std::abs(well_rates[p]);
+        }
+
+        // without rates the mixture follows the mobilities of the cells, always recompute
+        double change = std::numeric_limits<double>::max();
+        if (rate_scale > 0.0 && conn_press_perf_press_.size() == static_cast<std::size_t>(nperf)) {
+            const auto relative = [](const double value, const double old) {
+                return std::abs(value - old) / std::max(std::abs(old), 1.0);
+            };
+            change = relative(well_state.bhp(w), conn_press_bhp_);
+            const auto& perf_press = well_state.perfPress(w);
+            const auto * perf_rates = &well_state.perfPhaseRates()[first_perf_ * np];
+            for (int perf = 0; perf < nperf; ++perf) {
+                change = std::max(change, relative(perf_press[perf], conn_press_perf_press_[perf]));
+                for (int p = 0; p < np; ++p) {
+                    const double rate_change = std::abs(perf_rates[perf * np + p] - conn_press_perf_rates_[perf * np + p]);
+                    change = std::max(change, rate_change / rate_scale);
+                }
+            }
+        }
+        // the connection pressures are accumulated over all processes of the well
+        change = this->parallel_well_info_.communication().max(change);
+        return change < tolerance;
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::
+    storeConnectionPressureState(const WellState& well_state)
+    {
+        if (param_.well_connection_pressure_tolerance_ <= 0.0 || has_solvent) {
+            return;
+        }
+
+        const int nperf = number_of_perforations_;
+        const int np = number_of_phases_;
+        const int w = index_of_well_;
+        conn_press_bhp_ = well_state.bhp(w);
+        const auto& perf_press = well_state.perfPress(w);
+        conn_press_perf_press_.assign(perf_press.begin(), perf_press.begin() + nperf);
+        const auto * perf_rates = &well_state.perfPhaseRates()[first_perf_ * np];
+        conn_press_perf_rates_.assign(perf_rates, perf_rates + nperf * np);
     }
 
 
@@ -2243,6 +2350,11 @@ namespace Opm
             // Contributions are already in the matrix itself
             return;
         }
+        if (numWellEq_ == numStaticWellEq && this->parallel_well_info_.communication().size() == 1) {
+            applySchurComplementSerial(x, Ax);
+            return;
+        }
+
         assert( Bx_.size() == duneB_.N() );
         assert( invDrw_.size() == invDuneD_.N() );
 
@@ -2262,6 +2374,54 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::
+    applySchurComplementSerial(const BVector& x, BVector& Ax) const
+    {
+        constexpr int nw = numStaticWellEq;
+        assert(invDuneD_[0][0].N() == nw);
+
+        // Bx = duneB_ * x
+        std::array<Scalar, nw> Bx{};
+        const auto& rowB = duneB_[0];
+        for (auto colB = rowB.begin(), endB = rowB.end(); colB != endB; ++colB) {
+            const auto& block = *colB;
+            const auto& xc = x[colB.index()];
+            for (int i = 0; i < nw; ++i) {
+                for (int j = 0; j < numEq; ++j) {
+                    Bx[i] += block[i][j] * xc[j];
+                }
+            }
+        }
+
+        // invDBx = invDuneD_ * Bx
+        std::array<Scalar, nw> invDBx{};
+        const auto& invD = invDuneD_[0][0];
+        for (int i = 0; i < nw; ++i) {
+            for (int j = 0; j < nw; ++j) {
+                invDBx[i] += invD[i][j] * Bx[j];
+            }
+        }
+
+        // Ax = Ax - duneC_^T * invDBx
+        const auto& rowC = duneC_[0];
+        for (auto colC = rowC.begin(), endC = rowC.end(); colC != endC; ++colC) {
+            const auto& block = *colC;
+            auto& axc = Ax[colC.index()];
+            for (int j = 0; j < numEq; ++j) {
+                Scalar sum = 0.0;
+                for (int i = 0; i < nw; ++i) {
+                    sum += block[i][j] * invDBx[i];
+                }
+                axc[j] -= sum;
+            }
+        }
+    }
+
+
+
+
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
@@ -2277,7 +2437,27 @@ namespace Opm
         duneC_.mmtv(invDrw_, r);
     }
 
-#if HAVE_CUDA || HAVE_OPENCL
+
+
+
+    template<typename TypeTag>
+    bool
+    StandardWell<TypeTag>::
+    addPackedSchurComplement(PackedWellSchurComplement<Scalar, numEq>& packed) const
+    {
+        // the B x product of distributed wells needs communication, see parallelB_
+        if (this->parallel_well_info_.communication().size() > 1) {
+            return false;
+        }
+        // apply() does nothing for these wells
+        if (!this->isOperable() && !this->wellIsStopped()) {
+            return true;
+        }
+        packed.addWell(duneB_, duneC_, invDuneD_);
+        return true;
+    }
+
+#if HAVE_CUDA || HAVE_OPENCL || HAVE_FPGA
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
@@ -2664,6 +2844,9 @@ namespace Opm
                              *this, ebos_simulator, summary_state,
                              deferred_logger, well_state);
                     auto state = glift->runOptimize(ebos_simulator.model().newtonMethod().numIterations());
+                    gliftDebug(fmt::format("bhp(alq) cache hits/misses: {}/{}",
+                                           glift_cache_.hits(), glift_cache_.misses()),
+                               deferred_logger);
                     if (state) {
                         glift_state_map.insert({this->name(), std::move(state)});
                         glift_wells.insert({this->name(), std::move(glift)});
@@ -2775,10 +2958,10 @@ namespace Opm
         }
 
         if (std::abs(total_well_rate) > 0.) {
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 primary_variables_[WFrac] = scalingFactor(pu.phase_pos[Water]) * well_state.wellRates(well_index)[pu.phase_pos[Water]] / total_well_rate;
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 primary_variables_[GFrac] = scalingFactor(pu.phase_pos[Gas]) * (well_state.wellRates(well_index)[pu.phase_pos[Gas]]
                                                  - (has_solvent ? well_state.solventWellRate(well_index) : 0.0) ) / total_well_rate ;
             }
@@ -2789,7 +2972,7 @@ namespace Opm
             if (this->isInjector()) {
                 auto phase = well_ecl_.getInjectionProperties().injectorType;
                 // only single phase injection handled
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     if (phase == InjectorType::WATER) {
                         primary_variables_[WFrac] = 1.0;
                     } else {
@@ -2797,7 +2980,7 @@ namespace Opm
                     }
                 }
 
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     if (phase == InjectorType::GAS) {
                         primary_variables_[GFrac] = 1.0;
                         if constexpr (has_solvent) {
@@ -2814,10 +2997,10 @@ namespace Opm
                 // this will happen.
             } else if (this->isProducer()) { // producers
                 // TODO: the following are not addressed for the solvent case yet
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     primary_variables_[WFrac] = 1.0 / np;
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     primary_variables_[GFrac] = 1.0 / np;
                 }
             } else {
@@ -2958,14 +3141,57 @@ namespace Opm
                 // of implementation. It can be changed to be more consistent when possible.
                 water_velocity *= PolymerModule::shrate( int_quant.pvtRegionIndex() ) / bore_diameters_[perf];
             }
-            const EvalWell shear_factor = PolymerModule::computeShearFactor(polymer_concentration,
-                                                                int_quant.pvtRegionIndex(),
-                                                                water_velocity);
+            const EvalWell shear_factor = computeShearFactor(perf, polymer_concentration,
+                                                             int_quant.pvtRegionIndex(),
+                                                             water_velocity);
              // modify the mobility with the shear factor.
             mob[waterCompIdx] /= shear_factor;
         }
     }
 
+
+
+
+
+    template<typename TypeTag>
+    typename StandardWell<TypeTag>::EvalWell
+    StandardWell<TypeTag>::
+    computeShearFactor(const int perf,
+                       const EvalWell& polymer_concentration,
+                       const int region,
+                       const EvalWell& water_velocity) const
+    {
+        // The iterative solve for the shear factor only depends on the concentration
+        // and the velocity, so it is done with the two of them as the only derivatives
+        // instead of all the derivatives of the well equations. The result is kept and
+        // reused as long as they do not change, e.g. in the repeated evaluations of the
+        // well equations between two Newton updates.
+        if (shear_factor_cache_.size() != static_cast<std::size_t>(number_of_perforations_)) {
+            shear_factor_cache_.assign(number_of_perforations_, ShearFactorCache{});
+        }
+        auto& cache = shear_factor_cache_[perf];
+        const double concentration = polymer_concentration.value();
+        const double velocity = water_velocity.value();
+        if (cache.region != region || cache.concentration != concentration || cache.velocity != velocity) {
+            using ShearEval = DenseAd::Evaluation<double, 2>;
+            const ShearEval concentration_eval(concentration, 0);
+            const ShearEval velocity_eval(velocity, 1);
+            const ShearEval factor = PolymerModule::computeShearFactor(concentration_eval, region, velocity_eval);
+            cache.region = region;
+            cache.concentration = concentration;
+            cache.velocity = velocity;
+            cache.factor = factor.value();
+            cache.dConcentration = factor.derivative(0);
+            cache.dVelocity = factor.derivative(1);
+        }
+
+        // the chain rule for the derivatives of the well equations
+        EvalWell shear_factor = (polymer_concentration - concentration) * cache.dConcentration
+                              + (water_velocity - velocity) * cache.dVelocity;
+        shear_factor += cache.factor;
+        return shear_factor;
+    }
+
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::addWellContributions(SparseMatrixAdapter& jacobian) const
@@ -2994,6 +3220,36 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::addWellContributionsInPattern(typename SparseMatrixAdapter::IstlMatrix& mat) const
+    {
+        // Same as addWellContributions(), but only for the blocks of A
+        // which exist, the couplings between perforated cells which are
+        // not neighbours are dropped.
+        typename SparseMatrixAdapter::MatrixBlock tmpMat;
+        Dune::DynamicMatrix<Scalar> tmp;
+        for ( auto colC = duneC_[0].begin(), endC = duneC_[0].end(); colC != endC; ++colC )
+        {
+            auto& row = mat[colC.index()];
+
+            for ( auto colB = duneB_[0].begin(), endB = duneB_[0].end(); colB != endB; ++colB )
+            {
+                auto block = row.find(colB.index());
+                if (block == row.end()) {
+                    continue;
+                }
+                Detail::multMatrix(invDuneD_[0][0],  (*colB), tmp);
+                Detail::negativeMultMatrixTransposed((*colC), tmp, tmpMat);
+                *block += tmpMat;
+            }
+        }
+    }
+
+
+
+
+
     template<typename TypeTag>
     double
     StandardWell<TypeTag>::
@@ -3036,17 +3292,17 @@ namespace Opm
         double relaxation_factor = 1.0;
 
         if (FluidSystem::numActivePhases() > 1) {
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 const double relaxation_factor_w = relaxationFactorFraction(primary_variables[WFrac], dwells[0][WFrac]);
                 relaxation_factor = std::min(relaxation_factor, relaxation_factor_w);
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const double relaxation_factor_g = relaxationFactorFraction(primary_variables[GFrac], dwells[0][GFrac]);
                 relaxation_factor = std::min(relaxation_factor, relaxation_factor_g);
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (PhaseActivity::phaseIsActive(FluidSystem::waterPhaseIdx) && PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 // We need to make sure the even with the relaxation_factor, the sum of F_w and F_g is below one, so there will
                 // not be negative oil fraction later
                 const double original_sum = primary_variables[WFrac] + primary_variables[GFrac];
@@ -3988,8 +4244,8 @@ namespace Opm
             connPI[p] = connPICalc(connMob);
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) &&
-            FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx))
+        if (PhaseActivity::phaseIsActive(FluidSystem::oilPhaseIdx) &&
+            PhaseActivity::phaseIsActive(FluidSystem::gasPhaseIdx))
         {
             const auto io = pu.phase_pos[Oil];
             const auto ig = pu.phase_pos[Gas];
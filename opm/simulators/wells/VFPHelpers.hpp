@@ -23,6 +23,7 @@
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/VFPProdTable.hpp>
@@ -206,14 +207,11 @@ inline InterpData findInterpData(const double& value_in, const std::vector<doubl
             retval.ind_[1] = nvalues-1;
         }
         else {
-            //Search internal intervals
-            for (int i=1; i<nvalues; ++i) {
-                if (values[i] >= value) {
-                    retval.ind_[0] = i-1;
-                    retval.ind_[1] = i;
-                    break;
-                }
-            }
+            //Search internal intervals for the first element greater than or equal to value,
+            //the axes are sorted so a binary search can be used
+            const int i = std::lower_bound(values.begin() + 1, values.end(), value) - values.begin();
+            retval.ind_[0] = i-1;
+            retval.ind_[1] = i;
         }
 
         const double start = values[retval.ind_[0]];
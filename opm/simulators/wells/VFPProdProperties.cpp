@@ -26,6 +26,8 @@
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/simulators/wells/VFPHelpers.hpp>
 
+#include <algorithm>
+
 
 
 namespace Opm {
@@ -58,22 +60,36 @@ double VFPProdProperties::thp(int table_id,
         gfr = detail::getGFR(table, aqua, liquid, vapour);
     }
 
-    const std::vector<double> thp_array = table.getTHPAxis();
+    const std::vector<double>& thp_array = table.getTHPAxis();
     int nthp = thp_array.size();
 
     /**
      * Find the function bhp_array(thp) by creating a 1D view of the data
-     * by interpolating for every value of thp. This might be somewhat
-     * expensive, but let us assome that nthp is small.
+     * by interpolating for every value of thp. The thp values are nodes of
+     * the table, so this is a 4D interpolation for each of them, using the
+     * cached corner values of the hypercube.
      */
     auto flo_i = detail::findInterpData( flo, table.getFloAxis());
     auto wfr_i = detail::findInterpData( wfr, table.getWFRAxis());
     auto gfr_i = detail::findInterpData( gfr, table.getGFRAxis());
     auto alq_i = detail::findInterpData( alq, table.getALQAxis());
+    const std::vector<double>& slice = thpSlice(table_id, table, flo_i, wfr_i, gfr_i, alq_i);
     std::vector<double> bhp_array(nthp);
     for (int i=0; i<nthp; ++i) {
-        auto thp_i = detail::findInterpData(thp_array[i], thp_array);
-        bhp_array[i] = detail::interpolate(table, flo_i, thp_i, wfr_i, gfr_i, alq_i).value;
+        // corners are ordered as [w][g][a][f], reduce along flo, alq, gfr and wfr
+        // in the same order as detail::interpolate()
+        double nn[16];
+        std::copy_n(slice.begin() + 16*i, 16, nn);
+        for (int j = 0; j < 8; ++j) {
+            nn[j] = (1.0 - flo_i.factor_)*nn[2*j] + flo_i.factor_*nn[2*j + 1];
+        }
+        for (int j = 0; j < 4; ++j) {
+            nn[j] = (1.0 - alq_i.factor_)*nn[2*j] + alq_i.factor_*nn[2*j + 1];
+        }
+        for (int j = 0; j < 2; ++j) {
+            nn[j] = (1.0 - gfr_i.factor_)*nn[2*j] + gfr_i.factor_*nn[2*j + 1];
+        }
+        bhp_array[i] = (1.0 - wfr_i.factor_)*nn[0] + wfr_i.factor_*nn[1];
     }
 
     double retval = detail::findTHP(bhp_array, thp_array, bhp_arg);
@@ -81,6 +97,41 @@ double VFPProdProperties::thp(int table_id,
 }
 
 
+const std::vector<double>&
+VFPProdProperties::thpSlice(const int table_id,
+                            const VFPProdTable& table,
+                            const detail::InterpData& flo_i,
+                            const detail::InterpData& wfr_i,
+                            const detail::InterpData& gfr_i,
+                            const detail::InterpData& alq_i) const
+{
+    const std::array<int, 5> key{table_id, flo_i.ind_[0], wfr_i.ind_[0], gfr_i.ind_[0], alq_i.ind_[0]};
+
+    std::lock_guard<std::mutex> lock(m_thp_slices_mutex);
+    auto it = m_thp_slices.find(key);
+    if (it != m_thp_slices.end()) {
+        return it->second;
+    }
+
+    const int nthp = table.getTHPAxis().size();
+    std::vector<double> slice;
+    slice.reserve(16*nthp);
+    for (int t = 0; t < nthp; ++t) {
+        for (int w = 0; w <= 1; ++w) {
+            for (int g = 0; g <= 1; ++g) {
+                for (int a = 0; a <= 1; ++a) {
+                    for (int f = 0; f <= 1; ++f) {
+                        slice.push_back(table(t, wfr_i.ind_[w], gfr_i.ind_[g], alq_i.ind_[a], flo_i.ind_[f]));
+                    }
+                }
+            }
+        }
+    }
+    // references to map elements stay valid when other elements are inserted
+    return m_thp_slices.emplace(key, std::move(slice)).first->second;
+}
+
+
 double VFPProdProperties::bhp(int table_id,
                               const double& aqua,
                               const double& liquid,
@@ -94,6 +145,27 @@ double VFPProdProperties::bhp(int table_id,
 }
 
 
+DenseAd::Evaluation<double, 3>
+VFPProdProperties::bhpWithDerivatives(int table_id,
+                                      const double& aqua,
+                                      const double& liquid,
+                                      const double& vapour,
+                                      const double& thp_arg,
+                                      const double& alq,
+                                      double& dbhp_dthp) const {
+    using Eval = DenseAd::Evaluation<double, 3>;
+    const Eval retval = bhp(table_id,
+                            Eval::createVariable(aqua, 0),
+                            Eval::createVariable(liquid, 1),
+                            Eval::createVariable(vapour, 2),
+                            thp_arg, alq);
+
+    const VFPProdTable& table = detail::getTable(m_tables, table_id);
+    dbhp_dthp = detail::bhp(table, aqua, liquid, vapour, thp_arg, alq).dthp;
+    return retval;
+}
+
+
 const VFPProdTable& VFPProdProperties::getTable(const int table_id) const {
     return detail::getTable(m_tables, table_id);
 }
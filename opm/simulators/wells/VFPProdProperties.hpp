@@ -25,8 +25,10 @@
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/simulators/wells/VFPHelpers.hpp>
 
-#include <vector>
+#include <array>
 #include <map>
+#include <mutex>
+#include <vector>
 
 
 namespace Opm {
@@ -112,6 +114,28 @@ public:
             const double& thp,
             const double& alq) const;
 
+    /**
+     * Linear interpolation of bhp and of its derivatives as a function of the
+     * input parameters
+     * @param table_id Table number to use
+     * @param aqua Water phase
+     * @param liquid Oil phase
+     * @param vapour Gas phase
+     * @param thp Tubing head pressure
+     * @param alq Artificial lift or other parameter
+     * @param dbhp_dthp The derivative of the bottom hole pressure with respect to thp
+     *
+     * @return The bottom hole pressure, with its derivatives with respect to aqua,
+     * liquid and vapour, in this order.
+     */
+    DenseAd::Evaluation<double, 3> bhpWithDerivatives(int table_id,
+                                                      const double& aqua,
+                                                      const double& liquid,
+                                                      const double& vapour,
+                                                      const double& thp,
+                                                      const double& alq,
+                                                      double& dbhp_dthp) const;
+
     /**
      * Linear interpolation of thp as a function of the input parameters
      * @param table_id Table number to use
@@ -160,8 +184,24 @@ protected:
                                    const double alq,
                                    const double dp) const;
 
+    // The table values at the corners of the (flo, wfr, gfr, alq) hypercube for every
+    // thp value, as used to find the thp from the bhp. Returns a reference to the
+    // cached nthp x 16 values, they are gathered from the table on first use.
+    const std::vector<double>& thpSlice(const int table_id,
+                                        const VFPProdTable& table,
+                                        const detail::InterpData& flo_i,
+                                        const detail::InterpData& wfr_i,
+                                        const detail::InterpData& gfr_i,
+                                        const detail::InterpData& alq_i) const;
+
     // Map which connects the table number with the table itself
     std::map<int, std::reference_wrapper<const VFPProdTable>> m_tables;
+
+    // Cache of thpSlice(), keyed by the table number and the first index of the
+    // flo, wfr, gfr and alq intervals. The tables do not change during the lifetime
+    // of this object, it is rebuilt when the schedule changes the VFP tables.
+    mutable std::map<std::array<int, 5>, std::vector<double>> m_thp_slices;
+    mutable std::mutex m_thp_slices_mutex;
 };
 
 
@@ -27,4 +27,10 @@ WGState::WGState(const PhaseUsage& pu) :
     group_state(pu.num_phases)
 {}
 
+void WGState::assignValues(const WGState& other)
+{
+    this->well_state.assignValues(other.well_state);
+    this->group_state = other.group_state;
+}
+
 }
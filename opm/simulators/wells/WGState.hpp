@@ -34,6 +34,9 @@ struct PhaseUsage;
 struct WGState {
     WGState(const PhaseUsage& pu);
 
+    // Copy other into this state, reusing the storage of the well state.
+    void assignValues(const WGState& other);
+
     WellState well_state;
     GroupState group_state;
 };
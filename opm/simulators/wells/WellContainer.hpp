@@ -20,6 +20,7 @@
 #ifndef OPM_WELL_CONTAINER_HEADER_INCLUDED
 #define OPM_WELL_CONTAINER_HEADER_INCLUDED
 
+#include <cassert>
 #include <initializer_list>
 #include <stdexcept>
 #include <string>
@@ -113,6 +114,16 @@ public:
         }
     }
 
+    /*
+      Will copy the values from other to this, the containers must hold the
+      same wells in the same order, e.g. because one is a copy of the other.
+      The index map is not copied.
+    */
+    void copy_values(const WellContainer<T>& other) {
+        assert(this->m_data.size() == other.m_data.size());
+        this->m_data = other.m_data;
+    }
+
     /*
       Will copy the value for well @name from other to this. The well @name must
       exist in both containers, otherwise an exception is thrown.
@@ -28,13 +28,18 @@
 #include <opm/simulators/utils/DeferredLogger.hpp>
 #include <opm/simulators/utils/DeferredLoggingErrorHelpers.hpp>
 #include <opm/simulators/wells/GroupState.hpp>
+#include <opm/simulators/wells/GroupTree.hpp>
 #include <opm/simulators/wells/TargetCalculator.hpp>
 #include <opm/simulators/wells/VFPProdProperties.hpp>
 #include <opm/simulators/wells/WellState.hpp>
 #include <opm/simulators/wells/WellContainer.hpp>
 
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <set>
 #include <stack>
 
@@ -294,177 +299,132 @@ namespace WellGroupHelpers
         }
     }
 
-    void updateGroupTargetReduction(const Group& group,
-                                    const Schedule& schedule,
-                                    const int reportStepIdx,
+    void updateGroupTargetReduction(const GroupTree& tree,
                                     const bool isInjector,
                                     const PhaseUsage& pu,
                                     const GuideRate& guide_rate,
                                     const WellState& wellStateNupcol,
-                                    WellState& wellState,
-                                    GroupState& group_state,
-                                    std::vector<double>& groupTargetReduction)
+                                    const WellState& wellState,
+                                    GroupState& group_state)
     {
-        const int np = wellState.numPhases();
-        for (const std::string& subGroupName : group.groups()) {
-            std::vector<double> subGroupTargetReduction(np, 0.0);
-            const Group& subGroup = schedule.getGroup(subGroupName, reportStepIdx);
-            updateGroupTargetReduction(subGroup,
-                                       schedule,
-                                       reportStepIdx,
-                                       isInjector,
-                                       pu,
-                                       guide_rate,
-                                       wellStateNupcol,
-                                       wellState,
-                                       group_state,
-                                       subGroupTargetReduction);
-
-            // accumulate group contribution from sub group
-            if (isInjector) {
-                const Phase all[] = {Phase::WATER, Phase::OIL, Phase::GAS};
-                for (Phase phase : all) {
-                    const Group::InjectionCMode& currentGroupControl
-                        = group_state.injection_control(subGroup.name(), phase);
-                    int phasePos;
-                    if (phase == Phase::GAS && pu.phase_used[BlackoilPhases::Vapour])
-                        phasePos = pu.phase_pos[BlackoilPhases::Vapour];
-                    else if (phase == Phase::OIL && pu.phase_used[BlackoilPhases::Liquid])
-                        phasePos = pu.phase_pos[BlackoilPhases::Liquid];
-                    else if (phase == Phase::WATER && pu.phase_used[BlackoilPhases::Aqua])
-                        phasePos = pu.phase_pos[BlackoilPhases::Aqua];
-                    else
-                        continue;
-
-                    if (currentGroupControl != Group::InjectionCMode::FLD
-                        && currentGroupControl != Group::InjectionCMode::NONE) {
-                        // Subgroup is under individual control.
-                        groupTargetReduction[phasePos]
-                            += sumWellRates(subGroup, schedule, wellStateNupcol, reportStepIdx, phasePos, isInjector);
-                    } else {
-                        groupTargetReduction[phasePos] += subGroupTargetReduction[phasePos];
-                    }
-                }
-            } else {
-                const Group::ProductionCMode& currentGroupControl = group_state.production_control(subGroupName);
-                const bool individual_control = (currentGroupControl != Group::ProductionCMode::FLD
-                                                 && currentGroupControl != Group::ProductionCMode::NONE);
-                const int num_group_controlled_wells
-                    = groupControlledWells(schedule, wellStateNupcol, group_state, reportStepIdx, subGroupName, "", !isInjector, /*injectionPhaseNotUsed*/Phase::OIL);
-                if (individual_control || num_group_controlled_wells == 0) {
-                    for (int phase = 0; phase < np; phase++) {
-                        groupTargetReduction[phase]
-                            += sumWellRates(subGroup, schedule, wellStateNupcol, reportStepIdx, phase, isInjector);
+        const std::size_t np = wellState.numPhases();
+        const auto groupRates = tree.sumWellPhaseRates(wellStateNupcol.wellRates(), np, isInjector);
+        std::vector<int> numGroupControlledWells;
+        if (!isInjector) {
+            numGroupControlledWells = tree.groupControlledWells(wellStateNupcol, group_state, /*is_production_group*/ true, /*injectionPhaseNotUsed*/Phase::OIL);
+        }
+
+        // The subgroups come after their parent, the reductions of the
+        // subgroups are therefore complete when their parent is visited.
+        std::vector<double> targetReductions(tree.numGroups() * np, 0.0);
+        for (std::size_t group = tree.numGroups(); group-- > 0;) {
+            double* groupTargetReduction = targetReductions.data() + group * np;
+            for (const int subGroup : tree.children(group)) {
+                const std::string& subGroupName = tree.name(subGroup);
+                const double* subGroupRates = groupRates.data() + subGroup * np;
+                const double* subGroupTargetReduction = targetReductions.data() + subGroup * np;
+
+                // accumulate group contribution from sub group
+                if (isInjector) {
+                    const Phase all[] = {Phase::WATER, Phase::OIL, Phase::GAS};
+                    for (Phase phase : all) {
+                        const Group::InjectionCMode& currentGroupControl
+                            = group_state.injection_control(subGroupName, phase);
+                        int phasePos;
+                        if (phase == Phase::GAS && pu.phase_used[BlackoilPhases::Vapour])
+                            phasePos = pu.phase_pos[BlackoilPhases::Vapour];
+                        else if (phase == Phase::OIL && pu.phase_used[BlackoilPhases::Liquid])
+                            phasePos = pu.phase_pos[BlackoilPhases::Liquid];
+                        else if (phase == Phase::WATER && pu.phase_used[BlackoilPhases::Aqua])
+                            phasePos = pu.phase_pos[BlackoilPhases::Aqua];
+                        else
+                            continue;
+
+                        if (currentGroupControl != Group::InjectionCMode::FLD
+                            && currentGroupControl != Group::InjectionCMode::NONE) {
+                            // Subgroup is under individual control.
+                            groupTargetReduction[phasePos] += subGroupRates[phasePos];
+                        } else {
+                            groupTargetReduction[phasePos] += subGroupTargetReduction[phasePos];
+                        }
                     }
                 } else {
-                    // The subgroup may participate in group control.
-                    if (!guide_rate.has(subGroupName)) {
-                        // Accumulate from this subgroup only if no group guide rate is set for it.
-                        for (int phase = 0; phase < np; phase++) {
-                            groupTargetReduction[phase] += subGroupTargetReduction[phase];
+                    const Group::ProductionCMode& currentGroupControl = group_state.production_control(subGroupName);
+                    const bool individual_control = (currentGroupControl != Group::ProductionCMode::FLD
+                                                     && currentGroupControl != Group::ProductionCMode::NONE);
+                    const int num_group_controlled_wells = numGroupControlledWells[subGroup];
+                    if (individual_control || num_group_controlled_wells == 0) {
+                        for (std::size_t phase = 0; phase < np; phase++) {
+                            groupTargetReduction[phase] += subGroupRates[phase];
+                        }
+                    } else {
+                        // The subgroup may participate in group control.
+                        if (!guide_rate.has(subGroupName)) {
+                            // Accumulate from this subgroup only if no group guide rate is set for it.
+                            for (std::size_t phase = 0; phase < np; phase++) {
+                                groupTargetReduction[phase] += subGroupTargetReduction[phase];
+                            }
                         }
                     }
                 }
             }
-        }
-
-        for (const std::string& wellName : group.wells()) {
-            const auto& wellTmp = schedule.getWell(wellName, reportStepIdx);
-
-            if (wellTmp.isProducer() && isInjector)
-                continue;
 
-            if (wellTmp.isInjector() && !isInjector)
-                continue;
-
-            if (wellTmp.getStatus() == Well::Status::SHUT)
-                continue;
-
-            const auto& end = wellState.wellMap().end();
-            const auto& it = wellState.wellMap().find(wellName);
-            if (it == end) // the well is not found
-                continue;
-
-            int well_index = it->second[0];
+            for (const auto& well : tree.localWells(group)) {
+                if (well.is_injector != isInjector)
+                    continue;
 
-            if (! wellState.wellIsOwned(well_index, wellName) ) // Only sum once
-            {
-                continue;
+                // add contributino from wells not under group control
+                const auto& wellRates = wellStateNupcol.wellRates(well.well_index);
+                if (isInjector) {
+                    if (wellState.currentInjectionControl(well.well_index) != Well::InjectorCMode::GRUP)
+                        for (std::size_t phase = 0; phase < np; phase++) {
+                            groupTargetReduction[phase] += wellRates[phase] * well.efficiency;
+                        }
+                } else {
+                    if (wellState.currentProductionControl(well.well_index) != Well::ProducerCMode::GRUP)
+                        for (std::size_t phase = 0; phase < np; phase++) {
+                            groupTargetReduction[phase] -= wellRates[phase] * well.efficiency;
+                        }
+                }
             }
-
-            const double efficiency = wellTmp.getEfficiencyFactor();
-            // add contributino from wells not under group control
-            if (isInjector) {
-                if (wellState.currentInjectionControl(well_index) != Well::InjectorCMode::GRUP)
-                    for (int phase = 0; phase < np; phase++) {
-                        groupTargetReduction[phase] += wellStateNupcol.wellRates(well_index)[phase] * efficiency;
-                    }
-            } else {
-                if (wellState.currentProductionControl(well_index) != Well::ProducerCMode::GRUP)
-                    for (int phase = 0; phase < np; phase++) {
-                        groupTargetReduction[phase] -= wellStateNupcol.wellRates(well_index)[phase] * efficiency;
-                    }
+            const double groupEfficiency = tree.efficiency(group);
+            for (std::size_t phase = 0; phase < np; phase++) {
+                groupTargetReduction[phase] *= groupEfficiency;
             }
+            const std::vector<double> reduction(groupTargetReduction, groupTargetReduction + np);
+            if (isInjector)
+                group_state.update_injection_reduction_rates(tree.name(group), reduction);
+            else
+                group_state.update_production_reduction_rates(tree.name(group), reduction);
         }
-        const double groupEfficiency = group.getGroupEfficiencyFactor();
-        for (double& elem : groupTargetReduction) {
-            elem *= groupEfficiency;
-        }
-        if (isInjector)
-            group_state.update_injection_reduction_rates(group.name(), groupTargetReduction);
-        else
-            group_state.update_production_reduction_rates(group.name(), groupTargetReduction);
     }
 
 
-    void updateVREPForGroups(const Group& group,
-                             const Schedule& schedule,
-                             const int reportStepIdx,
+    void updateVREPForGroups(const GroupTree& tree,
                              const WellState& wellStateNupcol,
-                             WellState& wellState,
                              GroupState& group_state)
     {
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateVREPForGroups(groupTmp, schedule, reportStepIdx, wellStateNupcol, wellState, group_state);
+        const std::size_t np = wellStateNupcol.numPhases();
+        const auto resvRates = tree.sumWellPhaseRates(wellStateNupcol.wellReservoirRates(), np, /*isInjector*/ false);
+        for (std::size_t group = 0; group < tree.numGroups(); ++group) {
+            double resv = 0.0;
+            for (std::size_t phase = 0; phase < np; ++phase) {
+                resv += resvRates[group * np + phase];
+            }
+            group_state.update_injection_vrep_rate(tree.name(group), resv);
         }
-        const int np = wellState.numPhases();
-        double resv = 0.0;
-        for (int phase = 0; phase < np; ++phase) {
-            resv += sumWellPhaseRates(wellStateNupcol.wellReservoirRates(),
-                                      group,
-                                      schedule,
-                                      wellState,
-                                      reportStepIdx,
-                                      phase,
-                                      /*isInjector*/ false);
-        }
-        group_state.update_injection_vrep_rate(group.name(), resv);
     }
 
-    void updateReservoirRatesInjectionGroups(const Group& group,
-                                             const Schedule& schedule,
-                                             const int reportStepIdx,
+    void updateReservoirRatesInjectionGroups(const GroupTree& tree,
                                              const WellState& wellStateNupcol,
-                                             WellState& wellState,
                                              GroupState& group_state)
     {
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateReservoirRatesInjectionGroups(groupTmp, schedule, reportStepIdx, wellStateNupcol, wellState, group_state);
+        const std::size_t np = wellStateNupcol.numPhases();
+        const auto resvRates = tree.sumWellPhaseRates(wellStateNupcol.wellReservoirRates(), np, /*isInjector*/ true);
+        for (std::size_t group = 0; group < tree.numGroups(); ++group) {
+            const auto first = resvRates.begin() + group * np;
+            group_state.update_injection_reservoir_rates(tree.name(group), std::vector<double>(first, first + np));
         }
-        const int np = wellState.numPhases();
-        std::vector<double> resv(np, 0.0);
-        for (int phase = 0; phase < np; ++phase) {
-            resv[phase] = sumWellPhaseRates(wellStateNupcol.wellReservoirRates(),
-                                            group,
-                                            schedule,
-                                            wellState,
-                                            reportStepIdx,
-                                            phase,
-                                            /*isInjector*/ true);
-        }
-        group_state.update_injection_reservoir_rates(group.name(), resv);
     }
 
     void updateWellRates(const Group& group,
@@ -498,58 +458,45 @@ namespace WellGroupHelpers
         }
     }
 
-    void updateGroupProductionRates(const Group& group,
-                                    const Schedule& schedule,
-                                    const int reportStepIdx,
+    void updateGroupProductionRates(const GroupTree& tree,
                                     const WellState& wellStateNupcol,
-                                    WellState& wellState,
                                     GroupState& group_state)
     {
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateGroupProductionRates(groupTmp, schedule, reportStepIdx, wellStateNupcol, wellState, group_state);
-        }
-        const int np = wellState.numPhases();
-        std::vector<double> rates(np, 0.0);
-        for (int phase = 0; phase < np; ++phase) {
-            rates[phase] = sumWellPhaseRates(
-                wellStateNupcol.wellRates(), group, schedule, wellState, reportStepIdx, phase, /*isInjector*/ false);
+        const std::size_t np = wellStateNupcol.numPhases();
+        const auto rates = tree.sumWellPhaseRates(wellStateNupcol.wellRates(), np, /*isInjector*/ false);
+        for (std::size_t group = 0; group < tree.numGroups(); ++group) {
+            const auto first = rates.begin() + group * np;
+            group_state.update_production_rates(tree.name(group), std::vector<double>(first, first + np));
         }
-        group_state.update_production_rates(group.name(), rates);
     }
 
 
-    void updateREINForGroups(const Group& group,
+    void updateREINForGroups(const GroupTree& tree,
                              const Schedule& schedule,
-                             const int reportStepIdx,
                              const PhaseUsage& pu,
                              const SummaryState& st,
                              const WellState& wellStateNupcol,
-                             WellState& wellState,
                              GroupState& group_state)
     {
-        const int np = wellState.numPhases();
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateREINForGroups(groupTmp, schedule, reportStepIdx, pu, st, wellStateNupcol, wellState, group_state);
-        }
-
-        std::vector<double> rein(np, 0.0);
-        for (int phase = 0; phase < np; ++phase) {
-            rein[phase] = sumWellPhaseRates(
-                wellStateNupcol.wellRates(), group, schedule, wellState, reportStepIdx, phase, /*isInjector*/ false);
-        }
-
-        // add import rate and substract consumption rate for group for gas
-        if (schedule[reportStepIdx].gconsump().has(group.name())) {
-            const auto& gconsump = schedule[reportStepIdx].gconsump().get(group.name(), st);
-            if (pu.phase_used[BlackoilPhases::Vapour]) {
-                rein[pu.phase_pos[BlackoilPhases::Vapour]] += gconsump.import_rate;
-                rein[pu.phase_pos[BlackoilPhases::Vapour]] -= gconsump.consumption_rate;
+        const std::size_t np = wellStateNupcol.numPhases();
+        const auto rates = tree.sumWellPhaseRates(wellStateNupcol.wellRates(), np, /*isInjector*/ false);
+        const auto& gconsump = schedule[tree.reportStep()].gconsump();
+        for (std::size_t group = 0; group < tree.numGroups(); ++group) {
+            const std::string& groupName = tree.name(group);
+            const auto first = rates.begin() + group * np;
+            std::vector<double> rein(first, first + np);
+
+            // add import rate and substract consumption rate for group for gas
+            if (gconsump.has(groupName)) {
+                const auto& consumption = gconsump.get(groupName, st);
+                if (pu.phase_used[BlackoilPhases::Vapour]) {
+                    rein[pu.phase_pos[BlackoilPhases::Vapour]] += consumption.import_rate;
+                    rein[pu.phase_pos[BlackoilPhases::Vapour]] -= consumption.consumption_rate;
+                }
             }
-        }
 
-        group_state.update_injection_rein_rates(group.name(), rein);
+            group_state.update_injection_rein_rates(groupName, rein);
+        }
     }
 
 
@@ -561,7 +508,9 @@ namespace WellGroupHelpers
                             const GroupState& group_state,
                             const VFPProdProperties& vfp_prod_props,
                             const Schedule& schedule,
-                            const int report_time_step)
+                            const int report_time_step,
+                            const std::map<std::string, std::vector<double>>& leaf_rate_derivatives,
+                            const std::map<std::string, double>& previous_node_pressures)
     {
         // TODO: Only dealing with production networks for now.
 
@@ -606,6 +555,8 @@ namespace WellGroupHelpers
             }
         }
 
+        const auto leaf_inflows = node_inflows;
+
         // Accumulate in the network, towards the roots. Note that a
         // root (i.e. fixed pressure node) can still be contributing
         // flow towards other nodes in the network, i.e.  a node is
@@ -670,7 +621,138 @@ namespace WellGroupHelpers
             }
         }
 
-        return node_pressures;
+        // The inflows of the wells under THP control depend on the pressure of
+        // their node, such that the pressures above only balance the network
+        // after some iterations of the well model. With the inflows of the
+        // leaf nodes linear in their pressures, solve the equations
+        // p(node) = bhp(rates(node), p(uptree node)) for all nodes instead.
+        std::map<std::string, std::vector<double>> leaf_sensitivities;
+        for (const auto& node : leaf_nodes) {
+            const auto derivatives = leaf_rate_derivatives.find(node);
+            if (derivatives != leaf_rate_derivatives.end()
+                && previous_node_pressures.count(node) > 0
+                && !network.node(node).terminal_pressure()) {
+                leaf_sensitivities[node] = derivatives->second;
+            }
+        }
+        if (leaf_sensitivities.empty()) {
+            return node_pressures;
+        }
+
+        // The unknowns are the pressures of the nodes without a fixed pressure,
+        // and each node depends on the inflows of the leaf nodes below it.
+        std::map<std::string, int> unknown_index;
+        for (const auto& node : root_to_child_nodes) {
+            if (!network.node(node).terminal_pressure()) {
+                const int index = unknown_index.size();
+                unknown_index[node] = index;
+            }
+        }
+        std::map<std::string, std::vector<std::string>> leaves_below;
+        for (const auto& node : child_to_root_nodes) {
+            auto& below = leaves_below[node];
+            if (leaf_sensitivities.count(node) > 0) {
+                below.push_back(node);
+            }
+            const auto upbranch = network.uptree_branch(node);
+            if (upbranch) {
+                auto& up_below = leaves_below[(*upbranch).uptree_node()];
+                up_below.insert(up_below.end(), below.begin(), below.end());
+            }
+        }
+
+        auto pressures = node_pressures;
+        const int num_unknowns = unknown_index.size();
+        const int max_iterations = 20;
+        const double tolerance = 1.0; // Pa
+        bool converged = false;
+        for (int iteration = 0; iteration < max_iterations; ++iteration) {
+            // The inflows for the current pressures of the leaf nodes.
+            std::map<std::string, std::vector<double>> rates;
+            for (const auto& [node, inflow] : leaf_inflows) {
+                auto& r = rates[node];
+                r = inflow;
+                const auto sensitivity = leaf_sensitivities.find(node);
+                if (sensitivity != leaf_sensitivities.end()) {
+                    const double dp = pressures[node] - previous_node_pressures.at(node);
+                    for (size_t ii = 0; ii < r.size(); ++ii) {
+                        r[ii] = std::max(r[ii] + sensitivity->second[ii] * dp, 0.0);
+                    }
+                }
+            }
+            for (const auto& node : child_to_root_nodes) {
+                const auto upbranch = network.uptree_branch(node);
+                if (upbranch) {
+                    std::vector<double>& up = rates[(*upbranch).uptree_node()];
+                    const std::vector<double>& down = rates[node];
+                    if (up.empty()) {
+                        up = down;
+                    } else if (!down.empty()) {
+                        for (size_t ii = 0; ii < up.size(); ++ii) {
+                            up[ii] += down[ii];
+                        }
+                    }
+                }
+            }
+
+            Dune::DynamicMatrix<double> jacobian(num_unknowns, num_unknowns, 0.0);
+            Dune::DynamicVector<double> residual(num_unknowns, 0.0);
+            double max_residual = 0.0;
+            for (const auto& [node, row] : unknown_index) {
+                const auto upbranch = network.uptree_branch(node);
+                assert(upbranch);
+                const std::string& up = (*upbranch).uptree_node();
+                double dbhp_dup = 1.0;
+                jacobian[row][row] = 1.0;
+                const auto vfp_table = (*upbranch).vfp_table();
+                if (vfp_table) {
+                    // The VFP code expects negative production rates.
+                    const auto& r = rates[node];
+                    assert(r.size() == 3);
+                    const double alq = 0.0; // TODO: Do not ignore ALQ
+                    const auto bhp = vfp_prod_props.bhpWithDerivatives(*vfp_table,
+                                                                       -r[BlackoilPhases::Aqua],
+                                                                       -r[BlackoilPhases::Liquid],
+                                                                       -r[BlackoilPhases::Vapour],
+                                                                       pressures[up],
+                                                                       alq,
+                                                                       dbhp_dup);
+                    residual[row] = pressures[node] - bhp.value();
+                    for (const auto& leaf : leaves_below[node]) {
+                        const auto& sensitivity = leaf_sensitivities[leaf];
+                        double dbhp_dleaf = 0.0;
+                        for (int phase = 0; phase < 3; ++phase) {
+                            dbhp_dleaf -= bhp.derivative(phase) * sensitivity[phase];
+                        }
+                        jacobian[row][unknown_index[leaf]] -= dbhp_dleaf;
+                    }
+                } else {
+                    residual[row] = pressures[node] - pressures[up];
+                }
+                const auto up_index = unknown_index.find(up);
+                if (up_index != unknown_index.end()) {
+                    jacobian[row][up_index->second] -= dbhp_dup;
+                }
+                max_residual = std::max(max_residual, std::abs(residual[row]));
+            }
+            if (max_residual < tolerance) {
+                converged = true;
+                break;
+            }
+
+            Dune::DynamicVector<double> update(num_unknowns, 0.0);
+            try {
+                jacobian.solve(update, residual);
+            } catch (const Dune::FMatrixError&) {
+                break;
+            }
+            for (const auto& [node, index] : unknown_index) {
+                pressures[node] -= update[index];
+            }
+        }
+
+        // Keep the explicit pressures if the Newton iterations fail.
+        return converged ? pressures : node_pressures;
     }
 
 
@@ -879,6 +961,12 @@ namespace WellGroupHelpers
     }
     double FractionCalculator::guideRateSum(const Group& group, const std::string& always_included_child)
     {
+        const CacheKey key{group.name(), always_included_child};
+        const auto cached = guide_rate_sums_.find(key);
+        if (cached != guide_rate_sums_.end()) {
+            return cached->second;
+        }
+
         double total_guide_rate = 0.0;
         for (const std::string& child_group : group.groups()) {
             bool included = (child_group == always_included_child);
@@ -905,6 +993,7 @@ namespace WellGroupHelpers
                 total_guide_rate += guideRate(child_well, always_included_child);
             }
         }
+        guide_rate_sums_.emplace(key, total_guide_rate);
         return total_guide_rate;
     }
     double FractionCalculator::guideRate(const std::string& name, const std::string& always_included_child)
@@ -932,8 +1021,42 @@ namespace WellGroupHelpers
     int FractionCalculator::groupControlledWells(const std::string& group_name,
                                                  const std::string& always_included_child)
     {
-        return ::Opm::WellGroupHelpers::groupControlledWells(
-                                                             schedule_, well_state_, this->group_state_, report_step_, group_name, always_included_child, is_producer_, injection_phase_);
+        // Same as the free function, but the counts of the subgroups are
+        // memoized as well, since fraction() visits them once per level.
+        const CacheKey key{group_name, always_included_child};
+        const auto cached = num_group_controlled_wells_.find(key);
+        if (cached != num_group_controlled_wells_.end()) {
+            return cached->second;
+        }
+
+        const Group& group = schedule_.getGroup(group_name, report_step_);
+        int num_wells = 0;
+        for (const std::string& child_group : group.groups()) {
+            bool included = (child_group == always_included_child);
+            if (is_producer_) {
+                const auto ctrl = this->group_state_.production_control(child_group);
+                included = included || (ctrl == Group::ProductionCMode::FLD) || (ctrl == Group::ProductionCMode::NONE);
+            } else {
+                const auto ctrl = this->group_state_.injection_control(child_group, this->injection_phase_);
+                included = included || (ctrl == Group::InjectionCMode::FLD) || (ctrl == Group::InjectionCMode::NONE);
+            }
+            if (included) {
+                num_wells += groupControlledWells(child_group, always_included_child);
+            }
+        }
+        for (const std::string& child_well : group.wells()) {
+            bool included = (child_well == always_included_child);
+            if (is_producer_) {
+                included = included || well_state_.isProductionGrup(child_well);
+            } else {
+                included = included || well_state_.isInjectionGrup(child_well);
+            }
+            if (included) {
+                ++num_wells;
+            }
+        }
+        num_group_controlled_wells_.emplace(key, num_wells);
+        return num_wells;
     }
 
     GuideRate::RateVector FractionCalculator::getGroupRateVector(const std::string& group_name)
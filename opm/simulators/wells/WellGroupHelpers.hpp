@@ -25,6 +25,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Opm
@@ -33,6 +34,7 @@ namespace Opm
 class DeferredLogger;
 class Group;
 class GroupState;
+class GroupTree;
 namespace Network { class ExtNetwork; }
 struct PhaseUsage;
 class Schedule;
@@ -89,16 +91,15 @@ namespace WellGroupHelpers
                            const int reportStepIdx,
                            const bool injector);
 
-    void updateGroupTargetReduction(const Group& group,
-                                    const Schedule& schedule,
-                                    const int reportStepIdx,
+    /// Update the production or injection reduction rates of all groups,
+    /// in one pass from the leaves of the group tree to FIELD.
+    void updateGroupTargetReduction(const GroupTree& tree,
                                     const bool isInjector,
                                     const PhaseUsage& pu,
                                     const GuideRate& guide_rate,
                                     const WellState& wellStateNupcol,
-                                    WellState& wellState,
-                                    GroupState& group_state,
-                                    std::vector<double>& groupTargetReduction);
+                                    const WellState& wellState,
+                                    GroupState& group_state);
 
     template <class Comm>
     void updateGuideRateForProductionGroups(const Group& group,
@@ -131,18 +132,12 @@ namespace WellGroupHelpers
                                             GuideRate* guideRate,
                                             Opm::DeferredLogger& deferred_logger);
 
-    void updateVREPForGroups(const Group& group,
-                             const Schedule& schedule,
-                             const int reportStepIdx,
+    void updateVREPForGroups(const GroupTree& tree,
                              const WellState& wellStateNupcol,
-                             WellState& wellState,
                              GroupState& group_state);
 
-    void updateReservoirRatesInjectionGroups(const Group& group,
-                                             const Schedule& schedule,
-                                             const int reportStepIdx,
+    void updateReservoirRatesInjectionGroups(const GroupTree& tree,
                                              const WellState& wellStateNupcol,
-                                             WellState& wellState,
                                              GroupState& group_state);
 
     void updateWellRates(const Group& group,
@@ -151,29 +146,31 @@ namespace WellGroupHelpers
                          const WellState& wellStateNupcol,
                          WellState& wellState);
 
-    void updateGroupProductionRates(const Group& group,
-                                    const Schedule& schedule,
-                                    const int reportStepIdx,
+    void updateGroupProductionRates(const GroupTree& tree,
                                     const WellState& wellStateNupcol,
-                                    WellState& wellState,
                                     GroupState& group_state);
 
-    void updateREINForGroups(const Group& group,
+    void updateREINForGroups(const GroupTree& tree,
                              const Schedule& schedule,
-                             const int reportStepIdx,
                              const PhaseUsage& pu,
                              const SummaryState& st,
                              const WellState& wellStateNupcol,
-                             WellState& wellState,
                              GroupState& group_state);
 
+    // The pressures of the nodes of the extended network for the current
+    // production rates of the groups. Given the derivatives of the production
+    // rates of leaf nodes with respect to their node pressures, linearized at
+    // the previous node pressures, the pressures are those which balance the
+    // network with the inflows of the leaf nodes, found by Newton's method.
     std::map<std::string, double>
     computeNetworkPressures(const Opm::Network::ExtNetwork& network,
                             const WellState& well_state,
                             const GroupState& group_state,
                             const VFPProdProperties& vfp_prod_props,
                             const Schedule& schedule,
-                            const int report_time_step);
+                            const int report_time_step,
+                            const std::map<std::string, std::vector<double>>& leaf_rate_derivatives = {},
+                            const std::map<std::string, double>& previous_node_pressures = {});
 
     GuideRate::RateVector
     getWellRateVector(const WellState& well_state, const PhaseUsage& pu, const std::string& name);
@@ -211,6 +208,10 @@ namespace WellGroupHelpers
                              const Phase injection_phase);
 
 
+    /// Computes the fraction of a group target assigned to a well or group.
+    /// The guide rate sums and the number of group controlled wells are
+    /// memoized per (group, always included child), so a calculator must
+    /// not be used after the well or group state it was created with changed.
     class FractionCalculator
     {
     public:
@@ -241,6 +242,9 @@ namespace WellGroupHelpers
         const PhaseUsage& pu_;
         bool is_producer_;
         Phase injection_phase_;
+        using CacheKey = std::pair<std::string, std::string>;
+        std::map<CacheKey, double> guide_rate_sums_;
+        std::map<CacheKey, int> num_group_controlled_wells_;
     };
 
 
@@ -51,6 +51,7 @@ namespace Opm {
 #include <opm/simulators/flow/BlackoilModelParametersEbos.hpp>
 
 #include <opm/simulators/utils/DeferredLogger.hpp>
+#include <opm/simulators/utils/ScratchArena.hpp>
 
 #include<dune/common/fmatrix.hh>
 #include<dune/istl/bcrsmatrix.hh>
@@ -63,6 +64,8 @@ namespace Opm {
 
 #include <array>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -156,6 +159,10 @@ public:
                       const int num_cells,
                       const std::vector< Scalar >& B_avg);
 
+    /// Prepare an object of an earlier time step, for which canBeReused()
+    /// holds, for the time step, init() must be called afterwards.
+    void resetForTimeStep(const int time_step);
+
     virtual void initPrimaryVariablesEvaluation() const = 0;
 
     virtual ConvergenceReport getWellConvergence(const WellState& well_state, const std::vector<double>& B_avg, DeferredLogger& deferred_logger, const bool relax_tolerance = false) const = 0;
@@ -226,6 +233,10 @@ public:
     // Add well contributions to matrix
     virtual void addWellContributions(SparseMatrixAdapter&) const = 0;
 
+    // Add well contributions to the existing blocks of the matrix, the
+    // contributions outside of its sparsity pattern are dropped
+    virtual void addWellContributionsInPattern(typename SparseMatrixAdapter::IstlMatrix&) const = 0;
+
     void addCellRates(RateVector& rates, int cellIdx) const;
 
     Scalar volumetricSurfaceRateForConnection(int cellIdx, int phaseIdx) const;
@@ -281,6 +292,13 @@ public:
 
     virtual bool useInnerIterations() const = 0;
 
+    /// The arenas of the threads for the temporaries of the assembly, one per
+    /// OpenMP thread, owned by the well model.
+    void setScratchArenas(std::vector<ScratchArena>* arenas)
+    {
+        scratch_arenas_ = arenas;
+    }
+
 protected:
 
     // simulation parameters
@@ -292,6 +310,37 @@ protected:
 
     bool changed_to_stopped_this_step_ = false;
 
+    // the pressures of the perforated cells, the time step and the control of the
+    // last inner iterations, and whether they converged
+    std::vector<double> inner_iter_cell_pressures_;
+    double inner_iter_time_ = -1.0;
+    double inner_iter_dt_ = 0.0;
+    int inner_iter_control_ = -1;
+    bool inner_iter_converged_ = false;
+
+    std::vector<ScratchArena>* scratch_arenas_ = nullptr;
+
+    // the arena of the calling thread, the temporaries are taken from the heap
+    // if there is none
+    ScratchArena* scratchArena() const;
+
+    // whether the inner iterations converged before in this time step with the same
+    // control and the pressures of the perforated cells nearly unchanged, such that
+    // they can be skipped
+    bool innerIterationsConverged(const Simulator& ebosSimulator,
+                                  const double dt,
+                                  const WellState& well_state) const;
+
+    void storeInnerIterationState(const Simulator& ebosSimulator,
+                                  const double dt,
+                                  const WellState& well_state,
+                                  const bool converged);
+
+    // the control of the well in the well state, as an integer for comparisons
+    int currentControl(const WellState& well_state) const;
+
+    double perfCellPressure(const Simulator& ebosSimulator, const int perf) const;
+
     int flowPhaseToEbosCompIdx( const int phaseIdx ) const;
 
     int flowPhaseToEbosPhaseIdx( const int phaseIdx ) const;
@@ -304,6 +353,10 @@ protected:
 
     double wsalt() const;
 
+    // Prefetch the cached intensive quantities of the cell of a perforation,
+    // such that they are in the cache when the perforation is handled.
+    void prefetchPerforation(const Simulator& ebosSimulator, const int perf) const;
+
     template <class ValueType>
     ValueType calculateBhpFromThp(const WellState& well_state, const std::vector<ValueType>& rates, const Well& well, const SummaryState& summaryState, DeferredLogger& deferred_logger) const;
 
@@ -30,6 +30,7 @@
 #include <opm/simulators/wells/VFPProperties.hpp>
 #include <opm/simulators/wells/WellState.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
@@ -101,6 +102,53 @@ WellInterfaceGeneric::WellInterfaceGeneric(const Well& well,
     wsolvent_ = 0.0;
 }
 
+bool WellInterfaceGeneric::canBeReused(const Well& well,
+                                       const ParallelWellInfo& parallel_well_info,
+                                       const int first_perf_index,
+                                       const std::vector<PerforationData>& perf_data) const
+{
+    // The perforation data must still be the one referenced by perf_data_.
+    if (&perf_data != perf_data_ || &parallel_well_info != &parallel_well_info_ ||
+        first_perf_index != first_perf_ ||
+        static_cast<int>(perf_data.size()) != number_of_perforations_) {
+        return false;
+    }
+
+    for (int perf = 0; perf < number_of_perforations_; ++perf) {
+        if (perf_data[perf].cell_index != well_cells_[perf]) {
+            return false;
+        }
+    }
+
+    return well == well_ecl_;
+}
+
+void WellInterfaceGeneric::resetForTimeStep(const int time_step)
+{
+    current_step_ = time_step;
+
+    // closeCompletions() zeroes the well indices of closed completions
+    int perf = 0;
+    for (const auto& pd : *perf_data_) {
+        well_index_[perf] = pd.connection_transmissibility_factor;
+        saturation_table_number_[perf] = pd.satnum_id;
+        ++perf;
+    }
+
+    operability_status_.reset();
+    dynamic_thp_limit_.reset();
+    well_efficiency_factor_ = 1.0;
+    std::fill(ipr_a_.begin(), ipr_a_.end(), 0.0);
+    std::fill(ipr_b_.begin(), ipr_b_.end(), 0.0);
+
+    this->wellStatus_ = Well::Status::OPEN;
+    if (well_ecl_.getStatus() == Well::Status::STOP) {
+        this->wellStatus_ = Well::Status::STOP;
+    }
+
+    wsolvent_ = 0.0;
+}
+
 const std::string& WellInterfaceGeneric::name() const
 {
     return well_ecl_.name();
@@ -69,6 +69,13 @@ public:
     /// Well cells.
     const std::vector<int>& cells() const { return well_cells_; }
 
+    /// The coefficients b of the inflow performance relationship q = a - b * bhp
+    /// of a producer, by phase, as last updated.
+    const std::vector<double>& iprB() const { return ipr_b_; }
+
+    /// Information about the processes the well is distributed over.
+    const ParallelWellInfo& parallelWellInfo() const { return parallel_well_info_; }
+
     /// Index of well in the wells struct and wellState
     int indexOfWell() const;
 
@@ -107,7 +114,19 @@ public:
         return this->wellStatus_ == Well::Status::STOP;
     }
 
+    /// Whether the object can be used for the well with the given definition
+    /// and perforations instead of a new one, i.e. nothing it derived from
+    /// them at construction changed.
+    bool canBeReused(const Well& well,
+                     const ParallelWellInfo& parallel_well_info,
+                     const int first_perf_index,
+                     const std::vector<PerforationData>& perf_data) const;
+
 protected:
+    // Reset the state which changes during a time step to the one of a new
+    // object, for a reused well object.
+    void resetForTimeStep(const int time_step);
+
     // whether a well is specified with a non-zero and valid VFP table number
     bool isVFPActive(DeferredLogger& deferred_logger) const;
 
@@ -165,7 +184,7 @@ protected:
     Well well_ecl_;
 
     const ParallelWellInfo& parallel_well_info_;
-    const int current_step_;
+    int current_step_;
 
     // The pvt region of the well. We assume
     // We assume a well to not penetrate more than one pvt region.
@@ -23,6 +23,10 @@
 #include <opm/simulators/utils/DeferredLoggingErrorHelpers.hpp>
 #include <opm/simulators/wells/TargetCalculator.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Opm
 {
 
@@ -73,6 +77,26 @@ namespace Opm
     }
 
 
+    template<typename TypeTag>
+    void
+    WellInterface<TypeTag>::
+    resetForTimeStep(const int time_step)
+    {
+        WellInterfaceGeneric::resetForTimeStep(time_step);
+        changed_to_stopped_this_step_ = false;
+        inner_iter_converged_ = false;
+
+        if constexpr (has_solvent || has_zFraction) {
+            if (this->well_ecl_.isInjector()) {
+                auto injectorType = this->well_ecl_.injectorType();
+                if (injectorType == InjectorType::GAS) {
+                    this->wsolvent_ = this->well_ecl_.getSolventFraction();
+                }
+            }
+        }
+    }
+
+
     template<typename TypeTag>
     int
     WellInterface<TypeTag>::
@@ -195,6 +219,31 @@ namespace Opm
     }
 
 
+
+    template<typename TypeTag>
+    void
+    WellInterface<TypeTag>::
+    prefetchPerforation(const Simulator& ebosSimulator, const int perf) const
+    {
+#if defined(__GNUC__)
+        if (perf >= this->number_of_perforations_) {
+            return;
+        }
+        const auto* intQuants = ebosSimulator.model().cachedIntensiveQuantities(this->well_cells_[perf], /*timeIdx=*/0);
+        if (intQuants == nullptr) {
+            return;
+        }
+        const char* data = reinterpret_cast<const char*>(intQuants);
+        for (std::size_t offset = 0; offset < sizeof(IntensiveQuantities); offset += 64) {
+            __builtin_prefetch(data + offset);
+        }
+#else
+        static_cast<void>(ebosSimulator);
+        static_cast<void>(perf);
+#endif
+    }
+
+
     template<typename TypeTag>
     bool
     WellInterface<TypeTag>::
@@ -458,12 +507,17 @@ namespace Opm
         const WellState well_state0 = well_state;
         const double dt = ebosSimulator.timeStepSize();
         const bool converged = iterateWellEquations(ebosSimulator, dt, well_state, group_state, deferred_logger);
+        const bool debug = DeferredLogger::enabled(Log::MessageType::Debug);
         if (converged) {
-            deferred_logger.debug("Compute initial well solution for well " + this->name() +  ". Converged");
+            if (debug) {
+                deferred_logger.debug("Compute initial well solution for well " + this->name() +  ". Converged");
+            }
         } else {
-            const int max_iter = param_.max_welleq_iter_;
-            deferred_logger.debug("Compute initial well solution for well " + this->name() + ". Failed to converge in "
-                                  + std::to_string(max_iter) + " iterations");
+            if (debug) {
+                const int max_iter = param_.max_welleq_iter_;
+                deferred_logger.debug("Compute initial well solution for well " + this->name() + ". Failed to converge in "
+                                      + std::to_string(max_iter) + " iterations");
+            }
             well_state = well_state0;
         }
     }
@@ -482,8 +536,9 @@ namespace Opm
 
         checkWellOperability(ebosSimulator, well_state, deferred_logger);
 
-        if (this->useInnerIterations()) {
-            this->iterateWellEquations(ebosSimulator, dt, well_state, group_state, deferred_logger);
+        if (this->useInnerIterations() && !this->innerIterationsConverged(ebosSimulator, dt, well_state)) {
+            const bool converged = this->iterateWellEquations(ebosSimulator, dt, well_state, group_state, deferred_logger);
+            this->storeInnerIterationState(ebosSimulator, dt, well_state, converged);
         }
 
         const auto& summary_state = ebosSimulator.vanguard().summaryState();
@@ -494,6 +549,103 @@ namespace Opm
 
 
 
+    template <typename TypeTag>
+    bool
+    WellInterface<TypeTag>::
+    innerIterationsConverged(const Simulator& ebosSimulator,
+                             const double dt,
+                             const WellState& well_state) const
+    {
+        const double max_change = param_.inner_iter_skip_pressure_change_;
+        if (max_change <= 0.0 || !inner_iter_converged_
+            || inner_iter_time_ != ebosSimulator.time() || inner_iter_dt_ != dt
+            || inner_iter_control_ != this->currentControl(well_state)) {
+            return false;
+        }
+
+        for (int perf = 0; perf < this->number_of_perforations_; ++perf) {
+            if (std::abs(this->perfCellPressure(ebosSimulator, perf) - inner_iter_cell_pressures_[perf]) > max_change) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+
+    template <typename TypeTag>
+    void
+    WellInterface<TypeTag>::
+    storeInnerIterationState(const Simulator& ebosSimulator,
+                             const double dt,
+                             const WellState& well_state,
+                             const bool converged)
+    {
+        if (param_.inner_iter_skip_pressure_change_ <= 0.0) {
+            return;
+        }
+
+        inner_iter_converged_ = converged;
+        inner_iter_time_ = ebosSimulator.time();
+        inner_iter_dt_ = dt;
+        inner_iter_control_ = this->currentControl(well_state);
+        inner_iter_cell_pressures_.resize(this->number_of_perforations_);
+        for (int perf = 0; perf < this->number_of_perforations_; ++perf) {
+            inner_iter_cell_pressures_[perf] = this->perfCellPressure(ebosSimulator, perf);
+        }
+    }
+
+
+
+    template <typename TypeTag>
+    int
+    WellInterface<TypeTag>::
+    currentControl(const WellState& well_state) const
+    {
+        if (this->isInjector()) {
+            return static_cast<int>(well_state.currentInjectionControl(this->index_of_well_));
+        }
+        return static_cast<int>(well_state.currentProductionControl(this->index_of_well_));
+    }
+
+
+
+    template <typename TypeTag>
+    ScratchArena*
+    WellInterface<TypeTag>::
+    scratchArena() const
+    {
+        if (scratch_arenas_ == nullptr) {
+            return nullptr;
+        }
+#ifdef _OPENMP
+        const std::size_t thread = omp_get_thread_num();
+#else
+        const std::size_t thread = 0;
+#endif
+        return thread < scratch_arenas_->size() ? &(*scratch_arenas_)[thread] : nullptr;
+    }
+
+
+
+    template <typename TypeTag>
+    double
+    WellInterface<TypeTag>::
+    perfCellPressure(const Simulator& ebosSimulator, const int perf) const
+    {
+        const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(this->well_cells_[perf], /*timeIdx=*/0));
+        const auto& fs = intQuants.fluidState();
+        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+            return fs.pressure(FluidSystem::oilPhaseIdx).value();
+        }
+        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            return fs.pressure(FluidSystem::waterPhaseIdx).value();
+        }
+        return fs.pressure(FluidSystem::gasPhaseIdx).value();
+    }
+
+
+
     template<typename TypeTag>
     void
     WellInterface<TypeTag>::addCellRates(RateVector& rates, int cellIdx) const
@@ -24,14 +24,72 @@
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 #include <opm/simulators/wells/ParallelWellInfo.hpp>
+#include <opm/simulators/utils/MemoryReport.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <numeric>
 
 namespace Opm
 {
 
+void WellState::newLayout()
+{
+    static std::atomic<std::size_t> last_layout_id{0};
+    this->layout_id_ = ++last_layout_id;
+}
+
+void WellState::assignValues(const WellState& other)
+{
+    if (this->layout_id_ != other.layout_id_) {
+        *this = other;
+        return;
+    }
+
+    // The well map, the perforation data and parallel well info, the
+    // perforation and segment offsets and the phase usage are part of the
+    // layout and are left as they are.
+    this->global_well_info = other.global_well_info;
+    this->alq_state = other.alq_state;
+    this->do_glift_optimization_ = other.do_glift_optimization_;
+
+    this->status_.copy_values(other.status_);
+    this->bhp_.copy_values(other.bhp_);
+    this->thp_.copy_values(other.thp_);
+    this->temperature_.copy_values(other.temperature_);
+    this->wellrates_.copy_values(other.wellrates_);
+    this->perfrates_.copy_values(other.perfrates_);
+    this->perfpress_.copy_values(other.perfpress_);
+    this->perfphaserates_ = other.perfphaserates_;
+    this->current_injection_controls_.copy_values(other.current_injection_controls_);
+    this->current_production_controls_.copy_values(other.current_production_controls_);
+    this->well_rates = other.well_rates;
+
+    this->perfRateSolvent_ = other.perfRateSolvent_;
+    this->perfRatePolymer_ = other.perfRatePolymer_;
+    this->perfRateBrine_ = other.perfRateBrine_;
+    this->perf_water_throughput_ = other.perf_water_throughput_;
+    this->perf_skin_pressure_ = other.perf_skin_pressure_;
+    this->perf_water_velocity_ = other.perf_water_velocity_;
+
+    this->well_reservoir_rates_.copy_values(other.well_reservoir_rates_);
+    this->well_dissolved_gas_rates_.copy_values(other.well_dissolved_gas_rates_);
+    this->well_vaporized_oil_rates_.copy_values(other.well_vaporized_oil_rates_);
+    this->events_.copy_values(other.events_);
+
+    this->seg_rates_ = other.seg_rates_;
+    this->seg_press_ = other.seg_press_;
+    this->seg_pressdrop_ = other.seg_pressdrop_;
+    this->seg_pressdrop_friction_ = other.seg_pressdrop_friction_;
+    this->seg_pressdrop_hydorstatic_ = other.seg_pressdrop_hydorstatic_;
+    this->seg_pressdrop_acceleration_ = other.seg_pressdrop_acceleration_;
+
+    this->productivity_index_ = other.productivity_index_;
+    this->conn_productivity_index_ = other.conn_productivity_index_;
+    this->well_potentials_ = other.well_potentials_;
+}
+
 void WellState::base_init(const std::vector<double>& cellPressures,
                                                const std::vector<Well>& wells_ecl,
                                                const std::vector<ParallelWellInfo*>& parallel_well_info,
@@ -236,6 +294,7 @@ void WellState::init(const std::vector<double>& cellPressures,
     // call init on base class
     this->base_init(cellPressures, wells_ecl, parallel_well_info, well_perf_data, summary_state);
     this->global_well_info = std::make_optional<GlobalWellInfo>( schedule, report_step, wells_ecl );
+    this->newLayout();
     for (const auto& winfo: parallel_well_info)
     {
         well_rates.insert({winfo->name(), std::make_pair(winfo->isOwner(), std::vector<double>(this->numPhases()))});
@@ -596,7 +655,8 @@ void WellState::gatherVectorsOnRoot(const std::vector<data::Connection>& from_co
 
 data::Wells
 WellState::report(const int* globalCellIdxMap,
-                                       const std::function<bool(const int)>& wasDynamicallyClosed) const
+                                       const std::function<bool(const int)>& wasDynamicallyClosed,
+                                       const std::function<bool(const std::string&)>& reportDetails) const
 {
     if (this->numWells() == 0)
         return {};
@@ -635,7 +695,11 @@ WellState::report(const int* globalCellIdxMap,
             well.rates.set( rt::gas, wv[ pu.phase_pos[BlackoilPhases::Vapour] ] );
         }
 
-        if (pwinfo.communication().size()==1)
+        if (reportDetails && !reportDetails(itr.first))
+        {
+            // connection results are not requested for this well
+        }
+        else if (pwinfo.communication().size()==1)
         {
             reportConnections(well, pu, itr, globalCellIdxMap);
         }
@@ -733,6 +797,10 @@ WellState::report(const int* globalCellIdxMap,
             curr.inj  = this->currentInjectionControl(w);
         }
 
+        if (reportDetails && !reportDetails(wt.first)) {
+            continue;
+        }
+
         const auto nseg = this->numSegments(w);
         for (auto seg_ix = 0*nseg; seg_ix < nseg; ++seg_ix) {
             const auto seg_no = this->segmentNumber(w, seg_ix);
@@ -825,6 +893,7 @@ void WellState::initWellStateMSWell(const std::vector<Well>& wells_ecl,
     const auto& pu = this->phaseUsage();
     const int np = pu.num_phases;
 
+    this->newLayout();
     top_segment_index_.clear();
     seg_press_.clear();
     seg_rates_.clear();
@@ -1050,6 +1119,33 @@ void WellState::stopWell(int well_index)
     this->thp_[well_index] = 0;
 }
 
+std::size_t WellState::memoryUsage() const
+{
+    auto nested = [](const WellContainer<std::vector<double>>& container)
+    {
+        std::size_t bytes = container.size() * sizeof(std::vector<double>);
+        for (const auto& values : container)
+            bytes += values.capacity() * sizeof(double);
+        return bytes;
+    };
+    std::size_t bytes = nested(this->wellrates_) + nested(this->perfrates_)
+        + nested(this->perfpress_) + nested(this->well_reservoir_rates_);
+    for (const auto& perfData : this->well_perf_data_)
+        bytes += perfData.capacity() * sizeof(PerforationData);
+    for (const auto* values : { &this->perfphaserates_, &this->perfRateSolvent_, &this->perfRatePolymer_,
+                                &this->perfRateBrine_, &this->perf_water_throughput_, &this->perf_skin_pressure_,
+                                &this->perf_water_velocity_, &this->seg_rates_, &this->seg_press_,
+                                &this->seg_pressdrop_, &this->seg_pressdrop_friction_,
+                                &this->seg_pressdrop_hydorstatic_, &this->seg_pressdrop_acceleration_,
+                                &this->productivity_index_, &this->conn_productivity_index_,
+                                &this->well_potentials_ })
+        bytes += Opm::memoryUsage(*values);
+    for (const auto* indices : { &this->first_perf_index_, &this->num_perf_,
+                                 &this->top_segment_index_, &this->seg_number_ })
+        bytes += Opm::memoryUsage(*indices);
+    return bytes;
+}
+
 void WellState::shutWell(int well_index)
 {
     this->status_[well_index] = Well::Status::SHUT;
@@ -66,6 +66,12 @@ public:
         this->phase_usage_ = pu;
     }
 
+    /// Copy the state of other into this state. If both states have the
+    /// same layout of wells, perforations and segments, e.g. because one is
+    /// a copy of the other and none of them has been reinitialized since, only
+    /// the values are copied into the existing storage.
+    void assignValues(const WellState& other);
+
     const WellMapType& wellMap() const { return wellMap_; }
     WellMapType& wellMap() { return wellMap_; }
 
@@ -125,9 +131,12 @@ public:
                              std::vector< data::Connection >& to_connections,
                              const Communication& comm) const;
 
+    /// The connection and segment results are only reported for the wells
+    /// accepted by reportDetails, or for all wells if it is empty.
     data::Wells
     report(const int* globalCellIdxMap,
-           const std::function<bool(const int)>& wasDynamicallyClosed) const;
+           const std::function<bool(const int)>& wasDynamicallyClosed,
+           const std::function<bool(const std::string&)>& reportDetails = {}) const;
 
     void reportConnections(data::Well& well, const PhaseUsage &pu,
                            const WellMapType::value_type& wt,
@@ -360,6 +369,12 @@ public:
         this->alq_state.update_count(name, increase);
     }
 
+    /// Prepare the ALQ state of the well for being optimized concurrently
+    /// with other wells.
+    void gliftPrepareConcurrentUpdate(const std::string &name) {
+        this->alq_state.insert_count(name);
+    }
+
     bool gliftOptimizationEnabled() const {
         return do_glift_optimization_;
     }
@@ -411,6 +426,10 @@ public:
     void shutWell(int well_index);
     void stopWell(int well_index);
 
+    /// The bytes of the per well, perforation and segment values, without
+    /// the well names and the maps.
+    std::size_t memoryUsage() const;
+
     /// The number of phases present.
     int numPhases() const
     {
@@ -559,6 +578,11 @@ private:
     /// \end
     std::vector<int> seg_number_;
 
+    // Identifies the layout of wells, perforations and segments, changed
+    // whenever the state is reinitialized and shared by copies.
+    std::size_t layout_id_ = 0;
+    void newLayout();
+
     data::Segment
     reportSegmentResults(const PhaseUsage& pu,
                          const int         well_id,
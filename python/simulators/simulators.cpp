@@ -22,6 +22,9 @@
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 #include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
+#if HAVE_MPI
+#include <opm/simulators/utils/ParallelEclipseState.hpp>
+#endif
 #define FLOW_BLACKOIL_ONLY
 #include <opm/simulators/flow/Main.hpp>
 #include <opm/simulators/flow/FlowMainEbos.hpp>
@@ -29,9 +32,11 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 #include <pybind11/embed.h>
+#include <pybind11/stl.h>
 // NOTE: EXIT_SUCCESS, EXIT_FAILURE is defined in cstdlib
 #include <cstdlib>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <opm/simulators/flow/python/simulators.hpp>
 
@@ -43,6 +48,35 @@ BlackOilSimulator::BlackOilSimulator( const std::string &deckFilename)
 {
 }
 
+std::unique_ptr<BlackOilSimulator>
+BlackOilSimulator::fromBaseCase(const BlackOilSimulator& base)
+{
+    if (!base.hasRunInit_) {
+        throw std::logic_error("from_base_case() called with a base case before its step_init()");
+    }
+    if (base.hasRunStep_) {
+        throw std::logic_error("from_base_case() called with a base case after its step()");
+    }
+    const auto& vanguard = base.ebosSimulator_->vanguard();
+    auto sim = std::make_unique<BlackOilSimulator>(base.deckFilename_);
+    sim->deck_ = std::make_unique<Opm::Deck>(vanguard.deck());
+    // The eclipse state of the base has been processed together with its
+    // grid, so build a fresh one from the deck, which is cheap compared
+    // to reading and parsing the deck.
+#if HAVE_MPI
+    if (vanguard.grid().comm().rank() == 0) {
+        sim->eclipseState_ = std::make_unique<Opm::ParallelEclipseState>(*sim->deck_);
+    } else {
+        sim->eclipseState_ = std::make_unique<Opm::ParallelEclipseState>();
+    }
+#else
+    sim->eclipseState_ = std::make_unique<Opm::EclipseState>(*sim->deck_);
+#endif
+    sim->schedule_ = std::make_unique<Opm::Schedule>(vanguard.schedule());
+    sim->summaryConfig_ = std::make_unique<Opm::SummaryConfig>(vanguard.summaryConfig());
+    return sim;
+}
+
 py::array_t<double> BlackOilSimulator::getPorosity()
 {
     std::size_t len;
@@ -50,6 +84,46 @@ py::array_t<double> BlackOilSimulator::getPorosity()
     return py::array(len, array.get());
 }
 
+py::array_t<double> BlackOilSimulator::getStateView(StateVariable var)
+{
+    const auto buffer = materialState().getStateBuffer(var);
+    return makeView_(buffer, {static_cast<py::ssize_t>(buffer->size())});
+}
+
+py::array_t<double> BlackOilSimulator::getWellRatesView()
+{
+    auto& state = materialState();
+    const auto buffer = state.getWellRatesBuffer();
+    const py::ssize_t np = state.numPhases();
+    return makeView_(buffer, {static_cast<py::ssize_t>(buffer->size()) / np, np});
+}
+
+std::vector<std::string> BlackOilSimulator::getWellNames()
+{
+    return materialState().getWellNames();
+}
+
+PyMaterialState<BlackOilSimulator::TypeTag>& BlackOilSimulator::materialState()
+{
+    if (!materialState_) {
+        throw std::logic_error("simulator state accessed before step_init()");
+    }
+    return *materialState_;
+}
+
+py::array_t<double> BlackOilSimulator::makeView_(const PyMaterialState<TypeTag>::Buffer& buffer,
+                                                 std::vector<py::ssize_t> shape)
+{
+    // The capsule shares the ownership of the buffer, so the view stays
+    // valid even if the simulator replaces the buffer or is destroyed.
+    using Buffer = PyMaterialState<TypeTag>::Buffer;
+    py::capsule base(new Buffer(buffer), [](void *ptr) { delete static_cast<Buffer*>(ptr); });
+    py::array_t<double> view(shape, buffer->data(), base);
+    // writing to the view would not change the simulator state
+    py::detail::array_proxy(view.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    return view;
+}
+
 int BlackOilSimulator::run()
 {
     auto mainObject = Opm::Main( deckFilename_ );
@@ -64,7 +138,71 @@ void BlackOilSimulator::setPorosity( py::array_t<double,
     materialState_->setPorosity(poro, size_);
 }
 
+void BlackOilSimulator::setPermeability(
+    py::array_t<double, py::array::c_style | py::array::forcecast> permx,
+    py::array_t<double, py::array::c_style | py::array::forcecast> permy,
+    py::array_t<double, py::array::c_style | py::array::forcecast> permz)
+{
+    if (permy.size() != permx.size() || permz.size() != permx.size()) {
+        throw std::runtime_error("Cannot set permeability. The arrays have different sizes");
+    }
+    materialState().setPermeability(permx.data(), permy.data(), permz.data(), permx.size());
+}
+
+void BlackOilSimulator::setTransmissibilityMultipliers(
+    py::array_t<double, py::array::c_style | py::array::forcecast> multx,
+    py::array_t<double, py::array::c_style | py::array::forcecast> multy,
+    py::array_t<double, py::array::c_style | py::array::forcecast> multz)
+{
+    if (multy.size() != multx.size() || multz.size() != multx.size()) {
+        throw std::runtime_error("Cannot set transmissibility multipliers. The arrays have different sizes");
+    }
+    materialState().setTransmissibilityMultipliers(multx.data(), multy.data(), multz.data(), multx.size());
+}
+
+void BlackOilSimulator::setConnectionMultipliers(const std::string& wellName,
+                                                 const std::vector<double>& multipliers)
+{
+    if (!ebosSimulator_) {
+        throw std::logic_error("set_connection_multipliers() called before step_init()");
+    }
+    ebosSimulator_->problem().wellModel().setConnectionMultipliers(wellName, multipliers);
+}
+
 int BlackOilSimulator::step()
+{
+    checkCanStep_();
+    // Python actions of the schedule need the interpreter during the step.
+    std::optional<py::gil_scoped_release> release;
+    if (!usesPython_) {
+        release.emplace();
+    }
+    return advance_();
+}
+
+std::vector<int> BlackOilSimulator::stepAll(const std::vector<BlackOilSimulator*>& simulators)
+{
+    bool usesPython = false;
+    for (const auto* sim : simulators) {
+        sim->checkCanStep_();
+        usesPython = usesPython || sim->usesPython_;
+    }
+    std::vector<int> results;
+    results.reserve(simulators.size());
+    std::optional<py::gil_scoped_release> release;
+    if (!usesPython) {
+        release.emplace();
+    }
+    // The simulators share process wide state like the parameter system,
+    // the log backends and the OpenMP thread manager, so they are advanced
+    // one after the other. Each one uses its OpenMP threads during its step.
+    for (auto* sim : simulators) {
+        results.push_back(sim->advance_());
+    }
+    return results;
+}
+
+void BlackOilSimulator::checkCanStep_() const
 {
     if (!hasRunInit_) {
         throw std::logic_error("step() called before step_init()");
@@ -72,7 +210,14 @@ int BlackOilSimulator::step()
     if (hasRunCleanup_) {
         throw std::logic_error("step() called after step_cleanup()");
     }
-    return mainEbos_->executeStep();
+}
+
+int BlackOilSimulator::advance_()
+{
+    hasRunStep_ = true;
+    const int result = mainEbos_->executeStep();
+    materialState_->updateBuffers();
+    return result;
 }
 
 int BlackOilSimulator::stepCleanup()
@@ -93,13 +238,23 @@ int BlackOilSimulator::stepInit()
             return EXIT_SUCCESS;
         }
     }
-    main_ = std::make_unique<Opm::Main>( deckFilename_ );
+    if (deck_) {
+        main_ = std::make_unique<Opm::Main>( deckFilename_,
+                                             std::move(deck_),
+                                             std::move(eclipseState_),
+                                             std::move(schedule_),
+                                             std::move(summaryConfig_) );
+    }
+    else {
+        main_ = std::make_unique<Opm::Main>( deckFilename_ );
+    }
     int exitCode = EXIT_SUCCESS;
     mainEbos_ = main_->initFlowEbosBlackoil(exitCode);
     if (mainEbos_) {
         int result = mainEbos_->executeInitStep();
         hasRunInit_ = true;
         ebosSimulator_ = mainEbos_->getSimulatorPtr();
+        usesPython_ = ebosSimulator_->vanguard().deck().hasKeyword("PYACTION");
         materialState_ = std::make_unique<PyMaterialState<TypeTag>>(
             ebosSimulator_);
         return result;
@@ -116,11 +271,32 @@ PYBIND11_MODULE(simulators, m)
     using namespace Opm::Pybind;
     py::class_<BlackOilSimulator>(m, "BlackOilSimulator")
         .def(py::init< const std::string& >())
+        .def_static("from_base_case", &BlackOilSimulator::fromBaseCase)
         .def("get_porosity", &BlackOilSimulator::getPorosity,
             py::return_value_policy::copy)
+        .def("get_pressure", [](BlackOilSimulator& sim)
+            { return sim.getStateView(StateVariable::Pressure); })
+        .def("get_water_saturation", [](BlackOilSimulator& sim)
+            { return sim.getStateView(StateVariable::WaterSaturation); })
+        .def("get_oil_saturation", [](BlackOilSimulator& sim)
+            { return sim.getStateView(StateVariable::OilSaturation); })
+        .def("get_gas_saturation", [](BlackOilSimulator& sim)
+            { return sim.getStateView(StateVariable::GasSaturation); })
+        .def("get_rs", [](BlackOilSimulator& sim)
+            { return sim.getStateView(StateVariable::Rs); })
+        .def("get_rv", [](BlackOilSimulator& sim)
+            { return sim.getStateView(StateVariable::Rv); })
+        .def("get_cell_volumes", [](BlackOilSimulator& sim)
+            { return sim.getStateView(StateVariable::CellVolume); })
+        .def("get_well_rates", &BlackOilSimulator::getWellRatesView)
+        .def("get_well_names", &BlackOilSimulator::getWellNames)
         .def("run", &BlackOilSimulator::run)
         .def("set_porosity", &BlackOilSimulator::setPorosity)
+        .def("set_permeability", &BlackOilSimulator::setPermeability)
+        .def("set_transmissibility_multipliers", &BlackOilSimulator::setTransmissibilityMultipliers)
+        .def("set_connection_multipliers", &BlackOilSimulator::setConnectionMultipliers)
         .def("step", &BlackOilSimulator::step)
+        .def_static("step_all", &BlackOilSimulator::stepAll)
         .def("step_init", &BlackOilSimulator::stepInit)
         .def("step_cleanup", &BlackOilSimulator::stepCleanup);
 }
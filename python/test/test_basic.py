@@ -64,12 +64,23 @@ class TestBasic(unittest.TestCase):
             sim.step_init()
             sim.step()
 
+            pressure = sim.get_pressure()
+            self.assertEqual(len(pressure), 300, 'length of pressure vector')
+            self.assertFalse(pressure.flags.writeable, 'pressure view is read-only')
+            pressure_step1 = pressure.copy()
+            self.assertEqual(len(sim.get_gas_saturation()), 300, 'length of saturation vector')
+            self.assertEqual(len(sim.get_cell_volumes()), 300, 'length of cell volumes')
+            rates = sim.get_well_rates()
+            self.assertEqual(rates.shape[0], len(sim.get_well_names()), 'one row of rates per well')
+
             poro = sim.get_porosity()
             self.assertEqual(len(poro), 300, 'length of porosity vector')
             self.assertAlmostEqual(poro[0], 0.3, places=7, msg='value of porosity')
             poro = poro *.95
             sim.set_porosity(poro)
             sim.step()
+            self.assertNotAlmostEqual(pressure[0], pressure_step1[0], places=3,
+                                      msg='pressure view updated by step')
             poro2 = sim.get_porosity()
             self.assertAlmostEqual(poro2[0], 0.285, places=7, msg='value of porosity 2')
 
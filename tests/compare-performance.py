@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+
+# Compares the timings of the regression tests collected with
+# OPM_PERFORMANCE_DIR=<dir> ctest -L ... between a baseline and a new run.
+# A case regresses if a time grows by more than the tolerance, or if the
+# iteration counts or the peak memory grow by more than the tolerance.
+# Times below the minimum are not compared, they are mostly noise.
+#
+# Usage: compare-performance.py [-t TOL] [-m MIN_TIME] BASELINE_DIR NEW_DIR
+#
+# Exits with 1 if any case regressed.
+
+import argparse
+import json
+import os
+import sys
+
+TIMES = ["total_time", "solver_time", "assemble_time", "linear_solve_setup_time",
+         "linear_solve_time", "update_time", "output_write_time"]
+COUNTS = ["newton_iterations", "linear_iterations", "time_step_chops"]
+
+
+def load(directory):
+    results = {}
+    for name in sorted(os.listdir(directory)):
+        if name.endswith(".json"):
+            with open(os.path.join(directory, name)) as f:
+                results[name[:-len(".json")]] = json.load(f)
+    return results
+
+
+def values(result):
+    success = result["report"]["success"]
+    failure = result["report"]["failure"]
+    v = {key: success[key] + failure[key] for key in TIMES + COUNTS}
+    v["wasted_time"] = failure["total_time"]
+    v["peak_rss_kib"] = result.get("peak_rss_kib", 0)
+    return v
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flag performance regressions of the regression tests")
+    parser.add_argument("baseline", help="directory with the timings of the baseline")
+    parser.add_argument("new", help="directory with the timings to check")
+    parser.add_argument("-t", "--tolerance", type=float, default=0.1,
+                        help="allowed relative growth (default 0.1)")
+    parser.add_argument("-m", "--min-time", type=float, default=1.0,
+                        help="times below this in both runs are not compared (default 1 s)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    new = load(args.new)
+    regressions = 0
+    print("{:<40} {:<24} {:>12} {:>12} {:>8}".format("case", "quantity", "baseline", "new", "change"))
+    for case in sorted(set(baseline) & set(new)):
+        old_values = values(baseline[case])
+        new_values = values(new[case])
+        for key in TIMES + ["wasted_time"] + COUNTS + ["peak_rss_kib"]:
+            old, cur = old_values[key], new_values[key]
+            if key in TIMES + ["wasted_time"] and max(old, cur) < args.min_time:
+                continue
+            if old == 0:
+                change = 0.0 if cur == 0 else float("inf")
+            else:
+                change = (cur - old) / old
+            flag = change > args.tolerance
+            if flag or abs(change) > args.tolerance:
+                print("{:<40} {:<24} {:>12.6g} {:>12.6g} {:>+7.1%}{}".format(
+                    case, key, old, cur, change, "  REGRESSION" if flag else ""))
+            regressions += flag
+
+    for case in sorted(set(baseline) - set(new)):
+        print("{}: missing in {}".format(case, args.new))
+    for case in sorted(set(new) - set(baseline)):
+        print("{}: no baseline".format(case))
+
+    print("{} cases compared, {} regressions".format(len(set(baseline) & set(new)), regressions))
+    return 1 if regressions > 0 else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -14,12 +14,25 @@ EXE_NAME="${8}"
 shift 8
 TEST_ARGS="$@"
 
+# If OPM_PERFORMANCE_DIR is set, the timings of the run are collected there
+# as <simulator>+<case>.json for tests/compare-performance.py.
+if test -n "${OPM_PERFORMANCE_DIR}"
+then
+  TEST_ARGS="${TEST_ARGS} --output-timing-json=true"
+fi
+
 mkdir -p ${RESULT_PATH}
 cd ${RESULT_PATH}
 ${BINPATH}/${EXE_NAME} ${TEST_ARGS} --output-dir=${RESULT_PATH}
 test $? -eq 0 || exit 1
 cd ..
 
+if test -n "${OPM_PERFORMANCE_DIR}"
+then
+  mkdir -p ${OPM_PERFORMANCE_DIR}
+  cp ${RESULT_PATH}/${FILENAME}.TIMING.json ${OPM_PERFORMANCE_DIR}/${EXE_NAME}+${FILENAME}.json
+fi
+
 
 ecode=0
 
@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+
+# Strong and weak scaling of flow over a sweep of MPI ranks and threads.
+# Every deck is run for each combination of ranks and threads with
+# --output-timing-json=true. The phase timings of the runs and the parallel
+# efficiency of each phase relative to the smallest combination are written
+# to <output-dir>/scaling.json and printed as a table.
+#
+# Strong scaling runs the same deck everywhere, the efficiency of a phase is
+# t_base * n_base / (t * n) with n the ranks times the threads. Weak scaling
+# needs a synthetic deck, whose grid and well pattern are repeated in the x
+# direction n / n_base times, the efficiency is t_base / t.
+#
+# The synthetic deck is an oil-water model of NX x NY x NZ cells with a five
+# spot pattern of producers and water injectors. --refine R divides the cells
+# of the same reservoir into R x R cells in the areal directions, such that a
+# finer grid can be benchmarked with the same wells.
+#
+# With --baseline, the efficiencies are compared with the scaling.json of an
+# earlier run, and a phase regresses if its efficiency dropped by more than
+# the tolerance.
+#
+# Usage: scaling-benchmark.py --flow FLOW [--ranks 1,2,4] [--threads 1,2]
+#            [--mode strong|weak] [--synthetic NX,NY,NZ] [--refine R]
+#            [--baseline SCALING_JSON] [-o OUTPUT_DIR] [DECK ...]
+#
+# Exits with 1 if a run failed or any phase regressed.
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+# phases of the report of a run, as sums of the entries of SimulatorReportSingle
+PHASES = {
+    "total": ["total_time"],
+    "assembly": ["assemble_time", "-assemble_time_well"],
+    "wells": ["assemble_time_well"],
+    "linear_setup": ["linear_solve_setup_time"],
+    "linear_solve": ["linear_solve_time"],
+    "update": ["update_time"],
+    "output": ["output_write_time"],
+}
+
+
+def parse_list(text):
+    return [int(v) for v in text.split(",") if v]
+
+
+def write_synthetic_deck(path, nx, ny, nz, refine, repeat, steps, spacing):
+    """An oil-water deck with a five spot well pattern, repeated in the x direction."""
+    nx_total = nx * refine * repeat
+    ny_total = ny * refine
+    size = nx_total * ny_total * nz
+    dx = 100.0 / refine
+    dz = 5.0
+    cell = spacing * refine
+
+    producers = []
+    injectors = []
+    for i in range(cell // 2, nx_total, cell):
+        for j in range(cell // 2, ny_total, cell):
+            producers.append((i + 1, j + 1))
+    for i in range(0, nx_total, cell):
+        for j in range(0, ny_total, cell):
+            injectors.append((i + 1, j + 1))
+    wells = [("P{}".format(n + 1), ij, "OIL") for n, ij in enumerate(producers)]
+    wells += [("I{}".format(n + 1), ij, "WATER") for n, ij in enumerate(injectors)]
+
+    lines = []
+    add = lines.append
+    add("-- synthetic deck of tests/scaling-benchmark.py")
+    add("RUNSPEC")
+    add("TITLE\n  SCALING {} x {} x {}\n".format(nx_total, ny_total, nz))
+    add("DIMENS\n  {} {} {} /\n".format(nx_total, ny_total, nz))
+    add("OIL\nWATER\nMETRIC\n")
+    add("TABDIMS\n  1 1 20 20 /\n")
+    add("EQLDIMS\n  1 /\n")
+    add("WELLDIMS\n  {} {} 2 {} /\n".format(len(wells), nz, len(wells)))
+    add("START\n  1 'JAN' 2020 /\n")
+    add("UNIFOUT\n")
+
+    add("GRID")
+    add("DX\n  {}*{} /".format(size, dx))
+    add("DY\n  {}*{} /".format(size, dx))
+    add("DZ\n  {}*{} /".format(size, dz))
+    add("TOPS\n  {}*2000 /".format(nx_total * ny_total))
+    add("PORO\n  {}*0.2 /".format(size))
+    add("PERMX\n  {}*100 /".format(size))
+    add("PERMY\n  {}*100 /".format(size))
+    add("PERMZ\n  {}*10 /\n".format(size))
+
+    add("PROPS")
+    add("PVTW\n  250 1.0 4e-5 0.5 0 /")
+    add("PVDO\n  100 1.05 2.0\n  200 1.03 2.2\n  300 1.01 2.4 /")
+    add("ROCK\n  250 4e-5 /")
+    add("DENSITY\n  850 1000 1 /")
+    add("SWOF\n  0.2 0.0 1.0 0\n  0.4 0.1 0.5 0\n  0.6 0.3 0.2 0\n  0.8 0.6 0.0 0\n  1.0 1.0 0.0 0 /\n")
+
+    add("SOLUTION")
+    add("EQUIL\n  2000 250 {} 0 1000 0 /\n".format(2000 + 2 * nz * dz))
+
+    add("SUMMARY")
+    add("FOPR\nFWIR\nFPR\n")
+
+    add("SCHEDULE")
+    add("WELSPECS")
+    for name, (i, j), phase in wells:
+        add("  '{}' 'G1' {} {} 1* '{}' /".format(name, i, j, phase))
+    add("/")
+    add("COMPDAT")
+    for name, (i, j), _ in wells:
+        add("  '{}' {} {} 1 {} 'OPEN' 1* 1* 0.2 /".format(name, i, j, nz))
+    add("/")
+    add("WCONPROD\n  'P*' 'OPEN' 'BHP' 5* 150 /\n/")
+    # the same rate per pattern pore volume for any refinement
+    rate = (spacing * 100.0) ** 2 * nz * dz * 0.2 / 3000.0
+    add("WCONINJE\n  'I*' 'WATER' 'OPEN' 'RATE' {} 1* 400 /\n/".format(rate))
+    add("TSTEP\n  {}*30 /\n".format(steps))
+    add("END")
+
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def run_flow(args, deck, case, ranks, threads, directory):
+    os.makedirs(directory, exist_ok=True)
+    command = []
+    if ranks > 1:
+        command += args.mpirun.split() + ["-np", str(ranks)]
+    command += [args.flow, deck, "--output-dir=" + directory, "--output-timing-json=true",
+                "--threads-per-process={}".format(threads)]
+    command += args.flow_args.split()
+    env = dict(os.environ, OMP_NUM_THREADS=str(threads))
+    with open(os.path.join(directory, "flow.log"), "w") as log:
+        status = subprocess.call(command, stdout=log, stderr=subprocess.STDOUT, env=env)
+    if status != 0:
+        print("{} with {} ranks and {} threads failed, see {}".format(
+            case, ranks, threads, os.path.join(directory, "flow.log")))
+        return None
+    with open(os.path.join(directory, case + ".TIMING.json")) as f:
+        result = json.load(f)
+    report = result["report"]
+    phases = {}
+    for phase, entries in PHASES.items():
+        value = 0.0
+        for entry in entries:
+            sign = -1.0 if entry.startswith("-") else 1.0
+            key = entry.lstrip("-")
+            value += sign * (report["success"][key] + report["failure"][key])
+        phases[phase] = max(value, 0.0)
+    return {"ranks": ranks, "threads": threads, "phases": phases,
+            "newton_iterations": report["success"]["newton_iterations"] + report["failure"]["newton_iterations"],
+            "linear_iterations": report["success"]["linear_iterations"] + report["failure"]["linear_iterations"]}
+
+
+def efficiencies(runs, mode, min_time):
+    """The parallel efficiency of each phase of the runs relative to the first one."""
+    base = runs[0]
+    base_units = base["ranks"] * base["threads"]
+    for run in runs:
+        units = run["ranks"] * run["threads"]
+        run["efficiency"] = {}
+        for phase, time in run["phases"].items():
+            base_time = base["phases"][phase]
+            if base_time < min_time or time <= 0.0:
+                continue
+            if mode == "strong":
+                run["efficiency"][phase] = base_time * base_units / (time * units)
+            else:
+                run["efficiency"][phase] = base_time / time
+
+
+def print_table(case, runs):
+    print("\n{}".format(case))
+    print("{:>6} {:>8} ".format("ranks", "threads")
+          + " ".join("{:>18}".format(phase) for phase in PHASES))
+    for run in runs:
+        cells = []
+        for phase in PHASES:
+            time = run["phases"][phase]
+            eff = run["efficiency"].get(phase)
+            cells.append("{:>9.3g}s {:>6}".format(time, "" if eff is None else "{:.0%}".format(eff)))
+        print("{:>6} {:>8} ".format(run["ranks"], run["threads"]) + " ".join("{:>18}".format(c) for c in cells))
+
+
+def compare(baseline, results, tolerance):
+    regressions = 0
+    for case, runs in results.items():
+        old_runs = {(r["ranks"], r["threads"]): r for r in baseline.get(case, [])}
+        for run in runs:
+            old = old_runs.get((run["ranks"], run["threads"]))
+            if old is None:
+                continue
+            for phase, eff in run["efficiency"].items():
+                old_eff = old.get("efficiency", {}).get(phase)
+                if old_eff is None:
+                    continue
+                if old_eff - eff > tolerance:
+                    print("{} {} ranks {} threads {}: efficiency {:.0%} -> {:.0%}  REGRESSION".format(
+                        case, run["ranks"], run["threads"], phase, old_eff, eff))
+                    regressions += 1
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Strong and weak scaling benchmark of flow")
+    parser.add_argument("decks", nargs="*", help="decks to run, in addition to the synthetic one")
+    parser.add_argument("--flow", required=True, help="the flow executable")
+    parser.add_argument("--mpirun", default="mpirun", help="the MPI launcher (default mpirun)")
+    parser.add_argument("--flow-args", default="", help="further arguments of flow")
+    parser.add_argument("--ranks", default="1,2,4", help="comma separated MPI ranks (default 1,2,4)")
+    parser.add_argument("--threads", default="1", help="comma separated threads per rank (default 1)")
+    parser.add_argument("--mode", choices=["strong", "weak"], default="strong")
+    parser.add_argument("--synthetic", help="add a synthetic deck of NX,NY,NZ cells")
+    parser.add_argument("--refine", type=int, default=1, help="areal refinement of the synthetic deck")
+    parser.add_argument("--well-spacing", type=int, default=10,
+                        help="cells between the producers of the synthetic deck before refinement")
+    parser.add_argument("--steps", type=int, default=10, help="report steps of the synthetic deck")
+    parser.add_argument("--baseline", help="scaling.json of an earlier run to compare with")
+    parser.add_argument("-t", "--tolerance", type=float, default=0.1,
+                        help="allowed drop of the efficiency of a phase (default 0.1)")
+    parser.add_argument("-m", "--min-time", type=float, default=1.0,
+                        help="phases below this time in the base run are not compared (default 1 s)")
+    parser.add_argument("-o", "--output-dir", default="scaling-benchmark")
+    args = parser.parse_args()
+
+    if args.mode == "weak" and (args.decks or not args.synthetic):
+        parser.error("weak scaling needs the synthetic deck only")
+    if not args.decks and not args.synthetic:
+        parser.error("no decks given")
+
+    combinations = sorted(((r, t) for r in parse_list(args.ranks) for t in parse_list(args.threads)),
+                          key=lambda c: (c[0] * c[1], c[0]))
+    base_units = combinations[0][0] * combinations[0][1]
+    output_dir = os.path.abspath(args.output_dir)
+    os.makedirs(output_dir, exist_ok=True)
+
+    failures = 0
+    results = {}
+    cases = [(os.path.splitext(os.path.basename(d))[0], os.path.abspath(d)) for d in args.decks]
+    if args.synthetic:
+        cases.append(("SCALING", None))
+    for case, deck in cases:
+        runs = []
+        for ranks, threads in combinations:
+            directory = os.path.join(output_dir, case, "r{}t{}".format(ranks, threads))
+            if deck is None:
+                nx, ny, nz = parse_list(args.synthetic)
+                repeat = ranks * threads // base_units if args.mode == "weak" else 1
+                os.makedirs(directory, exist_ok=True)
+                run_deck = os.path.join(directory, case + ".DATA")
+                write_synthetic_deck(run_deck, nx, ny, nz, args.refine, max(repeat, 1),
+                                     args.steps, args.well_spacing)
+            else:
+                run_deck = deck
+            run = run_flow(args, run_deck, case, ranks, threads, directory)
+            if run is None:
+                failures += 1
+            else:
+                runs.append(run)
+        if runs:
+            efficiencies(runs, args.mode, args.min_time)
+            print_table(case, runs)
+            results[case] = runs
+
+    with open(os.path.join(output_dir, "scaling.json"), "w") as f:
+        json.dump({"mode": args.mode, "cases": results}, f, indent=2)
+
+    regressions = 0
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = compare(baseline["cases"], results, args.tolerance)
+        print("{} regressions".format(regressions))
+    return 1 if failures > 0 or regressions > 0 else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
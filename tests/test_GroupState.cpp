@@ -82,3 +82,24 @@ BOOST_AUTO_TEST_CASE(GroupStateDump) {
     auto json_string = gs.dump();
     Json::JsonObject json_gs(json_string);
 }
+
+
+BOOST_AUTO_TEST_CASE(GroupStateOrder) {
+    std::size_t num_phases{3};
+    GroupState gs1(num_phases);
+    GroupState gs2(num_phases);
+    std::vector<double> rates1{0,1,2};
+    std::vector<double> rates2{3,4,5};
+
+    gs1.update_production_rates("AGROUP", rates1);
+    gs1.update_production_rates("BGROUP", rates2);
+    gs1.update_injection_vrep_rate("BGROUP", 1);
+
+    gs2.update_injection_vrep_rate("BGROUP", 1);
+    gs2.update_production_rates("BGROUP", rates2);
+    BOOST_CHECK(!(gs1 == gs2));
+    gs2.update_production_rates("AGROUP", rates1);
+
+    BOOST_CHECK(gs1 == gs2);
+    BOOST_CHECK_EQUAL(gs1.dump(), gs2.dump());
+}
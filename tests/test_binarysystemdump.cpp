@@ -0,0 +1,159 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE BinarySystemDumpTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/linalg/BinarySystemDump.hpp>
+
+#include <opm/common/utility/FileSystem.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int bz = 3;
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+using Wells = Opm::PackedWellSchurComplement<double, bz>;
+
+// tridiagonal block matrix with distinct entries
+Matrix createMatrix(const int n)
+{
+    Matrix matrix(n, n, 3 * n, Matrix::row_wise);
+    for (auto row = matrix.createbegin(); row != matrix.createend(); ++row) {
+        const int i = row.index();
+        if (i > 0)
+            row.insert(i - 1);
+        row.insert(i);
+        if (i < n - 1)
+            row.insert(i + 1);
+    }
+    double value = 1.0;
+    for (auto& row : matrix)
+        for (auto& block : row)
+            for (int i = 0; i < bz; ++i)
+                for (int j = 0; j < bz; ++j)
+                    block[i][j] = value++;
+    return matrix;
+}
+
+Wells createWells()
+{
+    Wells wells;
+    const int nw = 4;
+    const std::vector<int> cells { 1, 3 };
+    std::vector<double> values(Wells::packedSize(nw, cells.size()));
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = 0.5 * i;
+    wells.addPackedWell(nw, cells.size(), cells.data(), values.data());
+    return wells;
+}
+
+void checkRoundTrip(const bool mapFile)
+{
+    const std::string fileName = "test_binarysystemdump.bin";
+    const Matrix matrix = createMatrix(5);
+    Vector rhs(5);
+    for (std::size_t i = 0; i < rhs.size(); ++i)
+        for (int j = 0; j < bz; ++j)
+            rhs[i][j] = -1.0 * (i * bz + j);
+    const Wells wells = createWells();
+    const std::vector<Opm::BinarySystemIndex> indices { {10, 0, 1}, {12, 1, 1}, {17, 2, 3} };
+
+    Opm::Helper::writeBinarySystem(fileName, matrix, rhs, &wells, indices);
+
+    Opm::BinarySystemReader reader(fileName, mapFile);
+    BOOST_CHECK_EQUAL(reader.header().block_size, bz);
+    BOOST_CHECK_EQUAL(reader.header().rows, 5);
+    BOOST_CHECK_EQUAL(reader.header().nonzeroes, matrix.nonzeroes());
+
+    Matrix matrixRead;
+    Vector rhsRead;
+    Opm::Helper::readBinarySystem(reader, matrixRead, rhsRead);
+    BOOST_REQUIRE_EQUAL(matrixRead.N(), matrix.N());
+    BOOST_REQUIRE_EQUAL(matrixRead.nonzeroes(), matrix.nonzeroes());
+    for (auto row = matrix.begin(); row != matrix.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            BOOST_REQUIRE(matrixRead.exists(row.index(), col.index()));
+            for (int i = 0; i < bz; ++i)
+                for (int j = 0; j < bz; ++j)
+                    BOOST_CHECK_EQUAL(matrixRead[row.index()][col.index()][i][j], (*col)[i][j]);
+        }
+    }
+    for (std::size_t i = 0; i < rhs.size(); ++i)
+        for (int j = 0; j < bz; ++j)
+            BOOST_CHECK_EQUAL(rhsRead[i][j], rhs[i][j]);
+
+    Wells wellsRead;
+    Opm::Helper::readBinarySystemWells(reader, wellsRead);
+    BOOST_REQUIRE_EQUAL(wellsRead.numWells(), 1);
+    BOOST_CHECK_EQUAL(wellsRead.numWellEq(0), 4);
+    BOOST_CHECK_EQUAL(wellsRead.numPerforations(0), 2);
+    BOOST_CHECK_EQUAL_COLLECTIONS(wellsRead.cells().begin(), wellsRead.cells().end(),
+                                  wells.cells().begin(), wells.cells().end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(wellsRead.values().begin(), wellsRead.values().end(),
+                                  wells.values().begin(), wells.values().end());
+
+    BOOST_REQUIRE_EQUAL(reader.header().indices, indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        BOOST_CHECK_EQUAL(reader.indices()[i].global, indices[i].global);
+        BOOST_CHECK_EQUAL(reader.indices()[i].local, indices[i].local);
+        BOOST_CHECK_EQUAL(reader.indices()[i].attribute, indices[i].attribute);
+    }
+
+    Opm::filesystem::remove(fileName);
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(RoundTripMapped)
+{
+    checkRoundTrip(true);
+}
+
+BOOST_AUTO_TEST_CASE(RoundTripRead)
+{
+    checkRoundTrip(false);
+}
+
+BOOST_AUTO_TEST_CASE(Truncated)
+{
+    const std::string fileName = "test_binarysystemdump_truncated.bin";
+    const Matrix matrix = createMatrix(4);
+    Vector rhs(4);
+    rhs = 1.0;
+    const Wells wells;
+    Opm::Helper::writeBinarySystem(fileName, matrix, rhs, &wells, {});
+
+    // drop the last bytes of the right hand side
+    Opm::filesystem::resize_file(fileName, Opm::filesystem::file_size(fileName) - 8);
+
+    BOOST_CHECK_THROW(Opm::BinarySystemReader reader(fileName), std::runtime_error);
+    Opm::filesystem::remove(fileName);
+}
@@ -0,0 +1,132 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE CheckpointBufferTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/CheckpointBuffer.hpp>
+
+#include <opm/common/utility/FileSystem.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+    const std::string fileName = "test_checkpointbuffer.bin";
+    const std::vector<double> values { 1.0, -2.5, 1.0e-300 };
+    {
+        Opm::CheckpointBuffer buffer;
+        buffer.write(42);
+        buffer.write(std::string("PROD-1"));
+        buffer.write(values);
+        buffer.write(std::vector<int>{});
+        buffer.write(true);
+        buffer.save(fileName);
+    }
+
+    auto buffer = Opm::CheckpointBuffer::load(fileName);
+    int i = 0;
+    std::string s;
+    std::vector<double> v;
+    std::vector<int> empty { 1 };
+    bool b = false;
+    buffer.read(i);
+    buffer.read(s);
+    buffer.read(v);
+    buffer.read(empty);
+    buffer.read(b);
+
+    BOOST_CHECK_EQUAL(i, 42);
+    BOOST_CHECK_EQUAL(s, "PROD-1");
+    BOOST_CHECK_EQUAL_COLLECTIONS(v.begin(), v.end(), values.begin(), values.end());
+    BOOST_CHECK(empty.empty());
+    BOOST_CHECK(b);
+    BOOST_CHECK(buffer.atEnd());
+    BOOST_CHECK(!Opm::filesystem::exists(fileName + ".tmp"));
+
+    Opm::filesystem::remove(fileName);
+}
+
+BOOST_AUTO_TEST_CASE(MappedAndRead)
+{
+    const std::string fileName = "test_checkpointbuffer_mapped.bin";
+    {
+        Opm::CheckpointBuffer buffer;
+        buffer.write(std::string("SNAPSHOT"));
+        buffer.write(std::vector<double>{ 3.0, 4.0 });
+        buffer.save(fileName);
+    }
+
+    for (const bool mapFile : { true, false }) {
+        auto buffer = Opm::CheckpointBuffer::load(fileName, mapFile);
+        if (!mapFile) {
+            BOOST_CHECK(!buffer.isMapped());
+        }
+        std::string s;
+        std::vector<double> v;
+        buffer.read(s);
+        buffer.read(v);
+        BOOST_CHECK_EQUAL(s, "SNAPSHOT");
+        BOOST_CHECK_EQUAL(v.size(), 2u);
+        BOOST_CHECK_EQUAL(v[1], 4.0);
+        BOOST_CHECK(buffer.atEnd());
+        if (buffer.isMapped()) {
+            BOOST_CHECK_THROW(buffer.write(1), std::logic_error);
+        }
+    }
+
+    Opm::filesystem::remove(fileName);
+}
+
+BOOST_AUTO_TEST_CASE(Truncated)
+{
+    Opm::CheckpointBuffer buffer;
+    buffer.write(1);
+
+    double value = 0.0;
+    BOOST_CHECK_THROW(buffer.read(value), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(Manifest)
+{
+    const std::string fileName = "test_checkpointbuffer.manifest";
+
+    Opm::CheckpointManifest manifest;
+    manifest.version = 1;
+    manifest.caseName = "NORNE ATW2013";
+    manifest.processes = 8;
+    manifest.reportStep = 17;
+    manifest.time = 123456.789012345;
+    manifest.save(fileName);
+
+    const auto loaded = Opm::CheckpointManifest::load(fileName);
+    BOOST_CHECK_EQUAL(loaded.version, manifest.version);
+    BOOST_CHECK_EQUAL(loaded.caseName, manifest.caseName);
+    BOOST_CHECK_EQUAL(loaded.processes, manifest.processes);
+    BOOST_CHECK_EQUAL(loaded.reportStep, manifest.reportStep);
+    BOOST_CHECK_EQUAL(loaded.time, manifest.time);
+
+    Opm::filesystem::remove(fileName);
+
+    BOOST_CHECK_THROW(Opm::CheckpointManifest::load(fileName), std::runtime_error);
+}
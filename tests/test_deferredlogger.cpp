@@ -98,3 +98,30 @@ BOOST_AUTO_TEST_CASE(deferredlogger)
     BOOST_CHECK_EQUAL(log_stream.str(), expected);
 
 }
+
+BOOST_AUTO_TEST_CASE(deferredloggerEnabledMessageTypes)
+{
+    const std::string expected = Log::prefixMessage(Log::MessageType::Info, "info 1") + "\n"
+        + Log::prefixMessage(Log::MessageType::Warning, "warning 1") + "\n";
+
+    std::ostringstream log_stream;
+    initLogger(log_stream);
+    Opm::DeferredLogger::setEnabledMessageTypes(Log::NoDebugMessageTypes);
+    BOOST_CHECK(!Opm::DeferredLogger::enabled(Log::MessageType::Debug));
+    BOOST_CHECK(Opm::DeferredLogger::enabled(Log::MessageType::Info));
+
+    auto deferred_logger = Opm::DeferredLogger();
+    deferred_logger.info("info 1");
+    deferred_logger.debug("debug 1");
+    deferred_logger.debug("tagme", "debug 2");
+    deferred_logger.warning("warning 1");
+    deferred_logger.logMessages();
+    Opm::DeferredLogger::setEnabledMessageTypes(Log::DefaultMessageTypes);
+
+    auto counter = OpmLog::getBackend<CounterLog>("COUNTER");
+    BOOST_CHECK_EQUAL( 1 , counter->numMessages(Log::MessageType::Info) );
+    BOOST_CHECK_EQUAL( 1 , counter->numMessages(Log::MessageType::Warning) );
+    BOOST_CHECK_EQUAL( 0 , counter->numMessages(Log::MessageType::Debug) );
+
+    BOOST_CHECK_EQUAL(log_stream.str(), expected);
+}
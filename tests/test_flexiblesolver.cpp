@@ -133,6 +133,98 @@ BOOST_AUTO_TEST_CASE(TestFlexibleSolver)
     }
 }
 
+BOOST_AUTO_TEST_CASE(TestPipelinedBiCGSTAB)
+{
+    namespace pt = boost::property_tree;
+    pt::ptree prm;
+    {
+        std::ifstream file("options_flexiblesolver_simple.json");
+        pt::read_json(file, prm);
+    }
+    prm.put("solver", "pipelined_bicgstab");
+    prm.put("preconditioner.type", "ILU0");
+
+    const int bz = 3;
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+    Matrix matrix;
+    {
+        std::ifstream mfile("matr33.txt");
+        readMatrixMarket(matrix, mfile);
+    }
+    Vector rhs;
+    {
+        std::ifstream rhsfile("rhs3.txt");
+        readMatrixMarket(rhs, rhsfile);
+    }
+    const Vector b = rhs;
+
+    using SeqOperatorType = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+    SeqOperatorType op(matrix);
+    Dune::FlexibleSolver<Matrix, Vector> solver(op, prm);
+    Vector x(rhs.size());
+    x = 0.0;
+    Dune::InverseOperatorResult res;
+    solver.apply(x, rhs, res);
+    BOOST_CHECK(res.converged);
+
+    // the solution must satisfy the original system
+    Vector r = b;
+    matrix.mmv(x, r);
+    BOOST_CHECK_LE(r.two_norm(), 1e-8 * b.two_norm());
+}
+
+BOOST_AUTO_TEST_CASE(TestRecyclingGCRO)
+{
+    namespace pt = boost::property_tree;
+    pt::ptree prm;
+    {
+        std::ifstream file("options_flexiblesolver_simple.json");
+        pt::read_json(file, prm);
+    }
+    prm.put("solver", "gcro");
+    prm.put("recycle", 3);
+    prm.put("preconditioner.type", "ILU0");
+
+    const int bz = 3;
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+    Matrix matrix;
+    {
+        std::ifstream mfile("matr33.txt");
+        readMatrixMarket(matrix, mfile);
+    }
+    Vector b;
+    {
+        std::ifstream rhsfile("rhs3.txt");
+        readMatrixMarket(b, rhsfile);
+    }
+
+    using SeqOperatorType = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+    SeqOperatorType op(matrix);
+    Dune::FlexibleSolver<Matrix, Vector> solver(op, prm);
+
+    // the second solve starts with the directions recycled from the first
+    int first_iterations = 0;
+    for (int solve = 0; solve < 2; ++solve) {
+        Vector rhs = b;
+        Vector x(rhs.size());
+        x = 0.0;
+        Dune::InverseOperatorResult res;
+        solver.apply(x, rhs, res);
+        BOOST_CHECK(res.converged);
+
+        Vector r = b;
+        matrix.mmv(x, r);
+        BOOST_CHECK_LE(r.two_norm(), 1e-8 * b.two_norm());
+        if (solve == 0) {
+            first_iterations = res.iterations;
+        } else {
+            BOOST_CHECK_LE(res.iterations, first_iterations);
+        }
+    }
+}
+
 #else
 
 // Do nothing if we do not have at least Dune 2.6.
@@ -99,3 +99,123 @@ BOOST_AUTO_TEST_CASE(TestWelschPowell)
                                            graph, 0);
     checkAllIndices(newOrder);
 }
+
+BOOST_AUTO_TEST_CASE(TestJonesPlassmann)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+    using Graph = Dune::Amg::MatrixGraph<Matrix>;
+    const int N = 10;
+    // 9-point stencil on an N x N grid
+    Matrix matrix(N*N, N*N, 9, 0.4, Matrix::implicit);
+    for( int j = 0; j < N; j++)
+    {
+        for(int i = 0; i < N; i++)
+        {
+            for(int dj = -1; dj <= 1; dj++)
+            {
+                for(int di = -1; di <= 1; di++)
+                {
+                    if ( i + di >= 0 && i + di < N && j + dj >= 0 && j + dj < N )
+                    {
+                        matrix.entry(j*N + i, (j + dj)*N + i + di) = 1;
+                    }
+                }
+            }
+        }
+    }
+    matrix.compress();
+
+    Graph graph(matrix);
+    auto colorsTuple = Opm::colorVerticesJonesPlassmann(graph);
+    const auto& colors = std::get<0>(colorsTuple);
+    const auto& verticesPerColor = std::get<2>(colorsTuple);
+    auto noColors = std::get<1>(colorsTuple);
+    BOOST_CHECK(noColors >= 4);
+    BOOST_CHECK(verticesPerColor.size() == static_cast<std::size_t>(noColors));
+    BOOST_CHECK(std::accumulate(verticesPerColor.begin(), verticesPerColor.end(), std::size_t(0)) == graph.noVertices());
+
+    // no neighbours share a color
+    for (auto vertex : graph)
+    {
+        BOOST_CHECK(colors[vertex] >= 0 && colors[vertex] < noColors);
+        for(auto edge = graph.beginEdges(vertex), endEdge = graph.endEdges(vertex);
+            edge != endEdge; ++edge)
+        {
+            if ( edge.target() != vertex )
+            {
+                BOOST_CHECK(colors[edge.target()] != colors[vertex]);
+            }
+        }
+    }
+
+    // the coloring is reproducible
+    BOOST_CHECK(std::get<0>(Opm::colorVerticesJonesPlassmann(graph)) == colors);
+
+    auto newOrder = Opm::reorderVerticesPreserving(colors, noColors, verticesPerColor,
+                                                   graph);
+    checkAllIndices(newOrder);
+}
+
+BOOST_AUTO_TEST_CASE(TestReverseCuthillMcKee)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+    using Graph = Dune::Amg::MatrixGraph<Matrix>;
+    const int N = 10;
+    // Laplacian on an N x N grid with scattered cell numbers
+    auto cell = [N](int i, int j) { return (37 * (j * N + i)) % (N * N); };
+    Matrix matrix(N*N, N*N, 5, 0.4, Matrix::implicit);
+    for( int j = 0; j < N; j++)
+    {
+        for(int i = 0; i < N; i++)
+        {
+            const auto index = cell(i, j);
+            matrix.entry(index, index) = 4;
+            if ( i > 0 )
+            {
+                matrix.entry(index, cell(i - 1, j)) = -1;
+            }
+            if ( i < N - 1 )
+            {
+                matrix.entry(index, cell(i + 1, j)) = -1;
+            }
+            if ( j > 0 )
+            {
+                matrix.entry(index, cell(i, j - 1)) = -1;
+            }
+            if ( j < N - 1 )
+            {
+                matrix.entry(index, cell(i, j + 1)) = -1;
+            }
+        }
+    }
+    matrix.compress();
+
+    auto bandwidth = [&matrix](const std::vector<std::size_t>& ordering)
+    {
+        std::size_t width = 0;
+        for (auto row = matrix.begin(); row != matrix.end(); ++row)
+        {
+            for (auto col = row->begin(); col != row->end(); ++col)
+            {
+                const auto i = ordering[row.index()];
+                const auto j = ordering[col.index()];
+                width = std::max(width, i > j ? i - j : j - i);
+            }
+        }
+        return width;
+    };
+
+    Graph graph(matrix);
+    auto newOrder = Opm::reorderVerticesReverseCuthillMcKee(graph, N*N);
+    checkAllIndices(newOrder);
+    BOOST_CHECK(bandwidth(newOrder) <= static_cast<std::size_t>(N));
+
+    // the vertices at the end keep their index
+    const std::size_t interior = N*N - N;
+    newOrder = Opm::reorderVerticesReverseCuthillMcKee(graph, interior);
+    checkAllIndices(newOrder);
+    for (std::size_t vertex = interior; vertex < newOrder.size(); ++vertex)
+    {
+        BOOST_CHECK_EQUAL(newOrder[vertex], vertex);
+    }
+}
@@ -69,6 +69,65 @@ BOOST_AUTO_TEST_CASE(Invert4x4)
     checkIdentity(inverse);
 }
 
+template <int n>
+void checkBlockOperations()
+{
+    using Matrix = Dune::FieldMatrix<double, n, n>;
+    using Vector = Dune::FieldVector<double, n>;
+    Matrix A, B, C;
+    Vector x, y;
+    for (int i = 0; i < n; ++i) {
+        x[i] = i + 1;
+        y[i] = 2 * i - 1;
+        for (int j = 0; j < n; ++j) {
+            A[i][j] = (i == j) ? 10.0 : i - 2.0 * j + 1;
+            B[i][j] = i * j - 1.0;
+            C[i][j] = i + j;
+        }
+    }
 
+    Vector y_ref(y), y_blk(y);
+    A.mmv(x, y_ref);
+    Opm::Detail::blockMmv(A, x, y_blk);
+    for (int i = 0; i < n; ++i)
+        BOOST_CHECK_CLOSE(y_ref[i], y_blk[i], 1e-13);
+
+    A.mv(x, y_ref);
+    Opm::Detail::blockMv(A, x, y_blk);
+    for (int i = 0; i < n; ++i)
+        BOOST_CHECK_CLOSE(y_ref[i], y_blk[i], 1e-13);
+
+    Matrix product(B), C_blk(C);
+    product.leftmultiply(A);
+    Matrix C_ref = C;
+    C_ref -= product;
+    Opm::Detail::blockSubtractProduct(A, B, C_blk);
+    Matrix AB_blk(A);
+    Opm::Detail::blockRightMultiply(AB_blk, B);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            BOOST_CHECK_CLOSE(C_ref[i][j], C_blk[i][j], 1e-13);
+            BOOST_CHECK_CLOSE(product[i][j], AB_blk[i][j], 1e-13);
+        }
+    }
 
+    Matrix inverse(A);
+    Dune::ISTLUtility::invertMatrix(inverse);
+    Matrix identity(A);
+    identity.rightmultiply(inverse);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            BOOST_CHECK_SMALL(identity[i][j] - (i == j ? 1.0 : 0.0), 1e-14);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BlockOperations3x3)
+{
+    checkBlockOperations<3>();
+}
 
+BOOST_AUTO_TEST_CASE(BlockOperations4x4)
+{
+    checkBlockOperations<4>();
+}
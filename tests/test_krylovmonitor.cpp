@@ -0,0 +1,74 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE KrylovMonitorTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/linalg/KrylovMonitor.hpp>
+
+#include <limits>
+
+using Dune::KrylovMonitor;
+using Status = KrylovMonitor::Status;
+
+BOOST_AUTO_TEST_CASE(InactiveByDefault)
+{
+    KrylovMonitor monitor;
+    BOOST_CHECK(!monitor.active());
+    monitor.start(1.0);
+    for (int it = 1; it <= 100; ++it) {
+        BOOST_CHECK(monitor.check(it, 1e3) == Status::Continue);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Stagnation)
+{
+    KrylovMonitor monitor(5, 0.9, 0.0);
+    BOOST_CHECK(monitor.active());
+    monitor.start(1.0);
+    // steady progress
+    double def = 1.0;
+    for (int it = 1; it <= 10; ++it) {
+        def *= 0.5;
+        BOOST_CHECK(monitor.check(it, def) == Status::Continue);
+    }
+    // a plateau, small gains do not count as progress
+    for (int it = 11; it <= 14; ++it) {
+        def *= 0.99;
+        BOOST_CHECK(monitor.check(it, def) == Status::Continue);
+    }
+    BOOST_CHECK(monitor.check(15, def) == Status::Stagnated);
+
+    // a new start forgets the plateau
+    monitor.start(1.0);
+    BOOST_CHECK(monitor.check(1, 0.5) == Status::Continue);
+}
+
+BOOST_AUTO_TEST_CASE(Divergence)
+{
+    KrylovMonitor monitor(0, 0.9, 100.0);
+    monitor.start(2.0);
+    BOOST_CHECK(monitor.check(1, 150.0) == Status::Continue);
+    BOOST_CHECK(monitor.check(2, 250.0) == Status::Diverged);
+    BOOST_CHECK(monitor.check(3, std::numeric_limits<double>::quiet_NaN()) == Status::Diverged);
+    BOOST_CHECK(monitor.check(4, std::numeric_limits<double>::infinity()) == Status::Diverged);
+}
@@ -0,0 +1,122 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LinearSolverAutoTunerTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/linalg/LinearSolverAutoTuner.hpp>
+
+using Opm::LinearSolverAutoTuner;
+
+namespace
+{
+
+LinearSolverAutoTuner::PropertyTree cprTree()
+{
+    LinearSolverAutoTuner::PropertyTree prm;
+    prm.put("solver", "bicgstab");
+    prm.put("preconditioner.type", "cpr");
+    prm.put("preconditioner.finesmoother.type", "ParOverILU0");
+    prm.put("preconditioner.coarsesolver.preconditioner.type", "amg");
+    prm.put("preconditioner.coarsesolver.preconditioner.coarsenTarget", 1200);
+    return prm;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(Variants)
+{
+    const auto variants = LinearSolverAutoTuner::variants(cprTree());
+    BOOST_REQUIRE_EQUAL(variants.size(), 5);
+    BOOST_CHECK_EQUAL(variants[0].first, "configured");
+    BOOST_CHECK_EQUAL(variants[1].second.get<int>("preconditioner.finesmoother.ilulevel"), 1);
+    BOOST_CHECK(variants[2].second.get<bool>("preconditioner.finesmoother.redblack"));
+    BOOST_CHECK_EQUAL(variants[3].second.get<int>("preconditioner.coarsesolver.preconditioner.coarsenTarget"), 4800);
+
+    // nothing to vary
+    LinearSolverAutoTuner::PropertyTree prm;
+    prm.put("preconditioner.type", "Jac");
+    BOOST_CHECK_EQUAL(LinearSolverAutoTuner::variants(prm).size(), 1);
+    LinearSolverAutoTuner tuner(prm, 3, 0);
+    BOOST_CHECK(!tuner.tuning());
+    BOOST_CHECK(!tuner.record(1.0, true));
+}
+
+BOOST_AUTO_TEST_CASE(ChooseFastest)
+{
+    LinearSolverAutoTuner tuner(cprTree(), 2, 0);
+    const std::size_t n = tuner.candidates().size();
+    const double times[] = {3.0, 2.0, 1.0, 4.0, 5.0};
+    for (std::size_t i = 0; i < n; ++i) {
+        BOOST_CHECK(tuner.tuning());
+        BOOST_CHECK_EQUAL(tuner.name(), tuner.candidates()[i].name);
+        BOOST_CHECK(!tuner.record(times[i], true));
+        const bool changed = tuner.record(times[i], true);
+        // the last one switches to the fastest
+        BOOST_CHECK(changed);
+    }
+    BOOST_CHECK(!tuner.tuning());
+    BOOST_CHECK_EQUAL(tuner.name(), tuner.candidates()[2].name);
+    BOOST_CHECK_CLOSE(tuner.candidates()[2].meanSeconds(), 1.0, 1e-12);
+    BOOST_CHECK(!tuner.record(10.0, true));
+    BOOST_CHECK_EQUAL(tuner.name(), tuner.candidates()[2].name);
+    BOOST_CHECK(tuner.summary().find("<- chosen") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(SkipFailed)
+{
+    LinearSolverAutoTuner tuner(cprTree(), 3, 0);
+    const std::size_t n = tuner.candidates().size();
+    // the fastest fails to converge, it is abandoned after one solve
+    BOOST_CHECK(!tuner.record(2.0, true));
+    BOOST_CHECK(!tuner.record(2.0, true));
+    BOOST_CHECK(tuner.record(2.0, true));
+    BOOST_CHECK(tuner.record(0.1, false));
+    for (std::size_t i = 2; i < n; ++i) {
+        for (int s = 0; s < 3; ++s) {
+            tuner.record(3.0, true);
+        }
+    }
+    BOOST_CHECK(!tuner.tuning());
+    BOOST_CHECK(tuner.candidates()[1].failed);
+    BOOST_CHECK_EQUAL(tuner.candidates()[1].solves, 1);
+    BOOST_CHECK_EQUAL(tuner.name(), "configured");
+}
+
+BOOST_AUTO_TEST_CASE(Retune)
+{
+    LinearSolverAutoTuner tuner(cprTree(), 1, 4);
+    const std::size_t n = tuner.candidates().size();
+    for (std::size_t i = 0; i < n; ++i) {
+        tuner.record(i == 1 ? 1.0 : 2.0, true);
+    }
+    BOOST_CHECK(!tuner.tuning());
+    BOOST_CHECK_EQUAL(tuner.name(), tuner.candidates()[1].name);
+    for (int s = 0; s < 3; ++s) {
+        BOOST_CHECK(!tuner.record(1.0, true));
+    }
+    // back to the configured solver to try all variants again
+    BOOST_CHECK(tuner.record(1.0, true));
+    BOOST_CHECK(tuner.tuning());
+    BOOST_CHECK_EQUAL(tuner.name(), "configured");
+    BOOST_CHECK_EQUAL(tuner.candidates()[1].solves, 0);
+}
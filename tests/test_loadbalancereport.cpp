@@ -0,0 +1,105 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LoadBalanceReportTest
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/timestepping/LoadBalanceReport.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+bool init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(Statistics)
+{
+    const auto stats = Opm::LoadBalanceReport::statistics({ 2.0, 6.0, 1.0, 3.0 });
+    BOOST_CHECK_EQUAL(stats.min, 1.0);
+    BOOST_CHECK_EQUAL(stats.max, 6.0);
+    BOOST_CHECK_EQUAL(stats.mean, 3.0);
+    BOOST_CHECK_EQUAL(stats.maxRank, 1);
+    BOOST_CHECK_EQUAL(stats.imbalance(), 2.0);
+
+    const auto idle = Opm::LoadBalanceReport::statistics({ 0.0, 0.0 });
+    BOOST_CHECK_EQUAL(idle.imbalance(), 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(Report)
+{
+    const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+
+    Opm::SimulatorReport report;
+    Opm::SimulatorReportSingle step;
+    step.converged = true;
+    step.assemble_time = 1.5;
+    step.linear_solve_time = 0.5;
+    step.total_well_iterations = 3;
+    report += step;
+    step.assemble_time = 2.5;
+    report += step;
+    Opm::SimulatorReportSingle failed;
+    failed.assemble_time = 1.0;
+    report += failed;
+
+    const Opm::LoadBalanceReport loadBalance(report, 100, 5, /*perStep=*/true, comm);
+    const Opm::LoadBalanceReport totalOnly(report, 100, 5, /*perStep=*/false, comm);
+    if (comm.rank() != 0) {
+        return;
+    }
+
+    using LBR = Opm::LoadBalanceReport;
+    BOOST_CHECK_EQUAL(loadBalance.numProcesses(), comm.size());
+    BOOST_CHECK_EQUAL(loadBalance.total(LBR::Cells).min, 100.0);
+    BOOST_CHECK_EQUAL(loadBalance.total(LBR::Wells).max, 5.0);
+    // the failed substeps are included in the total
+    BOOST_CHECK_EQUAL(loadBalance.total(LBR::AssemblyTime).mean, 5.0);
+    BOOST_CHECK_EQUAL(loadBalance.total(LBR::LinearSolveTime).mean, 1.0);
+    BOOST_CHECK_EQUAL(loadBalance.total(LBR::WellIterations).mean, 6.0);
+    BOOST_CHECK_EQUAL(loadBalance.total(LBR::AssemblyTime).imbalance(), 1.0);
+
+    BOOST_REQUIRE_EQUAL(loadBalance.numSteps(), 3);
+    BOOST_CHECK_EQUAL(loadBalance.step(0, LBR::AssemblyTime).mean, 1.5);
+    BOOST_CHECK_EQUAL(loadBalance.step(1, LBR::AssemblyTime).mean, 2.5);
+    BOOST_CHECK_EQUAL(loadBalance.step(2, LBR::AssemblyTime).mean, 1.0);
+
+    std::ostringstream os;
+    loadBalance.report(os);
+    BOOST_CHECK(os.str().find("Assembly time") != std::string::npos);
+    std::ostringstream steps;
+    loadBalance.reportSteps(steps);
+    const std::string table = steps.str();
+    BOOST_CHECK_EQUAL(std::count(table.begin(), table.end(), '\n'), 4);
+    BOOST_CHECK_EQUAL(totalOnly.numSteps(), 0);
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
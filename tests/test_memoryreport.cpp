@@ -0,0 +1,86 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE MemoryReportTest
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/MemoryReport.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+bool init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(VectorUsage)
+{
+    std::vector<double> v;
+    v.reserve(100);
+    v.resize(10);
+    BOOST_CHECK_EQUAL(Opm::memoryUsage(v), 100 * sizeof(double));
+}
+
+BOOST_AUTO_TEST_CASE(Accumulate)
+{
+    Opm::MemoryReport report;
+    report.add("Well state", 1024);
+    report.add("Preconditioner", 2048);
+    report.add("Well state", 1024);
+
+    const auto& subsystems = report.subsystems();
+    BOOST_REQUIRE_EQUAL(subsystems.size(), 2);
+    BOOST_CHECK_EQUAL(subsystems[0].first, "Well state");
+    BOOST_CHECK_EQUAL(subsystems[0].second, 2048);
+    BOOST_CHECK_EQUAL(subsystems[1].first, "Preconditioner");
+}
+
+BOOST_AUTO_TEST_CASE(Print)
+{
+    const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+
+    Opm::MemoryReport report;
+    report.add("Jacobian and residual", 3 * 1024 * 1024);
+    std::ostringstream os;
+    report.print(os, "Memory usage", comm);
+    if (comm.rank() != 0) {
+        BOOST_CHECK(os.str().empty());
+        return;
+    }
+
+    const std::string table = os.str();
+    BOOST_CHECK(table.find("Memory usage") == 0);
+    BOOST_CHECK(table.find("Jacobian and residual") != std::string::npos);
+    BOOST_CHECK(table.find("Not accounted for") != std::string::npos);
+    BOOST_CHECK(table.find("Resident set size") != std::string::npos);
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
@@ -196,3 +196,169 @@ BOOST_AUTO_TEST_CASE(MILULaplace4)
 {
     test<4>();
 }
+
+template<int bsize>
+void test_level_scheduling(bool redblack)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bsize, bsize> >;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bsize> >;
+    std::size_t N = 32;
+    Matrix A;
+    setupLaplacian(A, N);
+
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> sequential(A, 0, 1.0, Opm::MILU_VARIANT::ILU,
+                                                                    redblack, false, false);
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> levels(A, 0, 1.0, Opm::MILU_VARIANT::ILU,
+                                                                redblack, false, true);
+
+    Vector d(A.N());
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        for (int j = 0; j < bsize; ++j) {
+            d[i][j] = 1.0 + (i % 7) - 0.5 * j;
+        }
+    }
+    Vector v1(A.N()), v2(A.N());
+    v1 = 0.0;
+    v2 = 0.0;
+    sequential.apply(v1, d);
+    levels.apply(v2, d);
+
+    for (std::size_t i = 0; i < v1.size(); ++i) {
+        for (int j = 0; j < bsize; ++j) {
+            BOOST_CHECK_CLOSE(v1[i][j], v2[i][j], 1e-12);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ILULevelScheduling)
+{
+    test_level_scheduling<1>(false);
+    test_level_scheduling<3>(false);
+    test_level_scheduling<3>(true);
+}
+
+BOOST_AUTO_TEST_CASE(ILUMixedPrecision)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 3, 3> >;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, 3> >;
+    std::size_t N = 32;
+    Matrix A;
+    setupLaplacian(A, N);
+
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> full(A, 0, 1.0, Opm::MILU_VARIANT::ILU);
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> mixed(A, 0, 1.0, Opm::MILU_VARIANT::ILU,
+                                                               false, false, false, true);
+
+    Vector d(A.N());
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        for (int j = 0; j < 3; ++j) {
+            d[i][j] = 1.0 + (i % 5) + j;
+        }
+    }
+    Vector v1(A.N()), v2(A.N());
+    v1 = 0.0;
+    v2 = 0.0;
+    full.apply(v1, d);
+    mixed.apply(v2, d);
+
+    for (std::size_t i = 0; i < v1.size(); ++i) {
+        for (int j = 0; j < 3; ++j) {
+            BOOST_CHECK_CLOSE(v1[i][j], v2[i][j], 1e-3);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ILUnUpdateKeepsPattern)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 3, 3> >;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, 3> >;
+    std::size_t N = 16;
+    Matrix A;
+    setupLaplacian(A, N);
+
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> reused(A, 2, 1.0, Opm::MILU_VARIANT::ILU);
+
+    // new values on the same sparsity pattern
+    A *= 2.0;
+    reused.update();
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> fresh(A, 2, 1.0, Opm::MILU_VARIANT::ILU);
+
+    Vector d(A.N());
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        for (int j = 0; j < 3; ++j) {
+            d[i][j] = 1.0 + (i % 3) + j;
+        }
+    }
+    Vector v1(A.N()), v2(A.N());
+    v1 = 0.0;
+    v2 = 0.0;
+    reused.apply(v1, d);
+    fresh.apply(v2, d);
+
+    for (std::size_t i = 0; i < v1.size(); ++i) {
+        for (int j = 0; j < 3; ++j) {
+            BOOST_CHECK_CLOSE(v1[i][j], v2[i][j], 1e-12);
+        }
+    }
+}
+
+template<int bsize>
+void test_ilut_complete()
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bsize, bsize> >;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bsize> >;
+    std::size_t N = 8;
+    Matrix A;
+    setupLaplacian(A, N);
+
+    // Without dropping and with unbounded fill ILUT is a complete LU decomposition.
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> ilut(A, 0, 1.0, Opm::MILU_VARIANT::ILU,
+                                                              false, false, false, false,
+                                                              1e-300, static_cast<int>(N * N));
+    Vector e(A.N()), d(A.N()), v(A.N());
+    e = 1.0;
+    A.mv(e, d);
+    v = 0.0;
+    ilut.apply(v, d);
+
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        for (int j = 0; j < bsize; ++j) {
+            BOOST_CHECK_CLOSE(v[i][j], 1.0, 1e-8);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ILUTComplete)
+{
+    test_ilut_complete<1>();
+    test_ilut_complete<3>();
+}
+
+BOOST_AUTO_TEST_CASE(ILUTBoundedFill)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1> >;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, 1> >;
+    std::size_t N = 16;
+    Matrix A;
+    setupLaplacian(A, N);
+
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> ilu0(A, 0, 1.0, Opm::MILU_VARIANT::ILU);
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> ilut(A, 0, 1.0, Opm::MILU_VARIANT::ILU,
+                                                              false, false, false, false,
+                                                              1e-4, 2);
+    // ILUT keeps some fill-in.
+    BOOST_CHECK_GT(ilut.memoryUsage(), ilu0.memoryUsage());
+
+    // The preconditioned residual of ILUT is smaller than that of ILU0.
+    Vector e(A.N()), d(A.N()), v(A.N());
+    e = 1.0;
+    A.mv(e, d);
+    auto error = [&](auto& prec)
+    {
+        v = 0.0;
+        prec.apply(v, d);
+        v -= e;
+        return v.two_norm();
+    };
+    BOOST_CHECK_LT(error(ilut), error(ilu0));
+}
@@ -0,0 +1,131 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE MSWellHelpersTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/wells/MSWellHelpers.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <vector>
+
+using Block = Dune::FieldMatrix<double, 3, 3>;
+using Matrix = Dune::BCRSMatrix<Block>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, 3>>;
+using Solver = Opm::mswellhelpers::SegmentTreeSolver<Matrix, Vector>;
+
+namespace {
+
+// same sparsity pattern as MultisegmentWell::initMatrixAndVectors()
+Matrix buildSegmentMatrix(const std::vector<int>& outlets)
+{
+    const int n = outlets.size();
+    std::vector<std::vector<int>> inlets(n);
+    for (int seg = 0; seg < n; ++seg) {
+        if (outlets[seg] >= 0) {
+            inlets[outlets[seg]].push_back(seg);
+        }
+    }
+
+    Matrix D(n, n, Matrix::row_wise);
+    for (auto row = D.createbegin(), end = D.createend(); row != end; ++row) {
+        const int seg = row.index();
+        if (outlets[seg] >= 0) {
+            row.insert(outlets[seg]);
+        }
+        row.insert(seg);
+        for (const int inlet : inlets[seg]) {
+            row.insert(inlet);
+        }
+    }
+
+    for (auto row = D.begin(); row != D.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    (*col)[i][j] = 0.1 * (row.index() + 1) - 0.05 * (col.index() + i) + 0.02 * j;
+                }
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            D[row.index()][row.index()][i][i] += 4.0 + i;
+        }
+    }
+    return D;
+}
+
+void checkSolve(const std::vector<int>& outlets)
+{
+    const Matrix D = buildSegmentMatrix(outlets);
+    Vector x(outlets.size());
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        for (int j = 0; j < 3; ++j) {
+            x[i][j] = 1.0 + i - 0.5 * j;
+        }
+    }
+
+    Solver solver;
+    solver.init(outlets);
+    BOOST_REQUIRE(solver.factorize(D));
+    const Vector y = solver.solve(D, x);
+
+    Vector Dy(x.size());
+    D.mv(y, Dy);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        for (int j = 0; j < 3; ++j) {
+            BOOST_CHECK_CLOSE(Dy[i][j], x[i][j], 1.0e-10);
+        }
+    }
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(SingleBranch)
+{
+    checkSolve({-1, 0, 1, 2, 3, 4});
+}
+
+BOOST_AUTO_TEST_CASE(MultipleBranches)
+{
+    // two laterals leaving the main bore, segments not ordered by depth
+    checkSolve({-1, 0, 5, 1, 1, 0, 2, 4});
+}
+
+BOOST_AUTO_TEST_CASE(SingularPivot)
+{
+    const std::vector<int> outlets{-1, 0, 1};
+    Matrix D = buildSegmentMatrix(outlets);
+    D[2][2] = 0.0;
+
+    Solver solver;
+    solver.init(outlets);
+    BOOST_CHECK(!solver.factorize(D));
+
+    // the failure is only reset by invalidate()
+    D = buildSegmentMatrix(outlets);
+    BOOST_CHECK(!solver.factorize(D));
+    solver.invalidate();
+    BOOST_CHECK(solver.factorize(D));
+}
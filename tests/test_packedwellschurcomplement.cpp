@@ -0,0 +1,131 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PackedWellSchurComplementTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/wells/PackedWellSchurComplement.hpp>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <vector>
+
+namespace {
+
+constexpr int numEq = 3;
+using Block = Dune::DynamicMatrix<double>;
+using WellMatrix = Dune::BCRSMatrix<Block>;
+using WellVector = Dune::BlockVector<Dune::DynamicVector<double>>;
+using BVector = Dune::BlockVector<Dune::FieldVector<double, numEq>>;
+
+struct Well
+{
+    WellMatrix B, C, invD;
+};
+
+Well makeWell(const std::vector<int>& cells, const int num_cells, const int nw, const double seed)
+{
+    Well well;
+    well.invD.setSize(1, 1, 1);
+    for (auto row = well.invD.createbegin(); row != well.invD.createend(); ++row) {
+        row.insert(0);
+    }
+    well.invD[0][0].resize(nw, nw);
+    for (auto* m : {&well.B, &well.C}) {
+        m->setSize(1, num_cells, cells.size());
+        for (auto row = m->createbegin(); row != m->createend(); ++row) {
+            for (const int cell : cells) {
+                row.insert(cell);
+            }
+        }
+        for (const int cell : cells) {
+            (*m)[0][cell].resize(nw, numEq);
+        }
+    }
+    for (int i = 0; i < nw; ++i) {
+        for (int j = 0; j < nw; ++j) {
+            well.invD[0][0][i][j] = (i == j) ? 2.0 : 0.1 * (i - j) * seed;
+        }
+    }
+    for (const int cell : cells) {
+        for (int i = 0; i < nw; ++i) {
+            for (int j = 0; j < numEq; ++j) {
+                well.B[0][cell][i][j] = seed * (i + 1) - j + cell;
+                well.C[0][cell][i][j] = seed * (j + 1) - i + 0.5 * cell;
+            }
+        }
+    }
+    return well;
+}
+
+// Ax = Ax - C^T D^-1 B x, as in StandardWell::apply()
+void applyWell(const Well& well, const BVector& x, BVector& Ax)
+{
+    const int nw = well.invD[0][0].N();
+    WellVector Bx(1), invDBx(1);
+    Bx[0].resize(nw);
+    invDBx[0].resize(nw);
+    well.B.mv(x, Bx);
+    well.invD.mv(Bx, invDBx);
+    well.C.mmtv(invDBx, Ax);
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(PackedApplyMatchesWells)
+{
+    const int num_cells = 10;
+    std::vector<Well> wells;
+    wells.push_back(makeWell({1, 4, 5}, num_cells, 4, 1.0));
+    wells.push_back(makeWell({0, 9}, num_cells, 5, -0.5));
+    wells.push_back(makeWell({4, 7, 8}, num_cells, 4, 2.0));
+
+    Opm::PackedWellSchurComplement<double, numEq> packed;
+    for (const auto& well : wells) {
+        packed.addWell(well.B, well.C, well.invD);
+    }
+    BOOST_CHECK(!packed.empty());
+
+    BVector x(num_cells), Ax_ref(num_cells), Ax(num_cells);
+    for (int cell = 0; cell < num_cells; ++cell) {
+        for (int j = 0; j < numEq; ++j) {
+            x[cell][j] = 0.3 * cell - j;
+            Ax_ref[cell][j] = cell + j;
+        }
+    }
+    Ax = Ax_ref;
+
+    for (const auto& well : wells) {
+        applyWell(well, x, Ax_ref);
+    }
+    packed.apply(x, Ax);
+
+    for (int cell = 0; cell < num_cells; ++cell) {
+        for (int j = 0; j < numEq; ++j) {
+            BOOST_CHECK_SMALL(Ax_ref[cell][j] - Ax[cell][j], 1e-10);
+        }
+    }
+
+    packed.clear();
+    BOOST_CHECK(packed.empty());
+}
@@ -0,0 +1,123 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ParallelFileMergerTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/ParallelFileMerger.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace fs = ::Opm::filesystem;
+
+namespace
+{
+
+struct OutputDir
+{
+    OutputDir()
+        : path(fs::temp_directory_path() / "test_parallelfilemerger")
+    {
+        fs::remove_all(path);
+        fs::create_directories(path);
+    }
+
+    ~OutputDir()
+    {
+        fs::remove_all(path);
+    }
+
+    void write(const std::string& name, const std::string& contents) const
+    {
+        std::ofstream(path / name) << contents;
+    }
+
+    std::string read(const std::string& name) const
+    {
+        std::ifstream in(path / name);
+        std::ostringstream os;
+        os << in.rdbuf();
+        return os.str();
+    }
+
+    void merge(bool show_fallout) const
+    {
+        Opm::detail::ParallelFileMerger merger(path, "CASE", show_fallout);
+        for (const auto& entry : fs::directory_iterator(path)) {
+            merger(entry.path());
+        }
+        merger.merge();
+    }
+
+    fs::path path;
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(MergedInRankOrder)
+{
+    OutputDir dir;
+    dir.write("CASE.PRT", "root\n");
+    for (int rank : {10, 2, 1}) {
+        dir.write("CASE." + std::to_string(rank) + ".PRT", "log " + std::to_string(rank) + "\n");
+    }
+    dir.write("CASE.3.PRT", "");
+    dir.write("CASE.1.DBG", "debug 1\n");
+    dir.write("OTHER.1.PRT", "other\n");
+
+    dir.merge(/*show_fallout=*/true);
+
+    const std::string log = dir.read("CASE.PRT");
+    BOOST_CHECK_EQUAL(log.find("root\n"), 0u);
+    const auto first = log.find("log 1\n");
+    const auto second = log.find("log 2\n");
+    const auto tenth = log.find("log 10\n");
+    BOOST_CHECK(first != std::string::npos);
+    BOOST_CHECK(first < second);
+    BOOST_CHECK(second < tenth);
+    BOOST_CHECK(tenth != std::string::npos);
+    BOOST_CHECK(log.find("rank 3") == std::string::npos);
+    BOOST_CHECK(dir.read("CASE.DBG").find("debug 1\n") != std::string::npos);
+
+    for (const auto* name : {"CASE.1.PRT", "CASE.2.PRT", "CASE.3.PRT", "CASE.10.PRT", "CASE.1.DBG"}) {
+        BOOST_CHECK(!fs::exists(dir.path / name));
+    }
+    BOOST_CHECK(fs::exists(dir.path / "OTHER.1.PRT"));
+}
+
+BOOST_AUTO_TEST_CASE(RemovedWithoutFallout)
+{
+    OutputDir dir;
+    dir.write("CASE.PRT", "root\n");
+    dir.write("CASE.1.PRT", "log 1\n");
+    dir.write("CASE.1.DBG", "debug 1\n");
+    dir.write("CASE.1.SMSPEC", "summary\n");
+
+    dir.merge(/*show_fallout=*/false);
+
+    BOOST_CHECK_EQUAL(dir.read("CASE.PRT"), "root\n");
+    BOOST_CHECK(!fs::exists(dir.path / "CASE.1.PRT"));
+    BOOST_CHECK(!fs::exists(dir.path / "CASE.1.DBG"));
+    BOOST_CHECK(fs::exists(dir.path / "CASE.1.SMSPEC"));
+}
@@ -0,0 +1,145 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PararealIterationTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/timestepping/PararealIteration.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using State = std::vector<double>;
+using Parareal = Opm::PararealIteration<State>;
+
+namespace
+{
+
+// y' = -y, z' = -0.5 z by explicit Euler over windows of length one
+State euler(const State& start, const int steps)
+{
+    State y = start;
+    const double dt = 1.0 / steps;
+    for (int i = 0; i < steps; ++i) {
+        y[0] -= dt * y[0];
+        y[1] -= 0.5 * dt * y[1];
+    }
+    return y;
+}
+
+State coarse(const State& start, int)
+{ return euler(start, 2); }
+
+State fine(const State& start, int)
+{ return euler(start, 100); }
+
+std::vector<State> sequentialFine(const State& initial, const int numWindows)
+{
+    std::vector<State> ends;
+    State y = initial;
+    for (int n = 0; n < numWindows; ++n) {
+        y = fine(y, n);
+        ends.push_back(y);
+    }
+    return ends;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(ExactAfterAllWindows)
+{
+    const int numWindows = 6;
+    Parareal parareal(coarse, fine, Parareal::correctVector, Parareal::maxDistance);
+    const auto result = parareal.run({1.0, 1.0}, numWindows, numWindows, 0.0);
+    const auto expected = sequentialFine({1.0, 1.0}, numWindows);
+
+    BOOST_CHECK_EQUAL(parareal.iterations(), numWindows);
+    BOOST_REQUIRE_EQUAL(result.size(), expected.size());
+    for (int n = 0; n < numWindows; ++n) {
+        BOOST_CHECK_CLOSE(result[n][0], expected[n][0], 1e-10);
+        BOOST_CHECK_CLOSE(result[n][1], expected[n][1], 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(FirstWindowsExactAfterPartialIterations)
+{
+    const int numWindows = 8;
+    Parareal parareal(coarse, fine, Parareal::correctVector, Parareal::maxDistance);
+    const auto result = parareal.run({1.0, 1.0}, numWindows, 3, 0.0);
+    const auto expected = sequentialFine({1.0, 1.0}, numWindows);
+
+    BOOST_CHECK_EQUAL(parareal.iterations(), 3);
+    for (int n = 0; n < 3; ++n) {
+        BOOST_CHECK_CLOSE(result[n][0], expected[n][0], 1e-10);
+    }
+    // the later windows are closer to the fine solution than the coarse one
+    const auto coarseOnly = Parareal(coarse, fine, Parareal::correctVector, Parareal::maxDistance)
+        .run({1.0, 1.0}, numWindows, 0, 0.0);
+    BOOST_CHECK_LT(std::abs(result.back()[1] - expected.back()[1]),
+                   std::abs(coarseOnly.back()[1] - expected.back()[1]));
+}
+
+BOOST_AUTO_TEST_CASE(StopsAtTolerance)
+{
+    const int numWindows = 10;
+    Parareal parareal(coarse, fine, Parareal::correctVector, Parareal::maxDistance);
+    const auto result = parareal.run({1.0, 1.0}, numWindows, numWindows, 1e-4);
+    const auto expected = sequentialFine({1.0, 1.0}, numWindows);
+
+    BOOST_CHECK_LT(parareal.iterations(), numWindows);
+    BOOST_CHECK_LE(parareal.lastChange(), 1e-4);
+    for (int n = 0; n < numWindows; ++n) {
+        BOOST_CHECK_SMALL(result[n][0] - expected[n][0], 1e-3);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CustomFinePropagation)
+{
+    const int numWindows = 4;
+    Parareal parareal(coarse, fine, Parareal::correctVector, Parareal::maxDistance);
+    std::vector<std::size_t> batchSizes;
+    std::vector<int> firstWindows;
+    parareal.setFinePropagation([&](const std::vector<State>& starts, const int firstWindow)
+    {
+        batchSizes.push_back(starts.size());
+        firstWindows.push_back(firstWindow);
+        std::vector<State> ends;
+        for (std::size_t n = 0; n < starts.size(); ++n) {
+            ends.push_back(fine(starts[n], firstWindow + n));
+        }
+        return ends;
+    });
+    parareal.run({1.0, 1.0}, numWindows, numWindows, 0.0);
+    const std::vector<std::size_t> expectedSizes = {4, 3, 2, 1};
+    const std::vector<int> expectedFirst = {0, 1, 2, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(batchSizes.begin(), batchSizes.end(),
+                                  expectedSizes.begin(), expectedSizes.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(firstWindows.begin(), firstWindows.end(),
+                                  expectedFirst.begin(), expectedFirst.end());
+}
+
+BOOST_AUTO_TEST_CASE(NoWindows)
+{
+    Parareal parareal(coarse, fine, Parareal::correctVector, Parareal::maxDistance);
+    BOOST_CHECK_THROW(parareal.run({1.0, 1.0}, 0, 1, 0.0), std::invalid_argument);
+}
@@ -30,6 +30,7 @@
 
 #include <opm/simulators/linalg/PreconditionerFactory.hpp>
 #include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/SubdomainDirectPreconditioner.hpp>
 
 #include <dune/common/fvector.hh>
 #include <dune/istl/bvector.hh>
@@ -383,6 +384,69 @@ BOOST_AUTO_TEST_CASE(TestWithRepeatingOperator)
 
 
 
+template <int bz>
+void testSubdomainDirect(const std::string& matrix_filename, const std::string& rhs_filename)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+    Matrix matrix;
+    {
+        std::ifstream mfile(matrix_filename);
+        if (!mfile) {
+            throw std::runtime_error("Could not read matrix file");
+        }
+        readMatrixMarket(matrix, mfile);
+    }
+    Vector rhs;
+    {
+        std::ifstream rhsfile(rhs_filename);
+        if (!rhsfile) {
+            throw std::runtime_error("Could not read rhs file");
+        }
+        readMatrixMarket(rhs, rhsfile);
+    }
+    using Operator = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+    Operator op(matrix);
+
+    // Two overlapping subdomains are merged into one covering all cells, the
+    // preconditioner is then an exact solve.
+    pt::ptree prm;
+    prm.put("type", "subdomain_direct");
+    prm.put("overlap", 1);
+    std::vector<std::vector<int>> seeds(2);
+    for (std::size_t cell = 0; cell < matrix.N(); ++cell) {
+        seeds[cell < matrix.N() / 2 ? 0 : 1].push_back(cell);
+    }
+    BOOST_CHECK(Opm::setSubdomainSeeds(prm, seeds));
+    BOOST_CHECK(Opm::hasSubdomainPreconditioner(prm));
+
+    auto prec = Opm::PreconditionerFactory<Operator>::create(op, prm);
+    auto* subdomainPrec = dynamic_cast<Opm::SubdomainDirectPreconditioner<Operator, Vector>*>(prec.get());
+    BOOST_REQUIRE(subdomainPrec);
+    BOOST_REQUIRE_EQUAL(subdomainPrec->subdomains().size(), 1);
+    BOOST_CHECK_EQUAL(subdomainPrec->subdomains()[0].size(), matrix.N());
+
+    Vector x(rhs.size());
+    x = 0.0;
+    prec->apply(x, rhs);
+    Vector residual = rhs;
+    matrix.mmv(x, residual);
+    BOOST_CHECK_SMALL(residual.two_norm(), 1e-10 * rhs.two_norm());
+
+    // Too large subdomains are not solved.
+    prm.put("max_cells", 1);
+    auto ilu = Opm::PreconditionerFactory<Operator>::create(op, prm);
+    BOOST_CHECK(dynamic_cast<Opm::SubdomainDirectPreconditioner<Operator, Vector>&>(*ilu).subdomains().empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(TestSubdomainDirect)
+{
+    testSubdomainDirect<1>("matr33.txt", "rhs3.txt");
+    testSubdomainDirect<3>("matr33.txt", "rhs3.txt");
+}
+
+
 #else
 
 // Do nothing if we do not have at least Dune 2.6.
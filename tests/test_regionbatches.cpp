@@ -0,0 +1,65 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE RegionBatchesTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/RegionBatches.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using Opm::RegionBatches;
+
+BOOST_AUTO_TEST_CASE(GroupedByKey)
+{
+    const std::vector<int> keys = {2, 0, 2, 1, 0, 2, 2, 0};
+    const RegionBatches batches(keys, 3);
+
+    // key 0: 3 items, key 1: 1 item, key 2: 4 items in two batches
+    BOOST_REQUIRE_EQUAL(batches.numBatches(), 4u);
+    const std::vector<std::size_t> expected = {1, 4, 7, 3, 0, 2, 5, 6};
+    BOOST_CHECK_EQUAL_COLLECTIONS(batches.order().begin(), batches.order().end(),
+                                  expected.begin(), expected.end());
+    const std::vector<std::size_t> ends = {3, 4, 7, 8};
+    for (std::size_t b = 0; b < batches.numBatches(); ++b) {
+        BOOST_CHECK_EQUAL(batches.batchEnd(b), ends[b]);
+        const int key = keys[batches.order()[batches.batchBegin(b)]];
+        for (std::size_t k = batches.batchBegin(b); k < batches.batchEnd(b); ++k) {
+            BOOST_CHECK_EQUAL(keys[batches.order()[k]], key);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(EmptyAndUnusedKeys)
+{
+    RegionBatches batches(std::vector<int>{}, 10);
+    BOOST_CHECK_EQUAL(batches.numBatches(), 0u);
+
+    // keys without items give no batches
+    batches.build({5, 5, 0}, 10);
+    BOOST_CHECK_EQUAL(batches.numBatches(), 2u);
+
+    BOOST_CHECK_THROW(batches.build({0, -1}, 10), std::invalid_argument);
+    BOOST_CHECK_THROW(batches.build({0}, 0), std::invalid_argument);
+}
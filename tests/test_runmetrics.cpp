@@ -0,0 +1,103 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE RunMetricsTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/RunMetrics.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+Opm::RunMetrics metrics()
+{
+    Opm::RunMetrics m;
+    m.caseName = "NORNE";
+    m.reportStep = 3;
+    m.numReportSteps = 10;
+    m.simulatedDays = 30.0;
+    m.totalDays = 100.0;
+    m.wallSeconds = 7200.0;
+    m.stepSimulatedDays = 10.0;
+    m.stepWallSeconds = 1800.0;
+    m.substeps = 8;
+    m.timeStepChops = 2;
+    m.newtonIterations = 40;
+    m.linearIterations = 400;
+    m.maxRss = 1024;
+    m.sumRss = 4096;
+    return m;
+}
+
+std::string readFile(const std::string& fileName)
+{
+    std::ifstream is(fileName);
+    std::ostringstream ss;
+    ss << is.rdbuf();
+    return ss.str();
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(Rates)
+{
+    const auto m = metrics();
+    BOOST_CHECK_CLOSE(m.daysPerWallHour(), 15.0, 1e-12);
+    BOOST_CHECK_CLOSE(m.stepDaysPerWallHour(), 20.0, 1e-12);
+    BOOST_CHECK_CLOSE(m.chopRate(), 0.25, 1e-12);
+
+    const Opm::RunMetrics empty;
+    BOOST_CHECK_EQUAL(empty.daysPerWallHour(), 0.0);
+    BOOST_CHECK_EQUAL(empty.chopRate(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(Prometheus)
+{
+    std::ostringstream ss;
+    metrics().writePrometheus(ss);
+    const std::string text = ss.str();
+    BOOST_CHECK(text.find("# TYPE opm_flow_newton_iterations_total counter\n") != std::string::npos);
+    BOOST_CHECK(text.find("opm_flow_newton_iterations_total{case=\"NORNE\"} 40\n") != std::string::npos);
+    BOOST_CHECK(text.find("opm_flow_max_rss_bytes{case=\"NORNE\"} 1048576\n") != std::string::npos);
+    BOOST_CHECK(text.find("opm_flow_days_per_wall_hour{case=\"NORNE\"} 15\n") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(Save)
+{
+    const auto m = metrics();
+    m.save("runmetrics_test.json");
+    const std::string json = readFile("runmetrics_test.json");
+    BOOST_CHECK(json.find("\"case\": \"NORNE\"") != std::string::npos);
+    BOOST_CHECK(json.find("\"chop_rate\": 0.25") != std::string::npos);
+
+    m.save("runmetrics_test.prom");
+    BOOST_CHECK(readFile("runmetrics_test.prom").find("# HELP opm_flow_report_step ") == 0);
+    BOOST_CHECK(!std::ifstream("runmetrics_test.prom.tmp"));
+
+    std::remove("runmetrics_test.json");
+    std::remove("runmetrics_test.prom");
+}
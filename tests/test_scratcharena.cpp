@@ -0,0 +1,104 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ScratchArenaTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/ScratchArena.hpp>
+
+#include <cstdint>
+
+using Opm::ScratchAllocator;
+using Opm::ScratchArena;
+using Opm::ScratchVector;
+
+BOOST_AUTO_TEST_CASE(Alignment)
+{
+    ScratchArena arena(1024);
+    arena.allocate(1, 1);
+    void* p = arena.allocate(3 * sizeof(double), alignof(double));
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % alignof(double), 0u);
+    void* q = arena.allocate(16, 64);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(q) % 64, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(LastAllocationIsReused)
+{
+    ScratchArena arena(1024);
+    void* p = arena.allocate(100);
+    arena.deallocate(p, 100);
+    BOOST_CHECK_EQUAL(arena.allocate(100), p);
+
+    // freed out of order, only reused after the reset
+    void* a = arena.allocate(64);
+    void* b = arena.allocate(64);
+    arena.deallocate(a, 64);
+    BOOST_CHECK(arena.allocate(64) != a);
+    arena.deallocate(b, 64);
+    BOOST_CHECK_EQUAL(arena.numBlocks(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(ResetMergesBlocks)
+{
+    ScratchArena arena(256);
+    for (int i = 0; i < 10; ++i) {
+        arena.allocate(200);
+    }
+    BOOST_CHECK_EQUAL(arena.numBlocks(), 10u);
+    const auto capacity = arena.capacity();
+
+    arena.reset();
+    BOOST_CHECK_EQUAL(arena.numBlocks(), 1u);
+    BOOST_CHECK_EQUAL(arena.capacity(), capacity);
+
+    // the same allocations fit into the merged block
+    for (int i = 0; i < 10; ++i) {
+        arena.allocate(200);
+    }
+    BOOST_CHECK_EQUAL(arena.numBlocks(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(Vectors)
+{
+    ScratchArena arena(1024);
+    const ScratchAllocator<double> scratch(&arena);
+    for (int iter = 0; iter < 100; ++iter) {
+        ScratchVector<double> a(10, 1.0, scratch);
+        ScratchVector<double> b(a);
+        b[9] = 2.0;
+        BOOST_CHECK_EQUAL(b[0], 1.0);
+        BOOST_CHECK_EQUAL(b[9], 2.0);
+        BOOST_CHECK(b.get_allocator() == scratch);
+    }
+    // nested vectors give their memory back on destruction
+    BOOST_CHECK_EQUAL(arena.numBlocks(), 1u);
+
+    ScratchVector<double> grown(scratch);
+    for (int i = 0; i < 1000; ++i) {
+        grown.push_back(i);
+    }
+    BOOST_CHECK_EQUAL(grown[999], 999.0);
+
+    // without an arena the memory is taken from the heap
+    ScratchVector<double> heap(1000, 3.0, ScratchAllocator<double>());
+    BOOST_CHECK_EQUAL(heap[999], 3.0);
+}
@@ -0,0 +1,102 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE StructuredPartitionerTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/StructuredPartitioner.hpp>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+std::vector<int> allCells(const std::array<int, 3>& dims)
+{
+    std::vector<int> cells(dims[0] * dims[1] * dims[2]);
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        cells[i] = i;
+    }
+    return cells;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(BalancedColumns)
+{
+    const std::array<int, 3> dims{8, 4, 5};
+    const auto cells = allCells(dims);
+    const auto parts = Opm::structuredColumnPartition(dims, cells, 4);
+    BOOST_REQUIRE_EQUAL(parts.size(), cells.size());
+
+    std::map<int, int> sizes;
+    std::map<int, int> columnPart;
+    for (std::size_t c = 0; c < cells.size(); ++c) {
+        ++sizes[parts[c]];
+        // all cells of a column are in the same part
+        const int column = cells[c] % (dims[0] * dims[1]);
+        const auto it = columnPart.emplace(column, parts[c]).first;
+        BOOST_CHECK_EQUAL(it->second, parts[c]);
+    }
+    BOOST_REQUIRE_EQUAL(sizes.size(), 4);
+    for (const auto& size : sizes) {
+        BOOST_CHECK_EQUAL(size.second, 8 * 5);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(WellsAreKeptTogether)
+{
+    const std::array<int, 3> dims{10, 1, 2};
+    const auto cells = allCells(dims);
+    // a horizontal well through the columns 2 to 7 in the first layer
+    const std::vector<std::vector<int>> wells{{2, 3, 4, 5, 6, 7}};
+    const auto parts = Opm::structuredColumnPartition(dims, cells, 2, wells);
+    for (int c = 3; c <= 7; ++c) {
+        BOOST_CHECK_EQUAL(parts[c], parts[2]);
+        BOOST_CHECK_EQUAL(parts[c + 10], parts[2]);
+    }
+    BOOST_CHECK(std::count(parts.begin(), parts.end(), 1) > 0);
+}
+
+BOOST_AUTO_TEST_CASE(InactiveCells)
+{
+    const std::array<int, 3> dims{4, 4, 1};
+    // only the first two rows are active
+    const std::vector<int> cells{0, 1, 2, 3, 4, 5, 6, 7};
+    const auto parts = Opm::structuredColumnPartition(dims, cells, 2);
+    BOOST_CHECK_EQUAL(std::count(parts.begin(), parts.end(), 0), 4);
+    BOOST_CHECK_EQUAL(std::count(parts.begin(), parts.end(), 1), 4);
+}
+
+BOOST_AUTO_TEST_CASE(MorePartsThanColumns)
+{
+    const std::array<int, 3> dims{2, 1, 3};
+    const auto parts = Opm::structuredColumnPartition(dims, allCells(dims), 4);
+    for (const int part : parts) {
+        BOOST_CHECK(part >= 0 && part < 4);
+    }
+    BOOST_CHECK_THROW(Opm::structuredColumnPartition(dims, allCells(dims), 0), std::invalid_argument);
+}
@@ -0,0 +1,88 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TimeStepControlTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/timestepping/TimeStepControl.hpp>
+
+namespace {
+
+class ConstantRelativeChange : public Opm::RelativeChangeInterface
+{
+public:
+    explicit ConstantRelativeChange(const double change)
+        : change_(change)
+    {}
+
+    double relativeChange() const
+    { return change_; }
+
+private:
+    double change_;
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(HistoryWithoutSubSteps)
+{
+    const double tol = 1e-1;
+    const ConstantRelativeChange relChange(tol / 10);
+    const Opm::PIDAndIterationCountTimeStepControl pid(8, 1.0, 1.0/1.2, tol);
+    const Opm::HistoryTimeStepControl history(8, 30, 5, 1.0, 1.0/1.2, tol);
+
+    const double dt = 10.0;
+    const double dtPid = pid.computeTimeStepSize(dt, 4, relChange, 0.0);
+    BOOST_CHECK_GT(dtPid, dt);
+    BOOST_CHECK_CLOSE(history.computeTimeStepSize(dt, 4, relChange, 0.0), dtPid, 1e-12);
+    BOOST_CHECK_EQUAL(history.failureRisk(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(HistoryNoGrowthAfterChop)
+{
+    const double tol = 1e-1;
+    const ConstantRelativeChange relChange(tol / 10);
+    Opm::HistoryTimeStepControl history(8, 30, 3, 1.0, 1.0/1.2, tol);
+
+    const double dt = 10.0;
+    history.recordSubStep(12, 50, false);
+    history.recordSubStep(4, 10, true);
+    BOOST_CHECK_CLOSE(history.failureRisk(), 0.5, 1e-12);
+    BOOST_CHECK_CLOSE(history.computeTimeStepSize(dt, 4, relChange, 0.0), dt, 1e-12);
+
+    // the chop leaves the history after three more substeps
+    history.recordSubStep(4, 10, true);
+    history.recordSubStep(4, 10, true);
+    BOOST_CHECK_GT(history.computeTimeStepSize(dt, 4, relChange, 0.0), dt);
+}
+
+BOOST_AUTO_TEST_CASE(HistoryLinearIterationRisk)
+{
+    const double tol = 1e-1;
+    const ConstantRelativeChange relChange(tol / 10);
+    Opm::HistoryTimeStepControl history(8, 30, 5, 1.0, 1.0/1.2, tol);
+
+    const double dt = 10.0;
+    history.recordSubStep(4, 60, true);
+    history.recordSubStep(4, 60, true);
+    BOOST_CHECK_CLOSE(history.failureRisk(), 2.0, 1e-12);
+    BOOST_CHECK_CLOSE(history.computeTimeStepSize(dt, 4, relChange, 0.0), dt / 2.0, 1e-12);
+}
@@ -0,0 +1,114 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TracingTest
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/Tracing.hpp>
+
+#include <opm/common/utility/FileSystem.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::string readFile(const std::string& fileName)
+{
+    std::ifstream is(fileName);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    return ss.str();
+}
+
+} // anonymous namespace
+
+bool init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(RingBuffer)
+{
+    const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+    const std::string fileName = "test_tracing.json";
+
+    Opm::Tracing::start(4, comm);
+    BOOST_CHECK(Opm::Tracing::enabled());
+    const char* names[] = { "first", "second", "third", "fourth", "fifth", "sixth" };
+    for (const char* name : names) {
+        Opm::Tracing::Scope scope(name);
+    }
+    Opm::Tracing::stop();
+    BOOST_CHECK(!Opm::Tracing::enabled());
+
+    // not recorded after stop()
+    {
+        Opm::Tracing::Scope scope("stopped");
+    }
+
+    Opm::Tracing::writeChromeTrace(fileName, comm);
+    if (comm.rank() == 0) {
+        const std::string trace = readFile(fileName);
+        BOOST_CHECK_EQUAL(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+        BOOST_CHECK(trace.find("\"first\"") == std::string::npos);
+        BOOST_CHECK(trace.find("\"second\"") == std::string::npos);
+        for (const char* name : { "third", "fourth", "fifth", "sixth" })
+            BOOST_CHECK(trace.find(std::string("\"") + name + "\"") != std::string::npos);
+        BOOST_CHECK(trace.find("\"stopped\"") == std::string::npos);
+        BOOST_CHECK(trace.find("\"count\":2") != std::string::npos);
+        // the oldest kept event comes first
+        BOOST_CHECK(trace.find("\"third\"") < trace.find("\"sixth\""));
+        Opm::filesystem::remove(fileName);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Restart)
+{
+    const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
+    const std::string fileName = "test_tracing_restart.json";
+
+    Opm::Tracing::start(8, comm);
+    Opm::Tracing::record("before", Opm::Tracing::now(), Opm::Tracing::now());
+    Opm::Tracing::start(8, comm);
+    Opm::Tracing::record("after", Opm::Tracing::now(), Opm::Tracing::now());
+    Opm::Tracing::stop();
+
+    Opm::Tracing::writeChromeTrace(fileName, comm);
+    if (comm.rank() == 0) {
+        const std::string trace = readFile(fileName);
+        BOOST_CHECK(trace.find("\"before\"") == std::string::npos);
+        BOOST_CHECK(trace.find("\"after\"") != std::string::npos);
+        BOOST_CHECK(trace.find("\"count\":0") != std::string::npos);
+        Opm::filesystem::remove(fileName);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
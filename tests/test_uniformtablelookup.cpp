@@ -0,0 +1,107 @@
+/*
+  Copyright 2021 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE UniformTableLookupTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/UniformTableLookup.hpp>
+
+#include <opm/material/densead/Evaluation.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+using Opm::UniformTableLookup;
+
+namespace
+{
+
+// a miscibility column with segments of very different lengths
+const std::vector<double> x = {0.0, 0.05, 0.1, 0.5, 0.51, 1.0};
+const std::vector<double> y = {0.0, 0.1, 0.4, 0.9, 0.95, 1.0};
+
+double interpolate(const double xi)
+{
+    std::size_t seg = 0;
+    while (seg + 2 < x.size() && xi >= x[seg + 1]) {
+        ++seg;
+    }
+    return y[seg] + (y[seg + 1] - y[seg]) / (x[seg + 1] - x[seg]) * (xi - x[seg]);
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(MatchesLinearInterpolation)
+{
+    const UniformTableLookup table(x, y);
+    BOOST_CHECK_EQUAL(table.numBuckets(), 100u);
+    for (int i = 0; i <= 1000; ++i) {
+        const double xi = i / 1000.0;
+        BOOST_CHECK_CLOSE(table.eval(xi) + 1.0, interpolate(xi) + 1.0, 1e-10);
+    }
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        BOOST_CHECK_CLOSE(table.eval(x[i]) + 1.0, y[i] + 1.0, 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CappedBuckets)
+{
+    const UniformTableLookup table(x, y, /*maxBuckets=*/3);
+    BOOST_CHECK_EQUAL(table.numBuckets(), 3u);
+    for (int i = 0; i <= 1000; ++i) {
+        const double xi = i / 1000.0;
+        BOOST_CHECK_CLOSE(table.eval(xi) + 1.0, interpolate(xi) + 1.0, 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(OutsideOfRange)
+{
+    const UniformTableLookup table(x, y);
+    BOOST_CHECK_EQUAL(table.eval(-1.0), 0.0);
+    BOOST_CHECK_EQUAL(table.eval(2.0), 1.0);
+    BOOST_CHECK_CLOSE(table.eval(-0.05, /*extrapolate=*/true), -0.1, 1e-10);
+    BOOST_CHECK_CLOSE(table.eval(1.49, /*extrapolate=*/true), 1.05, 1e-10);
+    BOOST_CHECK_EQUAL(table.evalDerivative(2.0), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(Derivatives)
+{
+    using Eval = Opm::DenseAd::Evaluation<double, 1>;
+    const UniformTableLookup table(x, y);
+
+    const Eval xi(0.3, 0);
+    const Eval yi = table.eval(xi);
+    BOOST_CHECK_CLOSE(yi.value(), interpolate(0.3), 1e-10);
+    BOOST_CHECK_CLOSE(yi.derivative(0), 0.5 / 0.4, 1e-10);
+    BOOST_CHECK_CLOSE(table.evalDerivative(0.3), 0.5 / 0.4, 1e-10);
+
+    const Eval outside = table.eval(Eval(1.5, 0));
+    BOOST_CHECK_EQUAL(outside.value(), 1.0);
+    BOOST_CHECK_EQUAL(outside.derivative(0), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidTables)
+{
+    BOOST_CHECK_THROW(UniformTableLookup({0.0}, {1.0}), std::invalid_argument);
+    BOOST_CHECK_THROW(UniformTableLookup({0.0, 1.0}, {1.0}), std::invalid_argument);
+    BOOST_CHECK_THROW(UniformTableLookup({0.0, 0.0, 1.0}, {0.0, 1.0, 2.0}), std::invalid_argument);
+}
@@ -98,6 +98,31 @@ BOOST_AUTO_TEST_CASE(findInterpData)
     BOOST_CHECK_EQUAL(eval5.factor_, 1.0);
 }
 
+BOOST_AUTO_TEST_CASE(findInterpDataLongAxis)
+{
+    // the interval must be the one of the first value greater than or equal to the input
+    std::vector<double> values;
+    for (int i = 0; i < 50; ++i) {
+        values.push_back(i*i);
+    }
+
+    for (double value = 0.25; value < 2401.0; value += 3.5) {
+        const Opm::detail::InterpData eval = Opm::detail::findInterpData(value, values);
+        const int i = std::find_if(values.begin(), values.end(),
+                                   [value](double v) { return v >= value; }) - values.begin();
+        BOOST_CHECK_EQUAL(eval.ind_[0], i-1);
+        BOOST_CHECK_EQUAL(eval.ind_[1], i);
+        BOOST_CHECK_CLOSE(eval.factor_, (value - values[i-1]) / (values[i] - values[i-1]), 1e-10);
+    }
+
+    for (int i = 1; i < 50; ++i) {
+        const Opm::detail::InterpData eval = Opm::detail::findInterpData(values[i], values);
+        BOOST_CHECK_EQUAL(eval.ind_[0], i-1);
+        BOOST_CHECK_EQUAL(eval.ind_[1], i);
+        BOOST_CHECK_EQUAL(eval.factor_, 1.0);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END() // HelperTests
 
 
@@ -553,6 +578,40 @@ BOOST_AUTO_TEST_CASE(THPToBHPAndBackNonTrivial)
 
 
 
+/**
+ * Test that the derivatives of the bhp agree with finite differences
+ */
+BOOST_AUTO_TEST_CASE(BHPDerivativesPlane)
+{
+    fillDataPlane();
+    initProperties();
+
+    const double aqua = -0.2;
+    const double liquid = -0.53;
+    const double vapour = -0.15;
+    const double thp = 0.5;
+    const double alq = 0.4;
+
+    double dbhp_dthp = 0.0;
+    const auto bhp = properties->bhpWithDerivatives(1, aqua, liquid, vapour, thp, alq, dbhp_dthp);
+    BOOST_CHECK_CLOSE(bhp.value(), properties->bhp(1, aqua, liquid, vapour, thp, alq), max_d_tol);
+    BOOST_CHECK_CLOSE(dbhp_dthp, 1.0, max_d_tol);
+
+    const double eps = 1.0e-6;
+    const double daqua = (properties->bhp(1, aqua + eps, liquid, vapour, thp, alq)
+                          - properties->bhp(1, aqua - eps, liquid, vapour, thp, alq)) / (2*eps);
+    const double dliquid = (properties->bhp(1, aqua, liquid + eps, vapour, thp, alq)
+                            - properties->bhp(1, aqua, liquid - eps, vapour, thp, alq)) / (2*eps);
+    const double dvapour = (properties->bhp(1, aqua, liquid, vapour + eps, thp, alq)
+                            - properties->bhp(1, aqua, liquid, vapour - eps, thp, alq)) / (2*eps);
+    BOOST_CHECK_CLOSE(bhp.derivative(0), daqua, 1.0e-4);
+    BOOST_CHECK_CLOSE(bhp.derivative(1), dliquid, 1.0e-4);
+    BOOST_CHECK_CLOSE(bhp.derivative(2), dvapour, 1.0e-4);
+}
+
+
+
+
 BOOST_AUTO_TEST_SUITE_END() // Trivial tests
 
 
@@ -310,6 +310,38 @@ BOOST_AUTO_TEST_CASE(Pressure)
 
 // ---------------------------------------------------------------------
 
+BOOST_AUTO_TEST_CASE(ReportDetailsSelection)
+{
+    const Setup setup{ "msw.data" };
+    const auto tstep = std::size_t{0};
+
+    std::vector<Opm::ParallelWellInfo> pinfos;
+    auto wstate = buildWellState(setup, tstep, pinfos);
+
+    const auto& wells = setup.sched.getWells(tstep);
+    setSegPress(wells, wstate);
+
+    const auto rpt = wstate.report(setup.grid.c_grid()->global_cell,
+                                   [](const int){return false;},
+                                   [](const std::string& name){return name == "PROD01";});
+
+    {
+        const auto& xw = rpt.at("INJE01");
+
+        BOOST_CHECK(xw.connections.empty());
+        BOOST_CHECK(xw.segments.empty());
+    }
+
+    {
+        const auto& xw = rpt.at("PROD01");
+
+        BOOST_CHECK(!xw.connections.empty());
+        BOOST_CHECK_EQUAL(xw.segments.size(), 6);
+    }
+}
+
+// ---------------------------------------------------------------------
+
 BOOST_AUTO_TEST_CASE(Rates)
 {
     const Setup setup{ "msw.data" };
@@ -397,6 +429,36 @@ BOOST_AUTO_TEST_CASE(STOP_well)
 }
 
 
+// ---------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(AssignValues)
+{
+    const Setup setup{ "msw.data" };
+    const auto tstep = std::size_t{0};
+
+    std::vector<Opm::ParallelWellInfo> pinfos;
+    auto wstate = buildWellState(setup, tstep, pinfos);
+    const auto& wells = setup.sched.getWells(tstep);
+
+    // a copy shares the layout, only the values are assigned
+    auto copy = wstate;
+    setSegPress(wells, wstate);
+    wstate.update_bhp(0, 123.0);
+    copy.assignValues(wstate);
+    BOOST_CHECK_EQUAL(copy.bhp(0), 123.0);
+    for (std::size_t wellID = 0; wellID < wells.size(); ++wellID) {
+        BOOST_CHECK_EQUAL(copy.topSegmentIndex(wellID), wstate.topSegmentIndex(wellID));
+        BOOST_CHECK_EQUAL(copy.segPress(wellID)[0], wstate.segPress(wellID)[0]);
+    }
+
+    // a reinitialized state has a new layout and is copied completely
+    auto other = buildWellState(setup, tstep, pinfos);
+    other.assignValues(wstate);
+    BOOST_CHECK_EQUAL(other.bhp(0), 123.0);
+    BOOST_CHECK_EQUAL(other.numWells(), wstate.numWells());
+    BOOST_CHECK_EQUAL(other.numSegment(), wstate.numSegment());
+}
+
 // ---------------------------------------------------------------------
 
 //BOOST_AUTO_TEST_CASE(GlobalWellInfo_TEST) {